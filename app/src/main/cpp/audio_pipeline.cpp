@@ -3,18 +3,47 @@
 #include <memory>
 #include <cmath>
 #include <cstring>
-#include "sine_generator.h"
-#include "osc_sender.h"
-#include "buffer_manager.h"
+#include <string>
+#include <vector>
+#include "media_pipeline/buffer_manager.h"
+#include "media_pipeline/inference.h"
+#include "media_pipeline/mic_chain.h"
+#include "media_pipeline/osc_sender.h"
+#include "media_pipeline/plugin_host.h"
+#include "media_pipeline/sine_generator.h"
+#include "media_pipeline/thread_config.h"
+#include "media_pipeline/trace.h"
 
 #define LOG_TAG "AudioPipeline"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
 // Global instances for the prototype
-std::unique_ptr<SineGenerator> g_sine_generator;
-std::unique_ptr<OSCSender> g_osc_sender;
-std::unique_ptr<BufferManager> g_buffer_manager;
+std::unique_ptr<media_pipeline::SineGenerator> g_sine_generator;
+std::unique_ptr<media_pipeline::OSCSender> g_osc_sender;
+std::unique_ptr<media_pipeline::BufferManager> g_buffer_manager;
+std::unique_ptr<media_pipeline::MicChain> g_mic_chain;
+std::vector<float> g_capture_buffer;
+int g_sample_rate = 44100;
+
+// Feature model run on the capture stream; replaced with std::atomic_store so
+// loading a model never blocks the capture thread
+struct CaptureInference {
+    std::unique_ptr<media_pipeline::FeatureInference> inference;
+    std::string address;
+};
+std::shared_ptr<CaptureInference> g_capture_inference;
+
+// Plugin nodes (plugin_abi.h) run on the capture stream after the mic chain,
+// swapped in whole with std::atomic_store like the capture model
+std::unique_ptr<media_pipeline::PluginHost> g_plugin_host;
+struct CapturePlugins {
+    std::vector<std::unique_ptr<media_pipeline::PluginNode>> nodes;
+};
+std::shared_ptr<CapturePlugins> g_capture_plugins;
+
+// Largest block accepted from Kotlin in one call
+constexpr int kMaxFrameCount = 8192;
 
 extern "C" {
 
@@ -41,13 +70,18 @@ Java_com_elegia_pipcamera_audio_AudioProcessor_nativeInitialize(
 
     try {
         // Initialize buffer manager for efficient memory allocation
-        g_buffer_manager = std::make_unique<BufferManager>(buffer_size, inlet_count, outlet_count);
+        g_buffer_manager = std::make_unique<media_pipeline::BufferManager>(buffer_size, inlet_count, outlet_count);
 
         // Initialize 440Hz sine wave generator
-        g_sine_generator = std::make_unique<SineGenerator>(sample_rate, 440.0f);
+        g_sine_generator = std::make_unique<media_pipeline::SineGenerator>(sample_rate, 440.0f);
 
         // Initialize OSC sender for audio output
-        g_osc_sender = std::make_unique<OSCSender>("127.0.0.1", 8000);
+        g_osc_sender = std::make_unique<media_pipeline::OSCSender>("127.0.0.1", 8000);
+
+        // Microphone DSP chain; the capture buffer is sized once so capture never allocates
+        g_mic_chain = std::make_unique<media_pipeline::MicChain>(sample_rate);
+        g_capture_buffer.assign(kMaxFrameCount, 0.0f);
+        g_sample_rate = sample_rate;
 
         LOGI("Audio pipeline initialized successfully");
         return JNI_TRUE;
@@ -74,13 +108,14 @@ Java_com_elegia_pipcamera_audio_AudioProcessor_nativeProcessAudio(
     jobject output_buffer,
     jint frame_count
 ) {
+    MP_TRACE_SCOPE("nativeProcessAudio");
     if (!g_sine_generator || !g_osc_sender || !g_buffer_manager) {
         LOGE("Audio pipeline not initialized");
         return;
     }
 
     // Validate frame count to prevent buffer overruns
-    if (frame_count <= 0 || frame_count > 8192) {
+    if (frame_count <= 0 || frame_count > kMaxFrameCount) {
         LOGE("Invalid frame count: %d", frame_count);
         return;
     }
@@ -101,35 +136,115 @@ Java_com_elegia_pipcamera_audio_AudioProcessor_nativeProcessAudio(
         output_data = static_cast<float*>(env->GetDirectBufferAddress(output_buffer));
     }
 
-    // Get audio buffer for processing
-    auto audio_buffer = g_buffer_manager->getAudioBuffer();
-    if (!audio_buffer) {
-        LOGE("Failed to get audio buffer");
+    // Use input data in place if provided, otherwise generate sine wave
+    std::shared_ptr<float> audio_buffer;
+    const float* source = input_data;
+    if (!source) {
+        audio_buffer = g_buffer_manager->getAudioBuffer();
+        if (!audio_buffer) {
+            LOGE("Failed to get audio buffer");
+            return;
+        }
+        g_sine_generator->generate(audio_buffer.get(), frame_count);
+        source = audio_buffer.get();
+    }
+
+    // Send audio data via OSC (safely)
+    try {
+        g_osc_sender->sendAudio(source, frame_count);
+    } catch (...) {
+        LOGE("Exception during OSC send");
+    }
+
+    // Copy to output buffer if provided (skipped when the caller reuses the input buffer)
+    if (output_data && output_data != source) {
+        std::memcpy(output_data, source, frame_count * sizeof(float));
+    }
+}
+
+/**
+ * Process raw microphone capture through the native DSP chain and send it
+ * Input gain, noise gate, noise suppression, AGC and limiting all run here,
+ * so the capture thread only reads from AudioRecord and calls this.
+ * @param pcm_buffer Direct ByteBuffer of 16-bit native-order PCM
+ * @param frame_count Number of samples in pcm_buffer
+ */
+JNIEXPORT void JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeProcessCapture(
+    JNIEnv *env,
+    jobject thiz,
+    jobject pcm_buffer,
+    jint frame_count
+) {
+    MP_TRACE_SCOPE("nativeProcessCapture");
+    if (!g_mic_chain || !g_osc_sender) {
+        LOGE("Audio pipeline not initialized");
+        return;
+    }
+
+    if (frame_count <= 0 || frame_count > kMaxFrameCount) {
+        LOGE("Invalid frame count: %d", frame_count);
         return;
     }
 
-    // Use input data if provided, otherwise generate sine wave
-    if (input_data) {
-        // Process real microphone data
-        std::memcpy(audio_buffer.get(), input_data, frame_count * sizeof(float));
-    } else {
-        // Generate sine wave audio (for sine generator)
-        g_sine_generator->generate(audio_buffer.get(), frame_count);
+    auto* pcm = static_cast<const int16_t*>(env->GetDirectBufferAddress(pcm_buffer));
+    if (!pcm || env->GetDirectBufferCapacity(pcm_buffer) < frame_count * static_cast<jlong>(sizeof(int16_t))) {
+        LOGE("Invalid capture buffer");
+        return;
+    }
+
+    g_mic_chain->processCapture(pcm, g_capture_buffer.data(), frame_count);
+    if (auto plugins = std::atomic_load(&g_capture_plugins)) {
+        for (const auto& node : plugins->nodes) {
+            node->process(g_capture_buffer.data(), frame_count);
+        }
     }
 
-    // Send audio data via OSC (safely)
     try {
-        g_osc_sender->sendAudio(audio_buffer.get(), frame_count);
+        g_osc_sender->sendAudio(g_capture_buffer.data(), frame_count);
     } catch (...) {
         LOGE("Exception during OSC send");
     }
 
-    // Copy to output buffer if provided
-    if (output_data && audio_buffer) {
-        std::memcpy(output_data, audio_buffer.get(), frame_count * sizeof(float));
+    // Features and the capture model run here too: nothing returns to the JVM per frame
+    if (auto capture = std::atomic_load(&g_capture_inference)) {
+        capture->inference->process(g_capture_buffer.data(), frame_count, [&](const float* outputs, size_t count) {
+            g_osc_sender->sendFeatures(capture->address, outputs, static_cast<int>(count));
+        });
     }
 }
 
+/**
+ * Configure the microphone DSP chain (applied from the next capture block)
+ * @param gain Input gain, 0.1x - 5.0x
+ */
+JNIEXPORT void JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeSetMicChain(
+    JNIEnv *env,
+    jobject thiz,
+    jfloat gain,
+    jboolean noise_gate,
+    jboolean noise_suppression,
+    jboolean auto_gain,
+    jboolean limiter
+) {
+    if (!g_mic_chain) {
+        LOGE("Audio pipeline not initialized");
+        return;
+    }
+
+    media_pipeline::MicChain::Settings settings;
+    settings.input_gain = gain;
+    settings.noise_gate = noise_gate;
+    settings.noise_suppression = noise_suppression;
+    settings.auto_gain = auto_gain;
+    settings.limiter = limiter;
+    g_mic_chain->setSettings(settings);
+
+    LOGI("Mic chain: gain %.2f, gate %d, suppression %d, agc %d, limiter %d (latency %zu samples)",
+         gain, noise_gate, noise_suppression, auto_gain, limiter, g_mic_chain->getLatency());
+}
+
 /**
  * Cleanup the audio processing pipeline
  */
@@ -143,6 +258,10 @@ Java_com_elegia_pipcamera_audio_AudioProcessor_nativeShutdown(
     g_sine_generator.reset();
     g_osc_sender.reset();
     g_buffer_manager.reset();
+    g_mic_chain.reset();
+    std::atomic_store(&g_capture_inference, std::shared_ptr<CaptureInference>());
+    std::atomic_store(&g_capture_plugins, std::shared_ptr<CapturePlugins>());
+    g_plugin_host.reset();
 
     LOGI("Audio pipeline shutdown complete");
 }
@@ -190,6 +309,244 @@ Java_com_elegia_pipcamera_audio_AudioProcessor_nativeSetOSCAddress(
     LOGI("OSC address set: %s", address_str);
 }
 
+/**
+ * Select OSC transport
+ * @param use_tcp JNI_TRUE for SLIP-framed OSC over TCP, JNI_FALSE for UDP
+ * @param latency_budget_ms TCP backlog age beyond which messages fall back to UDP
+ */
+JNIEXPORT void JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeSetOSCTransport(
+    JNIEnv *env,
+    jobject thiz,
+    jboolean use_tcp,
+    jint latency_budget_ms
+) {
+    if (!g_osc_sender) {
+        LOGE("OSC sender not initialized");
+        return;
+    }
+
+    using Transport = media_pipeline::OSCSender::Transport;
+    g_osc_sender->setTransport(use_tcp ? Transport::TCP : Transport::UDP, latency_budget_ms);
+}
+
+/**
+ * Send audio to a receiver on the same host through its shared-memory ring
+ * @param name Ring file path (shm_open is unavailable on Android)
+ */
+JNIEXPORT void JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeSetSharedMemoryDestination(
+    JNIEnv *env,
+    jobject thiz,
+    jstring name
+) {
+    if (!g_osc_sender) {
+        LOGE("OSC sender not initialized");
+        return;
+    }
+
+    const char* name_str = env->GetStringUTFChars(name, nullptr);
+    g_osc_sender->setSharedMemoryDestination(name_str);
+    env->ReleaseStringUTFChars(name, name_str);
+}
+
+/**
+ * Send an analysis feature vector through the OSC sender
+ * @param address OSC address, e.g. "/analysis/mfcc"
+ * @param features Feature values
+ */
+JNIEXPORT void JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeSendFeatures(
+    JNIEnv *env,
+    jobject thiz,
+    jstring address,
+    jfloatArray features
+) {
+    if (!g_osc_sender) {
+        LOGE("OSC sender not initialized");
+        return;
+    }
+
+    jsize count = env->GetArrayLength(features);
+    jfloat* values = env->GetFloatArrayElements(features, nullptr);
+    if (!values) {
+        return;
+    }
+    const char* address_str = env->GetStringUTFChars(address, nullptr);
+    g_osc_sender->sendFeatures(address_str, values, count);
+    env->ReleaseStringUTFChars(address, address_str);
+    env->ReleaseFloatArrayElements(features, values, JNI_ABORT);
+}
+
+/**
+ * Select the analysis feature encoding
+ * @param bits 8 or 16 for quantized delta-coded vectors, 0 for text
+ * @param keyframe_interval Frames between keyframes
+ */
+JNIEXPORT void JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeSetFeatureEncoding(
+    JNIEnv *env,
+    jobject thiz,
+    jint bits,
+    jint keyframe_interval
+) {
+    if (!g_osc_sender) {
+        LOGE("OSC sender not initialized");
+        return;
+    }
+
+    g_osc_sender->setFeatureEncoding(bits, keyframe_interval);
+}
+
+/**
+ * Run a feature model on the processed capture stream
+ * Audio features (media_pipeline/audio_features.h) are extracted every
+ * 512 samples and evaluated a window at a time; the mean output of each
+ * window is sent as a feature vector to address.
+ * @param model_bytes Model file contents; must take the 6 audio features
+ * @param window_frames Feature frames per evaluation (1-64)
+ * @return false if the model is invalid or does not take the audio features
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeSetCaptureModel(
+    JNIEnv *env,
+    jobject thiz,
+    jbyteArray model_bytes,
+    jstring address,
+    jint window_frames
+) {
+    jsize length = env->GetArrayLength(model_bytes);
+    jbyte* data = env->GetByteArrayElements(model_bytes, nullptr);
+    if (!data) {
+        return JNI_FALSE;
+    }
+
+    std::string error;
+    auto model = media_pipeline::InferenceModel::load(data, static_cast<size_t>(length), error);
+    env->ReleaseByteArrayElements(model_bytes, data, JNI_ABORT);
+    auto inference = media_pipeline::FeatureInference::create(std::move(model), g_sample_rate,
+                                                              static_cast<size_t>(window_frames > 0 ? window_frames : 1),
+                                                              error);
+    if (!inference) {
+        LOGE("Failed to set capture model: %s", error.c_str());
+        return JNI_FALSE;
+    }
+
+    auto capture = std::make_shared<CaptureInference>();
+    capture->inference = std::move(inference);
+    const char* address_str = env->GetStringUTFChars(address, nullptr);
+    capture->address = address_str;
+    env->ReleaseStringUTFChars(address, address_str);
+
+    LOGI("Capture model active: %zu outputs to %s every %zu frames", capture->inference->getModel().getOutputCount(),
+         capture->address.c_str(), capture->inference->getWindowFrames());
+    std::atomic_store(&g_capture_inference, std::move(capture));
+    return JNI_TRUE;
+}
+
+/**
+ * Stop running the capture model
+ */
+JNIEXPORT void JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeClearCaptureModel(
+    JNIEnv *env,
+    jobject thiz
+) {
+    std::atomic_store(&g_capture_inference, std::shared_ptr<CaptureInference>());
+}
+
+/**
+ * Load processing node plugins (shared libraries built against plugin_abi.h)
+ * @param directory e.g. the app's native library directory
+ * @return Number of libraries loaded; failures are logged
+ */
+JNIEXPORT jint JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeLoadPlugins(
+    JNIEnv *env,
+    jobject thiz,
+    jstring directory
+) {
+    if (!g_plugin_host) {
+        g_plugin_host = std::make_unique<media_pipeline::PluginHost>();
+    }
+    const char* directory_str = env->GetStringUTFChars(directory, nullptr);
+    std::vector<std::string> errors;
+    size_t loaded = g_plugin_host->loadDirectory(directory_str, errors);
+    for (const auto& error : errors) {
+        LOGE("Plugin: %s", error.c_str());
+    }
+    LOGI("Loaded %zu plugin libraries from %s, %zu nodes available", loaded, directory_str,
+         g_plugin_host->getDescriptors().size());
+    env->ReleaseStringUTFChars(directory, directory_str);
+    return static_cast<jint>(loaded);
+}
+
+/**
+ * Run plugin nodes on the processed capture stream, in order, replacing any before
+ * Nodes are created here, off the capture thread; an empty array removes them.
+ * @param ids Plugin node ids
+ * @return false if a node is unknown or cannot be created (the chain is left as it was)
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeSetCapturePlugins(
+    JNIEnv *env,
+    jobject thiz,
+    jobjectArray ids
+) {
+    auto plugins = std::make_shared<CapturePlugins>();
+    const jsize count = env->GetArrayLength(ids);
+    for (jsize i = 0; i < count; ++i) {
+        auto id = static_cast<jstring>(env->GetObjectArrayElement(ids, i));
+        const char* id_str = env->GetStringUTFChars(id, nullptr);
+        std::string error = "plugins not loaded";
+        std::unique_ptr<media_pipeline::PluginNode> node;
+        if (g_plugin_host) {
+            node = g_plugin_host->createNode(id_str, g_sample_rate, 1, kMaxFrameCount, error);
+        }
+        env->ReleaseStringUTFChars(id, id_str);
+        env->DeleteLocalRef(id);
+        if (!node) {
+            LOGE("Capture plugin: %s", error.c_str());
+            return JNI_FALSE;
+        }
+        LOGI("Capture plugin %s (%s), latency %zu samples", node->getId().c_str(), node->getDescriptor().name,
+             node->getLatency());
+        plugins->nodes.push_back(std::move(node));
+    }
+    std::atomic_store(&g_capture_plugins, plugins->nodes.empty() ? std::shared_ptr<CapturePlugins>() : plugins);
+    return JNI_TRUE;
+}
+
+/**
+ * Set a parameter of a capture plugin node, applied from the next capture block
+ * @return false if no such node or parameter is running
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeSetCapturePluginParameter(
+    JNIEnv *env,
+    jobject thiz,
+    jstring id,
+    jstring parameter,
+    jfloat value
+) {
+    auto plugins = std::atomic_load(&g_capture_plugins);
+    if (!plugins) {
+        return JNI_FALSE;
+    }
+    const char* id_str = env->GetStringUTFChars(id, nullptr);
+    const char* parameter_str = env->GetStringUTFChars(parameter, nullptr);
+    bool set = false;
+    for (const auto& node : plugins->nodes) {
+        if (node->getId() == id_str) {
+            set = node->setParameter(parameter_str, value);
+            break;
+        }
+    }
+    env->ReleaseStringUTFChars(parameter, parameter_str);
+    env->ReleaseStringUTFChars(id, id_str);
+    return set ? JNI_TRUE : JNI_FALSE;
+}
+
 /**
  * Set sine wave frequency
  */
@@ -208,4 +565,51 @@ Java_com_elegia_pipcamera_audio_AudioProcessor_nativeSetFrequency(
     LOGI("Frequency set: %.2f Hz", frequency);
 }
 
+/**
+ * Configure the calling thread for audio processing
+ * Android apps cannot get SCHED_FIFO, so this normally lands on the
+ * nice -19 fallback (THREAD_PRIORITY_URGENT_AUDIO); denormals are flushed
+ * so decaying filters and gain ramps never hit the slow path.
+ * @param cpu Core to pin to, -1 to leave affinity alone
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeConfigureAudioThread(
+    JNIEnv *env,
+    jobject thiz,
+    jint cpu
+) {
+    media_pipeline::ThreadConfig config;
+    config.policy = media_pipeline::SchedulingPolicy::FIFO;
+    config.priority = 2;
+    config.nice_fallback = -19;
+    config.cpu = cpu;
+    config.flush_denormals = true;
+    config.prefault_stack_bytes = 64 * 1024;
+
+    auto result = media_pipeline::applyThreadConfig(config, "audio-proc");
+    LOGI("Audio thread %s", result.summary.c_str());
+    return (result.realtime || result.niced) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Write the native trace recorded so far as Chrome trace JSON
+ * Events are recorded only when the library is built with ENABLE_TRACING;
+ * pull the file with adb and open it in ui.perfetto.dev.
+ * @param path Destination file, e.g. in the app's files directory
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_elegia_pipcamera_audio_AudioProcessor_nativeDumpTrace(
+    JNIEnv *env,
+    jobject thiz,
+    jstring path
+) {
+    const char* path_str = env->GetStringUTFChars(path, nullptr);
+    if (!path_str) {
+        return JNI_FALSE;
+    }
+    bool written = media_pipeline::trace::writeChromeJson(std::string(path_str));
+    env->ReleaseStringUTFChars(path, path_str);
+    return written ? JNI_TRUE : JNI_FALSE;
+}
+
 } // extern "C"
\ No newline at end of file
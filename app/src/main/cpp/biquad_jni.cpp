@@ -0,0 +1,162 @@
+#include <jni.h>
+#include <android/log.h>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include "media_pipeline/biquad.h"
+#include "media_pipeline/dsp_kernels.h"
+
+#define LOG_TAG "NativeBiquadBank"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+using media_pipeline::BiquadBank;
+using media_pipeline::BiquadCoefficients;
+
+namespace {
+
+constexpr size_t kChunkFrames = 1024;
+
+/**
+ * Filters are retuned from the UI while a pipeline coroutine processes
+ */
+struct NativeBiquadBank {
+    NativeBiquadBank(size_t lanes, size_t stages)
+        : bank(lanes, stages)
+        , samples(kChunkFrames * lanes) {
+    }
+
+    std::mutex mutex;
+    BiquadBank bank;
+    std::vector<float> samples;
+};
+
+NativeBiquadBank* fromHandle(jlong handle) {
+    return reinterpret_cast<NativeBiquadBank*>(static_cast<intptr_t>(handle));
+}
+
+} // namespace
+
+extern "C" {
+
+/**
+ * @param lanes Interleaved channels (or streams) filtered side by side
+ * @param stages Sections in each lane's cascade, all pass-through to start
+ * @return Native handle
+ */
+JNIEXPORT jlong JNICALL
+Java_com_elegia_pipcamera_pipeline_nodes_NativeBiquadBank_nativeCreate(
+    JNIEnv *env,
+    jclass clazz,
+    jint lanes,
+    jint stages
+) {
+    if (lanes <= 0 || stages <= 0) {
+        LOGE("Invalid biquad bank: %d lanes, %d stages", lanes, stages);
+        return 0;
+    }
+    auto* bank = new NativeBiquadBank(static_cast<size_t>(lanes), static_cast<size_t>(stages));
+    LOGI("Biquad bank created: %d lanes, %d stages", lanes, stages);
+    return static_cast<jlong>(reinterpret_cast<intptr_t>(bank));
+}
+
+/**
+ * Design one section (RBJ cookbook), gliding to it over ramp_frames
+ * @param lane Lane index, or -1 for every lane
+ * @param type BiquadCoefficients::Type ordinal
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_elegia_pipcamera_pipeline_nodes_NativeBiquadBank_nativeSetFilter(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle,
+    jint lane,
+    jint stage,
+    jint type,
+    jdouble sample_rate,
+    jdouble frequency,
+    jdouble q,
+    jdouble gain_db,
+    jint ramp_frames
+) {
+    NativeBiquadBank* native = fromHandle(handle);
+    if (!native || type < 0 || type > static_cast<jint>(BiquadCoefficients::Type::HIGH_SHELF) || stage < 0 ||
+        static_cast<size_t>(stage) >= native->bank.getStageCount() || lane < -1 ||
+        (lane >= 0 && static_cast<size_t>(lane) >= native->bank.getLaneCount()) || frequency <= 0.0 || q <= 0.0) {
+        return JNI_FALSE;
+    }
+
+    std::lock_guard<std::mutex> lock(native->mutex);
+    const auto filter_type = static_cast<BiquadCoefficients::Type>(type);
+    const size_t first = lane < 0 ? 0 : static_cast<size_t>(lane);
+    const size_t last = lane < 0 ? native->bank.getLaneCount() : first + 1;
+    for (size_t l = first; l < last; ++l) {
+        native->bank.setDesign(l, static_cast<size_t>(stage), filter_type, sample_rate, frequency, q, gain_db,
+                               static_cast<size_t>(std::max(0, ramp_frames)));
+    }
+    return JNI_TRUE;
+}
+
+/**
+ * Filter interleaved 16-bit native-order PCM in place
+ * @param buffer Direct ByteBuffer
+ * @param offset Byte offset of the first frame
+ * @param frame_count Frames of getLaneCount() samples
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_elegia_pipcamera_pipeline_nodes_NativeBiquadBank_nativeProcessPcm16(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle,
+    jobject buffer,
+    jint offset,
+    jint frame_count
+) {
+    NativeBiquadBank* native = fromHandle(handle);
+    auto* data = static_cast<uint8_t*>(env->GetDirectBufferAddress(buffer));
+    if (!native || !data || offset < 0 || frame_count < 0) {
+        return JNI_FALSE;
+    }
+    const size_t lanes = native->bank.getLaneCount();
+    const jlong needed = offset + static_cast<jlong>(frame_count) * static_cast<jlong>(lanes * sizeof(int16_t));
+    if (env->GetDirectBufferCapacity(buffer) < needed) {
+        LOGE("PCM buffer too small for %d frames", frame_count);
+        return JNI_FALSE;
+    }
+
+    std::lock_guard<std::mutex> lock(native->mutex);
+    auto* pcm = reinterpret_cast<int16_t*>(data + offset);
+    for (size_t done = 0; done < static_cast<size_t>(frame_count);) {
+        const size_t frames = std::min(kChunkFrames, static_cast<size_t>(frame_count) - done);
+        int16_t* chunk = pcm + done * lanes;
+        media_pipeline::dsp::int16ToFloat(native->samples.data(), chunk, frames * lanes);
+        native->bank.process(native->samples.data(), frames);
+        media_pipeline::dsp::floatToInt16(chunk, native->samples.data(), frames * lanes);
+        done += frames;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_elegia_pipcamera_pipeline_nodes_NativeBiquadBank_nativeReset(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle
+) {
+    NativeBiquadBank* native = fromHandle(handle);
+    if (native) {
+        std::lock_guard<std::mutex> lock(native->mutex);
+        native->bank.reset();
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_elegia_pipcamera_pipeline_nodes_NativeBiquadBank_nativeDestroy(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle
+) {
+    delete fromHandle(handle);
+}
+
+} // extern "C"
@@ -0,0 +1,123 @@
+#include <jni.h>
+#include <android/log.h>
+#include <string>
+#include "media_pipeline/inference.h"
+
+#define LOG_TAG "NativeModel"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+using media_pipeline::InferenceModel;
+
+namespace {
+
+InferenceModel* fromHandle(jlong handle) {
+    return reinterpret_cast<InferenceModel*>(static_cast<intptr_t>(handle));
+}
+
+} // namespace
+
+extern "C" {
+
+/**
+ * Load a model file (see media_pipeline/inference.h for the format)
+ * @param bytes Whole file contents
+ * @return Native handle, or 0 if the model is invalid
+ */
+JNIEXPORT jlong JNICALL
+Java_com_elegia_pipcamera_ml_NativeModel_nativeLoad(
+    JNIEnv *env,
+    jclass clazz,
+    jbyteArray bytes
+) {
+    jsize length = env->GetArrayLength(bytes);
+    jbyte* data = env->GetByteArrayElements(bytes, nullptr);
+    if (!data) {
+        return 0;
+    }
+
+    std::string error;
+    auto model = InferenceModel::load(data, static_cast<size_t>(length), error);
+    env->ReleaseByteArrayElements(bytes, data, JNI_ABORT);
+    if (!model) {
+        LOGE("Failed to load model: %s", error.c_str());
+        return 0;
+    }
+
+    LOGI("Model loaded: type %d, %zu inputs, %zu outputs", static_cast<int>(model->getType()),
+         model->getInputCount(), model->getOutputCount());
+    return static_cast<jlong>(reinterpret_cast<intptr_t>(model.release()));
+}
+
+JNIEXPORT jint JNICALL
+Java_com_elegia_pipcamera_ml_NativeModel_nativeGetInputCount(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle
+) {
+    InferenceModel* model = fromHandle(handle);
+    return model ? static_cast<jint>(model->getInputCount()) : 0;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_elegia_pipcamera_ml_NativeModel_nativeGetOutputCount(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle
+) {
+    InferenceModel* model = fromHandle(handle);
+    return model ? static_cast<jint>(model->getOutputCount()) : 0;
+}
+
+/**
+ * Evaluate a window of frames in one call
+ * The arrays are pinned rather than copied; the model runs no JNI calls
+ * while they are held.
+ * @param frames frame_count rows of getInputCount() features
+ * @param outputs Receives frame_count rows of getOutputCount() values
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_elegia_pipcamera_ml_NativeModel_nativePredict(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle,
+    jfloatArray frames,
+    jint frame_count,
+    jfloatArray outputs
+) {
+    InferenceModel* model = fromHandle(handle);
+    if (!model || frame_count <= 0) {
+        return JNI_FALSE;
+    }
+
+    const jlong needed_in = static_cast<jlong>(frame_count) * static_cast<jlong>(model->getInputCount());
+    const jlong needed_out = static_cast<jlong>(frame_count) * static_cast<jlong>(model->getOutputCount());
+    if (env->GetArrayLength(frames) < needed_in || env->GetArrayLength(outputs) < needed_out) {
+        LOGE("Predict arrays too small for %d frames", frame_count);
+        return JNI_FALSE;
+    }
+
+    auto* in = static_cast<float*>(env->GetPrimitiveArrayCritical(frames, nullptr));
+    auto* out = static_cast<float*>(env->GetPrimitiveArrayCritical(outputs, nullptr));
+    if (in && out) {
+        model->predict(in, static_cast<size_t>(frame_count), model->getInputCount(), out);
+    }
+    if (out) {
+        env->ReleasePrimitiveArrayCritical(outputs, out, 0);
+    }
+    if (in) {
+        env->ReleasePrimitiveArrayCritical(frames, in, JNI_ABORT);
+    }
+    return (in && out) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_elegia_pipcamera_ml_NativeModel_nativeDestroy(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle
+) {
+    delete fromHandle(handle);
+}
+
+} // extern "C"
@@ -0,0 +1,155 @@
+#include <jni.h>
+#include <android/log.h>
+#include <string>
+#include <vector>
+#include "media_pipeline/stream_packetizer.h"
+
+#define LOG_TAG "StreamPacketizer"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+using media_pipeline::StreamPacketizer;
+
+namespace {
+
+// What a handle points to: the packetizer, and the buffer that frames from
+// byte arrays are copied into, reused from frame to frame
+struct NativePacketizer {
+    explicit NativePacketizer(size_t max_packet_size) : packetizer(max_packet_size) {}
+
+    StreamPacketizer packetizer;
+    std::vector<uint8_t> frame;
+};
+
+NativePacketizer* fromHandle(jlong handle) {
+    return reinterpret_cast<NativePacketizer*>(static_cast<intptr_t>(handle));
+}
+
+bool inBounds(jint offset, jint length, jlong capacity) {
+    return offset >= 0 && length >= 0 && static_cast<jlong>(offset) + length <= capacity;
+}
+
+} // namespace
+
+extern "C" {
+
+/**
+ * Create a packetizer
+ * @param max_packet_size Datagram size including the 24-byte header
+ * @return Native handle, passed to the other calls
+ */
+JNIEXPORT jlong JNICALL
+Java_com_elegia_pipcamera_pipeline_nodes_NativeStreamPacketizer_nativeCreate(
+    JNIEnv *env,
+    jclass clazz,
+    jint max_packet_size
+) {
+    auto* native = new NativePacketizer(static_cast<size_t>(max_packet_size));
+    LOGI("Stream packetizer created: max payload %zu bytes", native->packetizer.getMaxPayloadSize());
+    return static_cast<jlong>(reinterpret_cast<intptr_t>(native));
+}
+
+/**
+ * Set the destination
+ * @param host Numeric IPv4 or IPv6 address (resolve names before calling)
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_elegia_pipcamera_pipeline_nodes_NativeStreamPacketizer_nativeSetDestination(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle,
+    jstring host,
+    jint port
+) {
+    NativePacketizer* native = fromHandle(handle);
+    if (!native) {
+        return JNI_FALSE;
+    }
+
+    const char* host_str = env->GetStringUTFChars(host, nullptr);
+    std::string error;
+    bool ok = native->packetizer.setDestination(host_str, port, error);
+    if (ok) {
+        LOGI("Stream destination: %s:%d", host_str, port);
+    } else {
+        LOGE("Failed to set stream destination: %s", error.c_str());
+    }
+    env->ReleaseStringUTFChars(host, host_str);
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Send one frame from a direct ByteBuffer without copying it
+ * @return Packets sent, or -1 on failure
+ */
+JNIEXPORT jint JNICALL
+Java_com_elegia_pipcamera_pipeline_nodes_NativeStreamPacketizer_nativeSendFrame(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle,
+    jobject buffer,
+    jint offset,
+    jint length,
+    jlong timestamp
+) {
+    NativePacketizer* native = fromHandle(handle);
+    auto* data = static_cast<uint8_t*>(env->GetDirectBufferAddress(buffer));
+    if (!native || !data || !inBounds(offset, length, env->GetDirectBufferCapacity(buffer))) {
+        return -1;
+    }
+    return native->packetizer.sendFrame(data + offset, static_cast<size_t>(length),
+                                        static_cast<uint64_t>(timestamp));
+}
+
+/**
+ * Send one frame from a byte array (heap ByteBuffer backing array)
+ * The frame is copied out first: the send blocks in sendmmsg, which JNI
+ * does not allow while an array is held critical, and a critical hold
+ * would stall the GC for the whole send.
+ * @return Packets sent, or -1 on failure (including a range past the array)
+ */
+JNIEXPORT jint JNICALL
+Java_com_elegia_pipcamera_pipeline_nodes_NativeStreamPacketizer_nativeSendFrameArray(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle,
+    jbyteArray array,
+    jint offset,
+    jint length,
+    jlong timestamp
+) {
+    NativePacketizer* native = fromHandle(handle);
+    if (!native || !array || !inBounds(offset, length, env->GetArrayLength(array))) {
+        return -1;
+    }
+
+    // Grows to the largest frame once, then no allocation per frame
+    std::vector<uint8_t>& frame = native->frame;
+    if (frame.size() < static_cast<size_t>(length)) {
+        frame.resize(static_cast<size_t>(length));
+    }
+    env->GetByteArrayRegion(array, offset, length, reinterpret_cast<jbyte*>(frame.data()));
+    return native->packetizer.sendFrame(frame.data(), static_cast<size_t>(length),
+                                        static_cast<uint64_t>(timestamp));
+}
+
+/**
+ * Close the socket and free the packetizer
+ */
+JNIEXPORT void JNICALL
+Java_com_elegia_pipcamera_pipeline_nodes_NativeStreamPacketizer_nativeDestroy(
+    JNIEnv *env,
+    jclass clazz,
+    jlong handle
+) {
+    NativePacketizer* native = fromHandle(handle);
+    if (native) {
+        LOGI("Stream packetizer destroyed: %llu frames, %llu packets, %llu errors",
+             static_cast<unsigned long long>(native->packetizer.getFrameCount()),
+             static_cast<unsigned long long>(native->packetizer.getPacketCount()),
+             static_cast<unsigned long long>(native->packetizer.getErrorCount()));
+        delete native;
+    }
+}
+
+} // extern "C"
@@ -1,6 +1,7 @@
 package com.elegia.pipcamera.audio
 
 import android.util.Log
+import java.io.File
 import java.nio.ByteBuffer
 import java.nio.ByteOrder
 
@@ -92,6 +93,46 @@ class AudioProcessor {
         nativeProcessAudio(inputBuffer, outputBuffer, frameCount)
     }
 
+    /**
+     * Process raw microphone capture and stream it
+     * Gain, noise gate, noise suppression, AGC and limiting run natively
+     * (see setMicChain), so the capture thread does no per-sample work.
+     * @param pcmBuffer Direct buffer of 16-bit PCM as read from AudioRecord (see createCaptureBuffer)
+     * @param frameCount Number of samples in pcmBuffer
+     */
+    fun processCapture(pcmBuffer: ByteBuffer, frameCount: Int) {
+        if (!isInitialized) {
+            Log.w(TAG, "Audio processor not initialized")
+            return
+        }
+
+        nativeProcessCapture(pcmBuffer, frameCount)
+    }
+
+    /**
+     * Configure the native microphone DSP chain
+     * Noise suppression adds about 11 ms of latency and AGC 5 ms.
+     * @param gain Input gain, 0.1x - 5.0x
+     * @param noiseGate Gate with hysteresis (opens at -45 dBFS, closes below -52 dBFS)
+     * @param noiseSuppression Spectral (Wiener) noise suppression, up to 20 dB
+     * @param autoGain Look-ahead AGC towards -20 dBFS RMS
+     * @param limiter Soft limiter above 0.9 full scale
+     */
+    fun setMicChain(
+        gain: Float,
+        noiseGate: Boolean = false,
+        noiseSuppression: Boolean = false,
+        autoGain: Boolean = false,
+        limiter: Boolean = true
+    ) {
+        if (!isInitialized) {
+            Log.w(TAG, "Audio processor not initialized")
+            return
+        }
+
+        nativeSetMicChain(gain, noiseGate, noiseSuppression, autoGain, limiter)
+    }
+
     /**
      * Update OSC destination for audio streaming
      * @param host Target host address
@@ -121,6 +162,149 @@ class AudioProcessor {
         nativeSetOSCAddress(address)
     }
 
+    /**
+     * Select the OSC transport for audio streams
+     * TCP delivers every message in order (for recording on a stable LAN);
+     * if its backlog grows older than the latency budget, messages fall back
+     * to UDP until it drains.
+     * @param useTcp true for OSC 1.1 over TCP (SLIP framed), false for UDP
+     * @param latencyBudgetMs Maximum TCP backlog age before falling back to UDP
+     */
+    fun setOSCTransport(useTcp: Boolean, latencyBudgetMs: Int = 50) {
+        if (!isInitialized) {
+            Log.w(TAG, "Audio processor not initialized")
+            return
+        }
+
+        Log.i(TAG, "Setting OSC transport: ${if (useTcp) "TCP" else "UDP"}")
+        nativeSetOSCTransport(useTcp, latencyBudgetMs)
+    }
+
+    /**
+     * Send audio through the shared-memory ring of a receiver on this device
+     * The receiver must be listening with -l shm:<path>; until the ring
+     * exists, messages go over UDP. Call setOSCTransport() to leave this mode.
+     * @param path Ring file path, e.g. /data/local/tmp/osc-audio
+     */
+    fun setSharedMemoryDestination(path: String) {
+        if (!isInitialized) {
+            Log.w(TAG, "Audio processor not initialized")
+            return
+        }
+
+        Log.i(TAG, "Setting OSC transport: shared memory $path")
+        nativeSetSharedMemoryDestination(path)
+    }
+
+    /**
+     * Apply an oscTransport node parameter: "udp", "tcp" or "shm:<path>"
+     */
+    fun selectOSCTransport(spec: String) {
+        if (spec.startsWith("shm:")) {
+            setSharedMemoryDestination(spec.removePrefix("shm:"))
+        } else {
+            setOSCTransport(spec == "tcp")
+        }
+    }
+
+    /**
+     * Send an analysis feature vector (e.g. 40 MFCCs per frame)
+     * Quantized and delta-coded per address unless setFeatureEncoding(0) was called.
+     * @param address OSC address, e.g. "/analysis/mfcc"
+     * @param features Feature values (at most 256)
+     */
+    fun sendFeatures(address: String, features: FloatArray) {
+        if (!isInitialized) {
+            return
+        }
+        nativeSendFeatures(address, features)
+    }
+
+    /**
+     * Select the analysis feature encoding
+     * @param bits 16 (default) or 8 for quantized, delta-coded vectors; 0 for text floats
+     * @param keyframeInterval Frames between keyframes; a receiver that lost a
+     *        packet resumes at the next keyframe
+     */
+    fun setFeatureEncoding(bits: Int, keyframeInterval: Int = 50) {
+        if (!isInitialized) {
+            Log.w(TAG, "Audio processor not initialized")
+            return
+        }
+
+        Log.i(TAG, "Setting feature encoding: $bits bits, keyframe every $keyframeInterval frames")
+        nativeSetFeatureEncoding(bits, keyframeInterval)
+    }
+
+    /**
+     * Run a feature model on the microphone stream
+     * Audio features (RMS dB, zero-crossing rate, spectral centroid, rolloff,
+     * flatness and flux, in that order) are extracted natively every 512
+     * samples; each window of frames is evaluated in one batch and the mean
+     * model output sent as a feature vector to address.
+     * @param modelBytes .mpml model file contents taking those 6 features
+     * @param address OSC address for the results, e.g. "/analysis/model"
+     * @param windowFrames Feature frames per evaluation (1-64)
+     * @return false if the model is invalid or takes other inputs
+     */
+    fun setCaptureModel(modelBytes: ByteArray, address: String, windowFrames: Int = 8): Boolean {
+        if (!isInitialized) {
+            Log.w(TAG, "Audio processor not initialized")
+            return false
+        }
+
+        Log.i(TAG, "Setting capture model: ${modelBytes.size} bytes to $address")
+        return nativeSetCaptureModel(modelBytes, address, windowFrames)
+    }
+
+    /**
+     * Stop running the capture feature model
+     */
+    fun clearCaptureModel() {
+        if (!isInitialized) {
+            return
+        }
+        nativeClearCaptureModel()
+    }
+
+    /**
+     * Load processing node plugins from a directory of shared libraries
+     * built against libmedia_pipeline's plugin_abi.h (e.g. the app's native
+     * library directory); nodes are then inserted with setCapturePlugins()
+     * @return Number of libraries loaded; failures are logged
+     */
+    fun loadPlugins(directory: File): Int {
+        return try {
+            nativeLoadPlugins(directory.absolutePath)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Native method not found - library may not be loaded", e)
+            0
+        }
+    }
+
+    /**
+     * Run plugin nodes on the processed capture stream, in order, before it is sent
+     * @param ids Plugin node ids; empty to remove them all
+     * @return false if a node is unknown or fails to start (the previous nodes keep running)
+     */
+    fun setCapturePlugins(ids: List<String>): Boolean {
+        if (!isInitialized) {
+            Log.w(TAG, "Audio processor not initialized")
+            return false
+        }
+        return nativeSetCapturePlugins(ids.toTypedArray())
+    }
+
+    /**
+     * Set a parameter of a running capture plugin node, from the next capture block
+     */
+    fun setCapturePluginParameter(id: String, parameter: String, value: Float): Boolean {
+        if (!isInitialized) {
+            return false
+        }
+        return nativeSetCapturePluginParameter(id, parameter, value)
+    }
+
     /**
      * Update the sine wave frequency
      * @param frequency Frequency in Hz
@@ -135,6 +319,37 @@ class AudioProcessor {
         nativeSetFrequency(frequency)
     }
 
+    /**
+     * Raise the calling thread to audio priority
+     * Call once at the top of a processing thread. Tries SCHED_FIFO and falls
+     * back to urgent-audio nice; also enables denormal flushing for the thread.
+     * @param cpu Core to pin the thread to, -1 to leave affinity alone
+     * @return true if the priority was raised
+     */
+    fun configureAudioThread(cpu: Int = -1): Boolean {
+        return try {
+            nativeConfigureAudioThread(cpu)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Native method not found - library may not be loaded", e)
+            false
+        }
+    }
+
+    /**
+     * Write the native pipeline trace (Chrome trace JSON, opens in ui.perfetto.dev)
+     * Empty unless the native library was built with ENABLE_TRACING.
+     * @param file Destination, e.g. File(context.filesDir, "trace.json")
+     * @return true if the file was written
+     */
+    fun dumpTrace(file: File): Boolean {
+        return try {
+            nativeDumpTrace(file.absolutePath)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Native method not found - library may not be loaded", e)
+            false
+        }
+    }
+
     /**
      * Create a direct ByteBuffer for efficient native access
      * @param sizeInFloats Buffer size in float elements
@@ -144,6 +359,15 @@ class AudioProcessor {
             .order(ByteOrder.nativeOrder())
     }
 
+    /**
+     * Create a direct ByteBuffer for 16-bit capture (AudioRecord.read target)
+     * @param sizeInSamples Buffer size in samples
+     */
+    fun createCaptureBuffer(sizeInSamples: Int = bufferSize): ByteBuffer {
+        return ByteBuffer.allocateDirect(sizeInSamples * 2) // 2 bytes per sample
+            .order(ByteOrder.nativeOrder())
+    }
+
     /**
      * Shutdown the audio processor and cleanup native resources
      */
@@ -178,6 +402,16 @@ class AudioProcessor {
         frameCount: Int
     )
 
+    private external fun nativeProcessCapture(pcmBuffer: ByteBuffer, frameCount: Int)
+
+    private external fun nativeSetMicChain(
+        gain: Float,
+        noiseGate: Boolean,
+        noiseSuppression: Boolean,
+        autoGain: Boolean,
+        limiter: Boolean
+    )
+
     private external fun nativeShutdown()
 
     private external fun nativeUpdateOSCDestination(host: String, port: Int)
@@ -185,4 +419,26 @@ class AudioProcessor {
     private external fun nativeSetOSCAddress(address: String)
 
     private external fun nativeSetFrequency(frequency: Float)
+
+    private external fun nativeSetOSCTransport(useTcp: Boolean, latencyBudgetMs: Int)
+
+    private external fun nativeSetSharedMemoryDestination(name: String)
+
+    private external fun nativeSendFeatures(address: String, features: FloatArray)
+
+    private external fun nativeSetFeatureEncoding(bits: Int, keyframeInterval: Int)
+
+    private external fun nativeSetCaptureModel(modelBytes: ByteArray, address: String, windowFrames: Int): Boolean
+
+    private external fun nativeClearCaptureModel()
+
+    private external fun nativeConfigureAudioThread(cpu: Int): Boolean
+
+    private external fun nativeLoadPlugins(directory: String): Int
+
+    private external fun nativeSetCapturePlugins(ids: Array<String>): Boolean
+
+    private external fun nativeSetCapturePluginParameter(id: String, parameter: String, value: Float): Boolean
+
+    private external fun nativeDumpTrace(path: String): Boolean
 }
\ No newline at end of file
@@ -9,7 +9,6 @@ import android.util.Log
 import androidx.core.content.ContextCompat
 import kotlinx.coroutines.*
 import java.nio.ByteBuffer
-import java.nio.ByteOrder
 
 /**
  * Microphone input processor with real-time OSC streaming
@@ -44,10 +43,14 @@ class MicrophoneProcessor : NodeProcessor {
     private val parameters = mutableMapOf<String, Any>(
         "gain" to 1.0f,
         "enableNoiseReduction" to false,
+        "enableNoiseGate" to false,
+        "enableAgc" to false,
+        "enableLimiter" to true,
         "streamEnabled" to false,
         "oscHost" to "127.0.0.1",
         "oscPort" to 8000,
-        "oscAddress" to "/chan1/audio"
+        "oscAddress" to "/chan1/audio",
+        "oscTransport" to "udp"
     )
 
     override suspend fun initialize(config: ProcessingNodeConfig): Boolean {
@@ -74,6 +77,8 @@ class MicrophoneProcessor : NodeProcessor {
 
             audioProcessor.updateOSCDestination(host, port)
             audioProcessor.setOSCAddress(address)
+            audioProcessor.selectOSCTransport(parameters["oscTransport"] as String)
+            applyMicChain()
 
             // Note: Permission check should be handled by the app before using this processor
             Log.d(TAG, "Initializing microphone - ensure RECORD_AUDIO permission is granted")
@@ -154,9 +159,11 @@ class MicrophoneProcessor : NodeProcessor {
         isProcessingActive = true
 
         processingThread = Thread {
-            val buffer = ShortArray(bufferSize)
-            val outputBuffer = ByteBuffer.allocateDirect(bufferSize * 4) // 4 bytes per float
-                .order(ByteOrder.nativeOrder())
+            audioProcessor.configureAudioThread()
+
+            // Raw 16-bit capture goes straight to native code, which runs the
+            // gain, gate, noise suppression, AGC and limiter (see applyMicChain)
+            val pcmBuffer = audioProcessor.createCaptureBuffer(bufferSize)
 
             while (isProcessingActive && !Thread.currentThread().isInterrupted) {
                 try {
@@ -170,56 +177,28 @@ class MicrophoneProcessor : NodeProcessor {
                     if (shouldExit) break
 
                     if (isRecording && audioRecord?.recordingState == AudioRecord.RECORDSTATE_RECORDING) {
-                        val samplesRead = audioRecord?.read(buffer, 0, buffer.size) ?: 0
+                        // Blocks until a buffer is captured, which paces the loop
+                        val bytesRead = audioRecord?.read(pcmBuffer, bufferSize * 2) ?: 0
+                        val samplesRead = bytesRead / 2
 
                         if (samplesRead > 0) {
-                            // Convert to float and apply gain
-                            outputBuffer.clear()
-                            val gain = parameters["gain"] as Float
-                            val enableNoiseReduction = parameters["enableNoiseReduction"] as Boolean
-
-                            for (i in 0 until samplesRead) {
-                                var sample = buffer[i].toFloat() / Short.MAX_VALUE
-
-                                // Apply gain
-                                sample *= gain
-
-                                // Apply basic noise reduction if enabled
-                                if (enableNoiseReduction && kotlin.math.abs(sample) < 0.01f) {
-                                    sample *= 0.1f // Reduce by 90%
-                                }
-
-                                // Prevent clipping
-                                sample = sample.coerceIn(-1f, 1f)
-
-                                outputBuffer.putFloat(sample)
-                            }
-
-                            outputBuffer.flip()
-
                             // Check again before native call - most critical section
                             val shouldSkip = synchronized(cleanupLock) {
                                 if (isCleaningUp || !isInitialized) {
                                     Log.i(TAG, "Cleanup started, skipping audio processing")
                                     true
                                 } else {
-                                    // Process through AudioProcessor for proper OSC formatting
-                                    val dummyOutputBuffer = ByteBuffer.allocateDirect(samplesRead * 4).order(ByteOrder.nativeOrder())
-                                    audioProcessor.processAudio(
-                                        inputBuffer = outputBuffer,
-                                        outputBuffer = dummyOutputBuffer, // AudioProcessor requires non-null output
-                                        frameCount = samplesRead
-                                    )
+                                    audioProcessor.processCapture(pcmBuffer, samplesRead)
                                     false
                                 }
                             }
                             if (shouldSkip) break
                         }
+                    } else {
+                        // Not recording: idle without spinning
+                        Thread.sleep(10)
                     }
 
-                    // Sleep for a short time to prevent excessive CPU usage
-                    Thread.sleep(10)
-
                 } catch (e: InterruptedException) {
                     Log.i(TAG, "Processing thread interrupted")
                     break
@@ -335,13 +314,17 @@ class MicrophoneProcessor : NodeProcessor {
     }
 
     override fun updateParameter(name: String, value: Any) {
-        // Update internal parameter storage
-        parameters[name] = value
+        // Update internal parameter storage ("noiseReduction" is the UI's name)
+        val key = if (name == "noiseReduction") "enableNoiseReduction" else name
+        parameters[key] = value
 
         // Apply changes immediately if initialized and not cleaning up
         synchronized(cleanupLock) {
             if (isInitialized && !isCleaningUp) {
-                when (name) {
+                when (key) {
+                    "gain", "enableNoiseReduction", "enableNoiseGate", "enableAgc", "enableLimiter" -> {
+                        applyMicChain()
+                    }
                     "oscHost" -> {
                         val port = parameters["oscPort"] as Int
                         audioProcessor.updateOSCDestination(value.toString(), port)
@@ -353,6 +336,9 @@ class MicrophoneProcessor : NodeProcessor {
                     "oscAddress" -> {
                         audioProcessor.setOSCAddress(value.toString())
                     }
+                    "oscTransport" -> {
+                        audioProcessor.selectOSCTransport(value.toString())
+                    }
                     "streamEnabled" -> {
                         val enabled = when (value) {
                             is Boolean -> value
@@ -372,6 +358,24 @@ class MicrophoneProcessor : NodeProcessor {
         Log.d(TAG, "Updated parameter $name = $value")
     }
 
+    /**
+     * Push the DSP parameters to the native mic chain
+     */
+    private fun applyMicChain() {
+        fun flag(name: String) = when (val value = parameters[name]) {
+            is Boolean -> value
+            is String -> value.toBoolean()
+            else -> false
+        }
+        audioProcessor.setMicChain(
+            gain = (parameters["gain"] as? Number)?.toFloat() ?: 1.0f,
+            noiseGate = flag("enableNoiseGate"),
+            noiseSuppression = flag("enableNoiseReduction"),
+            autoGain = flag("enableAgc"),
+            limiter = flag("enableLimiter")
+        )
+    }
+
     // Public methods for UI access
     fun getCurrentAudioLevel(): Float {
         // This could be implemented to return current RMS level
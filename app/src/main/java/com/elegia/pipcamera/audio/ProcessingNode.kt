@@ -209,7 +209,8 @@ class SineGeneratorProcessor : NodeProcessor {
         "amplitude" to 0.5f,
         "oscHost" to "127.0.0.1",
         "oscPort" to 8000,
-        "oscAddress" to "/audio/stream"
+        "oscAddress" to "/audio/stream",
+        "oscTransport" to "udp"
     )
 
     override suspend fun initialize(config: ProcessingNodeConfig): Boolean {
@@ -237,6 +238,7 @@ class SineGeneratorProcessor : NodeProcessor {
 
             audioProcessor.updateOSCDestination(host, port)
             audioProcessor.setOSCAddress(address)
+            audioProcessor.selectOSCTransport(parameters["oscTransport"] as String)
 
             Log.i("SineGeneratorProcessor", "Initialization completed successfully")
 
@@ -324,6 +326,7 @@ class SineGeneratorProcessor : NodeProcessor {
         isProcessingActive = true
         processingThread = Thread {
             Log.i("SineGeneratorProcessor", "Processing thread started")
+            audioProcessor.configureAudioThread()
 
             // Create dummy buffers for processing
             val outputBuffer = java.nio.ByteBuffer.allocateDirect(512 * 4) // 512 floats
@@ -408,6 +411,9 @@ class SineGeneratorProcessor : NodeProcessor {
                 "oscAddress" -> {
                     audioProcessor.setOSCAddress(value.toString())
                 }
+                "oscTransport" -> {
+                    audioProcessor.selectOSCTransport(value.toString())
+                }
                 "streamEnabled" -> {
                     isStreamEnabled = value as Boolean
                     Log.i("SineGeneratorProcessor", "Stream enabled: $isStreamEnabled")
@@ -48,8 +48,12 @@ object ProcessorFunctions {
     val registryProcessor: ProcessorFunction = { features ->
         // Create a simple synchronous wrapper for the registry
         try {
-            // Simple weighted sum as fallback since ProcessorRegistry.processFeatures is suspend
-            if (features.isNotEmpty()) {
+            val current = ProcessorRegistry.getCurrentProcessor()
+            if (current is NativeModelProcessor) {
+                // Native models evaluate synchronously
+                current.evaluate(features)
+            } else if (features.isNotEmpty()) {
+                // Simple weighted sum as fallback since ProcessorRegistry.processFeatures is suspend
                 val weights = listOf(0.3f, 0.2f, 0.1f, 0.15f, 0.1f, 0.05f, 0.05f, 0.05f)
                 features.take(8).mapIndexed { index, feature ->
                     feature * weights.getOrElse(index) { 0.1f }
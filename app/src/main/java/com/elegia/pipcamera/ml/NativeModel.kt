@@ -0,0 +1,68 @@
+package com.elegia.pipcamera.ml
+
+import android.util.Log
+import java.io.File
+
+/**
+ * Native inference model: linear/logistic regression, Weka decision trees
+ * and random forests, or a small MLP, loaded from a compact .mpml file
+ * (layout in media_pipeline/inference.h)
+ *
+ * Weights stay in native memory and a whole window of frames is evaluated
+ * in one JNI call, so there is no boxing and no per-frame crossing.
+ * Calls are serialized on the instance (the native model has scratch state).
+ */
+class NativeModel private constructor(private var handle: Long) : AutoCloseable {
+    companion object {
+        private const val TAG = "NativeModel"
+
+        init {
+            try {
+                System.loadLibrary("audio_pipeline")
+            } catch (e: UnsatisfiedLinkError) {
+                Log.e(TAG, "Failed to load native audio pipeline library", e)
+            }
+        }
+
+        /**
+         * Parse a model from file contents
+         * @return null if the bytes are not a valid model
+         */
+        fun load(bytes: ByteArray): NativeModel? {
+            val handle = nativeLoad(bytes)
+            return if (handle != 0L) NativeModel(handle) else null
+        }
+
+        fun load(file: File): NativeModel? = load(file.readBytes())
+
+        @JvmStatic private external fun nativeLoad(bytes: ByteArray): Long
+        @JvmStatic private external fun nativeGetInputCount(handle: Long): Int
+        @JvmStatic private external fun nativeGetOutputCount(handle: Long): Int
+        @JvmStatic private external fun nativePredict(
+            handle: Long, frames: FloatArray, frameCount: Int, outputs: FloatArray
+        ): Boolean
+        @JvmStatic private external fun nativeDestroy(handle: Long)
+    }
+
+    val inputCount: Int = nativeGetInputCount(handle)
+    val outputCount: Int = nativeGetOutputCount(handle)
+
+    /**
+     * Evaluate frameCount frames
+     * @param frames frameCount rows of inputCount features, packed
+     * @param outputs Receives frameCount rows of outputCount values
+     */
+    @Synchronized
+    fun predict(frames: FloatArray, frameCount: Int, outputs: FloatArray): Boolean {
+        if (handle == 0L) return false
+        return nativePredict(handle, frames, frameCount, outputs)
+    }
+
+    @Synchronized
+    override fun close() {
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+}
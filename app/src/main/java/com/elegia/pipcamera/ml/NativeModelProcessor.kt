@@ -0,0 +1,95 @@
+package com.elegia.pipcamera.ml
+
+import android.util.Log
+import java.io.File
+
+/**
+ * FeatureProcessor backed by a NativeModel file
+ *
+ * Output mapping to the processor range [-1, 1]:
+ *   one output (regression):      the value, clamped
+ *   K outputs (class distribution): expected class index scaled to [-1, 1],
+ *                                   so two classes give p(1) * 2 - 1 as the
+ *                                   Weka processors do
+ */
+class NativeModelProcessor(private val modelFile: File) : FeatureProcessor {
+    companion object {
+        private const val TAG = "NativeModelProcessor"
+        const val FILE_EXTENSION = "mpml"
+    }
+
+    override val name = "Native ${modelFile.nameWithoutExtension}"
+    override val description = "Native inference model ${modelFile.name}"
+    override var isAvailable = false
+        private set
+
+    private var model: NativeModel? = null
+    private var frame = FloatArray(0)
+    private var outputs = FloatArray(0)
+
+    override suspend fun initialize(): Boolean {
+        model?.close()
+        model = try {
+            NativeModel.load(modelFile)
+        } catch (e: Exception) {
+            Log.e(TAG, "Failed to read ${modelFile.path}", e)
+            null
+        }
+        isAvailable = model != null
+        return isAvailable
+    }
+
+    override suspend fun process(features: List<Float>): Float = evaluate(features)
+
+    /**
+     * Synchronous single-frame evaluation (for the non-suspend processor functions)
+     * Missing features are zero, extra ones ignored.
+     */
+    @Synchronized
+    fun evaluate(features: List<Float>): Float {
+        val current = model ?: return 0f
+        if (frame.size != current.inputCount) {
+            frame = FloatArray(current.inputCount)
+            outputs = FloatArray(current.outputCount)
+        }
+        for (i in frame.indices) {
+            frame[i] = features.getOrElse(i) { 0f }
+        }
+        return if (current.predict(frame, 1, outputs)) toScalar(outputs, 0, current.outputCount) else 0f
+    }
+
+    /**
+     * Evaluate a window of frames in one native call
+     * @param frames frameCount rows of the model's inputCount features
+     * @param results Receives one scalar per frame
+     */
+    @Synchronized
+    fun evaluateBatch(frames: FloatArray, frameCount: Int, results: FloatArray): Boolean {
+        val current = model ?: return false
+        val batchOutputs = FloatArray(frameCount * current.outputCount)
+        if (!current.predict(frames, frameCount, batchOutputs)) {
+            return false
+        }
+        for (f in 0 until frameCount) {
+            results[f] = toScalar(batchOutputs, f * current.outputCount, current.outputCount)
+        }
+        return true
+    }
+
+    private fun toScalar(values: FloatArray, offset: Int, count: Int): Float {
+        if (count == 1) {
+            return values[offset].coerceIn(-1f, 1f)
+        }
+        var expected = 0f
+        for (k in 0 until count) {
+            expected += k * values[offset + k]
+        }
+        return (expected / (count - 1) * 2f - 1f).coerceIn(-1f, 1f)
+    }
+
+    override fun cleanup() {
+        model?.close()
+        model = null
+        isAvailable = false
+    }
+}
@@ -3,6 +3,7 @@ package com.elegia.pipcamera.ml
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.launch
+import java.io.File
 
 /**
  * Registry for managing available feature processors
@@ -51,6 +52,18 @@ object ProcessorRegistry {
         }
     }
 
+    /**
+     * Register a NativeModelProcessor for every .mpml model file in directory
+     * @return number of models found
+     */
+    fun registerNativeModels(directory: File): Int {
+        val files = directory.listFiles { file ->
+            file.isFile && file.extension == NativeModelProcessor.FILE_EXTENSION
+        } ?: return 0
+        files.forEach { registerProcessor(NativeModelProcessor(it)) }
+        return files.size
+    }
+
     /**
      * Get all available processors
      */
@@ -71,8 +71,7 @@ class AdvancedAudioPipeline(private val context: Context) {
                 nodeId = "udp_stream",
                 targetHost = targetHost,
                 targetPort = targetPort,
-                maxPacketSize = 1400,
-                enableSequencing = true
+                maxPacketSize = 1400
             )
             pipeline.addNode("udp_stream", udpNode)
             pipeline.connect(lastNodeId, "udp_stream")
@@ -82,8 +81,7 @@ class AdvancedAudioPipeline(private val context: Context) {
                 nodeId = "raw_udp_stream",
                 targetHost = targetHost,
                 targetPort = targetPort + 1, // Use different port for raw audio
-                maxPacketSize = 1400,
-                enableSequencing = true
+                maxPacketSize = 1400
             )
             pipeline.addNode("raw_udp_stream", rawUdpNode)
 
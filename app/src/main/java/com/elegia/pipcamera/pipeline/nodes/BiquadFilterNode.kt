@@ -0,0 +1,88 @@
+package com.elegia.pipcamera.pipeline.nodes
+
+import android.content.Context
+import android.util.Log
+import com.elegia.pipcamera.pipeline.MediaData
+import com.elegia.pipcamera.pipeline.MediaNode
+
+/**
+ * Equalizer / filter node for 16-bit PCM audio frames
+ * Runs the bands in order as a native biquad cascade, one SIMD lane per
+ * channel, filtering each frame's buffer in place. The bank is created on the
+ * first frame, when the channel count and sample rate are known.
+ */
+class BiquadFilterNode(
+    nodeId: String,
+    bands: List<Band>,
+    private val rampMs: Double = 50.0
+) : MediaNode(nodeId) {
+
+    companion object {
+        private const val TAG = "BiquadFilterNode"
+    }
+
+    data class Band(
+        val type: NativeBiquadBank.FilterType,
+        val frequency: Double,
+        val q: Double = 0.707,
+        val gainDb: Double = 0.0
+    )
+
+    private val bands = bands.toMutableList()
+    private var bank: NativeBiquadBank? = null
+    private var sampleRate = 0
+
+    override suspend fun initialize(context: Context): Boolean {
+        if (bands.isEmpty()) {
+            Log.e(TAG, "No filter bands")
+            return false
+        }
+        Log.i(TAG, "Biquad filter initialized: ${bands.size} bands")
+        return true
+    }
+
+    override suspend fun process(input: MediaData): MediaData? {
+        if (input !is MediaData.AudioFrame) {
+            return input
+        }
+
+        // Held while filtering too: cleanup() must not free the bank under it
+        synchronized(this) {
+            var current = bank
+            if (current == null || current.lanes != input.channels || sampleRate != input.sampleRate) {
+                current?.close()
+                current = NativeBiquadBank(input.channels, bands.size)
+                sampleRate = input.sampleRate
+                bands.forEachIndexed { index, band -> applyBand(current, index, band, 0) }
+                bank = current
+            }
+            if (!current.processPcm16(input.buffer)) {
+                Log.w(TAG, "Filtering failed, passing the frame through")
+            }
+        }
+        return input
+    }
+
+    /**
+     * Retune a band on every channel, gliding over rampMs
+     */
+    fun setBand(index: Int, band: Band): Boolean = synchronized(this) {
+        if (index !in bands.indices) return false
+        bands[index] = band
+        val current = bank ?: return true
+        return applyBand(current, index, band, (rampMs * sampleRate / 1000.0).toInt())
+    }
+
+    fun getBands(): List<Band> = synchronized(this) { bands.toList() }
+
+    private fun applyBand(bank: NativeBiquadBank, index: Int, band: Band, rampFrames: Int): Boolean {
+        return bank.setFilter(-1, index, band.type, sampleRate, band.frequency, band.q, band.gainDb, rampFrames)
+    }
+
+    override suspend fun cleanup() {
+        synchronized(this) {
+            bank?.close()
+            bank = null
+        }
+    }
+}
@@ -0,0 +1,98 @@
+package com.elegia.pipcamera.pipeline.nodes
+
+import android.util.Log
+import java.nio.ByteBuffer
+
+/**
+ * Native bank of biquad filter cascades (media_pipeline/biquad.h)
+ * Interleaved channels run side by side in SIMD lanes, each through its own
+ * cascade of RBJ cookbook sections. Retuning glides over a ramp, so filters
+ * can follow a UI control without zipper noise.
+ */
+class NativeBiquadBank(val lanes: Int, val stages: Int) : AutoCloseable {
+    companion object {
+        private const val TAG = "NativeBiquadBank"
+
+        init {
+            try {
+                System.loadLibrary("audio_pipeline")
+            } catch (e: UnsatisfiedLinkError) {
+                Log.e(TAG, "Failed to load native audio pipeline library", e)
+            }
+        }
+
+        @JvmStatic private external fun nativeCreate(lanes: Int, stages: Int): Long
+        @JvmStatic private external fun nativeSetFilter(
+            handle: Long, lane: Int, stage: Int, type: Int, sampleRate: Double,
+            frequency: Double, q: Double, gainDb: Double, rampFrames: Int
+        ): Boolean
+        @JvmStatic private external fun nativeProcessPcm16(
+            handle: Long, buffer: ByteBuffer, offset: Int, frameCount: Int
+        ): Boolean
+        @JvmStatic private external fun nativeReset(handle: Long)
+        @JvmStatic private external fun nativeDestroy(handle: Long)
+    }
+
+    /** Same order as BiquadCoefficients::Type */
+    enum class FilterType {
+        LOWPASS,
+        HIGHPASS,
+        BANDPASS,
+        NOTCH,
+        ALLPASS,
+        PEAKING,
+        LOW_SHELF,
+        HIGH_SHELF
+    }
+
+    private var handle: Long = nativeCreate(lanes, stages)
+
+    /**
+     * Design one section
+     * @param lane Lane (channel) index, or -1 for every lane
+     * @param gainDb Peaking and shelf gain; ignored by the other types
+     * @param rampFrames Frames to glide from the current design, 0 to switch at once
+     */
+    fun setFilter(
+        lane: Int, stage: Int, type: FilterType, sampleRate: Int, frequency: Double,
+        q: Double, gainDb: Double = 0.0, rampFrames: Int = 0
+    ): Boolean {
+        if (handle == 0L) return false
+        return nativeSetFilter(
+            handle, lane, stage, type.ordinal, sampleRate.toDouble(), frequency, q, gainDb, rampFrames
+        )
+    }
+
+    /**
+     * Filter the buffer's remaining bytes in place: interleaved 16-bit PCM,
+     * native byte order, lanes samples per frame
+     * Heap buffers are copied through a direct buffer.
+     */
+    fun processPcm16(buffer: ByteBuffer): Boolean {
+        if (handle == 0L) return false
+        val frames = buffer.remaining() / (2 * lanes)
+        if (frames == 0) return true
+
+        if (buffer.isDirect) {
+            return nativeProcessPcm16(handle, buffer, buffer.position(), frames)
+        }
+        val direct = ByteBuffer.allocateDirect(frames * 2 * lanes)
+        direct.put(buffer.duplicate().limit(buffer.position() + frames * 2 * lanes) as ByteBuffer)
+        if (!nativeProcessPcm16(handle, direct, 0, frames)) return false
+        direct.flip()
+        buffer.duplicate().put(direct)
+        return true
+    }
+
+    /** Clear the filter state, e.g. between streams */
+    fun reset() {
+        if (handle != 0L) nativeReset(handle)
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+}
@@ -0,0 +1,76 @@
+package com.elegia.pipcamera.pipeline.nodes
+
+import android.util.Log
+import java.nio.ByteBuffer
+
+/**
+ * Native UDP stream packetizer
+ * Splits frames into sequenced packets (24-byte header, see
+ * media_pipeline/stream_packetizer.h) and sends them in batches without
+ * copying the payload
+ */
+class NativeStreamPacketizer(maxPacketSize: Int = 1400) : AutoCloseable {
+    companion object {
+        private const val TAG = "NativeStreamPacketizer"
+
+        init {
+            try {
+                System.loadLibrary("audio_pipeline")
+            } catch (e: UnsatisfiedLinkError) {
+                Log.e(TAG, "Failed to load native audio pipeline library", e)
+            }
+        }
+
+        @JvmStatic private external fun nativeCreate(maxPacketSize: Int): Long
+        @JvmStatic private external fun nativeSetDestination(handle: Long, host: String, port: Int): Boolean
+        @JvmStatic private external fun nativeSendFrame(
+            handle: Long, buffer: ByteBuffer, offset: Int, length: Int, timestamp: Long
+        ): Int
+        @JvmStatic private external fun nativeSendFrameArray(
+            handle: Long, array: ByteArray, offset: Int, length: Int, timestamp: Long
+        ): Int
+        @JvmStatic private external fun nativeDestroy(handle: Long)
+    }
+
+    private var handle: Long = nativeCreate(maxPacketSize)
+
+    /**
+     * Set the destination
+     * @param host Numeric IPv4 or IPv6 address
+     */
+    fun setDestination(host: String, port: Int): Boolean {
+        if (handle == 0L) return false
+        return nativeSetDestination(handle, host, port)
+    }
+
+    /**
+     * Send the buffer's remaining bytes (position to limit) as one frame
+     * The buffer's position is not changed.
+     * @return Packets sent, or -1 on failure
+     */
+    fun sendFrame(buffer: ByteBuffer, timestamp: Long): Int {
+        if (handle == 0L) return -1
+        val length = buffer.remaining()
+        if (length == 0) return 0
+
+        return when {
+            buffer.isDirect -> nativeSendFrame(handle, buffer, buffer.position(), length, timestamp)
+            buffer.hasArray() -> nativeSendFrameArray(
+                handle, buffer.array(), buffer.arrayOffset() + buffer.position(), length, timestamp
+            )
+            else -> {
+                // Read-only heap buffer: copy once
+                val copy = ByteArray(length)
+                buffer.duplicate().get(copy)
+                nativeSendFrameArray(handle, copy, 0, length, timestamp)
+            }
+        }
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+}
@@ -6,39 +6,36 @@ import com.elegia.pipcamera.pipeline.MediaData
 import com.elegia.pipcamera.pipeline.OutputNode
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.withContext
-import java.net.*
+import java.net.InetAddress
 import java.nio.ByteBuffer
-import java.util.concurrent.atomic.AtomicLong
 
 /**
  * High-performance UDP streaming output node
- * Handles proper packetization, sequencing, and error recovery
+ * Packetization, sequencing and sending are done natively by
+ * NativeStreamPacketizer; the osc_receiver host tool reassembles the stream
  */
 class UdpStreamOutputNode(
     nodeId: String,
     private val targetHost: String = "192.168.1.100",
     private val targetPort: Int = 8000,
-    private val maxPacketSize: Int = 1400, // Safe UDP size
-    private val enableSequencing: Boolean = true
+    private val maxPacketSize: Int = 1400 // Safe UDP size
 ) : OutputNode(nodeId) {
 
     companion object {
         private const val TAG = "UdpStreamOutput"
-        private const val HEADER_SIZE = 16 // bytes for packet header
     }
 
-    private var socket: DatagramSocket? = null
-    private var targetAddress: InetSocketAddress? = null
-    private val sequenceNumber = AtomicLong(0)
+    private var packetizer: NativeStreamPacketizer? = null
     private val statistics = StreamingStatistics()
 
     override suspend fun initialize(context: Context): Boolean = withContext(Dispatchers.IO) {
         try {
-            // Create UDP socket
-            socket = DatagramSocket()
-
-            // Resolve target address
-            targetAddress = InetSocketAddress(targetHost, targetPort)
+            val native = NativeStreamPacketizer(maxPacketSize)
+            if (!native.setDestination(resolve(targetHost), targetPort)) {
+                native.close()
+                return@withContext false
+            }
+            packetizer = native
 
             Log.i(TAG, "UDP stream initialized: $targetHost:$targetPort, max packet: ${maxPacketSize} bytes")
             return@withContext true
@@ -51,64 +48,25 @@ class UdpStreamOutputNode(
 
     override suspend fun outputData(data: MediaData) = withContext(Dispatchers.IO) {
         when (data) {
-            is MediaData.AudioFrame -> streamAudioFrame(data)
-            is MediaData.EncodedData -> streamEncodedData(data)
+            is MediaData.AudioFrame -> sendFrame(data.buffer, data.timestamp)
+            is MediaData.EncodedData -> {
+                Log.v(TAG, "Streaming ${data.buffer.remaining()} bytes (codec: ${data.codecType})")
+                sendFrame(data.buffer, data.timestamp)
+            }
             is MediaData.VideoFrame -> streamVideoFrame(data)
         }
     }
 
-    private suspend fun streamEncodedData(data: MediaData.EncodedData) {
-        val payload = data.buffer.array()
-        val totalSize = payload.size
-
-        // Calculate number of packets needed
-        val maxPayloadSize = maxPacketSize - HEADER_SIZE
-        val packetCount = (totalSize + maxPayloadSize - 1) / maxPayloadSize
-
-        Log.v(TAG, "Streaming ${totalSize} bytes in ${packetCount} packets (codec: ${data.codecType})")
-
-        for (packetIndex in 0 until packetCount) {
-            val offset = packetIndex * maxPayloadSize
-            val packetPayloadSize = minOf(maxPayloadSize, totalSize - offset)
-
-            sendPacket(
-                payload = payload,
-                offset = offset,
-                size = packetPayloadSize,
-                packetIndex = packetIndex,
-                totalPackets = packetCount,
-                timestamp = data.timestamp,
-                dataType = "encoded",
-                codecInfo = data.codecType
-            )
-        }
-
-        statistics.recordTransmission(totalSize, packetCount)
-    }
-
-    private suspend fun streamAudioFrame(data: MediaData.AudioFrame) {
-        val payload = data.buffer.array()
-        val totalSize = payload.size
-        val maxPayloadSize = maxPacketSize - HEADER_SIZE
-        val packetCount = (totalSize + maxPayloadSize - 1) / maxPayloadSize
-
-        for (packetIndex in 0 until packetCount) {
-            val offset = packetIndex * maxPayloadSize
-            val packetPayloadSize = minOf(maxPayloadSize, totalSize - offset)
-
-            sendPacket(
-                payload = payload,
-                offset = offset,
-                size = packetPayloadSize,
-                packetIndex = packetIndex,
-                totalPackets = packetCount,
-                timestamp = data.timestamp,
-                dataType = "audio",
-                codecInfo = "${data.sampleRate}Hz_${data.channels}ch"
-            )
+    private fun sendFrame(buffer: ByteBuffer, timestamp: Long) {
+        val native = packetizer ?: return
+        val size = buffer.remaining()
+        val packets = native.sendFrame(buffer, timestamp)
+        if (packets < 0) {
+            Log.e(TAG, "Failed to send $size byte frame")
+            statistics.recordError()
+        } else {
+            statistics.recordTransmission(size, packets)
         }
-
-        statistics.recordTransmission(totalSize, packetCount)
     }
 
     private suspend fun streamVideoFrame(data: MediaData.VideoFrame) {
@@ -116,77 +74,21 @@ class UdpStreamOutputNode(
         Log.w(TAG, "Video streaming not yet implemented")
     }
 
-    private suspend fun sendPacket(
-        payload: ByteArray,
-        offset: Int,
-        size: Int,
-        packetIndex: Int,
-        totalPackets: Int,
-        timestamp: Long,
-        dataType: String,
-        codecInfo: String
-    ) {
-        val sock = socket ?: return
-        val addr = targetAddress ?: return
-
-        try {
-            // Create packet with header
-            val packet = createPacketWithHeader(
-                payload, offset, size, packetIndex, totalPackets, timestamp, dataType, codecInfo
-            )
-
-            val datagramPacket = DatagramPacket(packet, packet.size, addr)
-            sock.send(datagramPacket)
-
-        } catch (e: Exception) {
-            Log.e(TAG, "Failed to send UDP packet", e)
-            statistics.recordError()
-        }
-    }
-
-    private fun createPacketWithHeader(
-        payload: ByteArray,
-        offset: Int,
-        size: Int,
-        packetIndex: Int,
-        totalPackets: Int,
-        timestamp: Long,
-        dataType: String,
-        codecInfo: String
-    ): ByteArray {
-        val header = ByteBuffer.allocate(HEADER_SIZE)
-
-        if (enableSequencing) {
-            header.putLong(sequenceNumber.incrementAndGet()) // 8 bytes: sequence number
-        } else {
-            header.putLong(timestamp) // 8 bytes: timestamp
-        }
-
-        header.putShort(packetIndex.toShort()) // 2 bytes: packet index
-        header.putShort(totalPackets.toShort()) // 2 bytes: total packets
-        header.putInt(size) // 4 bytes: payload size
-
-        // Combine header and payload
-        val packet = ByteArray(HEADER_SIZE + size)
-        System.arraycopy(header.array(), 0, packet, 0, HEADER_SIZE)
-        System.arraycopy(payload, offset, packet, HEADER_SIZE, size)
-
-        return packet
-    }
+    private fun resolve(host: String): String = InetAddress.getByName(host).hostAddress ?: host
 
     override suspend fun cleanup() {
-        socket?.close()
-        socket = null
-        targetAddress = null
+        packetizer?.close()
+        packetizer = null
         Log.i(TAG, "UDP stream cleanup completed. Stats: ${statistics.getSummary()}")
     }
 
     /**
      * Update streaming destination
      */
-    fun updateDestination(host: String, port: Int) {
-        targetAddress = InetSocketAddress(host, port)
-        Log.i(TAG, "Updated destination: $host:$port")
+    suspend fun updateDestination(host: String, port: Int) = withContext(Dispatchers.IO) {
+        if (packetizer?.setDestination(resolve(host), port) == true) {
+            Log.i(TAG, "Updated destination: $host:$port")
+        }
     }
 
     /**
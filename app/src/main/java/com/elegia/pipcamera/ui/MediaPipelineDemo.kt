@@ -30,7 +30,6 @@ fun MediaPipelineDemo(modifier: Modifier = Modifier) {
     var streamingPort by remember { mutableStateOf(8000) }
     var enableMLProcessing by remember { mutableStateOf(true) }
     var enableHardwareEncoding by remember { mutableStateOf(true) }
-    var enableSequencing by remember { mutableStateOf(true) }
 
     // Pipeline instances
     val advancedPipeline = remember { AdvancedAudioPipeline(context) }
@@ -94,12 +93,10 @@ fun MediaPipelineDemo(modifier: Modifier = Modifier) {
             streamingPort = streamingPort,
             enableMLProcessing = enableMLProcessing,
             enableHardwareEncoding = enableHardwareEncoding,
-            enableSequencing = enableSequencing,
             onHostChange = { streamingHost = it },
             onPortChange = { streamingPort = it },
             onMLProcessingChange = { enableMLProcessing = it },
             onHardwareEncodingChange = { enableHardwareEncoding = it },
-            onSequencingChange = { enableSequencing = it },
             isRunning = isRunning
         )
 
@@ -207,12 +204,10 @@ private fun ConfigurationPanel(
     streamingPort: Int,
     enableMLProcessing: Boolean,
     enableHardwareEncoding: Boolean,
-    enableSequencing: Boolean,
     onHostChange: (String) -> Unit,
     onPortChange: (Int) -> Unit,
     onMLProcessingChange: (Boolean) -> Unit,
     onHardwareEncodingChange: (Boolean) -> Unit,
-    onSequencingChange: (Boolean) -> Unit,
     isRunning: Boolean
 ) {
     Card(modifier = Modifier.fillMaxWidth()) {
@@ -272,19 +267,6 @@ private fun ConfigurationPanel(
                     )
                 }
             }
-
-            Row(
-                modifier = Modifier.fillMaxWidth(),
-                horizontalArrangement = Arrangement.SpaceBetween,
-                verticalAlignment = Alignment.CenterVertically
-            ) {
-                Text("Packet Sequencing")
-                Switch(
-                    checked = enableSequencing,
-                    onCheckedChange = onSequencingChange,
-                    enabled = !isRunning
-                )
-            }
         }
     }
 }
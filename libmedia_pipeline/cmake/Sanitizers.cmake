@@ -0,0 +1,10 @@
+# Sanitizer builds for the library and everything that includes this file
+# before adding its targets (the receiver does, so one option covers both)
+include_guard(GLOBAL)
+
+option(ENABLE_TSAN "Build with ThreadSanitizer" OFF)
+
+if(ENABLE_TSAN)
+    add_compile_options(-fsanitize=thread -g -fno-omit-frame-pointer)
+    add_link_options(-fsanitize=thread)
+endif()
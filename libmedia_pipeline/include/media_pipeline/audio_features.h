@@ -0,0 +1,62 @@
+#pragma once
+
+#include "media_pipeline/fft.h"
+
+#include <complex>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace media_pipeline {
+
+/**
+ * Frame-level audio features for the inference models
+ * Hann-windowed frames of frame_size samples, one every hop, analysed with
+ * a RealFft. All buffers are allocated at construction, so process() never
+ * allocates. One instance per stream (it keeps the previous spectrum for
+ * the flux).
+ */
+class AudioFeatureExtractor {
+public:
+    // Index of each value in a feature frame (the model input order)
+    enum Feature {
+        RMS_DB,              // dBFS, floored at -100
+        ZERO_CROSSING_RATE,  // Sign changes per sample
+        SPECTRAL_CENTROID,   // Hz
+        SPECTRAL_ROLLOFF,    // Hz below which 85% of the energy lies
+        SPECTRAL_FLATNESS,   // Geometric / arithmetic mean of the power, 0-1
+        SPECTRAL_FLUX,       // RMS of the per-bin magnitude increase since the last frame
+        kFeatureCount
+    };
+
+    // Called once per hop with kFeatureCount values
+    using FrameCallback = std::function<void(const float* features, size_t count)>;
+
+    /**
+     * @param frame_size Analysis frame (rounded up to a power of two)
+     * @param hop Frame advance, at most frame_size (else frame_size / 2)
+     */
+    explicit AudioFeatureExtractor(int sample_rate, size_t frame_size = 1024, size_t hop = 512);
+
+    void process(const float* samples, size_t count, const FrameCallback& callback);
+    void reset();
+
+    size_t getFrameSize() const { return fft_.getSize(); }
+    size_t getHop() const { return hop_; }
+
+private:
+    void analyseFrame(float* features);
+
+    int sample_rate_;
+    RealFft fft_;
+    size_t hop_;
+    size_t fill_;                        // Samples received towards the next frame
+    std::vector<float> window_;          // Periodic Hann
+    std::vector<float> input_;           // Last frame_size samples
+    std::vector<float> frame_;
+    std::vector<std::complex<float>> bins_;
+    std::vector<float> magnitude_;
+    std::vector<float> previous_magnitude_;
+};
+
+} // namespace media_pipeline
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace media_pipeline {
+
+/**
+ * Second-order section coefficients, a0 normalized to 1
+ */
+struct BiquadCoefficients {
+    enum class Type {
+        LOWPASS,
+        HIGHPASS,
+        BANDPASS,      // Constant 0 dB peak gain
+        NOTCH,
+        ALLPASS,
+        PEAKING,
+        LOW_SHELF,
+        HIGH_SHELF
+    };
+
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+
+    /**
+     * RBJ Audio EQ Cookbook design
+     * @param frequency Corner or center frequency in Hz, clamped below Nyquist
+     * @param q Quality factor (shelves: slope-equivalent Q, 0.707 for the classic shelf)
+     * @param gain_db Peaking and shelf gain; ignored by the other types
+     */
+    static BiquadCoefficients design(Type type, double sample_rate, double frequency, double q, double gain_db = 0.0);
+
+    static const char* typeName(Type type);
+
+    /**
+     * @return false if name is not a type name ("lowpass", "peaking", "lowshelf", ...)
+     */
+    static bool parseType(const std::string& name, Type& type);
+
+    /**
+     * Magnitude response at frequency (for tests and displays)
+     */
+    double magnitude(double sample_rate, double frequency) const;
+};
+
+/**
+ * Bank of biquad cascades running side by side in SIMD lanes
+ *
+ * lane_count independent lanes (channels, streams, or bands fed the same
+ * input) each run a cascade of stage_count transposed direct form II
+ * sections. The lanes go through dsp::biquadCascade four or eight at a
+ * time, so a bank of eight filters costs about what one scalar filter does.
+ *
+ * Changes can ramp over a number of frames, updated every kRampStep frames
+ * with the state carried over, so there is no zipper noise or click:
+ *   setCoefficients()  interpolates the coefficients linearly. Between two
+ *                      stable sections every point is stable (the (a1, a2)
+ *                      stability region is convex), but the response in
+ *                      between can bulge: fine for small EQ moves.
+ *   setDesign()        glides the design instead (frequency geometrically,
+ *                      Q and gain linearly) and recomputes the section, so
+ *                      a sweep over octaves stays the filter it claims to be.
+ *
+ * Process and set coefficients from one thread; nothing allocates after
+ * construction.
+ */
+class BiquadBank {
+public:
+    static constexpr size_t kRampStep = 16;
+    static constexpr size_t kChunkFrames = 128;
+
+    BiquadBank(size_t lane_count, size_t stage_count);
+
+    size_t getLaneCount() const { return lanes_; }
+    size_t getStageCount() const { return stages_; }
+
+    /**
+     * @param ramp_frames Frames to glide from the current coefficients, 0 to switch at once
+     */
+    void setCoefficients(size_t lane, size_t stage, const BiquadCoefficients& coefficients, size_t ramp_frames = 0);
+
+    /** The same section on every lane */
+    void setCoefficientsAll(size_t stage, const BiquadCoefficients& coefficients, size_t ramp_frames = 0);
+
+    /**
+     * Design a cookbook section in place (see BiquadCoefficients::design)
+     * Ramps by design parameters when the section was last set with
+     * setDesign() of the same type and sample rate, else by coefficients.
+     */
+    void setDesign(size_t lane, size_t stage, BiquadCoefficients::Type type, double sample_rate, double frequency,
+                   double q, double gain_db = 0.0, size_t ramp_frames = 0);
+
+    /** Coefficients the lane is ramping to (or at) */
+    BiquadCoefficients getCoefficients(size_t lane, size_t stage) const;
+
+    /**
+     * Filter interleaved frames in place: frames rows of getLaneCount() samples
+     */
+    void process(float* data, size_t frames);
+
+    /**
+     * Filter one buffer per lane in place
+     */
+    void processPlanar(float* const* channels, size_t frames);
+
+    /**
+     * Clear the filter state (coefficients are kept; ramps finish at once)
+     */
+    void reset();
+
+private:
+    void runChunk(size_t frames);
+    void advanceRamps(size_t frames);
+    void writeCoefficient(size_t lane, size_t stage, const float* values);
+    void cancelRamp(size_t lane, size_t stage);
+
+    size_t lanes_;
+    size_t padded_;                     // lanes_ rounded up to a multiple of 4
+    size_t stages_;
+
+    std::vector<float> coefficients_;   // [stage][5][padded_], as the kernel reads them
+    std::vector<float> state_;          // [stage][2][padded_]
+    std::vector<float> scratch_;        // kChunkFrames rows of padded_
+
+    struct Design {
+        bool valid;
+        BiquadCoefficients::Type type;
+        double sample_rate;
+        double frequency;
+        double q;
+        double gain_db;
+    };
+
+    struct Ramp {
+        float start[5];
+        float target[5];
+        bool by_design;
+        Design from;                    // by_design: design parameters at the start
+        size_t elapsed;
+        size_t length;                  // 0: not ramping
+    };
+    std::vector<Ramp> ramps_;           // [lane * stages_ + stage]
+    std::vector<Design> designs_;       // Last setDesign() target, invalid after setCoefficients()
+    size_t active_ramps_;
+};
+
+} // namespace media_pipeline
@@ -4,6 +4,8 @@
 #include <vector>
 #include <mutex>
 
+namespace media_pipeline {
+
 /**
  * Buffer manager for efficient audio memory allocation
  * Abstracts buffer management for future optimization
@@ -65,4 +67,6 @@ private:
     std::mutex buffer_mutex_;
 
     void allocateBuffers();
-};
\ No newline at end of file
+};
+
+} // namespace media_pipeline
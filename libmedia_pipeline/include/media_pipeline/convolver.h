@@ -0,0 +1,145 @@
+#pragma once
+
+#include "media_pipeline/fft.h"
+#include "media_pipeline/thread_config.h"
+
+#include <atomic>
+#include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace media_pipeline {
+
+/**
+ * Zero-latency partitioned FFT convolution with a long impulse response
+ * (room correction, speaker EQ, reverb)
+ *
+ * The IR is split in two uniformly partitioned overlap-save stages, each
+ * with a frequency-domain delay line of input spectra multiplied against
+ * the IR partition spectra (dsp::complexMultiplyAccumulate):
+ *   head  partitions of block_size covering IR [0, 2 * tail_partition),
+ *         computed inside process(), so output has no added latency
+ *   tail  partitions of tail_partition covering the rest of the IR
+ * A tail block's output is first needed one tail_partition after its input
+ * is complete, so with background_tail the tail runs on a worker thread and
+ * the audio thread only hands it input and mixes finished blocks. A block
+ * the worker has not finished in time is left out (counted as late) rather
+ * than waited for. Without background_tail the tail is computed inline,
+ * which is deterministic but costs a spike every tail_partition samples.
+ *
+ * One instance per stream; process() from one thread only.
+ */
+class PartitionedConvolver {
+public:
+    struct Config {
+        size_t block_size = 256;         // Samples per process() block, power of two
+        size_t tail_partition = 0;       // Power of two multiple of block_size; 0: min(8192, 16 blocks)
+        bool background_tail = true;
+        ThreadConfig tail_thread;        // Applied to the worker ("conv-tail")
+    };
+
+    struct Stats {
+        size_t head_partitions;
+        size_t tail_partitions;
+        uint64_t tail_blocks_submitted;
+        uint64_t tail_blocks_completed;
+        uint64_t tail_blocks_late;       // Not ready when due, skipped
+    };
+
+    /**
+     * @param ir Impulse response, length samples (copied)
+     * @return nullptr (with error set) for an empty IR or an invalid config
+     */
+    static std::unique_ptr<PartitionedConvolver> create(const float* ir, size_t length, const Config& config,
+                                                        std::string& error);
+
+    ~PartitionedConvolver();
+
+    /**
+     * Convolve count samples; input and output may be the same buffer
+     * @return false (output untouched) unless count is a multiple of getBlockSize()
+     */
+    bool process(const float* input, float* output, size_t count);
+
+    /**
+     * Clear all signal history and the tail block counts (not the late
+     * count); waits for the worker to go idle
+     */
+    void reset();
+
+    size_t getBlockSize() const { return block_size_; }
+    size_t getTailPartition() const { return tail_size_; }
+    size_t getLength() const { return length_; }
+    Stats getStats() const;
+
+private:
+    // Uniformly partitioned overlap-save convolution with one IR segment
+    class Stage {
+    public:
+        Stage(const float* ir, size_t length, size_t partition);
+
+        // partition samples in, partition samples of output
+        void process(const float* input, float* output);
+        void reset();
+
+        size_t getPartitionCount() const { return spectra_.size(); }
+
+    private:
+        size_t partition_;
+        size_t bins_;
+        RealFft fft_;
+        std::vector<std::vector<std::complex<float>>> spectra_;  // IR partitions
+        std::vector<std::vector<std::complex<float>>> delay_;    // Input spectra, newest at head_
+        size_t head_;
+        std::vector<float> input_;                               // Previous and current input block
+        std::vector<float> time_;
+        std::vector<std::complex<float>> accumulator_;
+    };
+
+    PartitionedConvolver(const float* ir, size_t length, const Config& config, size_t tail_size);
+
+    void processBlock(const float* input, float* output);
+    void submitTail();
+    void computeTail(uint64_t index, const float* input);
+    void tailLoop();
+
+    static constexpr size_t kPendingBlocks = 4;
+
+    size_t block_size_;
+    size_t tail_size_;
+    size_t length_;
+    bool background_;
+    ThreadConfig tail_thread_config_;
+
+    std::unique_ptr<Stage> head_;
+    std::unique_ptr<Stage> tail_;
+
+    // Audio thread state
+    uint64_t position_;                   // Samples processed
+    std::vector<float> tail_input_;       // Input collected for the next tail block
+    bool mixing_tail_;                    // Current tail block was ready when it became due
+
+    // Tail handoff: input blocks by index % kPendingBlocks, output by index % 2
+    std::mutex tail_mutex_;
+    std::condition_variable tail_wake_;
+    std::condition_variable tail_idle_;
+    std::vector<float> pending_[kPendingBlocks];
+    uint64_t submitted_;                  // Guarded by tail_mutex_
+    uint64_t taken_;                      // Guarded by tail_mutex_
+    bool busy_;
+    bool stop_;
+    std::vector<float> tail_work_;        // Worker's copy of the block being computed
+    std::vector<float> tail_output_[2];
+    std::atomic<uint64_t> completed_;
+    std::atomic<uint64_t> submitted_count_;
+    std::atomic<uint64_t> late_;
+    std::thread tail_thread_;
+};
+
+} // namespace media_pipeline
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace media_pipeline {
+namespace dsp {
+
+/**
+ * Vectorized audio kernels: gain, mix, clip, sample format conversion
+ *
+ * Each kernel has a scalar reference implementation (dsp::reference) and
+ * SSE2/AVX2 (x86) or NEON (aarch64) variants picked once at startup from
+ * the running CPU. Every variant performs the same IEEE operations in the
+ * same order, so results are bit-identical to the reference; the kernel
+ * sources are compiled with -ffp-contract=off to keep it that way.
+ *
+ * Conversion conventions:
+ *   - int16/int24 full scale is 2^15 / 2^23 in both directions, so integer
+ *     samples round-trip exactly; +1.0 saturates to the largest code
+ *   - float to integer rounds to nearest, ties to even; NaN maps to the
+ *     most negative code
+ *   - int24 is packed little-endian, 3 bytes per sample
+ */
+enum class Isa {
+    SCALAR,
+    SSE2,
+    AVX2,
+    NEON
+};
+
+/** Best instruction set supported by the running CPU */
+Isa detectIsa();
+
+/** Instruction set the kernels currently dispatch to */
+Isa activeIsa();
+
+/**
+ * Force a specific instruction set (for testing and benchmarking)
+ * @return false if the CPU or build does not support it
+ */
+bool setIsa(Isa isa);
+
+const char* isaName(Isa isa);
+
+/** data[i] *= gain */
+void applyGain(float* data, size_t count, float gain);
+
+/**
+ * Linear gain ramp: data[i] *= start_gain + (end_gain - start_gain) / count * i
+ * Used to change gain across one block without zipper noise.
+ */
+void applyGainRamp(float* data, size_t count, float start_gain, float end_gain);
+
+/** dst[i] += src[i] * gain */
+void mixAccumulate(float* dst, const float* src, size_t count, float gain);
+
+/**
+ * Dot product: sum of a[i] * b[i]
+ * Accumulated in eight interleaved partial sums (i % 8), reduced pairwise,
+ * then the tail added in order; every variant follows this order, so the
+ * result does not depend on the ISA.
+ */
+float dot(const float* a, const float* b, size_t count);
+
+/**
+ * Complex multiply-accumulate on interleaved (re, im) pairs: acc[k] += a[k] * b[k]
+ * Per element re = ar * br - ai * bi and im = ar * bi + ai * br, then each
+ * added to acc; no fused multiply-add. acc must not overlap a or b.
+ * @param count Number of complex values
+ */
+void complexMultiplyAccumulate(float* acc, const float* a, const float* b, size_t count);
+
+/**
+ * Cascaded biquads, transposed direct form II, on independent lanes in place
+ * data holds frames rows of lanes interleaved samples; each lane runs its
+ * own cascade of stages sections. Per section and sample:
+ *   y = b0 * x + z1;  z1 = b1 * x - a1 * y + z2;  z2 = b2 * x - a2 * y
+ * Lanes map to SIMD lanes, so 4 or 8 filters cost about as much as one.
+ * @param lanes Multiple of 4
+ * @param coefficients [stages][5][lanes]: b0, b1, b2, a1, a2 rows (a0 normalized to 1)
+ * @param state [stages][2][lanes]: z1, z2 rows, updated
+ */
+void biquadCascade(float* data, size_t frames, size_t lanes, const float* coefficients, float* state,
+                   size_t stages);
+
+/** Clamp to [-limit, limit]; NaN passes through */
+void hardClip(float* data, size_t count, float limit);
+
+/** Cubic soft clip: 1.5x - 0.5x^3 on [-1, 1], saturating outside */
+void softClip(float* data, size_t count);
+
+void floatToInt16(int16_t* dst, const float* src, size_t count);
+void int16ToFloat(float* dst, const int16_t* src, size_t count);
+void floatToInt24(uint8_t* dst, const float* src, size_t count);
+void int24ToFloat(float* dst, const uint8_t* src, size_t count);
+
+/**
+ * Planar to interleaved
+ * @param channels channel_count pointers to frames samples each
+ */
+void interleave(float* dst, const float* const* channels, size_t channel_count, size_t frames);
+
+/** Interleaved to planar */
+void deinterleave(float* const* channels, const float* src, size_t channel_count, size_t frames);
+
+/**
+ * Scalar reference implementations
+ * The ground truth the SIMD variants are tested against.
+ */
+namespace reference {
+
+void applyGain(float* data, size_t count, float gain);
+void applyGainRamp(float* data, size_t count, float start_gain, float end_gain);
+void mixAccumulate(float* dst, const float* src, size_t count, float gain);
+float dot(const float* a, const float* b, size_t count);
+void complexMultiplyAccumulate(float* acc, const float* a, const float* b, size_t count);
+void biquadCascade(float* data, size_t frames, size_t lanes, const float* coefficients, float* state,
+                   size_t stages);
+void hardClip(float* data, size_t count, float limit);
+void softClip(float* data, size_t count);
+void floatToInt16(int16_t* dst, const float* src, size_t count);
+void int16ToFloat(float* dst, const int16_t* src, size_t count);
+void floatToInt24(uint8_t* dst, const float* src, size_t count);
+void int24ToFloat(float* dst, const uint8_t* src, size_t count);
+void interleave(float* dst, const float* const* channels, size_t channel_count, size_t frames);
+void deinterleave(float* const* channels, const float* src, size_t channel_count, size_t frames);
+
+} // namespace reference
+
+} // namespace dsp
+} // namespace media_pipeline
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace media_pipeline {
+
+/**
+ * Compact encoding of analysis feature vectors (MFCCs, embeddings, ...)
+ *
+ * A quantized message is "<address> #q " followed by a binary body:
+ *
+ *   u8  flags      bit 0: keyframe, bit 1: 16-bit quantization (else 8-bit),
+ *                  bit 2: range updates follow the deltas
+ *   u8  reserved
+ *   u16 dims
+ *   u16 sequence   Frame counter, detects gaps before a delta frame
+ *   keyframe:  dims x (f32 offset, f32 scale), then dims x i8/i16 values
+ *   delta:     dims x zigzag varint (value - previous value)
+ *              [u8 count, count x (u16 dim, f32 offset, f32 scale, i8/i16 value)]
+ *
+ * All fields are big-endian. A feature decodes to offset + value * scale.
+ * Each keyframe re-centres every dimension on the values seen since the
+ * previous one, with headroom; unused range shrinks by at most half per
+ * keyframe. A value outside its range gets a range at least twice as wide,
+ * sent for that dimension alone in the delta frame (a zero delta plus the
+ * new absolute value), or as a keyframe when many dimensions overflow at
+ * once. Deltas are taken between quantized values, so decoding never
+ * drifts. After a lost packet the decoder waits for the next keyframe.
+ */
+namespace feature_codec {
+
+constexpr char kTag[] = "#q";
+constexpr size_t kMaxDims = 256;  // Keeps a 16-bit keyframe within the receiver's 4 KiB buffer
+
+constexpr uint8_t kFlagKeyframe = 0x01;
+constexpr uint8_t kFlag16Bit = 0x02;
+constexpr uint8_t kFlagRangeUpdates = 0x04;
+constexpr size_t kMaxRangeUpdates = 255;
+
+class Encoder {
+public:
+    /**
+     * @param bits Quantization width, 8 or 16
+     * @param keyframe_interval Frames between keyframes (>= 1)
+     */
+    explicit Encoder(int bits = 16, int keyframe_interval = 50);
+
+    /**
+     * Append the body for one vector to out
+     * @return false if count is 0 or above kMaxDims
+     */
+    bool encode(const float* values, size_t count, std::string& out);
+
+    /**
+     * Make the next frame a keyframe (e.g. after the destination changed)
+     */
+    void requestKeyframe() { force_keyframe_ = true; }
+
+    int getBits() const { return bits_; }
+
+private:
+    void resetRanges(const float* values, size_t count);
+    void rerange(size_t i, float value, bool shrink, bool grow);
+    int32_t quantize(size_t i, float value) const;
+    void putValue(std::string& out, int32_t value) const;
+
+    int bits_;
+    int keyframe_interval_;
+    int32_t max_value_;
+    uint16_t sequence_;
+    int frames_since_keyframe_;
+    bool force_keyframe_;
+
+    std::vector<float> offset_;
+    std::vector<float> scale_;
+    std::vector<float> span_;
+    std::vector<float> observed_min_;  // Since the last keyframe
+    std::vector<float> observed_max_;
+    std::vector<bool> overflowed_;
+    std::vector<int32_t> previous_;
+};
+
+class Decoder {
+public:
+    Decoder();
+
+    /**
+     * Decode one body into values
+     * @return false if the body is malformed or a delta frame cannot be
+     *         applied (no keyframe yet, or frames were lost)
+     */
+    bool decode(const char* data, size_t length, std::vector<float>& values);
+
+    uint64_t getDecodedCount() const { return decoded_count_; }
+    uint64_t getSkippedCount() const { return skipped_count_; }
+
+private:
+    bool has_keyframe_;
+    uint16_t next_sequence_;
+    std::vector<float> offset_;
+    std::vector<float> scale_;
+    std::vector<int32_t> previous_;
+    uint64_t decoded_count_;
+    uint64_t skipped_count_;  // Delta frames without a usable reference
+};
+
+} // namespace feature_codec
+} // namespace media_pipeline
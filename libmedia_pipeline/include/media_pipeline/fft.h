@@ -0,0 +1,91 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace media_pipeline {
+
+/**
+ * Real-input FFT of a fixed power-of-two size
+ * Computed as a half-size complex FFT plus a split step, with twiddles and
+ * the bit-reversal permutation tabulated at construction, so a transform
+ * allocates nothing. Uses an internal work buffer: one instance per thread.
+ */
+class RealFft {
+public:
+    /**
+     * @param size Transform length (rounded up to a power of two, at least 4)
+     */
+    explicit RealFft(size_t size);
+
+    size_t getSize() const { return size_; }
+    size_t getBinCount() const { return size_ / 2 + 1; }
+
+    /**
+     * @param input size samples
+     * @param output getBinCount() bins, DC to Nyquist (unscaled)
+     */
+    void forward(const float* input, std::complex<float>* output);
+
+    /**
+     * Inverse of forward(): inverse(forward(x)) == x up to rounding
+     * @param input getBinCount() bins; the imaginary parts of DC and Nyquist are ignored
+     * @param output size samples
+     */
+    void inverse(const std::complex<float>* input, float* output);
+
+private:
+    void transform(std::complex<float>* data, bool inverse) const;
+
+    size_t size_;
+    std::vector<std::complex<float>> twiddles_;  // Half-size complex FFT
+    std::vector<std::complex<float>> split_;     // e^(-2 pi i k / size), k < size / 2
+    std::vector<uint32_t> bit_reverse_;
+    std::vector<std::complex<float>> work_;
+};
+
+/**
+ * Streaming short-time Fourier transform with overlap-add resynthesis
+ * Blocks of any length go in and the same number come out, delayed by
+ * getLatency() samples. Frames are sqrt-Hann windowed on analysis and
+ * synthesis, so with a processor that leaves the bins alone the output is
+ * the input, delayed.
+ */
+class Stft {
+public:
+    // Called once per hop with getBinCount() bins to modify in place
+    using Processor = std::function<void(std::complex<float>* bins, size_t bin_count)>;
+
+    /**
+     * @param fft_size Frame length (rounded up to a power of two)
+     * @param hop Frame advance dividing fft_size, at most fft_size / 2 (else fft_size / 2)
+     */
+    explicit Stft(size_t fft_size = 512, size_t hop = 256);
+
+    void process(const float* input, float* output, size_t count, const Processor& processor);
+
+    void reset();
+
+    size_t getFftSize() const { return fft_.getSize(); }
+    size_t getHop() const { return hop_; }
+    size_t getBinCount() const { return fft_.getBinCount(); }
+    size_t getLatency() const { return fft_.getSize(); }
+
+private:
+    void processFrame(const Processor& processor);
+
+    RealFft fft_;
+    size_t hop_;
+    size_t fill_;                      // Samples of the current hop received
+    std::vector<float> window_;        // sqrt-Hann, periodic
+    std::vector<float> input_;         // Last fft_size input samples
+    std::vector<float> frame_;
+    std::vector<float> accumulator_;   // Overlap-add sum, first hop complete after each frame
+    std::vector<float> output_;        // Completed hop being played out
+    std::vector<std::complex<float>> bins_;
+};
+
+} // namespace media_pipeline
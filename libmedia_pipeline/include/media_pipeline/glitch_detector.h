@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace media_pipeline {
+
+/**
+ * Audible glitch detector for a playout or received audio stream
+ *
+ * Runs inline on the audio thread (one pass per sample, no allocation, no
+ * locks) and reports four kinds of event:
+ *   UNDERRUN       silence the player inserted because its queue ran dry,
+ *                  reported with its total length once audio resumes
+ *   DROPOUT        a run of exact zeros that cuts into a signal mid-stream
+ *                  (silence inserted upstream, seen on parsed streams)
+ *   DISCONTINUITY  a step in the waveform: the second difference exceeds
+ *                  spike_ratio times its running average level plus
+ *                  spike_floor (a missing or repeated packet, a bad splice)
+ *   CLIPPING       a burst of at least min_clip_run samples at full scale
+ *
+ * Each event carries the stream position and the context the caller passed
+ * with the samples (packet sequence, queue depth, timestamp), so it can be
+ * tied to the packet that caused it. Events go to per-type counters and to
+ * a bounded single-consumer log that another thread drains with popEvent();
+ * when the log is full new events are only counted.
+ */
+class GlitchDetector {
+public:
+    enum class Type : uint8_t {
+        UNDERRUN,
+        DROPOUT,
+        DISCONTINUITY,
+        CLIPPING
+    };
+    static constexpr size_t kTypeCount = 4;
+
+    static const char* typeName(Type type);
+
+    struct Config {
+        float spike_ratio = 10.0f;
+        float spike_floor = 0.05f;
+        float clip_level = 0.999f;          // |x| counted as clipped
+        size_t min_clip_run = 3;
+        float dropout_min_ms = 1.0f;        // Shortest zero run reported as a dropout
+        float dropout_edge_level = 1e-3f;   // Signal level the run must cut from
+        float stream_gap_ms = 2000.0f;      // Longer underruns are a stopped stream, not a glitch
+        size_t event_capacity = 256;        // Rounded up to a power of two
+    };
+
+    /**
+     * What the caller knows about the samples being analyzed
+     */
+    struct Context {
+        uint64_t packet_sequence = 0;  // Packet the samples came from
+        uint32_t queue_depth = 0;      // Buffers queued behind it
+        uint64_t timestamp_ns = 0;     // When they were played or received
+    };
+
+    struct Event {
+        Type type;
+        uint64_t position;         // Stream sample index of the first affected sample
+        uint64_t length;           // Samples affected (1 for a discontinuity)
+        float magnitude;           // Step size, clip peak, or level the dropout cut from
+        uint64_t first_packet;     // Packet sequence at the start of the event
+        uint64_t last_packet;      // ... and where it ended (resume packet for underruns)
+        uint32_t queue_depth;      // Queue depth at the start of the event
+        uint64_t timestamp_ns;
+    };
+
+    explicit GlitchDetector(int sample_rate);
+    GlitchDetector(int sample_rate, const Config& config);
+
+    /**
+     * Analyze real samples (from a packet) in stream order
+     */
+    void analyze(const float* samples, size_t count, const Context& context);
+
+    /**
+     * Record count samples of silence the player inserted (not analyzed)
+     */
+    void insertedSilence(size_t count, const Context& context);
+
+    /**
+     * Take the oldest logged event (one consumer thread)
+     * @return false if the log is empty
+     */
+    bool popEvent(Event& event);
+
+    uint64_t getCount(Type type) const { return counts_[static_cast<size_t>(type)].load(std::memory_order_relaxed); }
+    uint64_t getTotalCount() const;
+    uint64_t getUnloggedCount() const { return unlogged_.load(std::memory_order_relaxed); }
+    uint64_t getPosition() const { return position_; }
+
+    /**
+     * Forget the signal history (stream restart); counters and the log are kept
+     */
+    void reset();
+
+private:
+    void emit(const Event& event);
+    void closeUnderrun(const Context& context);
+
+    Config config_;
+    size_t min_dropout_;
+    uint64_t max_underrun_;
+
+    uint64_t position_;        // Samples seen, analyzed or inserted
+    float previous_[2];        // x[n-1], x[n-2]
+    size_t history_;           // Consecutive analyzed samples, for warm-up
+    float step_level_;         // Running mean of |second difference|
+    size_t suppress_;          // Samples left before steps are checked again
+
+    size_t clip_run_;
+    float clip_peak_;
+    Event clip_event_;
+
+    size_t zero_run_;
+    float zero_edge_;          // |x| just before the run
+    Event zero_event_;
+
+    bool playing_;             // Real samples seen since the last underrun
+    bool underrun_open_;
+    Event underrun_event_;
+
+    std::atomic<uint64_t> counts_[kTypeCount];
+    std::atomic<uint64_t> unlogged_;
+
+    // Event log: single producer (the analyzing thread), single consumer
+    std::unique_ptr<Event[]> log_;
+    size_t log_mask_;
+    std::atomic<uint64_t> log_head_;
+    std::atomic<uint64_t> log_tail_;
+};
+
+} // namespace media_pipeline
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "media_pipeline/audio_features.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace media_pipeline {
+
+/**
+ * Inference for the model families the app deploys on feature vectors:
+ * linear / logistic regression, decision trees and random forests (Weka
+ * J48 / REPTree / RandomForest exports) and small MLPs
+ *
+ * Weights live in one contiguous array with every row padded to a multiple
+ * of eight floats, so each neuron is one dsp::dot() over whole SIMD blocks.
+ * predict() evaluates a batch of frames layer by layer (or tree by tree),
+ * keeping one layer's weights hot across the batch. Scratch space is sized
+ * at load time, so prediction never allocates; one instance per thread.
+ *
+ * Model file (little-endian):
+ *   char[4]  "MPML"
+ *   uint16   version (kVersion)
+ *   uint16   type (Type)
+ *   uint32   input count D
+ *   uint32   output count K
+ *   uint32   flags; kFlagNormalize: float offset[D], float scale[D] follow,
+ *            and inputs become (x - offset) * scale
+ *   LINEAR:  one layer (below) with D inputs and K outputs
+ *   MLP:     uint32 layer count, then each layer:
+ *              uint32 inputs, uint32 outputs, uint8 activation, uint8[3] 0,
+ *              float weights[outputs][inputs], float bias[outputs]
+ *   TREE_ENSEMBLE:
+ *            uint32 tree count, then each tree:
+ *              uint32 node count, nodes of {int32 feature, float threshold,
+ *              uint32 left, uint32 right}; node 0 is the root
+ *            uint32 leaf count, float values[leaf count][K]
+ *            A node with feature >= 0 goes left when x[feature] <= threshold
+ *            (NaN goes right); children come after their parent. A node with
+ *            feature -1 is a leaf and left indexes its values. The ensemble
+ *            output is the mean of the trees' leaf values (a single J48 tree
+ *            is an ensemble of one).
+ */
+class InferenceModel {
+public:
+    enum class Type : uint16_t {
+        LINEAR = 1,
+        TREE_ENSEMBLE = 2,
+        MLP = 3
+    };
+
+    enum class Activation : uint8_t {
+        IDENTITY = 0,
+        RELU = 1,
+        TANH = 2,
+        LOGISTIC = 3,   // Logistic regression, binary classes
+        SOFTMAX = 4     // Multinomial logistic, class distributions
+    };
+
+    static constexpr uint16_t kVersion = 1;
+    static constexpr uint32_t kFlagNormalize = 1;
+    static constexpr size_t kMaxBatch = 64;        // Frames per internal pass
+    static constexpr size_t kMaxWidth = 4096;      // Inputs, outputs or neurons per layer
+
+    /**
+     * Parse a model from memory
+     * @param error Receives a description on failure
+     */
+    static std::unique_ptr<InferenceModel> load(const void* data, size_t size, std::string& error);
+
+    static std::unique_ptr<InferenceModel> loadFile(const std::string& path, std::string& error);
+
+    InferenceModel(const InferenceModel&) = delete;
+    InferenceModel& operator=(const InferenceModel&) = delete;
+
+    Type getType() const { return type_; }
+    size_t getInputCount() const { return input_count_; }
+    size_t getOutputCount() const { return output_count_; }
+
+    /**
+     * Evaluate a batch of frames
+     * @param frames frame_count rows of getInputCount() features, stride floats apart
+     * @param outputs frame_count rows of getOutputCount() values, packed
+     */
+    void predict(const float* frames, size_t frame_count, size_t stride, float* outputs);
+
+private:
+    struct Layer {
+        size_t inputs;
+        size_t outputs;
+        size_t stride;        // Padded row length (multiple of 8)
+        size_t weights;       // Offset of row 0 in weights_
+        size_t bias;          // Offset in weights_
+        Activation activation;
+    };
+
+    struct Node {
+        int32_t feature;
+        float threshold;
+        uint32_t left;        // Absolute index into nodes_; leaf: value row
+        uint32_t right;
+    };
+
+    class Reader;
+
+    InferenceModel() = default;
+
+    bool parseLayer(Reader& reader, size_t inputs, std::string& error);
+    bool parseTrees(Reader& reader, std::string& error);
+    void allocateScratch();
+
+    void normalize(const float* frames, size_t frame_count, size_t stride, float* dst, size_t dst_stride) const;
+    void runLayers(size_t frame_count, float* outputs);
+    void runTrees(size_t frame_count, float* outputs);
+
+    Type type_ = Type::LINEAR;
+    size_t input_count_ = 0;
+    size_t output_count_ = 0;
+
+    std::vector<float> offset_;          // Empty without normalization
+    std::vector<float> scale_;
+
+    std::vector<float> weights_;         // All layers: padded rows, then biases
+    std::vector<Layer> layers_;
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> roots_;
+    std::vector<float> leaf_values_;     // [leaf][K]
+
+    size_t scratch_stride_ = 0;          // Widest layer, padded
+    std::vector<float> scratch_a_;       // kMaxBatch rows of scratch_stride_
+    std::vector<float> scratch_b_;
+};
+
+/**
+ * Audio features and inference chained on the capture thread
+ * Samples go in; feature frames collect in a window of window_frames, and
+ * each full window is evaluated as one batch. The callback gets the mean
+ * model output over the window, so a classifier's decision is smoothed over
+ * window_frames hops (at 48 kHz and the default hop, 8 frames ~ 85 ms).
+ */
+class FeatureInference {
+public:
+    using ResultCallback = std::function<void(const float* outputs, size_t count)>;
+
+    /**
+     * @param model Must take AudioFeatureExtractor::kFeatureCount inputs
+     * @return nullptr (with error set) if the model does not fit
+     */
+    static std::unique_ptr<FeatureInference> create(std::unique_ptr<InferenceModel> model, int sample_rate,
+                                                    size_t window_frames, std::string& error);
+
+    void process(const float* samples, size_t count, const ResultCallback& callback);
+    void reset();
+
+    const InferenceModel& getModel() const { return *model_; }
+    size_t getWindowFrames() const { return window_frames_; }
+
+private:
+    FeatureInference(std::unique_ptr<InferenceModel> model, int sample_rate, size_t window_frames);
+
+    std::unique_ptr<InferenceModel> model_;
+    AudioFeatureExtractor extractor_;
+    AudioFeatureExtractor::FrameCallback on_frame_;
+    const ResultCallback* callback_;     // Set for the duration of process()
+    size_t window_frames_;
+    size_t frames_;                      // Feature frames in the current window
+    std::vector<float> window_;          // [window_frames][kFeatureCount]
+    std::vector<float> outputs_;         // [window_frames][K]
+    std::vector<float> mean_;
+};
+
+} // namespace media_pipeline
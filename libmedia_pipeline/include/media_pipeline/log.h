@@ -0,0 +1,42 @@
+#pragma once
+
+namespace media_pipeline {
+
+/**
+ * Logging for library code
+ * Library sources log through this instead of android/log.h or iostreams,
+ * so the same code builds into the Android app and the desktop receiver.
+ * The default sink is logcat on Android and stderr elsewhere; a host can
+ * install its own. Messages are formatted into a fixed stack buffer (long
+ * ones are truncated), so logging never allocates.
+ */
+namespace log {
+
+enum class Level {
+    INFO,
+    WARNING,
+    ERROR
+};
+
+using Sink = void (*)(Level level, const char* tag, const char* message);
+
+/**
+ * Route all library log output to sink (nullptr restores the default)
+ */
+void setSink(Sink sink);
+
+/**
+ * Format and emit one message
+ */
+void write(Level level, const char* tag, const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    ;
+
+} // namespace log
+} // namespace media_pipeline
+
+#define MP_LOGI(tag, ...) ::media_pipeline::log::write(::media_pipeline::log::Level::INFO, tag, __VA_ARGS__)
+#define MP_LOGW(tag, ...) ::media_pipeline::log::write(::media_pipeline::log::Level::WARNING, tag, __VA_ARGS__)
+#define MP_LOGE(tag, ...) ::media_pipeline::log::write(::media_pipeline::log::Level::ERROR, tag, __VA_ARGS__)
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "media_pipeline/biquad.h"
+
+namespace media_pipeline {
+
+/**
+ * Streaming ITU-R BS.1770-4 / EBU R128 loudness and true-peak meter
+ *
+ * Samples are K-weighted (shelf plus RLB high-pass, one BiquadBank lane per
+ * channel) and their energy summed into 100 ms steps; everything else is
+ * derived from the steps, so the cost per sample is the filter, a square and
+ * the true-peak interpolator, whatever the measurement length:
+ *   momentary    mean of the last 4 steps (400 ms)
+ *   short-term   mean of the last 30 steps (3 s)
+ *   integrated   400 ms blocks every 100 ms, gated at -70 LUFS and then
+ *                10 LU below the mean of the blocks above that; blocks go
+ *                into a 0.1 LU histogram that keeps their exact energy, so
+ *                memory is fixed however long the stream runs and only the
+ *                gate edge is quantized
+ *   true peak    polyphase windowed-sinc interpolation to at least 192 kHz
+ *                (4x at 48 kHz), 12 taps per phase as in BS.1770 Annex 2
+ *
+ * Readings before the first 400 ms count the meter's start as silence.
+ * Not thread-safe: feed and read from one thread, or copy getReading() out.
+ */
+class LoudnessMeter {
+public:
+    static constexpr double kSilence = -std::numeric_limits<double>::infinity();  // No signal yet
+
+    struct Reading {
+        double momentary_lufs = kSilence;
+        double short_term_lufs = kSilence;
+        double integrated_lufs = kSilence;
+        double true_peak_dbtp = kSilence;   // Maximum since reset
+        double sample_peak_dbfs = kSilence;
+        uint64_t frames = 0;
+    };
+
+    /**
+     * @param channels Interleaved channels; all weighted 1.0 (see setChannelWeight)
+     */
+    LoudnessMeter(int sample_rate, size_t channels);
+
+    /**
+     * BS.1770 channel weight: 1.41 for surrounds, 0 to leave out (LFE)
+     */
+    void setChannelWeight(size_t channel, double weight);
+
+    /**
+     * Meter interleaved frames
+     * @return 100 ms steps completed by these frames (new momentary readings)
+     */
+    size_t process(const float* interleaved, size_t frames);
+
+    Reading getReading() const;
+
+    double getMomentary() const;
+    double getShortTerm() const;
+    double getIntegrated() const;
+    double getTruePeak() const;
+
+    size_t getChannelCount() const { return channels_; }
+    size_t getStepFrames() const { return step_frames_; }
+    size_t getOversampling() const { return oversampling_; }
+
+    /**
+     * Start a new measurement: filter state, history, gating and peaks
+     */
+    void reset();
+
+private:
+    static constexpr size_t kShortTermSteps = 30;
+    static constexpr size_t kMomentarySteps = 4;
+    static constexpr size_t kChunkFrames = 256;
+    static constexpr size_t kPhaseTaps = 12;
+    static constexpr double kHistogramFloor = -70.0;  // The absolute gate
+    static constexpr double kHistogramStep = 0.1;
+    static constexpr size_t kHistogramBins = 800;     // Up to +10 LUFS; louder lands in the top bin
+
+    void endStep();
+    double meanEnergy(size_t steps) const;
+    void measurePeaks(const float* interleaved, size_t frames);
+
+    size_t channels_;
+    size_t step_frames_;
+    std::vector<double> weights_;
+
+    BiquadBank k_weighting_;
+    std::vector<float> filtered_;           // kChunkFrames rows of channels_
+
+    // 100 ms steps
+    std::vector<double> step_sums_;         // Per channel: sum of squares so far this step
+    size_t step_position_;
+    double steps_[kShortTermSteps];         // Weighted mean squares, ring
+    size_t step_index_;
+    uint64_t step_count_;
+
+    // Gating blocks
+    uint64_t histogram_count_[kHistogramBins];
+    double histogram_energy_[kHistogramBins];
+
+    // True peak
+    size_t oversampling_;
+    std::vector<float> phases_;             // [oversampling_][kPhaseTaps], tap j for the input j back
+    std::vector<float> lines_;              // Per channel: kPhaseTaps - 1 history, then the chunk
+    std::vector<float> interpolated_;       // One phase of one chunk
+    float true_peak_;
+    float sample_peak_;
+    uint64_t frames_;
+};
+
+} // namespace media_pipeline
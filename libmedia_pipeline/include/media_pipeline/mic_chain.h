@@ -0,0 +1,229 @@
+#pragma once
+
+#include "media_pipeline/fft.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace media_pipeline {
+
+/**
+ * Noise gate with hysteresis and hold
+ * The detector runs once per 32-sample sub-block on its peak level, and the
+ * gain moves between sub-blocks as a vectorized ramp (dsp::applyGainRamp),
+ * so there is no per-sample branching. The gate opens above the open
+ * threshold and closes only after the level has stayed below the (lower)
+ * close threshold for the hold time, so speech tails do not chatter.
+ */
+class NoiseGate {
+public:
+    explicit NoiseGate(int sample_rate);
+
+    /**
+     * @param open_db Level (dBFS peak) that opens the gate
+     * @param close_db Level below which the gate starts to close (<= open_db)
+     */
+    void setThresholds(float open_db, float close_db);
+
+    void setTimes(float attack_ms, float hold_ms, float release_ms);
+
+    /**
+     * @param range_db Attenuation while closed (e.g. -40; -inf for silence)
+     */
+    void setRange(float range_db);
+
+    void process(float* data, size_t count);
+    void reset();
+
+    bool isOpen() const { return open_; }
+
+private:
+    int sample_rate_;
+    float open_threshold_;
+    float close_threshold_;
+    float floor_gain_;
+    float attack_coef_;     // Per sub-block
+    float release_coef_;
+    float envelope_coef_;
+    size_t hold_samples_;
+
+    bool open_;
+    size_t hold_remaining_;
+    float envelope_;
+    float gain_;
+};
+
+/**
+ * Spectral noise suppression (Wiener filter with decision-directed SNR)
+ * Runs on an Stft. The noise spectrum is seeded from the first frames and
+ * then tracked per bin: it is smoothed over frames that look like noise and
+ * creeps up slowly under speech, so a rising noise floor is still followed
+ * within seconds. The gain per
+ * bin is xi / (1 + xi) for the a priori SNR xi, floored at the maximum
+ * reduction so the residual noise stays natural rather than musical.
+ */
+class NoiseSuppressor {
+public:
+    /**
+     * @param fft_size STFT frame (512 at 44.1/48 kHz: ~11 ms, adds fft_size samples of latency)
+     */
+    explicit NoiseSuppressor(int sample_rate, size_t fft_size = 512);
+
+    /**
+     * @param reduction_db Largest attenuation applied to a bin (e.g. -20)
+     */
+    void setMaxReduction(float reduction_db);
+
+    void process(float* data, size_t count);
+    void reset();
+
+    size_t getLatency() const { return stft_.getLatency(); }
+
+private:
+    void processSpectrum(std::complex<float>* bins, size_t count);
+
+    Stft stft_;
+    Stft::Processor processor_;
+    std::vector<float> noise_;
+    std::vector<float> previous_clean_;  // |G * X|^2 of the last frame
+    float gain_floor_;
+    float noise_rise_;                   // Per-frame creep factor
+    uint32_t frames_;
+};
+
+/**
+ * Look-ahead automatic gain control
+ * The signal is delayed by the look-ahead while the detector measures the
+ * undelayed input: a smoothed RMS sets the gain that brings it to the
+ * target, capped so the loudest peak in the look-ahead window lands at the
+ * ceiling. Gain reductions therefore complete before the peak that needs
+ * them is played. Increases are slow, and the gain is frozen while the
+ * input is below the silence threshold so background noise is not pumped.
+ */
+class AutoGainControl {
+public:
+    AutoGainControl(int sample_rate, float lookahead_ms = 5.0f);
+
+    /**
+     * @param target_db RMS level to aim for (dBFS)
+     */
+    void setTarget(float target_db);
+
+    /**
+     * @param min_gain, max_gain Limits on the applied gain (linear)
+     */
+    void setGainRange(float min_gain, float max_gain);
+
+    /**
+     * @param ceiling Peak level the gain may drive a sample to (linear)
+     */
+    void setCeiling(float ceiling);
+
+    void process(float* data, size_t count);
+    void reset();
+
+    size_t getLatency() const { return delay_.size(); }
+    float getGain() const { return gain_; }
+
+private:
+    static constexpr size_t kSubBlock = 32;
+
+    void processSubBlock(float* data, size_t count);
+
+    int sample_rate_;
+    float target_rms_;
+    float min_gain_;
+    float max_gain_;
+    float ceiling_;
+    float silence_rms_;
+    float level_coef_;
+    float attack_coef_;
+    float release_coef_;
+
+    std::vector<float> delay_;      // Look-ahead ring
+    size_t delay_position_;
+    std::vector<float> peaks_;      // Sub-block peaks covering the look-ahead
+    size_t peak_position_;
+    float mean_square_;
+    float gain_;
+};
+
+/**
+ * Soft limiter: transparent below the threshold, then a rational knee that
+ * approaches full scale without reaching it
+ *   |y| = t + (1 - t) * u / (1 + u),  u = (|x| - t) / (1 - t)
+ * Continuous in value and slope at the threshold.
+ */
+class SoftLimiter {
+public:
+    explicit SoftLimiter(float threshold = 0.9f);
+
+    void setThreshold(float threshold);
+    void process(float* data, size_t count) const;
+
+private:
+    float threshold_;
+};
+
+/**
+ * Microphone capture chain: input gain, noise gate, noise suppression, AGC
+ * and soft limiter, in that order
+ * Capture threads pass raw 16-bit PCM to processCapture(); settings may be
+ * changed from any thread and take effect at the next block. Every stage
+ * is allocated up front, so processing never allocates.
+ */
+class MicChain {
+public:
+    struct Settings {
+        float input_gain = 1.0f;         // 0.1x - 5.0x, as the app's gain control
+        bool noise_gate = false;
+        bool noise_suppression = false;
+        bool auto_gain = false;
+        bool limiter = true;
+    };
+
+    explicit MicChain(int sample_rate);
+
+    void setSettings(const Settings& settings);
+    Settings getSettings() const;
+
+    /**
+     * Convert capture PCM to float and run the chain
+     * @param output count samples; may not alias pcm
+     */
+    void processCapture(const int16_t* pcm, float* output, size_t count);
+
+    /**
+     * Run the chain in place on float samples
+     */
+    void process(float* data, size_t count);
+
+    /**
+     * Current delay through the enabled stages in samples
+     */
+    size_t getLatency() const;
+
+    NoiseGate& getNoiseGate() { return gate_; }
+    NoiseSuppressor& getNoiseSuppressor() { return suppressor_; }
+    AutoGainControl& getAutoGainControl() { return agc_; }
+
+private:
+    std::atomic<float> input_gain_;
+    std::atomic<bool> noise_gate_;
+    std::atomic<bool> noise_suppression_;
+    std::atomic<bool> auto_gain_;
+    std::atomic<bool> limiter_;
+
+    float applied_gain_;                 // Processing thread only, like the stage state
+    bool suppression_active_;
+    bool auto_gain_active_;
+
+    NoiseGate gate_;
+    NoiseSuppressor suppressor_;
+    AutoGainControl agc_;
+    SoftLimiter soft_limiter_;
+};
+
+} // namespace media_pipeline
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace media_pipeline {
+
+/**
+ * Messages exchanged by the app and the receiver
+ *
+ * A message is "<address> <payload>" in one datagram (or SLIP frame, or
+ * shared-memory ring record). Audio and analysis payloads are floats printed
+ * with three decimals and separated by spaces; blocks longer than one chunk
+ * go out as "<address>_<chunk> ...". Text and control ("/control/...")
+ * payloads are the rest of the line.
+ * Quantized analysis vectors use "<address> #q <binary>" (feature_codec.h).
+ * OSC 1.0 bundles ("#bundle", timetag, size-prefixed elements) wrap any of
+ * these.
+ */
+
+/**
+ * Multi-type OSC message parser for TouchDesigner-style channels
+ */
+class OSCParser {
+public:
+    enum MessageType {
+        AUDIO,
+        TEXT,
+        ANALYSIS,
+        CONTROL,
+        UNKNOWN
+    };
+
+    struct OSCMessage {
+        std::string address;
+        MessageType type;
+        std::vector<float> floatData;
+        std::string textData;  // Text and control payloads
+        size_t encodedOffset;  // Start of a quantized feature body (feature_codec), 0 for text
+        bool valid;
+        uint64_t arrival_ns;  // Kernel receive timestamp, CLOCK_REALTIME ns
+    };
+
+    /**
+     * OSC 1.0 bundle: "#bundle\0", 64-bit NTP timetag, then size-prefixed
+     * elements (messages or nested bundles), all big-endian
+     */
+    struct OSCBundle {
+        uint64_t timetag;
+        std::vector<std::pair<const char*, size_t>> elements;  // Point into the packet
+    };
+
+    static constexpr uint64_t kImmediateTimetag = 1;
+
+    /**
+     * Parse one message
+     * Float tokens that are not numbers are skipped, as before; values
+     * printed by OSCFormatter are read without going through strtof.
+     */
+    static OSCMessage parseMessage(const std::string& data);
+    static MessageType getMessageType(const std::string& address);
+
+    /**
+     * Get the address of the stream a message belongs to: the address
+     * without the "_<chunk>" suffix of a block sent in several chunks.
+     * A stream whose own name ends in "_<digits>" cannot be told apart.
+     */
+    static std::string streamAddress(const std::string& address);
+
+    static bool isBundle(const char* data, size_t length);
+    static bool parseBundle(const char* data, size_t length, OSCBundle& bundle);
+
+    /**
+     * Convert an NTP timetag (seconds since 1900, 32.32 fixed point) to CLOCK_REALTIME ns
+     */
+    static uint64_t timetagToUnixNs(uint64_t timetag);
+};
+
+/**
+ * Builds float messages in the format OSCParser reads
+ */
+class OSCFormatter {
+public:
+    static constexpr size_t kChunkSamples = 128;
+
+    /**
+     * Append "<address>[_<chunk>] v v ... " to out
+     * @param chunk Chunk index, or -1 for a block that fits in one message
+     */
+    static void appendFloatMessage(std::string& out, const std::string& address, int chunk,
+                                   const float* values, size_t count);
+
+    /**
+     * Append one value followed by a space, byte-identical to "%.3f "
+     * Values with more than 15 characters are dropped, as the sender always did.
+     */
+    static void appendFloat(std::string& out, float value);
+};
+
+} // namespace media_pipeline
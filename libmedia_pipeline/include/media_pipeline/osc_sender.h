@@ -0,0 +1,184 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <netinet/in.h>
+
+#include "media_pipeline/feature_codec.h"
+#include "media_pipeline/shm_ring.h"
+
+namespace media_pipeline {
+
+/**
+ * Simple OSC sender for audio data transmission
+ * Future integration point for full AOO library
+ *
+ * Thread-safe: the capture thread sends audio and model features while JVM
+ * threads send features and change the encoding, destination or transport.
+ * One mutex serializes sends with those changes, so a transport switch never
+ * lands mid-flush or mid-ring-write; samples are copied and clamped before it
+ * is taken.
+ */
+class OSCSender {
+public:
+    enum class Transport {
+        UDP,  // One datagram per message chunk
+        TCP,  // OSC 1.1 stream: SLIP-framed messages over a TCP connection
+        SHARED_MEMORY  // Same-host ring created by the receiver's shm: listener
+    };
+
+    OSCSender(const std::string& host, int port);
+    ~OSCSender();
+
+    /**
+     * Send audio data via OSC
+     * @param audio_data Pointer to audio samples
+     * @param frame_count Number of audio frames
+     */
+    void sendAudio(const float* audio_data, int frame_count);
+
+    /**
+     * Send audio data to specific OSC address
+     * @param address OSC address/topic
+     * @param audio_data Pointer to audio samples
+     * @param frame_count Number of audio frames
+     */
+    void sendAudio(const std::string& address, const float* audio_data, int frame_count);
+
+    /**
+     * Send an analysis feature vector (MFCCs, embeddings, ...)
+     * Encoded according to setFeatureEncoding(); each address keeps its own
+     * quantization ranges and delta reference.
+     * @param address OSC address, e.g. "/analysis/mfcc"
+     * @param features Pointer to feature values
+     * @param count Number of features (at most 256 when quantized)
+     */
+    void sendFeatures(const std::string& address, const float* features, int count);
+
+    /**
+     * Select the analysis feature encoding
+     * @param bits 8 or 16 for quantized, delta-coded vectors; 0 for text floats
+     * @param keyframe_interval Frames between keyframes (bounds recovery after loss)
+     */
+    void setFeatureEncoding(int bits, int keyframe_interval = 50);
+
+    /**
+     * Update OSC destination
+     * @param host Target host address
+     * @param port Target port number
+     */
+    void updateDestination(const std::string& host, int port);
+
+    /**
+     * Set default OSC address for audio streams
+     * @param address Default OSC address (e.g., "/audio/stream")
+     */
+    void setDefaultAddress(const std::string& address);
+
+    /**
+     * Select the transport to the current destination
+     * TCP gives reliable, ordered delivery for recording over a stable LAN.
+     * Messages queue in a bounded send buffer that is flushed with one
+     * gathered write per block; while the oldest queued message is older than
+     * the latency budget (or the queue is full), new messages go out over UDP
+     * instead until the backlog drains. While the TCP connection is down,
+     * messages go over UDP and reconnects are attempted once a second.
+     * @param transport UDP or TCP
+     * @param latency_budget_ms Maximum backlog age before falling back to UDP
+     */
+    void setTransport(Transport transport, int latency_budget_ms = 50);
+
+    /**
+     * Send to a receiver on the same host through its shared-memory ring
+     * Messages keep the UDP framing and are written straight into the ring
+     * the receiver created with -l shm:<name>. While the ring does not exist
+     * (receiver not started, or restarted) messages go over UDP and the ring
+     * is re-attached once a second. Use setTransport() to leave this mode.
+     * @param name Ring name, or a file path where shm_open is unavailable
+     */
+    void setSharedMemoryDestination(const std::string& name);
+
+    Transport getTransport() const;
+
+    /**
+     * Check if the shared-memory ring is attached
+     */
+    bool isSharedMemoryAttached() const;
+
+    /**
+     * Check if the TCP stream is established
+     */
+    bool isTcpConnected() const;
+
+    /**
+     * Get number of messages sent over UDP while in TCP or shared-memory mode
+     */
+    uint64_t getUdpFallbackCount() const;
+
+    /**
+     * Check if OSC sender is connected and ready
+     */
+    bool isReady() const;
+
+private:
+    enum class TcpState {
+        DISCONNECTED,
+        CONNECTING,
+        CONNECTED
+    };
+
+    struct QueuedFrame {
+        std::string message;   // Unframed, for UDP fallback
+        std::string encoded;   // SLIP frame
+        size_t offset;         // Bytes of encoded already written
+        std::chrono::steady_clock::time_point queued_at;
+    };
+
+    mutable std::mutex mutex_;  // Guards all state below
+
+    std::string host_;
+    int port_;
+    int socket_fd_;
+    bool is_connected_;
+    std::string default_address_;
+
+    Transport transport_;
+    int tcp_fd_;
+    TcpState tcp_state_;
+    std::deque<QueuedFrame> tcp_queue_;
+    size_t tcp_queued_bytes_;
+    std::chrono::milliseconds latency_budget_;
+    bool udp_fallback_active_;
+    uint64_t udp_fallback_count_;
+    std::chrono::steady_clock::time_point last_connect_attempt_;
+
+    std::string shm_name_;
+    std::unique_ptr<ShmRing> shm_ring_;
+    std::chrono::steady_clock::time_point last_attach_attempt_;
+
+    int feature_bits_;
+    int feature_keyframe_interval_;
+    std::map<std::string, feature_codec::Encoder> feature_encoders_;  // By address
+
+    // Private helpers expect mutex_ to be held
+    bool ready() const;
+    bool connect();
+    void disconnect();
+    void sendOSCMessage(const std::string& address, const std::vector<float>& data);
+    void sendEncodedMessage(const std::string& message);
+    bool resolveDestination(sockaddr_in& dest_addr) const;
+    bool transmit(const std::string& message, const sockaddr_in& dest_addr);
+    bool tcpReady();
+    void startTcpConnect();
+    void closeTcp(bool reroute_to_udp);
+    void flushTcp();
+    bool shmReady();
+};
+
+} // namespace media_pipeline
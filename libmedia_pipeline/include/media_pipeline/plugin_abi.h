@@ -0,0 +1,111 @@
+#pragma once
+
+/*
+ * C ABI for processing nodes built outside this library
+ *
+ * A plugin is a shared library exporting mp_plugin_entry(), which hands the
+ * host one descriptor per node it implements. The host (plugin_host.h)
+ * loads it with dlopen and runs its nodes in the audio graph: on the phone
+ * after the microphone chain, in the receiver after the equalizer. Only C
+ * types cross the boundary, so a plugin may be written in C, C++ or
+ * anything else with a C FFI, and built with another compiler or standard
+ * library than the host.
+ *
+ * Threads and real time
+ *   create, destroy and reset run on a control thread and may allocate.
+ *   process and set_param run on the audio thread, never concurrently with
+ *   each other or any other call on the same instance. They must not
+ *   allocate, lock, block or make system calls: everything a node needs is
+ *   sized in create from mp_plugin_config. Parameter changes from other
+ *   threads are queued by the host and delivered through set_param just
+ *   before the block they apply to.
+ *
+ * Blocks
+ *   Audio is planar: channels spans of frames floats. frames is never more
+ *   than max_frames and may differ from block to block. A node flagged
+ *   MP_PLUGIN_IN_PLACE gets outputs[c] == inputs[c]; otherwise inputs and
+ *   outputs never overlap.
+ *
+ * Versioning
+ *   The host passes MP_PLUGIN_ABI_VERSION to mp_plugin_entry(); a plugin
+ *   built against another version returns NULL. Within a version, fields
+ *   are only ever appended to the structs, and struct_size says how much of
+ *   a struct the other side filled in. The host reads descriptor fields past
+ *   struct_size as NULL or 0, so a descriptor must reach at least through
+ *   process; set_param and reset may be left off the end.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MP_PLUGIN_ABI_VERSION 1u
+
+#define MP_PLUGIN_ENTRY_SYMBOL "mp_plugin_entry"
+
+#if defined(_WIN32)
+#define MP_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define MP_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* Descriptor flags */
+#define MP_PLUGIN_IN_PLACE 0x1u /* process() may write its output over its input */
+
+typedef struct mp_plugin_instance mp_plugin_instance; /* Opaque, owned by the plugin */
+
+typedef struct mp_plugin_param {
+    const char* name;      /* Unique within the node, e.g. "gain_db" */
+    float min_value;
+    float max_value;
+    float default_value;   /* Set by create(); the host does not call set_param for it */
+} mp_plugin_param;
+
+typedef struct mp_plugin_config {
+    uint32_t struct_size;  /* sizeof(mp_plugin_config) as the host built it */
+    uint32_t sample_rate;
+    uint32_t channels;
+    uint32_t max_frames;   /* Largest block process() will be given */
+} mp_plugin_config;
+
+typedef struct mp_plugin_block {
+    const float* const* inputs;  /* channels spans of frames samples */
+    float* const* outputs;
+    uint32_t channels;
+    uint32_t frames;
+} mp_plugin_block;
+
+typedef struct mp_plugin_descriptor {
+    uint32_t abi_version;          /* MP_PLUGIN_ABI_VERSION */
+    uint32_t struct_size;          /* sizeof(mp_plugin_descriptor) */
+    const char* id;                /* Unique across plugins, e.g. "org.example.tremolo" */
+    const char* name;              /* For people */
+    uint32_t flags;                /* MP_PLUGIN_* */
+    uint32_t latency_frames;       /* Delay the node adds, reported to the graph */
+    uint32_t max_channels;         /* 0: any */
+    uint32_t param_count;
+    const mp_plugin_param* params;
+
+    /* NULL if the config is unsupported */
+    mp_plugin_instance* (*create)(const mp_plugin_config* config);
+    void (*destroy)(mp_plugin_instance* instance);
+    void (*process)(mp_plugin_instance* instance, const mp_plugin_block* block);
+    /* value is within the param's range; may be NULL when param_count is 0 */
+    void (*set_param)(mp_plugin_instance* instance, uint32_t index, float value);
+    /* Forget signal history; may be NULL */
+    void (*reset)(mp_plugin_instance* instance);
+} mp_plugin_descriptor;
+
+/*
+ * Exported by every plugin as MP_PLUGIN_ENTRY_SYMBOL
+ * @return descriptor index (0, 1, ...) or NULL past the last one or if
+ *         host_abi_version is not the version the plugin was built against
+ */
+typedef const mp_plugin_descriptor* (*mp_plugin_entry_fn)(uint32_t host_abi_version, uint32_t index);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "media_pipeline/plugin_abi.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace media_pipeline {
+
+/**
+ * One instance of a plugin node (plugin_abi.h) in the audio graph
+ *
+ * Takes interleaved blocks of any length and hands the plugin planar spans
+ * of at most max_frames from buffers sized at creation, so process() never
+ * allocates on the host side either. setParameter() may be called from any
+ * thread: values go to per-parameter atomics and reach the plugin through
+ * set_param at the start of the next block.
+ */
+class PluginNode {
+public:
+    ~PluginNode();
+
+    /**
+     * Run count interleaved frames of getChannels() samples through the node, in place
+     */
+    void process(float* data, size_t frames);
+
+    /**
+     * Set a parameter (any thread), clamped to its range
+     * @return false if there is no such parameter
+     */
+    bool setParameter(const std::string& name, float value);
+    bool setParameter(size_t index, float value);
+
+    /**
+     * Get the last value set (or the default)
+     */
+    float getParameter(size_t index) const;
+
+    /**
+     * @return the parameter's index, getParameterCount() if there is none
+     */
+    size_t findParameter(const std::string& name) const;
+
+    /**
+     * Forget signal history; not while process() runs
+     */
+    void reset();
+
+    const mp_plugin_descriptor& getDescriptor() const { return *descriptor_; }
+    std::string getId() const { return descriptor_->id; }
+    size_t getParameterCount() const { return descriptor_->param_count; }
+    size_t getLatency() const { return descriptor_->latency_frames; }
+    size_t getChannels() const { return channels_; }
+    size_t getMaxFrames() const { return max_frames_; }
+
+private:
+    friend class PluginHost;
+
+    PluginNode(std::shared_ptr<void> library, std::shared_ptr<const mp_plugin_descriptor> descriptor,
+               mp_plugin_instance* instance, size_t channels, size_t max_frames);
+
+    void applyParameters();
+
+    std::shared_ptr<void> library_;          // Keeps the code loaded while the instance lives
+    std::shared_ptr<const mp_plugin_descriptor> descriptor_;  // The host's copy
+    mp_plugin_instance* instance_;
+    size_t channels_;
+    size_t max_frames_;
+    bool in_place_;
+    std::unique_ptr<std::atomic<float>[]> values_;
+    std::unique_ptr<std::atomic<bool>[]> changed_;
+    std::atomic<bool> any_changed_;
+    std::vector<float> inputs_;              // Planar, channels_ x max_frames_
+    std::vector<float> outputs_;
+    std::vector<const float*> input_views_;
+    std::vector<float*> output_views_;
+};
+
+/**
+ * Loads plugins and creates their nodes
+ *
+ * Each library is opened once and stays loaded while the host or any node
+ * created from it exists. Descriptors are checked when loaded: ABI
+ * version, struct size, required functions, parameter ranges and ids
+ * unique across everything loaded. The host keeps its own copy of each,
+ * zero-filled past the plugin's struct_size, and find() and
+ * getDescriptors() return that copy.
+ */
+class PluginHost {
+public:
+    PluginHost() = default;
+
+    /**
+     * Open a plugin library and register its descriptors
+     * @return false (with error set) if it cannot be opened, has no
+     *         mp_plugin_entry, offers no compatible node or repeats an id
+     */
+    bool load(const std::string& path, std::string& error);
+
+    /**
+     * Load every shared library (.so, or .dylib on macOS) in a directory, in name order
+     * @param errors One line per library that failed to load
+     * @return The number of libraries loaded
+     */
+    size_t loadDirectory(const std::string& directory, std::vector<std::string>& errors);
+
+    /**
+     * Register a node compiled into the program, as if loaded from a library
+     * (static builds, tests); the descriptor is copied, but the strings,
+     * parameters and code it points to must outlive the host and its nodes
+     */
+    bool add(const mp_plugin_descriptor* descriptor, std::string& error);
+
+    /**
+     * @return nullptr if no node has this id
+     */
+    const mp_plugin_descriptor* find(const std::string& id) const;
+
+    std::vector<const mp_plugin_descriptor*> getDescriptors() const;
+
+    /**
+     * Instantiate a node
+     * @param max_frames Largest block the plugin sees; process() splits longer blocks
+     * @return nullptr (with error set) for an unknown id, a channel count the
+     *         node does not support, or if the plugin's create() fails
+     */
+    std::unique_ptr<PluginNode> createNode(const std::string& id, int sample_rate, size_t channels,
+                                           size_t max_frames, std::string& error) const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const mp_plugin_descriptor> descriptor;
+        std::shared_ptr<void> library;       // Null for compiled-in nodes
+    };
+
+    /**
+     * @return the host's copy of a valid descriptor, nullptr (with error set) otherwise
+     */
+    std::shared_ptr<const mp_plugin_descriptor> check(const mp_plugin_descriptor* descriptor,
+                                                      std::string& error) const;
+
+    std::vector<Entry> entries_;
+};
+
+} // namespace media_pipeline
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace media_pipeline {
+
+/**
+ * Shared-memory message ring for same-host transport
+ *
+ * One process creates the ring (the receiver), others attach to it by name
+ * (senders). Messages are the same bytes a UDP datagram would carry, stored
+ * as variable-length records with the writer's CLOCK_REALTIME timestamp. The
+ * reader gets a pointer straight into the mapping, so a message crosses
+ * processes with one memcpy and no syscalls while the reader is spinning;
+ * an idle reader sleeps on a futex the writer only wakes when needed.
+ *
+ * Names:
+ *   osc-audio            POSIX shared memory object (shm_open, Linux/macOS)
+ *   /data/local/tmp/osc  File-backed mapping at this path (any platform, Android)
+ *
+ * Writers never block: when the ring is full the message is dropped and
+ * counted. Multiple writers are serialised by a spinlock in the header that
+ * records the owner's pid, so a writer killed while holding it is detected
+ * and the lock taken over; writers must share a PID namespace.
+ */
+class ShmRing {
+public:
+    struct Header;
+
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    /**
+     * Create (or replace) a ring and own it; the name is removed on destruction
+     * @param capacity Data bytes, rounded up to a power of two (min 64 KiB)
+     * @param error Receives a description on failure
+     */
+    static std::unique_ptr<ShmRing> create(const std::string& name, size_t capacity, std::string& error);
+
+    /**
+     * Attach to a ring created by another process
+     */
+    static std::unique_ptr<ShmRing> attach(const std::string& name, std::string& error);
+
+    /**
+     * Append one message (any thread, any attached process)
+     * @return false if the ring is full or the message too large
+     */
+    bool write(const char* data, size_t length, uint64_t timestamp_ns);
+
+    /**
+     * Deliver up to max_messages to on_message(data, length, timestamp_ns)
+     * Single reader. The data pointer aliases the ring and is only valid
+     * during the call.
+     * @return number of messages delivered
+     */
+    template <typename OnMessage>
+    size_t read(OnMessage&& on_message, size_t max_messages);
+
+    /**
+     * Wait until a message is available (reader)
+     * Spins for spin_iterations polls first, then sleeps on the futex.
+     * @return true if data is available
+     */
+    bool waitForData(int timeout_ms, int spin_iterations = 4096);
+
+    /**
+     * Wake a reader blocked in waitForData (used on shutdown)
+     */
+    void wakeReader();
+
+    /**
+     * Check if the owning process has destroyed the ring
+     */
+    bool isClosed() const;
+
+    uint64_t getDroppedCount() const;
+    size_t getCapacity() const { return capacity_; }
+    const std::string& getName() const { return name_; }
+
+private:
+    struct RecordHeader {
+        uint32_t length;
+        uint32_t flags;
+        uint64_t timestamp_ns;
+    };
+
+    static constexpr uint32_t kWrapFlag = 1;
+    static constexpr size_t kRecordAlign = 16;
+
+    ShmRing() = default;
+
+    static size_t recordSize(size_t length) {
+        return (sizeof(RecordHeader) + length + kRecordAlign - 1) & ~(kRecordAlign - 1);
+    }
+
+    void lockWriters();
+    void unlockWriters();
+    bool hasData() const;
+    uint64_t loadHead() const;
+    uint64_t loadTail() const;
+    void storeTail(uint64_t tail);
+
+    std::string name_;
+    bool owner_ = false;
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    Header* header_ = nullptr;
+    char* data_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+template <typename OnMessage>
+size_t ShmRing::read(OnMessage&& on_message, size_t max_messages) {
+    size_t delivered = 0;
+    uint64_t tail = loadTail();
+
+    while (delivered < max_messages) {
+        uint64_t head = loadHead();
+        if (tail == head) {
+            break;
+        }
+
+        size_t index = static_cast<size_t>(tail & (capacity_ - 1));
+        const auto* record = reinterpret_cast<const RecordHeader*>(data_ + index);
+        if (record->flags & kWrapFlag) {
+            tail += capacity_ - index;
+            storeTail(tail);
+            continue;
+        }
+        if (record->length > capacity_ - index - sizeof(RecordHeader)) {
+            // Corrupt record (writer crashed mid-write?); resynchronise at head
+            tail = head;
+            storeTail(tail);
+            break;
+        }
+
+        on_message(reinterpret_cast<const char*>(record + 1), static_cast<size_t>(record->length),
+                   record->timestamp_ns);
+        tail += recordSize(record->length);
+        storeTail(tail);  // Free the space as soon as each message is consumed
+        ++delivered;
+    }
+
+    return delivered;
+}
+
+} // namespace media_pipeline
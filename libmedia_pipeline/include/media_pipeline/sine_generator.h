@@ -2,6 +2,8 @@
 
 #include <cmath>
 
+namespace media_pipeline {
+
 /**
  * Simple sine wave generator for audio mock input
  */
@@ -37,4 +39,6 @@ private:
     double phase_increment_;
 
     void updatePhaseIncrement();
-};
\ No newline at end of file
+};
+
+} // namespace media_pipeline
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace media_pipeline {
+
+/**
+ * SLIP framing (RFC 1055) as used by OSC 1.1 over stream transports
+ * Frames are written double-ended (END payload END) so a receiver that
+ * joins mid-stream or sees line noise resynchronises on the next END.
+ */
+namespace slip {
+
+constexpr uint8_t END = 0xC0;
+constexpr uint8_t ESC = 0xDB;
+constexpr uint8_t ESC_END = 0xDC;
+constexpr uint8_t ESC_ESC = 0xDD;
+
+/**
+ * Append one encoded frame to out
+ */
+void encode(const char* data, size_t length, std::string& out);
+
+/**
+ * Upper bound of the encoded size of a payload
+ */
+inline size_t maxEncodedSize(size_t length) { return 2 * length + 2; }
+
+/**
+ * Incremental decoder for one byte stream
+ * Feed arbitrary chunks as they are read; every complete frame is handed
+ * to the callback with a pointer that is valid only during the call.
+ */
+class Decoder {
+public:
+    explicit Decoder(size_t max_frame_size = 65536)
+        : max_frame_size_(max_frame_size)
+        , escaped_(false)
+        , overflow_(false)
+        , dropped_frames_(0) {
+        frame_.reserve(4096);
+    }
+
+    template <typename OnFrame>
+    void feed(const char* data, size_t length, OnFrame&& on_frame) {
+        size_t i = 0;
+        while (i < length) {
+            uint8_t byte = static_cast<uint8_t>(data[i]);
+
+            if (escaped_) {
+                escaped_ = false;
+                append(byte == ESC_END ? static_cast<char>(END) :
+                       byte == ESC_ESC ? static_cast<char>(ESC) : data[i]);
+                ++i;
+                continue;
+            }
+
+            if (byte == END) {
+                if (!frame_.empty() && !overflow_) {
+                    on_frame(frame_.data(), frame_.size());
+                }
+                frame_.clear();
+                overflow_ = false;
+                ++i;
+                continue;
+            }
+
+            if (byte == ESC) {
+                escaped_ = true;
+                ++i;
+                continue;
+            }
+
+            // Copy the run of plain bytes up to the next special byte in one go
+            size_t run = i + 1;
+            while (run < length) {
+                uint8_t next = static_cast<uint8_t>(data[run]);
+                if (next == END || next == ESC) {
+                    break;
+                }
+                ++run;
+            }
+            append(data + i, run - i);
+            i = run;
+        }
+    }
+
+    /**
+     * Frames discarded for exceeding max_frame_size
+     */
+    uint64_t getDroppedFrames() const { return dropped_frames_; }
+
+private:
+    void append(char byte) { append(&byte, 1); }
+
+    void append(const char* bytes, size_t count) {
+        if (overflow_) {
+            return;
+        }
+        if (frame_.size() + count > max_frame_size_) {
+            overflow_ = true;
+            dropped_frames_++;
+            frame_.clear();
+            return;
+        }
+        frame_.append(bytes, count);
+    }
+
+    std::string frame_;
+    size_t max_frame_size_;
+    bool escaped_;
+    bool overflow_;
+    uint64_t dropped_frames_;
+};
+
+} // namespace slip
+} // namespace media_pipeline
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "media_pipeline/fft.h"
+
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace media_pipeline {
+
+/**
+ * Loudspeakers on a horizontal ring, in output channel order
+ * Azimuths are degrees counterclockwise from the front (left positive, as
+ * in SOFA), so a stereo pair is {30, -30}.
+ */
+struct SpeakerLayout {
+    std::vector<float> azimuths;
+
+    /**
+     * Parse a preset (mono, stereo, quad, 5.0, 7.0, octagon) or a comma
+     * separated azimuth list such as "30,-30,110,-110"
+     */
+    static bool parse(const std::string& spec, SpeakerLayout& layout);
+};
+
+/**
+ * Head-related impulse responses for directions on the horizontal plane
+ */
+struct HrirSet {
+    int sample_rate = 0;
+    size_t length = 0;               // Taps per response
+    std::vector<float> azimuths;     // Degrees, as SpeakerLayout
+    std::vector<float> left;         // [direction][length]
+    std::vector<float> right;
+
+    size_t getDirectionCount() const { return azimuths.size(); }
+
+    /**
+     * Rigid spherical head (Brown and Duda): interaural delay from the
+     * Woodworth formula and a one-pole head shadow per ear, no pinna cues.
+     * Needs no data, so binaural output always works; measured sets sound
+     * more external.
+     * @param directions Evenly spaced, starting at the front
+     */
+    static HrirSet sphericalHead(int sample_rate, size_t directions = 72, size_t length = 256);
+
+    /**
+     * Read a WAV file of 2N channels: left and right responses for N
+     * directions evenly spaced counterclockwise from the front
+     * @return false (with error set) if the file cannot be read or has an odd channel count
+     */
+    static bool load(const std::string& path, HrirSet& set, std::string& error);
+};
+
+/**
+ * Renders mono sources at positions on the horizontal plane to speakers or headphones
+ *
+ *   panning   pairwise 2D vector-based amplitude panning (Pulkki) over a
+ *             SpeakerLayout, power normalized; across a gap of 180 degrees
+ *             or more (behind a stereo pair) the two edge speakers are
+ *             crossfaded at constant power instead
+ *   binaural  each source through the HRIR pair nearest its azimuth, by
+ *             uniformly partitioned overlap-save convolution. Sources are
+ *             transformed once per block and their products with the HRIR
+ *             spectra summed in the frequency domain
+ *             (dsp::complexMultiplyAccumulate), so a block costs one
+ *             forward FFT per source and two inverse FFTs however many
+ *             sources play. A source that moved to another HRIR is run
+ *             through both for one block and crossfaded, so movement does
+ *             not click; the crossfade paths add at most four inverse FFTs.
+ *
+ * Gains (1 / distance beyond reference_distance) ramp across a block when
+ * they change. All per-source state is allocated up front for max_sources;
+ * positions may be set from any thread while another renders.
+ */
+class SpatialRenderer {
+public:
+    enum class Mode {
+        PANNING,
+        BINAURAL
+    };
+
+    struct Config {
+        size_t block_size = 512;          // Frames per render() step; a power of two for binaural
+        size_t max_sources = 32;
+        float reference_distance = 1.0f;  // Metres at which a source plays at unity gain
+    };
+
+    static std::unique_ptr<SpatialRenderer> createPanner(int sample_rate, const SpeakerLayout& layout,
+                                                         const Config& config, std::string& error);
+
+    /**
+     * @return nullptr (with error set) if the set is empty, its rate differs
+     *         or block_size is not a power of two
+     */
+    static std::unique_ptr<SpatialRenderer> createBinaural(int sample_rate, const HrirSet& hrirs, const Config& config,
+                                                           std::string& error);
+
+    ~SpatialRenderer();
+
+    /**
+     * Place a source (any thread); takes effect at the next block
+     */
+    void setPosition(size_t source, float azimuth_deg, float distance_m = 1.0f);
+    float getAzimuth(size_t source) const;
+    float getDistance(size_t source) const;
+
+    /**
+     * Render and mix every source into interleaved output (overwritten)
+     * @param sources max_sources pointers to frames samples each; nullptr for
+     *        a source with nothing to play (its HRIR tail still rings out)
+     * @return false (output untouched) unless frames is a multiple of the block size
+     */
+    bool render(const float* const* sources, float* output, size_t frames);
+
+    /**
+     * Forget all signal history; positions are kept
+     */
+    void reset();
+
+    /**
+     * Panning gains for an azimuth, getOutputChannels() values (panning mode)
+     */
+    void computeGains(float azimuth_deg, float* gains) const;
+
+    Mode getMode() const { return mode_; }
+    size_t getOutputChannels() const { return channels_; }
+    size_t getBlockSize() const { return block_size_; }
+    size_t getMaxSources() const { return max_sources_; }
+
+private:
+    struct Source {
+        std::atomic<float> azimuth;
+        std::atomic<float> distance;
+        std::vector<float> gains;                            // Panning: per channel at the end of the last block
+        float gain;                                          // Binaural: distance gain at the end of the last block
+        size_t direction;                                    // Binaural: HRIR in use
+        bool placed;                                         // Direction chosen yet
+        size_t idle_blocks;                                  // Blocks since the last input
+        std::vector<float> history;                          // Binaural: previous and current block
+        std::vector<std::vector<std::complex<float>>> delay; // Binaural: input spectra, newest at head
+        size_t head;
+    };
+
+    // Speakers adjacent on the circle
+    struct SpeakerPair {
+        size_t first;
+        size_t second;
+        float start;                  // Azimuth of first, radians in [0, 2 pi)
+        float span;                   // Counterclockwise to second, radians
+        bool gap;                     // 180 degrees or more: no vector base
+    };
+
+    SpatialRenderer(Mode mode, size_t channels, const Config& config);
+
+    void renderPanning(const float* const* sources);
+    void renderBinaural(const float* const* sources);
+    size_t nearestDirection(float azimuth_deg) const;
+    float distanceGain(float distance) const;
+
+    Mode mode_;
+    size_t channels_;
+    size_t block_size_;
+    size_t max_sources_;
+    float reference_distance_;
+    std::unique_ptr<Source[]> sources_;
+    std::vector<std::vector<float>> buses_;                  // Per output channel, block_size_
+    std::vector<const float*> bus_views_;
+    std::vector<const float*> views_;                        // Sources at the current block
+    std::vector<float> scratch_;
+
+    // Panning
+    std::vector<SpeakerPair> pairs_;
+    std::vector<float> target_gains_;
+
+    // Binaural
+    std::unique_ptr<RealFft> fft_;
+    size_t partitions_;
+    size_t bins_;
+    std::vector<float> hrir_azimuths_;
+    // [direction][ear][partition] spectra, bins_ each
+    std::vector<std::vector<std::complex<float>>> hrir_spectra_;
+    std::vector<std::complex<float>> accumulators_[6];       // Steady, fade in, fade out; left and right
+    std::vector<float> frame_;
+};
+
+} // namespace media_pipeline
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "media_pipeline/fft.h"
+
+namespace media_pipeline {
+
+/**
+ * Log-frequency band spectrum of a mono stream at a fixed frame rate, for display
+ *
+ * Every sample_rate / frame_rate input samples the last fft_size samples are
+ * Hann windowed and transformed, and the bin powers summed into bands spaced
+ * evenly in log frequency between min_frequency and max_frequency. Bands
+ * narrower than a bin take the bin nearest their center. Levels are dB
+ * relative to a full-scale sine (a sine at -12 dBFS reads -12 in its band),
+ * rise at once and fall by `smoothing` per frame in the power domain; each
+ * band's peak holds for peak_hold_s and then decays.
+ * Not thread-safe: one instance per stream and thread.
+ */
+class SpectrumAnalyzer {
+public:
+    struct Config {
+        size_t fft_size = 2048;             // Rounded up to a power of two
+        size_t bands = 32;
+        float min_frequency = 40.0f;
+        float max_frequency = 16000.0f;     // Clamped to Nyquist
+        float frame_rate = 30.0f;           // Frames per second of input
+        float smoothing = 0.5f;             // Fall per frame: power keeps this share of the last frame, 0..1
+        float peak_hold_s = 1.0f;
+        float peak_decay_db_per_s = 20.0f;
+        float floor_db = -100.0f;           // Levels and peaks never read lower
+    };
+
+    // Called once per frame with bands levels and peaks, in dB
+    using FrameCallback = std::function<void(const float* levels_db, const float* peaks_db, size_t bands)>;
+
+    explicit SpectrumAnalyzer(int sample_rate);
+    SpectrumAnalyzer(int sample_rate, const Config& config);
+
+    /**
+     * Analyze count mono samples
+     * @return Frames completed (callback called for each)
+     */
+    size_t process(const float* samples, size_t count, const FrameCallback& callback = FrameCallback());
+
+    const std::vector<float>& getLevels() const { return levels_db_; }
+    const std::vector<float>& getPeaks() const { return peaks_db_; }
+
+    /**
+     * Get a band's lower edge; band == getBandCount() gives the top edge
+     */
+    float getBandEdge(size_t band) const { return edges_[band]; }
+
+    size_t getBandCount() const { return levels_db_.size(); }
+    size_t getHop() const { return hop_; }
+    const Config& getConfig() const { return config_; }
+
+    /**
+     * Forget the input, levels and peaks
+     */
+    void reset();
+
+private:
+    void analyzeFrame();
+
+    Config config_;
+    RealFft fft_;
+    size_t hop_;
+    size_t fill_;                           // Samples of the current hop received
+    float power_scale_;                     // Bin |X|^2 to full-scale-sine-relative power
+    float floor_power_;
+
+    std::vector<float> window_;             // Hann, periodic
+    std::vector<float> input_;              // Last fft_size samples
+    std::vector<float> frame_;
+    std::vector<std::complex<float>> bins_;
+
+    std::vector<float> edges_;              // bands + 1, Hz
+    std::vector<uint32_t> band_first_;      // Bin range per band, end exclusive
+    std::vector<uint32_t> band_end_;
+
+    std::vector<float> power_;              // Smoothed, per band
+    std::vector<float> levels_db_;
+    std::vector<float> peaks_db_;
+    std::vector<uint32_t> hold_frames_;     // Frames left before a peak decays
+    uint32_t hold_length_;                  // peak_hold_s in frames
+    float decay_per_frame_db_;
+};
+
+} // namespace media_pipeline
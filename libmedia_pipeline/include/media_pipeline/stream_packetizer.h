@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace media_pipeline {
+
+/**
+ * Wire format of UdpStreamOutputNode packets (big-endian)
+ *
+ *   0  u64 sequence   Packet sequence; sequence - index identifies the frame
+ *   8  u16 index      Fragment index within the frame
+ *  10  u16 total      Fragments in the frame
+ *  12  u32 size       Payload bytes in this packet
+ *  16  u64 timestamp  Frame timestamp from the pipeline (ns)
+ *  24  payload
+ *
+ * The first 16 bytes match the original Kotlin header, which had no timestamp.
+ */
+namespace stream_packet {
+
+constexpr size_t kHeaderSize = 24;
+
+struct Header {
+    uint64_t sequence;
+    uint16_t index;
+    uint16_t total;
+    uint32_t size;
+    uint64_t timestamp;
+
+    uint64_t frameKey() const { return sequence - index; }
+};
+
+inline void write(const Header& header, uint8_t* out) {
+    for (int i = 0; i < 8; ++i) out[i] = static_cast<uint8_t>(header.sequence >> (56 - 8 * i));
+    out[8] = static_cast<uint8_t>(header.index >> 8);
+    out[9] = static_cast<uint8_t>(header.index);
+    out[10] = static_cast<uint8_t>(header.total >> 8);
+    out[11] = static_cast<uint8_t>(header.total);
+    for (int i = 0; i < 4; ++i) out[12 + i] = static_cast<uint8_t>(header.size >> (24 - 8 * i));
+    for (int i = 0; i < 8; ++i) out[16 + i] = static_cast<uint8_t>(header.timestamp >> (56 - 8 * i));
+}
+
+/**
+ * Parse and validate a packet header
+ * @return false if the datagram is not a well-formed stream packet
+ */
+inline bool read(const uint8_t* data, size_t length, Header& header) {
+    if (length < kHeaderSize) {
+        return false;
+    }
+    header.sequence = 0;
+    header.timestamp = 0;
+    header.size = 0;
+    for (int i = 0; i < 8; ++i) header.sequence = (header.sequence << 8) | data[i];
+    header.index = static_cast<uint16_t>((data[8] << 8) | data[9]);
+    header.total = static_cast<uint16_t>((data[10] << 8) | data[11]);
+    for (int i = 0; i < 4; ++i) header.size = (header.size << 8) | data[12 + i];
+    for (int i = 0; i < 8; ++i) header.timestamp = (header.timestamp << 8) | data[16 + i];
+    return header.total > 0 && header.index < header.total && header.size == length - kHeaderSize;
+}
+
+} // namespace stream_packet
+
+/**
+ * Splits frames into stream packets and sends them in batches
+ * Headers are written into a preallocated arena and each packet is a
+ * two-element iovec (arena header, slice of the caller's frame), so payload
+ * bytes are never copied in user space and nothing is allocated per frame.
+ * On Linux a whole batch leaves in one sendmmsg() call.
+ */
+class StreamPacketizer {
+public:
+    /**
+     * @param max_packet_size Datagram size including the header
+     * @param batch_packets Packets per sendmmsg() call (arena size)
+     */
+    explicit StreamPacketizer(size_t max_packet_size = 1400, size_t batch_packets = 64);
+    ~StreamPacketizer();
+
+    StreamPacketizer(const StreamPacketizer&) = delete;
+    StreamPacketizer& operator=(const StreamPacketizer&) = delete;
+
+    /**
+     * Set the destination (numeric IPv4 or IPv6 address), opening the socket if needed
+     */
+    bool setDestination(const std::string& host, int port, std::string& error);
+
+    /**
+     * Packetize and send one frame
+     * @return packets sent, or -1 if the frame was too large or sending failed
+     */
+    int sendFrame(const uint8_t* data, size_t size, uint64_t timestamp);
+
+    size_t getMaxPayloadSize() const { return max_payload_; }
+    uint64_t getFrameCount() const { return frame_count_; }
+    uint64_t getPacketCount() const { return packet_count_; }
+    uint64_t getErrorCount() const { return error_count_; }
+
+private:
+    bool sendBatch(size_t count);
+    msghdr& messageHeader(size_t index);
+
+    std::mutex mutex_;
+    int socket_fd_;
+    sockaddr_storage dest_;
+    socklen_t dest_len_;
+    size_t max_payload_;
+    size_t batch_packets_;
+    uint64_t next_sequence_;
+
+    std::vector<uint8_t> header_arena_;
+    std::vector<iovec> iovecs_;
+#ifdef __linux__
+    std::vector<mmsghdr> messages_;  // Sent with sendmmsg()
+#else
+    std::vector<msghdr> messages_;
+#endif
+
+    uint64_t frame_count_;
+    uint64_t packet_count_;
+    uint64_t error_count_;
+};
+
+} // namespace media_pipeline
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace media_pipeline {
+
+/**
+ * Real-time thread configuration
+ * Applied from inside the thread it configures. Every step degrades
+ * gracefully: if real-time scheduling is refused (no CAP_SYS_NICE, Android
+ * app sandbox) the thread falls back to the most favourable nice value the
+ * process is allowed, and the result says what actually happened.
+ */
+enum class SchedulingPolicy {
+    DEFAULT,      // Leave the scheduler alone
+    FIFO,         // SCHED_FIFO
+    ROUND_ROBIN   // SCHED_RR
+};
+
+struct ThreadConfig {
+    SchedulingPolicy policy = SchedulingPolicy::DEFAULT;
+    int priority = 0;                  // 1-99 for FIFO/RR
+    int nice_fallback = -19;           // Used when real-time scheduling is refused
+    int cpu = -1;                      // Core to pin to, -1 to leave affinity alone
+    bool flush_denormals = false;      // FTZ/DAZ on the calling thread
+    size_t prefault_stack_bytes = 0;   // Touch this much stack up front
+};
+
+struct ThreadConfigResult {
+    bool realtime = false;             // FIFO/RR was granted
+    bool niced = false;                // Fell back to a nice value
+    bool pinned = false;               // Affinity applied
+    bool denormals_flushed = false;
+    std::string summary;               // Human-readable report for startup logs
+};
+
+/**
+ * Apply a configuration to the calling thread
+ * @param name Thread name for the report (and pthread name where supported)
+ */
+ThreadConfigResult applyThreadConfig(const ThreadConfig& config, const char* name);
+
+/**
+ * Lock current and future pages in RAM and prefault heap
+ * Keeps page faults off the real-time path. Freed heap stays mapped
+ * (glibc) so later allocations reuse already-faulted pages.
+ * @param prefault_heap_bytes Heap to allocate, touch and release
+ * @param summary Receives a human-readable report
+ * @return false if mlockall was refused (RLIMIT_MEMLOCK, unsupported platform)
+ */
+bool lockProcessMemory(size_t prefault_heap_bytes, std::string& summary);
+
+/**
+ * Set flush-to-zero / denormals-are-zero on the calling thread
+ * @return false on architectures without a known control register
+ */
+bool enableDenormalFlush();
+
+} // namespace media_pipeline
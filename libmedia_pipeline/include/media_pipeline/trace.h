@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace media_pipeline {
+
+/**
+ * Event tracing across threads, exported as Chrome trace JSON
+ *
+ * Library and host code mark work with MP_TRACE_SCOPE("name") (a begin/end
+ * pair around the enclosing block), MP_TRACE_COUNTER("name", value) and
+ * MP_TRACE_INSTANT("name"). The macros record only when the build defines
+ * MEDIA_PIPELINE_TRACING (CMake -DENABLE_TRACING=ON); otherwise they expand
+ * to nothing and cost nothing.
+ *
+ * Each thread records into its own ring of fixed-size slots, allocated on
+ * its first event: recording is a few relaxed stores and never locks. When
+ * a ring is full the oldest events are overwritten, so a dump holds the most
+ * recent history of every thread. Rings outlive their threads, so a dump at
+ * exit still shows threads that have been joined.
+ *
+ * writeChromeJson() produces the JSON Trace Event Format, which loads in
+ * chrome://tracing and in the Perfetto UI (ui.perfetto.dev). Timestamps are
+ * CLOCK_MONOTONIC, so traces from the sender and the receiver on one host
+ * share a timeline.
+ *
+ * Names must be string literals (or otherwise outlive the dump): only the
+ * pointer is recorded.
+ */
+namespace trace {
+
+enum class Phase : uint8_t {
+    BEGIN,
+    END,
+    COUNTER,
+    INSTANT
+};
+
+void begin(const char* name);
+void end(const char* name);
+void counter(const char* name, double value);
+void instant(const char* name);
+
+/**
+ * Label the calling thread in the trace (copied)
+ */
+void setThreadName(const char* name);
+
+/**
+ * Ring size for threads that record their first event after this call
+ * @param events Rounded up to a power of two (default 16384)
+ */
+void setBufferCapacity(size_t events);
+
+/**
+ * Events lost to ring overwrites so far, over all threads
+ */
+uint64_t getOverwrittenCount();
+
+/**
+ * Write everything recorded so far; recording continues meanwhile
+ * Slots overwritten while being read are skipped.
+ */
+void writeChromeJson(std::ostream& out);
+bool writeChromeJson(const std::string& path);
+
+/**
+ * Dump to path when the process exits normally and whenever signal arrives
+ * (each dump replaces the file). The signal handler only wakes a helper
+ * thread, which does the writing.
+ * @param signal Signal to dump on (e.g. SIGUSR2), 0 for exit only
+ * @return false if the signal handler could not be installed
+ */
+bool enableDump(const std::string& path, int signal);
+
+/**
+ * Begin/end pair around a scope
+ */
+class Scope {
+public:
+    explicit Scope(const char* name) : name_(name) { begin(name); }
+    ~Scope() { end(name_); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name_;
+};
+
+} // namespace trace
+} // namespace media_pipeline
+
+#if defined(MEDIA_PIPELINE_TRACING)
+#define MP_TRACE_CONCAT_INNER(a, b) a##b
+#define MP_TRACE_CONCAT(a, b) MP_TRACE_CONCAT_INNER(a, b)
+#define MP_TRACE_SCOPE(name) ::media_pipeline::trace::Scope MP_TRACE_CONCAT(mp_trace_scope_, __LINE__)(name)
+#define MP_TRACE_COUNTER(name, value) ::media_pipeline::trace::counter(name, static_cast<double>(value))
+#define MP_TRACE_INSTANT(name) ::media_pipeline::trace::instant(name)
+#else
+#define MP_TRACE_SCOPE(name) ((void)0)
+#define MP_TRACE_COUNTER(name, value) ((void)0)
+#define MP_TRACE_INSTANT(name) ((void)0)
+#endif
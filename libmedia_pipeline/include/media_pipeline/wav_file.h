@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace media_pipeline {
+
+/**
+ * Audio read from or written to a RIFF/WAVE file
+ * Samples are interleaved floats at full scale +-1.0 whatever the file's
+ * sample format.
+ */
+struct WavData {
+    enum class Format {
+        PCM16,
+        PCM24,
+        FLOAT32
+    };
+
+    int sample_rate = 0;
+    size_t channels = 0;
+    std::vector<float> samples;
+
+    size_t getFrameCount() const { return channels ? samples.size() / channels : 0; }
+
+    /**
+     * Copy one channel out of the interleaved samples
+     */
+    std::vector<float> getChannel(size_t channel) const;
+};
+
+/**
+ * Parse a WAV file image
+ * Reads PCM 8/16/24/32-bit and IEEE float 32/64-bit, plain or
+ * WAVE_FORMAT_EXTENSIBLE; unknown chunks are skipped.
+ * @return false (with error set) if the data is not a supported WAV file
+ */
+bool readWav(const void* data, size_t size, WavData& wav, std::string& error);
+
+bool readWavFile(const std::string& path, WavData& wav, std::string& error);
+
+/**
+ * Write wav.samples in the given format (integer formats are clipped and
+ * rounded to nearest)
+ */
+bool writeWavFile(const std::string& path, const WavData& wav, WavData::Format format, std::string& error);
+
+} // namespace media_pipeline
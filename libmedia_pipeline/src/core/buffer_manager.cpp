@@ -1,10 +1,12 @@
-#include "buffer_manager.h"
-#include <android/log.h>
+#include "media_pipeline/buffer_manager.h"
+#include "media_pipeline/log.h"
 #include <cstring>
 
 #define LOG_TAG "BufferManager"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) MP_LOGI(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) MP_LOGE(LOG_TAG, __VA_ARGS__)
+
+namespace media_pipeline {
 
 BufferManager::BufferManager(int buffer_size, int inlet_count, int outlet_count)
     : buffer_size_(buffer_size)
@@ -90,4 +92,6 @@ void BufferManager::allocateBuffers() {
         LOGE("Buffer allocation failed: %s", e.what());
         throw;
     }
-}
\ No newline at end of file
+}
+
+} // namespace media_pipeline
@@ -0,0 +1,48 @@
+#include "media_pipeline/log.h"
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#endif
+
+namespace media_pipeline {
+namespace log {
+
+namespace {
+
+constexpr size_t kMessageBytes = 512;
+
+void defaultSink(Level level, const char* tag, const char* message) {
+#ifdef __ANDROID__
+    int priority = level == Level::ERROR ? ANDROID_LOG_ERROR
+                 : level == Level::WARNING ? ANDROID_LOG_WARN
+                 : ANDROID_LOG_INFO;
+    __android_log_write(priority, tag, message);
+#else
+    const char* prefix = level == Level::ERROR ? "error: " : level == Level::WARNING ? "warning: " : "";
+    std::fprintf(stderr, "[%s] %s%s\n", tag, prefix, message);
+#endif
+}
+
+std::atomic<Sink> g_sink{defaultSink};
+
+} // namespace
+
+void setSink(Sink sink) {
+    g_sink.store(sink ? sink : defaultSink, std::memory_order_release);
+}
+
+void write(Level level, const char* tag, const char* format, ...) {
+    char message[kMessageBytes];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    g_sink.load(std::memory_order_acquire)(level, tag, message);
+}
+
+} // namespace log
+} // namespace media_pipeline
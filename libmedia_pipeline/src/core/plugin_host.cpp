@@ -0,0 +1,318 @@
+#include "media_pipeline/plugin_host.h"
+#include "media_pipeline/trace.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include <dirent.h>
+#include <dlfcn.h>
+
+namespace media_pipeline {
+
+namespace {
+
+#if defined(__APPLE__)
+constexpr const char* kLibrarySuffix = ".dylib";
+#else
+constexpr const char* kLibrarySuffix = ".so";
+#endif
+
+// Every field up to and including process(); later ones may be cut off
+constexpr size_t kMinDescriptorSize = offsetof(mp_plugin_descriptor, set_param);
+
+bool endsWith(const std::string& text, const char* suffix) {
+    const size_t length = std::strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+} // namespace
+
+PluginNode::PluginNode(std::shared_ptr<void> library, std::shared_ptr<const mp_plugin_descriptor> descriptor,
+                       mp_plugin_instance* instance, size_t channels, size_t max_frames)
+    : library_(std::move(library))
+    , descriptor_(std::move(descriptor))
+    , instance_(instance)
+    , channels_(channels)
+    , max_frames_(max_frames)
+    , in_place_((descriptor_->flags & MP_PLUGIN_IN_PLACE) != 0)
+    , values_(new std::atomic<float>[descriptor_->param_count])
+    , changed_(new std::atomic<bool>[descriptor_->param_count])
+    , any_changed_(false)
+    , inputs_(channels * max_frames, 0.0f)
+    , outputs_(in_place_ ? 0 : channels * max_frames, 0.0f)
+    , input_views_(channels)
+    , output_views_(channels) {
+    for (size_t i = 0; i < descriptor_->param_count; ++i) {
+        values_[i] = descriptor_->params[i].default_value;
+        changed_[i] = false;
+    }
+    for (size_t c = 0; c < channels; ++c) {
+        input_views_[c] = inputs_.data() + c * max_frames;
+        output_views_[c] = in_place_ ? inputs_.data() + c * max_frames : outputs_.data() + c * max_frames;
+    }
+}
+
+PluginNode::~PluginNode() {
+    descriptor_->destroy(instance_);
+}
+
+bool PluginNode::setParameter(const std::string& name, float value) {
+    return setParameter(findParameter(name), value);
+}
+
+bool PluginNode::setParameter(size_t index, float value) {
+    if (index >= descriptor_->param_count) {
+        return false;
+    }
+    const mp_plugin_param& param = descriptor_->params[index];
+    values_[index].store(std::min(std::max(value, param.min_value), param.max_value), std::memory_order_relaxed);
+    changed_[index].store(true, std::memory_order_release);
+    any_changed_.store(true, std::memory_order_release);
+    return true;
+}
+
+float PluginNode::getParameter(size_t index) const {
+    return index < descriptor_->param_count ? values_[index].load(std::memory_order_relaxed) : 0.0f;
+}
+
+size_t PluginNode::findParameter(const std::string& name) const {
+    for (size_t i = 0; i < descriptor_->param_count; ++i) {
+        if (name == descriptor_->params[i].name) {
+            return i;
+        }
+    }
+    return descriptor_->param_count;
+}
+
+void PluginNode::reset() {
+    if (descriptor_->reset) {
+        descriptor_->reset(instance_);
+    }
+}
+
+// Only parameters changed since the last block reach the plugin
+void PluginNode::applyParameters() {
+    if (!any_changed_.exchange(false, std::memory_order_acquire)) {
+        return;
+    }
+    for (uint32_t i = 0; i < descriptor_->param_count; ++i) {
+        if (changed_[i].exchange(false, std::memory_order_acquire)) {
+            descriptor_->set_param(instance_, i, values_[i].load(std::memory_order_relaxed));
+        }
+    }
+}
+
+void PluginNode::process(float* data, size_t frames) {
+    MP_TRACE_SCOPE("PluginNode::process");
+    applyParameters();
+
+    mp_plugin_block block;
+    block.inputs = input_views_.data();
+    block.outputs = output_views_.data();
+    block.channels = static_cast<uint32_t>(channels_);
+    for (size_t offset = 0; offset < frames; offset += max_frames_) {
+        const size_t count = std::min(max_frames_, frames - offset);
+        float* chunk = data + offset * channels_;
+        block.frames = static_cast<uint32_t>(count);
+
+        // Mono needs no planar copy: the plugin works on the caller's buffer
+        if (channels_ == 1) {
+            const float* input = chunk;
+            float* output = in_place_ ? chunk : outputs_.data();
+            block.inputs = &input;
+            block.outputs = &output;
+            descriptor_->process(instance_, &block);
+            if (!in_place_) {
+                std::memcpy(chunk, output, count * sizeof(float));
+            }
+            continue;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t c = 0; c < channels_; ++c) {
+                inputs_[c * max_frames_ + i] = chunk[i * channels_ + c];
+            }
+        }
+        descriptor_->process(instance_, &block);
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t c = 0; c < channels_; ++c) {
+                chunk[i * channels_ + c] = output_views_[c][i];
+            }
+        }
+    }
+}
+
+std::shared_ptr<const mp_plugin_descriptor> PluginHost::check(const mp_plugin_descriptor* plugin_descriptor,
+                                                              std::string& error) const {
+    if (plugin_descriptor->abi_version != MP_PLUGIN_ABI_VERSION) {
+        error = "built for another plugin ABI (version " + std::to_string(plugin_descriptor->abi_version) +
+                ", host " + std::to_string(MP_PLUGIN_ABI_VERSION) + ")";
+        return nullptr;
+    }
+    if (plugin_descriptor->struct_size < kMinDescriptorSize) {
+        error = "descriptor of " + std::to_string(plugin_descriptor->struct_size) + " bytes, at least " +
+                std::to_string(kMinDescriptorSize) + " needed";
+        return nullptr;
+    }
+    // Only the struct_size bytes the plugin filled in are read; the rest stays NULL or 0
+    auto copy = std::make_shared<mp_plugin_descriptor>();
+    std::memcpy(copy.get(), plugin_descriptor, std::min<size_t>(plugin_descriptor->struct_size, sizeof(*copy)));
+    const mp_plugin_descriptor* descriptor = copy.get();
+
+    if (!descriptor->id || !*descriptor->id) {
+        error = "node without an id";
+        return nullptr;
+    }
+    const std::string id = descriptor->id;
+    if (!descriptor->create || !descriptor->destroy || !descriptor->process ||
+        (descriptor->param_count > 0 && (!descriptor->params || !descriptor->set_param))) {
+        error = id + ": missing create, destroy, process or set_param";
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < descriptor->param_count; ++i) {
+        const mp_plugin_param& param = descriptor->params[i];
+        if (!param.name || !(param.min_value <= param.default_value && param.default_value <= param.max_value)) {
+            error = id + ": parameter " + std::to_string(i) + " has no name or its default is out of range";
+            return nullptr;
+        }
+    }
+    if (find(id)) {
+        error = id + ": already loaded";
+        return nullptr;
+    }
+    return copy;
+}
+
+bool PluginHost::add(const mp_plugin_descriptor* descriptor, std::string& error) {
+    if (!descriptor) {
+        error = "no descriptor";
+        return false;
+    }
+    auto copy = check(descriptor, error);
+    if (!copy) {
+        return false;
+    }
+    entries_.push_back(Entry{std::move(copy), nullptr});
+    return true;
+}
+
+bool PluginHost::load(const std::string& path, std::string& error) {
+    // RTLD_LOCAL: plugins' own symbols never resolve against each other
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        const char* reason = dlerror();
+        error = reason ? reason : "cannot open " + path;
+        return false;
+    }
+    std::shared_ptr<void> library(handle, [](void* h) { dlclose(h); });
+
+    auto entry = reinterpret_cast<mp_plugin_entry_fn>(dlsym(handle, MP_PLUGIN_ENTRY_SYMBOL));
+    if (!entry) {
+        error = path + ": no " MP_PLUGIN_ENTRY_SYMBOL;
+        return false;
+    }
+
+    // All or nothing: a library with one bad node registers none
+    std::vector<Entry> loaded;
+    for (uint32_t index = 0;; ++index) {
+        const mp_plugin_descriptor* descriptor = entry(MP_PLUGIN_ABI_VERSION, index);
+        if (!descriptor) {
+            break;
+        }
+        auto copy = check(descriptor, error);
+        if (!copy) {
+            error = path + ": " + error;
+            return false;
+        }
+        for (const auto& other : loaded) {
+            if (std::strcmp(other.descriptor->id, descriptor->id) == 0) {
+                error = path + ": " + descriptor->id + " listed twice";
+                return false;
+            }
+        }
+        loaded.push_back(Entry{std::move(copy), library});
+    }
+    if (loaded.empty()) {
+        error = path + ": no node for plugin ABI version " + std::to_string(MP_PLUGIN_ABI_VERSION);
+        return false;
+    }
+    entries_.insert(entries_.end(), loaded.begin(), loaded.end());
+    return true;
+}
+
+size_t PluginHost::loadDirectory(const std::string& directory, std::vector<std::string>& errors) {
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        errors.push_back("cannot open plugin directory " + directory);
+        return 0;
+    }
+    std::vector<std::string> names;
+    while (struct dirent* item = readdir(dir)) {
+        if (item->d_name[0] != '.' && endsWith(item->d_name, kLibrarySuffix)) {
+            names.push_back(item->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+
+    size_t count = 0;
+    for (const auto& name : names) {
+        std::string error;
+        if (load(directory + "/" + name, error)) {
+            ++count;
+        } else {
+            errors.push_back(error);
+        }
+    }
+    return count;
+}
+
+const mp_plugin_descriptor* PluginHost::find(const std::string& id) const {
+    for (const auto& entry : entries_) {
+        if (id == entry.descriptor->id) {
+            return entry.descriptor.get();
+        }
+    }
+    return nullptr;
+}
+
+std::vector<const mp_plugin_descriptor*> PluginHost::getDescriptors() const {
+    std::vector<const mp_plugin_descriptor*> descriptors;
+    for (const auto& entry : entries_) {
+        descriptors.push_back(entry.descriptor.get());
+    }
+    return descriptors;
+}
+
+std::unique_ptr<PluginNode> PluginHost::createNode(const std::string& id, int sample_rate, size_t channels,
+                                                   size_t max_frames, std::string& error) const {
+    auto it = std::find_if(entries_.begin(), entries_.end(),
+                           [&](const Entry& entry) { return id == entry.descriptor->id; });
+    if (it == entries_.end()) {
+        error = "no plugin node " + id;
+        return nullptr;
+    }
+    const mp_plugin_descriptor* descriptor = it->descriptor.get();
+    if (channels == 0 || max_frames == 0 || sample_rate <= 0 ||
+        (descriptor->max_channels != 0 && channels > descriptor->max_channels)) {
+        error = id + ": unsupported configuration (" + std::to_string(channels) + " channels, blocks of " +
+                std::to_string(max_frames) + ")";
+        return nullptr;
+    }
+
+    mp_plugin_config config;
+    config.struct_size = sizeof(config);
+    config.sample_rate = static_cast<uint32_t>(sample_rate);
+    config.channels = static_cast<uint32_t>(channels);
+    config.max_frames = static_cast<uint32_t>(max_frames);
+    mp_plugin_instance* instance = descriptor->create(&config);
+    if (!instance) {
+        error = id + ": create failed for " + std::to_string(sample_rate) + " Hz, " + std::to_string(channels) +
+                " channels";
+        return nullptr;
+    }
+    return std::unique_ptr<PluginNode>(new PluginNode(it->library, it->descriptor, instance, channels, max_frames));
+}
+
+} // namespace media_pipeline
@@ -1,4 +1,6 @@
-#include "sine_generator.h"
+#include "media_pipeline/sine_generator.h"
+#include "media_pipeline/trace.h"
+
 #include <cmath>
 #include <algorithm>
 
@@ -6,6 +8,8 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace media_pipeline {
+
 SineGenerator::SineGenerator(int sample_rate, float frequency)
     : sample_rate_(sample_rate)
     , frequency_(frequency)
@@ -15,6 +19,7 @@ SineGenerator::SineGenerator(int sample_rate, float frequency)
 }
 
 void SineGenerator::generate(float* buffer, int frame_count) {
+    MP_TRACE_SCOPE("SineGenerator::generate");
     if (!buffer || frame_count <= 0) {
         return;
     }
@@ -45,4 +50,6 @@ void SineGenerator::setAmplitude(float amplitude) {
 
 void SineGenerator::updatePhaseIncrement() {
     phase_increment_ = 2.0 * M_PI * frequency_ / sample_rate_;
-}
\ No newline at end of file
+}
+
+} // namespace media_pipeline
@@ -0,0 +1,200 @@
+#include "media_pipeline/thread_config.h"
+#include "media_pipeline/trace.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sys/syscall.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#endif
+
+#if defined(__APPLE__) || defined(__GLIBC__) || defined(__ANDROID__)
+#include <alloca.h>
+#endif
+
+namespace media_pipeline {
+
+namespace {
+
+const char* policyName(SchedulingPolicy policy) {
+    switch (policy) {
+        case SchedulingPolicy::FIFO: return "SCHED_FIFO";
+        case SchedulingPolicy::ROUND_ROBIN: return "SCHED_RR";
+        default: return "default";
+    }
+}
+
+void prefaultStack(size_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    // Touch every page so the kernel maps them now rather than mid-callback
+    volatile char* stack = static_cast<volatile char*>(alloca(bytes));
+    long page = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < bytes; i += static_cast<size_t>(page)) {
+        stack[i] = 0;
+    }
+    stack[bytes - 1] = 0;
+}
+
+} // namespace
+
+bool enableDenormalFlush() {
+#if defined(__x86_64__) || defined(__i386__)
+    // FTZ (bit 15) and DAZ (bit 6)
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+    return true;
+#elif defined(__aarch64__)
+    uint64_t fpcr;
+    asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+    fpcr |= (1ULL << 24);  // FZ
+    asm volatile("msr fpcr, %0" : : "r"(fpcr));
+    return true;
+#elif defined(__arm__) && defined(__ARM_FP)
+    uint32_t fpscr;
+    asm volatile("vmrs %0, fpscr" : "=r"(fpscr));
+    fpscr |= (1U << 24);  // FZ
+    asm volatile("vmsr fpscr, %0" : : "r"(fpscr));
+    return true;
+#else
+    return false;
+#endif
+}
+
+ThreadConfigResult applyThreadConfig(const ThreadConfig& config, const char* name) {
+    ThreadConfigResult result;
+    std::ostringstream summary;
+    summary << (name ? name : "thread") << ":";
+
+#if defined(__linux__) && !defined(__ANDROID__)
+    if (name) {
+        char short_name[16];
+        std::strncpy(short_name, name, sizeof(short_name) - 1);
+        short_name[sizeof(short_name) - 1] = '\0';
+        pthread_setname_np(pthread_self(), short_name);
+    }
+#endif
+
+#if defined(MEDIA_PIPELINE_TRACING)
+    if (name) {
+        trace::setThreadName(name);
+    }
+#endif
+
+    // Scheduling policy with nice fallback
+    if (config.policy != SchedulingPolicy::DEFAULT) {
+        int policy = config.policy == SchedulingPolicy::FIFO ? SCHED_FIFO : SCHED_RR;
+        struct sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        int min_priority = sched_get_priority_min(policy);
+        int max_priority = sched_get_priority_max(policy);
+        param.sched_priority = config.priority < min_priority ? min_priority :
+                               config.priority > max_priority ? max_priority : config.priority;
+
+        int err = pthread_setschedparam(pthread_self(), policy, &param);
+        if (err == 0) {
+            result.realtime = true;
+            summary << " " << policyName(config.policy) << " priority " << param.sched_priority;
+        } else {
+            summary << " " << policyName(config.policy) << " refused (" << std::strerror(err) << ")";
+#if defined(__linux__) || defined(__ANDROID__)
+            // Per-thread nice value: setpriority on the thread id
+            pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+            if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), config.nice_fallback) == 0) {
+                result.niced = true;
+                summary << ", nice " << config.nice_fallback;
+            } else {
+                summary << ", nice " << config.nice_fallback << " refused";
+            }
+#endif
+        }
+    } else {
+        summary << " default scheduling";
+    }
+
+    // CPU affinity
+    if (config.cpu >= 0) {
+#if defined(__linux__) || defined(__ANDROID__)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config.cpu, &cpus);
+        if (sched_setaffinity(0, sizeof(cpus), &cpus) == 0) {
+            result.pinned = true;
+            summary << ", pinned to CPU " << config.cpu;
+        } else {
+            summary << ", pinning to CPU " << config.cpu << " failed";
+        }
+#else
+        summary << ", CPU pinning unsupported";
+#endif
+    }
+
+    if (config.flush_denormals) {
+        result.denormals_flushed = enableDenormalFlush();
+        summary << (result.denormals_flushed ? ", denormals flushed" : ", denormal flush unsupported");
+    }
+
+    if (config.prefault_stack_bytes > 0) {
+        prefaultStack(config.prefault_stack_bytes);
+        summary << ", " << config.prefault_stack_bytes / 1024 << " KiB stack prefaulted";
+    }
+
+    result.summary = summary.str();
+    return result;
+}
+
+bool lockProcessMemory(size_t prefault_heap_bytes, std::string& summary) {
+    std::ostringstream out;
+    bool locked = false;
+
+#if defined(MCL_CURRENT) && defined(MCL_FUTURE)
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+        locked = true;
+        out << "memory locked (mlockall)";
+    } else {
+        out << "mlockall refused (" << std::strerror(errno) << ", raise RLIMIT_MEMLOCK)";
+    }
+#else
+    out << "mlockall unsupported";
+#endif
+
+#if defined(__GLIBC__)
+    // Keep freed memory in the heap instead of returning it to the kernel
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+#endif
+
+    if (prefault_heap_bytes > 0) {
+        char* heap = static_cast<char*>(std::malloc(prefault_heap_bytes));
+        if (heap) {
+            long page = sysconf(_SC_PAGESIZE);
+            for (size_t i = 0; i < prefault_heap_bytes; i += static_cast<size_t>(page)) {
+                heap[i] = 0;
+            }
+            // Prevent the stores from being optimized away before free()
+            asm volatile("" : : "r"(heap) : "memory");
+            std::free(heap);
+            out << ", " << prefault_heap_bytes / (1024 * 1024) << " MiB heap prefaulted";
+        }
+    }
+
+    summary = out.str();
+    return locked;
+}
+
+} // namespace media_pipeline
@@ -0,0 +1,329 @@
+#include "media_pipeline/trace.h"
+#include "media_pipeline/log.h"
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace media_pipeline {
+namespace trace {
+
+namespace {
+
+constexpr const char* kTag = "Trace";
+constexpr size_t kDefaultCapacity = 16384;
+
+/**
+ * One event. Every field is atomic and the slot is guarded by a sequence
+ * number (seqlock): the owning thread zeroes it, writes the fields, then
+ * publishes index + 1; a reader keeps the slot only if it saw the same
+ * published value before and after copying.
+ */
+struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> timestamp_ns{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<double> value{0.0};
+    std::atomic<uint8_t> phase{0};
+};
+
+struct ThreadBuffer {
+    ThreadBuffer(size_t capacity, uint64_t thread_id)
+        : slots(new Slot[capacity]), mask(capacity - 1), tid(thread_id) {}
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    std::atomic<uint64_t> head{0};     // Events ever written
+    uint64_t tid;
+    std::string name;                  // Guarded by the registry mutex
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::atomic<size_t> capacity{kDefaultCapacity};
+
+    std::string dump_path;             // Guarded by mutex
+    int dump_pipe[2] = {-1, -1};
+};
+
+// Never destroyed: threads and atexit handlers may record or dump during shutdown
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+uint64_t currentThreadId() {
+#if defined(__linux__)
+    return static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+    static std::atomic<uint64_t> next{1};
+    thread_local uint64_t id = next.fetch_add(1);
+    return id;
+#endif
+}
+
+uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t power = 16;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+ThreadBuffer& threadBuffer() {
+    if (!t_buffer) {
+        Registry& reg = registry();
+        auto buffer = std::make_shared<ThreadBuffer>(reg.capacity.load(std::memory_order_relaxed), currentThreadId());
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.buffers.push_back(buffer);
+        t_buffer = buffer.get();
+    }
+    return *t_buffer;
+}
+
+void record(Phase phase, const char* name, double value) {
+    ThreadBuffer& buffer = threadBuffer();
+    uint64_t index = buffer.head.load(std::memory_order_relaxed);
+    Slot& slot = buffer.slots[index & buffer.mask];
+    // Release stores: a reader that sees any new field also sees the zeroed sequence
+    slot.sequence.store(0, std::memory_order_relaxed);
+    slot.timestamp_ns.store(nowNs(), std::memory_order_release);
+    slot.name.store(name, std::memory_order_release);
+    slot.value.store(value, std::memory_order_release);
+    slot.phase.store(static_cast<uint8_t>(phase), std::memory_order_release);
+    slot.sequence.store(index + 1, std::memory_order_release);
+    buffer.head.store(index + 1, std::memory_order_release);
+}
+
+void writeEscaped(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text ? text : ""; *c; ++c) {
+        unsigned char ch = static_cast<unsigned char>(*c);
+        if (ch == '"' || ch == '\\') {
+            out << '\\' << *c;
+        } else if (ch < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            out << escaped;
+        } else {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+const char* phaseCode(uint8_t phase) {
+    switch (static_cast<Phase>(phase)) {
+        case Phase::BEGIN: return "B";
+        case Phase::END: return "E";
+        case Phase::COUNTER: return "C";
+        default: return "i";
+    }
+}
+
+void dumpNow() {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        path = registry().dump_path;
+    }
+    if (!path.empty()) {
+        writeChromeJson(path);
+    }
+}
+
+void dumpAtExit() {
+    dumpNow();
+}
+
+void signalHandler(int) {
+    // write() is async-signal-safe; the helper thread does the dump
+    char byte = 1;
+    ssize_t ignored = write(registry().dump_pipe[1], &byte, 1);
+    (void)ignored;
+}
+
+} // namespace
+
+void begin(const char* name) {
+    record(Phase::BEGIN, name, 0.0);
+}
+
+void end(const char* name) {
+    record(Phase::END, name, 0.0);
+}
+
+void counter(const char* name, double value) {
+    record(Phase::COUNTER, name, value);
+}
+
+void instant(const char* name) {
+    record(Phase::INSTANT, name, 0.0);
+}
+
+void setThreadName(const char* name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.name = name ? name : "";
+}
+
+void setBufferCapacity(size_t events) {
+    registry().capacity.store(roundUpPowerOfTwo(events), std::memory_order_relaxed);
+}
+
+uint64_t getOverwrittenCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    uint64_t overwritten = 0;
+    for (const auto& buffer : reg.buffers) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        size_t capacity = buffer->mask + 1;
+        overwritten += head > capacity ? head - capacity : 0;
+    }
+    return overwritten;
+}
+
+void writeChromeJson(std::ostream& out) {
+    Registry& reg = registry();
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffers = reg.buffers;
+        for (const auto& buffer : buffers) {
+            names.push_back(buffer->name);
+        }
+    }
+
+    const long pid = static_cast<long>(getpid());
+    bool first = true;
+    auto separator = [&]() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t b = 0; b < buffers.size(); ++b) {
+        const ThreadBuffer& buffer = *buffers[b];
+        if (!names[b].empty()) {
+            separator();
+            out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid << ",\"tid\":" << buffer.tid
+                << ",\"args\":{\"name\":";
+            writeEscaped(out, names[b].c_str());
+            out << "}}";
+        }
+
+        const uint64_t head = buffer.head.load(std::memory_order_acquire);
+        const size_t capacity = buffer.mask + 1;
+        for (uint64_t index = head > capacity ? head - capacity : 0; index < head; ++index) {
+            const Slot& slot = buffer.slots[index & buffer.mask];
+            uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            uint64_t timestamp_ns = slot.timestamp_ns.load(std::memory_order_acquire);
+            const char* name = slot.name.load(std::memory_order_acquire);
+            double value = slot.value.load(std::memory_order_acquire);
+            uint8_t phase = slot.phase.load(std::memory_order_acquire);
+            if (before != index + 1 || slot.sequence.load(std::memory_order_relaxed) != before) {
+                continue;  // Overwritten while reading
+            }
+
+            char timestamp[32];
+            std::snprintf(timestamp, sizeof(timestamp), "%.3f", timestamp_ns / 1e3);
+            separator();
+            out << "{\"ph\":\"" << phaseCode(phase) << "\",\"name\":";
+            writeEscaped(out, name);
+            out << ",\"ts\":" << timestamp << ",\"pid\":" << pid << ",\"tid\":" << buffer.tid;
+            if (static_cast<Phase>(phase) == Phase::COUNTER) {
+                out << ",\"args\":{\"value\":" << value << "}";
+            } else if (static_cast<Phase>(phase) == Phase::INSTANT) {
+                out << ",\"s\":\"t\"";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+}
+
+bool writeChromeJson(const std::string& path) {
+    // Written beside the target and renamed, so a reader never sees half a trace
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) {
+            MP_LOGE(kTag, "cannot write %s", temporary.c_str());
+            return false;
+        }
+        writeChromeJson(file);
+        if (!file) {
+            MP_LOGE(kTag, "error writing %s", temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        MP_LOGE(kTag, "cannot rename %s to %s", temporary.c_str(), path.c_str());
+        return false;
+    }
+    MP_LOGI(kTag, "trace written to %s", path.c_str());
+    return true;
+}
+
+bool enableDump(const std::string& path, int signal) {
+    Registry& reg = registry();
+    bool first_call;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        first_call = reg.dump_path.empty();
+        reg.dump_path = path;
+    }
+    if (!first_call) {
+        return true;
+    }
+    std::atexit(dumpAtExit);
+    if (signal == 0) {
+        return true;
+    }
+
+    if (pipe(reg.dump_pipe) != 0) {
+        MP_LOGE(kTag, "cannot create the dump pipe");
+        return false;
+    }
+    std::thread([read_fd = reg.dump_pipe[0]] {
+        char byte;
+        while (read(read_fd, &byte, 1) == 1) {
+            dumpNow();
+        }
+    }).detach();
+
+    struct sigaction action{};
+    action.sa_handler = signalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(signal, &action, nullptr) != 0) {
+        MP_LOGE(kTag, "cannot install the dump handler for signal %d", signal);
+        return false;
+    }
+    return true;
+}
+
+} // namespace trace
+} // namespace media_pipeline
@@ -0,0 +1,240 @@
+#include "media_pipeline/wav_file.h"
+#include "media_pipeline/dsp_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace media_pipeline {
+
+namespace {
+
+constexpr size_t kMaxFileSize = 512 * 1024 * 1024;
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kFormatFloat = 3;
+constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void putU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    putU16(out, static_cast<uint16_t>(value));
+    putU16(out, static_cast<uint16_t>(value >> 16));
+}
+
+void putTag(std::vector<uint8_t>& out, const char* tag) {
+    out.insert(out.end(), tag, tag + 4);
+}
+
+bool convert(const uint8_t* src, size_t count, uint16_t format, uint16_t bits, float* dst) {
+    if (format == kFormatPcm) {
+        switch (bits) {
+            case 8:
+                for (size_t i = 0; i < count; ++i) {
+                    dst[i] = (static_cast<float>(src[i]) - 128.0f) / 128.0f;
+                }
+                return true;
+            case 16: {
+                std::vector<int16_t> values(count);
+                std::memcpy(values.data(), src, count * sizeof(int16_t));
+                dsp::int16ToFloat(dst, values.data(), count);
+                return true;
+            }
+            case 24:
+                dsp::int24ToFloat(dst, src, count);
+                return true;
+            case 32:
+                for (size_t i = 0; i < count; ++i) {
+                    dst[i] = static_cast<float>(static_cast<int32_t>(readU32(src + 4 * i)) / 2147483648.0);
+                }
+                return true;
+        }
+    } else if (format == kFormatFloat) {
+        if (bits == 32) {
+            std::memcpy(dst, src, count * sizeof(float));
+            return true;
+        }
+        if (bits == 64) {
+            for (size_t i = 0; i < count; ++i) {
+                double value;
+                std::memcpy(&value, src + 8 * i, sizeof(double));
+                dst[i] = static_cast<float>(value);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::vector<float> WavData::getChannel(size_t channel) const {
+    std::vector<float> result;
+    if (channel >= channels) {
+        return result;
+    }
+    const size_t frames = getFrameCount();
+    result.resize(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        result[i] = samples[i * channels + channel];
+    }
+    return result;
+}
+
+bool readWav(const void* data, size_t size, WavData& wav, std::string& error) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    if (!data || size < 12 || std::memcmp(bytes, "RIFF", 4) != 0 || std::memcmp(bytes + 8, "WAVE", 4) != 0) {
+        error = "not a RIFF/WAVE file";
+        return false;
+    }
+
+    uint16_t format = 0;
+    uint16_t channels = 0;
+    uint32_t sample_rate = 0;
+    uint16_t bits = 0;
+    bool have_format = false;
+    size_t position = 12;
+    while (position + 8 <= size) {
+        const uint8_t* chunk = bytes + position;
+        const size_t chunk_size = readU32(chunk + 4);
+        const uint8_t* body = chunk + 8;
+        // Writers that stream often leave the data size at 0 or 0xFFFFFFFF: take what is there
+        const size_t available = std::min(chunk_size, size - position - 8);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            if (available < 16) {
+                error = "truncated fmt chunk";
+                return false;
+            }
+            format = readU16(body);
+            channels = readU16(body + 2);
+            sample_rate = readU32(body + 4);
+            bits = readU16(body + 14);
+            if (format == kFormatExtensible) {
+                if (available < 40) {
+                    error = "truncated WAVE_FORMAT_EXTENSIBLE fmt chunk";
+                    return false;
+                }
+                format = readU16(body + 24);  // First two bytes of the subformat GUID
+            }
+            have_format = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!have_format) {
+                error = "data chunk before fmt chunk";
+                return false;
+            }
+            if (channels == 0 || sample_rate == 0 || bits == 0 || bits % 8 != 0) {
+                error = "invalid fmt chunk";
+                return false;
+            }
+            const size_t frame_bytes = static_cast<size_t>(channels) * (bits / 8);
+            const size_t count = available / frame_bytes * channels;
+            wav.samples.resize(count);
+            if (!convert(body, count, format, bits, wav.samples.data())) {
+                error = "unsupported sample format " + std::to_string(format) + " with " +
+                        std::to_string(bits) + " bits";
+                wav.samples.clear();
+                return false;
+            }
+            wav.sample_rate = static_cast<int>(sample_rate);
+            wav.channels = channels;
+            return true;
+        }
+        position += 8 + chunk_size + (chunk_size & 1);  // Chunks are padded to even sizes
+    }
+    error = have_format ? "no data chunk" : "no fmt chunk";
+    return false;
+}
+
+bool readWavFile(const std::string& path, WavData& wav, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::vector<char> contents;
+    contents.reserve(4096);
+    char buffer[4096];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        contents.insert(contents.end(), buffer, buffer + file.gcount());
+        if (contents.size() > kMaxFileSize) {
+            error = path + " is too large";
+            return false;
+        }
+    }
+    if (!readWav(contents.data(), contents.size(), wav, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+bool writeWavFile(const std::string& path, const WavData& wav, WavData::Format format, std::string& error) {
+    if (wav.channels == 0 || wav.sample_rate <= 0) {
+        error = "no channels or sample rate to write";
+        return false;
+    }
+    const size_t count = wav.getFrameCount() * wav.channels;
+    const uint16_t bits = format == WavData::Format::PCM16 ? 16 : format == WavData::Format::PCM24 ? 24 : 32;
+    const size_t data_bytes = count * (bits / 8);
+    if (data_bytes > 0xFFFFFFFFu - 44) {
+        error = "too much audio for a WAV file";
+        return false;
+    }
+
+    std::vector<uint8_t> out;
+    out.reserve(44 + data_bytes + 1);
+    putTag(out, "RIFF");
+    putU32(out, static_cast<uint32_t>(36 + data_bytes + (data_bytes & 1)));
+    putTag(out, "WAVE");
+    putTag(out, "fmt ");
+    putU32(out, 16);
+    putU16(out, format == WavData::Format::FLOAT32 ? kFormatFloat : kFormatPcm);
+    putU16(out, static_cast<uint16_t>(wav.channels));
+    putU32(out, static_cast<uint32_t>(wav.sample_rate));
+    putU32(out, static_cast<uint32_t>(wav.sample_rate * wav.channels * (bits / 8)));
+    putU16(out, static_cast<uint16_t>(wav.channels * (bits / 8)));
+    putU16(out, bits);
+    putTag(out, "data");
+    putU32(out, static_cast<uint32_t>(data_bytes));
+
+    const size_t header = out.size();
+    out.resize(header + data_bytes);
+    switch (format) {
+        case WavData::Format::PCM16: {
+            std::vector<int16_t> values(count);
+            dsp::floatToInt16(values.data(), wav.samples.data(), count);
+            std::memcpy(out.data() + header, values.data(), data_bytes);
+            break;
+        }
+        case WavData::Format::PCM24:
+            dsp::floatToInt24(out.data() + header, wav.samples.data(), count);
+            break;
+        case WavData::Format::FLOAT32:
+            std::memcpy(out.data() + header, wav.samples.data(), data_bytes);
+            break;
+    }
+    if (data_bytes & 1) {
+        out.push_back(0);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()))) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace media_pipeline
@@ -0,0 +1,339 @@
+#include "media_pipeline/biquad.h"
+#include "media_pipeline/dsp_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace media_pipeline {
+
+namespace {
+
+struct TypeName {
+    BiquadCoefficients::Type type;
+    const char* name;
+};
+
+const TypeName kTypeNames[] = {
+    {BiquadCoefficients::Type::LOWPASS, "lowpass"},
+    {BiquadCoefficients::Type::HIGHPASS, "highpass"},
+    {BiquadCoefficients::Type::BANDPASS, "bandpass"},
+    {BiquadCoefficients::Type::NOTCH, "notch"},
+    {BiquadCoefficients::Type::ALLPASS, "allpass"},
+    {BiquadCoefficients::Type::PEAKING, "peaking"},
+    {BiquadCoefficients::Type::LOW_SHELF, "lowshelf"},
+    {BiquadCoefficients::Type::HIGH_SHELF, "highshelf"},
+};
+
+} // namespace
+
+// ---------------------------------------------------------------- BiquadCoefficients
+
+BiquadCoefficients BiquadCoefficients::design(Type type, double sample_rate, double frequency, double q,
+                                              double gain_db) {
+    const double nyquist = sample_rate / 2.0;
+    frequency = std::min(std::max(frequency, 1e-3), nyquist * 0.9999);
+    q = std::max(q, 1e-3);
+
+    const double w0 = 2.0 * M_PI * frequency / sample_rate;
+    const double cosw = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double a = std::pow(10.0, gain_db / 40.0);
+    const double shelf = 2.0 * std::sqrt(a) * alpha;
+
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+    switch (type) {
+        case Type::LOWPASS:
+            b0 = (1.0 - cosw) / 2.0; b1 = 1.0 - cosw; b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosw; a2 = 1.0 - alpha;
+            break;
+        case Type::HIGHPASS:
+            b0 = (1.0 + cosw) / 2.0; b1 = -(1.0 + cosw); b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosw; a2 = 1.0 - alpha;
+            break;
+        case Type::BANDPASS:
+            b0 = alpha; b1 = 0.0; b2 = -alpha;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosw; a2 = 1.0 - alpha;
+            break;
+        case Type::NOTCH:
+            b0 = 1.0; b1 = -2.0 * cosw; b2 = 1.0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosw; a2 = 1.0 - alpha;
+            break;
+        case Type::ALLPASS:
+            b0 = 1.0 - alpha; b1 = -2.0 * cosw; b2 = 1.0 + alpha;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosw; a2 = 1.0 - alpha;
+            break;
+        case Type::PEAKING:
+            b0 = 1.0 + alpha * a; b1 = -2.0 * cosw; b2 = 1.0 - alpha * a;
+            a0 = 1.0 + alpha / a; a1 = -2.0 * cosw; a2 = 1.0 - alpha / a;
+            break;
+        case Type::LOW_SHELF:
+            b0 = a * ((a + 1.0) - (a - 1.0) * cosw + shelf);
+            b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cosw);
+            b2 = a * ((a + 1.0) - (a - 1.0) * cosw - shelf);
+            a0 = (a + 1.0) + (a - 1.0) * cosw + shelf;
+            a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cosw);
+            a2 = (a + 1.0) + (a - 1.0) * cosw - shelf;
+            break;
+        case Type::HIGH_SHELF:
+            b0 = a * ((a + 1.0) + (a - 1.0) * cosw + shelf);
+            b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cosw);
+            b2 = a * ((a + 1.0) + (a - 1.0) * cosw - shelf);
+            a0 = (a + 1.0) - (a - 1.0) * cosw + shelf;
+            a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cosw);
+            a2 = (a + 1.0) - (a - 1.0) * cosw - shelf;
+            break;
+    }
+
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>(b0 / a0);
+    c.b1 = static_cast<float>(b1 / a0);
+    c.b2 = static_cast<float>(b2 / a0);
+    c.a1 = static_cast<float>(a1 / a0);
+    c.a2 = static_cast<float>(a2 / a0);
+    return c;
+}
+
+const char* BiquadCoefficients::typeName(Type type) {
+    for (const auto& entry : kTypeNames) {
+        if (entry.type == type) {
+            return entry.name;
+        }
+    }
+    return "unknown";
+}
+
+bool BiquadCoefficients::parseType(const std::string& name, Type& type) {
+    for (const auto& entry : kTypeNames) {
+        if (name == entry.name) {
+            type = entry.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+double BiquadCoefficients::magnitude(double sample_rate, double frequency) const {
+    const std::complex<double> z1 = std::polar(1.0, -2.0 * M_PI * frequency / sample_rate);
+    const std::complex<double> z2 = z1 * z1;
+    const std::complex<double> numerator = static_cast<double>(b0) + static_cast<double>(b1) * z1 +
+                                           static_cast<double>(b2) * z2;
+    const std::complex<double> denominator = 1.0 + static_cast<double>(a1) * z1 + static_cast<double>(a2) * z2;
+    return std::abs(numerator / denominator);
+}
+
+// ---------------------------------------------------------------- BiquadBank
+
+BiquadBank::BiquadBank(size_t lane_count, size_t stage_count)
+    : lanes_(std::max<size_t>(lane_count, 1))
+    , padded_((lanes_ + 3) & ~size_t(3))
+    , stages_(std::max<size_t>(stage_count, 1))
+    , coefficients_(stages_ * 5 * padded_, 0.0f)
+    , state_(stages_ * 2 * padded_, 0.0f)
+    , scratch_(kChunkFrames * padded_, 0.0f)
+    , ramps_(lanes_ * stages_)
+    , designs_(lanes_ * stages_)
+    , active_ramps_(0) {
+    // Identity sections everywhere, padding lanes included
+    for (size_t stage = 0; stage < stages_; ++stage) {
+        std::fill_n(coefficients_.begin() + stage * 5 * padded_, padded_, 1.0f);
+    }
+    for (auto& ramp : ramps_) {
+        ramp.length = 0;
+    }
+    for (auto& design : designs_) {
+        design.valid = false;
+    }
+}
+
+void BiquadBank::writeCoefficient(size_t lane, size_t stage, const float* values) {
+    float* c = coefficients_.data() + stage * 5 * padded_ + lane;
+    for (size_t k = 0; k < 5; ++k) {
+        c[k * padded_] = values[k];
+    }
+}
+
+void BiquadBank::cancelRamp(size_t lane, size_t stage) {
+    Ramp& ramp = ramps_[lane * stages_ + stage];
+    if (ramp.length != 0) {
+        active_ramps_--;
+        ramp.length = 0;
+    }
+}
+
+void BiquadBank::setCoefficients(size_t lane, size_t stage, const BiquadCoefficients& coefficients,
+                                 size_t ramp_frames) {
+    if (lane >= lanes_ || stage >= stages_) {
+        return;
+    }
+    const float target[5] = {coefficients.b0, coefficients.b1, coefficients.b2, coefficients.a1, coefficients.a2};
+    Ramp& ramp = ramps_[lane * stages_ + stage];
+    cancelRamp(lane, stage);
+    designs_[lane * stages_ + stage].valid = false;
+    ramp.by_design = false;
+    if (ramp_frames == 0) {
+        writeCoefficient(lane, stage, target);
+        return;
+    }
+
+    // From wherever the lane is now, so a new target mid-ramp does not jump
+    const float* c = coefficients_.data() + stage * 5 * padded_ + lane;
+    for (size_t k = 0; k < 5; ++k) {
+        ramp.start[k] = c[k * padded_];
+        ramp.target[k] = target[k];
+    }
+    ramp.elapsed = 0;
+    ramp.length = ramp_frames;
+    active_ramps_++;
+}
+
+void BiquadBank::setCoefficientsAll(size_t stage, const BiquadCoefficients& coefficients, size_t ramp_frames) {
+    for (size_t lane = 0; lane < lanes_; ++lane) {
+        setCoefficients(lane, stage, coefficients, ramp_frames);
+    }
+}
+
+void BiquadBank::setDesign(size_t lane, size_t stage, BiquadCoefficients::Type type, double sample_rate,
+                           double frequency, double q, double gain_db, size_t ramp_frames) {
+    if (lane >= lanes_ || stage >= stages_) {
+        return;
+    }
+    const size_t index = lane * stages_ + stage;
+    // Where a running design ramp has got to, so retargeting mid-sweep is smooth
+    Design from = designs_[index];
+    Ramp& ramp = ramps_[index];
+    if (ramp.length != 0 && ramp.by_design) {
+        const double t = static_cast<double>(ramp.elapsed) / static_cast<double>(ramp.length);
+        from.frequency = ramp.from.frequency * std::pow(from.frequency / ramp.from.frequency, t);
+        from.q = ramp.from.q + (from.q - ramp.from.q) * t;
+        from.gain_db = ramp.from.gain_db + (from.gain_db - ramp.from.gain_db) * t;
+    }
+    const bool glide = ramp_frames != 0 && from.valid && from.type == type && from.sample_rate == sample_rate;
+
+    setCoefficients(lane, stage, BiquadCoefficients::design(type, sample_rate, frequency, q, gain_db), ramp_frames);
+    designs_[index] = {true, type, sample_rate, frequency, q, gain_db};
+    if (glide) {
+        ramp.by_design = true;
+        ramp.from = from;
+    }
+}
+
+BiquadCoefficients BiquadBank::getCoefficients(size_t lane, size_t stage) const {
+    BiquadCoefficients result;
+    if (lane >= lanes_ || stage >= stages_) {
+        return result;
+    }
+    float values[5];
+    const Ramp& ramp = ramps_[lane * stages_ + stage];
+    const float* c = coefficients_.data() + stage * 5 * padded_ + lane;
+    for (size_t k = 0; k < 5; ++k) {
+        values[k] = ramp.length != 0 ? ramp.target[k] : c[k * padded_];
+    }
+    result.b0 = values[0];
+    result.b1 = values[1];
+    result.b2 = values[2];
+    result.a1 = values[3];
+    result.a2 = values[4];
+    return result;
+}
+
+// Coefficients for the next frames, interpolated to the end of that span
+void BiquadBank::advanceRamps(size_t frames) {
+    for (size_t lane = 0; lane < lanes_; ++lane) {
+        for (size_t stage = 0; stage < stages_; ++stage) {
+            Ramp& ramp = ramps_[lane * stages_ + stage];
+            if (ramp.length == 0) {
+                continue;
+            }
+            ramp.elapsed += frames;
+            if (ramp.elapsed >= ramp.length) {
+                writeCoefficient(lane, stage, ramp.target);
+                ramp.length = 0;
+                active_ramps_--;
+                continue;
+            }
+            if (ramp.by_design) {
+                const Design& to = designs_[lane * stages_ + stage];
+                const double t = static_cast<double>(ramp.elapsed) / static_cast<double>(ramp.length);
+                auto c = BiquadCoefficients::design(to.type, to.sample_rate,
+                                                    ramp.from.frequency * std::pow(to.frequency / ramp.from.frequency, t),
+                                                    ramp.from.q + (to.q - ramp.from.q) * t,
+                                                    ramp.from.gain_db + (to.gain_db - ramp.from.gain_db) * t);
+                const float values[5] = {c.b0, c.b1, c.b2, c.a1, c.a2};
+                writeCoefficient(lane, stage, values);
+                continue;
+            }
+            const float t = static_cast<float>(ramp.elapsed) / static_cast<float>(ramp.length);
+            float values[5];
+            for (size_t k = 0; k < 5; ++k) {
+                values[k] = ramp.start[k] + (ramp.target[k] - ramp.start[k]) * t;
+            }
+            writeCoefficient(lane, stage, values);
+        }
+    }
+}
+
+void BiquadBank::runChunk(size_t frames) {
+    dsp::biquadCascade(scratch_.data(), frames, padded_, coefficients_.data(), state_.data(), stages_);
+}
+
+void BiquadBank::process(float* data, size_t frames) {
+    size_t done = 0;
+    while (done < frames) {
+        const size_t count = std::min(frames - done, active_ramps_ ? kRampStep : kChunkFrames);
+        if (active_ramps_) {
+            advanceRamps(count);
+        }
+        float* rows = data + done * lanes_;
+        if (padded_ == lanes_) {
+            dsp::biquadCascade(rows, count, padded_, coefficients_.data(), state_.data(), stages_);
+        } else {
+            for (size_t n = 0; n < count; ++n) {
+                std::copy(rows + n * lanes_, rows + (n + 1) * lanes_, scratch_.begin() + n * padded_);
+            }
+            runChunk(count);
+            for (size_t n = 0; n < count; ++n) {
+                std::copy(scratch_.begin() + n * padded_, scratch_.begin() + n * padded_ + lanes_, rows + n * lanes_);
+            }
+        }
+        done += count;
+    }
+}
+
+void BiquadBank::processPlanar(float* const* channels, size_t frames) {
+    size_t done = 0;
+    while (done < frames) {
+        const size_t count = std::min(frames - done, active_ramps_ ? kRampStep : kChunkFrames);
+        if (active_ramps_) {
+            advanceRamps(count);
+        }
+        for (size_t lane = 0; lane < lanes_; ++lane) {
+            const float* src = channels[lane] + done;
+            for (size_t n = 0; n < count; ++n) {
+                scratch_[n * padded_ + lane] = src[n];
+            }
+        }
+        runChunk(count);
+        for (size_t lane = 0; lane < lanes_; ++lane) {
+            float* dst = channels[lane] + done;
+            for (size_t n = 0; n < count; ++n) {
+                dst[n] = scratch_[n * padded_ + lane];
+            }
+        }
+        done += count;
+    }
+}
+
+void BiquadBank::reset() {
+    std::fill(state_.begin(), state_.end(), 0.0f);
+    for (size_t i = 0; i < ramps_.size() && active_ramps_; ++i) {
+        Ramp& ramp = ramps_[i];
+        if (ramp.length != 0) {
+            writeCoefficient(i / stages_, i % stages_, ramp.target);
+            ramp.length = 0;
+            active_ramps_--;
+        }
+    }
+}
+
+} // namespace media_pipeline
@@ -0,0 +1,266 @@
+#include "media_pipeline/convolver.h"
+#include "media_pipeline/dsp_kernels.h"
+#include "media_pipeline/trace.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace media_pipeline {
+
+namespace {
+
+constexpr size_t kMinBlockSize = 8;
+constexpr size_t kMaxTailPartition = 8192;
+
+bool isPowerOfTwo(size_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+float* interleaved(std::vector<std::complex<float>>& bins) {
+    return reinterpret_cast<float*>(bins.data());
+}
+
+} // namespace
+
+// ---------------------------------------------------------------- Stage
+
+PartitionedConvolver::Stage::Stage(const float* ir, size_t length, size_t partition)
+    : partition_(partition)
+    , bins_(partition + 1)
+    , fft_(2 * partition)
+    , head_(0)
+    , input_(2 * partition, 0.0f)
+    , time_(2 * partition, 0.0f)
+    , accumulator_(partition + 1) {
+    const size_t count = (length + partition - 1) / partition;
+    spectra_.resize(count);
+    delay_.assign(count, std::vector<std::complex<float>>(bins_));
+    for (size_t m = 0; m < count; ++m) {
+        const size_t begin = m * partition;
+        const size_t end = std::min(length, begin + partition);
+        std::fill(time_.begin(), time_.end(), 0.0f);
+        std::copy(ir + begin, ir + end, time_.begin());
+        spectra_[m].resize(bins_);
+        fft_.forward(time_.data(), spectra_[m].data());
+    }
+}
+
+// Overlap-save: transform the last two input blocks, multiply-accumulate
+// every IR partition with the input spectrum as old as its offset, and keep
+// the second half of the inverse (the first is circularly aliased)
+void PartitionedConvolver::Stage::process(const float* input, float* output) {
+    std::memmove(input_.data(), input_.data() + partition_, partition_ * sizeof(float));
+    std::memcpy(input_.data() + partition_, input, partition_ * sizeof(float));
+
+    const size_t count = spectra_.size();
+    head_ = (head_ + count - 1) % count;
+    fft_.forward(input_.data(), delay_[head_].data());
+
+    std::fill(accumulator_.begin(), accumulator_.end(), std::complex<float>());
+    for (size_t m = 0, slot = head_; m < count; ++m) {
+        dsp::complexMultiplyAccumulate(interleaved(accumulator_), interleaved(delay_[slot]),
+                                       interleaved(spectra_[m]), bins_);
+        slot = slot + 1 == count ? 0 : slot + 1;
+    }
+
+    fft_.inverse(accumulator_.data(), time_.data());
+    std::memcpy(output, time_.data() + partition_, partition_ * sizeof(float));
+}
+
+void PartitionedConvolver::Stage::reset() {
+    for (auto& spectrum : delay_) {
+        std::fill(spectrum.begin(), spectrum.end(), std::complex<float>());
+    }
+    std::fill(input_.begin(), input_.end(), 0.0f);
+    head_ = 0;
+}
+
+// ---------------------------------------------------------------- PartitionedConvolver
+
+std::unique_ptr<PartitionedConvolver> PartitionedConvolver::create(const float* ir, size_t length,
+                                                                   const Config& config, std::string& error) {
+    if (!ir || length == 0) {
+        error = "empty impulse response";
+        return nullptr;
+    }
+    if (!isPowerOfTwo(config.block_size) || config.block_size < kMinBlockSize) {
+        error = "block size must be a power of two of at least " + std::to_string(kMinBlockSize);
+        return nullptr;
+    }
+    size_t tail_size = config.tail_partition;
+    if (tail_size == 0) {
+        tail_size = std::max(config.block_size, std::min(kMaxTailPartition, 16 * config.block_size));
+    }
+    if (!isPowerOfTwo(tail_size) || tail_size < config.block_size) {
+        error = "tail partition must be a power of two multiple of the block size";
+        return nullptr;
+    }
+    return std::unique_ptr<PartitionedConvolver>(new PartitionedConvolver(ir, length, config, tail_size));
+}
+
+PartitionedConvolver::PartitionedConvolver(const float* ir, size_t length, const Config& config, size_t tail_size)
+    : block_size_(config.block_size)
+    , tail_size_(tail_size)
+    , length_(length)
+    , background_(config.background_tail)
+    , tail_thread_config_(config.tail_thread)
+    , position_(0)
+    , mixing_tail_(false)
+    , submitted_(0)
+    , taken_(0)
+    , busy_(false)
+    , stop_(false)
+    , completed_(0)
+    , submitted_count_(0)
+    , late_(0) {
+    const size_t head_length = std::min(length, 2 * tail_size);
+    head_.reset(new Stage(ir, head_length, block_size_));
+    if (length <= head_length) {
+        return;
+    }
+
+    tail_.reset(new Stage(ir + head_length, length - head_length, tail_size));
+    tail_input_.assign(tail_size, 0.0f);
+    tail_work_.assign(tail_size, 0.0f);
+    for (auto& output : tail_output_) {
+        output.assign(tail_size, 0.0f);
+    }
+    if (background_) {
+        for (auto& pending : pending_) {
+            pending.assign(tail_size, 0.0f);
+        }
+        tail_thread_ = std::thread(&PartitionedConvolver::tailLoop, this);
+    }
+}
+
+PartitionedConvolver::~PartitionedConvolver() {
+    if (tail_thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(tail_mutex_);
+            stop_ = true;
+        }
+        tail_wake_.notify_one();
+        tail_thread_.join();
+    }
+}
+
+bool PartitionedConvolver::process(const float* input, float* output, size_t count) {
+    if (count % block_size_ != 0) {
+        return false;
+    }
+    MP_TRACE_SCOPE("PartitionedConvolver::process");
+    for (size_t offset = 0; offset < count; offset += block_size_) {
+        processBlock(input + offset, output + offset);
+    }
+    return true;
+}
+
+void PartitionedConvolver::processBlock(const float* input, float* output) {
+    if (tail_) {
+        // Before the head writes output: input and output may be one buffer
+        std::memcpy(tail_input_.data() + position_ % tail_size_, input, block_size_ * sizeof(float));
+    }
+    head_->process(input, output);
+
+    if (tail_ && position_ >= 2 * tail_size_) {
+        // Tail block j is the IR past the head applied to input block j: it plays at (j + 2) * tail_size
+        const uint64_t index = (position_ - 2 * tail_size_) / tail_size_;
+        const size_t offset = (position_ - 2 * tail_size_) % tail_size_;
+        if (offset == 0) {
+            mixing_tail_ = completed_.load(std::memory_order_acquire) > index;
+            if (!mixing_tail_) {
+                late_.fetch_add(1, std::memory_order_relaxed);
+                MP_TRACE_INSTANT("convolver_tail_late");
+            }
+        }
+        if (mixing_tail_) {
+            dsp::mixAccumulate(output, tail_output_[index % 2].data() + offset, block_size_, 1.0f);
+        }
+    }
+
+    position_ += block_size_;
+    if (tail_ && position_ % tail_size_ == 0) {
+        submitTail();
+    }
+}
+
+// Hand off after this block's tail output was read: the slot the new block
+// will write (index % 2) is not read again until its own turn
+void PartitionedConvolver::submitTail() {
+    const uint64_t index = submitted_count_.load(std::memory_order_relaxed);
+    submitted_count_.store(index + 1, std::memory_order_relaxed);
+    if (!background_) {
+        computeTail(index, tail_input_.data());
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(tail_mutex_);
+        std::copy(tail_input_.begin(), tail_input_.end(), pending_[index % kPendingBlocks].begin());
+        submitted_ = index + 1;
+    }
+    tail_wake_.notify_one();
+}
+
+void PartitionedConvolver::computeTail(uint64_t index, const float* input) {
+    MP_TRACE_SCOPE("PartitionedConvolver::tail");
+    tail_->process(input, tail_output_[index % 2].data());
+    completed_.store(index + 1, std::memory_order_release);
+}
+
+void PartitionedConvolver::tailLoop() {
+    applyThreadConfig(tail_thread_config_, "conv-tail");
+    std::unique_lock<std::mutex> lock(tail_mutex_);
+    while (true) {
+        tail_wake_.wait(lock, [this] { return stop_ || taken_ < submitted_; });
+        if (stop_) {
+            return;
+        }
+        const uint64_t index = taken_++;
+        if (submitted_ - index > kPendingBlocks) {
+            // Overwritten before we got to it: keep the delay line in step with silence
+            std::fill(tail_work_.begin(), tail_work_.end(), 0.0f);
+        } else {
+            const auto& pending = pending_[index % kPendingBlocks];
+            std::copy(pending.begin(), pending.end(), tail_work_.begin());
+        }
+        busy_ = true;
+        lock.unlock();
+
+        computeTail(index, tail_work_.data());
+
+        lock.lock();
+        busy_ = false;
+        tail_idle_.notify_all();
+    }
+}
+
+void PartitionedConvolver::reset() {
+    head_->reset();
+    position_ = 0;
+    mixing_tail_ = false;
+    if (!tail_) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(tail_mutex_);
+    taken_ = submitted_;  // Drop queued blocks
+    tail_idle_.wait(lock, [this] { return !busy_; });
+    tail_->reset();
+    submitted_ = 0;
+    taken_ = 0;
+    submitted_count_.store(0, std::memory_order_relaxed);
+    completed_.store(0, std::memory_order_relaxed);
+    std::fill(tail_input_.begin(), tail_input_.end(), 0.0f);
+}
+
+PartitionedConvolver::Stats PartitionedConvolver::getStats() const {
+    Stats stats;
+    stats.head_partitions = head_->getPartitionCount();
+    stats.tail_partitions = tail_ ? tail_->getPartitionCount() : 0;
+    stats.tail_blocks_submitted = submitted_count_.load(std::memory_order_relaxed);
+    stats.tail_blocks_completed = completed_.load(std::memory_order_relaxed);
+    stats.tail_blocks_late = late_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace media_pipeline
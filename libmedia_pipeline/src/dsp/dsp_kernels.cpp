@@ -0,0 +1,332 @@
+#include "media_pipeline/dsp_kernels.h"
+#include "kernel_table.h"
+
+#include <atomic>
+
+namespace media_pipeline {
+namespace dsp {
+
+namespace reference {
+
+void applyGain(float* data, size_t count, float gain) {
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = data[i] * gain;
+    }
+}
+
+void applyGainRamp(float* data, size_t count, float start_gain, float end_gain) {
+    if (count == 0) {
+        return;
+    }
+    const float step = (end_gain - start_gain) / static_cast<float>(count);
+    for (size_t i = 0; i < count; ++i) {
+        float g = start_gain + step * static_cast<float>(static_cast<int32_t>(i));
+        data[i] = data[i] * g;
+    }
+}
+
+void mixAccumulate(float* dst, const float* src, size_t count, float gain) {
+    for (size_t i = 0; i < count; ++i) {
+        float scaled = src[i] * gain;
+        dst[i] = dst[i] + scaled;
+    }
+}
+
+float dot(const float* a, const float* b, size_t count) {
+    float lanes[8] = {};
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        for (size_t k = 0; k < 8; ++k) {
+            float product = a[i + k] * b[i + k];
+            lanes[k] = lanes[k] + product;
+        }
+    }
+    return dotTail(reduceLanes8(lanes), a, b, i, count);
+}
+
+void complexMultiplyAccumulate(float* acc, const float* a, const float* b, size_t count) {
+    complexMultiplyAccumulateTail(acc, a, b, 0, count);
+}
+
+void biquadCascade(float* data, size_t frames, size_t lanes, const float* coefficients, float* state,
+                   size_t stages) {
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        biquadLane(data, frames, lanes, lane, coefficients, state, stages);
+    }
+}
+
+void hardClip(float* data, size_t count, float limit) {
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = clampScalar(data[i], -limit, limit);
+    }
+}
+
+void softClip(float* data, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        float c = clampScalar(data[i], -1.0f, 1.0f);
+        float t = c * c;
+        t = t * 0.5f;
+        t = 1.5f - t;
+        data[i] = c * t;
+    }
+}
+
+void floatToInt16(int16_t* dst, const float* src, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<int16_t>(quantizeScalar(src[i], kInt16Scale, -32768.0f, 32767.0f));
+    }
+}
+
+void int16ToFloat(float* dst, const int16_t* src, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<float>(src[i]) * (1.0f / kInt16Scale);
+    }
+}
+
+void floatToInt24(uint8_t* dst, const float* src, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        storeInt24(dst + i * 3, quantizeScalar(src[i], kInt24Scale, -8388608.0f, 8388607.0f));
+    }
+}
+
+void int24ToFloat(float* dst, const uint8_t* src, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<float>(loadInt24(src + i * 3)) * (1.0f / kInt24Scale);
+    }
+}
+
+void interleave(float* dst, const float* const* channels, size_t channel_count, size_t frames) {
+    for (size_t frame = 0; frame < frames; ++frame) {
+        for (size_t ch = 0; ch < channel_count; ++ch) {
+            dst[frame * channel_count + ch] = channels[ch][frame];
+        }
+    }
+}
+
+void deinterleave(float* const* channels, const float* src, size_t channel_count, size_t frames) {
+    for (size_t frame = 0; frame < frames; ++frame) {
+        for (size_t ch = 0; ch < channel_count; ++ch) {
+            channels[ch][frame] = src[frame * channel_count + ch];
+        }
+    }
+}
+
+} // namespace reference
+
+namespace {
+
+void interleave2Scalar(float* dst, const float* left, const float* right, size_t frames) {
+    const float* channels[2] = {left, right};
+    reference::interleave(dst, channels, 2, frames);
+}
+
+void deinterleave2Scalar(float* left, float* right, const float* src, size_t frames) {
+    float* channels[2] = {left, right};
+    reference::deinterleave(channels, src, 2, frames);
+}
+
+// Variant with any null entries filled from the scalar table
+KernelTable complete(const KernelTable& variant) {
+    const KernelTable& s = scalarKernels();
+    KernelTable t = variant;
+    if (!t.applyGain) t.applyGain = s.applyGain;
+    if (!t.applyGainRamp) t.applyGainRamp = s.applyGainRamp;
+    if (!t.mixAccumulate) t.mixAccumulate = s.mixAccumulate;
+    if (!t.dot) t.dot = s.dot;
+    if (!t.complexMultiplyAccumulate) t.complexMultiplyAccumulate = s.complexMultiplyAccumulate;
+    if (!t.biquadCascade) t.biquadCascade = s.biquadCascade;
+    if (!t.hardClip) t.hardClip = s.hardClip;
+    if (!t.softClip) t.softClip = s.softClip;
+    if (!t.floatToInt16) t.floatToInt16 = s.floatToInt16;
+    if (!t.int16ToFloat) t.int16ToFloat = s.int16ToFloat;
+    if (!t.floatToInt24) t.floatToInt24 = s.floatToInt24;
+    if (!t.int24ToFloat) t.int24ToFloat = s.int24ToFloat;
+    if (!t.interleave2) t.interleave2 = s.interleave2;
+    if (!t.deinterleave2) t.deinterleave2 = s.deinterleave2;
+    return t;
+}
+
+const KernelTable* tableFor(Isa isa) {
+    switch (isa) {
+#if defined(__x86_64__) || defined(__i386__)
+        case Isa::SSE2: {
+            static const KernelTable table = complete(sse2Kernels());
+            return &table;
+        }
+        case Isa::AVX2: {
+            static const KernelTable table = complete(avx2Kernels());
+            return &table;
+        }
+#endif
+#if defined(__aarch64__)
+        case Isa::NEON: {
+            static const KernelTable table = complete(neonKernels());
+            return &table;
+        }
+#endif
+        case Isa::SCALAR:
+            return &scalarKernels();
+        default:
+            return nullptr;
+    }
+}
+
+bool isaSupported(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR:
+            return true;
+#if defined(__x86_64__) || defined(__i386__)
+        case Isa::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case Isa::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#if defined(__aarch64__)
+        case Isa::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+struct Dispatch {
+    std::atomic<const KernelTable*> table;
+    std::atomic<Isa> isa;
+
+    Dispatch() : isa(detectIsa()) {
+        table = tableFor(isa.load());
+    }
+};
+
+Dispatch& dispatch() {
+    static Dispatch instance;
+    return instance;
+}
+
+inline const KernelTable& active() {
+    return *dispatch().table.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+const KernelTable& scalarKernels() {
+    static const KernelTable table = {
+        reference::applyGain,
+        reference::applyGainRamp,
+        reference::mixAccumulate,
+        reference::dot,
+        reference::complexMultiplyAccumulate,
+        reference::biquadCascade,
+        reference::hardClip,
+        reference::softClip,
+        reference::floatToInt16,
+        reference::int16ToFloat,
+        reference::floatToInt24,
+        reference::int24ToFloat,
+        interleave2Scalar,
+        deinterleave2Scalar,
+    };
+    return table;
+}
+
+Isa detectIsa() {
+    if (isaSupported(Isa::AVX2)) return Isa::AVX2;
+    if (isaSupported(Isa::SSE2)) return Isa::SSE2;
+    if (isaSupported(Isa::NEON)) return Isa::NEON;
+    return Isa::SCALAR;
+}
+
+Isa activeIsa() {
+    return dispatch().isa.load(std::memory_order_relaxed);
+}
+
+bool setIsa(Isa isa) {
+    if (!isaSupported(isa)) {
+        return false;
+    }
+    const KernelTable* table = tableFor(isa);
+    if (!table) {
+        return false;
+    }
+    dispatch().table.store(table, std::memory_order_relaxed);
+    dispatch().isa.store(isa, std::memory_order_relaxed);
+    return true;
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::SSE2: return "SSE2";
+        case Isa::AVX2: return "AVX2";
+        case Isa::NEON: return "NEON";
+        default: return "scalar";
+    }
+}
+
+void applyGain(float* data, size_t count, float gain) {
+    active().applyGain(data, count, gain);
+}
+
+void applyGainRamp(float* data, size_t count, float start_gain, float end_gain) {
+    active().applyGainRamp(data, count, start_gain, end_gain);
+}
+
+void mixAccumulate(float* dst, const float* src, size_t count, float gain) {
+    active().mixAccumulate(dst, src, count, gain);
+}
+
+float dot(const float* a, const float* b, size_t count) {
+    return active().dot(a, b, count);
+}
+
+void complexMultiplyAccumulate(float* acc, const float* a, const float* b, size_t count) {
+    active().complexMultiplyAccumulate(acc, a, b, count);
+}
+
+void biquadCascade(float* data, size_t frames, size_t lanes, const float* coefficients, float* state,
+                   size_t stages) {
+    active().biquadCascade(data, frames, lanes, coefficients, state, stages);
+}
+
+void hardClip(float* data, size_t count, float limit) {
+    active().hardClip(data, count, limit);
+}
+
+void softClip(float* data, size_t count) {
+    active().softClip(data, count);
+}
+
+void floatToInt16(int16_t* dst, const float* src, size_t count) {
+    active().floatToInt16(dst, src, count);
+}
+
+void int16ToFloat(float* dst, const int16_t* src, size_t count) {
+    active().int16ToFloat(dst, src, count);
+}
+
+void floatToInt24(uint8_t* dst, const float* src, size_t count) {
+    active().floatToInt24(dst, src, count);
+}
+
+void int24ToFloat(float* dst, const uint8_t* src, size_t count) {
+    active().int24ToFloat(dst, src, count);
+}
+
+void interleave(float* dst, const float* const* channels, size_t channel_count, size_t frames) {
+    if (channel_count == 2) {
+        active().interleave2(dst, channels[0], channels[1], frames);
+    } else {
+        reference::interleave(dst, channels, channel_count, frames);
+    }
+}
+
+void deinterleave(float* const* channels, const float* src, size_t channel_count, size_t frames) {
+    if (channel_count == 2) {
+        active().deinterleave2(channels[0], channels[1], src, frames);
+    } else {
+        reference::deinterleave(channels, src, channel_count, frames);
+    }
+}
+
+} // namespace dsp
+} // namespace media_pipeline
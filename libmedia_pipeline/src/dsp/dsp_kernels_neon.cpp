@@ -0,0 +1,237 @@
+#include "kernel_table.h"
+
+// AArch64 only: 32-bit ARM NEON always flushes denormals and lacks a
+// round-to-nearest-even conversion, so it could not match the reference.
+#if defined(__aarch64__)
+
+#include <arm_neon.h>
+
+namespace media_pipeline {
+namespace dsp {
+
+namespace {
+
+void applyGainNeon(float* data, size_t count, float gain) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), gain));
+    }
+    for (; i < count; ++i) {
+        data[i] = data[i] * gain;
+    }
+}
+
+void applyGainRampNeon(float* data, size_t count, float start_gain, float end_gain) {
+    if (count == 0) {
+        return;
+    }
+    const float step = (end_gain - start_gain) / static_cast<float>(count);
+    const float32x4_t start = vdupq_n_f32(start_gain);
+    const float32x4_t steps = vdupq_n_f32(step);
+    const int32_t lane_values[4] = {0, 1, 2, 3};
+    const int32x4_t lanes = vld1q_s32(lane_values);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t index = vcvtq_f32_s32(vaddq_s32(vdupq_n_s32(static_cast<int32_t>(i)), lanes));
+        // Separate multiply and add (no vfma) to round like the reference
+        float32x4_t g = vaddq_f32(start, vmulq_f32(steps, index));
+        vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), g));
+    }
+    for (; i < count; ++i) {
+        float g = start_gain + step * static_cast<float>(static_cast<int32_t>(i));
+        data[i] = data[i] * g;
+    }
+}
+
+void mixAccumulateNeon(float* dst, const float* src, size_t count, float gain) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t scaled = vmulq_n_f32(vld1q_f32(src + i), gain);
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), scaled));
+    }
+    for (; i < count; ++i) {
+        float scaled = src[i] * gain;
+        dst[i] = dst[i] + scaled;
+    }
+}
+
+float dotNeon(const float* a, const float* b, size_t count) {
+    float32x4_t low = vdupq_n_f32(0.0f);
+    float32x4_t high = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        low = vaddq_f32(low, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+        high = vaddq_f32(high, vmulq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4)));
+    }
+    float lanes[8];
+    vst1q_f32(lanes, low);
+    vst1q_f32(lanes + 4, high);
+    return dotTail(reduceLanes8(lanes), a, b, i, count);
+}
+
+// vld2q splits four complex values into real and imaginary registers
+void complexMultiplyAccumulateNeon(float* acc, const float* a, const float* b, size_t count) {
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        float32x4x2_t va = vld2q_f32(a + 2 * k);
+        float32x4x2_t vb = vld2q_f32(b + 2 * k);
+        float32x4x2_t sum = vld2q_f32(acc + 2 * k);
+        float32x4_t re = vsubq_f32(vmulq_f32(va.val[0], vb.val[0]), vmulq_f32(va.val[1], vb.val[1]));
+        float32x4_t im = vaddq_f32(vmulq_f32(va.val[0], vb.val[1]), vmulq_f32(va.val[1], vb.val[0]));
+        sum.val[0] = vaddq_f32(sum.val[0], re);
+        sum.val[1] = vaddq_f32(sum.val[1], im);
+        vst2q_f32(acc + 2 * k, sum);
+    }
+    complexMultiplyAccumulateTail(acc, a, b, k, count);
+}
+
+void biquadCascadeNeon(float* data, size_t frames, size_t lanes, const float* coefficients, float* state,
+                       size_t stages) {
+    for (size_t lane = 0; lane + 4 <= lanes; lane += 4) {
+        for (size_t s = 0; s < stages; ++s) {
+            const float* c = coefficients + 5 * s * lanes + lane;
+            const float32x4_t b0 = vld1q_f32(c), b1 = vld1q_f32(c + lanes), b2 = vld1q_f32(c + 2 * lanes);
+            const float32x4_t a1 = vld1q_f32(c + 3 * lanes), a2 = vld1q_f32(c + 4 * lanes);
+            float* z = state + 2 * s * lanes + lane;
+            float32x4_t z1 = vld1q_f32(z), z2 = vld1q_f32(z + lanes);
+            for (size_t n = 0; n < frames; ++n) {
+                float* p = data + n * lanes + lane;
+                float32x4_t x = vld1q_f32(p);
+                float32x4_t y = vaddq_f32(vmulq_f32(b0, x), z1);
+                z1 = vaddq_f32(vsubq_f32(vmulq_f32(b1, x), vmulq_f32(a1, y)), z2);
+                z2 = vsubq_f32(vmulq_f32(b2, x), vmulq_f32(a2, y));
+                vst1q_f32(p, y);
+            }
+            vst1q_f32(z, z1);
+            vst1q_f32(z + lanes, z2);
+        }
+    }
+}
+
+// Compare-and-select rather than vmaxq/vminq so NaN handling matches maxps/minps
+inline float32x4_t clampNeon(float32x4_t x, float32x4_t lo, float32x4_t hi) {
+    x = vbslq_f32(vcgtq_f32(lo, x), lo, x);
+    return vbslq_f32(vcgtq_f32(x, hi), hi, x);
+}
+
+void hardClipNeon(float* data, size_t count, float limit) {
+    const float32x4_t lo = vdupq_n_f32(-limit);
+    const float32x4_t hi = vdupq_n_f32(limit);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(data + i, clampNeon(vld1q_f32(data + i), lo, hi));
+    }
+    for (; i < count; ++i) {
+        data[i] = clampScalar(data[i], -limit, limit);
+    }
+}
+
+void softClipNeon(float* data, size_t count) {
+    const float32x4_t lo = vdupq_n_f32(-1.0f);
+    const float32x4_t hi = vdupq_n_f32(1.0f);
+    const float32x4_t three_halves = vdupq_n_f32(1.5f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t c = clampNeon(vld1q_f32(data + i), lo, hi);
+        float32x4_t t = vmulq_n_f32(vmulq_f32(c, c), 0.5f);
+        vst1q_f32(data + i, vmulq_f32(c, vsubq_f32(three_halves, t)));
+    }
+    for (; i < count; ++i) {
+        float c = clampScalar(data[i], -1.0f, 1.0f);
+        float t = c * c;
+        t = t * 0.5f;
+        t = 1.5f - t;
+        data[i] = c * t;
+    }
+}
+
+inline int32x4_t quantizeNeon(float32x4_t x, float scale, float32x4_t lo, float32x4_t hi) {
+    float32x4_t v = vmulq_n_f32(x, scale);
+    v = vbslq_f32(vcgtq_f32(v, lo), v, lo);  // NaN -> lo
+    v = vbslq_f32(vcltq_f32(v, hi), v, hi);
+    return vcvtnq_s32_f32(v);  // Nearest, ties to even
+}
+
+void floatToInt16Neon(int16_t* dst, const float* src, size_t count) {
+    const float32x4_t lo = vdupq_n_f32(-32768.0f);
+    const float32x4_t hi = vdupq_n_f32(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int32x4_t a = quantizeNeon(vld1q_f32(src + i), kInt16Scale, lo, hi);
+        int32x4_t b = quantizeNeon(vld1q_f32(src + i + 4), kInt16Scale, lo, hi);
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<int16_t>(quantizeScalar(src[i], kInt16Scale, -32768.0f, 32767.0f));
+    }
+}
+
+void int16ToFloatNeon(float* dst, const int16_t* src, size_t count) {
+    const float scale = 1.0f / kInt16Scale;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t x = vld1q_s16(src + i);
+        float32x4_t a = vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)));
+        float32x4_t b = vcvtq_f32_s32(vmovl_s16(vget_high_s16(x)));
+        vst1q_f32(dst + i, vmulq_n_f32(a, scale));
+        vst1q_f32(dst + i + 4, vmulq_n_f32(b, scale));
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<float>(src[i]) * (1.0f / kInt16Scale);
+    }
+}
+
+void interleave2Neon(float* dst, const float* left, const float* right, size_t frames) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t pair;
+        pair.val[0] = vld1q_f32(left + i);
+        pair.val[1] = vld1q_f32(right + i);
+        vst2q_f32(dst + 2 * i, pair);
+    }
+    for (; i < frames; ++i) {
+        dst[2 * i] = left[i];
+        dst[2 * i + 1] = right[i];
+    }
+}
+
+void deinterleave2Neon(float* left, float* right, const float* src, size_t frames) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t pair = vld2q_f32(src + 2 * i);
+        vst1q_f32(left + i, pair.val[0]);
+        vst1q_f32(right + i, pair.val[1]);
+    }
+    for (; i < frames; ++i) {
+        left[i] = src[2 * i];
+        right[i] = src[2 * i + 1];
+    }
+}
+
+} // namespace
+
+const KernelTable& neonKernels() {
+    // 24-bit packing stays scalar: byte shuffling, nothing to vectorize
+    static const KernelTable table = {
+        applyGainNeon,
+        applyGainRampNeon,
+        mixAccumulateNeon,
+        dotNeon,
+        complexMultiplyAccumulateNeon,
+        biquadCascadeNeon,
+        hardClipNeon,
+        softClipNeon,
+        floatToInt16Neon,
+        int16ToFloatNeon,
+        nullptr,
+        nullptr,
+        interleave2Neon,
+        deinterleave2Neon,
+    };
+    return table;
+}
+
+} // namespace dsp
+} // namespace media_pipeline
+
+#endif // __aarch64__
@@ -0,0 +1,502 @@
+#include "kernel_table.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+// Per-function target attributes: the library is built for the baseline ISA
+// and AVX2 is only entered after the runtime CPU check in dsp_kernels.cpp.
+#define SSE2_FN __attribute__((target("sse2")))
+#define AVX2_FN __attribute__((target("avx2")))
+
+namespace media_pipeline {
+namespace dsp {
+
+namespace {
+
+// ---------------------------------------------------------------- SSE2
+
+SSE2_FN void applyGainSse2(float* data, size_t count, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+    }
+    for (; i < count; ++i) {
+        data[i] = data[i] * gain;
+    }
+}
+
+SSE2_FN void applyGainRampSse2(float* data, size_t count, float start_gain, float end_gain) {
+    if (count == 0) {
+        return;
+    }
+    const float step = (end_gain - start_gain) / static_cast<float>(count);
+    const __m128 start = _mm_set1_ps(start_gain);
+    const __m128 steps = _mm_set1_ps(step);
+    const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 index = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(static_cast<int32_t>(i)), lanes));
+        __m128 g = _mm_add_ps(start, _mm_mul_ps(steps, index));
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+    }
+    for (; i < count; ++i) {
+        float g = start_gain + step * static_cast<float>(static_cast<int32_t>(i));
+        data[i] = data[i] * g;
+    }
+}
+
+SSE2_FN void mixAccumulateSse2(float* dst, const float* src, size_t count, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 scaled = _mm_mul_ps(_mm_loadu_ps(src + i), g);
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), scaled));
+    }
+    for (; i < count; ++i) {
+        float scaled = src[i] * gain;
+        dst[i] = dst[i] + scaled;
+    }
+}
+
+// Two registers hold partial sums 0-3 and 4-7, as in the reference
+SSE2_FN float dotSse2(const float* a, const float* b, size_t count) {
+    __m128 low = _mm_setzero_ps();
+    __m128 high = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        low = _mm_add_ps(low, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        high = _mm_add_ps(high, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    alignas(16) float lanes[8];
+    _mm_store_ps(lanes, low);
+    _mm_store_ps(lanes + 4, high);
+    return dotTail(reduceLanes8(lanes), a, b, i, count);
+}
+
+// Two complex values per register: (ar ar | ai ai) times (b | b swapped),
+// then the even lanes of the second product negated, so the add gives
+// rr - ii and ri + ir exactly as the reference rounds them
+SSE2_FN void complexMultiplyAccumulateSse2(float* acc, const float* a, const float* b, size_t count) {
+    const __m128 negate_even = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    size_t k = 0;
+    for (; k + 2 <= count; k += 2) {
+        __m128 va = _mm_loadu_ps(a + 2 * k);
+        __m128 vb = _mm_loadu_ps(b + 2 * k);
+        __m128 re = _mm_shuffle_ps(va, va, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 im = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 swapped = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 t1 = _mm_mul_ps(re, vb);
+        __m128 t2 = _mm_xor_ps(_mm_mul_ps(im, swapped), negate_even);
+        _mm_storeu_ps(acc + 2 * k, _mm_add_ps(_mm_loadu_ps(acc + 2 * k), _mm_add_ps(t1, t2)));
+    }
+    complexMultiplyAccumulateTail(acc, a, b, k, count);
+}
+
+// Four lanes per register, one stage at a time over the whole block with
+// its coefficients and state held in registers
+SSE2_FN void biquadGroupSse2(float* data, size_t frames, size_t lanes, size_t lane, const float* coefficients,
+                             float* state, size_t stages) {
+    for (size_t s = 0; s < stages; ++s) {
+        const float* c = coefficients + 5 * s * lanes + lane;
+        const __m128 b0 = _mm_loadu_ps(c), b1 = _mm_loadu_ps(c + lanes), b2 = _mm_loadu_ps(c + 2 * lanes);
+        const __m128 a1 = _mm_loadu_ps(c + 3 * lanes), a2 = _mm_loadu_ps(c + 4 * lanes);
+        float* z = state + 2 * s * lanes + lane;
+        __m128 z1 = _mm_loadu_ps(z), z2 = _mm_loadu_ps(z + lanes);
+        for (size_t n = 0; n < frames; ++n) {
+            float* p = data + n * lanes + lane;
+            __m128 x = _mm_loadu_ps(p);
+            __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+            z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+            z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+            _mm_storeu_ps(p, y);
+        }
+        _mm_storeu_ps(z, z1);
+        _mm_storeu_ps(z + lanes, z2);
+    }
+}
+
+SSE2_FN void biquadCascadeSse2(float* data, size_t frames, size_t lanes, const float* coefficients, float* state,
+                               size_t stages) {
+    for (size_t lane = 0; lane + 4 <= lanes; lane += 4) {
+        biquadGroupSse2(data, frames, lanes, lane, coefficients, state, stages);
+    }
+}
+
+SSE2_FN void hardClipSse2(float* data, size_t count, float limit) {
+    const __m128 lo = _mm_set1_ps(-limit);
+    const __m128 hi = _mm_set1_ps(limit);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_max_ps(lo, _mm_loadu_ps(data + i));
+        _mm_storeu_ps(data + i, _mm_min_ps(hi, x));
+    }
+    for (; i < count; ++i) {
+        data[i] = clampScalar(data[i], -limit, limit);
+    }
+}
+
+SSE2_FN void softClipSse2(float* data, size_t count) {
+    const __m128 lo = _mm_set1_ps(-1.0f);
+    const __m128 hi = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 three_halves = _mm_set1_ps(1.5f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 c = _mm_min_ps(hi, _mm_max_ps(lo, _mm_loadu_ps(data + i)));
+        __m128 t = _mm_mul_ps(_mm_mul_ps(c, c), half);
+        _mm_storeu_ps(data + i, _mm_mul_ps(c, _mm_sub_ps(three_halves, t)));
+    }
+    for (; i < count; ++i) {
+        float c = clampScalar(data[i], -1.0f, 1.0f);
+        float t = c * c;
+        t = t * 0.5f;
+        t = 1.5f - t;
+        data[i] = c * t;
+    }
+}
+
+SSE2_FN inline __m128i quantizeSse2(__m128 x, __m128 scale, __m128 lo, __m128 hi) {
+    __m128 v = _mm_mul_ps(x, scale);
+    v = _mm_max_ps(v, lo);  // NaN -> lo
+    v = _mm_min_ps(v, hi);
+    return _mm_cvtps_epi32(v);  // MXCSR rounding: nearest, ties to even
+}
+
+SSE2_FN void floatToInt16Sse2(int16_t* dst, const float* src, size_t count) {
+    const __m128 scale = _mm_set1_ps(kInt16Scale);
+    const __m128 lo = _mm_set1_ps(-32768.0f);
+    const __m128 hi = _mm_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = quantizeSse2(_mm_loadu_ps(src + i), scale, lo, hi);
+        __m128i b = quantizeSse2(_mm_loadu_ps(src + i + 4), scale, lo, hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(a, b));
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<int16_t>(quantizeScalar(src[i], kInt16Scale, -32768.0f, 32767.0f));
+    }
+}
+
+SSE2_FN void int16ToFloatSse2(float* dst, const int16_t* src, size_t count) {
+    const __m128 scale = _mm_set1_ps(1.0f / kInt16Scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i a = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);  // Sign-extend
+        __m128i b = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(a), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(b), scale));
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<float>(src[i]) * (1.0f / kInt16Scale);
+    }
+}
+
+SSE2_FN void floatToInt24Sse2(uint8_t* dst, const float* src, size_t count) {
+    const __m128 scale = _mm_set1_ps(kInt24Scale);
+    const __m128 lo = _mm_set1_ps(-8388608.0f);
+    const __m128 hi = _mm_set1_ps(8388607.0f);
+    alignas(16) int32_t values[4];
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(values), quantizeSse2(_mm_loadu_ps(src + i), scale, lo, hi));
+        for (int k = 0; k < 4; ++k) {
+            storeInt24(dst + (i + k) * 3, values[k]);
+        }
+    }
+    for (; i < count; ++i) {
+        storeInt24(dst + i * 3, quantizeScalar(src[i], kInt24Scale, -8388608.0f, 8388607.0f));
+    }
+}
+
+SSE2_FN void int24ToFloatSse2(float* dst, const uint8_t* src, size_t count) {
+    const __m128 scale = _mm_set1_ps(1.0f / kInt24Scale);
+    alignas(16) int32_t values[4];
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            values[k] = loadInt24(src + (i + k) * 3);
+        }
+        __m128 x = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(values)));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(x, scale));
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<float>(loadInt24(src + i * 3)) * (1.0f / kInt24Scale);
+    }
+}
+
+SSE2_FN void interleave2Sse2(float* dst, const float* left, const float* right, size_t frames) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+    for (; i < frames; ++i) {
+        dst[2 * i] = left[i];
+        dst[2 * i + 1] = right[i];
+    }
+}
+
+SSE2_FN void deinterleave2Sse2(float* left, float* right, const float* src, size_t frames) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(src + 2 * i);
+        __m128 b = _mm_loadu_ps(src + 2 * i + 4);
+        _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    for (; i < frames; ++i) {
+        left[i] = src[2 * i];
+        right[i] = src[2 * i + 1];
+    }
+}
+
+// ---------------------------------------------------------------- AVX2
+
+AVX2_FN void applyGainAvx2(float* data, size_t count, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), g));
+    }
+    for (; i < count; ++i) {
+        data[i] = data[i] * gain;
+    }
+}
+
+AVX2_FN void applyGainRampAvx2(float* data, size_t count, float start_gain, float end_gain) {
+    if (count == 0) {
+        return;
+    }
+    const float step = (end_gain - start_gain) / static_cast<float>(count);
+    const __m256 start = _mm256_set1_ps(start_gain);
+    const __m256 steps = _mm256_set1_ps(step);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 index = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(static_cast<int32_t>(i)), lanes));
+        __m256 g = _mm256_add_ps(start, _mm256_mul_ps(steps, index));
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), g));
+    }
+    for (; i < count; ++i) {
+        float g = start_gain + step * static_cast<float>(static_cast<int32_t>(i));
+        data[i] = data[i] * g;
+    }
+}
+
+AVX2_FN void mixAccumulateAvx2(float* dst, const float* src, size_t count, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 scaled = _mm256_mul_ps(_mm256_loadu_ps(src + i), g);
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), scaled));
+    }
+    for (; i < count; ++i) {
+        float scaled = src[i] * gain;
+        dst[i] = dst[i] + scaled;
+    }
+}
+
+AVX2_FN float dotAvx2(const float* a, const float* b, size_t count) {
+    __m256 sum = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, sum);
+    return dotTail(reduceLanes8(lanes), a, b, i, count);
+}
+
+AVX2_FN void complexMultiplyAccumulateAvx2(float* acc, const float* a, const float* b, size_t count) {
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        __m256 va = _mm256_loadu_ps(a + 2 * k);
+        __m256 vb = _mm256_loadu_ps(b + 2 * k);
+        __m256 t1 = _mm256_mul_ps(_mm256_moveldup_ps(va), vb);
+        __m256 t2 = _mm256_mul_ps(_mm256_movehdup_ps(va), _mm256_permute_ps(vb, 0xB1));
+        _mm256_storeu_ps(acc + 2 * k, _mm256_add_ps(_mm256_loadu_ps(acc + 2 * k), _mm256_addsub_ps(t1, t2)));
+    }
+    complexMultiplyAccumulateTail(acc, a, b, k, count);
+}
+
+AVX2_FN void biquadCascadeAvx2(float* data, size_t frames, size_t lanes, const float* coefficients, float* state,
+                               size_t stages) {
+    size_t lane = 0;
+    for (; lane + 8 <= lanes; lane += 8) {
+        for (size_t s = 0; s < stages; ++s) {
+            const float* c = coefficients + 5 * s * lanes + lane;
+            const __m256 b0 = _mm256_loadu_ps(c), b1 = _mm256_loadu_ps(c + lanes);
+            const __m256 b2 = _mm256_loadu_ps(c + 2 * lanes), a1 = _mm256_loadu_ps(c + 3 * lanes);
+            const __m256 a2 = _mm256_loadu_ps(c + 4 * lanes);
+            float* z = state + 2 * s * lanes + lane;
+            __m256 z1 = _mm256_loadu_ps(z), z2 = _mm256_loadu_ps(z + lanes);
+            for (size_t n = 0; n < frames; ++n) {
+                float* p = data + n * lanes + lane;
+                __m256 x = _mm256_loadu_ps(p);
+                __m256 y = _mm256_add_ps(_mm256_mul_ps(b0, x), z1);
+                z1 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(b1, x), _mm256_mul_ps(a1, y)), z2);
+                z2 = _mm256_sub_ps(_mm256_mul_ps(b2, x), _mm256_mul_ps(a2, y));
+                _mm256_storeu_ps(p, y);
+            }
+            _mm256_storeu_ps(z, z1);
+            _mm256_storeu_ps(z + lanes, z2);
+        }
+    }
+    if (lane < lanes) {
+        biquadGroupSse2(data, frames, lanes, lane, coefficients, state, stages);
+    }
+}
+
+AVX2_FN void hardClipAvx2(float* data, size_t count, float limit) {
+    const __m256 lo = _mm256_set1_ps(-limit);
+    const __m256 hi = _mm256_set1_ps(limit);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_max_ps(lo, _mm256_loadu_ps(data + i));
+        _mm256_storeu_ps(data + i, _mm256_min_ps(hi, x));
+    }
+    for (; i < count; ++i) {
+        data[i] = clampScalar(data[i], -limit, limit);
+    }
+}
+
+AVX2_FN void softClipAvx2(float* data, size_t count) {
+    const __m256 lo = _mm256_set1_ps(-1.0f);
+    const __m256 hi = _mm256_set1_ps(1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 three_halves = _mm256_set1_ps(1.5f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 c = _mm256_min_ps(hi, _mm256_max_ps(lo, _mm256_loadu_ps(data + i)));
+        __m256 t = _mm256_mul_ps(_mm256_mul_ps(c, c), half);
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(c, _mm256_sub_ps(three_halves, t)));
+    }
+    for (; i < count; ++i) {
+        float c = clampScalar(data[i], -1.0f, 1.0f);
+        float t = c * c;
+        t = t * 0.5f;
+        t = 1.5f - t;
+        data[i] = c * t;
+    }
+}
+
+AVX2_FN inline __m256i quantizeAvx2(__m256 x, __m256 scale, __m256 lo, __m256 hi) {
+    __m256 v = _mm256_mul_ps(x, scale);
+    v = _mm256_max_ps(v, lo);  // NaN -> lo
+    v = _mm256_min_ps(v, hi);
+    return _mm256_cvtps_epi32(v);
+}
+
+AVX2_FN void floatToInt16Avx2(int16_t* dst, const float* src, size_t count) {
+    const __m256 scale = _mm256_set1_ps(kInt16Scale);
+    const __m256 lo = _mm256_set1_ps(-32768.0f);
+    const __m256 hi = _mm256_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = quantizeAvx2(_mm256_loadu_ps(src + i), scale, lo, hi);
+        __m256i b = quantizeAvx2(_mm256_loadu_ps(src + i + 8), scale, lo, hi);
+        // packs works per 128-bit lane; restore sample order across lanes
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<int16_t>(quantizeScalar(src[i], kInt16Scale, -32768.0f, 32767.0f));
+    }
+}
+
+AVX2_FN void int16ToFloatAvx2(float* dst, const int16_t* src, size_t count) {
+    const __m256 scale = _mm256_set1_ps(1.0f / kInt16Scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(x), scale));
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<float>(src[i]) * (1.0f / kInt16Scale);
+    }
+}
+
+AVX2_FN void interleave2Avx2(float* dst, const float* left, const float* right, size_t frames) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        __m256 l = _mm256_loadu_ps(left + i);
+        __m256 r = _mm256_loadu_ps(right + i);
+        __m256 lo = _mm256_unpacklo_ps(l, r);  // l0 r0 l1 r1 | l4 r4 l5 r5
+        __m256 hi = _mm256_unpackhi_ps(l, r);  // l2 r2 l3 r3 | l6 r6 l7 r7
+        _mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(dst + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    for (; i < frames; ++i) {
+        dst[2 * i] = left[i];
+        dst[2 * i + 1] = right[i];
+    }
+}
+
+AVX2_FN void deinterleave2Avx2(float* left, float* right, const float* src, size_t frames) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        __m256 a = _mm256_loadu_ps(src + 2 * i);
+        __m256 b = _mm256_loadu_ps(src + 2 * i + 8);
+        __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);  // l0 r0 l1 r1 | l4 r4 l5 r5
+        __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);  // l2 r2 l3 r3 | l6 r6 l7 r7
+        _mm256_storeu_ps(left + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm256_storeu_ps(right + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    for (; i < frames; ++i) {
+        left[i] = src[2 * i];
+        right[i] = src[2 * i + 1];
+    }
+}
+
+} // namespace
+
+const KernelTable& sse2Kernels() {
+    static const KernelTable table = {
+        applyGainSse2,
+        applyGainRampSse2,
+        mixAccumulateSse2,
+        dotSse2,
+        complexMultiplyAccumulateSse2,
+        biquadCascadeSse2,
+        hardClipSse2,
+        softClipSse2,
+        floatToInt16Sse2,
+        int16ToFloatSse2,
+        floatToInt24Sse2,
+        int24ToFloatSse2,
+        interleave2Sse2,
+        deinterleave2Sse2,
+    };
+    return table;
+}
+
+const KernelTable& avx2Kernels() {
+    // 24-bit packing is byte-shuffling bound; the SSE2 versions are as fast
+    static const KernelTable table = {
+        applyGainAvx2,
+        applyGainRampAvx2,
+        mixAccumulateAvx2,
+        dotAvx2,
+        complexMultiplyAccumulateAvx2,
+        biquadCascadeAvx2,
+        hardClipAvx2,
+        softClipAvx2,
+        floatToInt16Avx2,
+        int16ToFloatAvx2,
+        floatToInt24Sse2,
+        int24ToFloatSse2,
+        interleave2Avx2,
+        deinterleave2Avx2,
+    };
+    return table;
+}
+
+} // namespace dsp
+} // namespace media_pipeline
+
+#endif // x86
@@ -0,0 +1,196 @@
+#include "media_pipeline/fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace media_pipeline {
+
+namespace {
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t power = 4;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+size_t validHop(size_t fft_size, size_t hop) {
+    fft_size = roundUpPowerOfTwo(fft_size);
+    return (hop == 0 || hop > fft_size / 2 || fft_size % hop != 0) ? fft_size / 2 : hop;
+}
+
+} // namespace
+
+RealFft::RealFft(size_t size)
+    : size_(roundUpPowerOfTwo(size)) {
+    const size_t half = size_ / 2;
+    twiddles_.resize(half / 2);
+    for (size_t i = 0; i < twiddles_.size(); ++i) {
+        double angle = -2.0 * M_PI * static_cast<double>(i) / static_cast<double>(half);
+        twiddles_[i] = std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+    split_.resize(half);
+    for (size_t k = 0; k < half; ++k) {
+        double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(size_);
+        split_[k] = std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+
+    bit_reverse_.resize(half);
+    size_t bits = 0;
+    while ((size_t(1) << bits) < half) {
+        bits++;
+    }
+    for (size_t i = 0; i < half; ++i) {
+        uint32_t reversed = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            reversed |= static_cast<uint32_t>(((i >> b) & 1) << (bits - 1 - b));
+        }
+        bit_reverse_[i] = reversed;
+    }
+    work_.resize(half);
+}
+
+void RealFft::transform(std::complex<float>* data, bool inverse) const {
+    const size_t n = size_ / 2;
+    for (size_t i = 0; i < n; ++i) {
+        size_t j = bit_reverse_[i];
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    // Iterative radix-2; stride into the one twiddle table for every stage
+    for (size_t length = 2; length <= n; length <<= 1) {
+        size_t half_length = length / 2;
+        size_t stride = n / length;
+        for (size_t start = 0; start < n; start += length) {
+            for (size_t k = 0; k < half_length; ++k) {
+                std::complex<float> w = twiddles_[k * stride];
+                if (inverse) {
+                    w = std::conj(w);
+                }
+                std::complex<float> odd = data[start + k + half_length] * w;
+                data[start + k + half_length] = data[start + k] - odd;
+                data[start + k] += odd;
+            }
+        }
+    }
+}
+
+void RealFft::forward(const float* input, std::complex<float>* output) {
+    const size_t half = size_ / 2;
+
+    // Even samples as the real part, odd as the imaginary part
+    for (size_t m = 0; m < half; ++m) {
+        work_[m] = std::complex<float>(input[2 * m], input[2 * m + 1]);
+    }
+    transform(work_.data(), false);
+
+    // Separate the two interleaved real transforms and combine them
+    output[0] = std::complex<float>(work_[0].real() + work_[0].imag(), 0.0f);
+    output[half] = std::complex<float>(work_[0].real() - work_[0].imag(), 0.0f);
+    for (size_t k = 1; k < half; ++k) {
+        std::complex<float> a = work_[k];
+        std::complex<float> b = std::conj(work_[half - k]);
+        std::complex<float> even = 0.5f * (a + b);
+        std::complex<float> odd = std::complex<float>(0.0f, -0.5f) * (a - b);
+        output[k] = even + split_[k] * odd;
+    }
+}
+
+void RealFft::inverse(const std::complex<float>* input, float* output) {
+    const size_t half = size_ / 2;
+
+    // Rebuild the half-size spectrum of (even + i * odd)
+    for (size_t k = 0; k < half; ++k) {
+        std::complex<float> a = input[k];
+        std::complex<float> b = std::conj(input[half - k]);
+        if (k == 0) {
+            a = std::complex<float>(input[0].real(), 0.0f);
+            b = std::complex<float>(input[half].real(), 0.0f);
+            // DC and Nyquist pair up: even = (X0 + Xn/2) / 2, odd = (X0 - Xn/2) / 2
+            work_[0] = std::complex<float>(0.5f * (a.real() + b.real()), 0.5f * (a.real() - b.real()));
+            continue;
+        }
+        std::complex<float> even = 0.5f * (a + b);
+        std::complex<float> odd = 0.5f * (a - b) * std::conj(split_[k]);
+        work_[k] = even + std::complex<float>(0.0f, 1.0f) * odd;
+    }
+    transform(work_.data(), true);
+
+    const float scale = 1.0f / static_cast<float>(half);
+    for (size_t m = 0; m < half; ++m) {
+        output[2 * m] = work_[m].real() * scale;
+        output[2 * m + 1] = work_[m].imag() * scale;
+    }
+}
+
+Stft::Stft(size_t fft_size, size_t hop)
+    : fft_(fft_size)
+    , hop_(validHop(fft_size, hop))
+    , fill_(0) {
+    fft_size = fft_.getSize();
+
+    // Periodic Hann sums to fft_size / (2 * hop) across overlapping frames;
+    // the synthesis side carries the normalization
+    window_.resize(fft_size);
+    for (size_t i = 0; i < fft_size; ++i) {
+        window_[i] = static_cast<float>(std::sqrt(0.5 - 0.5 * std::cos(2.0 * M_PI * i / fft_size)));
+    }
+    input_.assign(fft_size, 0.0f);
+    frame_.assign(fft_size, 0.0f);
+    accumulator_.assign(fft_size, 0.0f);
+    output_.assign(hop_, 0.0f);
+    bins_.resize(fft_.getBinCount());
+}
+
+void Stft::reset() {
+    std::fill(input_.begin(), input_.end(), 0.0f);
+    std::fill(accumulator_.begin(), accumulator_.end(), 0.0f);
+    std::fill(output_.begin(), output_.end(), 0.0f);
+    fill_ = 0;
+}
+
+void Stft::process(const float* input, float* output, size_t count, const Processor& processor) {
+    const size_t tail = input_.size() - hop_;
+    size_t done = 0;
+    while (done < count) {
+        size_t n = std::min(count - done, hop_ - fill_);
+        // Input first: output may alias it
+        std::memcpy(input_.data() + tail + fill_, input + done, n * sizeof(float));
+        std::memcpy(output + done, output_.data() + fill_, n * sizeof(float));
+        fill_ += n;
+        done += n;
+        if (fill_ == hop_) {
+            processFrame(processor);
+            fill_ = 0;
+        }
+    }
+}
+
+void Stft::processFrame(const Processor& processor) {
+    const size_t size = input_.size();
+    for (size_t i = 0; i < size; ++i) {
+        frame_[i] = input_[i] * window_[i];
+    }
+    fft_.forward(frame_.data(), bins_.data());
+    if (processor) {
+        processor(bins_.data(), bins_.size());
+    }
+    fft_.inverse(bins_.data(), frame_.data());
+
+    const float scale = 2.0f * static_cast<float>(hop_) / static_cast<float>(size);
+    for (size_t i = 0; i < size; ++i) {
+        accumulator_[i] += frame_[i] * window_[i] * scale;
+    }
+
+    // The first hop has now seen every frame that overlaps it
+    std::memcpy(output_.data(), accumulator_.data(), hop_ * sizeof(float));
+    std::memmove(accumulator_.data(), accumulator_.data() + hop_, (size - hop_) * sizeof(float));
+    std::fill(accumulator_.end() - hop_, accumulator_.end(), 0.0f);
+    std::memmove(input_.data(), input_.data() + hop_, (size - hop_) * sizeof(float));
+}
+
+} // namespace media_pipeline
@@ -0,0 +1,218 @@
+#include "media_pipeline/glitch_detector.h"
+#include "media_pipeline/trace.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace media_pipeline {
+
+namespace {
+
+// Steps are checked once the level estimate has this many samples behind it
+constexpr size_t kWarmup = 32;
+constexpr float kLevelRate = 1.0f / 64.0f;
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t power = 16;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+} // namespace
+
+const char* GlitchDetector::typeName(Type type) {
+    switch (type) {
+        case Type::UNDERRUN: return "underrun";
+        case Type::DROPOUT: return "dropout";
+        case Type::DISCONTINUITY: return "discontinuity";
+        case Type::CLIPPING: return "clipping";
+    }
+    return "unknown";
+}
+
+GlitchDetector::GlitchDetector(int sample_rate)
+    : GlitchDetector(sample_rate, Config()) {
+}
+
+GlitchDetector::GlitchDetector(int sample_rate, const Config& config)
+    : config_(config)
+    , min_dropout_(std::max<size_t>(2, static_cast<size_t>(config.dropout_min_ms * sample_rate / 1000.0f)))
+    , max_underrun_(static_cast<uint64_t>(config.stream_gap_ms * sample_rate / 1000.0f))
+    , position_(0)
+    , unlogged_(0)
+    , log_(new Event[roundUpPowerOfTwo(config.event_capacity)])
+    , log_mask_(roundUpPowerOfTwo(config.event_capacity) - 1)
+    , log_head_(0)
+    , log_tail_(0) {
+    for (auto& count : counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    reset();
+}
+
+void GlitchDetector::reset() {
+    previous_[0] = 0.0f;
+    previous_[1] = 0.0f;
+    history_ = 0;
+    step_level_ = 0.0f;
+    suppress_ = 0;
+    clip_run_ = 0;
+    clip_peak_ = 0.0f;
+    zero_run_ = 0;
+    zero_edge_ = 0.0f;
+    playing_ = false;
+    underrun_open_ = false;
+}
+
+void GlitchDetector::analyze(const float* samples, size_t count, const Context& context) {
+    if (!samples || count == 0) {
+        return;
+    }
+    if (underrun_open_) {
+        closeUnderrun(context);
+    }
+    playing_ = true;
+
+    for (size_t i = 0; i < count; ++i) {
+        const float x = samples[i];
+        const float magnitude = std::fabs(x);
+        const uint64_t position = position_ + i;
+
+        // Clipping bursts
+        if (magnitude >= config_.clip_level) {
+            if (clip_run_ == 0) {
+                clip_event_ = {Type::CLIPPING, position, 0, 0.0f, context.packet_sequence, context.packet_sequence,
+                               context.queue_depth, context.timestamp_ns};
+                clip_peak_ = 0.0f;
+            }
+            clip_run_++;
+            clip_peak_ = std::max(clip_peak_, magnitude);
+            clip_event_.last_packet = context.packet_sequence;
+        } else if (clip_run_ > 0) {
+            if (clip_run_ >= config_.min_clip_run) {
+                clip_event_.length = clip_run_;
+                clip_event_.magnitude = clip_peak_;
+                emit(clip_event_);
+            }
+            clip_run_ = 0;
+        }
+
+        // Dropouts: exact zeros cutting into a signal, reported when it resumes
+        if (x == 0.0f) {
+            if (zero_run_ == 0) {
+                zero_edge_ = history_ > 0 ? std::fabs(previous_[0]) : 0.0f;
+                zero_event_ = {Type::DROPOUT, position, 0, 0.0f, context.packet_sequence, context.packet_sequence,
+                               context.queue_depth, context.timestamp_ns};
+            }
+            zero_run_++;
+        } else if (zero_run_ > 0) {
+            if (zero_run_ >= min_dropout_ && zero_edge_ >= config_.dropout_edge_level) {
+                zero_event_.length = zero_run_;
+                zero_event_.magnitude = zero_edge_;
+                zero_event_.last_packet = context.packet_sequence;
+                emit(zero_event_);
+            }
+            zero_run_ = 0;
+        }
+
+        // Discontinuities. The second difference spans three samples; edges
+        // into and out of silence belong to the dropout check and clipped
+        // corners to the clipping check.
+        const bool silent = x == 0.0f && previous_[0] == 0.0f;
+        if (!silent && history_ >= 2 && x != 0.0f) {
+            const float step = std::fabs(x - 2.0f * previous_[0] + previous_[1]);
+            const bool clipped = magnitude >= config_.clip_level || std::fabs(previous_[0]) >= config_.clip_level ||
+                                 std::fabs(previous_[1]) >= config_.clip_level;
+            if (suppress_ > 0) {
+                suppress_--;  // Second half of the step just reported
+            } else if (history_ >= kWarmup && !clipped &&
+                       step > config_.spike_ratio * step_level_ + config_.spike_floor) {
+                emit({Type::DISCONTINUITY, position, 1, step, context.packet_sequence, context.packet_sequence,
+                      context.queue_depth, context.timestamp_ns});
+                suppress_ = 1;
+            } else if (history_ < kWarmup) {
+                step_level_ += (step - step_level_) / static_cast<float>(history_ - 1);
+            } else {
+                step_level_ += (step - step_level_) * kLevelRate;
+            }
+        }
+
+        previous_[1] = previous_[0];
+        previous_[0] = x;
+        history_ = silent ? 0 : history_ + 1;  // After silence, warm up again
+    }
+    position_ += count;
+}
+
+void GlitchDetector::insertedSilence(size_t count, const Context& context) {
+    if (count == 0) {
+        return;
+    }
+
+    // A clip burst ends where the signal does; zeros before the gap join the underrun
+    if (clip_run_ >= config_.min_clip_run) {
+        clip_event_.length = clip_run_;
+        clip_event_.magnitude = clip_peak_;
+        emit(clip_event_);
+    }
+    clip_run_ = 0;
+    zero_run_ = 0;
+
+    if (!underrun_open_ && playing_) {
+        underrun_open_ = true;
+        underrun_event_ = {Type::UNDERRUN, position_, 0, std::fabs(previous_[0]), context.packet_sequence,
+                           context.packet_sequence, context.queue_depth, context.timestamp_ns};
+    }
+    if (underrun_open_) {
+        underrun_event_.length += count;
+    }
+
+    previous_[0] = 0.0f;
+    previous_[1] = 0.0f;
+    history_ = 0;
+    suppress_ = 0;
+    position_ += count;
+}
+
+void GlitchDetector::closeUnderrun(const Context& context) {
+    underrun_open_ = false;
+    if (underrun_event_.length <= max_underrun_) {
+        underrun_event_.last_packet = context.packet_sequence;
+        emit(underrun_event_);
+    }
+}
+
+uint64_t GlitchDetector::getTotalCount() const {
+    uint64_t total = 0;
+    for (const auto& count : counts_) {
+        total += count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void GlitchDetector::emit(const Event& event) {
+    MP_TRACE_INSTANT(typeName(event.type));
+    counts_[static_cast<size_t>(event.type)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t head = log_head_.load(std::memory_order_relaxed);
+    if (head - log_tail_.load(std::memory_order_acquire) > log_mask_) {
+        unlogged_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    log_[head & log_mask_] = event;
+    log_head_.store(head + 1, std::memory_order_release);
+}
+
+bool GlitchDetector::popEvent(Event& event) {
+    uint64_t tail = log_tail_.load(std::memory_order_relaxed);
+    if (tail == log_head_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    event = log_[tail & log_mask_];
+    log_tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace media_pipeline
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace media_pipeline {
+namespace dsp {
+
+/**
+ * Per-ISA kernel entry points (internal)
+ * A variant may leave an entry null to use the scalar reference for it.
+ */
+struct KernelTable {
+    void (*applyGain)(float*, size_t, float);
+    void (*applyGainRamp)(float*, size_t, float, float);
+    void (*mixAccumulate)(float*, const float*, size_t, float);
+    float (*dot)(const float*, const float*, size_t);
+    void (*complexMultiplyAccumulate)(float*, const float*, const float*, size_t);
+    void (*biquadCascade)(float*, size_t, size_t, const float*, float*, size_t);
+    void (*hardClip)(float*, size_t, float);
+    void (*softClip)(float*, size_t);
+    void (*floatToInt16)(int16_t*, const float*, size_t);
+    void (*int16ToFloat)(float*, const int16_t*, size_t);
+    void (*floatToInt24)(uint8_t*, const float*, size_t);
+    void (*int24ToFloat)(float*, const uint8_t*, size_t);
+    void (*interleave2)(float*, const float*, const float*, size_t);
+    void (*deinterleave2)(float*, float*, const float*, size_t);
+};
+
+const KernelTable& scalarKernels();
+
+#if defined(__x86_64__) || defined(__i386__)
+const KernelTable& sse2Kernels();
+const KernelTable& avx2Kernels();
+#endif
+
+#if defined(__aarch64__)
+const KernelTable& neonKernels();
+#endif
+
+// Shared scalar building blocks, so SIMD tails compute exactly what the reference does
+
+constexpr float kInt16Scale = 32768.0f;
+constexpr float kInt24Scale = 8388608.0f;
+
+inline float clampScalar(float x, float lo, float hi) {
+    x = lo > x ? lo : x;   // NaN passes (maxps semantics)
+    return x > hi ? hi : x;
+}
+
+inline int32_t quantizeScalar(float x, float scale, float lo, float hi) {
+    float v = x * scale;
+    v = v > lo ? v : lo;   // NaN maps to lo
+    v = v < hi ? v : hi;
+    return static_cast<int32_t>(std::nearbyint(v));
+}
+
+// Fixed reduction of the eight dot-product partial sums
+inline float reduceLanes8(const float* lanes) {
+    float t0 = lanes[0] + lanes[4];
+    float t1 = lanes[1] + lanes[5];
+    float t2 = lanes[2] + lanes[6];
+    float t3 = lanes[3] + lanes[7];
+    float u0 = t0 + t2;
+    float u1 = t1 + t3;
+    return u0 + u1;
+}
+
+inline float dotTail(float sum, const float* a, const float* b, size_t begin, size_t count) {
+    for (size_t i = begin; i < count; ++i) {
+        float product = a[i] * b[i];
+        sum = sum + product;
+    }
+    return sum;
+}
+
+inline void complexMultiplyAccumulateTail(float* acc, const float* a, const float* b, size_t begin, size_t count) {
+    for (size_t k = begin; k < count; ++k) {
+        const float ar = a[2 * k], ai = a[2 * k + 1];
+        const float br = b[2 * k], bi = b[2 * k + 1];
+        float rr = ar * br;
+        float ii = ai * bi;
+        float ri = ar * bi;
+        float ir = ai * br;
+        float re = rr - ii;
+        float im = ri + ir;
+        acc[2 * k] = acc[2 * k] + re;
+        acc[2 * k + 1] = acc[2 * k + 1] + im;
+    }
+}
+
+// One biquad lane through every stage; the SIMD variants run the same
+// operations on four or eight lanes at once
+inline void biquadLane(float* data, size_t frames, size_t lanes, size_t lane, const float* coefficients,
+                       float* state, size_t stages) {
+    for (size_t s = 0; s < stages; ++s) {
+        const float* c = coefficients + 5 * s * lanes + lane;
+        const float b0 = c[0], b1 = c[lanes], b2 = c[2 * lanes], a1 = c[3 * lanes], a2 = c[4 * lanes];
+        float* z = state + 2 * s * lanes + lane;
+        float z1 = z[0], z2 = z[lanes];
+        for (size_t n = 0; n < frames; ++n) {
+            float x = data[n * lanes + lane];
+            float y = b0 * x;
+            y = y + z1;
+            float t = b1 * x;
+            float u = a1 * y;
+            t = t - u;
+            z1 = t + z2;
+            float v = b2 * x;
+            float w = a2 * y;
+            z2 = v - w;
+            data[n * lanes + lane] = y;
+        }
+        z[0] = z1;
+        z[lanes] = z2;
+    }
+}
+
+inline void storeInt24(uint8_t* dst, int32_t value) {
+    dst[0] = static_cast<uint8_t>(value);
+    dst[1] = static_cast<uint8_t>(value >> 8);
+    dst[2] = static_cast<uint8_t>(value >> 16);
+}
+
+inline int32_t loadInt24(const uint8_t* src) {
+    uint32_t raw = static_cast<uint32_t>(src[0]) | (static_cast<uint32_t>(src[1]) << 8) |
+                   (static_cast<uint32_t>(src[2]) << 16);
+    return static_cast<int32_t>(raw << 8) >> 8;  // Sign-extend
+}
+
+} // namespace dsp
+} // namespace media_pipeline
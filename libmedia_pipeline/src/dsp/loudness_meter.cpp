@@ -0,0 +1,248 @@
+#include "media_pipeline/loudness_meter.h"
+#include "media_pipeline/dsp_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace media_pipeline {
+
+namespace {
+
+double loudness(double energy) {
+    return energy > 0.0 ? -0.691 + 10.0 * std::log10(energy) : LoudnessMeter::kSilence;
+}
+
+double decibels(float amplitude) {
+    return amplitude > 0.0f ? 20.0 * std::log10(static_cast<double>(amplitude)) : LoudnessMeter::kSilence;
+}
+
+// BS.1770 K-weighting for any sample rate: the standard's 48 kHz filters are
+// a high shelf and a high-pass with these analog parameters, bilinear-mapped
+BiquadCoefficients shelfStage(double sample_rate) {
+    const double f0 = 1681.974450955533;
+    const double gain_db = 3.999843853973347;
+    const double q = 0.7071752369554196;
+    const double k = std::tan(M_PI * f0 / sample_rate);
+    const double vh = std::pow(10.0, gain_db / 20.0);
+    const double vb = std::pow(vh, 0.4996667741545416);
+    const double a0 = 1.0 + k / q + k * k;
+
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>((vh + vb * k / q + k * k) / a0);
+    c.b1 = static_cast<float>(2.0 * (k * k - vh) / a0);
+    c.b2 = static_cast<float>((vh - vb * k / q + k * k) / a0);
+    c.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+    c.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    return c;
+}
+
+BiquadCoefficients highPassStage(double sample_rate) {
+    const double f0 = 38.13547087602444;
+    const double q = 0.5003270373238773;
+    const double k = std::tan(M_PI * f0 / sample_rate);
+    const double a0 = 1.0 + k / q + k * k;
+
+    BiquadCoefficients c;
+    c.b0 = 1.0f;
+    c.b1 = -2.0f;
+    c.b2 = 1.0f;
+    c.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+    c.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    return c;
+}
+
+} // namespace
+
+LoudnessMeter::LoudnessMeter(int sample_rate, size_t channels)
+    : channels_(std::max<size_t>(channels, 1))
+    , step_frames_(static_cast<size_t>(std::max(1, (sample_rate + 5) / 10)))
+    , weights_(channels_, 1.0)
+    , k_weighting_(channels_, 2)
+    , filtered_(kChunkFrames * channels_)
+    , step_sums_(channels_)
+    , oversampling_(sample_rate < 96000 ? 4 : sample_rate < 192000 ? 2 : 1)
+    , phases_(oversampling_ * kPhaseTaps)
+    , lines_(channels_ * (kPhaseTaps - 1 + kChunkFrames))
+    , interpolated_(kChunkFrames) {
+    k_weighting_.setCoefficientsAll(0, shelfStage(sample_rate));
+    k_weighting_.setCoefficientsAll(1, highPassStage(sample_rate));
+
+    // Interpolator: sinc at the input Nyquist under a Blackman window, each
+    // phase normalized to unity gain at DC
+    const size_t length = oversampling_ * kPhaseTaps;
+    const double center = (static_cast<double>(length) - 1.0) / 2.0;
+    for (size_t phase = 0; phase < oversampling_; ++phase) {
+        double sum = 0.0;
+        double taps[kPhaseTaps];
+        for (size_t j = 0; j < kPhaseTaps; ++j) {
+            const size_t n = phase + j * oversampling_;
+            const double x = (static_cast<double>(n) - center) / static_cast<double>(oversampling_);
+            const double sinc = x == 0.0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+            const double w = 2.0 * M_PI * (static_cast<double>(n) + 0.5) / static_cast<double>(length);
+            const double window = 0.42 - 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w);
+            taps[j] = sinc * window;
+            sum += taps[j];
+        }
+        for (size_t j = 0; j < kPhaseTaps; ++j) {
+            phases_[phase * kPhaseTaps + j] = static_cast<float>(taps[j] / sum);
+        }
+    }
+    reset();
+}
+
+void LoudnessMeter::setChannelWeight(size_t channel, double weight) {
+    if (channel < channels_) {
+        weights_[channel] = std::max(0.0, weight);
+    }
+}
+
+void LoudnessMeter::reset() {
+    k_weighting_.reset();
+    std::fill(step_sums_.begin(), step_sums_.end(), 0.0);
+    step_position_ = 0;
+    std::fill(std::begin(steps_), std::end(steps_), 0.0);
+    step_index_ = 0;
+    step_count_ = 0;
+    std::fill(std::begin(histogram_count_), std::end(histogram_count_), 0);
+    std::fill(std::begin(histogram_energy_), std::end(histogram_energy_), 0.0);
+    std::fill(lines_.begin(), lines_.end(), 0.0f);
+    true_peak_ = 0.0f;
+    sample_peak_ = 0.0f;
+    frames_ = 0;
+}
+
+size_t LoudnessMeter::process(const float* interleaved, size_t frames) {
+    size_t completed = 0;
+    for (size_t offset = 0; offset < frames;) {
+        const size_t count = std::min(kChunkFrames, frames - offset);
+        const float* input = interleaved + offset * channels_;
+        measurePeaks(input, count);
+
+        std::memcpy(filtered_.data(), input, count * channels_ * sizeof(float));
+        k_weighting_.process(filtered_.data(), count);
+        const float* row = filtered_.data();
+        for (size_t n = 0; n < count; ++n, row += channels_) {
+            for (size_t c = 0; c < channels_; ++c) {
+                step_sums_[c] += static_cast<double>(row[c]) * row[c];
+            }
+            if (++step_position_ == step_frames_) {
+                endStep();
+                completed++;
+            }
+        }
+        offset += count;
+    }
+    frames_ += frames;
+    return completed;
+}
+
+void LoudnessMeter::endStep() {
+    double energy = 0.0;
+    for (size_t c = 0; c < channels_; ++c) {
+        energy += weights_[c] * step_sums_[c];
+        step_sums_[c] = 0.0;
+    }
+    steps_[step_index_] = energy / static_cast<double>(step_frames_);
+    step_index_ = (step_index_ + 1) % kShortTermSteps;
+    step_position_ = 0;
+    step_count_++;
+
+    // Every 100 ms closes a 400 ms gating block (75% overlap)
+    if (step_count_ < kMomentarySteps) {
+        return;
+    }
+    const double block = meanEnergy(kMomentarySteps);
+    const double level = loudness(block);
+    if (level <= kHistogramFloor) {
+        return;
+    }
+    const size_t bin = std::min(kHistogramBins - 1, static_cast<size_t>((level - kHistogramFloor) / kHistogramStep));
+    histogram_count_[bin]++;
+    histogram_energy_[bin] += block;
+}
+
+double LoudnessMeter::meanEnergy(size_t steps) const {
+    double sum = 0.0;
+    for (size_t i = 1; i <= steps; ++i) {
+        sum += steps_[(step_index_ + kShortTermSteps - i) % kShortTermSteps];
+    }
+    return sum / static_cast<double>(steps);
+}
+
+// Frames is at most kChunkFrames. Each phase is filtered along time, one
+// vectorized multiply-add per tap over the whole chunk, rather than one
+// short dot product per output sample
+void LoudnessMeter::measurePeaks(const float* interleaved, size_t frames) {
+    const size_t history = kPhaseTaps - 1;
+    const size_t stride = history + kChunkFrames;
+    for (size_t c = 0; c < channels_; ++c) {
+        float* line = lines_.data() + c * stride;
+        for (size_t n = 0; n < frames; ++n) {
+            const float value = interleaved[n * channels_ + c];
+            line[history + n] = value;
+            sample_peak_ = std::max(sample_peak_, std::fabs(value));
+        }
+
+        for (size_t phase = 0; phase < oversampling_ && oversampling_ > 1; ++phase) {
+            const float* taps = phases_.data() + phase * kPhaseTaps;
+            std::fill(interpolated_.begin(), interpolated_.begin() + frames, 0.0f);
+            for (size_t j = 0; j < kPhaseTaps; ++j) {
+                dsp::mixAccumulate(interpolated_.data(), line + history - j, frames, taps[j]);
+            }
+            for (size_t n = 0; n < frames; ++n) {
+                true_peak_ = std::max(true_peak_, std::fabs(interpolated_[n]));
+            }
+        }
+        std::memmove(line, line + frames, history * sizeof(float));
+    }
+}
+
+double LoudnessMeter::getMomentary() const {
+    return loudness(meanEnergy(kMomentarySteps));
+}
+
+double LoudnessMeter::getShortTerm() const {
+    return loudness(meanEnergy(kShortTermSteps));
+}
+
+double LoudnessMeter::getIntegrated() const {
+    uint64_t count = 0;
+    double energy = 0.0;
+    for (size_t bin = 0; bin < kHistogramBins; ++bin) {
+        count += histogram_count_[bin];
+        energy += histogram_energy_[bin];
+    }
+    if (count == 0) {
+        return kSilence;
+    }
+
+    // Relative gate: keep bins centered above it
+    const double gate = loudness(energy / static_cast<double>(count)) - 10.0;
+    count = 0;
+    energy = 0.0;
+    for (size_t bin = 0; bin < kHistogramBins; ++bin) {
+        if (kHistogramFloor + (static_cast<double>(bin) + 0.5) * kHistogramStep > gate) {
+            count += histogram_count_[bin];
+            energy += histogram_energy_[bin];
+        }
+    }
+    return count > 0 ? loudness(energy / static_cast<double>(count)) : kSilence;
+}
+
+double LoudnessMeter::getTruePeak() const {
+    return decibels(std::max(true_peak_, sample_peak_));
+}
+
+LoudnessMeter::Reading LoudnessMeter::getReading() const {
+    Reading reading;
+    reading.momentary_lufs = getMomentary();
+    reading.short_term_lufs = getShortTerm();
+    reading.integrated_lufs = getIntegrated();
+    reading.true_peak_dbtp = getTruePeak();
+    reading.sample_peak_dbfs = decibels(sample_peak_);
+    reading.frames = frames_;
+    return reading;
+}
+
+} // namespace media_pipeline
@@ -0,0 +1,360 @@
+#include "media_pipeline/mic_chain.h"
+#include "media_pipeline/dsp_kernels.h"
+#include "media_pipeline/trace.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace media_pipeline {
+
+namespace {
+
+constexpr size_t kGateSubBlock = 32;
+constexpr float kPowerFloor = 1e-12f;
+
+float dbToLinear(float db) {
+    return std::pow(10.0f, db / 20.0f);
+}
+
+// One-pole coefficient for a time constant, applied once per step of step_samples
+float stepCoef(float time_ms, int sample_rate, size_t step_samples) {
+    if (time_ms <= 0.0f) {
+        return 0.0f;
+    }
+    return std::exp(-static_cast<float>(step_samples) / (time_ms * 0.001f * sample_rate));
+}
+
+} // namespace
+
+NoiseGate::NoiseGate(int sample_rate)
+    : sample_rate_(sample_rate > 0 ? sample_rate : 44100)
+    , open_(false)
+    , hold_remaining_(0)
+    , envelope_(0.0f)
+    , gain_(0.0f) {
+    setThresholds(-45.0f, -52.0f);
+    setTimes(1.0f, 80.0f, 120.0f);
+    setRange(-40.0f);
+    envelope_coef_ = stepCoef(20.0f, sample_rate_, kGateSubBlock);
+    gain_ = floor_gain_;
+}
+
+void NoiseGate::setThresholds(float open_db, float close_db) {
+    open_threshold_ = dbToLinear(open_db);
+    close_threshold_ = dbToLinear(std::min(close_db, open_db));
+}
+
+void NoiseGate::setTimes(float attack_ms, float hold_ms, float release_ms) {
+    attack_coef_ = stepCoef(attack_ms, sample_rate_, kGateSubBlock);
+    release_coef_ = stepCoef(release_ms, sample_rate_, kGateSubBlock);
+    hold_samples_ = static_cast<size_t>(std::max(0.0f, hold_ms) * 0.001f * sample_rate_);
+}
+
+void NoiseGate::setRange(float range_db) {
+    floor_gain_ = std::isinf(range_db) ? 0.0f : std::min(1.0f, dbToLinear(range_db));
+}
+
+void NoiseGate::reset() {
+    open_ = false;
+    hold_remaining_ = 0;
+    envelope_ = 0.0f;
+    gain_ = floor_gain_;
+}
+
+void NoiseGate::process(float* data, size_t count) {
+    for (size_t offset = 0; offset < count; offset += kGateSubBlock) {
+        float* block = data + offset;
+        size_t n = std::min(kGateSubBlock, count - offset);
+
+        float peak = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            peak = std::max(peak, std::fabs(block[i]));
+        }
+        envelope_ = std::max(peak, envelope_ * envelope_coef_);
+
+        // Hysteresis: open above the open threshold, close only after the
+        // level has stayed under the close threshold for the hold time
+        if (envelope_ >= open_threshold_) {
+            open_ = true;
+            hold_remaining_ = hold_samples_;
+        } else if (open_) {
+            if (envelope_ >= close_threshold_) {
+                hold_remaining_ = hold_samples_;
+            } else if (hold_remaining_ > n) {
+                hold_remaining_ -= n;
+            } else {
+                hold_remaining_ = 0;
+                open_ = false;
+            }
+        }
+
+        float target = open_ ? 1.0f : floor_gain_;
+        float coef = target > gain_ ? attack_coef_ : release_coef_;
+        float next = target + (gain_ - target) * coef;
+        if (std::fabs(next - target) < 1e-5f) {
+            next = target;
+        }
+        if (gain_ == 1.0f && next == 1.0f) {
+            continue;  // Open and settled: leave the samples alone
+        }
+        dsp::applyGainRamp(block, n, gain_, next);
+        gain_ = next;
+    }
+}
+
+NoiseSuppressor::NoiseSuppressor(int sample_rate, size_t fft_size)
+    : stft_(fft_size, fft_size / 2)
+    , noise_(stft_.getBinCount(), 0.0f)
+    , previous_clean_(stft_.getBinCount(), 0.0f)
+    , gain_floor_(0.1f)
+    , frames_(0) {
+    processor_ = [this](std::complex<float>* bins, size_t count) { processSpectrum(bins, count); };
+
+    // About +1 dB/s, so a noise floor that steps up is followed within seconds
+    float frames_per_second = static_cast<float>(sample_rate > 0 ? sample_rate : 44100) / stft_.getHop();
+    noise_rise_ = std::pow(10.0f, 0.1f / frames_per_second);
+}
+
+void NoiseSuppressor::setMaxReduction(float reduction_db) {
+    gain_floor_ = std::min(1.0f, dbToLinear(reduction_db));
+}
+
+void NoiseSuppressor::reset() {
+    stft_.reset();
+    std::fill(noise_.begin(), noise_.end(), 0.0f);
+    std::fill(previous_clean_.begin(), previous_clean_.end(), 0.0f);
+    frames_ = 0;
+}
+
+void NoiseSuppressor::process(float* data, size_t count) {
+    stft_.process(data, data, count, processor_);
+}
+
+void NoiseSuppressor::processSpectrum(std::complex<float>* bins, size_t count) {
+    constexpr uint32_t kSeedFrames = 8;
+    constexpr float kDecisionDirected = 0.98f;
+    constexpr float kNoiseLikeSnr = 4.0f;   // Posterior SNR below which a bin is treated as noise
+    constexpr float kNoiseSmoothing = 0.05f;
+
+    // Seed the noise estimate from the first frames, passing them through
+    if (frames_ < kSeedFrames) {
+        for (size_t k = 0; k < count; ++k) {
+            float power = std::norm(bins[k]);
+            noise_[k] += (power - noise_[k]) / static_cast<float>(frames_ + 1);
+            previous_clean_[k] = power;
+        }
+        frames_++;
+        return;
+    }
+
+    for (size_t k = 0; k < count; ++k) {
+        float power = std::norm(bins[k]);
+        float noise = noise_[k];
+
+        // Bin powers of noise are exponentially distributed: smooth symmetrically
+        // over noise-like frames so the estimate tracks the mean, not a low quantile
+        if (power < kNoiseLikeSnr * noise) {
+            noise += kNoiseSmoothing * (power - noise);
+        } else {
+            noise *= noise_rise_;
+        }
+        noise = std::max(noise, kPowerFloor);
+        noise_[k] = noise;
+
+        float posterior = power / noise;
+        float prior = kDecisionDirected * previous_clean_[k] / noise +
+                      (1.0f - kDecisionDirected) * std::max(posterior - 1.0f, 0.0f);
+        float gain = std::max(prior / (1.0f + prior), gain_floor_);
+
+        bins[k] *= gain;
+        previous_clean_[k] = gain * gain * power;
+    }
+}
+
+AutoGainControl::AutoGainControl(int sample_rate, float lookahead_ms)
+    : sample_rate_(sample_rate > 0 ? sample_rate : 44100)
+    , delay_position_(0)
+    , peak_position_(0)
+    , mean_square_(0.0f)
+    , gain_(1.0f) {
+    size_t lookahead = static_cast<size_t>(std::max(0.0f, lookahead_ms) * 0.001f * sample_rate_);
+    lookahead = std::max(lookahead, kSubBlock);
+    delay_.assign(lookahead, 0.0f);
+    peaks_.assign((lookahead + kSubBlock - 1) / kSubBlock + 1, 0.0f);
+
+    setTarget(-20.0f);
+    setGainRange(0.1f, 5.0f);
+    setCeiling(dbToLinear(-1.0f));
+    silence_rms_ = dbToLinear(-60.0f);
+    level_coef_ = stepCoef(200.0f, sample_rate_, kSubBlock);
+    // Five time constants within the look-ahead: reductions are >99% done when the peak plays
+    attack_coef_ = stepCoef(1000.0f * lookahead / sample_rate_ / 5.0f, sample_rate_, kSubBlock);
+    release_coef_ = stepCoef(400.0f, sample_rate_, kSubBlock);
+}
+
+void AutoGainControl::setTarget(float target_db) {
+    target_rms_ = dbToLinear(target_db);
+}
+
+void AutoGainControl::setGainRange(float min_gain, float max_gain) {
+    min_gain_ = std::max(0.0f, std::min(min_gain, max_gain));
+    max_gain_ = std::max(min_gain, max_gain);
+}
+
+void AutoGainControl::setCeiling(float ceiling) {
+    ceiling_ = std::clamp(ceiling, 0.01f, 1.0f);
+}
+
+void AutoGainControl::reset() {
+    std::fill(delay_.begin(), delay_.end(), 0.0f);
+    std::fill(peaks_.begin(), peaks_.end(), 0.0f);
+    delay_position_ = 0;
+    peak_position_ = 0;
+    mean_square_ = 0.0f;
+    gain_ = 1.0f;
+}
+
+void AutoGainControl::process(float* data, size_t count) {
+    for (size_t offset = 0; offset < count; offset += kSubBlock) {
+        processSubBlock(data + offset, std::min(kSubBlock, count - offset));
+    }
+}
+
+void AutoGainControl::processSubBlock(float* data, size_t count) {
+    // Detector on the undelayed input
+    float peak = 0.0f;
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        peak = std::max(peak, std::fabs(data[i]));
+        sum += data[i] * data[i];
+    }
+    mean_square_ += (sum / count - mean_square_) * (1.0f - level_coef_);
+    peaks_[peak_position_] = peak;
+    peak_position_ = (peak_position_ + 1) % peaks_.size();
+    float window_peak = *std::max_element(peaks_.begin(), peaks_.end());
+
+    float rms = std::sqrt(mean_square_);
+    float desired = rms > silence_rms_ ? std::clamp(target_rms_ / rms, min_gain_, max_gain_) : gain_;
+    if (window_peak * desired > ceiling_) {
+        desired = ceiling_ / window_peak;
+    }
+    float coef = desired < gain_ ? attack_coef_ : release_coef_;
+    float next = desired + (gain_ - desired) * coef;
+
+    // Swap the block through the look-ahead delay, then apply the gain ramp
+    const size_t size = delay_.size();
+    for (size_t i = 0; i < count; ++i) {
+        float delayed = delay_[delay_position_];
+        delay_[delay_position_] = data[i];
+        data[i] = delayed;
+        if (++delay_position_ == size) {
+            delay_position_ = 0;
+        }
+    }
+    dsp::applyGainRamp(data, count, gain_, next);
+    gain_ = next;
+}
+
+SoftLimiter::SoftLimiter(float threshold) {
+    setThreshold(threshold);
+}
+
+void SoftLimiter::setThreshold(float threshold) {
+    threshold_ = std::clamp(threshold, 0.1f, 0.99f);
+}
+
+void SoftLimiter::process(float* data, size_t count) const {
+    const float knee = 1.0f - threshold_;
+    for (size_t i = 0; i < count; ++i) {
+        float magnitude = std::fabs(data[i]);
+        if (magnitude > threshold_) {
+            float over = (magnitude - threshold_) / knee;
+            data[i] = std::copysign(threshold_ + knee * over / (1.0f + over), data[i]);
+        }
+    }
+}
+
+MicChain::MicChain(int sample_rate)
+    : input_gain_(1.0f)
+    , noise_gate_(false)
+    , noise_suppression_(false)
+    , auto_gain_(false)
+    , limiter_(true)
+    , applied_gain_(1.0f)
+    , suppression_active_(false)
+    , auto_gain_active_(false)
+    , gate_(sample_rate)
+    , suppressor_(sample_rate)
+    , agc_(sample_rate) {
+}
+
+void MicChain::setSettings(const Settings& settings) {
+    input_gain_ = std::clamp(settings.input_gain, 0.1f, 5.0f);
+    noise_gate_ = settings.noise_gate;
+    noise_suppression_ = settings.noise_suppression;
+    auto_gain_ = settings.auto_gain;
+    limiter_ = settings.limiter;
+}
+
+MicChain::Settings MicChain::getSettings() const {
+    Settings settings;
+    settings.input_gain = input_gain_;
+    settings.noise_gate = noise_gate_;
+    settings.noise_suppression = noise_suppression_;
+    settings.auto_gain = auto_gain_;
+    settings.limiter = limiter_;
+    return settings;
+}
+
+void MicChain::processCapture(const int16_t* pcm, float* output, size_t count) {
+    MP_TRACE_SCOPE("MicChain::processCapture");
+    dsp::int16ToFloat(output, pcm, count);
+    process(output, count);
+}
+
+void MicChain::process(float* data, size_t count) {
+    if (!data || count == 0) {
+        return;
+    }
+
+    float gain = input_gain_.load(std::memory_order_relaxed);
+    if (gain != applied_gain_) {
+        dsp::applyGainRamp(data, count, applied_gain_, gain);
+        applied_gain_ = gain;
+    } else if (gain != 1.0f) {
+        dsp::applyGain(data, count, gain);
+    }
+
+    if (noise_gate_.load(std::memory_order_relaxed)) {
+        gate_.process(data, count);
+    }
+
+    // Stages with memory restart clean when switched back on
+    bool suppress = noise_suppression_.load(std::memory_order_relaxed);
+    if (suppress != suppression_active_) {
+        suppressor_.reset();
+        suppression_active_ = suppress;
+    }
+    if (suppress) {
+        suppressor_.process(data, count);
+    }
+
+    bool auto_gain = auto_gain_.load(std::memory_order_relaxed);
+    if (auto_gain != auto_gain_active_) {
+        agc_.reset();
+        auto_gain_active_ = auto_gain;
+    }
+    if (auto_gain) {
+        agc_.process(data, count);
+    }
+
+    if (limiter_.load(std::memory_order_relaxed)) {
+        soft_limiter_.process(data, count);
+    }
+}
+
+size_t MicChain::getLatency() const {
+    return (noise_suppression_ ? suppressor_.getLatency() : 0) + (auto_gain_ ? agc_.getLatency() : 0);
+}
+
+} // namespace media_pipeline
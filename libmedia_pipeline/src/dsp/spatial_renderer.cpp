@@ -0,0 +1,520 @@
+#include "media_pipeline/spatial_renderer.h"
+#include "media_pipeline/dsp_kernels.h"
+#include "media_pipeline/trace.h"
+#include "media_pipeline/wav_file.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace media_pipeline {
+
+namespace {
+
+constexpr double kTwoPi = 2.0 * M_PI;
+constexpr size_t kMinBlockSize = 8;
+constexpr size_t kMaxSpeakers = 64;
+
+bool isPowerOfTwo(size_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+float* interleaved(std::vector<std::complex<float>>& bins) {
+    return reinterpret_cast<float*>(bins.data());
+}
+
+const float* interleaved(const std::vector<std::complex<float>>& bins) {
+    return reinterpret_cast<const float*>(bins.data());
+}
+
+// Radians in [0, 2 pi)
+double wrapPositive(double radians) {
+    double wrapped = std::fmod(radians, kTwoPi);
+    return wrapped < 0.0 ? wrapped + kTwoPi : wrapped;
+}
+
+// Degrees in (-180, 180]
+double wrapDegrees(double degrees) {
+    double wrapped = std::fmod(degrees, 360.0);
+    if (wrapped > 180.0) {
+        wrapped -= 360.0;
+    } else if (wrapped <= -180.0) {
+        wrapped += 360.0;
+    }
+    return wrapped;
+}
+
+double radians(double degrees) {
+    return degrees * M_PI / 180.0;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------- SpeakerLayout
+
+bool SpeakerLayout::parse(const std::string& spec, SpeakerLayout& layout) {
+    static const struct {
+        const char* name;
+        std::vector<float> azimuths;
+    } kPresets[] = {
+        {"mono", {0.0f}},
+        {"stereo", {30.0f, -30.0f}},
+        {"quad", {45.0f, -45.0f, 135.0f, -135.0f}},
+        {"5.0", {30.0f, -30.0f, 0.0f, 110.0f, -110.0f}},              // L R C Ls Rs
+        {"7.0", {30.0f, -30.0f, 0.0f, 90.0f, -90.0f, 150.0f, -150.0f}}, // L R C Lss Rss Lrs Rrs
+        {"octagon", {0.0f, 45.0f, 90.0f, 135.0f, 180.0f, -135.0f, -90.0f, -45.0f}},
+    };
+    for (const auto& preset : kPresets) {
+        if (spec == preset.name) {
+            layout.azimuths = preset.azimuths;
+            return true;
+        }
+    }
+
+    std::vector<float> azimuths;
+    const char* p = spec.c_str();
+    while (*p) {
+        char* end = nullptr;
+        const float azimuth = std::strtof(p, &end);
+        if (end == p || !std::isfinite(azimuth) || (*end != ',' && *end != '\0')) {
+            return false;
+        }
+        azimuths.push_back(azimuth);
+        p = *end == ',' ? end + 1 : end;
+    }
+    if (azimuths.empty() || azimuths.size() > kMaxSpeakers) {
+        return false;
+    }
+    layout.azimuths = azimuths;
+    return true;
+}
+
+// ---------------------------------------------------------------- HrirSet
+
+HrirSet HrirSet::sphericalHead(int sample_rate, size_t directions, size_t length) {
+    constexpr double kHeadRadius = 0.0875;     // Metres
+    constexpr double kSpeedOfSound = 343.0;
+    constexpr double kMinAlpha = 0.1;          // Shadow depth, -20 dB
+    constexpr double kMinAlphaAngle = 5.0 * M_PI / 6.0;
+    constexpr int kSincHalfWidth = 8;
+
+    HrirSet set;
+    set.sample_rate = sample_rate;
+    set.length = std::max<size_t>(length, 64);
+    directions = std::max<size_t>(directions, 1);
+    set.azimuths.resize(directions);
+    set.left.assign(directions * set.length, 0.0f);
+    set.right.assign(directions * set.length, 0.0f);
+
+    const double fs = static_cast<double>(sample_rate);
+    const double head_delay = kHeadRadius / kSpeedOfSound;
+    // Head shadow H(s) = (1 + alpha s / 2w0) / (1 + s / 2w0), w0 = c / a, bilinear-mapped
+    const double gamma = fs * kHeadRadius / kSpeedOfSound;
+    // Latest arrival first, so every delay is positive
+    const double base_delay = head_delay * fs + kSincHalfWidth;
+
+    for (size_t d = 0; d < directions; ++d) {
+        const double azimuth = wrapDegrees(360.0 * d / directions);
+        set.azimuths[d] = static_cast<float>(azimuth);
+        for (int ear = 0; ear < 2; ++ear) {
+            // Angle between the source and the ear's axis (left ear at +90 degrees)
+            const double theta = std::fabs(radians(wrapDegrees(azimuth - (ear == 0 ? 90.0 : -90.0))));
+            const double delay = theta < M_PI / 2.0 ? -head_delay * std::cos(theta)
+                                                    : head_delay * (theta - M_PI / 2.0);
+            const double alpha = (1.0 + kMinAlpha / 2.0) + (1.0 - kMinAlpha / 2.0) * std::cos(theta / kMinAlphaAngle * M_PI);
+            const double beta = alpha * gamma;
+            const double b0 = (1.0 + beta) / (1.0 + gamma);
+            const double b1 = (1.0 - beta) / (1.0 + gamma);
+            const double a1 = (1.0 - gamma) / (1.0 + gamma);
+
+            // Fractional delay as a Hann-windowed sinc, then the shadow filter
+            float* response = (ear == 0 ? set.left.data() : set.right.data()) + d * set.length;
+            const double position = base_delay + delay * fs;
+            const int center = static_cast<int>(std::floor(position));
+            std::vector<double> impulse(set.length, 0.0);
+            for (int n = center - kSincHalfWidth + 1; n <= center + kSincHalfWidth; ++n) {
+                if (n < 0 || n >= static_cast<int>(set.length)) {
+                    continue;
+                }
+                const double x = n - position;
+                const double sinc = std::fabs(x) < 1e-9 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+                const double window = 0.5 + 0.5 * std::cos(M_PI * x / kSincHalfWidth);
+                impulse[n] = sinc * window;
+            }
+            double previous_x = 0.0;
+            double previous_y = 0.0;
+            for (size_t n = 0; n < set.length; ++n) {
+                const double y = b0 * impulse[n] + b1 * previous_x - a1 * previous_y;
+                previous_x = impulse[n];
+                previous_y = y;
+                response[n] = static_cast<float>(y);
+            }
+        }
+    }
+    return set;
+}
+
+bool HrirSet::load(const std::string& path, HrirSet& set, std::string& error) {
+    WavData wav;
+    if (!readWavFile(path, wav, error)) {
+        return false;
+    }
+    if (wav.channels < 2 || wav.channels % 2 != 0 || wav.getFrameCount() == 0) {
+        error = "HRIR file needs an even number of channels (left and right per direction), got " +
+                std::to_string(wav.channels);
+        return false;
+    }
+    const size_t directions = wav.channels / 2;
+    set.sample_rate = wav.sample_rate;
+    set.length = wav.getFrameCount();
+    set.azimuths.resize(directions);
+    set.left.resize(directions * set.length);
+    set.right.resize(directions * set.length);
+    for (size_t d = 0; d < directions; ++d) {
+        set.azimuths[d] = static_cast<float>(wrapDegrees(360.0 * d / directions));
+        for (size_t n = 0; n < set.length; ++n) {
+            set.left[d * set.length + n] = wav.samples[n * wav.channels + 2 * d];
+            set.right[d * set.length + n] = wav.samples[n * wav.channels + 2 * d + 1];
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------- SpatialRenderer
+
+SpatialRenderer::SpatialRenderer(Mode mode, size_t channels, const Config& config)
+    : mode_(mode)
+    , channels_(channels)
+    , block_size_(config.block_size)
+    , max_sources_(std::max<size_t>(config.max_sources, 1))
+    , reference_distance_(config.reference_distance > 0.0f ? config.reference_distance : 1.0f)
+    , sources_(new Source[std::max<size_t>(config.max_sources, 1)])
+    , buses_(channels, std::vector<float>(config.block_size, 0.0f))
+    , views_(std::max<size_t>(config.max_sources, 1), nullptr)
+    , scratch_(config.block_size, 0.0f)
+    , target_gains_(channels, 0.0f)
+    , partitions_(0)
+    , bins_(0) {
+    for (const auto& bus : buses_) {
+        bus_views_.push_back(bus.data());
+    }
+    for (size_t s = 0; s < max_sources_; ++s) {
+        Source& source = sources_[s];
+        source.azimuth.store(0.0f, std::memory_order_relaxed);
+        source.distance.store(reference_distance_, std::memory_order_relaxed);
+        source.gains.assign(channels_, 0.0f);
+        source.gain = 0.0f;
+        source.direction = 0;
+        source.placed = false;
+        source.idle_blocks = 0;
+        source.head = 0;
+    }
+}
+
+SpatialRenderer::~SpatialRenderer() = default;
+
+std::unique_ptr<SpatialRenderer> SpatialRenderer::createPanner(int sample_rate, const SpeakerLayout& layout,
+                                                               const Config& config, std::string& error) {
+    (void)sample_rate;
+    const size_t count = layout.azimuths.size();
+    if (count == 0 || count > kMaxSpeakers) {
+        error = "speaker layout needs 1 to " + std::to_string(kMaxSpeakers) + " speakers";
+        return nullptr;
+    }
+    if (config.block_size == 0) {
+        error = "block size must be positive";
+        return nullptr;
+    }
+
+    // Adjacent speakers around the circle, counterclockwise
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    std::vector<double> angles(count);
+    for (size_t i = 0; i < count; ++i) {
+        angles[i] = wrapPositive(radians(layout.azimuths[i]));
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return angles[a] < angles[b]; });
+
+    std::unique_ptr<SpatialRenderer> renderer(new SpatialRenderer(Mode::PANNING, count, config));
+    for (size_t i = 0; count > 1 && i < count; ++i) {
+        SpeakerPair pair;
+        pair.first = order[i];
+        pair.second = order[(i + 1) % count];
+        pair.start = static_cast<float>(angles[pair.first]);
+        const double span = wrapPositive(angles[pair.second] - angles[pair.first]);
+        if (span < 1e-4) {
+            error = "two speakers at the same azimuth";
+            return nullptr;
+        }
+        pair.span = static_cast<float>(span);
+        pair.gap = span >= M_PI - 1e-4;
+        renderer->pairs_.push_back(pair);
+    }
+    return renderer;
+}
+
+std::unique_ptr<SpatialRenderer> SpatialRenderer::createBinaural(int sample_rate, const HrirSet& hrirs,
+                                                                 const Config& config, std::string& error) {
+    const size_t directions = hrirs.getDirectionCount();
+    if (directions == 0 || hrirs.length == 0 || hrirs.left.size() != directions * hrirs.length ||
+        hrirs.right.size() != directions * hrirs.length) {
+        error = "empty or inconsistent HRIR set";
+        return nullptr;
+    }
+    if (hrirs.sample_rate != sample_rate) {
+        error = "HRIR set is " + std::to_string(hrirs.sample_rate) + " Hz, output is " + std::to_string(sample_rate) +
+                " Hz (not resampled)";
+        return nullptr;
+    }
+    if (!isPowerOfTwo(config.block_size) || config.block_size < kMinBlockSize) {
+        error = "block size must be a power of two of at least " + std::to_string(kMinBlockSize);
+        return nullptr;
+    }
+
+    std::unique_ptr<SpatialRenderer> renderer(new SpatialRenderer(Mode::BINAURAL, 2, config));
+    const size_t block = config.block_size;
+    renderer->fft_.reset(new RealFft(2 * block));
+    renderer->partitions_ = (hrirs.length + block - 1) / block;
+    renderer->bins_ = block + 1;
+    renderer->hrir_azimuths_ = hrirs.azimuths;
+    renderer->frame_.assign(2 * block, 0.0f);
+    for (auto& accumulator : renderer->accumulators_) {
+        accumulator.resize(renderer->bins_);
+    }
+
+    // Each response zero-padded per partition, as the convolver's IR partitions
+    const size_t partitions = renderer->partitions_;
+    renderer->hrir_spectra_.resize(directions * 2 * partitions);
+    for (size_t d = 0; d < directions; ++d) {
+        for (size_t ear = 0; ear < 2; ++ear) {
+            const float* response = (ear == 0 ? hrirs.left.data() : hrirs.right.data()) + d * hrirs.length;
+            for (size_t p = 0; p < partitions; ++p) {
+                const size_t begin = p * block;
+                const size_t end = std::min(hrirs.length, begin + block);
+                std::fill(renderer->frame_.begin(), renderer->frame_.end(), 0.0f);
+                std::copy(response + begin, response + end, renderer->frame_.begin());
+                auto& spectrum = renderer->hrir_spectra_[(d * 2 + ear) * partitions + p];
+                spectrum.resize(renderer->bins_);
+                renderer->fft_->forward(renderer->frame_.data(), spectrum.data());
+            }
+        }
+    }
+
+    for (size_t s = 0; s < renderer->max_sources_; ++s) {
+        Source& source = renderer->sources_[s];
+        source.history.assign(2 * block, 0.0f);
+        source.delay.assign(partitions, std::vector<std::complex<float>>(renderer->bins_));
+    }
+    return renderer;
+}
+
+void SpatialRenderer::setPosition(size_t source, float azimuth_deg, float distance_m) {
+    if (source >= max_sources_ || !std::isfinite(azimuth_deg) || !std::isfinite(distance_m)) {
+        return;
+    }
+    sources_[source].azimuth.store(azimuth_deg, std::memory_order_relaxed);
+    sources_[source].distance.store(distance_m, std::memory_order_relaxed);
+}
+
+float SpatialRenderer::getAzimuth(size_t source) const {
+    return source < max_sources_ ? sources_[source].azimuth.load(std::memory_order_relaxed) : 0.0f;
+}
+
+float SpatialRenderer::getDistance(size_t source) const {
+    return source < max_sources_ ? sources_[source].distance.load(std::memory_order_relaxed) : 0.0f;
+}
+
+float SpatialRenderer::distanceGain(float distance) const {
+    return distance > reference_distance_ ? reference_distance_ / distance : 1.0f;
+}
+
+void SpatialRenderer::computeGains(float azimuth_deg, float* gains) const {
+    std::fill(gains, gains + channels_, 0.0f);
+    if (channels_ == 1 || pairs_.empty()) {
+        gains[0] = 1.0f;
+        return;
+    }
+    const double theta = wrapPositive(radians(azimuth_deg));
+    for (const SpeakerPair& pair : pairs_) {
+        const double offset = wrapPositive(theta - pair.start);
+        if (offset > pair.span + 1e-6) {
+            continue;
+        }
+        double first;
+        double second;
+        if (pair.gap) {
+            // Constant-power crossfade between the edge speakers
+            const double t = std::min(1.0, offset / pair.span) * M_PI / 2.0;
+            first = std::cos(t);
+            second = std::sin(t);
+        } else {
+            // p = g1 l1 + g2 l2 solved for the unit vectors of the pair, then power normalized
+            first = std::sin(pair.span - offset) / std::sin(pair.span);
+            second = std::sin(offset) / std::sin(pair.span);
+            const double norm = std::sqrt(first * first + second * second);
+            first /= norm;
+            second /= norm;
+        }
+        gains[pair.first] = static_cast<float>(std::max(0.0, first));
+        gains[pair.second] += static_cast<float>(std::max(0.0, second));
+        return;
+    }
+}
+
+size_t SpatialRenderer::nearestDirection(float azimuth_deg) const {
+    size_t nearest = 0;
+    double best = 360.0;
+    for (size_t d = 0; d < hrir_azimuths_.size(); ++d) {
+        const double distance = std::fabs(wrapDegrees(static_cast<double>(azimuth_deg) - hrir_azimuths_[d]));
+        if (distance < best) {
+            best = distance;
+            nearest = d;
+        }
+    }
+    return nearest;
+}
+
+bool SpatialRenderer::render(const float* const* sources, float* output, size_t frames) {
+    if (frames % block_size_ != 0) {
+        return false;
+    }
+    MP_TRACE_SCOPE("SpatialRenderer::render");
+    for (size_t offset = 0; offset < frames; offset += block_size_) {
+        for (size_t s = 0; s < max_sources_; ++s) {
+            views_[s] = sources[s] ? sources[s] + offset : nullptr;
+        }
+        if (mode_ == Mode::PANNING) {
+            renderPanning(views_.data());
+        } else {
+            renderBinaural(views_.data());
+        }
+        dsp::interleave(output + offset * channels_, bus_views_.data(), channels_, block_size_);
+    }
+    return true;
+}
+
+void SpatialRenderer::renderPanning(const float* const* sources) {
+    for (auto& bus : buses_) {
+        std::fill(bus.begin(), bus.end(), 0.0f);
+    }
+    for (size_t s = 0; s < max_sources_; ++s) {
+        Source& source = sources_[s];
+        if (!sources[s]) {
+            // Fades back in from silence when it returns
+            std::fill(source.gains.begin(), source.gains.end(), 0.0f);
+            continue;
+        }
+        computeGains(source.azimuth.load(std::memory_order_relaxed), target_gains_.data());
+        const float gain = distanceGain(source.distance.load(std::memory_order_relaxed));
+        for (size_t c = 0; c < channels_; ++c) {
+            const float from = source.gains[c];
+            const float to = target_gains_[c] * gain;
+            if (from == to) {
+                if (to != 0.0f) {
+                    dsp::mixAccumulate(buses_[c].data(), sources[s], block_size_, to);
+                }
+                continue;
+            }
+            std::memcpy(scratch_.data(), sources[s], block_size_ * sizeof(float));
+            dsp::applyGainRamp(scratch_.data(), block_size_, from, to);
+            dsp::mixAccumulate(buses_[c].data(), scratch_.data(), block_size_, 1.0f);
+            source.gains[c] = to;
+        }
+    }
+}
+
+void SpatialRenderer::renderBinaural(const float* const* sources) {
+    const size_t block = block_size_;
+    for (auto& accumulator : accumulators_) {
+        std::fill(accumulator.begin(), accumulator.end(), std::complex<float>());
+    }
+    bool fading = false;
+
+    for (size_t s = 0; s < max_sources_; ++s) {
+        Source& source = sources_[s];
+        if (sources[s]) {
+            source.idle_blocks = 0;
+        } else if (!source.placed || source.idle_blocks > partitions_) {
+            continue;  // Silent, and its history has rung out
+        } else {
+            source.idle_blocks++;
+        }
+
+        // Overlap-save input: previous block, then this one at its distance gain
+        float* history = source.history.data();
+        std::memmove(history, history + block, block * sizeof(float));
+        if (sources[s]) {
+            std::memcpy(history + block, sources[s], block * sizeof(float));
+        } else {
+            std::fill(history + block, history + 2 * block, 0.0f);
+        }
+        const float gain = distanceGain(source.distance.load(std::memory_order_relaxed));
+        if (gain != source.gain) {
+            dsp::applyGainRamp(history + block, block, source.gain, gain);
+            source.gain = gain;
+        } else if (gain != 1.0f) {
+            dsp::applyGain(history + block, block, gain);
+        }
+        source.head = (source.head + partitions_ - 1) % partitions_;
+        fft_->forward(history, source.delay[source.head].data());
+
+        const size_t direction = nearestDirection(source.azimuth.load(std::memory_order_relaxed));
+        if (!source.placed) {
+            source.direction = direction;
+            source.placed = true;
+        }
+        const bool moved = direction != source.direction;
+        fading |= moved;
+        for (size_t ear = 0; ear < 2; ++ear) {
+            const auto* target = &hrir_spectra_[(direction * 2 + ear) * partitions_];
+            const auto* previous = &hrir_spectra_[(source.direction * 2 + ear) * partitions_];
+            float* into = interleaved(accumulators_[moved ? 2 + ear : ear]);
+            for (size_t p = 0, slot = source.head; p < partitions_; ++p, slot = (slot + 1) % partitions_) {
+                const float* input = interleaved(source.delay[slot]);
+                dsp::complexMultiplyAccumulate(into, input, interleaved(target[p]), bins_);
+                if (moved) {
+                    dsp::complexMultiplyAccumulate(interleaved(accumulators_[4 + ear]), input,
+                                                   interleaved(previous[p]), bins_);
+                }
+            }
+        }
+        source.direction = direction;
+    }
+
+    // Second half of each inverse is the block's output; the crossfade pair
+    // ramps in and out across it
+    for (size_t ear = 0; ear < 2; ++ear) {
+        float* bus = buses_[ear].data();
+        fft_->inverse(accumulators_[ear].data(), frame_.data());
+        std::memcpy(bus, frame_.data() + block, block * sizeof(float));
+        if (!fading) {
+            continue;
+        }
+        fft_->inverse(accumulators_[2 + ear].data(), frame_.data());
+        dsp::applyGainRamp(frame_.data() + block, block, 0.0f, 1.0f);
+        dsp::mixAccumulate(bus, frame_.data() + block, block, 1.0f);
+        fft_->inverse(accumulators_[4 + ear].data(), frame_.data());
+        dsp::applyGainRamp(frame_.data() + block, block, 1.0f, 0.0f);
+        dsp::mixAccumulate(bus, frame_.data() + block, block, 1.0f);
+    }
+}
+
+void SpatialRenderer::reset() {
+    for (size_t s = 0; s < max_sources_; ++s) {
+        Source& source = sources_[s];
+        std::fill(source.gains.begin(), source.gains.end(), 0.0f);
+        source.gain = 0.0f;
+        source.placed = false;
+        source.idle_blocks = 0;
+        std::fill(source.history.begin(), source.history.end(), 0.0f);
+        for (auto& spectrum : source.delay) {
+            std::fill(spectrum.begin(), spectrum.end(), std::complex<float>());
+        }
+        source.head = 0;
+    }
+}
+
+} // namespace media_pipeline
@@ -0,0 +1,140 @@
+#include "media_pipeline/spectrum_analyzer.h"
+#include "media_pipeline/trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace media_pipeline {
+
+SpectrumAnalyzer::SpectrumAnalyzer(int sample_rate)
+    : SpectrumAnalyzer(sample_rate, Config()) {
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer(int sample_rate, const Config& config)
+    : config_(config)
+    , fft_(config.fft_size)
+    , fill_(0) {
+    const size_t size = fft_.getSize();
+    const double rate = std::max(1, sample_rate);
+    config_.fft_size = size;
+    config_.bands = std::max<size_t>(config_.bands, 1);
+    config_.frame_rate = std::max(config_.frame_rate, 0.1f);
+    config_.smoothing = std::min(std::max(config_.smoothing, 0.0f), 1.0f);
+    hop_ = std::max<size_t>(1, static_cast<size_t>(std::lround(rate / config_.frame_rate)));
+
+    double sum_squares = 0.0;
+    window_.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / size));
+        sum_squares += static_cast<double>(window_[i]) * window_[i];
+    }
+    // One-sided Parseval: a sine of amplitude A spreads A^2 N sum(w^2) / 4 over its bins
+    power_scale_ = static_cast<float>(4.0 / (static_cast<double>(size) * sum_squares));
+    floor_power_ = std::pow(10.0f, config_.floor_db / 10.0f);
+    input_.resize(size);
+    frame_.resize(size);
+    bins_.resize(fft_.getBinCount());
+
+    // Log-spaced edges; a band whose bin range is empty takes its center's bin
+    const double bin_hz = rate / static_cast<double>(size);
+    const double nyquist = rate / 2.0;
+    const double low = std::min(std::max(static_cast<double>(config_.min_frequency), bin_hz), nyquist / 2.0);
+    const double high = std::min(std::max(static_cast<double>(config_.max_frequency), low * 2.0), nyquist);
+    const size_t bands = config_.bands;
+    const uint32_t last_bin = static_cast<uint32_t>(bins_.size() - 1);
+    edges_.resize(bands + 1);
+    band_first_.resize(bands);
+    band_end_.resize(bands);
+    for (size_t b = 0; b <= bands; ++b) {
+        edges_[b] = static_cast<float>(low * std::pow(high / low, static_cast<double>(b) / bands));
+    }
+    for (size_t b = 0; b < bands; ++b) {
+        const uint32_t first = static_cast<uint32_t>(std::ceil(edges_[b] / bin_hz));
+        const uint32_t end = std::min(last_bin + 1, static_cast<uint32_t>(std::ceil(edges_[b + 1] / bin_hz)));
+        if (first < end) {
+            band_first_[b] = first;
+            band_end_[b] = end;
+        } else {
+            const double center = std::sqrt(static_cast<double>(edges_[b]) * edges_[b + 1]);
+            const uint32_t bin = std::min(last_bin, static_cast<uint32_t>(std::lround(center / bin_hz)));
+            band_first_[b] = bin;
+            band_end_[b] = bin + 1;
+        }
+    }
+
+    power_.resize(bands);
+    levels_db_.resize(bands);
+    peaks_db_.resize(bands);
+    hold_frames_.resize(bands);
+    hold_length_ = static_cast<uint32_t>(std::lround(std::max(config_.peak_hold_s, 0.0f) * config_.frame_rate));
+    decay_per_frame_db_ = std::max(config_.peak_decay_db_per_s, 0.0f) / config_.frame_rate;
+    reset();
+}
+
+void SpectrumAnalyzer::reset() {
+    fill_ = 0;
+    std::fill(input_.begin(), input_.end(), 0.0f);
+    std::fill(power_.begin(), power_.end(), floor_power_);
+    std::fill(levels_db_.begin(), levels_db_.end(), config_.floor_db);
+    std::fill(peaks_db_.begin(), peaks_db_.end(), config_.floor_db);
+    std::fill(hold_frames_.begin(), hold_frames_.end(), 0);
+}
+
+size_t SpectrumAnalyzer::process(const float* samples, size_t count, const FrameCallback& callback) {
+    const size_t size = input_.size();
+    size_t frames = 0;
+    size_t done = 0;
+    while (done < count) {
+        const size_t n = std::min(count - done, hop_ - fill_);
+        // input_ keeps the newest size samples; the hop may be longer than that
+        if (n >= size) {
+            std::memcpy(input_.data(), samples + done + n - size, size * sizeof(float));
+        } else {
+            std::memmove(input_.data(), input_.data() + n, (size - n) * sizeof(float));
+            std::memcpy(input_.data() + size - n, samples + done, n * sizeof(float));
+        }
+        fill_ += n;
+        done += n;
+        if (fill_ == hop_) {
+            analyzeFrame();
+            if (callback) {
+                callback(levels_db_.data(), peaks_db_.data(), levels_db_.size());
+            }
+            fill_ = 0;
+            frames++;
+        }
+    }
+    return frames;
+}
+
+void SpectrumAnalyzer::analyzeFrame() {
+    MP_TRACE_SCOPE("SpectrumAnalyzer::frame");
+    const size_t size = input_.size();
+    for (size_t i = 0; i < size; ++i) {
+        frame_[i] = input_[i] * window_[i];
+    }
+    fft_.forward(frame_.data(), bins_.data());
+
+    const float keep = config_.smoothing;
+    for (size_t b = 0; b < power_.size(); ++b) {
+        float sum = 0.0f;
+        for (uint32_t k = band_first_[b]; k < band_end_[b]; ++k) {
+            sum += std::norm(bins_[k]);
+        }
+        const float power = std::max(sum * power_scale_, floor_power_);
+        power_[b] = power >= power_[b] ? power : keep * power_[b] + (1.0f - keep) * power;
+        levels_db_[b] = std::max(10.0f * std::log10(power_[b]), config_.floor_db);
+
+        if (levels_db_[b] >= peaks_db_[b]) {
+            peaks_db_[b] = levels_db_[b];
+            hold_frames_[b] = hold_length_;
+        } else if (hold_frames_[b] > 0) {
+            hold_frames_[b]--;
+        } else {
+            peaks_db_[b] = std::max(peaks_db_[b] - decay_per_frame_db_, levels_db_[b]);
+        }
+    }
+}
+
+} // namespace media_pipeline
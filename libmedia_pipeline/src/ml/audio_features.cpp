@@ -0,0 +1,128 @@
+#include "media_pipeline/audio_features.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace media_pipeline {
+
+namespace {
+
+constexpr float kRolloffFraction = 0.85f;
+constexpr float kSilenceDb = -100.0f;
+constexpr double kPowerFloor = 1e-12;
+
+} // namespace
+
+AudioFeatureExtractor::AudioFeatureExtractor(int sample_rate, size_t frame_size, size_t hop)
+    : sample_rate_(sample_rate > 0 ? sample_rate : 48000)
+    , fft_(frame_size)
+    , hop_(0)
+    , fill_(0) {
+    const size_t size = fft_.getSize();
+    hop_ = (hop == 0 || hop > size) ? size / 2 : hop;
+
+    window_.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / size));
+    }
+    input_.assign(size, 0.0f);
+    frame_.assign(size, 0.0f);
+    bins_.resize(fft_.getBinCount());
+    magnitude_.assign(fft_.getBinCount(), 0.0f);
+    previous_magnitude_.assign(fft_.getBinCount(), 0.0f);
+}
+
+void AudioFeatureExtractor::reset() {
+    std::fill(input_.begin(), input_.end(), 0.0f);
+    std::fill(previous_magnitude_.begin(), previous_magnitude_.end(), 0.0f);
+    fill_ = 0;
+}
+
+void AudioFeatureExtractor::process(const float* samples, size_t count, const FrameCallback& callback) {
+    const size_t tail = input_.size() - hop_;
+    float features[kFeatureCount];
+    size_t done = 0;
+    while (done < count) {
+        size_t n = std::min(count - done, hop_ - fill_);
+        std::memcpy(input_.data() + tail + fill_, samples + done, n * sizeof(float));
+        fill_ += n;
+        done += n;
+        if (fill_ == hop_) {
+            analyseFrame(features);
+            if (callback) {
+                callback(features, kFeatureCount);
+            }
+            std::memmove(input_.data(), input_.data() + hop_, tail * sizeof(float));
+            fill_ = 0;
+        }
+    }
+}
+
+void AudioFeatureExtractor::analyseFrame(float* features) {
+    const size_t size = input_.size();
+
+    // Time domain: unwindowed frame
+    double energy = 0.0;
+    size_t crossings = 0;
+    for (size_t i = 0; i < size; ++i) {
+        energy += static_cast<double>(input_[i]) * input_[i];
+        if (i > 0 && (input_[i] >= 0.0f) != (input_[i - 1] >= 0.0f)) {
+            crossings++;
+        }
+    }
+    double rms = std::sqrt(energy / size);
+    features[RMS_DB] = rms > 1e-5 ? static_cast<float>(20.0 * std::log10(rms)) : kSilenceDb;
+    features[ZERO_CROSSING_RATE] = static_cast<float>(crossings) / static_cast<float>(size - 1);
+
+    for (size_t i = 0; i < size; ++i) {
+        frame_[i] = input_[i] * window_[i];
+    }
+    fft_.forward(frame_.data(), bins_.data());
+
+    // Magnitudes scaled so a full-scale sine peaks near 1 (Hann sums to size / 2)
+    const size_t bin_count = bins_.size();
+    const float scale = 4.0f / static_cast<float>(size);
+    const double bin_hz = static_cast<double>(sample_rate_) / size;
+    double magnitude_sum = 0.0;
+    double weighted_sum = 0.0;
+    double power_sum = 0.0;
+    double log_power_sum = 0.0;
+    double flux = 0.0;
+    for (size_t k = 0; k < bin_count; ++k) {
+        float magnitude = std::abs(bins_[k]) * scale;
+        magnitude_[k] = magnitude;
+        double power = static_cast<double>(magnitude) * magnitude;
+        magnitude_sum += magnitude;
+        weighted_sum += magnitude * (k * bin_hz);
+        power_sum += power;
+        log_power_sum += std::log(power + kPowerFloor);
+        float rise = magnitude - previous_magnitude_[k];
+        if (rise > 0.0f) {
+            flux += static_cast<double>(rise) * rise;
+        }
+    }
+    previous_magnitude_.swap(magnitude_);
+
+    features[SPECTRAL_CENTROID] = magnitude_sum > 0.0 ? static_cast<float>(weighted_sum / magnitude_sum) : 0.0f;
+
+    // previous_magnitude_ now holds this frame's magnitudes
+    double rolloff_energy = kRolloffFraction * power_sum;
+    double cumulative = 0.0;
+    size_t rolloff_bin = 0;
+    for (; rolloff_bin + 1 < bin_count; ++rolloff_bin) {
+        double magnitude = previous_magnitude_[rolloff_bin];
+        cumulative += magnitude * magnitude;
+        if (cumulative >= rolloff_energy) {
+            break;
+        }
+    }
+    features[SPECTRAL_ROLLOFF] = power_sum > 0.0 ? static_cast<float>(rolloff_bin * bin_hz) : 0.0f;
+
+    double geometric = std::exp(log_power_sum / bin_count);
+    double arithmetic = power_sum / bin_count;
+    features[SPECTRAL_FLATNESS] = static_cast<float>(std::min(1.0, (geometric + kPowerFloor) / (arithmetic + kPowerFloor)));
+    features[SPECTRAL_FLUX] = static_cast<float>(std::sqrt(flux / bin_count));
+}
+
+} // namespace media_pipeline
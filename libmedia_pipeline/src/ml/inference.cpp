@@ -0,0 +1,431 @@
+#include "media_pipeline/inference.h"
+#include "media_pipeline/dsp_kernels.h"
+#include "media_pipeline/trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace media_pipeline {
+
+namespace {
+
+constexpr size_t kMaxLayers = 64;
+constexpr size_t kMaxTrees = 4096;
+constexpr size_t kMaxFileSize = 64 * 1024 * 1024;
+constexpr size_t kNodeBytes = 16;
+
+size_t padToBlock(size_t count) {
+    return (count + 7) & ~size_t(7);
+}
+
+void activate(float* data, size_t count, InferenceModel::Activation activation) {
+    switch (activation) {
+        case InferenceModel::Activation::IDENTITY:
+            break;
+        case InferenceModel::Activation::RELU:
+            for (size_t i = 0; i < count; ++i) {
+                data[i] = data[i] > 0.0f ? data[i] : 0.0f;
+            }
+            break;
+        case InferenceModel::Activation::TANH:
+            for (size_t i = 0; i < count; ++i) {
+                data[i] = std::tanh(data[i]);
+            }
+            break;
+        case InferenceModel::Activation::LOGISTIC:
+            for (size_t i = 0; i < count; ++i) {
+                data[i] = 1.0f / (1.0f + std::exp(-data[i]));
+            }
+            break;
+        case InferenceModel::Activation::SOFTMAX: {
+            float peak = *std::max_element(data, data + count);
+            float sum = 0.0f;
+            for (size_t i = 0; i < count; ++i) {
+                data[i] = std::exp(data[i] - peak);
+                sum += data[i];
+            }
+            for (size_t i = 0; i < count; ++i) {
+                data[i] /= sum;
+            }
+            break;
+        }
+    }
+}
+
+} // namespace
+
+// Bounds-checked little-endian cursor (the app and receiver hosts are all little-endian)
+class InferenceModel::Reader {
+public:
+    Reader(const void* data, size_t size)
+        : data_(static_cast<const uint8_t*>(data)), size_(data ? size : 0), position_(0) {}
+
+    template <typename T>
+    bool read(T& value) {
+        return bytes(&value, sizeof(T));
+    }
+
+    bool bytes(void* dst, size_t count) {
+        if (count > remaining()) {
+            return false;
+        }
+        std::memcpy(dst, data_ + position_, count);
+        position_ += count;
+        return true;
+    }
+
+    bool floats(float* dst, size_t count) {
+        return count <= remaining() / sizeof(float) && bytes(dst, count * sizeof(float));
+    }
+
+    size_t remaining() const { return size_ - position_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t position_;
+};
+
+std::unique_ptr<InferenceModel> InferenceModel::load(const void* data, size_t size, std::string& error) {
+    Reader reader(data, size);
+    char magic[4];
+    uint16_t version = 0;
+    uint16_t type = 0;
+    uint32_t inputs = 0;
+    uint32_t outputs = 0;
+    uint32_t flags = 0;
+    if (!reader.bytes(magic, sizeof(magic)) || std::memcmp(magic, "MPML", 4) != 0) {
+        error = "not a model file";
+        return nullptr;
+    }
+    if (!reader.read(version) || !reader.read(type) || !reader.read(inputs) || !reader.read(outputs) ||
+        !reader.read(flags)) {
+        error = "truncated model header";
+        return nullptr;
+    }
+    if (version != kVersion) {
+        error = "unsupported model version " + std::to_string(version);
+        return nullptr;
+    }
+    if (inputs == 0 || inputs > kMaxWidth || outputs == 0 || outputs > kMaxWidth) {
+        error = "invalid model dimensions";
+        return nullptr;
+    }
+
+    std::unique_ptr<InferenceModel> model(new InferenceModel());
+    model->type_ = static_cast<Type>(type);
+    model->input_count_ = inputs;
+    model->output_count_ = outputs;
+
+    if (flags & kFlagNormalize) {
+        model->offset_.resize(inputs);
+        model->scale_.resize(inputs);
+        if (!reader.floats(model->offset_.data(), inputs) || !reader.floats(model->scale_.data(), inputs)) {
+            error = "truncated normalization";
+            return nullptr;
+        }
+    }
+
+    bool parsed = false;
+    switch (model->type_) {
+        case Type::LINEAR:
+            parsed = model->parseLayer(reader, inputs, error);
+            break;
+        case Type::MLP: {
+            uint32_t layer_count = 0;
+            if (!reader.read(layer_count) || layer_count == 0 || layer_count > kMaxLayers) {
+                error = "invalid layer count";
+                return nullptr;
+            }
+            parsed = true;
+            size_t layer_inputs = inputs;
+            for (uint32_t i = 0; parsed && i < layer_count; ++i) {
+                parsed = model->parseLayer(reader, layer_inputs, error);
+                layer_inputs = parsed ? model->layers_.back().outputs : 0;
+            }
+            break;
+        }
+        case Type::TREE_ENSEMBLE:
+            parsed = model->parseTrees(reader, error);
+            break;
+        default:
+            error = "unknown model type " + std::to_string(type);
+            return nullptr;
+    }
+    if (!parsed) {
+        return nullptr;
+    }
+    if (!model->layers_.empty() && model->layers_.back().outputs != outputs) {
+        error = "last layer does not produce the declared outputs";
+        return nullptr;
+    }
+    if (reader.remaining() != 0) {
+        error = "trailing bytes after model";
+        return nullptr;
+    }
+
+    model->allocateScratch();
+    return model;
+}
+
+std::unique_ptr<InferenceModel> InferenceModel::loadFile(const std::string& path, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + path;
+        return nullptr;
+    }
+    std::vector<char> contents;
+    contents.reserve(4096);
+    char buffer[4096];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        contents.insert(contents.end(), buffer, buffer + file.gcount());
+        if (contents.size() > kMaxFileSize) {
+            error = path + " is too large for a model";
+            return nullptr;
+        }
+    }
+    return load(contents.data(), contents.size(), error);
+}
+
+bool InferenceModel::parseLayer(Reader& reader, size_t inputs, std::string& error) {
+    uint32_t layer_inputs = 0;
+    uint32_t layer_outputs = 0;
+    uint8_t activation = 0;
+    uint8_t padding[3];
+    if (!reader.read(layer_inputs) || !reader.read(layer_outputs) || !reader.read(activation) ||
+        !reader.bytes(padding, sizeof(padding))) {
+        error = "truncated layer header";
+        return false;
+    }
+    if (layer_inputs != inputs) {
+        error = "layer inputs do not match the previous layer";
+        return false;
+    }
+    if (layer_outputs == 0 || layer_outputs > kMaxWidth) {
+        error = "invalid layer width";
+        return false;
+    }
+    if (activation > static_cast<uint8_t>(Activation::SOFTMAX)) {
+        error = "unknown activation " + std::to_string(activation);
+        return false;
+    }
+    // Checked before allocating, so a corrupt header cannot request gigabytes
+    if (static_cast<uint64_t>(layer_outputs) * (layer_inputs + 1) > reader.remaining() / sizeof(float)) {
+        error = "truncated layer weights";
+        return false;
+    }
+
+    Layer layer;
+    layer.inputs = layer_inputs;
+    layer.outputs = layer_outputs;
+    layer.stride = padToBlock(layer_inputs);
+    layer.activation = static_cast<Activation>(activation);
+    layer.weights = weights_.size();
+    layer.bias = layer.weights + layer.outputs * layer.stride;
+    weights_.resize(layer.bias + layer.outputs, 0.0f);
+    for (size_t row = 0; row < layer.outputs; ++row) {
+        reader.floats(weights_.data() + layer.weights + row * layer.stride, layer.inputs);
+    }
+    reader.floats(weights_.data() + layer.bias, layer.outputs);
+    layers_.push_back(layer);
+    return true;
+}
+
+bool InferenceModel::parseTrees(Reader& reader, std::string& error) {
+    uint32_t tree_count = 0;
+    if (!reader.read(tree_count) || tree_count == 0 || tree_count > kMaxTrees) {
+        error = "invalid tree count";
+        return false;
+    }
+
+    uint32_t max_leaf = 0;
+    for (uint32_t t = 0; t < tree_count; ++t) {
+        uint32_t node_count = 0;
+        if (!reader.read(node_count) || node_count == 0 || node_count > reader.remaining() / kNodeBytes) {
+            error = "truncated tree";
+            return false;
+        }
+        const uint32_t base = static_cast<uint32_t>(nodes_.size());
+        roots_.push_back(base);
+        for (uint32_t i = 0; i < node_count; ++i) {
+            Node node;
+            reader.read(node.feature);
+            reader.read(node.threshold);
+            reader.read(node.left);
+            reader.read(node.right);
+            if (node.feature < 0) {
+                max_leaf = std::max(max_leaf, node.left + 1);
+                node.feature = -1;
+            } else {
+                // Children strictly after the parent: every walk terminates
+                if (static_cast<size_t>(node.feature) >= input_count_ || node.left <= i || node.right <= i ||
+                    node.left >= node_count || node.right >= node_count) {
+                    error = "invalid tree node";
+                    return false;
+                }
+                node.left += base;
+                node.right += base;
+            }
+            nodes_.push_back(node);
+        }
+    }
+
+    uint32_t leaf_count = 0;
+    if (!reader.read(leaf_count) || leaf_count < max_leaf) {
+        error = "tree refers to a missing leaf";
+        return false;
+    }
+    if (static_cast<uint64_t>(leaf_count) * output_count_ > reader.remaining() / sizeof(float)) {
+        error = "truncated leaf values";
+        return false;
+    }
+    leaf_values_.resize(static_cast<size_t>(leaf_count) * output_count_);
+    reader.floats(leaf_values_.data(), leaf_values_.size());
+    return true;
+}
+
+void InferenceModel::allocateScratch() {
+    scratch_stride_ = padToBlock(input_count_);
+    for (const Layer& layer : layers_) {
+        scratch_stride_ = std::max(scratch_stride_, padToBlock(layer.outputs));
+    }
+    scratch_a_.assign(kMaxBatch * scratch_stride_, 0.0f);
+    scratch_b_.assign(kMaxBatch * scratch_stride_, 0.0f);
+}
+
+void InferenceModel::predict(const float* frames, size_t frame_count, size_t stride, float* outputs) {
+    while (frame_count > 0) {
+        size_t n = std::min(frame_count, kMaxBatch);
+        normalize(frames, n, stride, scratch_a_.data(), scratch_stride_);
+        if (type_ == Type::TREE_ENSEMBLE) {
+            runTrees(n, outputs);
+        } else {
+            runLayers(n, outputs);
+        }
+        frames += n * stride;
+        outputs += n * output_count_;
+        frame_count -= n;
+    }
+}
+
+void InferenceModel::normalize(const float* frames, size_t frame_count, size_t stride, float* dst,
+                               size_t dst_stride) const {
+    for (size_t f = 0; f < frame_count; ++f) {
+        const float* x = frames + f * stride;
+        float* row = dst + f * dst_stride;
+        if (offset_.empty()) {
+            std::memcpy(row, x, input_count_ * sizeof(float));
+        } else {
+            for (size_t i = 0; i < input_count_; ++i) {
+                row[i] = (x[i] - offset_[i]) * scale_[i];
+            }
+        }
+    }
+}
+
+void InferenceModel::runLayers(size_t frame_count, float* outputs) {
+    float* in = scratch_a_.data();
+    float* out = scratch_b_.data();
+    const size_t stride = scratch_stride_;
+    for (const Layer& layer : layers_) {
+        // Row-major over the batch: a neuron's weights stay in registers/L1 for every frame
+        for (size_t r = 0; r < layer.outputs; ++r) {
+            const float* row = weights_.data() + layer.weights + r * layer.stride;
+            const float bias = weights_[layer.bias + r];
+            for (size_t f = 0; f < frame_count; ++f) {
+                out[f * stride + r] = dsp::dot(row, in + f * stride, layer.stride) + bias;
+            }
+        }
+        for (size_t f = 0; f < frame_count; ++f) {
+            float* values = out + f * stride;
+            activate(values, layer.outputs, layer.activation);
+            // The next layer reads whole blocks; keep its padding zero
+            std::fill(values + layer.outputs, values + padToBlock(layer.outputs), 0.0f);
+        }
+        std::swap(in, out);
+    }
+
+    for (size_t f = 0; f < frame_count; ++f) {
+        std::memcpy(outputs + f * output_count_, in + f * stride, output_count_ * sizeof(float));
+    }
+}
+
+void InferenceModel::runTrees(size_t frame_count, float* outputs) {
+    const float* in = scratch_a_.data();
+    std::fill(outputs, outputs + frame_count * output_count_, 0.0f);
+    for (uint32_t root : roots_) {
+        for (size_t f = 0; f < frame_count; ++f) {
+            const float* x = in + f * scratch_stride_;
+            uint32_t i = root;
+            while (nodes_[i].feature >= 0) {
+                const Node& node = nodes_[i];
+                i = x[node.feature] <= node.threshold ? node.left : node.right;
+            }
+            dsp::mixAccumulate(outputs + f * output_count_, leaf_values_.data() + nodes_[i].left * output_count_,
+                               output_count_, 1.0f);
+        }
+    }
+    dsp::applyGain(outputs, frame_count * output_count_, 1.0f / static_cast<float>(roots_.size()));
+}
+
+std::unique_ptr<FeatureInference> FeatureInference::create(std::unique_ptr<InferenceModel> model, int sample_rate,
+                                                           size_t window_frames, std::string& error) {
+    if (!model) {
+        error = "no model";
+        return nullptr;
+    }
+    if (model->getInputCount() != AudioFeatureExtractor::kFeatureCount) {
+        error = "model takes " + std::to_string(model->getInputCount()) + " inputs, audio features have " +
+                std::to_string(static_cast<int>(AudioFeatureExtractor::kFeatureCount));
+        return nullptr;
+    }
+    return std::unique_ptr<FeatureInference>(new FeatureInference(std::move(model), sample_rate, window_frames));
+}
+
+FeatureInference::FeatureInference(std::unique_ptr<InferenceModel> model, int sample_rate, size_t window_frames)
+    : model_(std::move(model))
+    , extractor_(sample_rate)
+    , callback_(nullptr)
+    , window_frames_(std::min(std::max<size_t>(window_frames, 1), InferenceModel::kMaxBatch))
+    , frames_(0) {
+    const size_t outputs = model_->getOutputCount();
+    window_.assign(window_frames_ * AudioFeatureExtractor::kFeatureCount, 0.0f);
+    outputs_.assign(window_frames_ * outputs, 0.0f);
+    mean_.assign(outputs, 0.0f);
+
+    // Bound once: a lambda built per call could allocate on the capture thread
+    on_frame_ = [this](const float* features, size_t count) {
+        std::memcpy(window_.data() + frames_ * count, features, count * sizeof(float));
+        if (++frames_ < window_frames_) {
+            return;
+        }
+        frames_ = 0;
+
+        const size_t output_count = model_->getOutputCount();
+        model_->predict(window_.data(), window_frames_, count, outputs_.data());
+        std::fill(mean_.begin(), mean_.end(), 0.0f);
+        for (size_t f = 0; f < window_frames_; ++f) {
+            dsp::mixAccumulate(mean_.data(), outputs_.data() + f * output_count, output_count, 1.0f);
+        }
+        dsp::applyGain(mean_.data(), output_count, 1.0f / static_cast<float>(window_frames_));
+        if (callback_ && *callback_) {
+            (*callback_)(mean_.data(), output_count);
+        }
+    };
+}
+
+void FeatureInference::process(const float* samples, size_t count, const ResultCallback& callback) {
+    MP_TRACE_SCOPE("FeatureInference::process");
+    callback_ = &callback;
+    extractor_.process(samples, count, on_frame_);
+    callback_ = nullptr;
+}
+
+void FeatureInference::reset() {
+    extractor_.reset();
+    frames_ = 0;
+}
+
+} // namespace media_pipeline
@@ -0,0 +1,312 @@
+#include "media_pipeline/feature_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace media_pipeline {
+namespace feature_codec {
+
+namespace {
+
+constexpr size_t kBodyHeaderSize = 6;
+constexpr float kRangeMargin = 0.25f;  // Headroom on each side of the observed range
+constexpr float kMinSpan = 1e-6f;
+
+void putU16(std::string& out, uint16_t value) {
+    out += static_cast<char>(value >> 8);
+    out += static_cast<char>(value & 0xFF);
+}
+
+void putF32(std::string& out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out += static_cast<char>((bits >> shift) & 0xFF);
+    }
+}
+
+void putVarint(std::string& out, int32_t value) {
+    uint32_t zigzag = (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    while (zigzag >= 0x80) {
+        out += static_cast<char>((zigzag & 0x7F) | 0x80);
+        zigzag >>= 7;
+    }
+    out += static_cast<char>(zigzag);
+}
+
+uint16_t getU16(const uint8_t* data) {
+    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+float getF32(const uint8_t* data) {
+    uint32_t bits = (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+                    (static_cast<uint32_t>(data[2]) << 8) | data[3];
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool getVarint(const uint8_t*& data, const uint8_t* end, int32_t& value) {
+    uint32_t zigzag = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (data == end) {
+            return false;
+        }
+        uint8_t byte = *data++;
+        zigzag |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            value = static_cast<int32_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+Encoder::Encoder(int bits, int keyframe_interval)
+    : bits_(bits == 8 ? 8 : 16)
+    , keyframe_interval_(std::max(1, keyframe_interval))
+    , max_value_(bits_ == 8 ? 127 : 32767)
+    , sequence_(0)
+    , frames_since_keyframe_(0)
+    , force_keyframe_(true) {
+}
+
+void Encoder::resetRanges(const float* values, size_t count) {
+    offset_.assign(count, 0.0f);
+    scale_.assign(count, 1.0f);
+    span_.assign(count, 0.0f);
+    observed_min_.assign(count, 0.0f);
+    observed_max_.assign(count, 0.0f);
+    overflowed_.assign(count, false);
+    previous_.assign(count, 0);
+
+    // No history yet: a span the size of the value, widened on the first overflow
+    for (size_t i = 0; i < count; ++i) {
+        float value = std::isfinite(values[i]) ? values[i] : 0.0f;
+        span_[i] = std::max(std::fabs(value), 1.0f);
+        offset_[i] = value;
+        scale_[i] = span_[i] / (2.0f * static_cast<float>(max_value_));
+        observed_min_[i] = value;
+        observed_max_[i] = value;
+    }
+}
+
+void Encoder::rerange(size_t i, float value, bool shrink, bool grow) {
+    float low = std::min(value, observed_min_[i]);
+    float high = std::max(value, observed_max_[i]);
+
+    // Cover what was seen since the last keyframe plus headroom; only a full
+    // interval of history may shrink a range (by at most half), and a range
+    // that overflowed at least doubles
+    float span = std::max((high - low) * (1.0f + 2.0f * kRangeMargin), shrink ? span_[i] * 0.5f : span_[i]);
+    if (grow) {
+        span = std::max(span, span_[i] * 2.0f);
+    }
+    span = std::max(span, std::fabs(value) * kMinSpan + kMinSpan);
+
+    span_[i] = span;
+    offset_[i] = 0.5f * (low + high);
+    scale_[i] = span / (2.0f * static_cast<float>(max_value_));
+}
+
+int32_t Encoder::quantize(size_t i, float value) const {
+    long q = std::lrint((value - offset_[i]) / scale_[i]);
+    return static_cast<int32_t>(std::max<long>(-max_value_, std::min<long>(max_value_, q)));
+}
+
+void Encoder::putValue(std::string& out, int32_t value) const {
+    if (bits_ == 16) {
+        putU16(out, static_cast<uint16_t>(static_cast<int16_t>(value)));
+    } else {
+        out += static_cast<char>(static_cast<int8_t>(value));
+    }
+}
+
+bool Encoder::encode(const float* values, size_t count, std::string& out) {
+    if (!values || count == 0 || count > kMaxDims) {
+        return false;
+    }
+
+    bool periodic = frames_since_keyframe_ >= keyframe_interval_;
+    bool keyframe = force_keyframe_ || count != offset_.size() || periodic;
+    if (count != offset_.size()) {
+        resetRanges(values, count);
+    }
+
+    // Quantize against the current ranges, noting dimensions that overflow
+    std::vector<int32_t> quantized(count);
+    std::vector<uint16_t> updated;
+    for (size_t i = 0; i < count; ++i) {
+        float value = std::isfinite(values[i]) ? values[i] : offset_[i];
+        long q = std::lrint((value - offset_[i]) / scale_[i]);
+        if (q > max_value_ || q < -max_value_) {
+            overflowed_[i] = true;
+            updated.push_back(static_cast<uint16_t>(i));
+        }
+        quantized[i] = static_cast<int32_t>(q);
+    }
+
+    // A few overflowing dimensions get a new range inside the delta frame;
+    // past the point where that costs more than a keyframe, send a keyframe
+    if (updated.size() > std::min<size_t>(count / 2, kMaxRangeUpdates)) {
+        keyframe = true;
+    }
+
+    if (keyframe) {
+        for (size_t i = 0; i < count; ++i) {
+            float value = std::isfinite(values[i]) ? values[i] : offset_[i];
+            rerange(i, value, periodic, overflowed_[i]);
+            quantized[i] = quantize(i, value);
+            observed_min_[i] = value;
+            observed_max_[i] = value;
+            overflowed_[i] = false;
+        }
+        updated.clear();
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            float value = std::isfinite(values[i]) ? values[i] : offset_[i];
+            observed_min_[i] = std::min(observed_min_[i], value);
+            observed_max_[i] = std::max(observed_max_[i], value);
+        }
+        for (uint16_t i : updated) {
+            float value = std::isfinite(values[i]) ? values[i] : offset_[i];
+            rerange(i, value, false, true);
+            quantized[i] = quantize(i, value);
+            overflowed_[i] = false;
+        }
+    }
+
+    uint8_t flags = (keyframe ? kFlagKeyframe : 0) | (bits_ == 16 ? kFlag16Bit : 0) |
+                    (updated.empty() ? 0 : kFlagRangeUpdates);
+    out += static_cast<char>(flags);
+    out += '\0';
+    putU16(out, static_cast<uint16_t>(count));
+    putU16(out, sequence_);
+
+    if (keyframe) {
+        for (size_t i = 0; i < count; ++i) {
+            putF32(out, offset_[i]);
+            putF32(out, scale_[i]);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            putValue(out, quantized[i]);
+        }
+    } else {
+        // Re-ranged dimensions carry a zero delta and their new absolute value below
+        size_t next_update = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (next_update < updated.size() && updated[next_update] == i) {
+                putVarint(out, 0);
+                next_update++;
+            } else {
+                putVarint(out, quantized[i] - previous_[i]);
+            }
+        }
+        if (!updated.empty()) {
+            out += static_cast<char>(updated.size());
+            for (uint16_t i : updated) {
+                putU16(out, i);
+                putF32(out, offset_[i]);
+                putF32(out, scale_[i]);
+                putValue(out, quantized[i]);
+            }
+        }
+    }
+
+    previous_.swap(quantized);
+    sequence_++;
+    frames_since_keyframe_ = keyframe ? 1 : frames_since_keyframe_ + 1;
+    force_keyframe_ = false;
+    return true;
+}
+
+Decoder::Decoder()
+    : has_keyframe_(false)
+    , next_sequence_(0)
+    , decoded_count_(0)
+    , skipped_count_(0) {
+}
+
+bool Decoder::decode(const char* data, size_t length, std::vector<float>& values) {
+    if (length < kBodyHeaderSize) {
+        return false;
+    }
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* end = bytes + length;
+    uint8_t flags = bytes[0];
+    size_t dims = getU16(bytes + 2);
+    uint16_t sequence = getU16(bytes + 4);
+    const uint8_t* cursor = bytes + kBodyHeaderSize;
+    if (dims == 0 || dims > kMaxDims) {
+        return false;
+    }
+
+    if (flags & kFlagKeyframe) {
+        size_t width = (flags & kFlag16Bit) ? 2 : 1;
+        if (static_cast<size_t>(end - cursor) < dims * (8 + width)) {
+            return false;
+        }
+        offset_.resize(dims);
+        scale_.resize(dims);
+        previous_.resize(dims);
+        for (size_t i = 0; i < dims; ++i, cursor += 8) {
+            offset_[i] = getF32(cursor);
+            scale_[i] = getF32(cursor + 4);
+        }
+        for (size_t i = 0; i < dims; ++i, cursor += width) {
+            previous_[i] = width == 2 ? static_cast<int16_t>(getU16(cursor)) : static_cast<int8_t>(*cursor);
+        }
+        has_keyframe_ = true;
+    } else {
+        if (!has_keyframe_ || dims != previous_.size() || sequence != next_sequence_) {
+            has_keyframe_ = false;  // Reference lost: wait for the next keyframe
+            skipped_count_++;
+            return false;
+        }
+        for (size_t i = 0; i < dims; ++i) {
+            int32_t delta;
+            if (!getVarint(cursor, end, delta)) {
+                has_keyframe_ = false;
+                return false;
+            }
+            previous_[i] += delta;
+        }
+
+        if (flags & kFlagRangeUpdates) {
+            size_t width = (flags & kFlag16Bit) ? 2 : 1;
+            if (cursor == end) {
+                has_keyframe_ = false;
+                return false;
+            }
+            size_t updates = *cursor++;
+            if (static_cast<size_t>(end - cursor) < updates * (10 + width)) {
+                has_keyframe_ = false;
+                return false;
+            }
+            for (size_t u = 0; u < updates; ++u, cursor += 10 + width) {
+                size_t i = getU16(cursor);
+                if (i >= dims) {
+                    has_keyframe_ = false;
+                    return false;
+                }
+                offset_[i] = getF32(cursor + 2);
+                scale_[i] = getF32(cursor + 6);
+                previous_[i] = width == 2 ? static_cast<int16_t>(getU16(cursor + 10)) : static_cast<int8_t>(cursor[10]);
+            }
+        }
+    }
+
+    next_sequence_ = static_cast<uint16_t>(sequence + 1);
+    values.resize(dims);
+    for (size_t i = 0; i < dims; ++i) {
+        values[i] = offset_[i] + static_cast<float>(previous_[i]) * scale_[i];
+    }
+    decoded_count_++;
+    return true;
+}
+
+} // namespace feature_codec
+} // namespace media_pipeline
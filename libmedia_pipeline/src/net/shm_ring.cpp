@@ -0,0 +1,368 @@
+#include "media_pipeline/shm_ring.h"
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <new>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace media_pipeline {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x4F534352;  // "OSCR"
+constexpr uint32_t kVersion = 2;         // 2: writer_lock holds the owner's pid
+constexpr size_t kHeaderSize = 4096;      // Data region starts on its own page
+constexpr size_t kMinCapacity = 64 * 1024;
+constexpr uint32_t kOwnerCheckSpins = 1 << 14;  // Spins between liveness checks of the lock owner
+
+bool isPath(const std::string& name) {
+    return name.find('/', 1) != std::string::npos;
+}
+
+std::string shmName(const std::string& name) {
+    return name[0] == '/' ? name : "/" + name;
+}
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = kMinCapacity;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Only ESRCH proves the process is gone; EPERM means it exists under another user
+bool processGone(uint32_t pid) {
+    return kill(static_cast<pid_t>(pid), 0) < 0 && errno == ESRCH;
+}
+
+#if defined(__linux__) || defined(__ANDROID__)
+// Shared (not FUTEX_PRIVATE) operations: the word lives in a cross-process mapping
+void futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms) {
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+#endif
+
+int openBacking(const std::string& name, bool create, std::string& error) {
+    int fd;
+    if (isPath(name)) {
+        fd = create ? open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666)
+                    : open(name.c_str(), O_RDWR | O_CLOEXEC);
+    } else {
+#if defined(__ANDROID__)
+        error = "shm_open is unavailable on Android; use a file path such as /data/local/tmp/osc";
+        return -1;
+#else
+        if (create) {
+            shm_unlink(shmName(name).c_str());  // Replace a ring left by a crashed receiver
+        }
+        fd = shm_open(shmName(name).c_str(), create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0666);
+#endif
+    }
+    if (fd < 0) {
+        error = std::string("cannot open ") + name + ": " + std::strerror(errno);
+    }
+    return fd;
+}
+
+void removeBacking(const std::string& name) {
+    if (isPath(name)) {
+        unlink(name.c_str());
+    } else {
+#if !defined(__ANDROID__)
+        shm_unlink(shmName(name).c_str());
+#endif
+    }
+}
+
+} // namespace
+
+struct ShmRing::Header {
+    std::atomic<uint32_t> magic;          // Stored last, with release
+    uint32_t version;
+    uint64_t capacity;
+    std::atomic<uint32_t> closed;
+    std::atomic<uint32_t> writer_lock;    // Owner's pid, 0 when free
+    std::atomic<uint64_t> dropped;
+
+    alignas(64) std::atomic<uint64_t> head;   // Written by writers
+    alignas(64) std::atomic<uint64_t> tail;   // Written by the reader
+    alignas(64) std::atomic<uint32_t> wake_seq;
+    std::atomic<uint32_t> reader_waiting;
+};
+
+static_assert(sizeof(ShmRing::Header) <= kHeaderSize, "ring header must fit its page");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared atomics must be lock-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared atomics must be lock-free");
+
+ShmRing::~ShmRing() {
+    if (header_ && owner_) {
+        header_->closed.store(1, std::memory_order_release);
+        wakeReader();
+        removeBacking(name_);
+    }
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+    }
+}
+
+std::unique_ptr<ShmRing> ShmRing::create(const std::string& name, size_t capacity, std::string& error) {
+    if (name.empty()) {
+        error = "empty shared memory name";
+        return nullptr;
+    }
+
+    capacity = roundUpPowerOfTwo(capacity);
+    int fd = openBacking(name, true, error);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    size_t size = kHeaderSize + capacity;
+    if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        error = std::string("cannot size ") + name + ": " + std::strerror(errno);
+        close(fd);
+        removeBacking(name);
+        return nullptr;
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        error = std::string("cannot map ") + name + ": " + std::strerror(errno);
+        removeBacking(name);
+        return nullptr;
+    }
+
+    std::unique_ptr<ShmRing> ring(new ShmRing());
+    ring->name_ = name;
+    ring->owner_ = true;
+    ring->mapping_ = mapping;
+    ring->mapping_size_ = size;
+    ring->header_ = new (mapping) Header();
+    ring->data_ = static_cast<char*>(mapping) + kHeaderSize;
+    ring->capacity_ = capacity;
+
+    Header* header = ring->header_;
+    header->version = kVersion;
+    header->capacity = capacity;
+    header->closed.store(0, std::memory_order_relaxed);
+    header->writer_lock.store(0, std::memory_order_relaxed);
+    header->dropped.store(0, std::memory_order_relaxed);
+    header->head.store(0, std::memory_order_relaxed);
+    header->tail.store(0, std::memory_order_relaxed);
+    header->wake_seq.store(0, std::memory_order_relaxed);
+    header->reader_waiting.store(0, std::memory_order_relaxed);
+
+    // Publish last: writers treat a ring without the magic as not ready
+    header->magic.store(kMagic, std::memory_order_release);
+    return ring;
+}
+
+std::unique_ptr<ShmRing> ShmRing::attach(const std::string& name, std::string& error) {
+    if (name.empty()) {
+        error = "empty shared memory name";
+        return nullptr;
+    }
+
+    int fd = openBacking(name, false, error);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < kHeaderSize + kMinCapacity) {
+        error = name + " is not a shared memory ring";
+        close(fd);
+        return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        error = std::string("cannot map ") + name + ": " + std::strerror(errno);
+        return nullptr;
+    }
+
+    auto* header = static_cast<Header*>(mapping);
+    if (header->magic.load(std::memory_order_acquire) != kMagic || header->version != kVersion || kHeaderSize + header->capacity != size ||
+        (header->capacity & (header->capacity - 1)) != 0) {
+        error = name + " is not a compatible shared memory ring";
+        munmap(mapping, size);
+        return nullptr;
+    }
+
+    std::unique_ptr<ShmRing> ring(new ShmRing());
+    ring->name_ = name;
+    ring->owner_ = false;
+    ring->mapping_ = mapping;
+    ring->mapping_size_ = size;
+    ring->header_ = header;
+    ring->data_ = static_cast<char*>(mapping) + kHeaderSize;
+    ring->capacity_ = static_cast<size_t>(header->capacity);
+    return ring;
+}
+
+bool ShmRing::write(const char* data, size_t length, uint64_t timestamp_ns) {
+    size_t record = recordSize(length);
+    if (record > capacity_ / 2 || isClosed()) {
+        header_->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    lockWriters();
+
+    uint64_t head = header_->head.load(std::memory_order_relaxed);
+    uint64_t tail = header_->tail.load(std::memory_order_acquire);
+    size_t index = static_cast<size_t>(head & (capacity_ - 1));
+    size_t contiguous = capacity_ - index;
+    size_t needed = record + (contiguous < record ? contiguous : 0);
+
+    if (needed > capacity_ - static_cast<size_t>(head - tail)) {
+        unlockWriters();
+        header_->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (contiguous < record) {
+        // Not enough room before the end: mark the remainder as skipped
+        auto* wrap = reinterpret_cast<RecordHeader*>(data_ + index);
+        wrap->length = 0;
+        wrap->flags = kWrapFlag;
+        wrap->timestamp_ns = 0;
+        head += contiguous;
+        index = 0;
+    }
+
+    auto* header = reinterpret_cast<RecordHeader*>(data_ + index);
+    header->length = static_cast<uint32_t>(length);
+    header->flags = 0;
+    header->timestamp_ns = timestamp_ns;
+    std::memcpy(header + 1, data, length);
+
+    header_->head.store(head + record, std::memory_order_release);
+    unlockWriters();
+
+    // Dekker pairing with waitForData(): publish head, then look for a sleeper
+    header_->wake_seq.fetch_add(1, std::memory_order_seq_cst);
+    if (header_->reader_waiting.load(std::memory_order_seq_cst) != 0) {
+#if defined(__linux__) || defined(__ANDROID__)
+        futexWake(&header_->wake_seq);
+#endif
+    }
+    return true;
+}
+
+// Writers are rare and short; an uncontended compare-exchange is all this
+// costs. A writer killed while holding the lock would wedge every other
+// writer, so a waiter that has spun for a while checks that the owner is
+// still alive and takes the lock over if not. That is safe because head
+// only moves once a record is complete: whatever the dead writer left past
+// head is overwritten by the next record.
+void ShmRing::lockWriters() {
+    const uint32_t self = static_cast<uint32_t>(getpid());
+    uint32_t spins = 0;
+    while (true) {
+        uint32_t owner = 0;
+        if (header_->writer_lock.compare_exchange_weak(owner, self, std::memory_order_acquire,
+                                                       std::memory_order_relaxed)) {
+            return;
+        }
+        if (owner != 0 && owner != self && ++spins % kOwnerCheckSpins == 0 && processGone(owner) &&
+            header_->writer_lock.compare_exchange_strong(owner, self, std::memory_order_acquire,
+                                                         std::memory_order_relaxed)) {
+            return;
+        }
+        cpuRelax();
+    }
+}
+
+void ShmRing::unlockWriters() {
+    header_->writer_lock.store(0, std::memory_order_release);
+}
+
+bool ShmRing::waitForData(int timeout_ms, int spin_iterations) {
+    for (int i = 0; i < spin_iterations; ++i) {
+        if (hasData()) {
+            return true;
+        }
+        cpuRelax();
+    }
+
+#if defined(__linux__) || defined(__ANDROID__)
+    uint32_t seq = header_->wake_seq.load(std::memory_order_seq_cst);
+    header_->reader_waiting.store(1, std::memory_order_seq_cst);
+    if (!hasData() && !isClosed()) {
+        // Returns immediately if a writer bumped wake_seq after we read it
+        futexWait(&header_->wake_seq, seq, timeout_ms);
+    }
+    header_->reader_waiting.store(0, std::memory_order_relaxed);
+#else
+    // No futex: poll at 50 us granularity
+    struct timespec nap = {0, 50000};
+    for (int waited_us = 0; waited_us < timeout_ms * 1000 && !hasData() && !isClosed(); waited_us += 50) {
+        nanosleep(&nap, nullptr);
+    }
+#endif
+
+    return hasData();
+}
+
+void ShmRing::wakeReader() {
+    header_->wake_seq.fetch_add(1, std::memory_order_seq_cst);
+#if defined(__linux__) || defined(__ANDROID__)
+    futexWake(&header_->wake_seq);
+#endif
+}
+
+bool ShmRing::isClosed() const {
+    return header_->closed.load(std::memory_order_acquire) != 0;
+}
+
+uint64_t ShmRing::getDroppedCount() const {
+    return header_->dropped.load(std::memory_order_relaxed);
+}
+
+bool ShmRing::hasData() const {
+    return header_->head.load(std::memory_order_acquire) != header_->tail.load(std::memory_order_relaxed);
+}
+
+uint64_t ShmRing::loadHead() const {
+    return header_->head.load(std::memory_order_acquire);
+}
+
+uint64_t ShmRing::loadTail() const {
+    return header_->tail.load(std::memory_order_relaxed);
+}
+
+void ShmRing::storeTail(uint64_t tail) {
+    header_->tail.store(tail, std::memory_order_release);
+}
+
+} // namespace media_pipeline
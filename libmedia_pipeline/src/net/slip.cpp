@@ -0,0 +1,27 @@
+#include "media_pipeline/slip.h"
+
+namespace media_pipeline {
+namespace slip {
+
+void encode(const char* data, size_t length, std::string& out) {
+    out.reserve(out.size() + maxEncodedSize(length));
+    out.push_back(static_cast<char>(END));
+
+    size_t start = 0;
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t byte = static_cast<uint8_t>(data[i]);
+        if (byte != END && byte != ESC) {
+            continue;
+        }
+        out.append(data + start, i - start);
+        out.push_back(static_cast<char>(ESC));
+        out.push_back(static_cast<char>(byte == END ? ESC_END : ESC_ESC));
+        start = i + 1;
+    }
+    out.append(data + start, length - start);
+
+    out.push_back(static_cast<char>(END));
+}
+
+} // namespace slip
+} // namespace media_pipeline
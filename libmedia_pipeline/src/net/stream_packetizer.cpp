@@ -0,0 +1,177 @@
+#include "media_pipeline/stream_packetizer.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <unistd.h>
+
+namespace media_pipeline {
+
+namespace {
+
+constexpr int kSendBufferBytes = 1024 * 1024;  // One large I-frame in flight
+
+} // namespace
+
+StreamPacketizer::StreamPacketizer(size_t max_packet_size, size_t batch_packets)
+    : socket_fd_(-1)
+    , dest_len_(0)
+    , max_payload_(max_packet_size > stream_packet::kHeaderSize ? max_packet_size - stream_packet::kHeaderSize : 1)
+    , batch_packets_(batch_packets > 0 ? batch_packets : 1)
+    , next_sequence_(1)
+    , header_arena_(batch_packets_ * stream_packet::kHeaderSize)
+    , iovecs_(batch_packets_ * 2)
+    , messages_(batch_packets_)
+    , frame_count_(0)
+    , packet_count_(0)
+    , error_count_(0) {
+    std::memset(&dest_, 0, sizeof(dest_));
+}
+
+StreamPacketizer::~StreamPacketizer() {
+    if (socket_fd_ >= 0) {
+        close(socket_fd_);
+    }
+}
+
+bool StreamPacketizer::setDestination(const std::string& host, int port, std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    sockaddr_storage dest;
+    std::memset(&dest, 0, sizeof(dest));
+    socklen_t dest_len;
+    auto* in = reinterpret_cast<sockaddr_in*>(&dest);
+    auto* in6 = reinterpret_cast<sockaddr_in6*>(&dest);
+    if (inet_pton(AF_INET, host.c_str(), &in->sin_addr) == 1) {
+        in->sin_family = AF_INET;
+        in->sin_port = htons(static_cast<uint16_t>(port));
+        dest_len = sizeof(sockaddr_in);
+    } else if (inet_pton(AF_INET6, host.c_str(), &in6->sin6_addr) == 1) {
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(static_cast<uint16_t>(port));
+        dest_len = sizeof(sockaddr_in6);
+    } else {
+        error = "invalid address " + host;
+        return false;
+    }
+
+    if (socket_fd_ >= 0 && dest.ss_family != dest_.ss_family) {
+        close(socket_fd_);
+        socket_fd_ = -1;
+    }
+    if (socket_fd_ < 0) {
+        socket_fd_ = socket(dest.ss_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (socket_fd_ < 0) {
+            error = std::string("socket failed: ") + std::strerror(errno);
+            return false;
+        }
+        int sndbuf = kSendBufferBytes;
+        setsockopt(socket_fd_, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    }
+
+    dest_ = dest;
+    dest_len_ = dest_len;
+    return true;
+}
+
+int StreamPacketizer::sendFrame(const uint8_t* data, size_t size, uint64_t timestamp) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (socket_fd_ < 0 || !data || size == 0) {
+        return -1;
+    }
+
+    size_t total = (size + max_payload_ - 1) / max_payload_;
+    if (total > 0xFFFF) {
+        error_count_++;
+        return -1;
+    }
+
+    stream_packet::Header header;
+    header.total = static_cast<uint16_t>(total);
+    header.timestamp = timestamp;
+
+    size_t sent = 0;
+    while (sent < total) {
+        size_t batch = std::min(batch_packets_, total - sent);
+        for (size_t i = 0; i < batch; ++i) {
+            size_t index = sent + i;
+            size_t offset = index * max_payload_;
+            size_t length = std::min(max_payload_, size - offset);
+
+            header.sequence = next_sequence_ + index;
+            header.index = static_cast<uint16_t>(index);
+            header.size = static_cast<uint32_t>(length);
+            uint8_t* slot = header_arena_.data() + i * stream_packet::kHeaderSize;
+            stream_packet::write(header, slot);
+
+            iovecs_[2 * i].iov_base = slot;
+            iovecs_[2 * i].iov_len = stream_packet::kHeaderSize;
+            iovecs_[2 * i + 1].iov_base = const_cast<uint8_t*>(data + offset);
+            iovecs_[2 * i + 1].iov_len = length;
+
+            msghdr& message = messageHeader(i);
+            std::memset(&message, 0, sizeof(msghdr));
+            message.msg_name = &dest_;
+            message.msg_namelen = dest_len_;
+            message.msg_iov = &iovecs_[2 * i];
+            message.msg_iovlen = 2;
+        }
+
+        if (!sendBatch(batch)) {
+            error_count_++;
+            next_sequence_ += total;  // Keep frame keys unique even for a partial frame
+            packet_count_ += sent;
+            return -1;
+        }
+        sent += batch;
+    }
+
+    next_sequence_ += total;
+    frame_count_++;
+    packet_count_ += total;
+    return static_cast<int>(total);
+}
+
+#ifdef __linux__
+
+msghdr& StreamPacketizer::messageHeader(size_t index) {
+    return messages_[index].msg_hdr;
+}
+
+bool StreamPacketizer::sendBatch(size_t count) {
+    size_t done = 0;
+    while (done < count) {
+        int result = sendmmsg(socket_fd_, &messages_[done], static_cast<unsigned int>(count - done), 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        done += static_cast<size_t>(result);  // Partial batch: resend the remainder
+    }
+    return true;
+}
+
+#else  // !__linux__
+
+msghdr& StreamPacketizer::messageHeader(size_t index) {
+    return messages_[index];
+}
+
+bool StreamPacketizer::sendBatch(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        while (sendmsg(socket_fd_, &messages_[i], 0) < 0) {
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+#endif
+
+} // namespace media_pipeline
@@ -0,0 +1,285 @@
+#include "media_pipeline/osc_message.h"
+#include "media_pipeline/feature_codec.h"
+#include "media_pipeline/trace.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace media_pipeline {
+
+namespace {
+
+uint64_t readBigEndian64(const char* data) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value = (value << 8) | static_cast<uint8_t>(data[i]);
+    }
+    return value;
+}
+
+uint32_t readBigEndian32(const char* data) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value = (value << 8) | static_cast<uint8_t>(data[i]);
+    }
+    return value;
+}
+
+// Same set as isspace() in the C locale, which istream extraction used
+bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// "-?d{1,4}.ddd" exactly as OSCFormatter prints it. q / 1000 computed in
+// double and rounded to float matches strtof for every such value (checked
+// exhaustively), so the common case needs no strtof call.
+bool parseFixedPoint(const char* p, const char* end, float& value) {
+    bool negative = *p == '-';
+    if (negative) {
+        ++p;
+    }
+    const char* dot = p;
+    uint32_t q = 0;
+    while (dot < end && *dot >= '0' && *dot <= '9' && dot - p < 5) {
+        q = q * 10 + static_cast<uint32_t>(*dot - '0');
+        ++dot;
+    }
+    if (dot == p || dot - p > 4 || end - dot != 4 || *dot != '.') {
+        return false;
+    }
+    for (int i = 1; i <= 3; ++i) {
+        if (dot[i] < '0' || dot[i] > '9') {
+            return false;
+        }
+        q = q * 10 + static_cast<uint32_t>(dot[i] - '0');
+    }
+    float magnitude = static_cast<float>(static_cast<double>(q) / 1000.0);
+    value = negative ? -magnitude : magnitude;
+    return true;
+}
+
+// Whitespace-separated floats from [p, end); end must not be past the
+// string's terminator. Tokens that do not start with a number, or are out
+// of float range, are skipped (std::stof threw for those).
+void parseFloats(const char* p, const char* end, std::vector<float>& values) {
+    while (p < end) {
+        while (p < end && isSpace(*p)) {
+            ++p;
+        }
+        const char* token_end = p;
+        while (token_end < end && !isSpace(*token_end)) {
+            ++token_end;
+        }
+        if (token_end == p) {
+            break;
+        }
+
+        float value;
+        if (parseFixedPoint(p, token_end, value)) {
+            values.push_back(value);
+        } else {
+            char* parsed_end;
+            errno = 0;
+            value = std::strtof(p, &parsed_end);
+            if (parsed_end != p && errno != ERANGE) {
+                values.push_back(value);
+            }
+        }
+        p = token_end;
+    }
+}
+
+} // namespace
+
+OSCParser::OSCMessage OSCParser::parseMessage(const std::string& data) {
+    MP_TRACE_SCOPE("OSCParser::parseMessage");
+    OSCMessage msg;
+    msg.valid = false;
+    msg.type = UNKNOWN;
+    msg.encodedOffset = 0;
+    msg.arrival_ns = 0;
+
+    const char* begin = data.c_str();
+    const char* end = begin + data.size();
+    const char* address = begin;
+    while (address < end && isSpace(*address)) {
+        ++address;
+    }
+    const char* address_end = address;
+    while (address_end < end && !isSpace(*address_end)) {
+        ++address_end;
+    }
+    if (address_end == address) {
+        return msg;
+    }
+
+    msg.address.assign(address, address_end);
+    msg.type = getMessageType(msg.address);
+
+    switch (msg.type) {
+        case AUDIO:
+            parseFloats(address_end, end, msg.floatData);
+            msg.valid = !msg.floatData.empty();
+            break;
+
+        case TEXT:
+        case CONTROL: {
+            // Rest of the line, without the separating space
+            const char* text = address_end;
+            const char* text_end = static_cast<const char*>(std::memchr(text, '\n', end - text));
+            if (!text_end) {
+                text_end = end;
+            }
+            if (text < text_end && *text == ' ') {
+                ++text;
+            }
+            msg.textData.assign(text, text_end);
+            msg.valid = !msg.textData.empty();
+            break;
+        }
+
+        case ANALYSIS: {
+            // "<address> #q <binary>": quantized vector, decoded by the receiver
+            // against the address's delta reference
+            const std::string tag = std::string(" ") + feature_codec::kTag + " ";
+            size_t offset = static_cast<size_t>(address_end - begin);
+            if (data.compare(offset, tag.size(), tag) == 0) {
+                msg.encodedOffset = offset + tag.size();
+                msg.valid = data.size() > msg.encodedOffset;
+                break;
+            }
+            // Parse as float array (ML features)
+            parseFloats(address_end, end, msg.floatData);
+            msg.valid = !msg.floatData.empty();
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return msg;
+}
+
+bool OSCParser::isBundle(const char* data, size_t length) {
+    return length >= 16 && std::memcmp(data, "#bundle", 8) == 0;
+}
+
+bool OSCParser::parseBundle(const char* data, size_t length, OSCBundle& bundle) {
+    if (!isBundle(data, length)) {
+        return false;
+    }
+
+    bundle.timetag = readBigEndian64(data + 8);
+    bundle.elements.clear();
+
+    size_t offset = 16;
+    while (offset < length) {
+        if (length - offset < 4) {
+            return false;
+        }
+        uint32_t size = readBigEndian32(data + offset);
+        offset += 4;
+        if (size == 0 || size > length - offset) {
+            return false;
+        }
+        bundle.elements.emplace_back(data + offset, size);
+        offset += size;
+    }
+    return true;
+}
+
+uint64_t OSCParser::timetagToUnixNs(uint64_t timetag) {
+    constexpr uint64_t kNtpToUnixSeconds = 2208988800ULL;  // 1900-01-01 to 1970-01-01
+    uint64_t seconds = timetag >> 32;
+    uint64_t fraction = timetag & 0xFFFFFFFFULL;
+    if (seconds < kNtpToUnixSeconds) {
+        return 0;
+    }
+    return (seconds - kNtpToUnixSeconds) * 1000000000ULL + ((fraction * 1000000000ULL) >> 32);
+}
+
+OSCParser::MessageType OSCParser::getMessageType(const std::string& address) {
+    // TouchDesigner-style channel routing; control first, its payload names streams
+    if (address.compare(0, 9, "/control/") == 0) {
+        return CONTROL;
+    } else if (address.find("/chan1/audio") == 0 ||
+        address.find("/audio/") == 0 ||
+        address.find("audio") != std::string::npos) {
+        return AUDIO;
+    } else if (address.find("/chan2/text") == 0 ||
+               address.find("/text/") == 0 ||
+               address.find("text") != std::string::npos) {
+        return TEXT;
+    } else if (address.find("/chan3/analysis") == 0 ||
+               address.find("/analysis/") == 0 ||
+               address.find("/features/") == 0 ||
+               address.find("analysis") != std::string::npos ||
+               address.find("features") != std::string::npos) {
+        return ANALYSIS;
+    }
+    return UNKNOWN;
+}
+
+std::string OSCParser::streamAddress(const std::string& address) {
+    size_t underscore = address.rfind('_');
+    if (underscore == std::string::npos || underscore + 1 == address.size() || underscore == 0) {
+        return address;
+    }
+    for (size_t i = underscore + 1; i < address.size(); ++i) {
+        if (address[i] < '0' || address[i] > '9') {
+            return address;
+        }
+    }
+    return address.substr(0, underscore);
+}
+
+void OSCFormatter::appendFloatMessage(std::string& out, const std::string& address, int chunk,
+                                      const float* values, size_t count) {
+    out += address;
+    if (chunk >= 0) {
+        out += '_';
+        out += std::to_string(chunk);
+    }
+    out += ' ';
+    for (size_t i = 0; i < count; ++i) {
+        appendFloat(out, values[i]);
+    }
+}
+
+void OSCFormatter::appendFloat(std::string& out, float value) {
+    // Exact: a float times 1000 fits a double's mantissa, and llrint rounds
+    // half to even like printf does on an exact tie
+    double magnitude = std::fabs(static_cast<double>(value));
+    if (magnitude < 1e9) {
+        long long q = std::llrint(magnitude * 1000.0);
+        char digits[24];
+        char* p = digits + sizeof(digits);
+        *--p = ' ';
+        for (int i = 0; i < 3; ++i, q /= 10) {
+            *--p = static_cast<char>('0' + q % 10);
+        }
+        *--p = '.';
+        do {
+            *--p = static_cast<char>('0' + q % 10);
+            q /= 10;
+        } while (q > 0);
+        if (std::signbit(value)) {
+            *--p = '-';
+        }
+        out.append(p, digits + sizeof(digits) - p);
+        return;
+    }
+
+    // NaN, infinities and huge values
+    char buffer[16];
+    int ret = std::snprintf(buffer, sizeof(buffer), "%.3f ", value);
+    if (ret > 0 && ret < static_cast<int>(sizeof(buffer))) {
+        out += buffer;
+    }
+}
+
+} // namespace media_pipeline
@@ -0,0 +1,517 @@
+#include "media_pipeline/osc_sender.h"
+#include "media_pipeline/dsp_kernels.h"
+#include "media_pipeline/log.h"
+#include "media_pipeline/osc_message.h"
+#include "media_pipeline/slip.h"
+#include "media_pipeline/trace.h"
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#define LOG_TAG "OSCSender"
+#define LOGI(...) MP_LOGI(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) MP_LOGE(LOG_TAG, __VA_ARGS__)
+
+namespace media_pipeline {
+
+namespace {
+
+constexpr size_t kMaxTcpQueueBytes = 1024 * 1024;  // Hard cap on the TCP backlog
+constexpr int kMaxIovecs = 64;                      // Frames gathered per sendmsg()
+constexpr int kTcpSendBufferBytes = 256 * 1024;
+constexpr auto kReconnectInterval = std::chrono::seconds(1);
+
+uint64_t realtimeNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+} // namespace
+
+OSCSender::OSCSender(const std::string& host, int port)
+    : host_(host)
+    , port_(port)
+    , socket_fd_(-1)
+    , is_connected_(false)
+    , default_address_("/audio/stream")
+    , transport_(Transport::UDP)
+    , tcp_fd_(-1)
+    , tcp_state_(TcpState::DISCONNECTED)
+    , tcp_queued_bytes_(0)
+    , latency_budget_(50)
+    , udp_fallback_active_(false)
+    , udp_fallback_count_(0)
+    , feature_bits_(16)
+    , feature_keyframe_interval_(50) {
+    connect();
+}
+
+OSCSender::~OSCSender() {
+    disconnect();
+}
+
+void OSCSender::sendAudio(const float* audio_data, int frame_count) {
+    MP_TRACE_SCOPE("OSCSender::sendAudio");
+    if (!audio_data || frame_count <= 0) {
+        return;
+    }
+
+    // Copy and clamp in one vectorized pass so formatting never sees out-of-range values
+    std::vector<float> data(audio_data, audio_data + frame_count);
+    dsp::hardClip(data.data(), data.size(), 1.0f);
+
+    // Send as OSC message with default address
+    std::lock_guard<std::mutex> lock(mutex_);
+    sendOSCMessage(default_address_, data);
+}
+
+void OSCSender::sendAudio(const std::string& address, const float* audio_data, int frame_count) {
+    MP_TRACE_SCOPE("OSCSender::sendAudio");
+    if (!audio_data || frame_count <= 0) {
+        return;
+    }
+
+    // Copy and clamp in one vectorized pass so formatting never sees out-of-range values
+    std::vector<float> data(audio_data, audio_data + frame_count);
+    dsp::hardClip(data.data(), data.size(), 1.0f);
+
+    // Send as OSC message with custom address
+    std::lock_guard<std::mutex> lock(mutex_);
+    sendOSCMessage(address, data);
+}
+
+void OSCSender::sendFeatures(const std::string& address, const float* features, int count) {
+    MP_TRACE_SCOPE("OSCSender::sendFeatures");
+    if (!features || count <= 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ready()) {
+        return;
+    }
+
+    if (feature_bits_ == 0) {
+        sendOSCMessage(address, std::vector<float>(features, features + count));
+        return;
+    }
+
+    auto it = feature_encoders_.find(address);
+    if (it == feature_encoders_.end()) {
+        it = feature_encoders_.emplace(address, feature_codec::Encoder(feature_bits_, feature_keyframe_interval_)).first;
+    }
+
+    std::string message;
+    message.reserve(address.size() + 8 + static_cast<size_t>(count) * 10);
+    message = address;
+    message += ' ';
+    message += feature_codec::kTag;
+    message += ' ';
+    if (!it->second.encode(features, static_cast<size_t>(count), message)) {
+        LOGE("Cannot encode %d features for %s", count, address.c_str());
+        return;
+    }
+    sendEncodedMessage(message);
+}
+
+void OSCSender::setFeatureEncoding(int bits, int keyframe_interval) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    feature_bits_ = (bits == 8 || bits == 16) ? bits : 0;
+    feature_keyframe_interval_ = keyframe_interval > 0 ? keyframe_interval : 1;
+    feature_encoders_.clear();  // New encoders start with a keyframe
+    LOGI("Feature encoding: %s, keyframe every %d frames",
+         feature_bits_ ? (feature_bits_ == 8 ? "8-bit delta" : "16-bit delta") : "text", feature_keyframe_interval_);
+}
+
+void OSCSender::updateDestination(const std::string& host, int port) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    disconnect();
+    host_ = host;
+    port_ = port;
+    connect();
+
+    // A new receiver has no reference for delta frames
+    for (auto& entry : feature_encoders_) {
+        entry.second.requestKeyframe();
+    }
+}
+
+void OSCSender::setTransport(Transport transport, int latency_budget_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latency_budget_ = std::chrono::milliseconds(latency_budget_ms > 0 ? latency_budget_ms : 1);
+    if (transport == transport_) {
+        return;
+    }
+
+    if (transport_ == Transport::SHARED_MEMORY) {
+        shm_ring_.reset();
+    }
+
+    transport_ = transport;
+    if (transport_ == Transport::TCP) {
+        last_connect_attempt_ = std::chrono::steady_clock::time_point();  // Connect on next send
+        LOGI("OSC transport: TCP to %s:%d (latency budget %d ms)", host_.c_str(), port_, latency_budget_ms);
+    } else if (transport_ == Transport::UDP) {
+        closeTcp(true);
+        LOGI("OSC transport: UDP to %s:%d", host_.c_str(), port_);
+    }
+}
+
+void OSCSender::setSharedMemoryDestination(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closeTcp(true);
+    shm_ring_.reset();
+    shm_name_ = name;
+    transport_ = Transport::SHARED_MEMORY;
+    last_attach_attempt_ = std::chrono::steady_clock::time_point();  // Attach on next send
+    LOGI("OSC transport: shared memory ring %s", name.c_str());
+}
+
+void OSCSender::setDefaultAddress(const std::string& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    default_address_ = address;
+    LOGI("Default OSC address set to: %s", address.c_str());
+}
+
+OSCSender::Transport OSCSender::getTransport() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return transport_;
+}
+
+bool OSCSender::isSharedMemoryAttached() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return shm_ring_ != nullptr;
+}
+
+bool OSCSender::isTcpConnected() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tcp_state_ == TcpState::CONNECTED;
+}
+
+uint64_t OSCSender::getUdpFallbackCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return udp_fallback_count_;
+}
+
+bool OSCSender::isReady() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ready();
+}
+
+bool OSCSender::ready() const {
+    return is_connected_ && socket_fd_ >= 0;
+}
+
+bool OSCSender::connect() {
+    disconnect(); // Ensure clean state
+
+    socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_fd_ < 0) {
+        LOGE("Failed to create UDP socket");
+        return false;
+    }
+
+    // For UDP, we don't need to explicitly connect
+    // We'll send to the destination each time
+    is_connected_ = true;
+
+    LOGI("OSC sender ready for %s:%d", host_.c_str(), port_);
+    return true;
+}
+
+void OSCSender::disconnect() {
+    closeTcp(false);
+    if (socket_fd_ >= 0) {
+        close(socket_fd_);
+        socket_fd_ = -1;
+    }
+    is_connected_ = false;
+}
+
+void OSCSender::sendOSCMessage(const std::string& address, const std::vector<float>& data) {
+    if (!ready() || data.empty()) {
+        return;
+    }
+
+    // Limit data size to prevent excessive memory allocation
+    if (data.size() > 4096) {
+        LOGE("Audio data too large: %zu samples", data.size());
+        return;
+    }
+
+    struct sockaddr_in dest_addr;
+    if (!resolveDestination(dest_addr)) {
+        LOGE("Invalid host address: %s", host_.c_str());
+        return;
+    }
+
+    // Free socket buffer space first so backlog age reflects what is really stuck
+    flushTcp();
+
+    // Send smaller chunks to reduce memory pressure and network load
+    const size_t chunk_size = OSCFormatter::kChunkSamples;
+    const size_t total_chunks = (data.size() + chunk_size - 1) / chunk_size;
+
+    // Limit number of chunks to prevent network flooding
+    if (total_chunks > 32) {
+        LOGE("Too many chunks required: %zu", total_chunks);
+        return;
+    }
+
+    for (size_t chunk = 0; chunk < total_chunks; ++chunk) {
+        size_t start_idx = chunk * chunk_size;
+        size_t end_idx = std::min(start_idx + chunk_size, data.size());
+
+        // Create message for this chunk with pre-allocated size
+        std::string message;
+        message.reserve(900); // Conservative estimate for 128 samples
+        OSCFormatter::appendFloatMessage(message, address, total_chunks > 1 ? static_cast<int>(chunk) : -1,
+                                         data.data() + start_idx, end_idx - start_idx);
+
+        // Send with error checking
+        if (!transmit(message, dest_addr)) {
+            LOGE("Failed to send OSC message chunk %zu: errno=%d", chunk, errno);
+            break;
+        }
+    }
+
+    // All chunks of this block leave in one gathered write
+    flushTcp();
+
+#ifdef DEBUG
+    static int message_count = 0;
+    if (++message_count % 100 == 0) { // Log every 100th message
+        LOGI("Sent OSC message #%d: %zu samples in %zu chunks",
+             message_count, data.size(), total_chunks);
+    }
+#endif
+}
+
+void OSCSender::sendEncodedMessage(const std::string& message) {
+    struct sockaddr_in dest_addr;
+    if (!resolveDestination(dest_addr)) {
+        LOGE("Invalid host address: %s", host_.c_str());
+        return;
+    }
+
+    flushTcp();
+    if (!transmit(message, dest_addr)) {
+        LOGE("Failed to send encoded message: errno=%d", errno);
+    }
+    flushTcp();
+}
+
+bool OSCSender::resolveDestination(sockaddr_in& dest_addr) const {
+    memset(&dest_addr, 0, sizeof(dest_addr));
+    dest_addr.sin_family = AF_INET;
+    dest_addr.sin_port = htons(port_);
+
+    // Use inet_pton for better address parsing
+    return inet_pton(AF_INET, host_.c_str(), &dest_addr.sin_addr) > 0;
+}
+
+bool OSCSender::transmit(const std::string& message, const sockaddr_in& dest_addr) {
+    MP_TRACE_SCOPE("OSCSender::transmit");
+    if (transport_ == Transport::TCP && tcpReady()) {
+        auto now = std::chrono::steady_clock::now();
+        if (!udp_fallback_active_ && !tcp_queue_.empty() &&
+            (tcp_queued_bytes_ > kMaxTcpQueueBytes || now - tcp_queue_.front().queued_at > latency_budget_)) {
+            udp_fallback_active_ = true;
+            LOGE("TCP backlog over budget (%zu bytes queued), falling back to UDP", tcp_queued_bytes_);
+        }
+
+        if (!udp_fallback_active_) {
+            QueuedFrame frame;
+            frame.message = message;
+            slip::encode(message.data(), message.size(), frame.encoded);
+            frame.offset = 0;
+            frame.queued_at = now;
+            tcp_queued_bytes_ += frame.encoded.size();
+            tcp_queue_.push_back(std::move(frame));
+            MP_TRACE_COUNTER("tcp_queued_bytes", tcp_queued_bytes_);
+            return true;
+        }
+        udp_fallback_count_++;
+    } else if (transport_ == Transport::SHARED_MEMORY && shmReady()) {
+        // A full ring counts the drop on the receiver side; never block the audio thread
+        shm_ring_->write(message.data(), message.size(), realtimeNs());
+        return true;
+    } else if (transport_ != Transport::UDP) {
+        udp_fallback_count_++;
+    }
+
+    ssize_t sent = sendto(socket_fd_, message.c_str(), message.length(), 0,
+                         (const struct sockaddr*)&dest_addr, sizeof(dest_addr));
+    return sent >= 0;
+}
+
+bool OSCSender::shmReady() {
+    if (shm_ring_ && shm_ring_->isClosed()) {
+        LOGI("Shared memory ring %s closed by receiver", shm_name_.c_str());
+        shm_ring_.reset();
+    }
+    if (shm_ring_) {
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_attach_attempt_ < kReconnectInterval) {
+        return false;
+    }
+    last_attach_attempt_ = now;
+
+    std::string error;
+    shm_ring_ = ShmRing::attach(shm_name_, error);
+    if (!shm_ring_) {
+        LOGE("Shared memory attach failed: %s", error.c_str());
+        return false;
+    }
+    LOGI("Attached to shared memory ring %s (%zu bytes)", shm_name_.c_str(), shm_ring_->getCapacity());
+    return true;
+}
+
+bool OSCSender::tcpReady() {
+    if (tcp_state_ == TcpState::DISCONNECTED) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_connect_attempt_ < kReconnectInterval) {
+            return false;
+        }
+        last_connect_attempt_ = now;
+        startTcpConnect();
+    }
+
+    if (tcp_state_ == TcpState::CONNECTING) {
+        struct pollfd pfd;
+        pfd.fd = tcp_fd_;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, 0) <= 0) {
+            return false;  // Still in progress
+        }
+
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if (getsockopt(tcp_fd_, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0) {
+            LOGE("TCP connect to %s:%d failed: %s", host_.c_str(), port_, strerror(error));
+            closeTcp(true);
+            return false;
+        }
+
+        tcp_state_ = TcpState::CONNECTED;
+        LOGI("TCP stream connected to %s:%d", host_.c_str(), port_);
+    }
+
+    return tcp_state_ == TcpState::CONNECTED;
+}
+
+void OSCSender::startTcpConnect() {
+    sockaddr_in dest_addr;
+    if (!resolveDestination(dest_addr)) {
+        return;
+    }
+
+    tcp_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (tcp_fd_ < 0) {
+        LOGE("Failed to create TCP socket");
+        return;
+    }
+
+    // Small OSC messages must not wait for Nagle; blocks are coalesced by sendmsg() instead
+    int one = 1;
+    setsockopt(tcp_fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    int sndbuf = kTcpSendBufferBytes;
+    setsockopt(tcp_fd_, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    fcntl(tcp_fd_, F_SETFL, fcntl(tcp_fd_, F_GETFL, 0) | O_NONBLOCK);
+
+    if (::connect(tcp_fd_, (struct sockaddr*)&dest_addr, sizeof(dest_addr)) == 0) {
+        tcp_state_ = TcpState::CONNECTED;
+        LOGI("TCP stream connected to %s:%d", host_.c_str(), port_);
+    } else if (errno == EINPROGRESS) {
+        tcp_state_ = TcpState::CONNECTING;
+    } else {
+        LOGE("TCP connect to %s:%d failed: errno=%d", host_.c_str(), port_, errno);
+        close(tcp_fd_);
+        tcp_fd_ = -1;
+    }
+}
+
+void OSCSender::closeTcp(bool reroute_to_udp) {
+    if (tcp_fd_ >= 0) {
+        close(tcp_fd_);
+        tcp_fd_ = -1;
+    }
+    tcp_state_ = TcpState::DISCONNECTED;
+
+    // Messages not yet started on the stream still get a best-effort UDP send
+    sockaddr_in dest_addr;
+    if (reroute_to_udp && socket_fd_ >= 0 && resolveDestination(dest_addr)) {
+        for (const auto& frame : tcp_queue_) {
+            if (frame.offset == 0) {
+                sendto(socket_fd_, frame.message.c_str(), frame.message.length(), 0,
+                       (struct sockaddr*)&dest_addr, sizeof(dest_addr));
+                udp_fallback_count_++;
+            }
+        }
+    }
+    tcp_queue_.clear();
+    tcp_queued_bytes_ = 0;
+    udp_fallback_active_ = false;
+}
+
+void OSCSender::flushTcp() {
+    while (tcp_state_ == TcpState::CONNECTED && !tcp_queue_.empty()) {
+        struct iovec iov[kMaxIovecs];
+        int count = 0;
+        for (auto it = tcp_queue_.begin(); it != tcp_queue_.end() && count < kMaxIovecs; ++it, ++count) {
+            iov[count].iov_base = const_cast<char*>(it->encoded.data()) + it->offset;
+            iov[count].iov_len = it->encoded.size() - it->offset;
+        }
+
+        // writev() semantics plus MSG_NOSIGNAL so a dropped peer cannot raise SIGPIPE
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        ssize_t sent = sendmsg(tcp_fd_, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOGE("TCP stream to %s:%d lost: errno=%d", host_.c_str(), port_, errno);
+                closeTcp(true);
+            }
+            return;
+        }
+
+        size_t remaining = static_cast<size_t>(sent);
+        while (remaining > 0) {
+            QueuedFrame& front = tcp_queue_.front();
+            size_t left = front.encoded.size() - front.offset;
+            if (remaining >= left) {
+                remaining -= left;
+                tcp_queued_bytes_ -= left;
+                tcp_queue_.pop_front();
+            } else {
+                front.offset += remaining;
+                tcp_queued_bytes_ -= remaining;
+                remaining = 0;
+            }
+        }
+    }
+
+    if (tcp_queue_.empty()) {
+        udp_fallback_active_ = false;
+    }
+}
+
+} // namespace media_pipeline
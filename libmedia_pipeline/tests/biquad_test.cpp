@@ -0,0 +1,276 @@
+#include "test_framework.h"
+#include "media_pipeline/biquad.h"
+#include "media_pipeline/dsp_kernels.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using media_pipeline::BiquadBank;
+using media_pipeline::BiquadCoefficients;
+using Type = media_pipeline::BiquadCoefficients::Type;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+
+// Transposed direct form II in double, one section at a time
+void referenceFilter(std::vector<double>& data, const std::vector<BiquadCoefficients>& sections) {
+    for (const auto& c : sections) {
+        double z1 = 0.0, z2 = 0.0;
+        for (double& x : data) {
+            double y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            x = y;
+        }
+    }
+}
+
+std::vector<float> sine(size_t count, double frequency) {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] = static_cast<float>(std::sin(2.0 * M_PI * frequency * i / kSampleRate));
+    }
+    return samples;
+}
+
+double peak(const float* data, size_t count, size_t stride = 1) {
+    double result = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        result = std::max(result, std::fabs(static_cast<double>(data[i * stride])));
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(biquad_kernel_identical_across_isas) {
+    using namespace media_pipeline::dsp;
+    std::mt19937 rng(50);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::uniform_real_distribution<double> frequency(50.0, 15000.0);
+    const Isa original = activeIsa();
+    for (size_t lanes : {4u, 8u, 12u}) {
+        for (size_t stages : {1u, 3u}) {
+            const size_t frames = 77;
+            std::vector<float> coefficients(stages * 5 * lanes);
+            for (size_t s = 0; s < stages; ++s) {
+                for (size_t l = 0; l < lanes; ++l) {
+                    auto c = BiquadCoefficients::design(static_cast<Type>(l % 8), kSampleRate, frequency(rng), 0.9, 6.0);
+                    const float values[5] = {c.b0, c.b1, c.b2, c.a1, c.a2};
+                    for (size_t k = 0; k < 5; ++k) {
+                        coefficients[(s * 5 + k) * lanes + l] = values[k];
+                    }
+                }
+            }
+            std::vector<float> input(frames * lanes);
+            std::vector<float> initial_state(stages * 2 * lanes);
+            for (float& x : input) x = uniform(rng);
+            for (float& z : initial_state) z = uniform(rng) * 0.1f;
+
+            std::vector<float> expected = input;
+            std::vector<float> expected_state = initial_state;
+            reference::biquadCascade(expected.data(), frames, lanes, coefficients.data(), expected_state.data(), stages);
+            for (Isa isa : {Isa::SCALAR, Isa::SSE2, Isa::AVX2, Isa::NEON}) {
+                if (setIsa(isa)) {
+                    std::vector<float> actual = input;
+                    std::vector<float> state = initial_state;
+                    biquadCascade(actual.data(), frames, lanes, coefficients.data(), state.data(), stages);
+                    CHECK(std::memcmp(actual.data(), expected.data(), expected.size() * sizeof(float)) == 0);
+                    CHECK(std::memcmp(state.data(), expected_state.data(), state.size() * sizeof(float)) == 0);
+                }
+            }
+        }
+    }
+    setIsa(original);
+}
+
+TEST(biquad_cookbook_designs) {
+    const double fs = kSampleRate;
+    auto db = [](double magnitude) { return 20.0 * std::log10(magnitude); };
+
+    auto lowpass = BiquadCoefficients::design(Type::LOWPASS, fs, 1000.0, M_SQRT1_2);
+    CHECK_NEAR(db(lowpass.magnitude(fs, 1000.0)), -3.01, 0.02);
+    CHECK_NEAR(lowpass.magnitude(fs, 10.0), 1.0, 1e-4);
+    CHECK(db(lowpass.magnitude(fs, 10000.0)) < -38.0);
+
+    auto highpass = BiquadCoefficients::design(Type::HIGHPASS, fs, 1000.0, M_SQRT1_2);
+    CHECK_NEAR(db(highpass.magnitude(fs, 1000.0)), -3.01, 0.02);
+    CHECK_NEAR(highpass.magnitude(fs, 20000.0), 1.0, 1e-3);
+
+    auto bandpass = BiquadCoefficients::design(Type::BANDPASS, fs, 2000.0, 4.0);
+    CHECK_NEAR(bandpass.magnitude(fs, 2000.0), 1.0, 1e-4);
+    auto notch = BiquadCoefficients::design(Type::NOTCH, fs, 2000.0, 4.0);
+    CHECK(notch.magnitude(fs, 2000.0) < 1e-3);
+    auto allpass = BiquadCoefficients::design(Type::ALLPASS, fs, 2000.0, 1.0);
+    CHECK_NEAR(allpass.magnitude(fs, 300.0), 1.0, 1e-4);
+    CHECK_NEAR(allpass.magnitude(fs, 9000.0), 1.0, 1e-4);
+
+    auto peaking = BiquadCoefficients::design(Type::PEAKING, fs, 3000.0, 2.0, 9.0);
+    CHECK_NEAR(db(peaking.magnitude(fs, 3000.0)), 9.0, 0.01);
+    CHECK_NEAR(db(peaking.magnitude(fs, 100.0)), 0.0, 0.05);
+
+    auto low_shelf = BiquadCoefficients::design(Type::LOW_SHELF, fs, 300.0, M_SQRT1_2, -6.0);
+    CHECK_NEAR(db(low_shelf.magnitude(fs, 20.0)), -6.0, 0.1);
+    CHECK_NEAR(db(low_shelf.magnitude(fs, 300.0)), -3.0, 0.05);
+    CHECK_NEAR(db(low_shelf.magnitude(fs, 15000.0)), 0.0, 0.05);
+    auto high_shelf = BiquadCoefficients::design(Type::HIGH_SHELF, fs, 5000.0, M_SQRT1_2, 4.0);
+    CHECK_NEAR(db(high_shelf.magnitude(fs, 20000.0)), 4.0, 0.1);
+    CHECK_NEAR(db(high_shelf.magnitude(fs, 50.0)), 0.0, 0.05);
+
+    Type type;
+    CHECK(BiquadCoefficients::parseType("highshelf", type) && type == Type::HIGH_SHELF);
+    CHECK(!BiquadCoefficients::parseType("bogus", type));
+    CHECK(std::strcmp(BiquadCoefficients::typeName(Type::PEAKING), "peaking") == 0);
+}
+
+TEST(biquad_bank_matches_reference) {
+    // Three lanes (padded to four inside), two sections each, different per lane
+    const size_t lanes = 3, frames = 1000;
+    BiquadBank bank(lanes, 2);
+    std::vector<std::vector<BiquadCoefficients>> sections(lanes);
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        sections[lane].push_back(BiquadCoefficients::design(Type::PEAKING, kSampleRate, 500.0 * (lane + 1), 1.5, 6.0));
+        sections[lane].push_back(BiquadCoefficients::design(Type::LOWPASS, kSampleRate, 4000.0 * (lane + 1), 0.9));
+        for (size_t stage = 0; stage < 2; ++stage) {
+            bank.setCoefficients(lane, stage, sections[lane][stage]);
+        }
+    }
+
+    std::mt19937 rng(51);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float> interleaved(frames * lanes);
+    for (float& x : interleaved) x = uniform(rng);
+    std::vector<std::vector<float>> planar(lanes, std::vector<float>(frames));
+    for (size_t n = 0; n < frames; ++n) {
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            planar[lane][n] = interleaved[n * lanes + lane];
+        }
+    }
+
+    std::vector<float> filtered = interleaved;
+    bank.process(filtered.data(), 300);
+    bank.process(filtered.data() + 300 * lanes, frames - 300);  // State carries across calls
+
+    BiquadBank planar_bank(lanes, 2);
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        for (size_t stage = 0; stage < 2; ++stage) {
+            planar_bank.setCoefficients(lane, stage, sections[lane][stage]);
+        }
+    }
+    float* channels[lanes] = {planar[0].data(), planar[1].data(), planar[2].data()};
+    planar_bank.processPlanar(channels, frames);
+
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        std::vector<double> expected(frames);
+        for (size_t n = 0; n < frames; ++n) {
+            expected[n] = interleaved[n * lanes + lane];
+        }
+        referenceFilter(expected, sections[lane]);
+        for (size_t n = 0; n < frames; ++n) {
+            CHECK_NEAR(filtered[n * lanes + lane], expected[n], 1e-4);
+            CHECK_EQ(planar[lane][n], filtered[n * lanes + lane]);
+        }
+    }
+
+    // Reset clears the state: the same input gives the same output again
+    bank.reset();
+    std::vector<float> again = interleaved;
+    bank.process(again.data(), frames);
+    CHECK(std::memcmp(again.data(), filtered.data(), again.size() * sizeof(float)) == 0);
+}
+
+TEST(biquad_bank_band_split) {
+    // One input copied to four lanes: a crossover's low, band and high outputs
+    BiquadBank bank(4, 2);
+    for (size_t stage = 0; stage < 2; ++stage) {
+        bank.setCoefficients(0, stage, BiquadCoefficients::design(Type::LOWPASS, kSampleRate, 300.0, M_SQRT1_2));
+        bank.setCoefficients(1, stage, BiquadCoefficients::design(Type::HIGHPASS, kSampleRate, 300.0, M_SQRT1_2));
+        bank.setCoefficients(2, stage, BiquadCoefficients::design(Type::LOWPASS, kSampleRate, 3000.0, M_SQRT1_2));
+        bank.setCoefficients(3, stage, BiquadCoefficients::design(Type::HIGHPASS, kSampleRate, 3000.0, M_SQRT1_2));
+    }
+    for (double frequency : {60.0, 1000.0, 10000.0}) {
+        bank.reset();
+        std::vector<float> tone = sine(4800, frequency);
+        std::vector<float> lanes(tone.size() * 4);
+        for (size_t n = 0; n < tone.size(); ++n) {
+            std::fill_n(lanes.begin() + n * 4, 4, tone[n]);
+        }
+        bank.process(lanes.data(), tone.size());
+        const float* settled = lanes.data() + 2400 * 4;
+        const double low = peak(settled, 2400, 4);
+        const double high = peak(settled + 3, 2400, 4);
+        if (frequency < 300.0) {
+            CHECK(low > 0.95 && high < 0.01);
+        } else if (frequency > 3000.0) {
+            CHECK(low < 0.01 && high > 0.95);
+        } else {
+            CHECK(peak(settled + 1, 2400, 4) > 0.9 && peak(settled + 2, 2400, 4) > 0.9);
+        }
+    }
+}
+
+TEST(biquad_bank_design_ramp) {
+    BiquadBank bank(1, 1);
+    bank.setDesign(0, 0, Type::LOWPASS, kSampleRate, 200.0, M_SQRT1_2);
+    auto target = BiquadCoefficients::design(Type::LOWPASS, kSampleRate, 8000.0, M_SQRT1_2);
+
+    // Settle on a 1 kHz tone, heavily attenuated, then sweep the corner up
+    // over 100 ms: more than five octaves, which coefficient interpolation
+    // would turn into a resonant bump on the way
+    std::vector<float> tone = sine(48000, 1000.0);
+    bank.process(tone.data(), 9600);
+    bank.setDesign(0, 0, Type::LOWPASS, kSampleRate, 8000.0, M_SQRT1_2, 0.0, 4800);
+    CHECK_EQ(bank.getCoefficients(0, 0).b0, target.b0);
+    bank.process(tone.data() + 9600, 4800);
+    bank.process(tone.data() + 14400, tone.size() - 14400);
+
+    // The level rises smoothly from the old response to the new one
+    const double before = peak(tone.data() + 4800, 4800);
+    const double during = peak(tone.data() + 9600, 4800);
+    const double after = peak(tone.data() + 24000, 24000);
+    CHECK_NEAR(before, BiquadCoefficients::design(Type::LOWPASS, kSampleRate, 200.0, M_SQRT1_2)
+                           .magnitude(kSampleRate, 1000.0), 0.01);
+    CHECK_NEAR(after, target.magnitude(kSampleRate, 1000.0), 0.01);
+    CHECK(during < 1.05);
+    double largest_step = 0.0;
+    for (size_t n = 9601; n < 14400; ++n) {
+        largest_step = std::max(largest_step, std::fabs(static_cast<double>(tone[n]) - tone[n - 1]));
+    }
+    // A full-scale 1 kHz sine moves at most 2 pi 1000 / 48000 = 0.131 per sample
+    CHECK(largest_step < 0.14);
+}
+
+TEST(biquad_bank_coefficient_ramp) {
+    // A small EQ move interpolated by coefficients: +6 dB at 1 kHz over 100 ms
+    BiquadBank bank(1, 1);
+    auto start = BiquadCoefficients::design(Type::PEAKING, kSampleRate, 1000.0, 1.0, 0.0);
+    auto target = BiquadCoefficients::design(Type::PEAKING, kSampleRate, 1000.0, 1.0, 6.0);
+    bank.setCoefficients(0, 0, start);
+
+    std::vector<float> tone = sine(48000, 1000.0);
+    for (float& sample : tone) {
+        sample *= 0.5f;
+    }
+    bank.process(tone.data(), 9600);
+    bank.setCoefficients(0, 0, target, 4800);
+    CHECK_EQ(bank.getCoefficients(0, 0).b0, target.b0);
+    bank.process(tone.data() + 9600, tone.size() - 9600);
+
+    CHECK_NEAR(peak(tone.data() + 4800, 4800), 0.5 * start.magnitude(kSampleRate, 1000.0), 0.01);
+    CHECK_NEAR(peak(tone.data() + 24000, 24000), 0.5 * target.magnitude(kSampleRate, 1000.0), 0.01);
+    double largest_step = 0.0;
+    for (size_t n = 9601; n < 14400; ++n) {
+        largest_step = std::max(largest_step, std::fabs(static_cast<double>(tone[n]) - tone[n - 1]));
+    }
+    // At most the slope of the boosted tone: 0.131 * 0.5 * 2
+    CHECK(largest_step < 0.14);
+
+    // Retargeting by coefficients drops the design, so the next design ramp
+    // interpolates coefficients too; it still ends on the target
+    bank.setDesign(0, 0, Type::PEAKING, kSampleRate, 1000.0, 1.0, -6.0, 480);
+    bank.process(tone.data(), 4800);
+    CHECK_EQ(bank.getCoefficients(0, 0).b0,
+             BiquadCoefficients::design(Type::PEAKING, kSampleRate, 1000.0, 1.0, -6.0).b0);
+}
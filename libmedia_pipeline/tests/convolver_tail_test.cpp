@@ -0,0 +1,92 @@
+#include "test_framework.h"
+#include "media_pipeline/convolver.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+using media_pipeline::PartitionedConvolver;
+
+namespace {
+
+std::vector<float> randomSignal(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uniform(-0.5f, 0.5f);
+    std::vector<float> values(count);
+    for (float& value : values) {
+        value = uniform(rng);
+    }
+    return values;
+}
+
+void waitForTail(const PartitionedConvolver& convolver) {
+    while (convolver.getStats().tail_blocks_completed < convolver.getStats().tail_blocks_submitted) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+} // namespace
+
+// A worker that keeps up produces exactly the inline result
+TEST(convolver_background_tail_matches_inline) {
+    std::vector<float> ir = randomSignal(20000, 40);
+    std::vector<float> input = randomSignal(64 * 1024, 41);
+
+    PartitionedConvolver::Config config;
+    config.block_size = 64;
+    config.tail_partition = 1024;
+    config.background_tail = false;
+    std::string error;
+    auto inline_convolver = PartitionedConvolver::create(ir.data(), ir.size(), config, error);
+    config.background_tail = true;
+    auto background = PartitionedConvolver::create(ir.data(), ir.size(), config, error);
+    CHECK(inline_convolver != nullptr && background != nullptr);
+
+    std::vector<float> expected(input.size());
+    std::vector<float> actual(input.size());
+    inline_convolver->process(input.data(), expected.data(), input.size());
+    for (size_t offset = 0; offset < input.size(); offset += 64) {
+        background->process(input.data() + offset, actual.data() + offset, 64);
+        waitForTail(*background);
+    }
+    CHECK(std::memcmp(actual.data(), expected.data(), expected.size() * sizeof(float)) == 0);
+    CHECK_EQ(background->getStats().tail_blocks_late, 0u);
+    CHECK_EQ(background->getStats().tail_blocks_completed, 64u);
+}
+
+// Several streams with a few seconds of IR each, at full speed: late tail
+// blocks are allowed, lost input or races (under TSan) are not
+TEST(convolver_streams_run_free) {
+    const size_t streams = 3;
+    const size_t blocks = 2000 * media_pipeline::test::stressScale();
+    std::vector<float> ir = randomSignal(3 * 48000, 42);
+
+    std::vector<std::thread> threads;
+    std::vector<uint64_t> submitted(streams);
+    for (size_t s = 0; s < streams; ++s) {
+        threads.emplace_back([&ir, &submitted, s, blocks] {
+            PartitionedConvolver::Config config;
+            config.block_size = 256;
+            std::string error;
+            auto convolver = PartitionedConvolver::create(ir.data(), ir.size(), config, error);
+            std::vector<float> input = randomSignal(256, static_cast<uint32_t>(s));
+            std::vector<float> output(input.size());
+            for (size_t b = 0; b < blocks; ++b) {
+                convolver->process(input.data(), output.data(), input.size());
+                if (b == blocks / 2) {
+                    convolver->reset();
+                }
+            }
+            waitForTail(*convolver);
+            submitted[s] = convolver->getStats().tail_blocks_submitted;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (uint64_t count : submitted) {
+        CHECK_EQ(count, (blocks - blocks / 2 - 1) * 256 / 4096);
+    }
+}
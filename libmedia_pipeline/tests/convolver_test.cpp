@@ -0,0 +1,211 @@
+#include "test_framework.h"
+#include "media_pipeline/convolver.h"
+#include "media_pipeline/dsp_kernels.h"
+#include "media_pipeline/wav_file.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+using media_pipeline::PartitionedConvolver;
+using media_pipeline::WavData;
+
+namespace {
+
+std::vector<float> randomSignal(size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float> values(count);
+    for (float& value : values) {
+        value = uniform(rng);
+    }
+    return values;
+}
+
+// Noise under an exponential decay, like a room response
+std::vector<float> decayingIr(size_t length, std::mt19937& rng) {
+    std::vector<float> ir = randomSignal(length, rng);
+    for (size_t i = 0; i < length; ++i) {
+        ir[i] *= 0.5f * std::exp(-4.0f * static_cast<float>(i) / static_cast<float>(length));
+    }
+    return ir;
+}
+
+std::vector<double> directConvolution(const std::vector<float>& input, const std::vector<float>& ir) {
+    std::vector<double> output(input.size(), 0.0);
+    for (size_t n = 0; n < input.size(); ++n) {
+        for (size_t k = 0; k < ir.size() && k <= n; ++k) {
+            output[n] += static_cast<double>(ir[k]) * input[n - k];
+        }
+    }
+    return output;
+}
+
+} // namespace
+
+TEST(complex_mac_kernel_identical_across_isas) {
+    using namespace media_pipeline::dsp;
+    std::mt19937 rng(30);
+    const Isa original = activeIsa();
+    for (size_t count : {0u, 1u, 3u, 4u, 9u, 257u}) {
+        // Unaligned on purpose
+        std::vector<float> a = randomSignal(2 * count + 1, rng);
+        std::vector<float> b = randomSignal(2 * count + 1, rng);
+        std::vector<float> start = randomSignal(2 * count + 1, rng);
+        std::vector<float> expected = start;
+        reference::complexMultiplyAccumulate(expected.data() + 1, a.data() + 1, b.data() + 1, count);
+        for (size_t k = 0; k < count; ++k) {
+            std::complex<double> product = std::complex<double>(a[2 * k + 1], a[2 * k + 2]) *
+                                           std::complex<double>(b[2 * k + 1], b[2 * k + 2]);
+            CHECK_NEAR(expected[2 * k + 1], start[2 * k + 1] + product.real(), 1e-5);
+            CHECK_NEAR(expected[2 * k + 2], start[2 * k + 2] + product.imag(), 1e-5);
+        }
+        for (Isa isa : {Isa::SCALAR, Isa::SSE2, Isa::AVX2, Isa::NEON}) {
+            if (setIsa(isa)) {
+                std::vector<float> actual = start;
+                complexMultiplyAccumulate(actual.data() + 1, a.data() + 1, b.data() + 1, count);
+                CHECK(std::memcmp(actual.data(), expected.data(), expected.size() * sizeof(float)) == 0);
+            }
+        }
+    }
+    setIsa(original);
+}
+
+TEST(convolver_head_only_matches_direct) {
+    std::mt19937 rng(31);
+    std::vector<float> ir = decayingIr(100, rng);  // Not a multiple of the block
+    std::vector<float> input = randomSignal(64 * 20, rng);
+    std::vector<double> expected = directConvolution(input, ir);
+
+    PartitionedConvolver::Config config;
+    config.block_size = 64;
+    std::string error;
+    auto convolver = PartitionedConvolver::create(ir.data(), ir.size(), config, error);
+    CHECK(convolver != nullptr);
+    CHECK_EQ(convolver->getStats().head_partitions, 2u);
+    CHECK_EQ(convolver->getStats().tail_partitions, 0u);
+
+    // In place, several blocks per call
+    std::vector<float> output = input;
+    for (size_t offset = 0; offset < output.size(); offset += 4 * 64) {
+        CHECK(convolver->process(output.data() + offset, output.data() + offset, 4 * 64));
+    }
+    for (size_t i = 0; i < output.size(); ++i) {
+        CHECK_NEAR(output[i], expected[i], 1e-5);
+    }
+
+    CHECK(!convolver->process(input.data(), output.data(), 63));
+}
+
+TEST(convolver_two_stages_match_direct) {
+    std::mt19937 rng(32);
+    std::vector<float> ir = decayingIr(1000, rng);
+    std::vector<float> input = randomSignal(4096, rng);
+    std::vector<double> expected = directConvolution(input, ir);
+
+    PartitionedConvolver::Config config;
+    config.block_size = 32;
+    config.tail_partition = 128;
+    config.background_tail = false;
+    std::string error;
+    auto convolver = PartitionedConvolver::create(ir.data(), ir.size(), config, error);
+    CHECK(convolver != nullptr);
+    auto stats = convolver->getStats();
+    CHECK_EQ(stats.head_partitions, 8u);    // IR [0, 256)
+    CHECK_EQ(stats.tail_partitions, 6u);    // IR [256, 1000)
+
+    std::vector<float> output(input.size());
+    for (size_t offset = 0; offset < input.size(); offset += 32) {
+        convolver->process(input.data() + offset, output.data() + offset, 32);
+    }
+    for (size_t i = 0; i < output.size(); ++i) {
+        CHECK_NEAR(output[i], expected[i], 1e-5);
+    }
+    stats = convolver->getStats();
+    CHECK_EQ(stats.tail_blocks_submitted, 4096u / 128);
+    CHECK_EQ(stats.tail_blocks_completed, 4096u / 128);
+    CHECK_EQ(stats.tail_blocks_late, 0u);
+
+    // After reset the output starts over as for a fresh stream
+    convolver->reset();
+    std::vector<float> again(256);
+    convolver->process(input.data(), again.data(), again.size());
+    CHECK(std::memcmp(again.data(), output.data(), again.size() * sizeof(float)) == 0);
+}
+
+TEST(convolver_rejects_bad_config) {
+    const float ir[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+    PartitionedConvolver::Config config;
+    std::string error;
+    CHECK(PartitionedConvolver::create(ir, 0, config, error) == nullptr);
+    config.block_size = 100;
+    CHECK(PartitionedConvolver::create(ir, 4, config, error) == nullptr);
+    config.block_size = 256;
+    config.tail_partition = 128;
+    CHECK(PartitionedConvolver::create(ir, 4, config, error) == nullptr);
+    config.tail_partition = 0;
+    auto convolver = PartitionedConvolver::create(ir, 4, config, error);
+    CHECK(convolver != nullptr);
+    CHECK_EQ(convolver->getTailPartition(), 4096u);
+}
+
+TEST(wav_file_round_trip) {
+    WavData wav;
+    wav.sample_rate = 48000;
+    wav.channels = 2;
+    for (int i = 0; i < 301; ++i) {
+        wav.samples.push_back(static_cast<float>(i) / 512.0f - 0.25f);
+        wav.samples.push_back(-static_cast<float>(i) / 1024.0f);
+    }
+    const std::string path = "/tmp/media_pipeline_wav_test.wav";
+    std::string error;
+    const struct { WavData::Format format; double tolerance; } cases[] = {
+        {WavData::Format::PCM16, 1.0 / 32768},
+        {WavData::Format::PCM24, 1.0 / 8388608},
+        {WavData::Format::FLOAT32, 0.0},
+    };
+    for (const auto& c : cases) {
+        CHECK(media_pipeline::writeWavFile(path, wav, c.format, error));
+        WavData read;
+        CHECK(media_pipeline::readWavFile(path, read, error));
+        CHECK_EQ(read.sample_rate, 48000);
+        CHECK_EQ(read.channels, 2u);
+        CHECK_EQ(read.getFrameCount(), 301u);
+        for (size_t i = 0; i < read.samples.size(); ++i) {
+            CHECK_NEAR(read.samples[i], wav.samples[i], c.tolerance);
+        }
+    }
+    std::vector<float> right = wav.getChannel(1);
+    CHECK_EQ(right.size(), 301u);
+    CHECK_EQ(right[2], -2.0f / 1024.0f);
+    std::remove(path.c_str());
+
+    CHECK(!media_pipeline::readWavFile(path, wav, error));
+    const char junk[] = "RIFF\x04\0\0\0WAVEjunk";
+    CHECK(!media_pipeline::readWav(junk, sizeof(junk), wav, error));
+}
+
+TEST(wav_file_extensible_float) {
+    // WAVE_FORMAT_EXTENSIBLE, float subformat, with a chunk to skip before fmt
+    const uint8_t header[] = {
+        'R', 'I', 'F', 'F', 86, 0, 0, 0, 'W', 'A', 'V', 'E',
+        'L', 'I', 'S', 'T', 3, 0, 0, 0, 'a', 'b', 'c', 0,
+        'f', 'm', 't', ' ', 40, 0, 0, 0,
+        0xFE, 0xFF, 1, 0, 0x44, 0xAC, 0, 0, 0x10, 0xB1, 2, 0, 4, 0, 32, 0,
+        22, 0, 32, 0, 4, 0, 0, 0,
+        3, 0, 0, 0, 0, 0, 0x10, 0, 0x80, 0, 0, 0xAA, 0, 0x38, 0x9B, 0x71,
+        'd', 'a', 't', 'a', 8, 0, 0, 0,
+    };
+    const float samples[2] = {0.5f, -0.75f};
+    std::vector<uint8_t> file(header, header + sizeof(header));
+    file.insert(file.end(), reinterpret_cast<const uint8_t*>(samples),
+                reinterpret_cast<const uint8_t*>(samples) + sizeof(samples));
+
+    WavData wav;
+    std::string error;
+    CHECK(media_pipeline::readWav(file.data(), file.size(), wav, error));
+    CHECK_EQ(wav.sample_rate, 44100);
+    CHECK_EQ(wav.channels, 1u);
+    CHECK_EQ(wav.samples.size(), 2u);
+    CHECK_EQ(wav.samples[1], -0.75f);
+}
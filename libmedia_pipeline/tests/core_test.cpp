@@ -0,0 +1,135 @@
+#include "test_framework.h"
+#include "media_pipeline/buffer_manager.h"
+#include "media_pipeline/log.h"
+#include "media_pipeline/sine_generator.h"
+
+#include <cstring>
+#include <set>
+
+using media_pipeline::BufferManager;
+using media_pipeline::SineGenerator;
+
+TEST(sine_generator_accuracy) {
+    const int sample_rate = 48000;
+    const double frequency = 440.0;
+    SineGenerator generator(sample_rate, static_cast<float>(frequency));
+    generator.setAmplitude(1.0f);
+
+    // Ten seconds in callback-sized blocks against a reference computed from the sample index
+    std::vector<float> block(480);
+    double worst = 0.0;
+    for (int b = 0; b < 1000; ++b) {
+        generator.generate(block.data(), static_cast<int>(block.size()));
+        for (size_t i = 0; i < block.size(); ++i) {
+            double n = static_cast<double>(b) * block.size() + i;
+            double reference = std::sin(2.0 * M_PI * frequency * n / sample_rate);
+            worst = std::max(worst, std::fabs(block[i] - reference));
+        }
+    }
+    CHECK(worst < 1e-5);
+}
+
+TEST(sine_generator_phase_continuous) {
+    const int sample_rate = 48000;
+    SineGenerator generator(sample_rate, 1000.0f);
+    generator.setAmplitude(1.0f);
+
+    std::vector<float> block(256);
+    float previous = 0.0f;
+    bool first = true;
+    for (float frequency : {1000.0f, 3000.0f, 200.0f, 5000.0f}) {
+        generator.setFrequency(frequency);
+        generator.generate(block.data(), static_cast<int>(block.size()));
+
+        // No sample-to-sample step larger than the steepest slope of either frequency
+        double max_step = 2.0 * M_PI * 5000.0 / sample_rate * 1.01;
+        for (float sample : block) {
+            if (!first) {
+                CHECK(std::fabs(sample - previous) <= max_step);
+            }
+            previous = sample;
+            first = false;
+        }
+    }
+}
+
+TEST(sine_generator_amplitude_clamped) {
+    SineGenerator generator(48000, 1000.0f);
+    std::vector<float> block(480);
+    for (float amplitude : {-1.0f, 0.25f, 4.0f}) {
+        generator.setAmplitude(amplitude);
+        generator.generate(block.data(), static_cast<int>(block.size()));
+        float peak = 0.0f;
+        for (float sample : block) {
+            peak = std::max(peak, std::fabs(sample));
+        }
+        float expected = std::max(0.0f, std::min(1.0f, amplitude));
+        CHECK(peak <= expected + 1e-6f);
+        CHECK(peak >= expected * 0.99f);
+    }
+
+    // Null buffer and non-positive counts are ignored
+    generator.generate(nullptr, 16);
+    generator.generate(block.data(), 0);
+}
+
+TEST(buffer_manager_bounds) {
+    BufferManager manager(256, 2, 3);
+    CHECK_EQ(manager.getBufferSize(), 256);
+    CHECK_EQ(manager.getInletCount(), 2);
+    CHECK_EQ(manager.getOutletCount(), 3);
+
+    CHECK(manager.getInletBuffer(-1) == nullptr);
+    CHECK(manager.getInletBuffer(2) == nullptr);
+    CHECK(manager.getOutletBuffer(-1) == nullptr);
+    CHECK(manager.getOutletBuffer(3) == nullptr);
+
+    // Every buffer is distinct and holds buffer_size zeroed samples
+    std::set<float*> seen;
+    std::vector<float*> buffers = {manager.getAudioBuffer().get()};
+    for (int i = 0; i < 2; ++i) {
+        buffers.push_back(manager.getInletBuffer(i));
+    }
+    for (int i = 0; i < 3; ++i) {
+        buffers.push_back(manager.getOutletBuffer(i));
+    }
+    for (float* buffer : buffers) {
+        CHECK(buffer != nullptr);
+        CHECK(seen.insert(buffer).second);
+        for (int i = 0; i < 256; ++i) {
+            CHECK_EQ(buffer[i], 0.0f);
+        }
+        // Fill so clearBuffers() has something to clear
+        for (int i = 0; i < 256; ++i) {
+            buffer[i] = 1.0f;
+        }
+    }
+
+    manager.clearBuffers();
+    for (float* buffer : buffers) {
+        for (int i = 0; i < 256; ++i) {
+            CHECK_EQ(buffer[i], 0.0f);
+        }
+    }
+}
+
+namespace {
+
+std::vector<std::string> g_logged;
+
+void captureSink(media_pipeline::log::Level level, const char* tag, const char* message) {
+    g_logged.push_back(std::string(level == media_pipeline::log::Level::ERROR ? "E/" : "I/") + tag + ": " + message);
+}
+
+} // namespace
+
+TEST(log_sink) {
+    media_pipeline::log::setSink(captureSink);
+    MP_LOGI("Test", "value=%d", 42);
+    MP_LOGE("Test", "%s", std::string(2000, 'x').c_str());
+    media_pipeline::log::setSink(nullptr);
+
+    CHECK_EQ(g_logged.size(), 2u);
+    CHECK_EQ(g_logged[0], std::string("I/Test: value=42"));
+    CHECK(g_logged[1].size() < 600);  // Truncated to the fixed message buffer
+}
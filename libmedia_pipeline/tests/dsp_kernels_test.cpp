@@ -0,0 +1,262 @@
+#include "test_framework.h"
+#include "media_pipeline/dsp_kernels.h"
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace media_pipeline::dsp;
+
+namespace {
+
+// Odd lengths and lengths one either side of every vector width, so each
+// variant's main loop, remainder and scalar tail all run
+const size_t kLengths[] = {0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 64, 100, 257};
+
+// Starting offsets into the buffers, so loads and stores run unaligned
+const size_t kOffsets[] = {0, 1, 3};
+
+const float kInf = std::numeric_limits<float>::infinity();
+const float kNaN = std::numeric_limits<float>::quiet_NaN();
+
+// Random samples around full scale with the awkward values mixed in:
+// denormals, signed zeros, infinities, NaN and exact full scale
+std::vector<float> samples(size_t count, uint32_t seed) {
+    static const float special[] = {
+        0.0f, -0.0f, 1.0f, -1.0f, 1.0000001f, -1.0000001f, 1e-40f, -1e-40f,
+        std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::min() / 2.0f,
+        kInf, -kInf, kNaN, 0.99999994f, 32767.5f / 32768.0f, -32768.5f / 32768.0f,
+    };
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uniform(-1.5f, 1.5f);
+    std::uniform_int_distribution<size_t> pick(0, sizeof(special) / sizeof(special[0]) - 1);
+    std::vector<float> result(count);
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = (rng() % 4 == 0) ? special[pick(rng)] : uniform(rng);
+    }
+    return result;
+}
+
+template <typename T>
+bool same(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+// Run check under every instruction set this CPU and build support
+void forEachIsa(const std::function<void()>& check) {
+    const Isa original = activeIsa();
+    for (Isa isa : {Isa::SCALAR, Isa::SSE2, Isa::AVX2, Isa::NEON}) {
+        if (setIsa(isa)) {
+            check();
+        }
+    }
+    setIsa(original);
+}
+
+// Every length at every offset, inputs padded so offset + length fits
+void forEachShape(const std::function<void(size_t offset, size_t count, uint32_t seed)>& check) {
+    uint32_t seed = 1;
+    for (size_t count : kLengths) {
+        for (size_t offset : kOffsets) {
+            check(offset, count, seed++);
+        }
+    }
+}
+
+} // namespace
+
+TEST(dsp_kernels_gain_and_mix_bit_exact) {
+    forEachShape([](size_t offset, size_t count, uint32_t seed) {
+        const auto input = samples(offset + count, seed);
+        const auto other = samples(offset + count, seed + 1000);
+        for (float gain : {0.0f, 0.5f, -1.25f, 3.0f}) {
+            auto expected_gain = input;
+            reference::applyGain(expected_gain.data() + offset, count, gain);
+            auto expected_ramp = input;
+            reference::applyGainRamp(expected_ramp.data() + offset, count, gain, 1.0f - gain);
+            auto expected_mix = input;
+            reference::mixAccumulate(expected_mix.data() + offset, other.data() + offset, count, gain);
+
+            forEachIsa([&] {
+                auto actual = input;
+                applyGain(actual.data() + offset, count, gain);
+                CHECK(same(actual, expected_gain));
+                actual = input;
+                applyGainRamp(actual.data() + offset, count, gain, 1.0f - gain);
+                CHECK(same(actual, expected_ramp));
+                actual = input;
+                mixAccumulate(actual.data() + offset, other.data() + offset, count, gain);
+                CHECK(same(actual, expected_mix));
+            });
+        }
+
+        // Finite inputs for the reductions, where one NaN would hide any difference
+        std::vector<float> a(offset + count);
+        std::vector<float> b(offset + count);
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+        for (size_t i = 0; i < a.size(); ++i) {
+            a[i] = uniform(rng);
+            b[i] = i % 7 == 0 ? 1e-40f : uniform(rng);
+        }
+        const float expected_dot = reference::dot(a.data() + offset, b.data() + offset, count);
+        const size_t complex_count = count / 2;
+        std::vector<float> expected_acc(offset + 2 * complex_count, 0.25f);
+        reference::complexMultiplyAccumulate(expected_acc.data() + offset, a.data() + offset, b.data() + offset,
+                                             complex_count);
+        forEachIsa([&] {
+            const float actual_dot = dot(a.data() + offset, b.data() + offset, count);
+            CHECK(std::memcmp(&actual_dot, &expected_dot, sizeof(float)) == 0);
+            std::vector<float> acc(offset + 2 * complex_count, 0.25f);
+            complexMultiplyAccumulate(acc.data() + offset, a.data() + offset, b.data() + offset, complex_count);
+            CHECK(same(acc, expected_acc));
+        });
+    });
+}
+
+TEST(dsp_kernels_clip_bit_exact) {
+    forEachShape([](size_t offset, size_t count, uint32_t seed) {
+        const auto input = samples(offset + count, seed);
+        for (float limit : {1.0f, 0.5f}) {
+            auto expected = input;
+            reference::hardClip(expected.data() + offset, count, limit);
+            forEachIsa([&] {
+                auto actual = input;
+                hardClip(actual.data() + offset, count, limit);
+                CHECK(same(actual, expected));
+            });
+        }
+        auto expected = input;
+        reference::softClip(expected.data() + offset, count);
+        forEachIsa([&] {
+            auto actual = input;
+            softClip(actual.data() + offset, count);
+            CHECK(same(actual, expected));
+        });
+    });
+
+    // NaN passes through hardClip (it is not clamped to the limit, as a
+    // std::min/std::max clamp would), infinities saturate
+    forEachIsa([] {
+        std::vector<float> data = {kNaN, kInf, -kInf, 1e-40f, 2.0f, -2.0f, 0.25f, -0.0f, kNaN};
+        hardClip(data.data(), data.size(), 1.0f);
+        CHECK(std::isnan(data[0]));
+        CHECK(std::isnan(data[8]));
+        CHECK_EQ(data[1], 1.0f);
+        CHECK_EQ(data[2], -1.0f);
+        CHECK_EQ(data[3], 1e-40f);
+        CHECK_EQ(data[4], 1.0f);
+        CHECK_EQ(data[5], -1.0f);
+        CHECK_EQ(data[6], 0.25f);
+
+        std::vector<float> soft = {kInf, -kInf, 1.0f, -1.0f, 0.0f, kNaN, 0.5f, 3.0f, -3.0f};
+        softClip(soft.data(), soft.size());
+        CHECK_EQ(soft[0], 1.0f);
+        CHECK_EQ(soft[1], -1.0f);
+        CHECK_EQ(soft[2], 1.0f);
+        CHECK_EQ(soft[3], -1.0f);
+        CHECK_EQ(soft[4], 0.0f);
+        CHECK(std::isnan(soft[5]));
+        CHECK_EQ(soft[6], 0.6875f);
+    });
+}
+
+TEST(dsp_kernels_conversions_bit_exact) {
+    forEachShape([](size_t offset, size_t count, uint32_t seed) {
+        const auto input = samples(offset + count, seed);
+        std::vector<int16_t> expected16(offset + count, 0x5555);
+        reference::floatToInt16(expected16.data() + offset, input.data() + offset, count);
+        std::vector<uint8_t> expected24(3 * (offset + count), 0x55);
+        reference::floatToInt24(expected24.data() + 3 * offset, input.data() + offset, count);
+        std::vector<float> expected_back16(offset + count, 0.0f);
+        reference::int16ToFloat(expected_back16.data() + offset, expected16.data() + offset, count);
+        std::vector<float> expected_back24(offset + count, 0.0f);
+        reference::int24ToFloat(expected_back24.data() + offset, expected24.data() + 3 * offset, count);
+
+        forEachIsa([&] {
+            std::vector<int16_t> actual16(offset + count, 0x5555);
+            floatToInt16(actual16.data() + offset, input.data() + offset, count);
+            CHECK(same(actual16, expected16));
+            std::vector<uint8_t> actual24(3 * (offset + count), 0x55);
+            floatToInt24(actual24.data() + 3 * offset, input.data() + offset, count);
+            CHECK(same(actual24, expected24));
+            std::vector<float> back(offset + count, 0.0f);
+            int16ToFloat(back.data() + offset, expected16.data() + offset, count);
+            CHECK(same(back, expected_back16));
+            std::fill(back.begin(), back.end(), 0.0f);
+            int24ToFloat(back.data() + offset, expected24.data() + 3 * offset, count);
+            CHECK(same(back, expected_back24));
+        });
+    });
+
+    forEachIsa([] {
+        // Saturation at and beyond full scale; NaN to the most negative code
+        const std::vector<float> edges = {1.0f, -1.0f, 2.0f, -2.0f, kInf, -kInf, kNaN, 0.5f, -0.5f};
+        std::vector<int16_t> codes16(edges.size());
+        floatToInt16(codes16.data(), edges.data(), edges.size());
+        const std::vector<int16_t> want16 = {32767, -32768, 32767, -32768, 32767, -32768, -32768, 16384, -16384};
+        CHECK(same(codes16, want16));
+
+        std::vector<uint8_t> packed(edges.size() * 3);
+        floatToInt24(packed.data(), edges.data(), edges.size());
+        const int32_t want24[] = {8388607, -8388608, 8388607, -8388608, 8388607, -8388608, -8388608,
+                                  4194304, -4194304};
+        for (size_t i = 0; i < edges.size(); ++i) {
+            int32_t code = packed[3 * i] | (packed[3 * i + 1] << 8) | (packed[3 * i + 2] << 16);
+            if (code & 0x800000) {
+                code -= 0x1000000;
+            }
+            CHECK_EQ(code, want24[i]);
+        }
+
+        // Every int16 code survives the round trip
+        std::vector<int16_t> all(65536);
+        for (size_t i = 0; i < all.size(); ++i) {
+            all[i] = static_cast<int16_t>(static_cast<int32_t>(i) - 32768);
+        }
+        std::vector<float> floats(all.size());
+        int16ToFloat(floats.data(), all.data(), all.size());
+        std::vector<int16_t> round_trip(all.size());
+        floatToInt16(round_trip.data(), floats.data(), floats.size());
+        CHECK(same(round_trip, all));
+        CHECK_EQ(floats.front(), -1.0f);
+    });
+}
+
+TEST(dsp_kernels_interleave_bit_exact) {
+    for (size_t channel_count : {1u, 2u, 3u, 8u}) {
+        for (size_t frames : kLengths) {
+            const auto source = samples(channel_count * frames, static_cast<uint32_t>(channel_count * 1000 + frames));
+            std::vector<std::vector<float>> planar(channel_count, std::vector<float>(frames));
+            std::vector<const float*> inputs(channel_count);
+            for (size_t ch = 0; ch < channel_count; ++ch) {
+                for (size_t i = 0; i < frames; ++i) {
+                    planar[ch][i] = source[i * channel_count + ch];
+                }
+                inputs[ch] = planar[ch].data();
+            }
+            std::vector<float> expected(channel_count * frames);
+            reference::interleave(expected.data(), inputs.data(), channel_count, frames);
+            CHECK(same(expected, source));
+
+            forEachIsa([&] {
+                std::vector<float> actual(channel_count * frames, 7.0f);
+                interleave(actual.data(), inputs.data(), channel_count, frames);
+                CHECK(same(actual, expected));
+
+                std::vector<std::vector<float>> split(channel_count, std::vector<float>(frames, 7.0f));
+                std::vector<float*> outputs(channel_count);
+                for (size_t ch = 0; ch < channel_count; ++ch) {
+                    outputs[ch] = split[ch].data();
+                }
+                deinterleave(outputs.data(), source.data(), channel_count, frames);
+                for (size_t ch = 0; ch < channel_count; ++ch) {
+                    CHECK(same(split[ch], planar[ch]));
+                }
+            });
+        }
+    }
+}
@@ -0,0 +1,144 @@
+#include "test_framework.h"
+#include "media_pipeline/feature_codec.h"
+
+#include <random>
+
+using media_pipeline::feature_codec::Decoder;
+using media_pipeline::feature_codec::Encoder;
+
+namespace {
+
+// AR(1) process: smooth like MFCC frames, with occasional jumps
+std::vector<std::vector<float>> makeSignal(size_t frames, size_t dims, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<std::vector<float>> signal(frames, std::vector<float>(dims));
+    std::vector<float> state(dims, 0.0f);
+    for (size_t f = 0; f < frames; ++f) {
+        for (size_t d = 0; d < dims; ++d) {
+            state[d] = 0.95f * state[d] + 0.3f * noise(rng) * (1.0f + d % 4);
+            if (rng() % 500 == 0) {
+                state[d] += 20.0f * noise(rng);
+            }
+            signal[f][d] = state[d];
+        }
+    }
+    return signal;
+}
+
+// Largest error as a fraction of each dimension's range over the whole signal
+double maxErrorOfSpan(const std::vector<float>& decoded, const std::vector<float>& original,
+                      const std::vector<float>& low, const std::vector<float>& high) {
+    double worst = 0.0;
+    for (size_t i = 0; i < original.size(); ++i) {
+        worst = std::max(worst, static_cast<double>(std::fabs(decoded[i] - original[i]) / (high[i] - low[i])));
+    }
+    return worst;
+}
+
+void signalRange(const std::vector<std::vector<float>>& signal, std::vector<float>& low, std::vector<float>& high) {
+    low.assign(signal[0].size(), signal[0][0]);
+    high.assign(signal[0].size(), signal[0][0]);
+    for (const auto& frame : signal) {
+        for (size_t i = 0; i < frame.size(); ++i) {
+            low[i] = std::min(low[i], frame[i]);
+            high[i] = std::max(high[i], frame[i]);
+        }
+    }
+}
+
+} // namespace
+
+TEST(feature_codec_round_trip) {
+    for (int bits : {8, 16}) {
+        auto signal = makeSignal(1000, 13, 4);
+        std::vector<float> low, high;
+        signalRange(signal, low, high);
+        Encoder encoder(bits, 50);
+        Decoder decoder;
+        std::vector<float> decoded;
+        double worst = 0.0;
+        for (const auto& frame : signal) {
+            std::string body;
+            CHECK(encoder.encode(frame.data(), frame.size(), body));
+            CHECK(decoder.decode(body.data(), body.size(), decoded));
+            CHECK_EQ(decoded.size(), frame.size());
+            worst = std::max(worst, maxErrorOfSpan(decoded, frame, low, high));
+        }
+
+        // Range headroom and growth after jumps cost resolution: looser than one step of the full range
+        CHECK(worst < (bits == 8 ? 1.0 / 100 : 1.0 / 10000));
+        CHECK_EQ(decoder.getDecodedCount(), 1000u);
+        CHECK_EQ(decoder.getSkippedCount(), 0u);
+    }
+}
+
+TEST(feature_codec_loss_recovery) {
+    const int kInterval = 20;
+    auto signal = makeSignal(400, 8, 5);
+    std::vector<float> low, high;
+    signalRange(signal, low, high);
+    Encoder encoder(16, kInterval);
+    Decoder decoder;
+    std::vector<float> decoded;
+    uint64_t received = 0;
+    uint64_t lost = 0;
+    for (size_t f = 0; f < signal.size(); ++f) {
+        std::string body;
+        CHECK(encoder.encode(signal[f].data(), signal[f].size(), body));
+        if (f % 37 == 5) {
+            lost++;
+            continue;
+        }
+        received++;
+        if (decoder.decode(body.data(), body.size(), decoded)) {
+            CHECK(maxErrorOfSpan(decoded, signal[f], low, high) < 1.0 / 10000);
+        }
+    }
+
+    // Every frame received is either decoded or skipped, and a loss costs at
+    // most the frames up to the next keyframe
+    CHECK_EQ(decoder.getDecodedCount() + decoder.getSkippedCount(), received);
+    CHECK(decoder.getSkippedCount() > 0);
+    CHECK(decoder.getSkippedCount() <= lost * (kInterval - 1));
+}
+
+TEST(feature_codec_keyframe_on_request) {
+    auto signal = makeSignal(10, 4, 6);
+    Encoder encoder(16, 1000);
+    std::string body;
+    CHECK(encoder.encode(signal[0].data(), 4, body));
+    body.clear();
+    CHECK(encoder.encode(signal[1].data(), 4, body));
+    CHECK(!(body[0] & media_pipeline::feature_codec::kFlagKeyframe));
+
+    // A fresh decoder (new receiver) can only start from a keyframe
+    encoder.requestKeyframe();
+    body.clear();
+    CHECK(encoder.encode(signal[2].data(), 4, body));
+    Decoder decoder;
+    std::vector<float> decoded;
+    CHECK(decoder.decode(body.data(), body.size(), decoded));
+}
+
+TEST(feature_codec_rejects_bad_input) {
+    Encoder encoder;
+    std::string body;
+    std::vector<float> too_many(media_pipeline::feature_codec::kMaxDims + 1, 0.0f);
+    CHECK(!encoder.encode(too_many.data(), too_many.size(), body));
+    CHECK(!encoder.encode(nullptr, 4, body));
+
+    // Random bytes never crash the decoder and never yield out-of-range dims
+    std::mt19937 rng(7);
+    Decoder decoder;
+    std::vector<float> decoded;
+    for (int i = 0; i < 20000; ++i) {
+        std::string junk(rng() % 64, '\0');
+        for (char& byte : junk) {
+            byte = static_cast<char>(rng());
+        }
+        if (decoder.decode(junk.data(), junk.size(), decoded)) {
+            CHECK(decoded.size() <= media_pipeline::feature_codec::kMaxDims);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#include "test_framework.h"
+#include "media_pipeline/fft.h"
+
+#include <random>
+
+using media_pipeline::RealFft;
+using media_pipeline::Stft;
+
+TEST(real_fft_matches_dft) {
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    for (size_t size : {4u, 8u, 64u, 512u}) {
+        std::vector<float> input(size);
+        for (float& sample : input) {
+            sample = uniform(rng);
+        }
+        RealFft fft(size);
+        std::vector<std::complex<float>> bins(fft.getBinCount());
+        fft.forward(input.data(), bins.data());
+
+        for (size_t k = 0; k < bins.size(); ++k) {
+            std::complex<double> reference = 0.0;
+            for (size_t n = 0; n < size; ++n) {
+                double angle = -2.0 * M_PI * static_cast<double>(k * n) / size;
+                reference += static_cast<double>(input[n]) * std::complex<double>(std::cos(angle), std::sin(angle));
+            }
+            CHECK_NEAR(bins[k].real(), reference.real(), 1e-4 * size);
+            CHECK_NEAR(bins[k].imag(), reference.imag(), 1e-4 * size);
+        }
+
+        std::vector<float> output(size);
+        fft.inverse(bins.data(), output.data());
+        for (size_t n = 0; n < size; ++n) {
+            CHECK_NEAR(output[n], input[n], 1e-5);
+        }
+    }
+
+    // Sizes are rounded up to a power of two
+    CHECK_EQ(RealFft(100).getSize(), 128u);
+}
+
+TEST(stft_identity_is_a_delay) {
+    for (size_t hop : {256u, 128u}) {
+        Stft stft(512, hop);
+        std::mt19937 rng(9);
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+        std::vector<float> input(20000);
+        for (float& sample : input) {
+            sample = uniform(rng);
+        }
+
+        // Odd block sizes, in place, as capture buffers arrive
+        std::vector<float> output = input;
+        size_t offset = 0;
+        while (offset < output.size()) {
+            size_t count = std::min<size_t>(1 + rng() % 700, output.size() - offset);
+            stft.process(output.data() + offset, output.data() + offset, count, nullptr);
+            offset += count;
+        }
+
+        const size_t latency = stft.getLatency();
+        for (size_t i = 0; i < latency; ++i) {
+            CHECK_NEAR(output[i], 0.0f, 1e-6);
+        }
+        for (size_t i = latency; i < output.size(); ++i) {
+            CHECK_NEAR(output[i], input[i - latency], 1e-5);
+        }
+    }
+}
@@ -0,0 +1,166 @@
+#include "test_framework.h"
+#include "media_pipeline/glitch_detector.h"
+
+#include <random>
+#include <vector>
+
+using media_pipeline::GlitchDetector;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+constexpr size_t kPacket = 256;
+
+std::vector<float> sine(size_t count, double frequency, double amplitude, size_t offset = 0) {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] = static_cast<float>(amplitude * std::sin(2.0 * M_PI * frequency * (offset + i) / kSampleRate));
+    }
+    return samples;
+}
+
+// Feed in packets numbered from 1, as a receiver would
+void feed(GlitchDetector& detector, const std::vector<float>& samples, uint64_t& sequence) {
+    for (size_t start = 0; start < samples.size(); start += kPacket) {
+        GlitchDetector::Context context;
+        context.packet_sequence = ++sequence;
+        context.queue_depth = 3;
+        detector.analyze(samples.data() + start, std::min(kPacket, samples.size() - start), context);
+    }
+}
+
+std::vector<GlitchDetector::Event> drain(GlitchDetector& detector) {
+    std::vector<GlitchDetector::Event> events;
+    GlitchDetector::Event event;
+    while (detector.popEvent(event)) {
+        events.push_back(event);
+    }
+    return events;
+}
+
+} // namespace
+
+TEST(glitch_detector_clean_signals) {
+    uint64_t sequence = 0;
+    for (double frequency : {50.0, 440.0, 3000.0, 12000.0}) {
+        GlitchDetector detector(kSampleRate);
+        feed(detector, sine(kSampleRate, frequency, 0.9), sequence);
+        CHECK_EQ(detector.getTotalCount(), 0u);
+    }
+
+    // Broadband noise has large steps everywhere: none may stand out
+    GlitchDetector detector(kSampleRate);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    std::vector<float> samples(kSampleRate);
+    for (float& sample : samples) {
+        sample = noise(rng);
+    }
+    feed(detector, samples, sequence);
+    CHECK_EQ(detector.getTotalCount(), 0u);
+}
+
+TEST(glitch_detector_missing_packet_is_a_discontinuity) {
+    GlitchDetector detector(kSampleRate);
+    uint64_t sequence = 0;
+
+    // Ten packets of a tone, then the stream resumes 100 samples later
+    std::vector<float> samples = sine(10 * kPacket, 440.0, 0.5);
+    std::vector<float> after = sine(10 * kPacket, 440.0, 0.5, 10 * kPacket + 100);
+    samples.insert(samples.end(), after.begin(), after.end());
+    feed(detector, samples, sequence);
+
+    auto events = drain(detector);
+    CHECK_EQ(events.size(), 1u);
+    CHECK(events[0].type == GlitchDetector::Type::DISCONTINUITY);
+    CHECK_EQ(events[0].position, 10 * kPacket);
+    CHECK_EQ(events[0].first_packet, 11u);
+    CHECK_EQ(events[0].queue_depth, 3u);
+    CHECK(events[0].magnitude > 0.1f);
+    CHECK_EQ(detector.getCount(GlitchDetector::Type::DISCONTINUITY), 1u);
+}
+
+TEST(glitch_detector_dropout_and_clipping) {
+    GlitchDetector detector(kSampleRate);
+    uint64_t sequence = 0;
+
+    // 10 ms of exact zeros cut into a tone: a dropout, not two steps
+    std::vector<float> samples = sine(4800, 440.0, 0.5);
+    std::fill(samples.begin() + 1000, samples.begin() + 1480, 0.0f);
+    feed(detector, samples, sequence);
+    auto events = drain(detector);
+    CHECK_EQ(events.size(), 1u);
+    CHECK(events[0].type == GlitchDetector::Type::DROPOUT);
+    CHECK_EQ(events[0].position, 1000u);
+    CHECK_EQ(events[0].length, 480u);
+    CHECK_EQ(events[0].first_packet, 4u);
+    CHECK_EQ(events[0].last_packet, 6u);
+
+    // A tone driven 2x into the clipper: one burst per half cycle, no steps
+    detector.reset();
+    std::vector<float> loud = sine(4800, 100.0, 2.0, 4800);
+    for (float& sample : loud) {
+        sample = std::max(-1.0f, std::min(1.0f, sample));
+    }
+    feed(detector, loud, sequence);
+    events = drain(detector);
+    CHECK_EQ(detector.getCount(GlitchDetector::Type::DISCONTINUITY), 0u);
+    CHECK(events.size() >= 19 && events.size() <= 20);
+    for (const auto& event : events) {
+        CHECK(event.type == GlitchDetector::Type::CLIPPING);
+        CHECK(event.length > 100);
+        CHECK_EQ(event.magnitude, 1.0f);
+    }
+}
+
+TEST(glitch_detector_underruns) {
+    GlitchDetector::Config config;
+    config.stream_gap_ms = 100.0f;
+    GlitchDetector detector(kSampleRate, config);
+    GlitchDetector::Context context;
+
+    // Silence before the stream starts is not an underrun
+    detector.insertedSilence(kPacket, context);
+
+    uint64_t sequence = 0;
+    feed(detector, sine(4 * kPacket, 440.0, 0.5), sequence);
+    context.packet_sequence = sequence;
+    detector.insertedSilence(100, context);
+    detector.insertedSilence(kPacket, context);
+    feed(detector, sine(4 * kPacket, 440.0, 0.5, 4 * kPacket), sequence);
+
+    auto events = drain(detector);
+    CHECK_EQ(events.size(), 1u);
+    CHECK(events[0].type == GlitchDetector::Type::UNDERRUN);
+    CHECK_EQ(events[0].position, 5 * kPacket);
+    CHECK_EQ(events[0].length, 100 + kPacket);
+    CHECK_EQ(events[0].first_packet, 4u);
+    CHECK_EQ(events[0].last_packet, 5u);
+
+    // A gap longer than stream_gap_ms is the stream stopping and restarting
+    context.packet_sequence = sequence;
+    detector.insertedSilence(kSampleRate, context);
+    feed(detector, sine(4 * kPacket, 440.0, 0.5), sequence);
+    CHECK_EQ(detector.getTotalCount(), 1u);
+    CHECK_EQ(detector.getPosition(), 14 * kPacket + 100 + kSampleRate);
+}
+
+TEST(glitch_detector_log_full) {
+    GlitchDetector::Config config;
+    config.event_capacity = 16;
+    GlitchDetector detector(kSampleRate, config);
+
+    // 20 separate clipping bursts
+    std::vector<float> samples(20 * 64, 0.25f);
+    for (size_t burst = 0; burst < 20; ++burst) {
+        std::fill(samples.begin() + burst * 64, samples.begin() + burst * 64 + 8, 1.0f);
+    }
+    uint64_t sequence = 0;
+    feed(detector, samples, sequence);
+
+    CHECK_EQ(detector.getCount(GlitchDetector::Type::CLIPPING), 20u);
+    CHECK_EQ(detector.getUnloggedCount(), 4u);
+    auto events = drain(detector);
+    CHECK_EQ(events.size(), 16u);
+    CHECK_EQ(events[15].position, 15u * 64);
+}
@@ -0,0 +1,317 @@
+#include "test_framework.h"
+#include "media_pipeline/dsp_kernels.h"
+#include "media_pipeline/inference.h"
+
+#include <cstring>
+#include <random>
+
+using media_pipeline::AudioFeatureExtractor;
+using media_pipeline::FeatureInference;
+using media_pipeline::InferenceModel;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+
+// Builds model files in the documented layout
+class ModelWriter {
+public:
+    ModelWriter(InferenceModel::Type type, uint32_t inputs, uint32_t outputs, uint32_t flags = 0) {
+        bytes_.insert(bytes_.end(), {'M', 'P', 'M', 'L'});
+        put<uint16_t>(InferenceModel::kVersion);
+        put<uint16_t>(static_cast<uint16_t>(type));
+        put(inputs);
+        put(outputs);
+        put(flags);
+    }
+
+    template <typename T>
+    ModelWriter& put(T value) {
+        const char* raw = reinterpret_cast<const char*>(&value);
+        bytes_.insert(bytes_.end(), raw, raw + sizeof(T));
+        return *this;
+    }
+
+    ModelWriter& floats(const std::vector<float>& values) {
+        for (float value : values) {
+            put(value);
+        }
+        return *this;
+    }
+
+    ModelWriter& layer(uint32_t inputs, uint32_t outputs, InferenceModel::Activation activation,
+                       const std::vector<float>& weights, const std::vector<float>& bias) {
+        put(inputs).put(outputs).put(static_cast<uint8_t>(activation));
+        put<uint8_t>(0).put<uint8_t>(0).put<uint8_t>(0);
+        return floats(weights).floats(bias);
+    }
+
+    ModelWriter& node(int32_t feature, float threshold, uint32_t left, uint32_t right) {
+        return put(feature).put(threshold).put(left).put(right);
+    }
+
+    const std::vector<char>& bytes() const { return bytes_; }
+
+    std::unique_ptr<InferenceModel> load() const {
+        std::string error;
+        auto model = InferenceModel::load(bytes_.data(), bytes_.size(), error);
+        if (!model) {
+            media_pipeline::test::fail(__FILE__, __LINE__, "load failed: " + error);
+        }
+        return model;
+    }
+
+private:
+    std::vector<char> bytes_;
+};
+
+std::vector<float> randomValues(size_t count, std::mt19937& rng, float scale = 1.0f) {
+    std::normal_distribution<float> normal(0.0f, scale);
+    std::vector<float> values(count);
+    for (float& value : values) {
+        value = normal(rng);
+    }
+    return values;
+}
+
+// Straightforward dense layer, the reference for the padded batched one
+std::vector<float> denseReference(const std::vector<float>& x, const std::vector<float>& weights,
+                                  const std::vector<float>& bias, size_t inputs, size_t outputs) {
+    std::vector<float> y(outputs);
+    for (size_t r = 0; r < outputs; ++r) {
+        double sum = bias[r];
+        for (size_t i = 0; i < inputs; ++i) {
+            sum += static_cast<double>(weights[r * inputs + i]) * x[i];
+        }
+        y[r] = static_cast<float>(sum);
+    }
+    return y;
+}
+
+} // namespace
+
+TEST(dot_kernel_identical_across_isas) {
+    using namespace media_pipeline::dsp;
+    std::mt19937 rng(21);
+    const Isa original = activeIsa();
+    for (size_t count : {0u, 1u, 7u, 8u, 13u, 64u, 250u}) {
+        std::vector<float> a = randomValues(count + 1, rng);
+        std::vector<float> b = randomValues(count + 1, rng);
+        // Unaligned on purpose
+        const float expected = reference::dot(a.data() + 1, b.data() + 1, count);
+        double exact = 0.0;
+        for (size_t i = 1; i <= count; ++i) {
+            exact += static_cast<double>(a[i]) * b[i];
+        }
+        CHECK_NEAR(expected, exact, 1e-4);
+        for (Isa isa : {Isa::SCALAR, Isa::SSE2, Isa::AVX2, Isa::NEON}) {
+            if (setIsa(isa)) {
+                float actual = dot(a.data() + 1, b.data() + 1, count);
+                CHECK(std::memcmp(&actual, &expected, sizeof(float)) == 0);
+            }
+        }
+    }
+    setIsa(original);
+}
+
+TEST(inference_logistic_regression) {
+    std::mt19937 rng(22);
+    const uint32_t inputs = 13;
+    std::vector<float> weights = randomValues(inputs, rng, 0.5f);
+    std::vector<float> bias = {0.25f};
+    std::vector<float> offset = randomValues(inputs, rng);
+    std::vector<float> scale(inputs, 0.5f);
+    ModelWriter writer(InferenceModel::Type::LINEAR, inputs, 1, InferenceModel::kFlagNormalize);
+    writer.floats(offset).floats(scale).layer(inputs, 1, InferenceModel::Activation::LOGISTIC, weights, bias);
+    auto model = writer.load();
+    CHECK(model->getType() == InferenceModel::Type::LINEAR);
+
+    // More frames than one internal batch, with a row stride wider than the inputs
+    const size_t frames = InferenceModel::kMaxBatch * 2 + 5;
+    const size_t stride = inputs + 3;
+    std::vector<float> data = randomValues(frames * stride, rng, 2.0f);
+    std::vector<float> outputs(frames);
+    model->predict(data.data(), frames, stride, outputs.data());
+    for (size_t f = 0; f < frames; ++f) {
+        std::vector<float> x(inputs);
+        for (size_t i = 0; i < inputs; ++i) {
+            x[i] = (data[f * stride + i] - offset[i]) * scale[i];
+        }
+        float logit = denseReference(x, weights, bias, inputs, 1)[0];
+        CHECK_NEAR(outputs[f], 1.0 / (1.0 + std::exp(-logit)), 1e-5);
+    }
+}
+
+TEST(inference_mlp_matches_reference) {
+    std::mt19937 rng(23);
+    const uint32_t inputs = 6;
+    const uint32_t hidden = 19;
+    const uint32_t classes = 3;
+    std::vector<float> w1 = randomValues(hidden * inputs, rng, 0.6f);
+    std::vector<float> b1 = randomValues(hidden, rng, 0.1f);
+    std::vector<float> w2 = randomValues(classes * hidden, rng, 0.6f);
+    std::vector<float> b2 = randomValues(classes, rng, 0.1f);
+    ModelWriter writer(InferenceModel::Type::MLP, inputs, classes);
+    writer.put<uint32_t>(2);
+    writer.layer(inputs, hidden, InferenceModel::Activation::TANH, w1, b1);
+    writer.layer(hidden, classes, InferenceModel::Activation::SOFTMAX, w2, b2);
+    auto model = writer.load();
+
+    const size_t frames = 40;
+    std::vector<float> data = randomValues(frames * inputs, rng);
+    std::vector<float> outputs(frames * classes);
+    model->predict(data.data(), frames, inputs, outputs.data());
+    for (size_t f = 0; f < frames; ++f) {
+        std::vector<float> x(data.begin() + f * inputs, data.begin() + (f + 1) * inputs);
+        std::vector<float> h = denseReference(x, w1, b1, inputs, hidden);
+        for (float& value : h) {
+            value = std::tanh(value);
+        }
+        std::vector<float> z = denseReference(h, w2, b2, hidden, classes);
+        double total = 0.0;
+        for (float value : z) {
+            total += std::exp(static_cast<double>(value));
+        }
+        double sum = 0.0;
+        for (size_t k = 0; k < classes; ++k) {
+            CHECK_NEAR(outputs[f * classes + k], std::exp(static_cast<double>(z[k])) / total, 1e-5);
+            sum += outputs[f * classes + k];
+        }
+        CHECK_NEAR(sum, 1.0, 1e-5);
+    }
+}
+
+TEST(inference_random_forest) {
+    // Two stumps on x0 / x1 voting over two classes, and a deeper tree
+    ModelWriter writer(InferenceModel::Type::TREE_ENSEMBLE, 2, 2);
+    writer.put<uint32_t>(2);
+    writer.put<uint32_t>(3);
+    writer.node(0, 0.5f, 1, 2).node(-1, 0.0f, 0, 0).node(-1, 0.0f, 1, 0);
+    writer.put<uint32_t>(5);
+    writer.node(1, 0.0f, 1, 2).node(-1, 0.0f, 0, 0).node(0, 2.0f, 3, 4).node(-1, 0.0f, 1, 0).node(-1, 0.0f, 2, 0);
+    writer.put<uint32_t>(3);
+    writer.floats({1.0f, 0.0f, 0.0f, 1.0f, 0.5f, 0.5f});
+    auto model = writer.load();
+
+    const float nan = std::nanf("");
+    std::vector<float> frames = {
+        0.0f, -1.0f,   // Both trees: class 0
+        1.0f, 1.0f,    // Tree 1 class 1, tree 2 (x0 <= 2) class 1
+        3.0f, 1.0f,    // Tree 1 class 1, tree 2 leaf 2 (0.5 / 0.5)
+        nan, -1.0f,    // NaN goes right in tree 1
+    };
+    std::vector<float> outputs(8);
+    model->predict(frames.data(), 4, 2, outputs.data());
+    const float expected[] = {1.0f, 0.0f, 0.0f, 1.0f, 0.25f, 0.75f, 0.5f, 0.5f};
+    for (size_t i = 0; i < 8; ++i) {
+        CHECK_NEAR(outputs[i], expected[i], 1e-6);
+    }
+}
+
+TEST(inference_rejects_bad_models) {
+    std::string error;
+    CHECK(!InferenceModel::load(nullptr, 0, error));
+    CHECK(!InferenceModel::loadFile("/nonexistent/model.mpml", error));
+
+    // A tree whose child points backwards could loop forever
+    ModelWriter cyclic(InferenceModel::Type::TREE_ENSEMBLE, 1, 1);
+    cyclic.put<uint32_t>(1).put<uint32_t>(2).node(0, 0.0f, 1, 0).node(-1, 0.0f, 0, 0);
+    cyclic.put<uint32_t>(1).floats({1.0f});
+    CHECK(!InferenceModel::load(cyclic.bytes().data(), cyclic.bytes().size(), error));
+
+    // Mismatched layer chain
+    ModelWriter chain(InferenceModel::Type::MLP, 2, 1);
+    chain.put<uint32_t>(2);
+    chain.layer(2, 3, InferenceModel::Activation::RELU, std::vector<float>(6), std::vector<float>(3));
+    chain.layer(4, 1, InferenceModel::Activation::IDENTITY, std::vector<float>(4), std::vector<float>(1));
+    CHECK(!InferenceModel::load(chain.bytes().data(), chain.bytes().size(), error));
+
+    // Truncations and random corruption of a valid model never crash and
+    // never produce a model that walks out of bounds
+    std::mt19937 rng(24);
+    ModelWriter valid(InferenceModel::Type::MLP, 4, 2);
+    valid.put<uint32_t>(1).layer(4, 2, InferenceModel::Activation::RELU, randomValues(8, rng), randomValues(2, rng));
+    const std::vector<char>& good = valid.bytes();
+    for (size_t length = 0; length < good.size(); ++length) {
+        CHECK(!InferenceModel::load(good.data(), length, error));
+    }
+    std::vector<float> frame = {1.0f, 2.0f, 3.0f, 4.0f};
+    for (int i = 0; i < 5000; ++i) {
+        std::vector<char> bad = good;
+        bad[rng() % bad.size()] = static_cast<char>(rng());
+        auto model = InferenceModel::load(bad.data(), bad.size(), error);
+        if (model) {
+            std::vector<float> outputs(model->getOutputCount());
+            if (model->getInputCount() == 4) {
+                model->predict(frame.data(), 1, 4, outputs.data());
+            }
+        }
+    }
+}
+
+TEST(audio_features_tone_and_noise) {
+    AudioFeatureExtractor extractor(kSampleRate);
+    const size_t frames = 40;
+    std::vector<float> tone(extractor.getHop() * frames);
+    for (size_t i = 0; i < tone.size(); ++i) {
+        tone[i] = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * 1000.0 * i / kSampleRate));
+    }
+    std::vector<float> last(AudioFeatureExtractor::kFeatureCount);
+    size_t seen = 0;
+    auto keep = [&](const float* features, size_t count) {
+        CHECK_EQ(count, static_cast<size_t>(AudioFeatureExtractor::kFeatureCount));
+        last.assign(features, features + count);
+        seen++;
+    };
+    extractor.process(tone.data(), tone.size(), keep);
+    CHECK_EQ(seen, frames);
+    CHECK_NEAR(last[AudioFeatureExtractor::RMS_DB], 20.0 * std::log10(0.5 / std::sqrt(2.0)), 0.2);
+    CHECK_NEAR(last[AudioFeatureExtractor::SPECTRAL_CENTROID], 1000.0, 60.0);
+    CHECK_NEAR(last[AudioFeatureExtractor::ZERO_CROSSING_RATE], 2000.0 / kSampleRate, 0.002);
+    CHECK(last[AudioFeatureExtractor::SPECTRAL_FLATNESS] < 0.01f);
+    CHECK(last[AudioFeatureExtractor::SPECTRAL_FLUX] < 0.01f);
+
+    // White noise: flat, with its centroid near a quarter of the sample rate
+    std::mt19937 rng(25);
+    std::vector<float> noise = randomValues(tone.size(), rng, 0.1f);
+    extractor.process(noise.data(), noise.size(), keep);
+    CHECK(last[AudioFeatureExtractor::SPECTRAL_FLATNESS] > 0.3f);
+    CHECK_NEAR(last[AudioFeatureExtractor::SPECTRAL_CENTROID], kSampleRate / 4.0, 1500.0);
+    CHECK(last[AudioFeatureExtractor::SPECTRAL_ROLLOFF] > 0.7f * kSampleRate / 2);
+}
+
+TEST(feature_inference_chain) {
+    // Logistic regression on the RMS level alone: loud above -30 dBFS
+    std::vector<float> weights(AudioFeatureExtractor::kFeatureCount, 0.0f);
+    weights[AudioFeatureExtractor::RMS_DB] = 1.0f;
+    ModelWriter writer(InferenceModel::Type::LINEAR, AudioFeatureExtractor::kFeatureCount, 1);
+    writer.layer(AudioFeatureExtractor::kFeatureCount, 1, InferenceModel::Activation::LOGISTIC, weights, {30.0f});
+
+    std::string error;
+    auto inference = FeatureInference::create(writer.load(), kSampleRate, 8, error);
+    CHECK(inference != nullptr);
+
+    std::vector<float> results;
+    auto collect = [&](const float* outputs, size_t count) {
+        CHECK_EQ(count, 1u);
+        results.push_back(outputs[0]);
+    };
+    const size_t window = inference->getWindowFrames() * 512;
+    std::vector<float> block(window * 4);
+    for (size_t i = 0; i < block.size(); ++i) {
+        float level = i < block.size() / 2 ? 0.001f : 0.5f;
+        block[i] = level * static_cast<float>(std::sin(2.0 * M_PI * 440.0 * i / kSampleRate));
+    }
+    // Capture-sized blocks
+    for (size_t offset = 0; offset < block.size(); offset += 480) {
+        inference->process(block.data() + offset, std::min<size_t>(480, block.size() - offset), collect);
+    }
+    CHECK_EQ(results.size(), 4u);
+    CHECK(results[0] < 0.01f);
+    CHECK(results[3] > 0.99f);
+
+    // Models that do not take the audio features are refused
+    ModelWriter other(InferenceModel::Type::LINEAR, 3, 1);
+    other.layer(3, 1, InferenceModel::Activation::IDENTITY, {1.0f, 1.0f, 1.0f}, {0.0f});
+    CHECK(FeatureInference::create(other.load(), kSampleRate, 8, error) == nullptr);
+}
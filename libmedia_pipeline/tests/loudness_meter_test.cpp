@@ -0,0 +1,94 @@
+#include "test_framework.h"
+#include "media_pipeline/loudness_meter.h"
+
+#include <cmath>
+#include <vector>
+
+using media_pipeline::LoudnessMeter;
+
+namespace {
+
+// Stereo sine, the same on both channels (EBU Tech 3341 test signals)
+std::vector<float> stereoSine(int sample_rate, double seconds, double frequency, double dbfs, double phase = 0.0) {
+    const size_t frames = static_cast<size_t>(seconds * sample_rate);
+    const double amplitude = std::pow(10.0, dbfs / 20.0);
+    std::vector<float> samples(frames * 2);
+    for (size_t i = 0; i < frames; ++i) {
+        const float value = static_cast<float>(amplitude * std::sin(2.0 * M_PI * frequency * i / sample_rate + phase));
+        samples[2 * i] = value;
+        samples[2 * i + 1] = value;
+    }
+    return samples;
+}
+
+void feed(LoudnessMeter& meter, const std::vector<float>& samples) {
+    meter.process(samples.data(), samples.size() / 2);
+}
+
+} // namespace
+
+TEST(loudness_meter_sine_calibration) {
+    // 1 kHz at -23 dBFS on both channels of a stereo pair reads -23 LUFS
+    for (int sample_rate : {44100, 48000}) {
+        LoudnessMeter meter(sample_rate, 2);
+        CHECK_EQ(meter.getReading().integrated_lufs, LoudnessMeter::kSilence);
+        feed(meter, stereoSine(sample_rate, 5.0, 997.0, -23.0));
+        const auto reading = meter.getReading();
+        CHECK_NEAR(reading.momentary_lufs, -23.0, 0.1);
+        CHECK_NEAR(reading.short_term_lufs, -23.0, 0.1);
+        CHECK_NEAR(reading.integrated_lufs, -23.0, 0.1);
+        CHECK_NEAR(reading.sample_peak_dbfs, -23.0, 0.01);
+        CHECK_NEAR(reading.true_peak_dbtp, -23.0, 0.1);
+        CHECK_EQ(reading.frames, static_cast<uint64_t>(5 * sample_rate));
+    }
+}
+
+TEST(loudness_meter_gating) {
+    // Tech 3341 case 4: the -72 dBFS parts fall under the absolute gate,
+    // the -36 dBFS parts under the relative one
+    LoudnessMeter meter(48000, 2);
+    const std::vector<float> quiet = stereoSine(48000, 10.0, 997.0, -72.0);
+    const std::vector<float> soft = stereoSine(48000, 10.0, 997.0, -36.0);
+    const std::vector<float> program = stereoSine(48000, 60.0, 997.0, -23.0);
+    for (const auto* part : {&quiet, &soft, &program, &soft, &quiet}) {
+        feed(meter, *part);
+    }
+    CHECK_NEAR(meter.getIntegrated(), -23.0, 0.1);
+    CHECK(meter.getMomentary() < -70.0);
+
+    // Steps reported as they complete, whatever the call sizes
+    meter.reset();
+    CHECK_EQ(meter.getIntegrated(), LoudnessMeter::kSilence);
+    std::vector<float> tone = stereoSine(48000, 1.0, 997.0, -20.0);
+    size_t steps = 0;
+    for (size_t offset = 0; offset < tone.size() / 2;) {
+        const size_t frames = std::min<size_t>(777, tone.size() / 2 - offset);
+        steps += meter.process(tone.data() + offset * 2, frames);
+        offset += frames;
+    }
+    CHECK_EQ(steps, 10u);
+    CHECK_NEAR(meter.getMomentary(), -20.0, 0.1);
+}
+
+TEST(loudness_meter_channel_weights) {
+    // One channel alone is 3 dB below both; a weight of 0 leaves it out
+    LoudnessMeter meter(48000, 2);
+    meter.setChannelWeight(1, 0.0);
+    feed(meter, stereoSine(48000, 1.0, 997.0, -20.0));
+    CHECK_NEAR(meter.getMomentary(), -23.01, 0.1);
+}
+
+TEST(loudness_meter_true_peak) {
+    // fs/4 with a 45 degree phase: every sample lands at 0.707 of the peak,
+    // which lies halfway between samples (Tech 3341 true-peak cases)
+    LoudnessMeter meter(48000, 2);
+    CHECK_EQ(meter.getOversampling(), 4u);
+    feed(meter, stereoSine(48000, 1.0, 12000.0, -6.0, M_PI / 4.0));
+    const auto reading = meter.getReading();
+    CHECK_NEAR(reading.sample_peak_dbfs, -9.01, 0.05);
+    CHECK_NEAR(reading.true_peak_dbtp, -6.0, 0.2);
+
+    // High sample rates need less oversampling
+    CHECK_EQ(LoudnessMeter(96000, 1).getOversampling(), 2u);
+    CHECK_EQ(LoudnessMeter(192000, 1).getOversampling(), 1u);
+}
@@ -0,0 +1,175 @@
+#include "test_framework.h"
+#include "media_pipeline/mic_chain.h"
+
+#include <random>
+
+using media_pipeline::AutoGainControl;
+using media_pipeline::MicChain;
+using media_pipeline::NoiseGate;
+using media_pipeline::NoiseSuppressor;
+using media_pipeline::SoftLimiter;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+
+float dbToLinear(float db) {
+    return std::pow(10.0f, db / 20.0f);
+}
+
+double rms(const float* data, size_t count) {
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += static_cast<double>(data[i]) * data[i];
+    }
+    return std::sqrt(sum / count);
+}
+
+// Amplitude of the frequency component in data, by projection
+double toneAmplitude(const float* data, size_t count, double frequency, size_t first_index) {
+    double in_phase = 0.0;
+    double quadrature = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double phase = 2.0 * M_PI * frequency * (first_index + i) / kSampleRate;
+        in_phase += data[i] * std::cos(phase);
+        quadrature += data[i] * std::sin(phase);
+    }
+    return 2.0 * std::sqrt(in_phase * in_phase + quadrature * quadrature) / count;
+}
+
+void processInBlocks(const std::function<void(float*, size_t)>& process, std::vector<float>& signal, size_t block) {
+    for (size_t offset = 0; offset < signal.size(); offset += block) {
+        process(signal.data() + offset, std::min(block, signal.size() - offset));
+    }
+}
+
+} // namespace
+
+TEST(soft_limiter_shape) {
+    SoftLimiter limiter(0.9f);
+    std::vector<float> ramp(4001);
+    for (size_t i = 0; i < ramp.size(); ++i) {
+        ramp[i] = -4.0f + 0.002f * i;
+    }
+    std::vector<float> limited = ramp;
+    limiter.process(limited.data(), limited.size());
+    for (size_t i = 0; i < ramp.size(); ++i) {
+        if (std::fabs(ramp[i]) <= 0.9f) {
+            CHECK_EQ(limited[i], ramp[i]);
+        }
+        CHECK(std::fabs(limited[i]) < 1.0f);
+        if (i > 0) {
+            CHECK(limited[i] >= limited[i - 1]);
+        }
+    }
+}
+
+TEST(noise_gate_hysteresis) {
+    NoiseGate gate(kSampleRate);   // Opens at -45 dBFS, closes below -52 after 80 ms
+    const size_t segment = kSampleRate / 2;
+    auto run = [&](float level_db) {
+        std::vector<float> block(segment);
+        for (size_t i = 0; i < segment; ++i) {
+            block[i] = dbToLinear(level_db) * (i % 2 ? 1.0f : -1.0f);
+        }
+        processInBlocks([&](float* data, size_t count) { gate.process(data, count); }, block, 480);
+        return std::fabs(block.back()) / dbToLinear(level_db);  // Gain at the end of the segment
+    };
+
+    CHECK(run(-48.0f) < 0.02f);       // Between the thresholds: stays closed
+    CHECK(!gate.isOpen());
+    CHECK_NEAR(run(-30.0f), 1.0f, 1e-4);
+    CHECK(gate.isOpen());
+    CHECK_NEAR(run(-48.0f), 1.0f, 1e-4);  // Between the thresholds: stays open
+    CHECK(gate.isOpen());
+    CHECK(run(-60.0f) < 0.1f);        // Held, then released
+    CHECK(!gate.isOpen());
+    CHECK(run(-60.0f) < 0.02f);
+}
+
+TEST(noise_suppressor_keeps_tone_removes_noise) {
+    NoiseSuppressor suppressor(kSampleRate);
+    std::mt19937 rng(12);
+    std::normal_distribution<float> noise(0.0f, dbToLinear(-40.0f));
+
+    // One second of noise, then a 1 kHz tone over the same noise
+    const size_t length = 2 * kSampleRate;
+    const double frequency = 1000.0;
+    const float amplitude = dbToLinear(-20.0f);
+    std::vector<float> signal(length);
+    for (size_t i = 0; i < length; ++i) {
+        signal[i] = noise(rng);
+        if (i >= length / 2) {
+            signal[i] += amplitude * static_cast<float>(std::sin(2.0 * M_PI * frequency * i / kSampleRate));
+        }
+    }
+    std::vector<float> output = signal;
+    processInBlocks([&](float* data, size_t count) { suppressor.process(data, count); }, output, 441);
+
+    const size_t latency = suppressor.getLatency();
+    const size_t window = kSampleRate / 4;
+
+    // Noise alone, once the estimate has settled
+    size_t noise_start = length / 2 - window;
+    double reduction = rms(output.data() + noise_start + latency, window - latency) /
+                       rms(signal.data() + noise_start, window - latency);
+    CHECK(reduction < dbToLinear(-10.0f));
+
+    // The tone comes through within 1 dB
+    size_t tone_start = length - window;
+    double tone = toneAmplitude(output.data() + tone_start, window, frequency, tone_start - latency);
+    CHECK(std::fabs(20.0 * std::log10(tone / amplitude)) < 1.0);
+}
+
+TEST(auto_gain_control_target_and_lookahead) {
+    AutoGainControl agc(kSampleRate);   // Target -20 dBFS RMS, gain 0.1x - 5x, ceiling -1 dBFS
+    const double frequency = 440.0;
+
+    // Two seconds of a quiet tone (-30 dBFS RMS), then a burst near full scale
+    const size_t quiet = 2 * kSampleRate;
+    const size_t length = quiet + kSampleRate / 10;
+    std::vector<float> signal(length);
+    for (size_t i = 0; i < length; ++i) {
+        float level = i < quiet ? dbToLinear(-30.0f) * std::sqrt(2.0f) : 0.9f;
+        signal[i] = level * static_cast<float>(std::sin(2.0 * M_PI * frequency * i / kSampleRate));
+    }
+    processInBlocks([&](float* data, size_t count) { agc.process(data, count); }, signal, 256);
+
+    const size_t latency = agc.getLatency();
+    double settled = rms(signal.data() + quiet - kSampleRate / 4 + latency, kSampleRate / 4 - latency);
+    CHECK(std::fabs(20.0 * std::log10(settled) + 20.0) < 1.0);
+
+    // The gain came down before the burst was played: no sample near clipping
+    float peak = 0.0f;
+    for (size_t i = quiet; i < length; ++i) {
+        peak = std::max(peak, std::fabs(signal[i]));
+    }
+    CHECK(peak < 0.95f);
+}
+
+TEST(mic_chain_capture) {
+    MicChain chain(kSampleRate);
+    MicChain::Settings settings;
+    settings.input_gain = 9.0f;
+    chain.setSettings(settings);
+    CHECK_EQ(chain.getSettings().input_gain, 5.0f);
+    CHECK_EQ(chain.getLatency(), 0u);
+
+    // Full-scale capture pushed 5x over: the limiter keeps it in range
+    std::vector<int16_t> pcm(4096);
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = static_cast<int16_t>(32767.0 * std::sin(2.0 * M_PI * 1000.0 * i / kSampleRate));
+    }
+    std::vector<float> output(pcm.size());
+    chain.processCapture(pcm.data(), output.data(), 512);   // Gain ramps up across the first block
+    chain.processCapture(pcm.data() + 512, output.data() + 512, pcm.size() - 512);
+    for (float sample : output) {
+        CHECK(std::fabs(sample) < 1.0f);
+    }
+
+    settings.input_gain = 1.0f;
+    settings.noise_suppression = true;
+    settings.auto_gain = true;
+    chain.setSettings(settings);
+    CHECK_EQ(chain.getLatency(), chain.getNoiseSuppressor().getLatency() + chain.getAutoGainControl().getLatency());
+}
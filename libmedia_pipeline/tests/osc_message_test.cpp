@@ -0,0 +1,187 @@
+#include "test_framework.h"
+#include "media_pipeline/feature_codec.h"
+#include "media_pipeline/osc_message.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+using media_pipeline::OSCFormatter;
+using media_pipeline::OSCParser;
+
+namespace {
+
+std::string printfFloat(float value) {
+    char buffer[16];
+    int ret = std::snprintf(buffer, sizeof(buffer), "%.3f ", value);
+    return ret > 0 && ret < static_cast<int>(sizeof(buffer)) ? std::string(buffer) : std::string();
+}
+
+void appendBigEndian(std::string& out, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+} // namespace
+
+TEST(formatter_matches_printf) {
+    const float values[] = {0.0f, -0.0f, 1.0f, -1.0f, 0.0005f, -0.0005f, 0.0625f, 0.0015f, 0.9995f,
+                            123.4565f, 999999999.0f, 1e9f, -1e10f, 1e30f, 1e-40f, NAN, INFINITY, -INFINITY};
+    for (float value : values) {
+        std::string formatted;
+        OSCFormatter::appendFloat(formatted, value);
+        CHECK_EQ(formatted, printfFloat(value));
+    }
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> audio(-1.0f, 1.0f);
+    for (int i = 0; i < 200000; ++i) {
+        uint32_t bits = rng();
+        float any;
+        std::memcpy(&any, &bits, sizeof(any));
+        for (float value : {any, audio(rng)}) {
+            std::string formatted;
+            OSCFormatter::appendFloat(formatted, value);
+            CHECK_EQ(formatted, printfFloat(value));
+        }
+    }
+}
+
+TEST(float_message_round_trip) {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> audio(-1.0f, 1.0f);
+    std::vector<float> samples(OSCFormatter::kChunkSamples);
+    for (float& sample : samples) {
+        sample = audio(rng);
+    }
+
+    std::string message;
+    OSCFormatter::appendFloatMessage(message, "/chan1/audio", -1, samples.data(), samples.size());
+    OSCParser::OSCMessage parsed = OSCParser::parseMessage(message);
+    CHECK(parsed.valid);
+    CHECK_EQ(parsed.type, OSCParser::AUDIO);
+    CHECK_EQ(parsed.address, std::string("/chan1/audio"));
+    CHECK_EQ(parsed.floatData.size(), samples.size());
+
+    // Parsing reproduces exactly what strtof makes of the printed text
+    for (size_t i = 0; i < samples.size(); ++i) {
+        CHECK_NEAR(parsed.floatData[i], samples[i], 0.0005);
+        std::string text = printfFloat(samples[i]);
+        CHECK_EQ(parsed.floatData[i], std::strtof(text.c_str(), nullptr));
+    }
+}
+
+TEST(fixed_point_parse_matches_strtof) {
+    char text[32];
+    for (uint32_t q = 0; q < 10000000; q += 7) {
+        for (const char* sign : {"", "-"}) {
+            std::snprintf(text, sizeof(text), "/audio %s%u.%03u", sign, q / 1000, q % 1000);
+            OSCParser::OSCMessage parsed = OSCParser::parseMessage(text);
+            CHECK_EQ(parsed.floatData.size(), 1u);
+            float expected = std::strtof(text + 7, nullptr);
+            CHECK(std::memcmp(&parsed.floatData[0], &expected, sizeof(float)) == 0);
+        }
+    }
+}
+
+TEST(chunked_address) {
+    const float samples[] = {0.25f, -0.5f};
+    std::string message;
+    OSCFormatter::appendFloatMessage(message, "/audio/stream", 3, samples, 2);
+    CHECK_EQ(message, std::string("/audio/stream_3 0.250 -0.500 "));
+
+    OSCParser::OSCMessage parsed = OSCParser::parseMessage(message);
+    CHECK_EQ(parsed.address, std::string("/audio/stream_3"));
+    CHECK_EQ(parsed.type, OSCParser::AUDIO);
+}
+
+TEST(non_numeric_tokens_skipped) {
+    OSCParser::OSCMessage parsed = OSCParser::parseMessage("/chan1/audio 0.5 abc  1e5x\t-0.250 1e50 +3");
+    CHECK(parsed.valid);
+    CHECK_EQ(parsed.floatData.size(), 4u);
+    CHECK_EQ(parsed.floatData[0], 0.5f);
+    CHECK_EQ(parsed.floatData[1], 1e5f);
+    CHECK_EQ(parsed.floatData[2], -0.25f);
+    CHECK_EQ(parsed.floatData[3], 3.0f);
+
+    CHECK(!OSCParser::parseMessage("/chan1/audio abc").valid);
+    CHECK(!OSCParser::parseMessage("").valid);
+    CHECK(!OSCParser::parseMessage("   ").valid);
+}
+
+TEST(text_message) {
+    OSCParser::OSCMessage parsed = OSCParser::parseMessage("/chan2/text  hello world\nignored");
+    CHECK(parsed.valid);
+    CHECK_EQ(parsed.type, OSCParser::TEXT);
+    CHECK_EQ(parsed.textData, std::string(" hello world"));
+
+    CHECK(!OSCParser::parseMessage("/chan2/text").valid);
+}
+
+TEST(control_message) {
+    // Classified by prefix, whatever the payload or the rest of the address mentions
+    OSCParser::OSCMessage parsed = OSCParser::parseMessage("/control/position /audio/phone1 -45 2");
+    CHECK(parsed.valid);
+    CHECK_EQ(parsed.type, OSCParser::CONTROL);
+    CHECK_EQ(parsed.textData, std::string("/audio/phone1 -45 2"));
+    CHECK_EQ(OSCParser::getMessageType("/control/audio_gain"), OSCParser::CONTROL);
+
+    CHECK_EQ(OSCParser::streamAddress("/audio/phone1_3"), std::string("/audio/phone1"));
+    CHECK_EQ(OSCParser::streamAddress("/audio/phone1"), std::string("/audio/phone1"));
+    CHECK_EQ(OSCParser::streamAddress("/audio/mic_left"), std::string("/audio/mic_left"));
+    CHECK_EQ(OSCParser::streamAddress("/audio/stream_"), std::string("/audio/stream_"));
+}
+
+TEST(quantized_feature_tag) {
+    std::string message = std::string("/analysis/mfcc ") + media_pipeline::feature_codec::kTag + " ";
+    size_t body = message.size();
+    message += std::string("\x03\x00\x00\x01", 4);
+
+    OSCParser::OSCMessage parsed = OSCParser::parseMessage(message);
+    CHECK(parsed.valid);
+    CHECK_EQ(parsed.type, OSCParser::ANALYSIS);
+    CHECK_EQ(parsed.encodedOffset, body);
+    CHECK(parsed.floatData.empty());
+
+    parsed = OSCParser::parseMessage("/analysis/mfcc 1.000 2.000");
+    CHECK_EQ(parsed.encodedOffset, 0u);
+    CHECK_EQ(parsed.floatData.size(), 2u);
+}
+
+TEST(message_types) {
+    CHECK_EQ(OSCParser::getMessageType("/chan1/audio"), OSCParser::AUDIO);
+    CHECK_EQ(OSCParser::getMessageType("/chan2/text"), OSCParser::TEXT);
+    CHECK_EQ(OSCParser::getMessageType("/features/embedding"), OSCParser::ANALYSIS);
+    CHECK_EQ(OSCParser::getMessageType("/clock/sync"), OSCParser::UNKNOWN);
+}
+
+TEST(bundle_parse) {
+    const std::string first = "/chan1/audio 0.100 ";
+    const std::string second = "/chan2/text hi";
+    std::string bundle("#bundle\0", 8);
+    uint64_t timetag = (2208988800ULL + 1700000000ULL) << 32 | 0x80000000ULL;
+    appendBigEndian(bundle, timetag, 8);
+    for (const std::string& element : {first, second}) {
+        appendBigEndian(bundle, element.size(), 4);
+        bundle += element;
+    }
+
+    OSCParser::OSCBundle parsed;
+    CHECK(OSCParser::isBundle(bundle.data(), bundle.size()));
+    CHECK(OSCParser::parseBundle(bundle.data(), bundle.size(), parsed));
+    CHECK_EQ(parsed.timetag, timetag);
+    CHECK_EQ(parsed.elements.size(), 2u);
+    CHECK_EQ(std::string(parsed.elements[0].first, parsed.elements[0].second), first);
+    CHECK_EQ(std::string(parsed.elements[1].first, parsed.elements[1].second), second);
+    CHECK_EQ(OSCParser::timetagToUnixNs(timetag), 1700000000500000000ULL);
+
+    // Truncated element, zero-sized element, not a bundle
+    CHECK(!OSCParser::parseBundle(bundle.data(), bundle.size() - 1, parsed));
+    std::string empty_element = bundle.substr(0, 16);
+    appendBigEndian(empty_element, 0, 4);
+    CHECK(!OSCParser::parseBundle(empty_element.data(), empty_element.size(), parsed));
+    CHECK(!OSCParser::isBundle(first.data(), first.size()));
+    CHECK_EQ(OSCParser::timetagToUnixNs(OSCParser::kImmediateTimetag), 0u);
+}
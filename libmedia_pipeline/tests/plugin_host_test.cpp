@@ -0,0 +1,141 @@
+#include "test_framework.h"
+#include "media_pipeline/plugin_host.h"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+using media_pipeline::PluginHost;
+using media_pipeline::PluginNode;
+
+// The test plugin (test_plugin.c) is built into a directory of its own
+#ifndef MP_TEST_PLUGIN_DIR
+#error "MP_TEST_PLUGIN_DIR must name the directory holding the test plugin"
+#endif
+
+namespace {
+
+PluginHost& loadedHost() {
+    static PluginHost host;
+    static bool loaded = false;
+    if (!loaded) {
+        std::vector<std::string> errors;
+        CHECK_EQ(host.loadDirectory(MP_TEST_PLUGIN_DIR, errors), 1u);
+        CHECK(errors.empty());
+        loaded = true;
+    }
+    return host;
+}
+
+void noProcess(mp_plugin_instance*, const mp_plugin_block*) {}
+
+} // namespace
+
+TEST(plugin_host_load) {
+    PluginHost& host = loadedHost();
+    CHECK_EQ(host.getDescriptors().size(), 2u);
+    CHECK(host.find("test.gain") != nullptr);
+    CHECK(host.find("test.delay") != nullptr);
+    CHECK(host.find("test.missing") == nullptr);
+
+    // Ids stay unique however the same node arrives
+    std::string error;
+    CHECK(!host.load(std::string(MP_TEST_PLUGIN_DIR) + "/libmp_test_plugin.so", error));
+    CHECK(error.find("already loaded") != std::string::npos);
+    CHECK(!host.add(host.find("test.gain"), error));
+    CHECK(!host.load("/nonexistent/libplugin.so", error));
+    std::vector<std::string> errors;
+    CHECK_EQ(host.loadDirectory("/nonexistent", errors), 0u);
+    CHECK_EQ(errors.size(), 1u);
+
+    // Descriptors from another ABI version or without process() are refused
+    PluginHost fresh;
+    mp_plugin_descriptor descriptor = *host.find("test.delay");
+    descriptor.id = "test.other";
+    descriptor.abi_version = MP_PLUGIN_ABI_VERSION + 1;
+    CHECK(!fresh.add(&descriptor, error));
+    descriptor.abi_version = MP_PLUGIN_ABI_VERSION;
+    descriptor.process = nullptr;
+    CHECK(!fresh.add(&descriptor, error));
+    descriptor.process = noProcess;
+    CHECK(fresh.add(&descriptor, error));
+
+    // Shorter descriptors load with what they leave off read as NULL; one
+    // that stops before process() is refused
+    PluginHost older;
+    descriptor.id = "test.short";
+    descriptor.struct_size = offsetof(mp_plugin_descriptor, set_param);
+    CHECK(descriptor.reset != nullptr);
+    CHECK(older.add(&descriptor, error));
+    const mp_plugin_descriptor* stored = older.find("test.short");
+    CHECK(stored != nullptr && stored != &descriptor);
+    CHECK(stored->set_param == nullptr);
+    CHECK(stored->reset == nullptr);
+    CHECK(stored->process == noProcess);
+    auto node = older.createNode("test.short", 48000, 2, 4, error);
+    CHECK(node != nullptr);
+    node->reset();
+    descriptor.id = "test.shorter";
+    descriptor.struct_size = offsetof(mp_plugin_descriptor, process);
+    CHECK(!older.add(&descriptor, error));
+    CHECK(older.find("test.shorter") == nullptr);
+}
+
+TEST(plugin_node_parameters) {
+    std::string error;
+    auto gain = loadedHost().createNode("test.gain", 48000, 1, 64, error);
+    CHECK(gain != nullptr);
+    CHECK_EQ(gain->getLatency(), 0u);
+    CHECK(loadedHost().createNode("test.missing", 48000, 1, 64, error) == nullptr);
+
+    // Blocks longer than max_frames are split
+    std::vector<float> block(100, 1.0f);
+    gain->process(block.data(), block.size());
+    for (float sample : block) {
+        CHECK_EQ(sample, 1.0f);
+    }
+
+    // Applied from the next block, clamped to the range
+    CHECK(gain->setParameter("gain_db", -20.0f * std::log10(2.0f)));
+    CHECK(!gain->setParameter("volume", 1.0f));
+    gain->process(block.data(), block.size());
+    for (float sample : block) {
+        CHECK_NEAR(sample, 0.5, 1e-6);
+    }
+    CHECK(gain->setParameter(0, 100.0f));
+    CHECK_EQ(gain->getParameter(0), 12.0f);
+    CHECK_EQ(gain->findParameter("volume"), gain->getParameterCount());
+}
+
+TEST(plugin_node_planar_out_of_place) {
+    std::string error;
+    CHECK(loadedHost().createNode("test.delay", 48000, 3, 4, error) == nullptr);
+    auto delay = loadedHost().createNode("test.delay", 48000, 2, 4, error);
+    CHECK(delay != nullptr);
+    CHECK_EQ(delay->getLatency(), 3u);
+
+    // Interleaved stereo ramps through 4-frame planar blocks, in calls of varying length
+    std::vector<float> played;
+    size_t frame = 0;
+    for (size_t frames : {10u, 1u, 2u, 7u}) {
+        std::vector<float> block(frames * 2);
+        for (size_t i = 0; i < frames; ++i, ++frame) {
+            block[2 * i] = static_cast<float>(frame + 1);
+            block[2 * i + 1] = -static_cast<float>(frame + 1);
+        }
+        delay->process(block.data(), frames);
+        played.insert(played.end(), block.begin(), block.end());
+    }
+    for (size_t i = 0; i < frame; ++i) {
+        const float expected = i < 3 ? 0.0f : static_cast<float>(i - 2);
+        CHECK_EQ(played[2 * i], expected);
+        CHECK_EQ(played[2 * i + 1], -expected);
+    }
+
+    delay->reset();
+    std::vector<float> silence(8, 0.0f);
+    delay->process(silence.data(), 4);
+    for (float sample : silence) {
+        CHECK_EQ(sample, 0.0f);
+    }
+}
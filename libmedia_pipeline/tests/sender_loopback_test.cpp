@@ -0,0 +1,273 @@
+#include "test_framework.h"
+#include "media_pipeline/osc_message.h"
+#include "media_pipeline/osc_sender.h"
+#include "media_pipeline/shm_ring.h"
+#include "media_pipeline/slip.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+using media_pipeline::OSCParser;
+using media_pipeline::OSCSender;
+
+namespace {
+
+constexpr int kBlockSamples = 256;  // Two chunks per block
+
+float sampleValue(int block, int i) {
+    return static_cast<float>((block * 7 + i) % 2001 - 1000) / 1000.0f;
+}
+
+int bindSocket(int type, int port) {
+    int fd = socket(AF_INET, type, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int boundPort(int fd) {
+    sockaddr_in addr{};
+    socklen_t length = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length);
+    return ntohs(addr.sin_port);
+}
+
+std::vector<std::string> receiveDatagrams(int fd, int idle_ms) {
+    std::vector<std::string> messages;
+    char buffer[65536];
+    pollfd pfd{fd, POLLIN, 0};
+    while (poll(&pfd, 1, idle_ms) > 0) {
+        ssize_t length = recv(fd, buffer, sizeof(buffer), 0);
+        if (length <= 0) {
+            break;
+        }
+        messages.emplace_back(buffer, static_cast<size_t>(length));
+    }
+    return messages;
+}
+
+/**
+ * Check messages named "/chan1/audio/<block>_<chunk>" against sampleValue()
+ * @return number of blocks fully seen
+ */
+int verifyBlocks(const std::vector<std::string>& messages, int blocks) {
+    std::vector<int> chunks_seen(blocks, 0);
+    for (const std::string& message : messages) {
+        OSCParser::OSCMessage parsed = OSCParser::parseMessage(message);
+        CHECK(parsed.valid);
+        CHECK_EQ(parsed.type, OSCParser::AUDIO);
+
+        int block = 0;
+        int chunk = 0;
+        CHECK_EQ(std::sscanf(parsed.address.c_str(), "/chan1/audio/%d_%d", &block, &chunk), 2);
+        CHECK(block >= 0 && block < blocks && (chunk == 0 || chunk == 1));
+        CHECK_EQ(parsed.floatData.size(), media_pipeline::OSCFormatter::kChunkSamples);
+        for (size_t i = 0; i < parsed.floatData.size(); ++i) {
+            int index = chunk * static_cast<int>(media_pipeline::OSCFormatter::kChunkSamples) + static_cast<int>(i);
+            CHECK_NEAR(parsed.floatData[i], sampleValue(block, index), 1e-6);
+        }
+        chunks_seen[block]++;
+    }
+
+    int complete = 0;
+    for (int count : chunks_seen) {
+        CHECK(count <= 2);  // Never duplicated
+        complete += count == 2;
+    }
+    return complete;
+}
+
+void sendBlocks(OSCSender& sender, int blocks) {
+    std::vector<float> samples(kBlockSamples);
+    for (int block = 0; block < blocks; ++block) {
+        for (int i = 0; i < kBlockSamples; ++i) {
+            samples[i] = sampleValue(block, i);
+        }
+        sender.sendAudio("/chan1/audio/" + std::to_string(block), samples.data(), kBlockSamples);
+        if (block % 16 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    }
+}
+
+} // namespace
+
+TEST(sender_udp_loopback) {
+    int fd = bindSocket(SOCK_DGRAM, 0);
+    CHECK(fd >= 0);
+    int rcvbuf = 4 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    const int blocks = 200;
+    {
+        OSCSender sender("127.0.0.1", boundPort(fd));
+        CHECK(sender.isReady());
+        sendBlocks(sender, blocks);
+    }
+
+    std::vector<std::string> messages = receiveDatagrams(fd, 200);
+    close(fd);
+    CHECK_EQ(verifyBlocks(messages, blocks), blocks);
+}
+
+TEST(sender_tcp_loopback) {
+    int listen_fd = bindSocket(SOCK_STREAM, 0);
+    CHECK(listen_fd >= 0);
+    CHECK_EQ(listen(listen_fd, 4), 0);
+    int port = boundPort(listen_fd);
+    int udp_fd = bindSocket(SOCK_DGRAM, port);  // Catches messages sent before the stream is up
+    CHECK(udp_fd >= 0);
+
+    std::vector<std::string> stream_messages;
+    std::thread reader([&] {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        media_pipeline::slip::Decoder decoder;
+        char buffer[16384];
+        ssize_t length;
+        while ((length = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            decoder.feed(buffer, static_cast<size_t>(length),
+                         [&](const char* data, size_t size) { stream_messages.emplace_back(data, size); });
+        }
+        close(fd);
+    });
+
+    const int blocks = 300;
+    uint64_t fallback = 0;
+    {
+        OSCSender sender("127.0.0.1", port);
+        sender.setTransport(OSCSender::Transport::TCP, 1000);
+        sendBlocks(sender, blocks);
+        CHECK(sender.isTcpConnected());
+        fallback = sender.getUdpFallbackCount();
+    }
+    reader.join();
+    close(listen_fd);
+
+    std::vector<std::string> datagrams = receiveDatagrams(udp_fd, 100);
+    close(udp_fd);
+    CHECK_EQ(datagrams.size(), fallback);
+
+    std::vector<std::string> all = stream_messages;
+    all.insert(all.end(), datagrams.begin(), datagrams.end());
+    CHECK_EQ(verifyBlocks(all, blocks), blocks);
+    CHECK(stream_messages.size() > datagrams.size());
+}
+
+TEST(sender_shared_memory_loopback) {
+    std::string error;
+    std::string path = "/tmp/media_pipeline_test_sender_" + std::to_string(getpid());
+    auto ring = media_pipeline::ShmRing::create(path, 4 * 1024 * 1024, error);
+    CHECK(ring != nullptr);
+
+    const int blocks = 200;
+    {
+        OSCSender sender("127.0.0.1", 9);  // UDP only while the ring is not attached
+        sender.setSharedMemoryDestination(path);
+        sendBlocks(sender, blocks);
+        CHECK(sender.isSharedMemoryAttached());
+        CHECK_EQ(sender.getUdpFallbackCount(), 0u);
+    }
+
+    std::vector<std::string> messages;
+    while (ring->read([&](const char* data, size_t length, uint64_t) { messages.emplace_back(data, length); },
+                      1024) > 0) {
+    }
+    CHECK_EQ(verifyBlocks(messages, blocks), blocks);
+    CHECK_EQ(ring->getDroppedCount(), 0u);
+}
+
+TEST(sender_concurrent_features_and_encoding) {
+    int fd = bindSocket(SOCK_DGRAM, 0);
+    CHECK(fd >= 0);
+    int rcvbuf = 4 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    // Capture thread sends audio while another thread sends features and a third reconfigures
+    const int blocks = 200;
+    const int iterations = 200 * media_pipeline::test::stressScale();
+    {
+        OSCSender sender("127.0.0.1", boundPort(fd));
+        std::thread capture([&] { sendBlocks(sender, blocks); });
+        std::thread features([&] {
+            float values[13];
+            for (int i = 0; i < iterations; ++i) {
+                for (int j = 0; j < 13; ++j) {
+                    values[j] = sampleValue(i, j);
+                }
+                sender.sendFeatures("/analysis/mfcc", values, 13);
+            }
+        });
+        for (int i = 0; i < iterations / 10; ++i) {
+            sender.setFeatureEncoding(i % 3 == 0 ? 0 : (i % 3 == 1 ? 8 : 16), 10);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        capture.join();
+        features.join();
+    }
+
+    std::vector<std::string> audio;
+    size_t feature_count = 0;
+    for (std::string& message : receiveDatagrams(fd, 200)) {
+        if (message.compare(0, 7, "/chan1/") == 0) {
+            audio.push_back(std::move(message));
+        } else {
+            CHECK(message.compare(0, 14, "/analysis/mfcc") == 0);
+            feature_count++;
+        }
+    }
+    close(fd);
+    CHECK_EQ(verifyBlocks(audio, blocks), blocks);
+    CHECK(feature_count > 0);
+}
+
+TEST(sender_transport_switch_while_sending) {
+    int fd = bindSocket(SOCK_DGRAM, 0);
+    CHECK(fd >= 0);
+    int rcvbuf = 4 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    std::string error;
+    std::string path = "/tmp/media_pipeline_test_switch_" + std::to_string(getpid());
+    auto ring = media_pipeline::ShmRing::create(path, 4 * 1024 * 1024, error);
+    CHECK(ring != nullptr);
+
+    // The UI thread flips between UDP and the ring, and polls its state, while the capture thread writes
+    const int blocks = 400;
+    {
+        OSCSender sender("127.0.0.1", boundPort(fd));
+        std::thread capture([&] { sendBlocks(sender, blocks); });
+        for (int i = 0; i < 40; ++i) {
+            if (i % 2 == 0) {
+                sender.setSharedMemoryDestination(path);
+            } else {
+                sender.setTransport(OSCSender::Transport::UDP);
+            }
+            sender.isSharedMemoryAttached();
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        capture.join();
+    }
+
+    // Every chunk arrives exactly once, over one path or the other
+    std::vector<std::string> messages = receiveDatagrams(fd, 200);
+    close(fd);
+    while (ring->read([&](const char* data, size_t length, uint64_t) { messages.emplace_back(data, length); },
+                      1024) > 0) {
+    }
+    CHECK_EQ(verifyBlocks(messages, blocks), blocks);
+}
@@ -0,0 +1,169 @@
+#include "test_framework.h"
+#include "media_pipeline/shm_ring.h"
+
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+using media_pipeline::ShmRing;
+
+namespace {
+
+struct Record {
+    uint32_t writer;
+    uint32_t sequence;
+    uint32_t length;
+};
+
+// Payload bytes derived from the header, so a torn or misplaced record is detected
+char patternByte(const Record& record, size_t i) {
+    return static_cast<char>((record.writer * 131 + record.sequence * 31 + i) & 0xFF);
+}
+
+std::string ringPath(const char* name) {
+    return "/tmp/media_pipeline_test_" + std::string(name) + "_" + std::to_string(getpid());
+}
+
+} // namespace
+
+TEST(shm_ring_round_trip) {
+    std::string error;
+    auto ring = ShmRing::create(ringPath("rt"), 64 * 1024, error);
+    CHECK(ring != nullptr);
+    auto writer = ShmRing::attach(ring->getName(), error);
+    CHECK(writer != nullptr);
+
+    const std::string message = "/chan1/audio 0.100 0.200 ";
+    CHECK(writer->write(message.data(), message.size(), 1234));
+
+    std::string received;
+    uint64_t timestamp = 0;
+    size_t count = ring->read([&](const char* data, size_t length, uint64_t timestamp_ns) {
+        received.assign(data, length);
+        timestamp = timestamp_ns;
+    }, 16);
+    CHECK_EQ(count, 1u);
+    CHECK_EQ(received, message);
+    CHECK_EQ(timestamp, 1234u);
+
+    // Larger than the ring: refused rather than corrupting it
+    std::string huge(ring->getCapacity(), 'x');
+    CHECK(!writer->write(huge.data(), huge.size(), 0));
+}
+
+TEST(shm_ring_concurrent_writers) {
+    const int kWriters = 3;
+    const uint32_t kMessages = 20000 * media_pipeline::test::stressScale();
+
+    std::string error;
+    auto ring = ShmRing::create(ringPath("mw"), 64 * 1024, error);
+    CHECK(ring != nullptr);
+
+    std::atomic<int> writers_done{0};
+    std::atomic<uint64_t> refused{0};
+    std::vector<std::thread> writers;
+    for (int w = 0; w < kWriters; ++w) {
+        writers.emplace_back([&, w] {
+            std::string attach_error;
+            auto writer = ShmRing::attach(ring->getName(), attach_error);
+            std::vector<char> message(sizeof(Record) + 1024);
+            for (uint32_t s = 0; s < kMessages; ++s) {
+                Record record{static_cast<uint32_t>(w), s, static_cast<uint32_t>((s * 37 + w) % 1000)};
+                std::memcpy(message.data(), &record, sizeof(record));
+                for (size_t i = 0; i < record.length; ++i) {
+                    message[sizeof(record) + i] = patternByte(record, i);
+                }
+                if (!writer->write(message.data(), sizeof(record) + record.length, s)) {
+                    refused.fetch_add(1);
+                }
+                if (s % 64 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            writers_done.fetch_add(1);
+            writer->wakeReader();
+        });
+    }
+
+    std::vector<int64_t> last_sequence(kWriters, -1);
+    uint64_t delivered = 0;
+    bool corrupt = false;
+    auto drain = [&] {
+        return ring->read([&](const char* data, size_t length, uint64_t timestamp_ns) {
+            Record record;
+            if (length < sizeof(record)) {
+                corrupt = true;
+                return;
+            }
+            std::memcpy(&record, data, sizeof(record));
+            bool valid = record.writer < kWriters && length == sizeof(record) + record.length &&
+                         static_cast<int64_t>(record.sequence) > last_sequence[record.writer] &&
+                         timestamp_ns == record.sequence;
+            for (size_t i = 0; valid && i < record.length; ++i) {
+                valid = data[sizeof(record) + i] == patternByte(record, i);
+            }
+            if (!valid) {
+                corrupt = true;
+                return;
+            }
+            last_sequence[record.writer] = record.sequence;
+            delivered++;
+        }, 256);
+    };
+
+    while (writers_done.load() < kWriters) {
+        if (ring->waitForData(10)) {
+            drain();
+        }
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    while (drain() > 0) {
+    }
+
+    CHECK(!corrupt);
+    CHECK_EQ(delivered + refused.load(), static_cast<uint64_t>(kWriters) * kMessages);
+    CHECK_EQ(ring->getDroppedCount(), refused.load());
+    CHECK(delivered > 0);
+}
+
+TEST(shm_ring_writer_lock_held_by_dead_process) {
+    std::string error;
+    auto ring = ShmRing::create(ringPath("dead"), 64 * 1024, error);
+    CHECK(ring != nullptr);
+    auto writer = ShmRing::attach(ring->getName(), error);
+    CHECK(writer != nullptr);
+
+    // A pid that is certainly gone: a child that has exited and been reaped
+    pid_t child = fork();
+    if (child == 0) {
+        _exit(0);
+    }
+    CHECK(child > 0);
+    waitpid(child, nullptr, 0);
+
+    // Leave the writer lock as a writer killed mid-write would: the lock word
+    // follows magic, version, capacity and closed in the ring header
+    int fd = open(ring->getName().c_str(), O_RDWR);
+    CHECK(fd >= 0);
+    void* page = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    CHECK(page != MAP_FAILED);
+    auto* lock = reinterpret_cast<std::atomic<uint32_t>*>(static_cast<char*>(page) + 20);
+    lock->store(static_cast<uint32_t>(child));
+
+    const std::string message = "/chan1/audio 0.5 ";
+    CHECK(writer->write(message.data(), message.size(), 7));
+    CHECK_EQ(lock->load(), 0u);
+    munmap(page, 4096);
+
+    size_t count = ring->read([&](const char* data, size_t length, uint64_t) {
+        CHECK_EQ(std::string(data, length), message);
+    }, 16);
+    CHECK_EQ(count, 1u);
+}
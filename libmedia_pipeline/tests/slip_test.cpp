@@ -0,0 +1,62 @@
+#include "test_framework.h"
+#include "media_pipeline/slip.h"
+
+#include <random>
+
+namespace slip = media_pipeline::slip;
+
+TEST(slip_round_trip) {
+    std::mt19937 rng(3);
+    std::vector<std::string> frames;
+    std::string stream;
+    for (int i = 0; i < 500; ++i) {
+        // Biased towards the END and ESC bytes
+        std::string frame(1 + rng() % 300, '\0');
+        for (char& byte : frame) {
+            uint32_t pick = rng() % 8;
+            byte = static_cast<char>(pick == 0 ? 0xC0 : pick == 1 ? 0xDB : rng());
+        }
+        frames.push_back(frame);
+        slip::encode(frame.data(), frame.size(), stream);
+    }
+
+    // Feed in random-sized pieces, as TCP reads arrive
+    slip::Decoder decoder;
+    std::vector<std::string> decoded;
+    size_t offset = 0;
+    while (offset < stream.size()) {
+        size_t length = std::min<size_t>(1 + rng() % 700, stream.size() - offset);
+        decoder.feed(stream.data() + offset, length,
+                     [&](const char* data, size_t size) { decoded.emplace_back(data, size); });
+        offset += length;
+    }
+
+    CHECK_EQ(decoded.size(), frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        CHECK(decoded[i] == frames[i]);
+    }
+    CHECK_EQ(decoder.getDroppedFrames(), 0u);
+}
+
+TEST(slip_encoded_size_bound) {
+    std::string frame(100, static_cast<char>(0xC0));
+    std::string encoded;
+    slip::encode(frame.data(), frame.size(), encoded);
+    CHECK(encoded.size() <= slip::maxEncodedSize(frame.size()));
+}
+
+TEST(slip_oversized_frame_dropped) {
+    std::string stream;
+    std::string big(200, 'x');
+    std::string small = "/chan1/audio 0.500 ";
+    slip::encode(big.data(), big.size(), stream);
+    slip::encode(small.data(), small.size(), stream);
+
+    slip::Decoder decoder(100);
+    std::vector<std::string> decoded;
+    decoder.feed(stream.data(), stream.size(),
+                 [&](const char* data, size_t size) { decoded.emplace_back(data, size); });
+    CHECK_EQ(decoded.size(), 1u);
+    CHECK(decoded[0] == small);
+    CHECK_EQ(decoder.getDroppedFrames(), 1u);
+}
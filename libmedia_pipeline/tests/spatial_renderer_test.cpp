@@ -0,0 +1,246 @@
+#include "test_framework.h"
+#include "media_pipeline/spatial_renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using media_pipeline::HrirSet;
+using media_pipeline::SpatialRenderer;
+using media_pipeline::SpeakerLayout;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+constexpr size_t kBlock = 256;
+
+std::unique_ptr<SpatialRenderer> panner(const char* layout_spec, size_t max_sources = 4) {
+    SpeakerLayout layout;
+    CHECK(SpeakerLayout::parse(layout_spec, layout));
+    SpatialRenderer::Config config;
+    config.block_size = kBlock;
+    config.max_sources = max_sources;
+    std::string error;
+    auto renderer = SpatialRenderer::createPanner(kSampleRate, layout, config, error);
+    CHECK(renderer != nullptr);
+    return renderer;
+}
+
+std::unique_ptr<SpatialRenderer> binaural(size_t max_sources) {
+    SpatialRenderer::Config config;
+    config.block_size = kBlock;
+    config.max_sources = max_sources;
+    std::string error;
+    auto renderer = SpatialRenderer::createBinaural(kSampleRate, HrirSet::sphericalHead(kSampleRate), config, error);
+    CHECK(renderer != nullptr);
+    return renderer;
+}
+
+size_t peakIndex(const std::vector<float>& interleaved, size_t channel, size_t channels) {
+    size_t peak = 0;
+    for (size_t i = 0; i < interleaved.size() / channels; ++i) {
+        if (std::fabs(interleaved[i * channels + channel]) > std::fabs(interleaved[peak * channels + channel])) {
+            peak = i;
+        }
+    }
+    return peak;
+}
+
+double energy(const std::vector<float>& interleaved, size_t channel, size_t channels) {
+    double sum = 0.0;
+    for (size_t i = channel; i < interleaved.size(); i += channels) {
+        sum += static_cast<double>(interleaved[i]) * interleaved[i];
+    }
+    return sum;
+}
+
+} // namespace
+
+TEST(spatial_renderer_layouts) {
+    SpeakerLayout layout;
+    CHECK(SpeakerLayout::parse("5.0", layout));
+    CHECK_EQ(layout.azimuths.size(), 5u);
+    CHECK(SpeakerLayout::parse("30,-30,110.5,-110", layout));
+    CHECK_EQ(layout.azimuths.size(), 4u);
+    CHECK_NEAR(layout.azimuths[2], 110.5, 1e-6);
+    CHECK(!SpeakerLayout::parse("", layout));
+    CHECK(!SpeakerLayout::parse("30,,-30", layout));
+    CHECK(!SpeakerLayout::parse("surround", layout));
+
+    layout.azimuths = {30.0f, 30.0f};
+    std::string error;
+    CHECK(SpatialRenderer::createPanner(kSampleRate, layout, SpatialRenderer::Config(), error) == nullptr);
+    CHECK(!error.empty());
+}
+
+TEST(spatial_renderer_vbap_gains) {
+    auto stereo = panner("stereo");
+    float gains[8];
+    stereo->computeGains(30.0f, gains);
+    CHECK_NEAR(gains[0], 1.0, 1e-6);
+    CHECK_NEAR(gains[1], 0.0, 1e-6);
+    stereo->computeGains(0.0f, gains);
+    CHECK_NEAR(gains[0], std::sqrt(0.5), 1e-6);
+    CHECK_NEAR(gains[1], std::sqrt(0.5), 1e-6);
+    stereo->computeGains(-15.0f, gains);
+    CHECK(gains[1] > gains[0]);
+    CHECK_NEAR(gains[0] * gains[0] + gains[1] * gains[1], 1.0, 1e-5);
+    // Behind the pair: folded to the middle at constant power
+    stereo->computeGains(180.0f, gains);
+    CHECK_NEAR(gains[0], std::sqrt(0.5), 1e-6);
+    CHECK_NEAR(gains[1], std::sqrt(0.5), 1e-6);
+
+    // 5.0 (L R C Ls Rs): between L and C only
+    auto surround = panner("5.0");
+    surround->computeGains(15.0f, gains);
+    CHECK_NEAR(gains[0], gains[2], 1e-6);
+    CHECK_EQ(gains[1], 0.0f);
+    CHECK_EQ(gains[3], 0.0f);
+    CHECK_NEAR(gains[0] * gains[0] + gains[2] * gains[2], 1.0, 1e-5);
+    surround->computeGains(-110.0f, gains);
+    CHECK_NEAR(gains[4], 1.0, 1e-6);
+    // Continuous across the front and through the rear: no jumps between
+    // pairs (the steepest pair, L-C over 30 degrees, moves 0.053 per degree)
+    float previous[8];
+    surround->computeGains(-180.0f, previous);
+    for (int degrees = -179; degrees <= 180; ++degrees) {
+        surround->computeGains(static_cast<float>(degrees), gains);
+        for (size_t c = 0; c < 5; ++c) {
+            CHECK(std::fabs(gains[c] - previous[c]) < 0.07f);
+            previous[c] = gains[c];
+        }
+    }
+}
+
+TEST(spatial_renderer_panning_render) {
+    auto stereo = panner("stereo", 2);
+    std::vector<float> tone(kBlock * 4);
+    for (size_t i = 0; i < tone.size(); ++i) {
+        tone[i] = std::sin(0.05f * i);
+    }
+    stereo->setPosition(0, 30.0f);
+    stereo->setPosition(1, -30.0f, 4.0f);
+    std::vector<float> quiet(tone.size());
+    for (size_t i = 0; i < tone.size(); ++i) {
+        quiet[i] = tone[i] * 0.5f;
+    }
+    const float* sources[2] = {tone.data(), quiet.data()};
+    std::vector<float> output(tone.size() * 2);
+    CHECK(!stereo->render(sources, output.data(), kBlock + 1));
+    CHECK(stereo->render(sources, output.data(), tone.size()));
+
+    // Faded in over the first block, then exact: left the first source,
+    // right the second at a quarter (4 m)
+    for (size_t i = kBlock; i < tone.size(); ++i) {
+        CHECK_NEAR(output[2 * i], tone[i], 1e-6);
+        CHECK_NEAR(output[2 * i + 1], quiet[i] * 0.25f, 1e-6);
+    }
+    CHECK(std::fabs(output[0]) < 1e-6f);
+
+    // A missing source fades out rather than stopping the others
+    const float* one[2] = {tone.data(), nullptr};
+    CHECK(stereo->render(one, output.data(), kBlock));
+    for (size_t i = 0; i < kBlock; ++i) {
+        CHECK_NEAR(output[2 * i + 1], 0.0, 1e-6);
+    }
+}
+
+TEST(spatial_renderer_binaural_cues) {
+    auto renderer = binaural(1);
+    CHECK_EQ(renderer->getOutputChannels(), 2u);
+
+    // An impulse from the left reaches the left ear first and louder
+    std::vector<float> impulse(kBlock * 4, 0.0f);
+    impulse[kBlock] = 1.0f;
+    const float* sources[1] = {impulse.data()};
+    std::vector<float> output(impulse.size() * 2);
+    renderer->setPosition(0, 90.0f);
+    CHECK(renderer->render(sources, output.data(), impulse.size()));
+    const size_t left = peakIndex(output, 0, 2);
+    const size_t right = peakIndex(output, 1, 2);
+    CHECK(left < right);
+    const double itd_ms = (right - left) * 1000.0 / kSampleRate;
+    CHECK(itd_ms > 0.55 && itd_ms < 0.75);  // Woodworth: (a / c)(1 + pi / 2) = 0.66 ms
+    CHECK(energy(output, 0, 2) > 4.0 * energy(output, 1, 2));
+
+    // Straight ahead: the same at both ears
+    renderer->reset();
+    renderer->setPosition(0, 0.0f);
+    CHECK(renderer->render(sources, output.data(), impulse.size()));
+    for (size_t i = 0; i < impulse.size(); ++i) {
+        CHECK_NEAR(output[2 * i], output[2 * i + 1], 1e-5);
+    }
+    CHECK(energy(output, 0, 2) > 0.1);
+
+    // The HRIR tail rings out after the source stops
+    const float* silent[1] = {nullptr};
+    renderer->reset();
+    renderer->setPosition(0, -90.0f);
+    std::vector<float> block(kBlock * 2);
+    std::vector<float> late(kBlock, 0.0f);
+    late[kBlock - 1] = 1.0f;
+    sources[0] = late.data();
+    CHECK(renderer->render(sources, block.data(), kBlock));
+    CHECK(renderer->render(silent, block.data(), kBlock));
+    CHECK(energy(block, 1, 2) > 0.01);
+}
+
+TEST(spatial_renderer_binaural_movement_is_smooth) {
+    // A tone circling the head one HRIR step per block: crossfaded, each
+    // output step stays within what the tone's own slope allows
+    auto renderer = binaural(1);
+    const double frequency = 300.0;
+    std::vector<float> tone(kBlock * 200);
+    for (size_t i = 0; i < tone.size(); ++i) {
+        tone[i] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * frequency * i / kSampleRate));
+    }
+    std::vector<float> output(kBlock * 2);
+    float last[2] = {0.0f, 0.0f};
+    float largest_step = 0.0f;
+    for (size_t b = 0; b < 200; ++b) {
+        renderer->setPosition(0, 5.0f * b);
+        const float* sources[1] = {tone.data() + b * kBlock};
+        CHECK(renderer->render(sources, output.data(), kBlock));
+        for (size_t i = 0; i < kBlock; ++i) {
+            for (size_t ear = 0; ear < 2; ++ear) {
+                if (b > 0 || i > 0) {
+                    largest_step = std::max(largest_step, std::fabs(output[2 * i + ear] - last[ear]));
+                }
+                last[ear] = output[2 * i + ear];
+            }
+        }
+    }
+    // Tone slope 0.5 * 2 pi f / fs = 0.02 per sample; the near ear's shadow boost can double it
+    CHECK(largest_step < 0.05f);
+}
+
+TEST(spatial_renderer_thirty_moving_sources) {
+    // 30 sources, all moving every block: every one crossfades every block
+    // (the renderer's worst case) and the mix stays finite and bounded
+    const size_t sources_count = 30;
+    auto renderer = binaural(32);
+    std::vector<std::vector<float>> inputs(sources_count, std::vector<float>(kBlock));
+    for (size_t s = 0; s < sources_count; ++s) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            inputs[s][i] = 0.03f * std::sin(0.01f * (s + 1) * i);
+        }
+    }
+    std::vector<const float*> sources(32, nullptr);
+    for (size_t s = 0; s < sources_count; ++s) {
+        sources[s] = inputs[s].data();
+    }
+    std::vector<float> output(kBlock * 2);
+    float peak = 0.0f;
+    for (size_t b = 0; b < kSampleRate / kBlock; ++b) {  // One second
+        for (size_t s = 0; s < sources_count; ++s) {
+            renderer->setPosition(s, static_cast<float>(12 * s + 7 * b), 1.0f + 0.1f * s);
+        }
+        CHECK(renderer->render(sources.data(), output.data(), kBlock));
+        for (float sample : output) {
+            CHECK(std::isfinite(sample));
+            peak = std::max(peak, std::fabs(sample));
+        }
+    }
+    CHECK(peak > 0.01f && peak < 2.0f);
+    CHECK(energy(output, 0, 2) > 0.0);
+}
@@ -0,0 +1,94 @@
+#include "test_framework.h"
+#include "media_pipeline/spectrum_analyzer.h"
+
+#include <cmath>
+#include <vector>
+
+using media_pipeline::SpectrumAnalyzer;
+
+namespace {
+
+const int kSampleRate = 44100;
+
+std::vector<float> sine(double seconds, double frequency, double dbfs) {
+    const size_t count = static_cast<size_t>(seconds * kSampleRate);
+    const double amplitude = std::pow(10.0, dbfs / 20.0);
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] = static_cast<float>(amplitude * std::sin(2.0 * M_PI * frequency * i / kSampleRate));
+    }
+    return samples;
+}
+
+} // namespace
+
+TEST(spectrum_analyzer_sine_lands_in_its_band) {
+    SpectrumAnalyzer analyzer(kSampleRate);
+    CHECK_EQ(analyzer.getBandCount(), 32u);
+    CHECK_EQ(analyzer.getHop(), 1470u);
+
+    // A tone at the geometric center of band 20 reads its level there and
+    // nothing a few bands away
+    const size_t band = 20;
+    const double frequency = std::sqrt(static_cast<double>(analyzer.getBandEdge(band)) * analyzer.getBandEdge(band + 1));
+    const auto tone = sine(1.0, frequency, -12.0);
+    size_t callbacks = 0;
+    const size_t frames = analyzer.process(tone.data(), tone.size(),
+                                           [&](const float*, const float*, size_t bands) {
+                                               CHECK_EQ(bands, 32u);
+                                               callbacks++;
+                                           });
+    CHECK_EQ(frames, 30u);
+    CHECK_EQ(callbacks, 30u);
+
+    const auto& levels = analyzer.getLevels();
+    CHECK_NEAR(levels[band], -12.0, 0.5);
+    CHECK(levels[band - 4] < -60.0f);
+    CHECK(levels[band + 4] < -60.0f);
+    CHECK(levels[0] <= -99.9f);
+    CHECK_NEAR(analyzer.getPeaks()[band], -12.0, 0.5);
+}
+
+TEST(spectrum_analyzer_frame_rate_any_block_size) {
+    SpectrumAnalyzer::Config config;
+    config.frame_rate = 10.0f;  // Hop longer than the FFT
+    SpectrumAnalyzer analyzer(kSampleRate, config);
+    const auto tone = sine(2.0, 1000.0, -6.0);
+    size_t frames = 0;
+    for (size_t offset = 0; offset < tone.size(); offset += 333) {
+        frames += analyzer.process(tone.data() + offset, std::min<size_t>(333, tone.size() - offset));
+    }
+    CHECK_EQ(frames, 20u);
+}
+
+TEST(spectrum_analyzer_peak_hold_and_decay) {
+    SpectrumAnalyzer::Config config;
+    config.smoothing = 0.0f;
+    config.peak_hold_s = 0.5f;
+    config.peak_decay_db_per_s = 30.0f;
+    SpectrumAnalyzer analyzer(kSampleRate, config);
+    const size_t band = 16;
+    const double frequency = std::sqrt(static_cast<double>(analyzer.getBandEdge(band)) * analyzer.getBandEdge(band + 1));
+    const auto tone = sine(0.5, frequency, -20.0);
+    analyzer.process(tone.data(), tone.size());
+
+    // Silence: once the window clears (2 hops) the level drops at once; the
+    // peak holds 15 frames and then falls 1 dB per frame
+    const std::vector<float> hop(analyzer.getHop(), 0.0f);
+    for (int i = 0; i < 2; ++i) {
+        analyzer.process(hop.data(), hop.size());
+    }
+    CHECK(analyzer.getLevels()[band] <= -99.9f);
+    CHECK_NEAR(analyzer.getPeaks()[band], -20.0, 0.5);
+    for (int i = 0; i < 13; ++i) {
+        analyzer.process(hop.data(), hop.size());
+    }
+    CHECK_NEAR(analyzer.getPeaks()[band], -20.0, 0.5);
+    for (int i = 0; i < 10; ++i) {
+        analyzer.process(hop.data(), hop.size());
+    }
+    CHECK_NEAR(analyzer.getPeaks()[band], -30.0, 0.5);
+
+    analyzer.reset();
+    CHECK_EQ(analyzer.getPeaks()[band], -100.0f);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Minimal test harness for the host test suites
+ * TEST(name) defines a self-registering test; the CHECK macros throw on
+ * failure, which fails that test and moves on to the next. test_main.cpp
+ * runs every test (or those whose name contains the first argument).
+ */
+namespace media_pipeline {
+namespace test {
+
+struct TestCase {
+    const char* name;
+    void (*function)();
+};
+
+std::vector<TestCase>& registry();
+
+struct Registrar {
+    Registrar(const char* name, void (*function)()) { registry().push_back({name, function}); }
+};
+
+struct Failure : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+[[noreturn]] inline void fail(const char* file, int line, const std::string& message) {
+    std::ostringstream out;
+    out << file << ":" << line << ": " << message;
+    throw Failure(out.str());
+}
+
+template <typename A, typename B>
+void checkEqual(const A& actual, const B& expected, const char* expression, const char* file, int line) {
+    if (!(actual == expected)) {
+        std::ostringstream out;
+        out << expression << ": got " << actual << ", expected " << expected;
+        fail(file, line, out.str());
+    }
+}
+
+inline void checkNear(double actual, double expected, double tolerance, const char* expression,
+                      const char* file, int line) {
+    if (!(std::fabs(actual - expected) <= tolerance)) {
+        std::ostringstream out;
+        out << expression << ": got " << actual << ", expected " << expected << " +/- " << tolerance;
+        fail(file, line, out.str());
+    }
+}
+
+/**
+ * Scale for stress test iteration counts (MEDIA_PIPELINE_STRESS, default 1)
+ */
+int stressScale();
+
+} // namespace test
+} // namespace media_pipeline
+
+#define TEST(name)                                                                  \
+    static void test_##name();                                                      \
+    static ::media_pipeline::test::Registrar registrar_##name(#name, &test_##name); \
+    static void test_##name()
+
+#define CHECK(condition)                                                            \
+    do {                                                                            \
+        if (!(condition)) {                                                         \
+            ::media_pipeline::test::fail(__FILE__, __LINE__, "CHECK(" #condition ")"); \
+        }                                                                           \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    ::media_pipeline::test::checkEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    ::media_pipeline::test::checkNear((actual), (expected), (tolerance), #actual, __FILE__, __LINE__)
@@ -0,0 +1,49 @@
+#include "test_framework.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace media_pipeline {
+namespace test {
+
+std::vector<TestCase>& registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+int stressScale() {
+    const char* value = std::getenv("MEDIA_PIPELINE_STRESS");
+    int scale = value ? std::atoi(value) : 1;
+    return scale > 0 ? scale : 1;
+}
+
+} // namespace test
+} // namespace media_pipeline
+
+int main(int argc, char* argv[]) {
+    using namespace media_pipeline::test;
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    int run = 0;
+    int failed = 0;
+    for (const TestCase& test : registry()) {
+        if (filter && !std::strstr(test.name, filter)) {
+            continue;
+        }
+        run++;
+        auto start = std::chrono::steady_clock::now();
+        try {
+            test.function();
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            std::cout << "[ OK ] " << test.name << " (" << ms.count() << " ms)" << std::endl;
+        } catch (const std::exception& e) {
+            failed++;
+            std::cout << "[FAIL] " << test.name << ": " << e.what() << std::endl;
+        }
+    }
+
+    std::cout << run - failed << "/" << run << " tests passed" << std::endl;
+    return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/*
+ * Plugin loaded by plugin_host_test.cpp, in plain C to exercise the ABI as
+ * a third party would build against it:
+ *   test.gain   in place, one parameter (dB)
+ *   test.delay  out of place, a fixed delay per channel, reported as latency
+ */
+
+#include "media_pipeline/plugin_abi.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DELAY_FRAMES 3
+
+typedef struct gain_state {
+    float gain;
+} gain_state;
+
+static const mp_plugin_param gain_params[] = {
+    {"gain_db", -60.0f, 12.0f, 0.0f},
+};
+
+static mp_plugin_instance* gain_create(const mp_plugin_config* config) {
+    (void)config;
+    gain_state* state = (gain_state*)malloc(sizeof(gain_state));
+    if (state) {
+        state->gain = 1.0f;
+    }
+    return (mp_plugin_instance*)state;
+}
+
+static void gain_destroy(mp_plugin_instance* instance) {
+    free(instance);
+}
+
+static void gain_process(mp_plugin_instance* instance, const mp_plugin_block* block) {
+    const gain_state* state = (const gain_state*)instance;
+    for (uint32_t c = 0; c < block->channels; ++c) {
+        for (uint32_t i = 0; i < block->frames; ++i) {
+            block->outputs[c][i] = block->inputs[c][i] * state->gain;
+        }
+    }
+}
+
+static void gain_set_param(mp_plugin_instance* instance, uint32_t index, float value) {
+    if (index == 0) {
+        ((gain_state*)instance)->gain = powf(10.0f, value / 20.0f);
+    }
+}
+
+typedef struct delay_state {
+    uint32_t channels;
+    float history[2][DELAY_FRAMES];
+} delay_state;
+
+static mp_plugin_instance* delay_create(const mp_plugin_config* config) {
+    if (config->channels > 2) {
+        return NULL;
+    }
+    delay_state* state = (delay_state*)calloc(1, sizeof(delay_state));
+    if (state) {
+        state->channels = config->channels;
+    }
+    return (mp_plugin_instance*)state;
+}
+
+static void delay_destroy(mp_plugin_instance* instance) {
+    free(instance);
+}
+
+static void delay_process(mp_plugin_instance* instance, const mp_plugin_block* block) {
+    delay_state* state = (delay_state*)instance;
+    for (uint32_t c = 0; c < block->channels; ++c) {
+        const float* input = block->inputs[c];
+        float* output = block->outputs[c];
+        float* history = state->history[c];
+        for (uint32_t i = 0; i < block->frames; ++i) {
+            output[i] = i < DELAY_FRAMES ? history[i] : input[i - DELAY_FRAMES];
+        }
+        /* Blocks may be shorter than the delay */
+        for (uint32_t i = 0; i < DELAY_FRAMES; ++i) {
+            const uint32_t from = block->frames + i;
+            history[i] = from < DELAY_FRAMES ? history[from] : input[from - DELAY_FRAMES];
+        }
+    }
+}
+
+static void delay_reset(mp_plugin_instance* instance) {
+    delay_state* state = (delay_state*)instance;
+    memset(state->history, 0, sizeof(state->history));
+}
+
+static const mp_plugin_descriptor descriptors[] = {
+    {
+        MP_PLUGIN_ABI_VERSION, sizeof(mp_plugin_descriptor), "test.gain", "Gain",
+        MP_PLUGIN_IN_PLACE, 0, 0, 1, gain_params,
+        gain_create, gain_destroy, gain_process, gain_set_param, NULL,
+    },
+    {
+        MP_PLUGIN_ABI_VERSION, sizeof(mp_plugin_descriptor), "test.delay", "Delay",
+        0, DELAY_FRAMES, 2, 0, NULL,
+        delay_create, delay_destroy, delay_process, NULL, delay_reset,
+    },
+};
+
+MP_PLUGIN_EXPORT const mp_plugin_descriptor* mp_plugin_entry(uint32_t host_abi_version, uint32_t index) {
+    if (host_abi_version != MP_PLUGIN_ABI_VERSION || index >= sizeof(descriptors) / sizeof(descriptors[0])) {
+        return NULL;
+    }
+    return &descriptors[index];
+}
@@ -0,0 +1,113 @@
+#include "test_framework.h"
+#include "media_pipeline/trace.h"
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trace = media_pipeline::trace;
+
+namespace {
+
+std::string dump() {
+    std::ostringstream out;
+    trace::writeChromeJson(out);
+    return out.str();
+}
+
+size_t countOccurrences(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+} // namespace
+
+// Each test records from fresh threads: rings belong to threads and outlive them
+TEST(trace_records_scopes_counters_and_thread_names) {
+    std::thread([] {
+        trace::setThreadName("trace-test \"worker\"");
+        {
+            trace::Scope scope("trace_test_scope");
+            trace::counter("trace_test_counter", 42.5);
+            trace::instant("trace_test_instant");
+        }
+    }).join();
+
+    std::string json = dump();
+    CHECK(json.compare(0, 15, "{\"displayTimeUn") == 0);
+    CHECK(json.size() > 4 && json.compare(json.size() - 4, 4, "\n]}\n") == 0);
+    CHECK(json.find("\"name\":\"thread_name\"") != std::string::npos);
+    CHECK(json.find("\"args\":{\"name\":\"trace-test \\\"worker\\\"\"}") != std::string::npos);
+    CHECK(json.find("{\"ph\":\"B\",\"name\":\"trace_test_scope\"") != std::string::npos);
+    CHECK(json.find("{\"ph\":\"E\",\"name\":\"trace_test_scope\"") != std::string::npos);
+    CHECK(json.find("{\"ph\":\"C\",\"name\":\"trace_test_counter\"") != std::string::npos);
+    CHECK(json.find("\"args\":{\"value\":42.5}") != std::string::npos);
+    CHECK(json.find("{\"ph\":\"i\",\"name\":\"trace_test_instant\"") != std::string::npos);
+
+    // Begin precedes end on the thread's timeline
+    CHECK(json.find("\"B\",\"name\":\"trace_test_scope\"") < json.find("\"E\",\"name\":\"trace_test_scope\""));
+}
+
+TEST(trace_ring_keeps_most_recent_events) {
+    const uint64_t overwritten_before = trace::getOverwrittenCount();
+    trace::setBufferCapacity(10);  // Rounded up to 16
+    std::thread([] {
+        for (int i = 0; i < 100; ++i) {
+            trace::counter("trace_test_overwrite", i);
+        }
+    }).join();
+    trace::setBufferCapacity(16384);
+
+    CHECK_EQ(trace::getOverwrittenCount() - overwritten_before, 84u);
+    std::string json = dump();
+    CHECK_EQ(countOccurrences(json, "\"trace_test_overwrite\""), 16u);
+    CHECK(json.find("\"value\":84}") != std::string::npos);
+    CHECK(json.find("\"value\":99}") != std::string::npos);
+    CHECK(json.find("\"value\":83}") == std::string::npos);
+}
+
+TEST(trace_dump_while_recording) {
+    const int writers = 4;
+    const int iterations = 20000 * media_pipeline::test::stressScale();
+    std::atomic<int> finished{0};
+
+    trace::setBufferCapacity(256);
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&finished, iterations] {
+            for (int i = 0; i < iterations; ++i) {
+                trace::Scope scope("trace_test_concurrent");
+                trace::counter("trace_test_concurrent_value", i);
+            }
+            finished.fetch_add(1);
+        });
+    }
+
+    // Every dump taken mid-recording must be complete JSON with only whole events
+    int dumps = 0;
+    while (finished.load() < writers || dumps == 0) {
+        std::string json = dump();
+        CHECK(json.size() > 4 && json.compare(json.size() - 4, 4, "\n]}\n") == 0);
+        std::istringstream lines(json);
+        std::string line;
+        std::getline(lines, line);
+        while (std::getline(lines, line) && line != "]}") {
+            CHECK(line.compare(0, 7, "{\"ph\":\"") == 0);
+            CHECK(line.find("\"tid\":") != std::string::npos);
+        }
+        dumps++;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    trace::setBufferCapacity(16384);
+
+    // Per writer the ring holds the last 256 events of a B, C, E sequence: 85 counters
+    std::string json = dump();
+    CHECK_EQ(countOccurrences(json, "\"trace_test_concurrent_value\""), static_cast<size_t>(writers * 85));
+}
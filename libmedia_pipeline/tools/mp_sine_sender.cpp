@@ -0,0 +1,152 @@
+#include "media_pipeline/osc_sender.h"
+#include "media_pipeline/sine_generator.h"
+#include "media_pipeline/trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using media_pipeline::OSCSender;
+using media_pipeline::SineGenerator;
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+void signalHandler(int) {
+    g_running = false;
+}
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -H <host>     Receiver address (default: 127.0.0.1)" << std::endl;
+    std::cout << "  -p <port>     Receiver port (default: 8000)" << std::endl;
+    std::cout << "  -a <address>  OSC address (default: /audio/stream)" << std::endl;
+    std::cout << "  -f <hz>       Tone frequency (default: 440)" << std::endl;
+    std::cout << "  -r <rate>     Sample rate (default: 48000)" << std::endl;
+    std::cout << "  -b <frames>   Frames per message (default: 256)" << std::endl;
+    std::cout << "  -d <seconds>  Stop after <seconds> (default: until Ctrl+C)" << std::endl;
+    std::cout << "  -t            OSC 1.1 stream over TCP instead of UDP" << std::endl;
+    std::cout << "  -m <name>     Same-host shared-memory ring (receiver started with -l shm:<name>)" << std::endl;
+    std::cout << "  -T <file>     Write a Chrome/Perfetto trace to <file> at exit and on SIGUSR2" << std::endl;
+    std::cout << "                (events are recorded only in -DENABLE_TRACING=ON builds)" << std::endl;
+    std::cout << "  -h            Show this help message" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string host = "127.0.0.1";
+    int port = 8000;
+    std::string address = "/audio/stream";
+    float frequency = 440.0f;
+    int sample_rate = 48000;
+    int block = 256;
+    double duration = 0.0;
+    bool tcp = false;
+    std::string shm_name;
+    std::string trace_path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "-H" && i + 1 < argc) {
+            host = argv[++i];
+        } else if (arg == "-p" && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (arg == "-a" && i + 1 < argc) {
+            address = argv[++i];
+        } else if (arg == "-f" && i + 1 < argc) {
+            frequency = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "-r" && i + 1 < argc) {
+            sample_rate = std::atoi(argv[++i]);
+        } else if (arg == "-b" && i + 1 < argc) {
+            block = std::atoi(argv[++i]);
+        } else if (arg == "-d" && i + 1 < argc) {
+            duration = std::atof(argv[++i]);
+        } else if (arg == "-t") {
+            tcp = true;
+        } else if (arg == "-m" && i + 1 < argc) {
+            shm_name = argv[++i];
+        } else if (arg == "-T" && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (sample_rate <= 0 || block <= 0 || port <= 0) {
+        std::cerr << "Sample rate, block size and port must be positive" << std::endl;
+        return 1;
+    }
+
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+    if (!trace_path.empty()) {
+        media_pipeline::trace::setThreadName("sender");
+        if (!media_pipeline::trace::enableDump(trace_path, SIGUSR2)) {
+            std::cerr << "Trace dump on SIGUSR2 unavailable, writing at exit only" << std::endl;
+        }
+#if !defined(MEDIA_PIPELINE_TRACING)
+        std::cerr << "Tracing not compiled in, rebuild with -DENABLE_TRACING=ON" << std::endl;
+#endif
+    }
+
+    OSCSender sender(host, port);
+    sender.setDefaultAddress(address);
+    if (!shm_name.empty()) {
+        sender.setSharedMemoryDestination(shm_name);
+    } else if (tcp) {
+        sender.setTransport(OSCSender::Transport::TCP);
+    }
+
+    SineGenerator generator(sample_rate, frequency);
+    std::vector<float> buffer(static_cast<size_t>(block));
+
+    std::cout << "Sending " << frequency << " Hz to " << host << ":" << port << address
+              << " (" << block << " frames at " << sample_rate << " Hz";
+    if (!shm_name.empty()) {
+        std::cout << ", shm:" << shm_name;
+    } else if (tcp) {
+        std::cout << ", TCP";
+    }
+    std::cout << ", pid " << getpid() << ")" << std::endl;
+
+    // Paced against an absolute schedule so sleep overshoot does not accumulate
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(block) / sample_rate));
+    const auto start = Clock::now();
+    auto next = start;
+    uint64_t blocks = 0;
+    while (g_running) {
+        if (duration > 0.0 && std::chrono::duration<double>(Clock::now() - start).count() >= duration) {
+            break;
+        }
+        {
+            MP_TRACE_SCOPE("block");
+            generator.generate(buffer.data(), block);
+            sender.sendAudio(buffer.data(), block);
+        }
+        blocks++;
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+
+    std::cout << "Sent " << blocks << " messages";
+    if (sender.getUdpFallbackCount() > 0) {
+        std::cout << " (" << sender.getUdpFallbackCount() << " over UDP fallback)";
+    }
+    std::cout << std::endl;
+    return 0;
+}
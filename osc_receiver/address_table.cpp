@@ -0,0 +1,90 @@
+#include "address_table.h"
+
+#include <cstring>
+
+AddressTable::AddressTable()
+    : slots_(new Slot[kSlotCount])
+    , addresses_(new std::string[kMaxChannels])
+    , stats_(new ChannelStats[kMaxChannels])
+    , count_(0)
+    , full_(false) {
+    addresses_[kOverflowId] = "(other)";
+}
+
+uint64_t AddressTable::hashAddress(const char* address, size_t length) {
+    // FNV-1a; addresses are short, so this beats anything needing setup
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<uint8_t>(address[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash != 0 ? hash : 1;  // 0 marks an empty slot
+}
+
+bool AddressTable::matches(uint32_t id, const char* address, size_t length) const {
+    const std::string& interned = addresses_[id];
+    return interned.size() == length && std::memcmp(interned.data(), address, length) == 0;
+}
+
+uint32_t AddressTable::lookup(uint64_t hash, const char* address, size_t length) const {
+    size_t mask = kSlotCount - 1;
+
+    // Lock-free: slots are never removed or changed once published
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        uint64_t slot_hash = slots_[i].hash.load(std::memory_order_acquire);
+        if (slot_hash == 0) {
+            return kOverflowId;
+        }
+        if (slot_hash == hash) {
+            uint32_t id = slots_[i].id.load(std::memory_order_relaxed);
+            if (matches(id, address, length)) {
+                return id;
+            }
+        }
+    }
+}
+
+uint32_t AddressTable::find(const char* address, size_t length) const {
+    return lookup(hashAddress(address, length), address, length);
+}
+
+uint32_t AddressTable::intern(const char* address, size_t length) {
+    uint64_t hash = hashAddress(address, length);
+    uint32_t found = lookup(hash, address, length);
+    // A full table assigns nothing more: every later miss is an overflow
+    if (found != kOverflowId || full_.load(std::memory_order_acquire)) {
+        return found;
+    }
+
+    size_t mask = kSlotCount - 1;
+    std::lock_guard<std::mutex> lock(insert_mutex_);
+    uint32_t count = count_.load(std::memory_order_relaxed);
+
+    // Another thread may have inserted it since the lookup
+    size_t index = hash & mask;
+    for (;; index = (index + 1) & mask) {
+        uint64_t slot_hash = slots_[index].hash.load(std::memory_order_relaxed);
+        if (slot_hash == 0) {
+            break;
+        }
+        if (slot_hash == hash) {
+            uint32_t id = slots_[index].id.load(std::memory_order_relaxed);
+            if (matches(id, address, length)) {
+                return id;
+            }
+        }
+    }
+
+    if (count >= kOverflowId) {
+        return kOverflowId;
+    }
+
+    addresses_[count].assign(address, length);
+    slots_[index].id.store(count, std::memory_order_relaxed);
+    slots_[index].hash.store(hash, std::memory_order_release);
+    count_.store(count + 1, std::memory_order_release);
+    if (count + 1 == kOverflowId) {
+        full_.store(true, std::memory_order_release);
+    }
+    return count;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Interns OSC addresses as dense channel ids
+ * Each address is hashed and copied once, the first time it is seen; after
+ * that a lookup is one hash, a short probe of an open-addressing table and
+ * one compare, with no locks and no allocation, so any receive thread can
+ * call intern() per message. Per-channel statistics live in a cache-aligned
+ * array indexed by id. Addresses past kMaxChannels share kOverflowId, so a
+ * sender spraying random addresses cannot grow the table. Once the table is
+ * full, unknown addresses get kOverflowId without taking the insert lock.
+ */
+class AddressTable {
+public:
+    static constexpr uint32_t kMaxChannels = 1024;
+    static constexpr uint32_t kOverflowId = kMaxChannels - 1;
+
+    struct alignas(64) ChannelStats {
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> invalid{0};         // Unparseable or undecodable
+        std::atomic<uint64_t> last_arrival_ns{0};
+    };
+
+    AddressTable();
+
+    AddressTable(const AddressTable&) = delete;
+    AddressTable& operator=(const AddressTable&) = delete;
+
+    /**
+     * Get the id of an address, assigning the next free id on first sight
+     */
+    uint32_t intern(const char* address, size_t length);
+    uint32_t intern(const std::string& address) { return intern(address.data(), address.size()); }
+
+    /**
+     * Get the id of an address without assigning one
+     * @return kOverflowId if the address has not been interned
+     */
+    uint32_t find(const char* address, size_t length) const;
+    uint32_t find(const std::string& address) const { return find(address.data(), address.size()); }
+
+    /**
+     * Get number of ids in use (overflow id not included)
+     */
+    uint32_t size() const { return count_.load(std::memory_order_acquire); }
+
+    /**
+     * Get the address of an id below size(), or kOverflowId
+     */
+    const std::string& getAddress(uint32_t id) const { return addresses_[id]; }
+
+    ChannelStats& stats(uint32_t id) { return stats_[id]; }
+    const ChannelStats& stats(uint32_t id) const { return stats_[id]; }
+
+private:
+    static constexpr size_t kSlotCount = 2 * kMaxChannels;  // Load factor <= 0.5
+
+    struct Slot {
+        std::atomic<uint64_t> hash{0};  // 0: empty; published last
+        std::atomic<uint32_t> id{0};
+    };
+
+    static uint64_t hashAddress(const char* address, size_t length);
+    bool matches(uint32_t id, const char* address, size_t length) const;
+    uint32_t lookup(uint64_t hash, const char* address, size_t length) const;
+
+    std::unique_ptr<Slot[]> slots_;
+    std::unique_ptr<std::string[]> addresses_;  // By id; written before the slot is published
+    std::unique_ptr<ChannelStats[]> stats_;
+    std::atomic<uint32_t> count_;
+    std::atomic<bool> full_;  // Set once the last id is taken; misses then skip the lock
+    std::mutex insert_mutex_;
+};
@@ -1,16 +1,66 @@
 #include "audio_output.h"
+#include "media_pipeline/dsp_kernels.h"
+#include "media_pipeline/osc_message.h"
+#include "media_pipeline/trace.h"
+#include "media_pipeline/wav_file.h"
 #include <iostream>
 #include <algorithm>
 #include <cstring>
+#include <cmath>
+#include <cstdlib>
+#include <time.h>
+
+namespace {
+
+constexpr size_t kMaxQueuedBuffers = 20;  // Per queue: older buffers are dropped past this
+
+} // namespace
+
+bool EqualizerBand::parse(const std::string& spec, EqualizerBand& band) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t colon = spec.find(':', start);
+        fields.push_back(spec.substr(start, colon == std::string::npos ? std::string::npos : colon - start));
+        if (colon == std::string::npos) {
+            break;
+        }
+        start = colon + 1;
+    }
+    if (fields.size() < 3 || fields.size() > 4) {
+        return false;
+    }
+    band = EqualizerBand();
+    if (!media_pipeline::BiquadCoefficients::parseType(fields[0], band.type)) {
+        return false;
+    }
+    band.frequency = std::atof(fields[1].c_str());
+    band.q = std::atof(fields[2].c_str());
+    band.gain_db = fields.size() == 4 ? std::atof(fields[3].c_str()) : 0.0;
+    return band.frequency > 0.0 && band.q > 0.0;
+}
 
 AudioOutput::AudioOutput(int sample_rate, int buffer_size)
     : sample_rate_(sample_rate)
     , buffer_size_(buffer_size)
+    , output_channels_(1)
     , running_(false)
     , initialized_(false)
     , volume_(0.5f)
+    , applied_volume_(0.5f)
     , stream_(nullptr)
-    , buffer_position_(0) {
+    , buffer_position_(0)
+    , next_sequence_(1)
+    , current_sequence_(0)
+    , overflow_count_(0)
+    , glitch_detector_(sample_rate)
+    , assigned_sources_(0)
+    , unplaced_count_(0)
+    , last_arrival_ns_(0)
+    , last_sample_count_(0)
+    , jitter_ns_(0.0)
+    , playout_delay_ns_(0.0)
+    , thread_configured_(false) {
 }
 
 AudioOutput::~AudioOutput() {
@@ -51,7 +101,7 @@ bool AudioOutput::start() {
         return false;
     }
 
-    output_params.channelCount = 1; // Mono output
+    output_params.channelCount = static_cast<int>(output_channels_);  // Mono unless spatial
     output_params.sampleFormat = paFloat32;
     output_params.suggestedLatency = Pa_GetDeviceInfo(output_params.device)->defaultLowOutputLatency;
     output_params.hostApiSpecificStreamInfo = nullptr;
@@ -107,26 +157,238 @@ void AudioOutput::stop() {
     std::cout << "Audio output stopped" << std::endl;
 }
 
-void AudioOutput::addAudioData(const std::vector<float>& samples) {
+void AudioOutput::addAudioData(const std::vector<float>& samples, uint64_t arrival_ns) {
     if (samples.empty()) {
         return;
     }
 
     std::lock_guard<std::mutex> lock(audio_mutex_);
+    updateJitter(arrival_ns, last_arrival_ns_, last_sample_count_, samples.size());
 
     // Add samples to queue
-    audio_queue_.push(samples);
+    audio_queue_.push({samples, arrival_ns, next_sequence_++});
 
     // Keep queue size reasonable
-    while (audio_queue_.size() > 20) {
+    while (audio_queue_.size() > kMaxQueuedBuffers) {
         audio_queue_.pop();
+        overflow_count_.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
+// Interarrival jitter: deviation of wire spacing from the audio duration of
+// the previous packet of the same stream, smoothed with the RFC 3550 1/16 gain
+void AudioOutput::updateJitter(uint64_t arrival_ns, uint64_t& last_arrival_ns, size_t& last_sample_count,
+                               size_t samples) {
+    if (arrival_ns != 0 && last_arrival_ns != 0 && arrival_ns > last_arrival_ns) {
+        double spacing = static_cast<double>(arrival_ns - last_arrival_ns);
+        double expected = 1e9 * last_sample_count / sample_rate_;
+        double jitter = jitter_ns_.load();
+        jitter += (std::abs(spacing - expected) - jitter) / 16.0;
+        jitter_ns_ = jitter;
+    }
+    if (arrival_ns != 0) {
+        last_arrival_ns = arrival_ns;
+        last_sample_count = samples;
+    }
+}
+
+bool AudioOutput::setSpatialRenderer(std::unique_ptr<media_pipeline::SpatialRenderer> renderer, std::string& error) {
+    std::lock_guard<std::mutex> lock(audio_mutex_);
+    if (running_) {
+        error = "audio output is already running";
+        return false;
+    }
+    if (convolver_) {
+        error = "the impulse response convolver needs mono output";
+        return false;
+    }
+    if (!plugins_.empty()) {
+        error = "plugin nodes are set up for mono output; add them after the renderer";
+        return false;
+    }
+    if (!renderer || renderer->getBlockSize() != static_cast<size_t>(buffer_size_)) {
+        error = "renderer block size must be the buffer size (" + std::to_string(buffer_size_) + ")";
+        return false;
+    }
+
+    // Everything the callback touches is sized here, not as streams arrive
+    const size_t count = renderer->getMaxSources();
+    sources_.clear();
+    sources_.resize(count);
+    assigned_sources_ = 0;
+    stream_sources_.clear();
+    channel_sources_.assign(AddressTable::kMaxChannels, kNoSource);
+    source_blocks_.assign(count, std::vector<float>(buffer_size_, 0.0f));
+    source_views_.assign(count, nullptr);
+    source_glitches_.clear();
+    for (size_t i = 0; i < count; ++i) {
+        source_glitches_.emplace_back(new media_pipeline::GlitchDetector(sample_rate_));
+    }
+    output_channels_ = renderer->getOutputChannels();
+    renderer_ = std::move(renderer);
+    buildEqualizer();
+    return true;
+}
+
+size_t AudioOutput::assignSource(const std::string& stream) {
+    auto it = stream_sources_.find(stream);
+    if (it != stream_sources_.end()) {
+        return it->second;
+    }
+    if (assigned_sources_ >= sources_.size()) {
+        return sources_.size();
+    }
+    const size_t index = assigned_sources_++;
+    sources_[index].address = stream;
+    stream_sources_.emplace(stream, index);
+    return index;
+}
+
+void AudioOutput::addStreamAudio(uint32_t channel, const std::string& address, const std::vector<float>& samples,
+                                 uint64_t arrival_ns) {
+    if (samples.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(audio_mutex_);
+    if (!renderer_) {
+        return;
+    }
+    // The overflow id is shared by every address past the table, so it is never cached
+    const bool cached = channel < AddressTable::kOverflowId;
+    size_t index = cached ? channel_sources_[channel] : kNoSource;
+    if (index == kNoSource) {
+        // Chunks of one block arrive on addresses of their own
+        index = assignSource(media_pipeline::OSCParser::streamAddress(address));
+        if (index == sources_.size()) {
+            unplaced_count_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (cached) {
+            channel_sources_[channel] = static_cast<uint16_t>(index);
+        }
+    }
+
+    StreamSource& source = sources_[index];
+    updateJitter(arrival_ns, source.last_arrival_ns, source.last_sample_count, samples.size());
+    source.queue.push({samples, arrival_ns, next_sequence_++});
+    while (source.queue.size() > kMaxQueuedBuffers) {
+        source.queue.pop();
+        overflow_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool AudioOutput::setStreamPosition(const std::string& stream, float azimuth_deg, float distance_m) {
+    std::lock_guard<std::mutex> lock(audio_mutex_);
+    if (!renderer_) {
+        return false;
+    }
+    const size_t index = assignSource(stream);
+    if (index == sources_.size()) {
+        return false;
+    }
+    renderer_->setPosition(index, azimuth_deg, distance_m);
+    return true;
+}
+
+media_pipeline::GlitchDetector* AudioOutput::getStreamGlitchDetector(size_t index) {
+    std::lock_guard<std::mutex> lock(audio_mutex_);
+    return index < assigned_sources_ ? source_glitches_[index].get() : nullptr;
+}
+
+uint64_t AudioOutput::getGlitchCount() const {
+    std::lock_guard<std::mutex> lock(audio_mutex_);
+    uint64_t count = glitch_detector_.getTotalCount();
+    for (size_t i = 0; i < assigned_sources_; ++i) {
+        count += source_glitches_[i]->getTotalCount();
+    }
+    return count;
+}
+
+std::vector<AudioOutput::StreamPosition> AudioOutput::getStreamPositions() const {
+    std::lock_guard<std::mutex> lock(audio_mutex_);
+    std::vector<StreamPosition> positions;
+    for (size_t i = 0; i < assigned_sources_; ++i) {
+        positions.push_back(StreamPosition{sources_[i].address, renderer_->getAzimuth(i), renderer_->getDistance(i)});
+    }
+    return positions;
+}
+
 void AudioOutput::setVolume(float volume) {
     volume_ = std::clamp(volume, 0.0f, 1.0f);
 }
 
+bool AudioOutput::addPlugin(std::unique_ptr<media_pipeline::PluginNode> node, std::string& error) {
+    std::lock_guard<std::mutex> lock(audio_mutex_);
+    if (running_) {
+        error = "audio output is already running";
+        return false;
+    }
+    if (!node || node->getChannels() != output_channels_) {
+        error = "plugin node must have " + std::to_string(output_channels_) + " channel(s)";
+        return false;
+    }
+    plugins_.push_back(std::move(node));
+    return true;
+}
+
+media_pipeline::PluginNode* AudioOutput::getPlugin(const std::string& id) const {
+    for (const auto& node : plugins_) {
+        if (node->getId() == id) {
+            return node.get();
+        }
+    }
+    return nullptr;
+}
+
+size_t AudioOutput::getPluginLatency() const {
+    size_t latency = 0;
+    for (const auto& node : plugins_) {
+        latency += node->getLatency();
+    }
+    return latency;
+}
+
+void AudioOutput::setEqualizer(const std::vector<EqualizerBand>& bands) {
+    std::lock_guard<std::mutex> lock(audio_mutex_);
+    equalizer_bands_ = bands;
+    buildEqualizer();
+}
+
+// One lane per output channel, all with the same bands
+void AudioOutput::buildEqualizer() {
+    equalizer_.reset();
+    if (equalizer_bands_.empty()) {
+        return;
+    }
+    equalizer_.reset(new media_pipeline::BiquadBank(output_channels_, equalizer_bands_.size()));
+    for (size_t i = 0; i < equalizer_bands_.size(); ++i) {
+        const EqualizerBand& band = equalizer_bands_[i];
+        for (size_t lane = 0; lane < output_channels_; ++lane) {
+            equalizer_->setDesign(lane, i, band.type, sample_rate_, band.frequency, band.q, band.gain_db);
+        }
+    }
+}
+
+bool AudioOutput::setEqualizerBand(size_t index, const EqualizerBand& band, double ramp_ms) {
+    // The callback holds the same lock for the whole block: retuning lands between blocks
+    std::lock_guard<std::mutex> lock(audio_mutex_);
+    if (!equalizer_ || index >= equalizer_bands_.size()) {
+        return false;
+    }
+    equalizer_bands_[index] = band;
+    const size_t ramp_frames = static_cast<size_t>(std::max(0.0, ramp_ms) * sample_rate_ / 1000.0);
+    for (size_t lane = 0; lane < output_channels_; ++lane) {
+        equalizer_->setDesign(lane, index, band.type, sample_rate_, band.frequency, band.q, band.gain_db, ramp_frames);
+    }
+    return true;
+}
+
+std::vector<EqualizerBand> AudioOutput::getEqualizer() const {
+    std::lock_guard<std::mutex> lock(audio_mutex_);
+    return equalizer_bands_;
+}
+
 int AudioOutput::audioCallback(const void* input_buffer,
                               void* output_buffer,
                               unsigned long frame_count,
@@ -136,27 +398,110 @@ int AudioOutput::audioCallback(const void* input_buffer,
     AudioOutput* audio_output = static_cast<AudioOutput*>(user_data);
     float* output = static_cast<float*>(output_buffer);
 
+    // One-time setup on PortAudio's thread; denormal flushing is per-thread FPU state
+    if (!audio_output->thread_configured_.load(std::memory_order_relaxed)) {
+        auto result = media_pipeline::applyThreadConfig(audio_output->thread_config_, "audio-out");
+        audio_output->thread_report_ = result.summary;
+        audio_output->thread_configured_.store(true, std::memory_order_release);
+    }
+
     return audio_output->processAudio(output, frame_count);
 }
 
+bool AudioOutput::loadImpulseResponse(const std::string& path, const media_pipeline::ThreadConfig& tail_thread,
+                                      std::string& error) {
+    if (renderer_) {
+        error = "the impulse response convolver needs mono output, not spatial rendering";
+        return false;
+    }
+    media_pipeline::WavData wav;
+    if (!media_pipeline::readWavFile(path, wav, error)) {
+        return false;
+    }
+    if (wav.sample_rate != sample_rate_) {
+        std::cerr << "Warning: impulse response " << path << " is " << wav.sample_rate
+                  << " Hz, playback is " << sample_rate_ << " Hz (not resampled)" << std::endl;
+    }
+    if (wav.channels > 1) {
+        std::cerr << "Warning: impulse response " << path << " has " << wav.channels
+                  << " channels, using the first" << std::endl;
+    }
+
+    std::vector<float> ir = wav.getChannel(0);
+    media_pipeline::PartitionedConvolver::Config config;
+    config.block_size = static_cast<size_t>(buffer_size_);
+    config.tail_thread = tail_thread;
+    convolver_ = media_pipeline::PartitionedConvolver::create(ir.data(), ir.size(), config, error);
+    return convolver_ != nullptr;
+}
+
 int AudioOutput::processAudio(float* output, unsigned long frame_count) {
+    MP_TRACE_SCOPE("AudioOutput::processAudio");
     std::lock_guard<std::mutex> lock(audio_mutex_);
+    MP_TRACE_COUNTER("playout_queue", audio_queue_.size());
 
     // Clear output buffer
-    std::memset(output, 0, frame_count * sizeof(float));
+    std::memset(output, 0, frame_count * output_channels_ * sizeof(float));
 
     float vol = volume_.load();
-    size_t frames_filled = 0;
+    size_t frames_filled;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    const uint64_t now_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+    media_pipeline::GlitchDetector::Context context;
+    context.timestamp_ns = now_ns;
+
+    if (renderer_) {
+        frames_filled = renderSpatial(output, frame_count, context, now_ns);
+    } else {
+        frames_filled = renderMono(output, frame_count, context, now_ns);
+    }
+
+    // The whole block, silence included: filter and reverb tails ring on after the stream stops
+    size_t output_frames = frames_filled;
+    if (equalizer_) {
+        equalizer_->process(output, frame_count);
+        output_frames = frame_count;
+    }
+    for (const auto& node : plugins_) {
+        node->process(output, frame_count);
+        output_frames = frame_count;
+    }
+    if (convolver_ && convolver_->process(output, output, frame_count)) {
+        output_frames = frame_count;
+    }
+
+    // Apply volume in one vectorized pass, ramping across the block when it changed
+    if (vol != applied_volume_) {
+        media_pipeline::dsp::applyGainRamp(output, output_frames * output_channels_, applied_volume_, vol);
+        applied_volume_ = vol;
+    } else {
+        media_pipeline::dsp::applyGain(output, output_frames * output_channels_, vol);
+    }
+
+    return paContinue;
+}
 
+// The single queue, straight to the mono output
+size_t AudioOutput::renderMono(float* output, size_t frame_count, media_pipeline::GlitchDetector::Context& context,
+                               uint64_t now_ns) {
+    size_t frames_filled = 0;
     while (frames_filled < frame_count) {
         // If we need a new buffer, get one from the queue
         if (buffer_position_ >= current_buffer_.size()) {
             if (!audio_queue_.empty()) {
-                current_buffer_ = audio_queue_.front();
+                QueuedBuffer& next = audio_queue_.front();
+                if (next.arrival_ns != 0) {
+                    playout_delay_ns_ = now_ns > next.arrival_ns ? static_cast<double>(now_ns - next.arrival_ns) : 0.0;
+                }
+                current_buffer_.swap(next.samples);
+                current_sequence_ = next.sequence;
                 audio_queue_.pop();
                 buffer_position_ = 0;
             } else {
                 // No more audio data, fill rest with silence
+                MP_TRACE_INSTANT("playout_starved");
                 break;
             }
         }
@@ -166,13 +511,80 @@ int AudioOutput::processAudio(float* output, unsigned long frame_count) {
         size_t samples_needed = frame_count - frames_filled;
         size_t samples_to_copy = std::min(samples_available, samples_needed);
 
-        for (size_t i = 0; i < samples_to_copy; ++i) {
-            output[frames_filled + i] = current_buffer_[buffer_position_ + i] * vol;
-        }
+        std::memcpy(output + frames_filled, current_buffer_.data() + buffer_position_,
+                    samples_to_copy * sizeof(float));
+
+        // Analyzed before the volume, as received; per packet so events name it
+        context.packet_sequence = current_sequence_;
+        context.queue_depth = static_cast<uint32_t>(audio_queue_.size());
+        glitch_detector_.analyze(output + frames_filled, samples_to_copy, context);
 
         buffer_position_ += samples_to_copy;
         frames_filled += samples_to_copy;
     }
 
-    return paContinue;
-}
\ No newline at end of file
+    if (frames_filled < frame_count) {
+        context.packet_sequence = current_sequence_;
+        context.queue_depth = 0;
+        glitch_detector_.insertedSilence(frame_count - frames_filled, context);
+    }
+    return frames_filled;
+}
+
+// Pulls one renderer block from every stream's queue at a time and renders
+// them all at once; a stream with nothing queued is left out of the block.
+// Each stream's block goes through its own glitch detector before the mix.
+size_t AudioOutput::renderSpatial(float* output, size_t frame_count,
+                                  media_pipeline::GlitchDetector::Context& context, uint64_t now_ns) {
+    const size_t block = static_cast<size_t>(buffer_size_);
+    size_t done = 0;
+    for (; done + block <= frame_count; done += block) {
+        bool playing = false;
+        for (size_t s = 0; s < assigned_sources_; ++s) {
+            StreamSource& source = sources_[s];
+            float* into = source_blocks_[s].data();
+            size_t filled = 0;
+            while (filled < block) {
+                if (source.position >= source.current.size()) {
+                    if (source.queue.empty()) {
+                        break;
+                    }
+                    QueuedBuffer& next = source.queue.front();
+                    if (next.arrival_ns != 0) {
+                        playout_delay_ns_ = now_ns > next.arrival_ns ? static_cast<double>(now_ns - next.arrival_ns)
+                                                                     : 0.0;
+                    }
+                    source.current.swap(next.samples);
+                    source.sequence = next.sequence;
+                    source.queue.pop();
+                    source.position = 0;
+                }
+                const size_t count = std::min(source.current.size() - source.position, block - filled);
+                std::memcpy(into + filled, source.current.data() + source.position, count * sizeof(float));
+                source.position += count;
+                filled += count;
+            }
+
+            context.packet_sequence = source.sequence;
+            context.queue_depth = static_cast<uint32_t>(source.queue.size());
+            media_pipeline::GlitchDetector& detector = *source_glitches_[s];
+            if (filled > 0) {
+                detector.analyze(into, filled, context);
+            }
+            detector.insertedSilence(block - filled, context);
+            if (filled == 0) {
+                source_views_[s] = nullptr;
+                continue;
+            }
+            std::fill(into + filled, into + block, 0.0f);
+            source_views_[s] = into;
+            playing = true;
+        }
+
+        if (!playing) {
+            MP_TRACE_INSTANT("playout_starved");
+        }
+        renderer_->render(source_views_.data(), output + done * output_channels_, block);
+    }
+    return done;
+}
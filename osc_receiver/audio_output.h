@@ -3,12 +3,53 @@
 #include <vector>
 #include <atomic>
 #include <mutex>
+#include <map>
 #include <queue>
+#include <cstdint>
+#include <string>
+#include <memory>
 #include <portaudio.h>
 
+#include "address_table.h"
+
+#include "media_pipeline/biquad.h"
+#include "media_pipeline/convolver.h"
+#include "media_pipeline/glitch_detector.h"
+#include "media_pipeline/plugin_host.h"
+#include "media_pipeline/spatial_renderer.h"
+#include "media_pipeline/thread_config.h"
+
+/**
+ * One playback equalizer section
+ */
+struct EqualizerBand {
+    media_pipeline::BiquadCoefficients::Type type = media_pipeline::BiquadCoefficients::Type::PEAKING;
+    double frequency = 1000.0;
+    double q = 0.707;
+    double gain_db = 0.0;
+
+    /**
+     * Parse "<type>:<frequency>:<q>[:<gain_db>]", e.g. "highpass:80:0.7" or "peaking:3000:1.5:-4"
+     */
+    static bool parse(const std::string& spec, EqualizerBand& band);
+};
+
 /**
  * Audio output using PortAudio
- * Plays received audio samples through the default audio device
+ * Plays received audio samples through the default audio device. Every block
+ * passes through a GlitchDetector on the way out, so underruns, steps and
+ * clipping are counted and logged against the packet (numbered in arrival
+ * order) and queue depth that produced them. After the detector the block
+ * goes through the equalizer (setEqualizer()), then any plugin nodes
+ * (addPlugin()), then the impulse response (loadImpulseResponse()), then
+ * the volume.
+ *
+ * With a SpatialRenderer (setSpatialRenderer()) streams are no longer played
+ * one after another: each stream address gets its own queue and renderer
+ * source, and every block mixes them at their positions into the
+ * renderer's output channels. Each stream then has a glitch detector of its
+ * own (getStreamGlitchDetector()), run on its block before the mix, so a
+ * gap or step is counted against the stream that produced it.
  */
 class AudioOutput {
 public:
@@ -32,8 +73,151 @@ public:
 
     /**
      * Add audio data to output queue
+     * @param samples Audio samples
+     * @param arrival_ns Kernel receive timestamp of the packet (CLOCK_REALTIME ns), 0 if unknown
+     */
+    void addAudioData(const std::vector<float>& samples, uint64_t arrival_ns = 0);
+
+    /**
+     * Render streams at positions instead of mixing them into one (before start())
+     * The device opens with the renderer's output channels. Blocks that are not
+     * a multiple of its block size play silence.
+     * @return false (with error set) if an impulse response or plugin nodes
+     *         are loaded, the renderer's block size is not the buffer size, or it is running
+     */
+    bool setSpatialRenderer(std::unique_ptr<media_pipeline::SpatialRenderer> renderer, std::string& error);
+
+    /**
+     * Queue one buffer of a stream for spatial rendering
+     * The first buffer of a new stream (address without its chunk suffix,
+     * see OSCParser::streamAddress) takes the next free renderer source;
+     * beyond the renderer's max_sources, streams are dropped and counted.
+     * @param channel The receiver's id for the address, to skip the lookup after the first buffer
+     */
+    void addStreamAudio(uint32_t channel, const std::string& address, const std::vector<float>& samples,
+                        uint64_t arrival_ns = 0);
+
+    /**
+     * Place a stream (any thread); streams play from the front until placed
+     * @param stream Stream address, e.g. "/audio/phone1"
+     * @return false without spatial rendering or when every source is taken
+     */
+    bool setStreamPosition(const std::string& stream, float azimuth_deg, float distance_m = 1.0f);
+
+    struct StreamPosition {
+        std::string stream;
+        float azimuth_deg;
+        float distance_m;
+    };
+
+    /**
+     * Get the streams that have a renderer source, in source order
+     */
+    std::vector<StreamPosition> getStreamPositions() const;
+
+    /**
+     * Get the number of buffers dropped because every renderer source was taken
+     */
+    uint64_t getUnplacedCount() const { return unplaced_count_.load(std::memory_order_relaxed); }
+
+    const media_pipeline::SpatialRenderer* getSpatialRenderer() const { return renderer_.get(); }
+    size_t getOutputChannels() const { return output_channels_; }
+
+    /**
+     * Get interarrival jitter estimate in milliseconds (RFC 3550 style)
+     * Compares packet spacing on the wire with the audio duration each packet carries.
+     */
+    double getJitterMs() const { return jitter_ns_.load() / 1e6; }
+
+    /**
+     * Get time the most recently started buffer spent between arrival and playout, in milliseconds
+     */
+    double getPlayoutDelayMs() const { return playout_delay_ns_.load() / 1e6; }
+
+    /**
+     * Glitches in the played stream: counters, and the event log to drain
+     * from one thread with popEvent(). Timestamps are CLOCK_REALTIME.
+     */
+    media_pipeline::GlitchDetector& getGlitchDetector() { return glitch_detector_; }
+    const media_pipeline::GlitchDetector& getGlitchDetector() const { return glitch_detector_; }
+
+    /**
+     * In spatial mode, the detector watching one stream (getStreamPositions() order)
+     * @return nullptr past the streams placed so far
+     */
+    media_pipeline::GlitchDetector* getStreamGlitchDetector(size_t index);
+
+    /**
+     * Get the glitches counted so far, over the output and every stream's detector
+     */
+    uint64_t getGlitchCount() const;
+
+    /**
+     * Get the number of buffers discarded because the queue was full
+     */
+    uint64_t getOverflowCount() const { return overflow_count_.load(std::memory_order_relaxed); }
+
+    /**
+     * Convolve playback with the first channel of a WAV impulse response
+     * (room correction, speaker EQ, reverb). The head of the IR is computed in
+     * the callback with no added latency, the rest on a worker thread. Blocks
+     * that are not a multiple of the buffer size pass through unconvolved.
+     * Call before start().
+     * @param tail_thread Scheduling for the worker, below the audio thread
+     */
+    bool loadImpulseResponse(const std::string& path, const media_pipeline::ThreadConfig& tail_thread,
+                             std::string& error);
+
+    /**
+     * Filter playback through a cascade of biquad sections, in order
+     * Call before start(); an empty list removes the equalizer.
+     */
+    void setEqualizer(const std::vector<EqualizerBand>& bands);
+
+    /**
+     * Retune one band while playing, gliding over ramp_ms without zipper noise
+     * @return false if there is no such band
+     */
+    bool setEqualizerBand(size_t index, const EqualizerBand& band, double ramp_ms = 50.0);
+
+    /**
+     * Get the equalizer bands (targets of any running glides)
+     */
+    std::vector<EqualizerBand> getEqualizer() const;
+
+    /**
+     * Run a plugin node on playback, after the equalizer and any nodes added before (before start())
+     * @return false (with error set) if running or the node's channels are not getOutputChannels()
+     */
+    bool addPlugin(std::unique_ptr<media_pipeline::PluginNode> node, std::string& error);
+
+    /**
+     * Get a node by plugin id, nullptr if none; its parameters may be set from any thread
+     */
+    media_pipeline::PluginNode* getPlugin(const std::string& id) const;
+
+    /**
+     * Get the delay the plugin nodes add, in frames
+     */
+    size_t getPluginLatency() const;
+
+    /**
+     * Get the loaded convolver, nullptr if none
      */
-    void addAudioData(const std::vector<float>& samples);
+    const media_pipeline::PartitionedConvolver* getConvolver() const { return convolver_.get(); }
+
+    /**
+     * Set scheduling policy, affinity and FPU state for the audio callback thread
+     * PortAudio owns that thread, so the config is applied on the first callback.
+     */
+    void setThreadConfig(const media_pipeline::ThreadConfig& config) { thread_config_ = config; }
+
+    /**
+     * Get the result of applying the thread config (empty until the first callback ran)
+     */
+    std::string getThreadReport() const {
+        return thread_configured_.load(std::memory_order_acquire) ? thread_report_ : std::string();
+    }
 
     /**
      * Check if audio output is running
@@ -50,6 +234,13 @@ public:
      */
     void setVolume(float volume);
 
+    /**
+     * Fill one output block from the queue (silence where it runs dry)
+     * Output is interleaved getOutputChannels() samples per frame.
+     * Called from the PortAudio callback; tests drive it directly.
+     */
+    int processAudio(float* output, unsigned long frame_count);
+
 private:
     static int audioCallback(const void* input_buffer,
                            void* output_buffer,
@@ -58,17 +249,73 @@ private:
                            PaStreamCallbackFlags status_flags,
                            void* user_data);
 
-    int processAudio(float* output, unsigned long frame_count);
+    struct QueuedBuffer {
+        std::vector<float> samples;
+        uint64_t arrival_ns;
+        uint64_t sequence;  // Arrival order, from 1
+    };
+
+    static constexpr uint16_t kNoSource = 0xFFFF;
+
+    // One stream in spatial mode, at its renderer source index
+    struct StreamSource {
+        std::string address;
+        std::queue<QueuedBuffer> queue;
+        std::vector<float> current;
+        size_t position = 0;
+        uint64_t sequence = 0;  // Of current
+        uint64_t last_arrival_ns = 0;
+        size_t last_sample_count = 0;
+    };
+
+    void buildEqualizer();
+    void updateJitter(uint64_t arrival_ns, uint64_t& last_arrival_ns, size_t& last_sample_count, size_t samples);
+    size_t assignSource(const std::string& stream);
+    size_t renderMono(float* output, size_t frame_count, media_pipeline::GlitchDetector::Context& context,
+                      uint64_t now_ns);
+    size_t renderSpatial(float* output, size_t frame_count, media_pipeline::GlitchDetector::Context& context,
+                         uint64_t now_ns);
 
     int sample_rate_;
     int buffer_size_;
+    size_t output_channels_;
     std::atomic<bool> running_;
     std::atomic<bool> initialized_;
     std::atomic<float> volume_;
+    float applied_volume_;  // Volume at the end of the last callback (callback thread only)
 
     PaStream* stream_;
-    std::mutex audio_mutex_;
-    std::queue<std::vector<float>> audio_queue_;
+    mutable std::mutex audio_mutex_;
+    std::queue<QueuedBuffer> audio_queue_;
     std::vector<float> current_buffer_;
     size_t buffer_position_;
+    uint64_t next_sequence_;
+    uint64_t current_sequence_;
+    std::atomic<uint64_t> overflow_count_;
+    media_pipeline::GlitchDetector glitch_detector_;
+    std::vector<EqualizerBand> equalizer_bands_;
+    std::unique_ptr<media_pipeline::BiquadBank> equalizer_;
+    std::vector<std::unique_ptr<media_pipeline::PluginNode>> plugins_;  // Fixed once running
+    std::unique_ptr<media_pipeline::PartitionedConvolver> convolver_;
+
+    // Spatial mode, all guarded by audio_mutex_ and sized in setSpatialRenderer()
+    std::unique_ptr<media_pipeline::SpatialRenderer> renderer_;
+    std::vector<StreamSource> sources_;
+    size_t assigned_sources_;
+    std::map<std::string, size_t> stream_sources_;   // Stream address to source
+    std::vector<uint16_t> channel_sources_;          // By channel id, kNoSource until first seen
+    std::vector<std::vector<float>> source_blocks_;  // One renderer block per source
+    std::vector<const float*> source_views_;         // Rendered this block, nullptr if silent
+    std::vector<std::unique_ptr<media_pipeline::GlitchDetector>> source_glitches_;  // Before the mix
+    std::atomic<uint64_t> unplaced_count_;
+
+    // Arrival timing, fed by kernel receive timestamps
+    uint64_t last_arrival_ns_;
+    size_t last_sample_count_;
+    std::atomic<double> jitter_ns_;
+    std::atomic<double> playout_delay_ns_;
+
+    media_pipeline::ThreadConfig thread_config_;
+    std::atomic<bool> thread_configured_;
+    std::string thread_report_;  // Written once by the callback thread before thread_configured_
 };
\ No newline at end of file
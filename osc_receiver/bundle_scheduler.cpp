@@ -0,0 +1,217 @@
+#include "bundle_scheduler.h"
+#include "rx_timestamp.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// Sleep until this long before a deadline, then spin: covers timer slack
+constexpr uint64_t kSpinWindowNs = 200000;
+constexpr uint64_t kIdleWaitNs = 1000000000;
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+ClockOffsetEstimator::ClockOffsetEstimator()
+    : window_{}
+    , sample_count_(0)
+    , offset_ns_(0) {
+}
+
+void ClockOffsetEstimator::addSample(uint64_t sender_ns, uint64_t arrival_ns) {
+    int64_t sample = static_cast<int64_t>(arrival_ns - sender_ns);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t count = sample_count_.load(std::memory_order_relaxed);
+    window_[count % kWindowSize] = sample;
+    count++;
+
+    size_t filled = static_cast<size_t>(std::min<uint64_t>(count, kWindowSize));
+    int64_t minimum = *std::min_element(window_, window_ + filled);
+    offset_ns_.store(minimum, std::memory_order_relaxed);
+    sample_count_.store(count, std::memory_order_relaxed);
+}
+
+BundleScheduler::BundleScheduler(uint64_t tick_ns, size_t slot_count, size_t max_pending)
+    : tick_ns_(tick_ns > 0 ? tick_ns : 1)
+    , slot_mask_(roundUpPowerOfTwo(slot_count > 1 ? slot_count : 2) - 1)
+    , max_pending_(max_pending)
+    , slots_(slot_mask_ + 1)
+    , next_tick_(0)
+    , next_wake_ns_(0)
+    , overflow_rescan_tick_(0)
+    , running_(false)
+    , pending_count_(0)
+    , scheduled_count_(0)
+    , dropped_count_(0) {
+}
+
+BundleScheduler::~BundleScheduler() {
+    stop();
+}
+
+void BundleScheduler::start(Dispatch dispatch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+
+    dispatch_ = std::move(dispatch);
+    next_tick_ = rx_timestamp::nowNs() / tick_ns_;
+    next_wake_ns_ = 0;
+    running_ = true;
+    thread_ = std::thread(&BundleScheduler::run, this);
+}
+
+void BundleScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& slot : slots_) {
+        slot.clear();
+    }
+    overflow_.clear();
+    due_ = decltype(due_)();
+    pending_count_ = 0;
+}
+
+bool BundleScheduler::schedule(uint64_t deadline_ns, const char* data, size_t length, uint64_t arrival_ns,
+                               uint64_t source, int depth) {
+    Entry entry{deadline_ns, arrival_ns, source, depth, std::string(data, length)};  // Allocate outside the lock
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+        return false;
+    }
+    if (pending_count_.load(std::memory_order_relaxed) >= max_pending_) {
+        dropped_count_++;
+        return false;
+    }
+
+    insertLocked(std::move(entry));
+    pending_count_++;
+    scheduled_count_++;
+
+    // Only wake the dispatch thread if this deadline comes before its next look
+    if (deadline_ns < next_wake_ns_ + kSpinWindowNs) {
+        next_wake_ns_ = deadline_ns > kSpinWindowNs ? deadline_ns - kSpinWindowNs : 0;
+        wake_.notify_one();
+    }
+    return true;
+}
+
+void BundleScheduler::insertLocked(Entry&& entry) {
+    uint64_t tick = entry.deadline_ns / tick_ns_;
+    if (tick < next_tick_) {
+        due_.push(std::move(entry));  // Its slot was already swept
+    } else if (tick - next_tick_ <= slot_mask_) {
+        slots_[tick & slot_mask_].push_back(std::move(entry));
+    } else {
+        if (overflow_.empty()) {
+            overflow_rescan_tick_ = next_tick_ + (slot_mask_ + 1) / 2;
+        }
+        overflow_.push_back(std::move(entry));
+    }
+}
+
+void BundleScheduler::sweepLocked(uint64_t now_ns) {
+    uint64_t now_tick = now_ns / tick_ns_;
+    if (now_tick < next_tick_) {
+        return;
+    }
+
+    // A slot only ever holds entries for one tick, so every swept slot is due
+    uint64_t sweep = std::min<uint64_t>(now_tick - next_tick_ + 1, slot_mask_ + 1);
+    for (uint64_t i = 0; i < sweep; ++i) {
+        auto& slot = slots_[(next_tick_ + i) & slot_mask_];
+        for (auto& entry : slot) {
+            due_.push(std::move(entry));
+        }
+        slot.clear();
+    }
+    next_tick_ = now_tick + 1;
+
+    // Pull overflow entries into the wheel twice per revolution
+    if (!overflow_.empty() && next_tick_ >= overflow_rescan_tick_) {
+        std::vector<Entry> overflow;
+        overflow.swap(overflow_);
+        for (auto& entry : overflow) {
+            insertLocked(std::move(entry));
+        }
+        overflow_rescan_tick_ = next_tick_ + (slot_mask_ + 1) / 2;
+    }
+}
+
+void BundleScheduler::run() {
+    if (thread_init_) {
+        thread_init_();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        uint64_t now_ns = rx_timestamp::nowNs();
+        sweepLocked(now_ns);
+
+        if (!due_.empty() && due_.top().deadline_ns <= now_ns + kSpinWindowNs) {
+            Entry entry = std::move(const_cast<Entry&>(due_.top()));
+            due_.pop();
+            lock.unlock();
+
+            uint64_t dispatch_ns;
+            while ((dispatch_ns = rx_timestamp::nowNs()) < entry.deadline_ns) {
+                cpuRelax();
+            }
+            lateness_.record(dispatch_ns - entry.deadline_ns);
+            pending_count_--;
+            dispatch_(entry.packet, entry.arrival_ns, entry.source, entry.depth);
+
+            lock.lock();
+            continue;
+        }
+
+        // Next look: earliest swept deadline, next occupied slot or overflow rescan
+        uint64_t wake_ns = now_ns + kIdleWaitNs;
+        if (!due_.empty()) {
+            wake_ns = std::min(wake_ns, due_.top().deadline_ns - kSpinWindowNs);
+        }
+        for (uint64_t i = 0; i <= slot_mask_; ++i) {
+            if (!slots_[(next_tick_ + i) & slot_mask_].empty()) {
+                wake_ns = std::min(wake_ns, (next_tick_ + i) * tick_ns_);
+                break;
+            }
+        }
+        if (!overflow_.empty()) {
+            wake_ns = std::min(wake_ns, overflow_rescan_tick_ * tick_ns_);
+        }
+
+        next_wake_ns_ = wake_ns;
+        if (wake_ns > now_ns) {
+            wake_.wait_for(lock, std::chrono::nanoseconds(wake_ns - now_ns));
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "latency_histogram.h"
+
+/**
+ * Estimates the offset between a sender's clock and ours
+ * Each sample is arrival time minus the sender's send time; the minimum over
+ * a sliding window rejects queueing jitter, leaving clock offset plus the
+ * minimum one-way delay (tens of microseconds on a LAN, and the same for
+ * every receiver on the same segment).
+ */
+class ClockOffsetEstimator {
+public:
+    static constexpr size_t kWindowSize = 64;
+
+    ClockOffsetEstimator();
+
+    /**
+     * Add one sample (both CLOCK_REALTIME ns, sender's and ours)
+     */
+    void addSample(uint64_t sender_ns, uint64_t arrival_ns);
+
+    /**
+     * Get offset to add to sender times to get local times (0 until the first sample)
+     */
+    int64_t getOffsetNs() const { return offset_ns_.load(std::memory_order_relaxed); }
+
+    bool hasEstimate() const { return sample_count_.load(std::memory_order_relaxed) > 0; }
+    uint64_t getSampleCount() const { return sample_count_.load(std::memory_order_relaxed); }
+
+private:
+    std::mutex mutex_;
+    int64_t window_[kWindowSize];
+    std::atomic<uint64_t> sample_count_;
+    std::atomic<int64_t> offset_ns_;
+};
+
+/**
+ * Timing-wheel scheduler for timetagged OSC bundle elements
+ * Packets are bucketed by deadline into a wheel of slot_count ticks; deadlines
+ * beyond the wheel's horizon wait in an overflow list that is re-sorted into
+ * the wheel twice per revolution. The dispatch thread sweeps due slots into a
+ * deadline-ordered heap, sleeps until just before the earliest deadline and
+ * spins the rest of the way, so packets are dispatched within a few
+ * microseconds of their deadline rather than at network-jitter precision.
+ * schedule() may be called from any thread. Each packet carries its
+ * sender's source id and bundle nesting depth back to the dispatch callback.
+ */
+class BundleScheduler {
+public:
+    using Dispatch = std::function<void(const std::string& packet, uint64_t arrival_ns, uint64_t source, int depth)>;
+    using ThreadInit = std::function<void()>;
+
+    /**
+     * @param tick_ns Wheel slot width
+     * @param slot_count Slots per revolution (rounded up to a power of two)
+     * @param max_pending Packets held before new ones are dropped
+     */
+    explicit BundleScheduler(uint64_t tick_ns = 1000000, size_t slot_count = 1024, size_t max_pending = 65536);
+    ~BundleScheduler();
+
+    BundleScheduler(const BundleScheduler&) = delete;
+    BundleScheduler& operator=(const BundleScheduler&) = delete;
+
+    /**
+     * Set a hook run at the top of the dispatch thread (before start())
+     */
+    void setThreadInit(ThreadInit init) { thread_init_ = std::move(init); }
+
+    /**
+     * Start the dispatch thread
+     */
+    void start(Dispatch dispatch);
+
+    /**
+     * Stop the dispatch thread, discarding pending packets
+     */
+    void stop();
+
+    /**
+     * Queue a packet for dispatch at deadline_ns (CLOCK_REALTIME)
+     * @param source Sender id, handed back on dispatch
+     * @param depth Bundle nesting depth of the packet, handed back on dispatch
+     * @return false if the scheduler is stopped or full
+     */
+    bool schedule(uint64_t deadline_ns, const char* data, size_t length, uint64_t arrival_ns,
+                  uint64_t source = 0, int depth = 0);
+
+    size_t getPendingCount() const { return pending_count_.load(std::memory_order_relaxed); }
+    uint64_t getScheduledCount() const { return scheduled_count_.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const { return dropped_count_.load(std::memory_order_relaxed); }
+
+    /**
+     * Get dispatch time minus deadline for every dispatched packet
+     */
+    const LatencyHistogram& getLatenessHistogram() const { return lateness_; }
+
+private:
+    struct Entry {
+        uint64_t deadline_ns;
+        uint64_t arrival_ns;
+        uint64_t source;
+        int depth;
+        std::string packet;
+    };
+
+    struct LaterDeadline {
+        bool operator()(const Entry& a, const Entry& b) const { return a.deadline_ns > b.deadline_ns; }
+    };
+
+    void run();
+    void insertLocked(Entry&& entry);
+    void sweepLocked(uint64_t now_ns);
+
+    const uint64_t tick_ns_;
+    const size_t slot_mask_;
+    const size_t max_pending_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<std::vector<Entry>> slots_;
+    std::vector<Entry> overflow_;                                       // Beyond the wheel horizon
+    std::priority_queue<Entry, std::vector<Entry>, LaterDeadline> due_;  // Swept, awaiting their deadline
+    uint64_t next_tick_;       // First tick not yet swept
+    uint64_t next_wake_ns_;    // When the dispatch thread will next look at the wheel
+    uint64_t overflow_rescan_tick_;
+    bool running_;
+
+    std::atomic<size_t> pending_count_;
+    std::atomic<uint64_t> scheduled_count_;
+    std::atomic<uint64_t> dropped_count_;
+    LatencyHistogram lateness_;
+
+    Dispatch dispatch_;
+    ThreadInit thread_init_;
+    std::thread thread_;
+};
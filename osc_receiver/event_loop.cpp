@@ -0,0 +1,681 @@
+#include "event_loop.h"
+#include "rx_timestamp.h"
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+namespace {
+
+constexpr int kBatchSize = 32;        // Datagrams per recvmmsg call
+constexpr size_t kPacketSize = 4096;  // Matches the blocking receive buffer
+constexpr int kReceiveBufferBytes = 4 * 1024 * 1024;  // Absorb bursts from many senders
+constexpr size_t kStreamReadSize = 64 * 1024;          // Bytes per read() on a TCP session
+constexpr size_t kShmRingBytes = 4 * 1024 * 1024;      // Same burst headroom as SO_RCVBUF
+constexpr size_t kShmBatchSize = 64;                   // Messages per ring read
+
+bool parsePort(const std::string& text, int& port) {
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value <= 0 || value > 65535) {
+        return false;
+    }
+    port = static_cast<int>(value);
+    return true;
+}
+
+// FNV-1a, to fold a sender address into the handler's source id
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+uint64_t EventLoop::sourceOf(const sockaddr_storage& addr, socklen_t length) {
+    if (addr.ss_family == AF_INET) {
+        const auto* in = reinterpret_cast<const sockaddr_in*>(&addr);
+        return hashBytes(&in->sin_port, sizeof(in->sin_port), hashBytes(&in->sin_addr, sizeof(in->sin_addr)));
+    }
+    if (addr.ss_family == AF_INET6) {
+        const auto* in6 = reinterpret_cast<const sockaddr_in6*>(&addr);
+        return hashBytes(&in6->sin6_port, sizeof(in6->sin6_port),
+                         hashBytes(&in6->sin6_addr, sizeof(in6->sin6_addr)));
+    }
+    if (addr.ss_family == AF_UNIX && length > offsetof(sockaddr_un, sun_path)) {
+        const auto* un = reinterpret_cast<const sockaddr_un*>(&addr);
+        return hashBytes(un->sun_path, length - offsetof(sockaddr_un, sun_path));
+    }
+    return 0;
+}
+
+bool ListenerConfig::parse(const std::string& spec, ListenerConfig& config) {
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+
+    std::string scheme = spec.substr(0, colon);
+    std::string rest = spec.substr(colon + 1);
+    config = ListenerConfig();
+
+    if (scheme == "udp" || scheme == "udp4") {
+        config.type = Type::UDP4;
+        return parsePort(rest, config.port);
+    } else if (scheme == "udp6") {
+        config.type = Type::UDP6;
+        return parsePort(rest, config.port);
+    } else if (scheme == "tcp" || scheme == "tcp4") {
+        config.type = Type::TCP4;
+        return parsePort(rest, config.port);
+    } else if (scheme == "tcp6") {
+        config.type = Type::TCP6;
+        return parsePort(rest, config.port);
+    } else if (scheme == "shm") {
+        config.type = Type::SHARED_MEMORY;
+        config.address = rest;
+        return !rest.empty();
+    } else if (scheme == "unix") {
+        config.type = Type::UNIX_DGRAM;
+        config.address = rest;
+        return !rest.empty() && rest.size() < sizeof(sockaddr_un::sun_path);
+    } else if (scheme == "mcast") {
+        config.type = Type::MULTICAST;
+        size_t port_sep;
+        if (!rest.empty() && rest[0] == '[') {
+            size_t close = rest.find(']');
+            if (close == std::string::npos || close + 1 >= rest.size() || rest[close + 1] != ':') {
+                return false;
+            }
+            config.address = rest.substr(1, close - 1);
+            port_sep = close + 1;
+        } else {
+            port_sep = rest.rfind(':');
+            if (port_sep == std::string::npos) {
+                return false;
+            }
+            config.address = rest.substr(0, port_sep);
+        }
+        return !config.address.empty() && parsePort(rest.substr(port_sep + 1), config.port);
+    }
+
+    return false;
+}
+
+std::string ListenerConfig::describe() const {
+    std::ostringstream oss;
+    switch (type) {
+        case Type::UDP4:
+            oss << "udp:" << port;
+            break;
+        case Type::UDP6:
+            oss << "udp6:" << port;
+            break;
+        case Type::MULTICAST:
+            if (address.find(':') != std::string::npos) {
+                oss << "mcast:[" << address << "]:" << port;
+            } else {
+                oss << "mcast:" << address << ":" << port;
+            }
+            break;
+        case Type::UNIX_DGRAM:
+            oss << "unix:" << address;
+            break;
+        case Type::TCP4:
+            oss << "tcp:" << port;
+            break;
+        case Type::TCP6:
+            oss << "tcp6:" << port;
+            break;
+        case Type::SHARED_MEMORY:
+            oss << "shm:" << address;
+            break;
+    }
+    return oss.str();
+}
+
+EventLoop::EventLoop(int thread_count)
+    : thread_count_(thread_count > 0 ? thread_count : 1)
+    , running_(false)
+    , session_count_(0) {
+}
+
+EventLoop::~EventLoop() {
+    stop();
+}
+
+void EventLoop::addListener(const ListenerConfig& config) {
+    configs_.push_back(config);
+}
+
+#ifdef __linux__
+
+bool EventLoop::isSupported() {
+    return true;
+}
+
+int EventLoop::openSocket(const ListenerConfig& config, bool reuse_port) {
+    int family = AF_INET;
+    if (config.type == ListenerConfig::Type::UDP6 || config.type == ListenerConfig::Type::TCP6) {
+        family = AF_INET6;
+    } else if (config.type == ListenerConfig::Type::UNIX_DGRAM) {
+        family = AF_UNIX;
+    } else if (config.type == ListenerConfig::Type::MULTICAST &&
+               config.address.find(':') != std::string::npos) {
+        family = AF_INET6;
+    }
+
+    int sock_type = config.isStream() ? SOCK_STREAM : SOCK_DGRAM;
+    int fd = socket(family, sock_type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "Failed to create socket for " << config.describe() << std::endl;
+        return -1;
+    }
+
+    int opt = 1;
+    int rcvbuf = kReceiveBufferBytes;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    if (family != AF_UNIX) {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        if (reuse_port && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+            std::cerr << "SO_REUSEPORT unavailable for " << config.describe() << std::endl;
+        }
+    }
+    if (family != AF_UNIX && !config.isStream()) {
+        rx_timestamp::enable(fd);
+    }
+    if (family == AF_INET6) {
+        // Keep v6 sockets v6-only so udp:N/tcp:N and their v6 forms can coexist
+        setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &opt, sizeof(opt));
+    }
+
+    bool ok = false;
+    if (family == AF_INET) {
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = INADDR_ANY;
+        addr.sin_port = htons(config.port);
+        ok = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+
+        if (ok && config.type == ListenerConfig::Type::MULTICAST) {
+            ip_mreq mreq;
+            std::memset(&mreq, 0, sizeof(mreq));
+            mreq.imr_interface.s_addr = INADDR_ANY;
+            ok = inet_pton(AF_INET, config.address.c_str(), &mreq.imr_multiaddr) == 1 &&
+                 setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) == 0;
+        }
+    } else if (family == AF_INET6) {
+        sockaddr_in6 addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin6_family = AF_INET6;
+        addr.sin6_addr = in6addr_any;
+        addr.sin6_port = htons(config.port);
+        ok = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+
+        if (ok && config.type == ListenerConfig::Type::MULTICAST) {
+            ipv6_mreq mreq;
+            std::memset(&mreq, 0, sizeof(mreq));
+            mreq.ipv6mr_interface = 0;
+            ok = inet_pton(AF_INET6, config.address.c_str(), &mreq.ipv6mr_multiaddr) == 1 &&
+                 setsockopt(fd, IPPROTO_IPV6, IPV6_JOIN_GROUP, &mreq, sizeof(mreq)) == 0;
+        }
+    } else {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, config.address.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(config.address.c_str());  // Remove a stale socket from a previous run
+        ok = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    }
+
+    if (ok && config.isStream()) {
+        ok = listen(fd, SOMAXCONN) == 0;
+    }
+
+    if (!ok) {
+        std::cerr << "Failed to open listener " << config.describe() << ": " << strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+bool EventLoop::registerSocket(Loop& loop, int fd, bool listening) {
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLET;
+    event.data.fd = fd;
+    if (epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        std::cerr << "epoll_ctl failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    loop.socket_fds.push_back(fd);
+    if (listening) {
+        loop.listen_fds.insert(fd);
+    }
+    return true;
+}
+
+bool EventLoop::start(PacketHandler handler) {
+    if (running_) {
+        return true;
+    }
+
+    handler_ = std::move(handler);
+
+    for (int i = 0; i < thread_count_; ++i) {
+        auto loop = std::make_unique<Loop>();
+        loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        loop->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (loop->epoll_fd < 0 || loop->wake_fd < 0) {
+            std::cerr << "Failed to create epoll instance" << std::endl;
+            loops_.push_back(std::move(loop));
+            closeAll();
+            return false;
+        }
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = loop->wake_fd;
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->wake_fd, &event);
+        loops_.push_back(std::move(loop));
+    }
+
+    size_t next_loop = 0;
+    for (const auto& config : configs_) {
+        if (config.type == ListenerConfig::Type::SHARED_MEMORY) {
+            if (!openSharedMemory(config)) {
+                closeAll();
+                return false;
+            }
+            continue;
+        }
+
+        bool shareable = config.type == ListenerConfig::Type::UDP4 ||
+                         config.type == ListenerConfig::Type::UDP6 ||
+                         config.isStream();
+
+        if (shareable && thread_count_ > 1) {
+            // One socket per loop thread; the kernel hashes flows across them
+            for (auto& loop : loops_) {
+                int fd = openSocket(config, true);
+                if (fd < 0 || !registerSocket(*loop, fd, config.isStream())) {
+                    if (fd >= 0) close(fd);
+                    closeAll();
+                    return false;
+                }
+            }
+        } else {
+            int fd = openSocket(config, false);
+            Loop& loop = *loops_[next_loop++ % loops_.size()];
+            if (fd < 0 || !registerSocket(loop, fd, config.isStream())) {
+                if (fd >= 0) close(fd);
+                closeAll();
+                return false;
+            }
+        }
+    }
+
+    running_ = true;
+    for (size_t i = 0; i < loops_.size(); ++i) {
+        Loop* loop_ptr = loops_[i].get();
+        int index = static_cast<int>(i);
+        loops_[i]->thread = std::thread([this, loop_ptr, index]() {
+            if (thread_init_) {
+                thread_init_(index);
+            }
+            runLoop(*loop_ptr);
+        });
+    }
+    for (size_t i = 0; i < shm_listeners_.size(); ++i) {
+        ShmListener* listener = shm_listeners_[i].get();
+        int index = static_cast<int>(loops_.size() + i);
+        listener->thread = std::thread([this, listener, index]() {
+            if (thread_init_) {
+                thread_init_(index);
+            }
+            runSharedMemory(*listener);
+        });
+    }
+
+    return true;
+}
+
+void EventLoop::stop() {
+    if (!running_) {
+        closeAll();
+        return;
+    }
+
+    running_ = false;
+
+    for (auto& loop : loops_) {
+        uint64_t one = 1;
+        ssize_t written = write(loop->wake_fd, &one, sizeof(one));
+        (void)written;
+    }
+    for (auto& listener : shm_listeners_) {
+        listener->ring->wakeReader();
+    }
+    for (auto& loop : loops_) {
+        if (loop->thread.joinable()) {
+            loop->thread.join();
+        }
+    }
+    for (auto& listener : shm_listeners_) {
+        if (listener->thread.joinable()) {
+            listener->thread.join();
+        }
+    }
+
+    closeAll();
+}
+
+void EventLoop::runLoop(Loop& loop) {
+    std::vector<char> buffers(kBatchSize * kPacketSize);
+    std::vector<char> control(kBatchSize * rx_timestamp::kControlSize);
+    std::vector<char> stream_buffer(kStreamReadSize);
+    epoll_event events[64];
+
+    while (running_) {
+        int count = epoll_wait(loop.epoll_fd, events, 64, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == loop.wake_fd) {
+                continue;
+            }
+            if (loop.listen_fds.count(fd)) {
+                acceptSessions(loop, fd, stream_buffer.data(), stream_buffer.size());
+                continue;
+            }
+            auto session = loop.sessions.find(fd);
+            if (session != loop.sessions.end()) {
+                readSession(loop, fd, *session->second, stream_buffer.data(), stream_buffer.size());
+                continue;
+            }
+            drainSocket(fd, buffers.data(), control.data());
+        }
+    }
+}
+
+void EventLoop::drainSocket(int fd, char* buffers, char* control) {
+    mmsghdr messages[kBatchSize];
+    iovec iovecs[kBatchSize];
+    sockaddr_storage names[kBatchSize];
+
+    // Edge-triggered: keep reading until the socket reports EAGAIN
+    while (running_) {
+        for (int i = 0; i < kBatchSize; ++i) {
+            iovecs[i].iov_base = buffers + i * kPacketSize;
+            iovecs[i].iov_len = kPacketSize;
+            std::memset(&messages[i], 0, sizeof(messages[i]));
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &names[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(names[i]);
+            messages[i].msg_hdr.msg_control = control + i * rx_timestamp::kControlSize;
+            messages[i].msg_hdr.msg_controllen = rx_timestamp::kControlSize;
+        }
+
+        int received = recvmmsg(fd, messages, kBatchSize, MSG_DONTWAIT, nullptr);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;  // EAGAIN or a socket error; wait for the next edge
+        }
+
+        uint64_t fallback_ns = 0;
+        for (int i = 0; i < received; ++i) {
+            if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                continue;
+            }
+            uint64_t arrival_ns = rx_timestamp::extract(&messages[i].msg_hdr);
+            if (arrival_ns == 0) {
+                // Unix sockets carry no kernel timestamp; use one clock read per batch
+                if (fallback_ns == 0) {
+                    fallback_ns = rx_timestamp::nowNs();
+                }
+                arrival_ns = fallback_ns;
+            }
+            handler_(buffers + i * kPacketSize, messages[i].msg_len, arrival_ns,
+                     sourceOf(names[i], messages[i].msg_hdr.msg_namelen));
+        }
+
+        if (received < kBatchSize) {
+            break;
+        }
+    }
+}
+
+void EventLoop::acceptSessions(Loop& loop, int listen_fd, char* buffer, size_t size) {
+    // Edge-triggered: accept until the backlog is empty
+    while (running_) {
+        sockaddr_storage peer;
+        socklen_t peer_len = sizeof(peer);
+        int fd = accept4(listen_fd, reinterpret_cast<sockaddr*>(&peer), &peer_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "accept failed: " << strerror(errno) << std::endl;
+            }
+            return;
+        }
+
+        int rcvbuf = kReceiveBufferBytes;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        event.data.fd = fd;
+        if (epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            std::cerr << "epoll_ctl failed for TCP session: " << strerror(errno) << std::endl;
+            close(fd);
+            continue;
+        }
+
+        auto session = std::make_unique<Session>();
+        char host[INET6_ADDRSTRLEN] = "?";
+        int peer_port = 0;
+        if (peer.ss_family == AF_INET) {
+            auto* in = reinterpret_cast<sockaddr_in*>(&peer);
+            inet_ntop(AF_INET, &in->sin_addr, host, sizeof(host));
+            peer_port = ntohs(in->sin_port);
+        } else if (peer.ss_family == AF_INET6) {
+            auto* in6 = reinterpret_cast<sockaddr_in6*>(&peer);
+            inet_ntop(AF_INET6, &in6->sin6_addr, host, sizeof(host));
+            peer_port = ntohs(in6->sin6_port);
+        }
+        session->peer = std::string(host) + ":" + std::to_string(peer_port);
+        session->source = sourceOf(peer, peer_len);
+        std::cout << "TCP session opened from " << session->peer << std::endl;
+
+        loop.sessions[fd] = std::move(session);
+        session_count_++;
+
+        // Data may have arrived before registration; the edge is already gone
+        readSession(loop, fd, *loop.sessions[fd], buffer, size);
+    }
+}
+
+void EventLoop::readSession(Loop& loop, int fd, Session& session, char* buffer, size_t size) {
+    // Edge-triggered: read until EAGAIN, EOF or error
+    while (running_) {
+        ssize_t bytes = read(fd, buffer, size);
+        if (bytes > 0) {
+            uint64_t arrival_ns = rx_timestamp::nowNs();
+            session.decoder.feed(buffer, static_cast<size_t>(bytes), [&](const char* frame, size_t length) {
+                handler_(frame, length, arrival_ns, session.source);
+            });
+            continue;
+        }
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        }
+        closeSession(loop, fd);  // EOF or connection error
+        return;
+    }
+}
+
+void EventLoop::closeSession(Loop& loop, int fd) {
+    auto it = loop.sessions.find(fd);
+    if (it == loop.sessions.end()) {
+        return;
+    }
+
+    std::cout << "TCP session closed from " << it->second->peer;
+    if (it->second->decoder.getDroppedFrames() > 0) {
+        std::cout << " (" << it->second->decoder.getDroppedFrames() << " oversized frames dropped)";
+    }
+    std::cout << std::endl;
+
+    epoll_ctl(loop.epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    loop.sessions.erase(it);
+    session_count_--;
+}
+
+bool EventLoop::openSharedMemory(const ListenerConfig& config) {
+    std::string error;
+    auto ring = media_pipeline::ShmRing::create(config.address, kShmRingBytes, error);
+    if (!ring) {
+        std::cerr << "Failed to open listener " << config.describe() << ": " << error << std::endl;
+        return false;
+    }
+
+    auto listener = std::make_unique<ShmListener>();
+    listener->ring = std::move(ring);
+    shm_listeners_.push_back(std::move(listener));
+    return true;
+}
+
+void EventLoop::runSharedMemory(ShmListener& listener) {
+    media_pipeline::ShmRing& ring = *listener.ring;
+    const uint64_t source = hashBytes(ring.getName().data(), ring.getName().size());
+
+    while (running_) {
+        if (!ring.waitForData(100)) {
+            continue;
+        }
+        // The handler reads the message straight out of the mapping
+        while (running_ && ring.read([this, source](const char* data, size_t length, uint64_t written_ns) {
+                   handler_(data, length, written_ns, source);
+               }, kShmBatchSize) == kShmBatchSize) {
+        }
+    }
+
+    if (ring.getDroppedCount() > 0) {
+        std::cout << "Shared memory ring " << ring.getName() << ": " << ring.getDroppedCount()
+                  << " messages dropped by senders (ring full)" << std::endl;
+    }
+}
+
+void EventLoop::closeAll() {
+    shm_listeners_.clear();  // Unlinks the ring names
+
+    if (loops_.empty()) {
+        return;
+    }
+
+    for (auto& loop : loops_) {
+        for (auto& session : loop->sessions) {
+            close(session.first);
+        }
+        loop->sessions.clear();
+        for (int fd : loop->socket_fds) {
+            close(fd);
+        }
+        if (loop->epoll_fd >= 0) close(loop->epoll_fd);
+        if (loop->wake_fd >= 0) close(loop->wake_fd);
+    }
+    loops_.clear();
+    session_count_ = 0;
+
+    for (const auto& config : configs_) {
+        if (config.type == ListenerConfig::Type::UNIX_DGRAM) {
+            unlink(config.address.c_str());
+        }
+    }
+}
+
+#else  // !__linux__
+
+bool EventLoop::isSupported() {
+    return false;
+}
+
+bool EventLoop::start(PacketHandler /*handler*/) {
+    std::cerr << "epoll event loop is only available on Linux" << std::endl;
+    return false;
+}
+
+void EventLoop::stop() {
+    running_ = false;
+}
+
+int EventLoop::openSocket(const ListenerConfig& /*config*/, bool /*reuse_port*/) {
+    return -1;
+}
+
+bool EventLoop::registerSocket(Loop& /*loop*/, int /*fd*/, bool /*listening*/) {
+    return false;
+}
+
+void EventLoop::runLoop(Loop& /*loop*/) {
+}
+
+void EventLoop::drainSocket(int /*fd*/, char* /*buffers*/, char* /*control*/) {
+}
+
+void EventLoop::acceptSessions(Loop& /*loop*/, int /*listen_fd*/, char* /*buffer*/, size_t /*size*/) {
+}
+
+void EventLoop::readSession(Loop& /*loop*/, int /*fd*/, Session& /*session*/, char* /*buffer*/, size_t /*size*/) {
+}
+
+void EventLoop::closeSession(Loop& /*loop*/, int /*fd*/) {
+}
+
+bool EventLoop::openSharedMemory(const ListenerConfig& /*config*/) {
+    return false;
+}
+
+void EventLoop::runSharedMemory(ShmListener& /*listener*/) {
+}
+
+void EventLoop::closeAll() {
+}
+
+#endif
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <sys/socket.h>
+
+#include "media_pipeline/shm_ring.h"
+#include "media_pipeline/slip.h"
+
+/**
+ * Description of one socket the event loop listens on
+ *
+ * Spec strings accepted by parse():
+ *   udp:9000                  IPv4 UDP on all interfaces
+ *   udp6:9000                 IPv6 UDP on all interfaces
+ *   mcast:239.1.2.3:9000      IPv4 multicast group membership
+ *   mcast:[ff02::1234]:9000   IPv6 multicast group membership
+ *   unix:/tmp/osc.sock        Unix datagram socket
+ *   tcp:9000                  OSC 1.1 over TCP, SLIP framed (IPv4)
+ *   tcp6:9000                 OSC 1.1 over TCP, SLIP framed (IPv6)
+ *   shm:osc-audio             Shared-memory ring for same-host senders
+ */
+struct ListenerConfig {
+    enum class Type {
+        UDP4,
+        UDP6,
+        MULTICAST,
+        UNIX_DGRAM,
+        TCP4,
+        TCP6,
+        SHARED_MEMORY
+    };
+
+    Type type = Type::UDP4;
+    int port = 0;
+    std::string address;  // Multicast group, unix socket path or ring name
+
+    static bool parse(const std::string& spec, ListenerConfig& config);
+    std::string describe() const;
+    bool isStream() const { return type == Type::TCP4 || type == Type::TCP6; }
+};
+
+/**
+ * Edge-triggered epoll event loop serving many listeners (Linux)
+ * Unicast UDP ports get one SO_REUSEPORT socket per loop thread so the kernel
+ * spreads flows across threads; multicast and unix sockets are assigned to a
+ * single thread round-robin. Readable sockets are drained with recvmmsg and
+ * every datagram is handed to the shared packet handler together with its
+ * kernel receive timestamp and source; the handler may be called
+ * concurrently from several loop threads.
+ *
+ * TCP listeners are opened per loop thread with SO_REUSEPORT as well, so
+ * accepted sessions stay on the thread that accepted them. Each session
+ * SLIP-decodes its byte stream and hands complete frames to the same packet
+ * handler, stamped with the time the read returned.
+ *
+ * Shared-memory listeners create the ring and get a dedicated reader thread
+ * that spins briefly, then sleeps on the ring's futex. Messages are handed
+ * to the packet handler in place, stamped with the sender's write time.
+ */
+class EventLoop {
+public:
+    /**
+     * source identifies the sender: a hash of its address and port for
+     * datagrams, of the peer for a TCP session and of the ring name for
+     * shared memory; 0 for unbound unix datagram senders
+     */
+    using PacketHandler =
+        std::function<void(const char* data, size_t length, uint64_t arrival_ns, uint64_t source)>;
+    using ThreadInit = std::function<void(int thread_index)>;
+
+    explicit EventLoop(int thread_count = 1);
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * Register a listener (before start())
+     */
+    void addListener(const ListenerConfig& config);
+
+    /**
+     * Set a hook run at the top of every loop thread (before start())
+     * Used to apply scheduling policy, affinity and FPU state per thread.
+     */
+    void setThreadInit(ThreadInit init) { thread_init_ = std::move(init); }
+
+    /**
+     * Open all sockets and start the loop threads
+     * @return false if any listener failed to open
+     */
+    bool start(PacketHandler handler);
+
+    /**
+     * Wake and join the loop threads, close all sockets
+     */
+    void stop();
+
+    /**
+     * Check if the platform has an epoll implementation
+     */
+    static bool isSupported();
+
+    /**
+     * Get the source id PacketHandler passes for a sender address
+     * Lets receive paths outside the loop identify senders the same way.
+     */
+    static uint64_t sourceOf(const sockaddr_storage& addr, socklen_t length);
+
+    bool isRunning() const { return running_; }
+    int getThreadCount() const { return thread_count_; }
+    int getSessionCount() const { return session_count_; }
+    const std::vector<ListenerConfig>& getListeners() const { return configs_; }
+
+private:
+    struct Session {
+        media_pipeline::slip::Decoder decoder;
+        std::string peer;
+        uint64_t source = 0;
+    };
+
+    struct Loop {
+        int epoll_fd = -1;
+        int wake_fd = -1;
+        std::vector<int> socket_fds;
+        std::unordered_set<int> listen_fds;
+        std::unordered_map<int, std::unique_ptr<Session>> sessions;  // Owned by the loop thread
+        std::thread thread;
+    };
+
+    struct ShmListener {
+        std::unique_ptr<media_pipeline::ShmRing> ring;
+        std::thread thread;
+    };
+
+    int openSocket(const ListenerConfig& config, bool reuse_port);
+    bool registerSocket(Loop& loop, int fd, bool listening);
+    void runLoop(Loop& loop);
+    void drainSocket(int fd, char* buffers, char* control);
+    void acceptSessions(Loop& loop, int listen_fd, char* buffer, size_t size);
+    void readSession(Loop& loop, int fd, Session& session, char* buffer, size_t size);
+    void closeSession(Loop& loop, int fd);
+    bool openSharedMemory(const ListenerConfig& config);
+    void runSharedMemory(ShmListener& listener);
+    void closeAll();
+
+    int thread_count_;
+    std::atomic<bool> running_;
+    std::atomic<int> session_count_;
+    std::vector<ListenerConfig> configs_;
+    std::vector<std::unique_ptr<Loop>> loops_;
+    std::vector<std::unique_ptr<ShmListener>> shm_listeners_;
+    PacketHandler handler_;
+    ThreadInit thread_init_;
+};
@@ -0,0 +1,178 @@
+#include "frame_reassembler.h"
+#include "media_pipeline/stream_packetizer.h"
+#include <algorithm>
+#include <cstring>
+
+using media_pipeline::stream_packet::Header;
+
+FrameReassembler::FrameReassembler(size_t max_frame_bytes, size_t max_buffered_bytes, uint64_t timeout_ns)
+    : max_frame_bytes_(max_frame_bytes)
+    , max_buffered_bytes_(max_buffered_bytes)
+    , timeout_ns_(timeout_ns)
+    , last_expire_ns_(0)
+    , buffered_bytes_(0)
+    , completed_frames_(0)
+    , completed_bytes_(0)
+    , timed_out_frames_(0)
+    , evicted_frames_(0)
+    , duplicate_packets_(0)
+    , stale_packets_(0)
+    , invalid_packets_(0) {
+}
+
+bool FrameReassembler::handlePacket(const char* data, size_t length, uint64_t arrival_ns, uint64_t source) {
+    Header header;
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+    if (!media_pipeline::stream_packet::read(bytes, length, header)) {
+        invalid_packets_++;
+        return false;
+    }
+    const uint8_t* payload = bytes + media_pipeline::stream_packet::kHeaderSize;
+    const FrameId id{source, header.frameKey()};
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (finished_.count(id)) {
+        stale_packets_++;
+        return true;
+    }
+
+    auto it = partials_.find(id);
+    if (it == partials_.end()) {
+        if (header.total == 1) {
+            // Single-packet frame: deliver straight from the datagram
+            markFinished(id);
+            if (header.size > max_frame_bytes_) {
+                evicted_frames_++;
+                return true;
+            }
+            if (frame_callback_) {
+                Frame frame{source, id.key, header.timestamp, payload, header.size, 1, arrival_ns, arrival_ns};
+                frame_callback_(frame);
+            }
+            completed_frames_++;
+            completed_bytes_ += header.size;
+            return true;
+        }
+
+        it = partials_.emplace(id, Partial()).first;
+        Partial& partial = it->second;
+        partial.timestamp = header.timestamp;
+        partial.total = header.total;
+        partial.first_arrival_ns = arrival_ns;
+        partial.fragments.assign(header.total, std::make_pair(kMissing, 0u));
+    }
+
+    Partial& partial = it->second;
+    if (header.total != partial.total) {
+        invalid_packets_++;
+        return true;
+    }
+    auto& fragment = partial.fragments[header.index];
+    if (fragment.first != kMissing) {
+        duplicate_packets_++;
+        return true;
+    }
+    const size_t needed = partial.staging.size() + header.size;
+    if (needed > max_frame_bytes_) {
+        drop(it);
+        evicted_frames_++;
+        return true;
+    }
+
+    // Staging grows geometrically as fragments arrive (the header's total is
+    // only the sender's claim) and the limit is charged for its capacity
+    const size_t capacity = partial.staging.capacity();
+    size_t new_capacity = capacity;
+    if (needed > capacity) {
+        new_capacity = std::min(std::max(needed, 2 * capacity), max_frame_bytes_);
+    }
+
+    // Make room by evicting the incomplete frames that started arriving first, from any sender
+    while (buffered_bytes_ + (new_capacity - capacity) > max_buffered_bytes_) {
+        auto oldest = partials_.end();
+        for (auto other = partials_.begin(); other != partials_.end(); ++other) {
+            if (other != it && (oldest == partials_.end() ||
+                                other->second.first_arrival_ns < oldest->second.first_arrival_ns)) {
+                oldest = other;
+            }
+        }
+        if (oldest == partials_.end()) {
+            break;
+        }
+        drop(oldest);
+        evicted_frames_++;
+    }
+
+    if (new_capacity > capacity) {
+        partial.staging.reserve(new_capacity);
+        buffered_bytes_ += partial.staging.capacity() - capacity;
+    }
+    fragment.first = static_cast<uint32_t>(partial.staging.size());
+    fragment.second = header.size;
+    partial.staging.insert(partial.staging.end(), payload, payload + header.size);
+    partial.received++;
+    partial.last_arrival_ns = arrival_ns;
+
+    if (partial.received == partial.total) {
+        complete(id, partial);
+        buffered_bytes_ -= partial.staging.capacity();
+        partials_.erase(it);
+    }
+
+    if (arrival_ns - last_expire_ns_ > timeout_ns_ / 4) {
+        expireLocked(arrival_ns);
+    }
+    return true;
+}
+
+void FrameReassembler::expire(uint64_t now_ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    expireLocked(now_ns);
+}
+
+void FrameReassembler::expireLocked(uint64_t now_ns) {
+    last_expire_ns_ = now_ns;
+    for (auto it = partials_.begin(); it != partials_.end();) {
+        auto next = std::next(it);
+        if (now_ns > it->second.first_arrival_ns && now_ns - it->second.first_arrival_ns > timeout_ns_) {
+            drop(it);
+            timed_out_frames_++;
+        }
+        it = next;
+    }
+}
+
+void FrameReassembler::complete(const FrameId& id, Partial& partial) {
+    // One gather copy into index order; output_ keeps its capacity between frames
+    output_.resize(partial.staging.size());
+    size_t offset = 0;
+    for (const auto& fragment : partial.fragments) {
+        std::memcpy(output_.data() + offset, partial.staging.data() + fragment.first, fragment.second);
+        offset += fragment.second;
+    }
+
+    if (frame_callback_) {
+        Frame frame{id.source, id.key, partial.timestamp, output_.data(), output_.size(), partial.total,
+                    partial.first_arrival_ns, partial.last_arrival_ns};
+        frame_callback_(frame);
+    }
+    completed_frames_++;
+    completed_bytes_ += output_.size();
+    markFinished(id);
+}
+
+void FrameReassembler::drop(std::map<FrameId, Partial>::iterator it) {
+    buffered_bytes_ -= it->second.staging.capacity();
+    markFinished(it->first);
+    partials_.erase(it);
+}
+
+void FrameReassembler::markFinished(const FrameId& id) {
+    finished_.insert(id);
+    finished_order_.push_back(id);
+    if (finished_order_.size() > kFinishedHistory) {
+        finished_.erase(finished_order_.front());
+        finished_order_.pop_front();
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * Rebuilds frames sent by the app's UdpStreamOutputNode
+ * Fragments (media_pipeline/stream_packetizer.h format) may arrive in any
+ * order. Every sender numbers its packets from 1, so frames are told apart
+ * by the source passed with each packet as well as by their frame key.
+ * Each fragment is appended to its frame's staging buffer, and the frame is
+ * gathered into order once the last one arrives. Incomplete frames are
+ * dropped after a timeout, and the oldest ones are evicted when buffered
+ * bytes exceed the memory limit. Packets for frames already delivered or
+ * dropped are recognised and discarded. Thread-safe.
+ */
+class FrameReassembler {
+public:
+    struct Frame {
+        uint64_t source;         // As passed to handlePacket()
+        uint64_t sequence;       // Sequence of the first fragment
+        uint64_t timestamp;      // Sender pipeline timestamp (ns)
+        const uint8_t* data;     // Valid only during the callback
+        size_t size;
+        uint16_t packet_count;
+        uint64_t first_arrival_ns;
+        uint64_t last_arrival_ns;
+    };
+
+    // Called with the reassembler lock held: copy or hand off quickly
+    using FrameCallback = std::function<void(const Frame&)>;
+
+    /**
+     * @param max_frame_bytes Frames larger than this are dropped
+     * @param max_buffered_bytes Limit on bytes allocated for incomplete frames
+     * @param timeout_ns Age after which an incomplete frame is dropped
+     */
+    explicit FrameReassembler(size_t max_frame_bytes = 4 * 1024 * 1024,
+                              size_t max_buffered_bytes = 32 * 1024 * 1024,
+                              uint64_t timeout_ns = 500000000);
+
+    void setFrameCallback(FrameCallback callback) { frame_callback_ = std::move(callback); }
+
+    /**
+     * Add one datagram
+     * @param source Sender id (EventLoop::PacketHandler); packets from one
+     *        sender must carry the same source
+     * @return false if it is not a stream packet
+     */
+    bool handlePacket(const char* data, size_t length, uint64_t arrival_ns, uint64_t source = 0);
+
+    /**
+     * Drop incomplete frames older than the timeout (also run from handlePacket)
+     */
+    void expire(uint64_t now_ns);
+
+    uint64_t getCompletedFrames() const { return completed_frames_; }
+    uint64_t getCompletedBytes() const { return completed_bytes_; }
+    uint64_t getTimedOutFrames() const { return timed_out_frames_; }
+    uint64_t getEvictedFrames() const { return evicted_frames_; }
+    uint64_t getDuplicatePackets() const { return duplicate_packets_; }
+    uint64_t getStalePackets() const { return stale_packets_; }
+    uint64_t getInvalidPackets() const { return invalid_packets_; }
+    size_t getBufferedBytes() const { return buffered_bytes_; }
+
+private:
+    static constexpr uint32_t kMissing = 0xFFFFFFFF;
+    static constexpr size_t kFinishedHistory = 256;
+
+    struct FrameId {
+        uint64_t source;
+        uint64_t key;       // Header::frameKey()
+
+        bool operator==(const FrameId& other) const { return source == other.source && key == other.key; }
+        bool operator<(const FrameId& other) const {
+            return source != other.source ? source < other.source : key < other.key;
+        }
+    };
+
+    struct FrameIdHash {
+        size_t operator()(const FrameId& id) const { return std::hash<uint64_t>()(id.source * 31 + id.key); }
+    };
+
+    struct Partial {
+        uint64_t timestamp = 0;
+        uint16_t total = 0;
+        uint16_t received = 0;
+        uint64_t first_arrival_ns = 0;
+        uint64_t last_arrival_ns = 0;
+        std::vector<uint8_t> staging;                           // Fragments in arrival order; capacity is charged
+        std::vector<std::pair<uint32_t, uint32_t>> fragments;  // (staging offset, length) per index
+    };
+
+    void expireLocked(uint64_t now_ns);
+    void complete(const FrameId& id, Partial& partial);
+    void drop(std::map<FrameId, Partial>::iterator it);
+    void markFinished(const FrameId& id);
+
+    const size_t max_frame_bytes_;
+    const size_t max_buffered_bytes_;
+    const uint64_t timeout_ns_;
+
+    std::mutex mutex_;
+    std::map<FrameId, Partial> partials_;  // By sender, then frame key: oldest first
+    std::unordered_set<FrameId, FrameIdHash> finished_;
+    std::deque<FrameId> finished_order_;
+    std::vector<uint8_t> output_;
+    uint64_t last_expire_ns_;
+    FrameCallback frame_callback_;
+
+    std::atomic<size_t> buffered_bytes_;
+    std::atomic<uint64_t> completed_frames_;
+    std::atomic<uint64_t> completed_bytes_;
+    std::atomic<uint64_t> timed_out_frames_;
+    std::atomic<uint64_t> evicted_frames_;
+    std::atomic<uint64_t> duplicate_packets_;
+    std::atomic<uint64_t> stale_packets_;
+    std::atomic<uint64_t> invalid_packets_;
+};
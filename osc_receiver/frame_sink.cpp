@@ -0,0 +1,281 @@
+#include "frame_sink.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace frame_sink_layout;
+
+namespace {
+
+constexpr size_t kFileBufferBytes = 1024 * 1024;
+
+bool isPath(const std::string& name) {
+    return name.find('/', 1) != std::string::npos;
+}
+
+std::string shmName(const std::string& name) {
+    return name[0] == '/' ? name : "/" + name;
+}
+
+void removeBacking(const std::string& name) {
+    if (isPath(name)) {
+        unlink(name.c_str());
+    } else {
+        shm_unlink(shmName(name).c_str());
+    }
+}
+
+size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+Slot* slotAt(Header* header, uint32_t index) {
+    return reinterpret_cast<Slot*>(reinterpret_cast<char*>(header) + header->slot_offset + index * header->slot_stride);
+}
+
+} // namespace
+
+static_assert(sizeof(Header) <= kHeaderSize, "sink header must fit its page");
+static_assert(sizeof(Slot) <= kSlotHeaderSize, "slot header must fit before the data");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared atomics must be lock-free");
+
+bool FrameFormat::parse(const std::string& spec, FrameFormat& format) {
+    std::string fourcc = spec.substr(0, spec.find(':'));
+    if (fourcc.empty() || fourcc.size() > 4) {
+        return false;
+    }
+    format = FrameFormat();
+    for (size_t i = 0; i < 4; ++i) {
+        char c = i < fourcc.size() ? fourcc[i] : ' ';
+        format.fourcc |= static_cast<uint32_t>(static_cast<uint8_t>(c)) << (8 * i);
+    }
+
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos) {
+        return true;
+    }
+    std::string size = spec.substr(colon + 1);
+    size_t x = size.find('x');
+    if (x == std::string::npos) {
+        return false;
+    }
+    format.width = static_cast<uint32_t>(std::atoi(size.substr(0, x).c_str()));
+    format.height = static_cast<uint32_t>(std::atoi(size.substr(x + 1).c_str()));
+    return format.width > 0 && format.height > 0;
+}
+
+std::string FrameFormat::describe() const {
+    std::string result;
+    for (int i = 0; i < 4; ++i) {
+        char c = static_cast<char>((fourcc >> (8 * i)) & 0xFF);
+        if (c != ' ' && c != '\0') {
+            result += c;
+        }
+    }
+    if (width > 0) {
+        result += " " + std::to_string(width) + "x" + std::to_string(height);
+    }
+    return result;
+}
+
+FrameSink::FrameSink(const FrameFormat& format)
+    : format_(format)
+    , mapping_(nullptr)
+    , mapping_size_(0)
+    , header_(nullptr)
+    , data_file_(nullptr)
+    , index_file_(nullptr)
+    , file_offset_(0)
+    , frame_count_(0)
+    , oversized_count_(0) {
+}
+
+FrameSink::~FrameSink() {
+    close();
+}
+
+bool FrameSink::openSharedMemory(const std::string& name, size_t slot_capacity, std::string& error) {
+    if (name.empty()) {
+        error = "empty shared memory name";
+        return false;
+    }
+
+    int fd;
+    if (isPath(name)) {
+        fd = open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    } else {
+        shm_unlink(shmName(name).c_str());
+        fd = shm_open(shmName(name).c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    }
+    if (fd < 0) {
+        error = "cannot open " + name + ": " + std::strerror(errno);
+        return false;
+    }
+
+    size_t stride = roundUp(kSlotHeaderSize + slot_capacity, 4096);
+    size_t size = kHeaderSize + kSlotCount * stride;
+    if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        error = "cannot size " + name + ": " + std::strerror(errno);
+        ::close(fd);
+        removeBacking(name);
+        return false;
+    }
+
+    // Pages are only touched as frames are written, so a large capacity is cheap
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        error = "cannot map " + name + ": " + std::strerror(errno);
+        removeBacking(name);
+        return false;
+    }
+
+    shm_name_ = name;
+    mapping_ = mapping;
+    mapping_size_ = size;
+    header_ = new (mapping) Header();
+    header_->version = kVersion;
+    header_->slot_count = kSlotCount;
+    header_->slot_capacity = stride - kSlotHeaderSize;
+    header_->slot_offset = kHeaderSize;
+    header_->slot_stride = stride;
+    header_->latest.store(kNoFrame, std::memory_order_relaxed);
+    header_->frame_seq.store(0, std::memory_order_relaxed);
+    header_->frame_count.store(0, std::memory_order_relaxed);
+    header_->closed.store(0, std::memory_order_relaxed);
+    header_->waiters.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < kSlotCount; ++i) {
+        new (slotAt(header_, i)) Slot();
+    }
+
+    // Publish last: readers treat a region without the magic as not ready
+    header_->magic.store(kMagic, std::memory_order_release);
+    return true;
+}
+
+bool FrameSink::openFile(const std::string& path, std::string& error) {
+    data_file_ = std::fopen(path.c_str(), "ab");
+    if (!data_file_) {
+        error = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    std::string index_path = path + ".idx";
+    index_file_ = std::fopen(index_path.c_str(), "ab");
+    if (!index_file_) {
+        error = "cannot open " + index_path + ": " + std::strerror(errno);
+        std::fclose(data_file_);
+        data_file_ = nullptr;
+        return false;
+    }
+    setvbuf(data_file_, nullptr, _IOFBF, kFileBufferBytes);
+
+    // Appending: offsets continue from the existing data
+    std::fseek(data_file_, 0, SEEK_END);
+    file_offset_ = static_cast<uint64_t>(std::ftell(data_file_));
+    std::fseek(index_file_, 0, SEEK_END);
+    if (std::ftell(index_file_) == 0) {
+        uint32_t index_header[4] = {kIndexMagic, 1, sizeof(IndexRecord), 0};
+        std::fwrite(index_header, sizeof(index_header), 1, index_file_);
+    }
+    return true;
+}
+
+void FrameSink::write(const uint8_t* data, size_t size, uint64_t timestamp_ns, uint64_t arrival_ns) {
+    if (header_) {
+        exportFrame(data, size, timestamp_ns, arrival_ns);
+    }
+    if (data_file_) {
+        appendFrame(data, size, timestamp_ns, arrival_ns);
+    }
+    frame_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FrameSink::exportFrame(const uint8_t* data, size_t size, uint64_t timestamp_ns, uint64_t arrival_ns) {
+    if (size > header_->slot_capacity) {
+        oversized_count_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Fill the slot after latest: the other two hold the newest and previous frames
+    uint32_t latest = header_->latest.load(std::memory_order_relaxed);
+    uint32_t index = latest == kNoFrame ? 0 : (latest + 1) % kSlotCount;
+    Slot* slot = slotAt(header_, index);
+
+    // Odd while writing. An acquire RMW keeps the data stores below from
+    // moving ahead of it, as a release fence after a plain store would
+    const uint64_t seq = slot->seq.fetch_add(1, std::memory_order_acq_rel);
+
+    std::memcpy(reinterpret_cast<char*>(slot) + kSlotHeaderSize, data, size);
+    slot->frame_number = header_->frame_count.load(std::memory_order_relaxed);
+    slot->timestamp_ns = timestamp_ns;
+    slot->arrival_ns = arrival_ns;
+    slot->size = static_cast<uint32_t>(size);
+    slot->fourcc = format_.fourcc;
+    slot->width = format_.width;
+    slot->height = format_.height;
+
+    slot->seq.store(seq + 2, std::memory_order_release);
+    header_->latest.store(index, std::memory_order_release);
+    header_->frame_count.fetch_add(1, std::memory_order_release);
+
+    // Dekker pairing with sleeping readers: publish frame_seq, then look for
+    // waiters, so a reader polling in place costs the writer no syscall
+    header_->frame_seq.fetch_add(1, std::memory_order_seq_cst);
+#ifdef __linux__
+    if (header_->waiters.load(std::memory_order_seq_cst) != 0) {
+        // Shared futex: waiters live in other processes
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header_->frame_seq), FUTEX_WAKE, INT_MAX, nullptr, nullptr,
+                0);
+    }
+#endif
+}
+
+void FrameSink::appendFrame(const uint8_t* data, size_t size, uint64_t timestamp_ns, uint64_t arrival_ns) {
+    IndexRecord record;
+    record.offset = file_offset_;
+    record.timestamp_ns = timestamp_ns;
+    record.arrival_ns = arrival_ns;
+    record.size = static_cast<uint32_t>(size);
+    record.fourcc = format_.fourcc;
+    record.width = format_.width;
+    record.height = format_.height;
+
+    std::fwrite(data, 1, size, data_file_);
+    std::fwrite(&record, sizeof(record), 1, index_file_);
+    file_offset_ += size;
+}
+
+void FrameSink::close() {
+    if (data_file_) {
+        std::fclose(data_file_);
+        data_file_ = nullptr;
+    }
+    if (index_file_) {
+        std::fclose(index_file_);
+        index_file_ = nullptr;
+    }
+    if (header_) {
+        header_->closed.store(1, std::memory_order_release);
+        header_->frame_seq.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header_->frame_seq), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+        removeBacking(shm_name_);
+        header_ = nullptr;
+    }
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+    }
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/**
+ * Describes the frames of one stream (stored with every exported frame)
+ */
+struct FrameFormat {
+    uint32_t fourcc = 0;   // e.g. 'H264', 'RGBA', 'NV12' (first character in the low byte)
+    uint32_t width = 0;    // 0 if unknown (encoded streams)
+    uint32_t height = 0;
+
+    /**
+     * Parse "<fourcc>[:<width>x<height>]", e.g. "H264" or "RGBA:1280x720"
+     */
+    static bool parse(const std::string& spec, FrameFormat& format);
+    std::string describe() const;
+};
+
+/**
+ * Shared-memory layout of a FrameSink export
+ *
+ * Header page (offset 0, 4096 bytes):
+ *    0  u32 magic          "OSCF"
+ *    4  u32 version        2
+ *    8  u32 slot_count     3
+ *   16  u64 slot_capacity  Data bytes per slot
+ *   24  u64 slot_offset    Offset of slot 0 (4096)
+ *   32  u64 slot_stride    Bytes between slots
+ *   64  u32 latest         Slot holding the newest complete frame (0xFFFFFFFF: none yet)
+ *   68  u32 frame_seq      Bumped after every frame; futex word (Linux, shared)
+ *   72  u64 frame_count
+ *   80  u32 closed         Set when the receiver exits
+ *   84  u32 waiters        Readers sleeping on frame_seq; the writer skips FUTEX_WAKE while 0
+ *
+ * Slot (slot_offset + index * slot_stride, 64-byte header then data):
+ *    0  u64 seq            Odd while the slot is being written
+ *    8  u64 frame_number
+ *   16  u64 timestamp_ns   Sender pipeline timestamp
+ *   24  u64 arrival_ns     Receive time of the last fragment (CLOCK_REALTIME)
+ *   32  u32 size           Data bytes
+ *   36  u32 fourcc
+ *   40  u32 width
+ *   44  u32 height
+ *   64  data
+ *
+ * Readers: load magic (acquire) once, then per frame: load latest, load the
+ * slot's seq (acquire; retry if odd), use the data in place, then reload seq
+ * after an acquire fence (or as a release fetch_add of 0); if it changed the
+ * frame was overwritten meanwhile. To sleep until the next frame: increment
+ * waiters, recheck frame_seq, FUTEX_WAIT on it if unchanged, decrement
+ * waiters (all sequentially consistent).
+ * The writer always fills the slot after latest, so a reader has two frame
+ * periods before the slot it holds is reused. No locks, no copies.
+ */
+namespace frame_sink_layout {
+
+constexpr uint32_t kMagic = 0x4643534F;  // "OSCF" in memory
+constexpr uint32_t kVersion = 2;         // 2: waiters
+constexpr uint32_t kSlotCount = 3;
+constexpr uint32_t kNoFrame = 0xFFFFFFFF;
+constexpr size_t kHeaderSize = 4096;
+constexpr size_t kSlotHeaderSize = 64;
+
+struct Header {
+    std::atomic<uint32_t> magic;     // Stored last, with release
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t reserved;
+    uint64_t slot_capacity;
+    uint64_t slot_offset;
+    uint64_t slot_stride;
+
+    alignas(64) std::atomic<uint32_t> latest;
+    std::atomic<uint32_t> frame_seq;
+    std::atomic<uint64_t> frame_count;
+    std::atomic<uint32_t> closed;
+    std::atomic<uint32_t> waiters;
+};
+
+struct Slot {
+    std::atomic<uint64_t> seq;
+    uint64_t frame_number;
+    uint64_t timestamp_ns;
+    uint64_t arrival_ns;
+    uint32_t size;
+    uint32_t fourcc;
+    uint32_t width;
+    uint32_t height;
+};
+
+/**
+ * Index file (<file>.idx) next to the appended frame data
+ * 16-byte header ("OSCX", u32 version, u32 record size, u32 reserved), then
+ * one record per frame.
+ */
+constexpr uint32_t kIndexMagic = 0x5843534F;  // "OSCX" in memory
+
+struct IndexRecord {
+    uint64_t offset;        // Byte offset of the frame in the data file
+    uint64_t timestamp_ns;
+    uint64_t arrival_ns;
+    uint32_t size;
+    uint32_t fourcc;
+    uint32_t width;
+    uint32_t height;
+};
+
+static_assert(sizeof(IndexRecord) == 40, "index records are 40 bytes");
+
+} // namespace frame_sink_layout
+
+/**
+ * Destination for reassembled frames of one stream
+ * Keeps the latest complete frame in a triple-buffered shared-memory region
+ * for local consumers (see frame_sink_layout) and optionally appends every
+ * frame to a data file with a fixed-size index record per frame. write() is
+ * called from the receive thread only.
+ */
+class FrameSink {
+public:
+    explicit FrameSink(const FrameFormat& format);
+    ~FrameSink();
+
+    FrameSink(const FrameSink&) = delete;
+    FrameSink& operator=(const FrameSink&) = delete;
+
+    /**
+     * Create the shared-memory export (replaces one left by a crashed receiver)
+     * @param name POSIX shared memory name, or a file path (contains '/')
+     * @param slot_capacity Largest frame that can be exported
+     */
+    bool openSharedMemory(const std::string& name, size_t slot_capacity, std::string& error);
+
+    /**
+     * Append frames to path and index records to path.idx
+     */
+    bool openFile(const std::string& path, std::string& error);
+
+    /**
+     * Store one frame in every open destination
+     */
+    void write(const uint8_t* data, size_t size, uint64_t timestamp_ns, uint64_t arrival_ns);
+
+    /**
+     * Flush and close the file, mark the export closed and remove its name
+     */
+    void close();
+
+    const FrameFormat& getFormat() const { return format_; }
+    uint64_t getFrameCount() const { return frame_count_.load(std::memory_order_relaxed); }
+    uint64_t getOversizedCount() const { return oversized_count_.load(std::memory_order_relaxed); }
+    uint64_t getFileBytes() const { return file_offset_; }
+
+private:
+    void exportFrame(const uint8_t* data, size_t size, uint64_t timestamp_ns, uint64_t arrival_ns);
+    void appendFrame(const uint8_t* data, size_t size, uint64_t timestamp_ns, uint64_t arrival_ns);
+
+    const FrameFormat format_;
+
+    std::string shm_name_;
+    void* mapping_;
+    size_t mapping_size_;
+    frame_sink_layout::Header* header_;
+
+    FILE* data_file_;
+    FILE* index_file_;
+    uint64_t file_offset_;
+
+    std::atomic<uint64_t> frame_count_;
+    std::atomic<uint64_t> oversized_count_;
+};
@@ -0,0 +1,112 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+int bucketIndex(uint64_t nanoseconds) {
+    int index = 0;
+    while (nanoseconds > 1 && index < LatencyHistogram::kBucketCount - 1) {
+        nanoseconds >>= 1;
+        index++;
+    }
+    return index;
+}
+
+std::string formatDuration(uint64_t nanoseconds) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    if (nanoseconds < 1000) {
+        oss << nanoseconds << "ns";
+    } else if (nanoseconds < 1000000) {
+        oss << nanoseconds / 1e3 << "us";
+    } else {
+        oss << nanoseconds / 1e6 << "ms";
+    }
+    return oss.str();
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram()
+    : count_(0)
+    , sum_(0)
+    , max_(0) {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    buckets_[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    uint64_t current = max_.load(std::memory_order_relaxed);
+    while (nanoseconds > current &&
+           !max_.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_ = 0;
+    sum_ = 0;
+    max_ = 0;
+}
+
+double LatencyHistogram::getMean() const {
+    uint64_t count = getCount();
+    return count > 0 ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / count : 0.0;
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+    uint64_t count = getCount();
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(count * percentile / 100.0);
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen > target) {
+            return std::min<uint64_t>(uint64_t(1) << (i + 1), getMax());
+        }
+    }
+    return getMax();
+}
+
+void LatencyHistogram::print(std::ostream& out, const std::string& title) const {
+    uint64_t count = getCount();
+    out << title << ": " << count << " samples";
+    if (count == 0) {
+        out << std::endl;
+        return;
+    }
+
+    out << " | mean " << formatDuration(static_cast<uint64_t>(getMean()))
+        << " | p50 " << formatDuration(getPercentile(50))
+        << " | p90 " << formatDuration(getPercentile(90))
+        << " | p99 " << formatDuration(getPercentile(99))
+        << " | p99.9 " << formatDuration(getPercentile(99.9))
+        << " | max " << formatDuration(getMax()) << std::endl;
+
+    uint64_t peak = 0;
+    for (const auto& bucket : buckets_) {
+        peak = std::max(peak, bucket.load(std::memory_order_relaxed));
+    }
+
+    for (int i = 0; i < kBucketCount; ++i) {
+        uint64_t value = buckets_[i].load(std::memory_order_relaxed);
+        if (value == 0) {
+            continue;
+        }
+        int bar = static_cast<int>(40 * value / peak);
+        out << "  <" << std::setw(8) << formatDuration(uint64_t(1) << (i + 1)) << " "
+            << std::setw(9) << value << " " << std::string(std::max(bar, 1), '#') << std::endl;
+    }
+}
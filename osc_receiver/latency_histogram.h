@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * Lock-free log2 latency histogram
+ * Buckets are powers of two in nanoseconds. record() takes no lock: three
+ * relaxed fetch_adds (bucket, count, sum) and a compare-exchange loop on the
+ * max that only runs while the sample is a new maximum, so it can sit on the
+ * receive path of any thread. Readers may see the fields momentarily apart.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kBucketCount = 40;  // Up to ~9 minutes
+
+    LatencyHistogram();
+
+    /**
+     * Add one sample in nanoseconds
+     */
+    void record(uint64_t nanoseconds);
+
+    /**
+     * Clear all buckets
+     */
+    void reset();
+
+    /**
+     * Get number of recorded samples
+     */
+    uint64_t getCount() const { return count_.load(std::memory_order_relaxed); }
+
+    /**
+     * Get maximum recorded sample in nanoseconds
+     */
+    uint64_t getMax() const { return max_.load(std::memory_order_relaxed); }
+
+    /**
+     * Get mean sample in nanoseconds
+     */
+    double getMean() const;
+
+    /**
+     * Estimate a percentile (0-100) in nanoseconds from the bucket upper bounds
+     */
+    uint64_t getPercentile(double percentile) const;
+
+    /**
+     * Print count, mean, p50/p90/p99/p99.9 and max plus a compact bucket chart
+     */
+    void print(std::ostream& out, const std::string& title) const;
+
+private:
+    std::atomic<uint64_t> buckets_[kBucketCount];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
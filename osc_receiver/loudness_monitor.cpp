@@ -0,0 +1,76 @@
+#include "loudness_monitor.h"
+#include "media_pipeline/osc_sender.h"
+
+#include <algorithm>
+
+LoudnessMonitor::LoudnessMonitor(int sample_rate, size_t queue_capacity)
+    : StreamWorker("loudness", queue_capacity)
+    , sample_rate_(sample_rate)
+    , osc_port_(0)
+    , meters_(AddressTable::kMaxChannels)
+    , osc_messages_(0)
+    , readings_(AddressTable::kMaxChannels) {
+}
+
+LoudnessMonitor::~LoudnessMonitor() {
+    stop();
+}
+
+void LoudnessMonitor::setOscOutput(const std::string& host, int port) {
+    osc_host_ = host;
+    osc_port_ = port;
+}
+
+void LoudnessMonitor::onStart() {
+    if (!osc_ && !osc_host_.empty() && osc_port_ > 0) {
+        osc_.reset(new media_pipeline::OSCSender(osc_host_, osc_port_));
+        osc_->setFeatureEncoding(0);  // Plain floats for any OSC client
+    }
+}
+
+void LoudnessMonitor::analyze(uint32_t stream, const std::vector<float>& samples) {
+    auto& meter = meters_[stream];
+    if (!meter) {
+        meter.reset(new media_pipeline::LoudnessMeter(sample_rate_, 1));
+    }
+    if (meter->process(samples.data(), samples.size()) > 0) {
+        publish(stream, *meter);
+    }
+}
+
+void LoudnessMonitor::publish(uint32_t stream, const media_pipeline::LoudnessMeter& meter) {
+    const auto reading = meter.getReading();
+    {
+        std::lock_guard<std::mutex> lock(readings_mutex_);
+        readings_[stream].valid = true;
+        readings_[stream].reading = reading;
+    }
+    if (!osc_) {
+        return;
+    }
+    const float values[5] = {
+        static_cast<float>(stream),
+        static_cast<float>(std::max(kOscFloor, reading.momentary_lufs)),
+        static_cast<float>(std::max(kOscFloor, reading.short_term_lufs)),
+        static_cast<float>(std::max(kOscFloor, reading.integrated_lufs)),
+        static_cast<float>(std::max(kOscFloor, reading.true_peak_dbtp)),
+    };
+    osc_->sendFeatures("/analysis/loudness", values, 5);
+    osc_messages_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<LoudnessMonitor::StreamLoudness> LoudnessMonitor::getReadings() const {
+    std::vector<StreamLoudness> result;
+    {
+        std::lock_guard<std::mutex> lock(readings_mutex_);
+        for (uint32_t stream = 0; stream < readings_.size(); ++stream) {
+            if (readings_[stream].valid) {
+                result.push_back(StreamLoudness{stream, std::string(), readings_[stream].reading});
+            }
+        }
+    }
+    for (auto& loudness : result) {
+        loudness.address = getAddress(loudness.stream);
+    }
+    return result;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "address_table.h"
+#include "stream_worker.h"
+#include "media_pipeline/loudness_meter.h"
+
+namespace media_pipeline {
+class OSCSender;
+}
+
+/**
+ * EBU R128 loudness and true peak of every received audio stream
+ *
+ * A StreamWorker running one LoudnessMeter per stream address, so neither
+ * the receive path nor the audio callback does any metering work. Each
+ * completed 100 ms step refreshes the stream's published reading and, with
+ * an OSC destination set, sends
+ *   /analysis/loudness <stream> <momentary> <short-term> <integrated> <true peak>
+ * (LUFS and dBTP, floored at kOscFloor; stream is the StreamWorker id of
+ * the stream address).
+ */
+class LoudnessMonitor : public StreamWorker {
+public:
+    static constexpr double kOscFloor = -120.0;
+
+    struct StreamLoudness {
+        uint32_t stream;
+        std::string address;
+        media_pipeline::LoudnessMeter::Reading reading;
+    };
+
+    LoudnessMonitor(int sample_rate, size_t queue_capacity = 256);
+    ~LoudnessMonitor() override;
+
+    /**
+     * Send readings over OSC (before start())
+     */
+    void setOscOutput(const std::string& host, int port);
+
+    /**
+     * Get the latest reading of every stream, by stream id
+     */
+    std::vector<StreamLoudness> getReadings() const;
+
+    uint64_t getOscMessageCount() const { return osc_messages_.load(std::memory_order_relaxed); }
+
+protected:
+    void onStart() override;
+    void analyze(uint32_t stream, const std::vector<float>& samples) override;
+
+private:
+    struct Published {
+        bool valid = false;
+        media_pipeline::LoudnessMeter::Reading reading;
+    };
+
+    void publish(uint32_t stream, const media_pipeline::LoudnessMeter& meter);
+
+    int sample_rate_;
+    std::string osc_host_;
+    int osc_port_;
+
+    // Worker thread only; by stream id, a meter created on the stream's first buffer
+    std::vector<std::unique_ptr<media_pipeline::LoudnessMeter>> meters_;
+    std::unique_ptr<media_pipeline::OSCSender> osc_;
+    std::atomic<uint64_t> osc_messages_;
+
+    mutable std::mutex readings_mutex_;
+    std::vector<Published> readings_;  // By stream id
+};
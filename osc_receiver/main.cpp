@@ -1,14 +1,41 @@
 #include <iostream>
 #include <string>
+#include <cstring>
+#include <algorithm>
 #include <signal.h>
 #include <unistd.h>
 #include <chrono>
+#include <fstream>
 #include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <ifaddrs.h>
 #include <arpa/inet.h>
 
 #include "osc_receiver.h"
 #include "audio_output.h"
+#include "loudness_monitor.h"
+#include "spectrum_service.h"
+#include "event_loop.h"
+#include "frame_reassembler.h"
+#include "frame_sink.h"
+#include "rx_timestamp.h"
+#include "media_pipeline/dsp_kernels.h"
+#include "media_pipeline/osc_message.h"
+#include "media_pipeline/plugin_host.h"
+#include "media_pipeline/spatial_renderer.h"
+#include "media_pipeline/trace.h"
+
+// Largest frame the shared-memory export holds (a 1080p RGBA frame is ~8 MB)
+static constexpr size_t kFrameSlotBytes = 16 * 1024 * 1024;
+
+// Playback rate, also assumed for the streams analyzed with -G
+static constexpr int kSampleRate = 44100;
+
+// Playback buffer, also the spatial renderer's block
+static constexpr int kBufferFrames = 512;
 
 // Global variables for signal handling
 static bool g_running = true;
@@ -56,13 +83,300 @@ void printUsage(const char* program_name) {
     std::cout << "  -p <port>     OSC port to listen on (default: 8000)" << std::endl;
     std::cout << "  -v <volume>   Output volume 0.0-1.0 (default: 0.5)" << std::endl;
     std::cout << "  -s            Silent mode (no audio output)" << std::endl;
+    std::cout << "  -u            Use io_uring receive backend (Linux, falls back to recvfrom)" << std::endl;
+    std::cout << "  -l <spec>     Add listener: udp:<port>, udp6:<port>, mcast:<group>:<port>," << std::endl;
+    std::cout << "                unix:<path>, tcp:<port>, tcp6:<port>, shm:<name|path>" << std::endl;
+    std::cout << "                (repeatable, uses the epoll event loop)" << std::endl;
+    std::cout << "  -t <threads>  Event loop threads (default: 1)" << std::endl;
+    std::cout << "  -b <cpu>      Busy-poll receive pinned to <cpu> (-1: no pinning, not with -u)" << std::endl;
+    std::cout << "  -r <prio>     SCHED_FIFO priority for receive and audio threads (falls back to nice)" << std::endl;
+    std::cout << "  -c <cpu>      Pin receive thread(s) to <cpu> (event loop threads use <cpu>+index)" << std::endl;
+    std::cout << "  -a <cpu>      Pin audio output thread to <cpu>" << std::endl;
+    std::cout << "  -m            Lock memory (mlockall) and prefault heap and stacks" << std::endl;
+    std::cout << "  -i            Ignore bundle timetags (dispatch bundles on arrival)" << std::endl;
+    std::cout << "  -V <port>     Reassemble UdpStreamOutputNode frames arriving on <port>" << std::endl;
+    std::cout << "  -o <file>     Append reassembled frames to <file>, indexed in <file>.idx" << std::endl;
+    std::cout << "  -S <name>     Export the latest frame in triple-buffered shared memory (name or path)" << std::endl;
+    std::cout << "  -F <format>   Frame format for -o/-S: <fourcc>[:<width>x<height>] (default: H264)" << std::endl;
+    std::cout << "                (each sender gets its own -o file and -S region, \"-2\", \"-3\"... after the first)" << std::endl;
+    std::cout << "  -g <file>     Append audio glitch events (underruns, dropouts, steps, clipping) to <file>" << std::endl;
+    std::cout << "  -G            Also check received audio streams for glitches before the playout queue" << std::endl;
+    std::cout << "  -E <band>     Equalizer band <type>:<freq>:<q>[:<gain_db>], e.g. peaking:3000:1.5:-4" << std::endl;
+    std::cout << "                (repeatable, in order; types: lowpass, highpass, bandpass, notch, allpass," << std::endl;
+    std::cout << "                peaking, lowshelf, highshelf)" << std::endl;
+    std::cout << "  -C <ir.wav>   Convolve playback with an impulse response (first channel of a WAV file)" << std::endl;
+    std::cout << "  -L            Meter EBU R128 loudness and true peak of every received stream" << std::endl;
+    std::cout << "  -M <host:port> Also send loudness readings as /analysis/loudness OSC messages (implies -L)" << std::endl;
+    std::cout << "  -A <host:port> Send a log-frequency spectrum of every received stream as quantized" << std::endl;
+    std::cout << "                /analysis/spectrum/<stream> OSC messages (levels, then peak holds, in dB)" << std::endl;
+    std::cout << "  -B <bands>    Spectrum bands, 40 Hz to 16 kHz (default: 32, at most 128)" << std::endl;
+    std::cout << "  -R <fps>      Spectrum frames per second (default: 30)" << std::endl;
+    std::cout << "  -X <layout>   Render each stream at its own position: binaural (headphones), or VBAP over" << std::endl;
+    std::cout << "                mono, stereo, quad, 5.0, 7.0, octagon or azimuths, e.g. 30,-30,110,-110" << std::endl;
+    std::cout << "  -H <hrir.wav> Binaural with measured HRIRs (2N channels, N directions from the front," << std::endl;
+    std::cout << "                counterclockwise; default: a spherical head model)" << std::endl;
+    std::cout << "  -P <stream>:<azimuth>[:<distance>] Place a stream, e.g. /audio/phone1:45:2 (repeatable;" << std::endl;
+    std::cout << "                degrees, left positive; also /control/position <stream> <azimuth> [distance])" << std::endl;
+    std::cout << "  -D <dir>      Load processing node plugins (shared libraries, plugin_abi.h) from <dir>" << std::endl;
+    std::cout << "                and list them" << std::endl;
+    std::cout << "  -N <id>[:<param>=<value>,...] Insert a plugin node into playback after the equalizer" << std::endl;
+    std::cout << "                (repeatable, in order; also /control/param <id> <param> <value>)" << std::endl;
+    std::cout << "  -T <file>     Write a Chrome/Perfetto trace to <file> at exit and on SIGUSR2" << std::endl;
+    std::cout << "                (events are recorded only in -DENABLE_TRACING=ON builds)" << std::endl;
     std::cout << "  -h            Show this help message" << std::endl;
     std::cout << std::endl;
     std::cout << "This receiver will listen for OSC audio messages and optionally play them back." << std::endl;
     std::cout << "Press Ctrl+C to quit." << std::endl;
 }
 
-void printStatus(const OSCReceiver& receiver, const AudioOutput* audio_output) {
+/**
+ * Move logged glitch events to the event log (JSON lines), or discard them
+ */
+void drainGlitchLog(media_pipeline::GlitchDetector& detector, const char* source, std::ofstream* log) {
+    media_pipeline::GlitchDetector::Event event;
+    bool written = false;
+    while (detector.popEvent(event)) {
+        if (!log) {
+            continue;
+        }
+        *log << "{\"source\":\"" << source << "\",\"type\":\""
+             << media_pipeline::GlitchDetector::typeName(event.type) << "\""
+             << ",\"time_ns\":" << event.timestamp_ns
+             << ",\"position\":" << event.position
+             << ",\"length\":" << event.length
+             << ",\"length_ms\":" << event.length * 1000.0 / kSampleRate
+             << ",\"magnitude\":" << event.magnitude
+             << ",\"first_packet\":" << event.first_packet
+             << ",\"last_packet\":" << event.last_packet
+             << ",\"queue_depth\":" << event.queue_depth << "}\n";
+        written = true;
+    }
+    if (written) {
+        log->flush();
+    }
+}
+
+/**
+ * Drain the detector of every stream in spatial mode, labelled with its address
+ */
+void drainStreamGlitchLogs(AudioOutput& audio_output, std::ofstream* log) {
+    const auto positions = audio_output.getStreamPositions();
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (media_pipeline::GlitchDetector* detector = audio_output.getStreamGlitchDetector(i)) {
+            drainGlitchLog(*detector, positions[i].stream.c_str(), log);
+        }
+    }
+}
+
+void printGlitchReport(const media_pipeline::GlitchDetector& detector, const char* label, std::ostream& out) {
+    using media_pipeline::GlitchDetector;
+    out << label << " glitches: " << detector.getTotalCount();
+    if (detector.getTotalCount() > 0) {
+        const char* separator = " (";
+        for (size_t type = 0; type < GlitchDetector::kTypeCount; ++type) {
+            out << separator << GlitchDetector::typeName(static_cast<GlitchDetector::Type>(type)) << " "
+                << detector.getCount(static_cast<GlitchDetector::Type>(type));
+            separator = ", ";
+        }
+        out << ")";
+    }
+    if (detector.getUnloggedCount() > 0) {
+        out << ", " << detector.getUnloggedCount() << " not logged (log full)";
+    }
+    out << std::endl;
+}
+
+/**
+ * Frame sinks by sender on the video port (FrameReassembler::Frame::source)
+ * Each sender's frames get a shared-memory region and file of their own.
+ * The first sender keeps the -S and -o names; later ones add "-<n>" (before
+ * a file's extension). Only the video loop thread writes, until it stops.
+ */
+class VideoSinks {
+public:
+    static constexpr size_t kMaxSources = 8;  // Frames from senders past this are dropped
+
+    VideoSinks(const FrameFormat& format, const std::string& file_path, const std::string& shm_name)
+        : format_(format), file_path_(file_path), shm_name_(shm_name), dropped_frames_(0) {}
+
+    void write(const FrameReassembler::Frame& frame) {
+        if (FrameSink* sink = sinkFor(frame.source)) {
+            sink->write(frame.data, frame.size, frame.timestamp, frame.last_arrival_ns);
+        }
+    }
+
+    /**
+     * Close every sink and report what did not fit (after the video loop stops)
+     */
+    void close(std::ostream& out) {
+        uint64_t oversized = 0;
+        for (auto& entry : sinks_) {
+            oversized += entry.second->getOversizedCount();
+            entry.second->close();
+        }
+        if (oversized > 0) {
+            out << "Frames too large for shared memory export: " << oversized << std::endl;
+        }
+        if (dropped_frames_ > 0) {
+            out << "Frames dropped from senders past " << kMaxSources << ": " << dropped_frames_ << std::endl;
+        }
+    }
+
+private:
+    static std::string suffixed(const std::string& name, size_t ordinal) {
+        if (ordinal == 1) {
+            return name;
+        }
+        const std::string suffix = "-" + std::to_string(ordinal);
+        const size_t slash = name.rfind('/');
+        const size_t dot = name.rfind('.');
+        if (dot != std::string::npos && dot > 0 && (slash == std::string::npos || dot > slash + 1)) {
+            return name.substr(0, dot) + suffix + name.substr(dot);
+        }
+        return name + suffix;
+    }
+
+    FrameSink* sinkFor(uint64_t source) {
+        auto it = sinks_.find(source);
+        if (it != sinks_.end()) {
+            return it->second.get();
+        }
+        if (sinks_.size() >= kMaxSources) {
+            dropped_frames_++;
+            return nullptr;
+        }
+        const size_t ordinal = sinks_.size() + 1;
+        std::unique_ptr<FrameSink> sink(new FrameSink(format_));
+        std::string error;
+        std::cout << std::endl << "Stream frames from sender " << ordinal;
+        if (!file_path_.empty()) {
+            const std::string path = suffixed(file_path_, ordinal);
+            std::cout << " -> " << path;
+            if (!sink->openFile(path, error)) {
+                std::cerr << "Frame file: " << error << std::endl;
+            }
+        }
+        if (!shm_name_.empty()) {
+            const std::string name = suffixed(shm_name_, ordinal);
+            std::cout << " -> shm:" << name;
+            if (!sink->openSharedMemory(name, kFrameSlotBytes, error)) {
+                std::cerr << "Frame export: " << error << std::endl;
+            }
+        }
+        std::cout << std::endl;
+        return sinks_.emplace(source, std::move(sink)).first->second.get();
+    }
+
+    FrameFormat format_;
+    std::string file_path_;
+    std::string shm_name_;
+    std::map<uint64_t, std::unique_ptr<FrameSink>> sinks_;
+    uint64_t dropped_frames_;
+};
+
+/**
+ * Glitch detectors for the received audio, one per stream address
+ * Chunks of one block arrive on addresses of their own and share their
+ * stream's detector, so continuity and packet sequence are checked per stream.
+ */
+class StreamGlitches {
+public:
+    static constexpr size_t kMaxStreams = 64;  // Buffers from streams past this are not analyzed
+
+    StreamGlitches() : channel_streams_(AddressTable::kMaxChannels, kNoStream), unanalyzed_(0) {}
+
+    /**
+     * Analyze one received buffer (event loop threads may call concurrently)
+     */
+    void analyze(uint32_t channel, const std::string& address, const std::vector<float>& samples,
+                 uint64_t arrival_ns) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stream* stream = streamFor(channel, address);
+        if (!stream) {
+            unanalyzed_++;
+            return;
+        }
+        media_pipeline::GlitchDetector::Context context;
+        context.packet_sequence = ++stream->packets;
+        context.timestamp_ns = arrival_ns;
+        stream->detector.analyze(samples.data(), samples.size(), context);
+    }
+
+    /**
+     * Move every stream's logged events to the event log, labelled with its address
+     */
+    void drain(std::ofstream* log) {
+        for (Stream* stream : snapshot()) {
+            drainGlitchLog(stream->detector, stream->address.c_str(), log);
+        }
+    }
+
+    /**
+     * Print counts per stream (after the receiver stops)
+     */
+    void print(std::ostream& out) {
+        for (Stream* stream : snapshot()) {
+            printGlitchReport(stream->detector, ("Received stream " + stream->address).c_str(), out);
+        }
+        if (unanalyzed_ > 0) {
+            out << "Buffers from streams past " << kMaxStreams << " not checked for glitches: " << unanalyzed_
+                << std::endl;
+        }
+    }
+
+private:
+    static constexpr uint32_t kNoStream = UINT32_MAX;
+
+    struct Stream {
+        explicit Stream(const std::string& stream_address)
+            : address(stream_address), detector(kSampleRate), packets(0) {}
+
+        std::string address;
+        media_pipeline::GlitchDetector detector;
+        uint64_t packets;
+    };
+
+    Stream* streamFor(uint32_t channel, const std::string& address) {
+        // The overflow id is shared by every address past the table, so it is never cached
+        const bool cached = channel < AddressTable::kOverflowId;
+        uint32_t index = cached ? channel_streams_[channel] : kNoStream;
+        if (index == kNoStream) {
+            const std::string stream = media_pipeline::OSCParser::streamAddress(address);
+            auto it = by_address_.find(stream);
+            if (it == by_address_.end()) {
+                if (streams_.size() >= kMaxStreams) {
+                    return nullptr;
+                }
+                it = by_address_.emplace(stream, static_cast<uint32_t>(streams_.size())).first;
+                streams_.emplace_back(new Stream(stream));
+            }
+            index = it->second;
+            if (cached) {
+                channel_streams_[channel] = index;
+            }
+        }
+        return streams_[index].get();
+    }
+
+    // Streams are never removed, so the pointers stay valid outside the lock
+    std::vector<Stream*> snapshot() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Stream*> streams;
+        for (const auto& stream : streams_) {
+            streams.push_back(stream.get());
+        }
+        return streams;
+    }
+
+    std::mutex mutex_;
+    std::vector<uint32_t> channel_streams_;  // Receiver channel id to stream index
+    std::map<std::string, uint32_t> by_address_;
+    std::vector<std::unique_ptr<Stream>> streams_;
+    uint64_t unanalyzed_;
+};
+
+void printStatus(const OSCReceiver& receiver, const AudioOutput* audio_output, const FrameReassembler* video,
+                 const LoudnessMonitor* loudness) {
     static auto start_time = std::chrono::steady_clock::now();
     static uint64_t last_message_count = 0;
     auto now = std::chrono::steady_clock::now();
@@ -80,20 +394,210 @@ void printStatus(const OSCReceiver& receiver, const AudioOutput* audio_output) {
                   << " | Rate: " << std::fixed << std::setprecision(1) << messages_per_second << " msg/s";
 
         if (audio_output && audio_output->isRunning()) {
-            std::cout << " | Audio: ON";
+            std::cout << " | Audio: ON"
+                      << " | Jitter: " << std::setprecision(2) << audio_output->getJitterMs() << " ms"
+                      << " | Playout: " << std::setprecision(1) << audio_output->getPlayoutDelayMs() << " ms"
+                      << " | Glitches: " << audio_output->getGlitchCount();
         } else {
             std::cout << " | Audio: OFF";
         }
 
+        if (video) {
+            std::cout << " | Frames: " << video->getCompletedFrames()
+                      << " (" << video->getTimedOutFrames() + video->getEvictedFrames() << " lost)";
+        }
+
+        if (loudness) {
+            // The loudest stream right now, by momentary loudness
+            double loudest = media_pipeline::LoudnessMeter::kSilence;
+            for (const auto& stream : loudness->getReadings()) {
+                loudest = std::max(loudest, stream.reading.momentary_lufs);
+            }
+            if (loudest > media_pipeline::LoudnessMeter::kSilence) {
+                std::cout << " | Loudest: " << std::setprecision(1) << loudest << " LUFS";
+            }
+        }
+
         std::cout << " | Channels: Audio/Text/Analysis" << std::flush;
         last_message_count = message_count;
     }
 }
 
+/**
+ * Parse "<stream>:<azimuth>[:<distance>]"; the stream itself may not contain ':'
+ */
+bool parseStreamPosition(const std::string& spec, AudioOutput::StreamPosition& position) {
+    const size_t colon = spec.find(':');
+    if (colon == 0 || colon == std::string::npos) {
+        return false;
+    }
+    position.stream = spec.substr(0, colon);
+    position.distance_m = 1.0f;
+    char* end = nullptr;
+    position.azimuth_deg = std::strtof(spec.c_str() + colon + 1, &end);
+    if (end == spec.c_str() + colon + 1) {
+        return false;
+    }
+    if (*end == ':') {
+        const char* distance = end + 1;
+        position.distance_m = std::strtof(distance, &end);
+        if (end == distance || position.distance_m <= 0.0f) {
+            return false;
+        }
+    }
+    return *end == '\0';
+}
+
+/**
+ * A plugin node to insert with -N: "<id>[:<parameter>=<value>,...]"
+ */
+struct PluginSpec {
+    std::string id;
+    std::vector<std::pair<std::string, float>> parameters;
+
+    static bool parse(const std::string& spec, PluginSpec& plugin) {
+        const size_t colon = spec.find(':');
+        plugin.id = spec.substr(0, colon);
+        plugin.parameters.clear();
+        if (plugin.id.empty()) {
+            return false;
+        }
+        if (colon == std::string::npos) {
+            return true;
+        }
+        std::istringstream list(spec.substr(colon + 1));
+        std::string assignment;
+        while (std::getline(list, assignment, ',')) {
+            const size_t equals = assignment.find('=');
+            if (equals == 0 || equals == std::string::npos) {
+                return false;
+            }
+            char* end = nullptr;
+            const float value = std::strtof(assignment.c_str() + equals + 1, &end);
+            if (end == assignment.c_str() + equals + 1 || *end != '\0') {
+                return false;
+            }
+            plugin.parameters.emplace_back(assignment.substr(0, equals), value);
+        }
+        return !plugin.parameters.empty();
+    }
+};
+
+/**
+ * List the nodes the loaded plugins offer, with their parameters
+ */
+void printPlugins(const media_pipeline::PluginHost& host, std::ostream& out) {
+    for (const auto* descriptor : host.getDescriptors()) {
+        out << "  " << descriptor->id << "  " << (descriptor->name ? descriptor->name : "") << " (latency "
+            << descriptor->latency_frames << " frames";
+        for (uint32_t i = 0; i < descriptor->param_count; ++i) {
+            const mp_plugin_param& param = descriptor->params[i];
+            out << (i == 0 ? "; " : ", ") << param.name << " " << param.min_value << ".." << param.max_value;
+        }
+        out << ")" << std::endl;
+    }
+}
+
+/**
+ * Build the renderer for -X/-H: binaural, or VBAP over a speaker layout
+ */
+std::unique_ptr<media_pipeline::SpatialRenderer> createSpatialRenderer(const std::string& spec,
+                                                                       const std::string& hrir_path,
+                                                                       std::string& description, std::string& error) {
+    using media_pipeline::SpatialRenderer;
+    SpatialRenderer::Config config;
+    config.block_size = kBufferFrames;
+    std::ostringstream text;
+    if (spec == "binaural") {
+        media_pipeline::HrirSet hrirs;
+        if (hrir_path.empty()) {
+            hrirs = media_pipeline::HrirSet::sphericalHead(kSampleRate);
+            text << "binaural, spherical head model";
+        } else if (!media_pipeline::HrirSet::load(hrir_path, hrirs, error)) {
+            return nullptr;
+        } else {
+            text << "binaural, " << hrir_path;
+        }
+        text << " (" << hrirs.getDirectionCount() << " directions)";
+        description = text.str();
+        return SpatialRenderer::createBinaural(kSampleRate, hrirs, config, error);
+    }
+    media_pipeline::SpeakerLayout layout;
+    if (!media_pipeline::SpeakerLayout::parse(spec, layout)) {
+        error = "unknown speaker layout " + spec;
+        return nullptr;
+    }
+    text << "VBAP over " << layout.azimuths.size() << " speakers (";
+    const char* separator = "";
+    for (float azimuth : layout.azimuths) {
+        text << separator << azimuth;
+        separator = ", ";
+    }
+    text << " degrees)";
+    description = text.str();
+    return SpatialRenderer::createPanner(kSampleRate, layout, config, error);
+}
+
+/**
+ * Print the loudness of every metered stream
+ */
+void printLoudnessReport(const LoudnessMonitor& loudness, std::ostream& out) {
+    auto level = [](double value) {
+        std::ostringstream text;
+        if (value > media_pipeline::LoudnessMeter::kSilence) {
+            text << std::fixed << std::setprecision(1) << value;
+        } else {
+            text << "-inf";
+        }
+        return text.str();
+    };
+    for (const auto& stream : loudness.getReadings()) {
+        out << "Loudness " << stream.address << ": integrated " << level(stream.reading.integrated_lufs) << " LUFS"
+            << ", short-term " << level(stream.reading.short_term_lufs) << " LUFS"
+            << ", true peak " << level(stream.reading.true_peak_dbtp) << " dBTP"
+            << " (" << std::fixed << std::setprecision(1)
+            << static_cast<double>(stream.reading.frames) / kSampleRate << " s)" << std::endl;
+    }
+    if (loudness.getDroppedCount() > 0) {
+        out << "Loudness buffers dropped: " << loudness.getDroppedCount() << std::endl;
+    }
+}
+
 int main(int argc, char* argv[]) {
     int port = 8000;
     float volume = 0.5f;
     bool silent_mode = false;
+    bool use_io_uring = false;
+    std::vector<ListenerConfig> listeners;
+    int loop_threads = 1;
+    bool busy_poll = false;
+    int busy_poll_cpu = -1;
+    int rt_priority = 0;
+    int receive_cpu = -1;
+    int audio_cpu = -1;
+    bool lock_memory = false;
+    bool bundle_scheduling = true;
+    int video_port = 0;
+    std::string video_output_path;
+    std::string video_shm_name;
+    FrameFormat video_format;
+    FrameFormat::parse("H264", video_format);
+    std::string trace_path;
+    std::string glitch_log_path;
+    bool analyze_streams = false;
+    std::string impulse_response_path;
+    std::vector<EqualizerBand> equalizer_bands;
+    bool meter_loudness = false;
+    std::string loudness_host;
+    int loudness_port = 0;
+    std::string spectrum_host;
+    int spectrum_port = 0;
+    media_pipeline::SpectrumAnalyzer::Config spectrum_config;
+    std::string spatial_spec;
+    std::string hrir_path;
+    std::vector<AudioOutput::StreamPosition> stream_positions;
+    std::string plugin_directory;
+    std::vector<PluginSpec> plugin_specs;
 
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
@@ -109,16 +613,145 @@ int main(int argc, char* argv[]) {
             volume = std::clamp(volume, 0.0f, 1.0f);
         } else if (arg == "-s") {
             silent_mode = true;
+        } else if (arg == "-u") {
+            use_io_uring = true;
+        } else if (arg == "-l" && i + 1 < argc) {
+            ListenerConfig config;
+            if (!ListenerConfig::parse(argv[++i], config)) {
+                std::cerr << "Invalid listener spec: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            listeners.push_back(config);
+        } else if (arg == "-t" && i + 1 < argc) {
+            loop_threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "-b" && i + 1 < argc) {
+            busy_poll = true;
+            busy_poll_cpu = std::atoi(argv[++i]);
+        } else if (arg == "-r" && i + 1 < argc) {
+            rt_priority = std::clamp(std::atoi(argv[++i]), 1, 99);
+        } else if (arg == "-c" && i + 1 < argc) {
+            receive_cpu = std::atoi(argv[++i]);
+        } else if (arg == "-a" && i + 1 < argc) {
+            audio_cpu = std::atoi(argv[++i]);
+        } else if (arg == "-m") {
+            lock_memory = true;
+        } else if (arg == "-i") {
+            bundle_scheduling = false;
+        } else if (arg == "-V" && i + 1 < argc) {
+            video_port = std::atoi(argv[++i]);
+        } else if (arg == "-o" && i + 1 < argc) {
+            video_output_path = argv[++i];
+        } else if (arg == "-S" && i + 1 < argc) {
+            video_shm_name = argv[++i];
+        } else if (arg == "-F" && i + 1 < argc) {
+            if (!FrameFormat::parse(argv[++i], video_format)) {
+                std::cerr << "Invalid frame format: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "-g" && i + 1 < argc) {
+            glitch_log_path = argv[++i];
+        } else if (arg == "-G") {
+            analyze_streams = true;
+        } else if (arg == "-E" && i + 1 < argc) {
+            EqualizerBand band;
+            if (!EqualizerBand::parse(argv[++i], band)) {
+                std::cerr << "Invalid equalizer band: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            equalizer_bands.push_back(band);
+        } else if (arg == "-C" && i + 1 < argc) {
+            impulse_response_path = argv[++i];
+        } else if (arg == "-L") {
+            meter_loudness = true;
+        } else if (arg == "-M" && i + 1 < argc) {
+            std::string destination = argv[++i];
+            size_t colon = destination.rfind(':');
+            loudness_port = colon == std::string::npos ? 0 : std::atoi(destination.c_str() + colon + 1);
+            if (loudness_port <= 0) {
+                std::cerr << "Invalid loudness destination: " << destination << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            loudness_host = destination.substr(0, colon);
+            meter_loudness = true;
+        } else if (arg == "-A" && i + 1 < argc) {
+            std::string destination = argv[++i];
+            size_t colon = destination.rfind(':');
+            spectrum_port = colon == std::string::npos ? 0 : std::atoi(destination.c_str() + colon + 1);
+            if (spectrum_port <= 0) {
+                std::cerr << "Invalid spectrum destination: " << destination << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            spectrum_host = destination.substr(0, colon);
+        } else if (arg == "-B" && i + 1 < argc) {
+            int bands = std::atoi(argv[++i]);
+            if (bands <= 0 || bands > static_cast<int>(SpectrumService::kMaxBands)) {
+                std::cerr << "Invalid spectrum band count: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            spectrum_config.bands = static_cast<size_t>(bands);
+        } else if (arg == "-R" && i + 1 < argc) {
+            float fps = static_cast<float>(std::atof(argv[++i]));
+            if (fps <= 0.0f || fps > 200.0f) {
+                std::cerr << "Invalid spectrum frame rate: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            spectrum_config.frame_rate = fps;
+        } else if (arg == "-X" && i + 1 < argc) {
+            spatial_spec = argv[++i];
+        } else if (arg == "-H" && i + 1 < argc) {
+            hrir_path = argv[++i];
+            spatial_spec = "binaural";
+        } else if (arg == "-P" && i + 1 < argc) {
+            AudioOutput::StreamPosition position;
+            if (!parseStreamPosition(argv[++i], position)) {
+                std::cerr << "Invalid stream position: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            stream_positions.push_back(position);
+        } else if (arg == "-D" && i + 1 < argc) {
+            plugin_directory = argv[++i];
+        } else if (arg == "-N" && i + 1 < argc) {
+            PluginSpec plugin;
+            if (!PluginSpec::parse(argv[++i], plugin)) {
+                std::cerr << "Invalid plugin node: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            plugin_specs.push_back(plugin);
+        } else if (arg == "-T" && i + 1 < argc) {
+            trace_path = argv[++i];
         } else {
             std::cerr << "Unknown argument: " << arg << std::endl;
             printUsage(argv[0]);
             return 1;
         }
     }
+    if (!spatial_spec.empty() && !impulse_response_path.empty()) {
+        std::cerr << "-C convolves mono playback and cannot be combined with -X or -H" << std::endl;
+        return 1;
+    }
+    if (use_io_uring && busy_poll) {
+        std::cerr << "-u and -b each pick the receive backend and cannot be combined" << std::endl;
+        return 1;
+    }
 
     // Set up signal handling
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
+    if (!trace_path.empty()) {
+        media_pipeline::trace::setThreadName("main");
+        if (!media_pipeline::trace::enableDump(trace_path, SIGUSR2)) {
+            std::cerr << "Trace dump on SIGUSR2 unavailable, writing at exit only" << std::endl;
+        }
+    }
 
     std::cout << "OSC Multi-Channel Receiver" << std::endl;
     std::cout << "===========================" << std::endl;
@@ -129,20 +762,107 @@ int main(int argc, char* argv[]) {
     std::cout << "Port: " << port << std::endl;
     std::cout << "Volume: " << volume << std::endl;
     std::cout << "Audio output: " << (silent_mode ? "disabled" : "enabled") << std::endl;
+    std::cout << "Bundle timetags: " << (bundle_scheduling ? "scheduled" : "ignored") << std::endl;
+    if (!glitch_log_path.empty() || analyze_streams) {
+        std::cout << "Glitch detection: playout" << (analyze_streams ? " and received streams" : "");
+        if (!glitch_log_path.empty()) {
+            std::cout << " -> " << glitch_log_path;
+        }
+        std::cout << std::endl;
+    }
+    if (video_port > 0) {
+        std::cout << "Stream frames: port " << video_port << " (" << video_format.describe() << ")";
+        if (!video_output_path.empty()) {
+            std::cout << " -> " << video_output_path;
+        }
+        if (!video_shm_name.empty()) {
+            std::cout << " -> shm:" << video_shm_name;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "DSP kernels: " << media_pipeline::dsp::isaName(media_pipeline::dsp::activeIsa()) << std::endl;
+    if (!trace_path.empty()) {
+#if defined(MEDIA_PIPELINE_TRACING)
+        std::cout << "Trace: " << trace_path << " (kill -USR2 " << getpid() << " to dump now)" << std::endl;
+#else
+        std::cout << "Trace: " << trace_path << " (tracing not compiled in, rebuild with -DENABLE_TRACING=ON)" << std::endl;
+#endif
+    }
+    if (!listeners.empty() || loop_threads > 1) {
+        std::cout << "Receive backend: epoll (" << loop_threads << " thread(s))" << std::endl;
+        for (const auto& config : listeners) {
+            std::cout << "Extra listener: " << config.describe() << std::endl;
+        }
+    } else if (busy_poll) {
+        std::cout << "Receive backend: busy-poll";
+        if (busy_poll_cpu >= 0) {
+            std::cout << " (CPU " << busy_poll_cpu << ")";
+        }
+        std::cout << std::endl;
+    } else {
+        std::cout << "Receive backend: " << (use_io_uring ? "io_uring" : "recvfrom") << std::endl;
+    }
+    if (lock_memory) {
+        std::string memory_report;
+        media_pipeline::lockProcessMemory(64 * 1024 * 1024, memory_report);
+        std::cout << "Memory: " << memory_report << std::endl;
+    }
     std::cout << "Supported channels:" << std::endl;
     std::cout << "  • Audio: /chan1/audio or /audio/*" << std::endl;
     std::cout << "  • Text:  /chan2/text or /text/*" << std::endl;
     std::cout << "  • Analysis: /chan3/analysis or /analysis/*" << std::endl;
+    std::cout << "  • Control: /control/* (e.g. /control/position)" << std::endl;
     std::cout << std::endl;
 
     // Create OSC receiver
     OSCReceiver receiver(port);
     g_receiver = &receiver;
+    if (use_io_uring) {
+        receiver.setReceiveBackend(OSCReceiver::ReceiveBackend::IO_URING);
+    } else if (busy_poll) {
+        receiver.setReceiveBackend(OSCReceiver::ReceiveBackend::BUSY_POLL);
+        receiver.setBusyPoll(busy_poll_cpu);
+    }
+    for (const auto& config : listeners) {
+        receiver.addListener(config);
+    }
+    receiver.setLoopThreads(loop_threads);
+    receiver.setBundleScheduling(bundle_scheduling);
 
-    // Create audio output (if not in silent mode)
+    // Real-time setup; each thread applies its own config and reports the outcome
+    media_pipeline::ThreadConfig receive_config;
+    receive_config.cpu = receive_cpu;
+    receive_config.flush_denormals = true;
+    if (rt_priority > 0) {
+        receive_config.policy = media_pipeline::SchedulingPolicy::FIFO;
+        receive_config.priority = rt_priority;
+    }
+    media_pipeline::ThreadConfig audio_config = receive_config;
+    audio_config.cpu = audio_cpu;
+    if (rt_priority > 0) {
+        audio_config.priority = std::min(rt_priority + 1, 99);  // Playback outranks receive
+    }
+    if (lock_memory) {
+        receive_config.prefault_stack_bytes = 256 * 1024;
+        audio_config.prefault_stack_bytes = 64 * 1024;
+    }
+    receiver.setThreadConfig(receive_config);
+
+    // Create audio output (if not in silent mode); plugin libraries stay
+    // loaded while the host or any node from them exists
+    media_pipeline::PluginHost plugin_host;
+    if (!plugin_directory.empty()) {
+        std::vector<std::string> errors;
+        plugin_host.loadDirectory(plugin_directory, errors);
+        for (const auto& error : errors) {
+            std::cerr << "Plugin: " << error << std::endl;
+        }
+        std::cout << "Plugins in " << plugin_directory << ":" << std::endl;
+        printPlugins(plugin_host, std::cout);
+    }
     AudioOutput* audio_output = nullptr;
     if (!silent_mode) {
-        audio_output = new AudioOutput();
+        audio_output = new AudioOutput(kSampleRate, kBufferFrames);
         g_audio_output = audio_output;
 
         if (!audio_output->initialize()) {
@@ -152,6 +872,79 @@ int main(int argc, char* argv[]) {
         }
 
         audio_output->setVolume(volume);
+        audio_output->setThreadConfig(audio_config);
+
+        if (!spatial_spec.empty()) {
+            std::string description;
+            std::string error;
+            auto renderer = createSpatialRenderer(spatial_spec, hrir_path, description, error);
+            if (!renderer || !audio_output->setSpatialRenderer(std::move(renderer), error)) {
+                std::cerr << "Spatial rendering: " << error << std::endl;
+                delete audio_output;
+                return 1;
+            }
+            std::cout << "Spatial rendering: " << description << ", up to "
+                      << audio_output->getSpatialRenderer()->getMaxSources() << " streams" << std::endl;
+            for (const auto& position : stream_positions) {
+                if (!audio_output->setStreamPosition(position.stream, position.azimuth_deg, position.distance_m)) {
+                    std::cerr << "No renderer source left for " << position.stream << std::endl;
+                }
+            }
+        }
+
+        if (!equalizer_bands.empty()) {
+            audio_output->setEqualizer(equalizer_bands);
+            std::cout << "Equalizer:";
+            const char* separator = " ";
+            for (const auto& band : equalizer_bands) {
+                std::cout << separator << media_pipeline::BiquadCoefficients::typeName(band.type) << " "
+                          << band.frequency << " Hz Q " << band.q;
+                if (band.gain_db != 0.0) {
+                    std::cout << " " << std::showpos << band.gain_db << std::noshowpos << " dB";
+                }
+                separator = ", ";
+            }
+            std::cout << std::endl;
+        }
+
+        for (const auto& plugin : plugin_specs) {
+            std::string error;
+            auto node = plugin_host.createNode(plugin.id, kSampleRate, audio_output->getOutputChannels(),
+                                               kBufferFrames, error);
+            for (const auto& parameter : plugin.parameters) {
+                if (node && !node->setParameter(parameter.first, parameter.second)) {
+                    std::cerr << "Plugin " << plugin.id << " has no parameter " << parameter.first << std::endl;
+                }
+            }
+            if (!node || !audio_output->addPlugin(std::move(node), error)) {
+                std::cerr << "Plugin node: " << error << std::endl;
+                delete audio_output;
+                return 1;
+            }
+        }
+        if (!plugin_specs.empty()) {
+            std::cout << "Plugin nodes: " << plugin_specs.size() << " after the equalizer, "
+                      << audio_output->getPluginLatency() << " frames of latency" << std::endl;
+        }
+
+        if (!impulse_response_path.empty()) {
+            // The tail worker runs like a receive thread, below playback, on any core
+            media_pipeline::ThreadConfig tail_config = receive_config;
+            tail_config.cpu = -1;
+            std::string error;
+            if (audio_output->loadImpulseResponse(impulse_response_path, tail_config, error)) {
+                const auto* convolver = audio_output->getConvolver();
+                const auto stats = convolver->getStats();
+                std::cout << "Convolution: " << impulse_response_path << " ("
+                          << std::fixed << std::setprecision(2)
+                          << static_cast<double>(convolver->getLength()) / kSampleRate << " s, "
+                          << stats.head_partitions << " x " << convolver->getBlockSize() << " in the callback, "
+                          << stats.tail_partitions << " x " << convolver->getTailPartition() << " on a worker)"
+                          << std::endl;
+            } else {
+                std::cerr << "Impulse response: " << error << std::endl;
+            }
+        }
 
         if (!audio_output->start()) {
             std::cerr << "Failed to start audio output" << std::endl;
@@ -159,19 +952,125 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
-        // Set up audio callback to forward received audio to output
-        receiver.setAudioCallback([audio_output](const std::vector<float>& samples) {
-            audio_output->addAudioData(samples);
+    }
+
+    std::unique_ptr<std::ofstream> glitch_log;
+    if (!glitch_log_path.empty()) {
+        glitch_log.reset(new std::ofstream(glitch_log_path, std::ios::app));
+        if (!*glitch_log) {
+            std::cerr << "Cannot open glitch log " << glitch_log_path << std::endl;
+            glitch_log.reset();
+        } else {
+            *glitch_log << std::fixed << std::setprecision(3);
+        }
+    }
+
+    const bool spatial = audio_output && audio_output->getSpatialRenderer();
+    if (audio_output && !spatial) {
+        receiver.setAudioCallback([audio_output](const std::vector<float>& samples, uint64_t arrival_ns) {
+            audio_output->addAudioData(samples, arrival_ns);
+        });
+    }
+
+    // Received streams are checked as parsed, so glitches from the sender or
+    // the network show up separately from those the playout queue adds
+    StreamGlitches stream_glitches;
+    if (analyze_streams) {
+        receiver.addAudioTap([&stream_glitches](uint32_t channel, const std::string& address,
+                                                const StreamWorker::Samples& samples, uint64_t arrival_ns) {
+            stream_glitches.analyze(channel, address, *samples, arrival_ns);
+        });
+    }
+
+    // Spatial playback queues each stream on its own, so it needs the address
+    // the audio callback does not carry
+    if (spatial) {
+        receiver.addAudioTap([audio_output](uint32_t channel, const std::string& address,
+                                            const StreamWorker::Samples& samples, uint64_t arrival_ns) {
+            audio_output->addStreamAudio(channel, address, *samples, arrival_ns);
+        });
+    }
+
+    // Live control of playback:
+    //   /control/position <stream> <azimuth> [distance]
+    //   /control/param <plugin id> <parameter> <value>
+    if (spatial || (audio_output && !plugin_specs.empty())) {
+        receiver.setControlCallback([audio_output](const std::string& address, const std::string& arguments,
+                                                   uint64_t /*arrival_ns*/) {
+            std::istringstream fields(arguments);
+            if (address == "/control/position") {
+                std::string stream;
+                float azimuth = 0.0f;
+                float distance = 1.0f;
+                if (!(fields >> stream >> azimuth)) {
+                    std::cerr << "Ignoring /control/position " << arguments << std::endl;
+                    return;
+                }
+                if (!(fields >> distance) || distance <= 0.0f) {
+                    distance = 1.0f;
+                }
+                audio_output->setStreamPosition(stream, azimuth, distance);
+            } else if (address == "/control/param") {
+                std::string id;
+                std::string parameter;
+                float value = 0.0f;
+                media_pipeline::PluginNode* node = nullptr;
+                if (!(fields >> id >> parameter >> value) || !(node = audio_output->getPlugin(id)) ||
+                    !node->setParameter(parameter, value)) {
+                    std::cerr << "Ignoring /control/param " << arguments << std::endl;
+                }
+            }
+        });
+    }
+
+    // Received streams are metered and analyzed on their own threads, from
+    // buffers the receiver shares out once it has finished with them
+    std::unique_ptr<LoudnessMonitor> loudness;
+    if (meter_loudness) {
+        loudness.reset(new LoudnessMonitor(kSampleRate));
+        media_pipeline::ThreadConfig meter_config;  // Normal scheduling: below receive and playback
+        meter_config.flush_denormals = true;
+        loudness->setThreadConfig(meter_config);
+        if (loudness_port > 0) {
+            loudness->setOscOutput(loudness_host, loudness_port);
+        }
+        loudness->start();
+        LoudnessMonitor* monitor = loudness.get();
+        receiver.addAudioTap([monitor](uint32_t channel, const std::string& address,
+                                       const StreamWorker::Samples& samples, uint64_t /*arrival_ns*/) {
+            monitor->submit(channel, address, samples);
+        });
+        std::cout << "Loudness metering: EBU R128 per stream";
+        if (loudness_port > 0) {
+            std::cout << ", /analysis/loudness to " << loudness_host << ":" << loudness_port;
+        }
+        std::cout << std::endl;
+    }
+    std::unique_ptr<SpectrumService> spectrum;
+    if (spectrum_port > 0) {
+        spectrum.reset(new SpectrumService(kSampleRate, spectrum_config));
+        media_pipeline::ThreadConfig spectrum_thread;
+        spectrum_thread.flush_denormals = true;
+        spectrum->setThreadConfig(spectrum_thread);
+        spectrum->setOscOutput(spectrum_host, spectrum_port);
+        spectrum->start();
+        SpectrumService* service = spectrum.get();
+        receiver.addAudioTap([service](uint32_t channel, const std::string& address,
+                                       const StreamWorker::Samples& samples, uint64_t /*arrival_ns*/) {
+            service->submit(channel, address, samples);
         });
+        std::cout << "Spectrum: " << spectrum_config.bands << " bands at " << spectrum_config.frame_rate
+                  << " fps per stream, /analysis/spectrum/<stream> to " << spectrum_host << ":" << spectrum_port
+                  << std::endl;
     }
 
     // Set up text message callback
-    receiver.setTextCallback([](const std::string& channel, const std::string& message) {
+    receiver.setTextCallback([](const std::string& channel, const std::string& message, uint64_t /*arrival_ns*/) {
         std::cout << std::endl << "[TEXT " << channel << "] " << message << std::endl;
     });
 
     // Set up analysis data callback
-    receiver.setAnalysisCallback([](const std::string& channel, const std::vector<float>& features) {
+    receiver.setAnalysisCallback([](const std::string& channel, const std::vector<float>& features, uint64_t /*arrival_ns*/) {
         std::cout << std::endl << "[ANALYSIS " << channel << "] " << features.size() << " features: ";
         for (size_t i = 0; i < std::min(features.size(), size_t(5)); ++i) {
             std::cout << std::fixed << std::setprecision(3) << features[i];
@@ -190,19 +1089,67 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    // Stream frames from UdpStreamOutputNode get their own socket and thread
+    std::unique_ptr<FrameReassembler> video;
+    std::unique_ptr<EventLoop> video_loop;
+    std::unique_ptr<VideoSinks> video_sinks;
+    if (video_port > 0) {
+        video_sinks.reset(new VideoSinks(video_format, video_output_path, video_shm_name));
+        video.reset(new FrameReassembler());
+        VideoSinks* sinks = video_sinks.get();
+        video->setFrameCallback([sinks](const FrameReassembler::Frame& frame) {
+            sinks->write(frame);
+        });
+
+        ListenerConfig config;
+        ListenerConfig::parse("udp:" + std::to_string(video_port), config);
+        video_loop.reset(new EventLoop(1));
+        video_loop->addListener(config);
+        FrameReassembler* reassembler = video.get();
+        if (!video_loop->start([reassembler](const char* data, size_t length, uint64_t arrival_ns, uint64_t source) {
+                reassembler->handlePacket(data, length, arrival_ns, source);
+            })) {
+            std::cerr << "Failed to listen for stream frames on port " << video_port << std::endl;
+            video_loop.reset();
+            video.reset();
+        }
+    }
+
     std::cout << "Receiver started. Listening for multi-channel OSC messages..." << std::endl;
     std::cout << "Press Ctrl+C to quit." << std::endl;
     std::cout << std::endl;
 
     // Main loop
     auto last_status_time = std::chrono::steady_clock::now();
+    bool audio_thread_reported = false;
     while (g_running) {
         sleep(1);
 
+        // The audio thread configures itself on its first callback
+        if (audio_output && !audio_thread_reported) {
+            std::string report = audio_output->getThreadReport();
+            if (!report.empty()) {
+                std::cout << "Thread " << report << std::endl;
+                audio_thread_reported = true;
+            }
+        }
+
+        if (video) {
+            video->expire(rx_timestamp::nowNs());
+        }
+
+        if (audio_output) {
+            drainGlitchLog(audio_output->getGlitchDetector(), "playout", glitch_log.get());
+            drainStreamGlitchLogs(*audio_output, glitch_log.get());
+        }
+        if (analyze_streams) {
+            stream_glitches.drain(glitch_log.get());
+        }
+
         // Print status every second
         auto now = std::chrono::steady_clock::now();
         if (std::chrono::duration_cast<std::chrono::milliseconds>(now - last_status_time).count() >= 1000) {
-            printStatus(receiver, audio_output);
+            printStatus(receiver, audio_output, video.get(), loudness.get());
             last_status_time = now;
         }
     }
@@ -213,8 +1160,63 @@ int main(int argc, char* argv[]) {
     if (g_running) {
         receiver.stop();
     }
+    receiver.printLatencyReport(std::cout);
+    if (loudness) {
+        loudness->flush();
+        loudness->stop();
+        printLoudnessReport(*loudness, std::cout);
+    }
+    if (spectrum) {
+        spectrum->stop();
+        std::cout << "Spectrum frames sent: " << spectrum->getFrameCount() << " (" << spectrum->getStreamCount()
+                  << " streams)";
+        if (spectrum->getDroppedCount() > 0) {
+            std::cout << ", buffers dropped " << spectrum->getDroppedCount();
+        }
+        std::cout << std::endl;
+    }
+    if (video_loop) {
+        video_loop->stop();
+        std::cout << "Stream frames: " << video->getCompletedFrames() << " (" << video->getCompletedBytes() << " bytes)"
+                  << ", timed out " << video->getTimedOutFrames()
+                  << ", evicted " << video->getEvictedFrames()
+                  << ", duplicate packets " << video->getDuplicatePackets()
+                  << ", stale packets " << video->getStalePackets()
+                  << ", invalid packets " << video->getInvalidPackets() << std::endl;
+        video_sinks->close(std::cout);
+    }
+    if (analyze_streams) {
+        stream_glitches.drain(glitch_log.get());
+        stream_glitches.print(std::cout);
+    }
     if (audio_output) {
         audio_output->stop();
+        drainGlitchLog(audio_output->getGlitchDetector(), "playout", glitch_log.get());
+        drainStreamGlitchLogs(*audio_output, glitch_log.get());
+        const auto positions = audio_output->getStreamPositions();
+        if (positions.empty()) {
+            printGlitchReport(audio_output->getGlitchDetector(), "Playout", std::cout);
+        }
+        for (size_t i = 0; i < positions.size(); ++i) {
+            printGlitchReport(*audio_output->getStreamGlitchDetector(i), ("Playout " + positions[i].stream).c_str(),
+                              std::cout);
+        }
+        for (const auto& position : positions) {
+            std::cout << "Stream " << position.stream << ": azimuth " << std::fixed << std::setprecision(1)
+                      << position.azimuth_deg << " degrees, distance " << position.distance_m << " m" << std::endl;
+        }
+        if (audio_output->getUnplacedCount() > 0) {
+            std::cout << "Streams beyond the renderer's sources: " << audio_output->getUnplacedCount()
+                      << " buffers dropped" << std::endl;
+        }
+        if (audio_output->getOverflowCount() > 0) {
+            std::cout << "Playout queue overflows: " << audio_output->getOverflowCount() << " buffers dropped" << std::endl;
+        }
+        if (const auto* convolver = audio_output->getConvolver()) {
+            const auto stats = convolver->getStats();
+            std::cout << "Convolution tail blocks: " << stats.tail_blocks_completed << " computed, "
+                      << stats.tail_blocks_late << " late" << std::endl;
+        }
         delete audio_output;
     }
 
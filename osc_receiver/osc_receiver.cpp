@@ -1,18 +1,50 @@
 #include "osc_receiver.h"
+#include "uring_receiver.h"
+#include "rx_timestamp.h"
+#include "media_pipeline/osc_message.h"
+#include "media_pipeline/trace.h"
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <pthread.h>
+#include <chrono>
 #include <iostream>
-#include <sstream>
 #include <cstring>
+#include <cerrno>
+#include <cstdlib>
 #include <iomanip>
-#include <map>
+
+using media_pipeline::OSCParser;
+
+namespace {
+
+constexpr int kMaxBundleDepth = 8;
+constexpr char kClockSyncAddress[] = "/clock/sync";
+
+} // namespace
 
 OSCReceiver::OSCReceiver(int port)
     : port_(port)
     , socket_fd_(-1)
     , running_(false)
+    , backend_(ReceiveBackend::BLOCKING)
+    , active_backend_(ReceiveBackend::BLOCKING)
+    , loop_threads_(1)
+    , busy_poll_cpu_(-1)
+    , busy_poll_spin_us_(200)
+    , spin_wakes_(0)
+    , blocked_wakes_(0)
+    , bundle_scheduling_(true)
+    , late_bundles_(0)
+    , malformed_bundles_(0)
+    , feature_channels_(new FeatureChannel[AddressTable::kMaxChannels])
+    , latest_audio_(new LatestAudio[AddressTable::kMaxChannels])
+    , features_decoded_(0)
+    , features_skipped_(0)
     , message_count_(0) {
 }
 
@@ -25,10 +57,32 @@ bool OSCReceiver::start() {
         return true;
     }
 
+    if (bundle_scheduling_) {
+        bundle_scheduler_.setThreadInit([this]() {
+            applyThreadConfig("osc-sched", loop_threads_);
+        });
+        bundle_scheduler_.start([this](const std::string& packet, uint64_t arrival_ns, uint64_t source, int depth) {
+            if (OSCParser::isBundle(packet.data(), packet.size())) {
+                handleBundle(packet.data(), packet.size(), arrival_ns, source, depth);
+            } else {
+                parseOSCMessage(packet, arrival_ns, source);
+            }
+        });
+    }
+
+    if (backend_ == ReceiveBackend::EPOLL || !extra_listeners_.empty() || loop_threads_ > 1) {
+        bool ok = startEventLoop();
+        if (!ok) {
+            bundle_scheduler_.stop();
+        }
+        return ok;
+    }
+
     // Create UDP socket
     socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
     if (socket_fd_ < 0) {
         std::cerr << "Failed to create socket" << std::endl;
+        bundle_scheduler_.stop();
         return false;
     }
 
@@ -37,9 +91,14 @@ bool OSCReceiver::start() {
     if (setsockopt(socket_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
         std::cerr << "Failed to set socket options" << std::endl;
         close(socket_fd_);
+        bundle_scheduler_.stop();
         return false;
     }
 
+    if (!rx_timestamp::enable(socket_fd_)) {
+        std::cerr << "Kernel receive timestamps unavailable, using receive time" << std::endl;
+    }
+
     // Bind to port
     struct sockaddr_in addr;
     memset(&addr, 0, sizeof(addr));
@@ -50,6 +109,7 @@ bool OSCReceiver::start() {
     if (bind(socket_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
         std::cerr << "Failed to bind to port " << port_ << std::endl;
         close(socket_fd_);
+        bundle_scheduler_.stop();
         return false;
     }
 
@@ -60,6 +120,41 @@ bool OSCReceiver::start() {
     return true;
 }
 
+bool OSCReceiver::startEventLoop() {
+    event_loop_ = std::make_unique<EventLoop>(loop_threads_);
+
+    ListenerConfig primary;
+    primary.type = ListenerConfig::Type::UDP4;
+    primary.port = port_;
+    event_loop_->addListener(primary);
+    for (const auto& config : extra_listeners_) {
+        event_loop_->addListener(config);
+    }
+
+    event_loop_->setThreadInit([this](int index) {
+        std::string name = "osc-loop-" + std::to_string(index);
+        applyThreadConfig(name.c_str(), index);
+    });
+
+    running_ = true;
+    bool ok = event_loop_->start([this](const char* data, size_t length, uint64_t arrival_ns, uint64_t source) {
+        handlePacket(data, length, arrival_ns, source);
+    });
+    if (!ok) {
+        running_ = false;
+        event_loop_.reset();
+        return false;
+    }
+
+    active_backend_ = ReceiveBackend::EPOLL;
+    std::cout << "OSC Receiver started with " << loop_threads_ << " event loop thread(s) on:";
+    for (const auto& config : event_loop_->getListeners()) {
+        std::cout << " " << config.describe();
+    }
+    std::cout << std::endl;
+    return true;
+}
+
 void OSCReceiver::stop() {
     if (!running_) {
         return;
@@ -67,24 +162,46 @@ void OSCReceiver::stop() {
 
     running_ = false;
 
-    // Close socket first to unblock receive thread
+    if (event_loop_) {
+        event_loop_->stop();
+        event_loop_.reset();
+        bundle_scheduler_.stop();
+        std::cout << "OSC Receiver stopped" << std::endl;
+        return;
+    }
+
+    // Shut down the socket first to unblock the receive thread (close() alone
+    // does not wake a blocked recvfrom on Linux); close it only once the thread
+    // has stopped using it
     if (socket_fd_ >= 0) {
-        close(socket_fd_);
-        socket_fd_ = -1;
+        shutdown(socket_fd_, SHUT_RDWR);
     }
 
     // Wait for thread to finish
     if (receive_thread_.joinable()) {
         receive_thread_.join();
     }
+    if (socket_fd_ >= 0) {
+        close(socket_fd_);
+        socket_fd_ = -1;
+    }
+    bundle_scheduler_.stop();
 
     std::cout << "OSC Receiver stopped" << std::endl;
 }
 
+void OSCReceiver::addListener(const ListenerConfig& config) {
+    extra_listeners_.push_back(config);
+}
+
 void OSCReceiver::setAudioCallback(AudioCallback callback) {
     audio_callback_ = callback;
 }
 
+void OSCReceiver::addAudioTap(AudioTap tap) {
+    audio_taps_.push_back(std::move(tap));
+}
+
 void OSCReceiver::setTextCallback(TextCallback callback) {
     text_callback_ = callback;
 }
@@ -93,25 +210,86 @@ void OSCReceiver::setAnalysisCallback(AnalysisCallback callback) {
     analysis_callback_ = callback;
 }
 
-std::vector<float> OSCReceiver::getLatestAudioData() {
-    std::lock_guard<std::mutex> lock(data_mutex_);
-    return latest_audio_;
+void OSCReceiver::setControlCallback(ControlCallback callback) {
+    control_callback_ = callback;
+}
+
+std::vector<float> OSCReceiver::getLatestAudioData(uint32_t channel) {
+    if (channel >= AddressTable::kMaxChannels) {
+        return std::vector<float>();
+    }
+    LatestAudio& latest = latest_audio_[channel];
+    std::lock_guard<std::mutex> lock(latest.mutex);
+    return latest.samples;
+}
+
+void OSCReceiver::applyThreadConfig(const char* name, int cpu_offset) {
+    media_pipeline::ThreadConfig config = thread_config_;
+    if (config.cpu >= 0) {
+        config.cpu += cpu_offset;
+    }
+
+    auto result = media_pipeline::applyThreadConfig(config, name);
+    if (config.policy != media_pipeline::SchedulingPolicy::DEFAULT || config.cpu >= 0 ||
+        config.flush_denormals || config.prefault_stack_bytes > 0) {
+        std::cout << "Thread " << result.summary << std::endl;
+    }
 }
 
 void OSCReceiver::receiveLoop() {
+    applyThreadConfig("osc-recv", 0);
+
+    if (backend_ == ReceiveBackend::IO_URING && receiveLoopUring()) {
+        return;
+    }
+
+    if (backend_ == ReceiveBackend::BUSY_POLL) {
+        active_backend_ = ReceiveBackend::BUSY_POLL;
+        receiveLoopBusyPoll();
+        return;
+    }
+
+    active_backend_ = ReceiveBackend::BLOCKING;
+    receiveLoopBlocking();
+}
+
+ssize_t OSCReceiver::receivePacket(char* buffer, size_t size, int flags, uint64_t& arrival_ns, uint64_t& source) {
+    struct sockaddr_storage sender_addr;
+    char control[rx_timestamp::kControlSize];
+    struct iovec iov;
+    iov.iov_base = buffer;
+    iov.iov_len = size;
+
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &sender_addr;
+    msg.msg_namelen = sizeof(sender_addr);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t bytes_received = recvmsg(socket_fd_, &msg, flags);
+    if (bytes_received > 0) {
+        arrival_ns = rx_timestamp::extract(&msg);
+        if (arrival_ns == 0) {
+            arrival_ns = rx_timestamp::nowNs();
+        }
+        source = EventLoop::sourceOf(sender_addr, msg.msg_namelen);
+    }
+    return bytes_received;
+}
+
+void OSCReceiver::receiveLoopBlocking() {
     char buffer[4096];
-    struct sockaddr_in sender_addr;
-    socklen_t sender_len = sizeof(sender_addr);
+    uint64_t arrival_ns = 0;
+    uint64_t source = 0;
 
     while (running_) {
-        ssize_t bytes_received = recvfrom(socket_fd_, buffer, sizeof(buffer) - 1, 0,
-                                        (struct sockaddr*)&sender_addr, &sender_len);
+        ssize_t bytes_received = receivePacket(buffer, sizeof(buffer) - 1, 0, arrival_ns, source);
 
         if (bytes_received > 0) {
-            buffer[bytes_received] = '\0';
-            std::string data(buffer, bytes_received);
-            parseOSCMessage(data);
-            message_count_++;
+            handlePacket(buffer, static_cast<size_t>(bytes_received), arrival_ns, source);
         } else if (bytes_received < 0) {
             // Socket error or closed - exit gracefully
             if (running_) {
@@ -123,132 +301,328 @@ void OSCReceiver::receiveLoop() {
     }
 }
 
-void OSCReceiver::parseOSCMessage(const std::string& data) {
-    OSCParser::OSCMessage msg = OSCParser::parseMessage(data);
+bool OSCReceiver::receiveLoopUring() {
+    UringReceiver uring;
+    if (!uring.initialize(socket_fd_)) {
+        std::cerr << "io_uring unavailable, falling back to blocking recvfrom" << std::endl;
+        return false;
+    }
+
+    active_backend_ = ReceiveBackend::IO_URING;
+    std::cout << "OSC Receiver using io_uring multishot recvmsg" << std::endl;
+
+    bool ok = uring.run(running_, [this](const char* data, size_t length, uint64_t arrival_ns, uint64_t source) {
+        handlePacket(data, length, arrival_ns, source);
+    });
+
+    if (!ok && running_) {
+        std::cerr << "io_uring receive failed, falling back to blocking recvfrom" << std::endl;
+        return false;
+    }
 
-    if (msg.valid) {
-        // Reduced verbosity - only show channel info
-        static std::map<std::string, int> channel_counts;
-        channel_counts[msg.address]++;
+    if (uring.getBatchCount() > 0) {
+        std::cout << "io_uring: " << uring.getPacketCount() << " packets in "
+                  << uring.getBatchCount() << " batches" << std::endl;
+    }
+    return true;
+}
 
-        if (channel_counts[msg.address] % 100 == 1) {  // Show every 100th message
-            std::string typeStr = (msg.type == OSCParser::AUDIO) ? "audio" :
-                                (msg.type == OSCParser::TEXT) ? "text" :
-                                (msg.type == OSCParser::ANALYSIS) ? "analysis" : "unknown";
-            std::cout << "[" << msg.address << "] " << typeStr << " (msg #" << channel_counts[msg.address] << ") ";
+void OSCReceiver::receiveLoopBusyPoll() {
+#ifdef __linux__
+    if (busy_poll_cpu_ >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(busy_poll_cpu_, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+            std::cerr << "Failed to pin receive thread to CPU " << busy_poll_cpu_ << std::endl;
         }
+    }
+#endif
 
-        // Route to appropriate callback
-        switch (msg.type) {
-            case OSCParser::AUDIO:
-                if (!msg.floatData.empty()) {
-                    {
-                        std::lock_guard<std::mutex> lock(data_mutex_);
-                        latest_audio_ = msg.floatData;
-                        audio_queue_.push(msg.floatData);
-                        while (audio_queue_.size() > 10) { // Keep last 10 audio buffers
-                            audio_queue_.pop();
-                        }
-                    }
-                    if (audio_callback_) {
-                        audio_callback_(msg.floatData);
-                    }
-                }
-                break;
-            case OSCParser::TEXT:
-                if (text_callback_) {
-                    text_callback_(msg.address, msg.textData);
-                }
-                break;
-            case OSCParser::ANALYSIS:
-                if (analysis_callback_) {
-                    analysis_callback_(msg.address, msg.floatData);
-                }
-                break;
-            default:
-                break;
+    // Let the driver poll the NIC queue from recv() instead of waiting for an interrupt
+#ifdef SO_BUSY_POLL
+    int busy_poll_us = 50;
+    if (setsockopt(socket_fd_, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(busy_poll_us)) < 0) {
+        std::cerr << "SO_BUSY_POLL unavailable (needs CAP_NET_ADMIN to raise), spinning in userspace only" << std::endl;
+    }
+#endif
+#ifdef SO_PREFER_BUSY_POLL
+    int prefer = 1;
+    setsockopt(socket_fd_, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer));
+#endif
+
+    int flags = fcntl(socket_fd_, F_GETFL, 0);
+    fcntl(socket_fd_, F_SETFL, flags | O_NONBLOCK);
+
+    std::cout << "OSC Receiver busy-polling"
+              << (busy_poll_cpu_ >= 0 ? " on CPU " + std::to_string(busy_poll_cpu_) : std::string())
+              << " (spin " << busy_poll_spin_us_ << " us before back-off)" << std::endl;
+
+    using Clock = std::chrono::steady_clock;
+    const auto spin_budget = std::chrono::microseconds(busy_poll_spin_us_);
+    const auto yield_budget = spin_budget * 10;
+
+    char buffer[4096];
+    uint64_t arrival_ns = 0;
+    uint64_t source = 0;
+    auto last_packet = Clock::now();
+    bool blocked = false;
+
+    while (running_) {
+        ssize_t bytes_received = receivePacket(buffer, sizeof(buffer) - 1, MSG_DONTWAIT, arrival_ns, source);
+
+        if (bytes_received > 0) {
+            (blocked ? blocked_wakes_ : spin_wakes_)++;
+            blocked = false;
+            handlePacket(buffer, static_cast<size_t>(bytes_received), arrival_ns, source);
+            last_packet = Clock::now();
+            continue;
+        }
+
+        if (bytes_received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            if (running_) {
+                std::cerr << "Socket error in busy-poll loop, stopping..." << std::endl;
+                running_ = false;
+            }
+            break;
+        }
+
+        // Adaptive back-off: spin, then yield, then block until the socket is readable
+        auto idle = Clock::now() - last_packet;
+        if (idle < spin_budget) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        } else if (idle < yield_budget) {
+            sched_yield();
+        } else {
+            struct pollfd pfd;
+            pfd.fd = socket_fd_;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (poll(&pfd, 1, 100) > 0) {
+                blocked = true;
+                last_packet = Clock::now();  // Resume spinning on activity
+            }
         }
     }
 }
 
-// OSC Parser implementation
-OSCParser::OSCMessage OSCParser::parseMessage(const std::string& data) {
-    OSCMessage msg;
-    msg.valid = false;
-    msg.type = UNKNOWN;
+void OSCReceiver::handlePacket(const char* data, size_t length, uint64_t arrival_ns, uint64_t source) {
+    MP_TRACE_SCOPE("OSCReceiver::handlePacket");
+    if (OSCParser::isBundle(data, length)) {
+        handleBundle(data, length, arrival_ns, source, 0);
+    } else {
+        std::string packet(data, length);
+        parseOSCMessage(packet, arrival_ns, source);
+    }
+    message_count_++;
 
-    std::istringstream iss(data);
-    std::string token;
+    // Kernel arrival to end of dispatch: includes wakeup, scheduling and parse cost
+    uint64_t now_ns = rx_timestamp::nowNs();
+    latency_histogram_.record(now_ns > arrival_ns ? now_ns - arrival_ns : 0);
+}
 
-    // Get address
-    if (iss >> token) {
-        msg.address = token;
-        msg.type = getMessageType(token);
+void OSCReceiver::handleBundle(const char* data, size_t length, uint64_t arrival_ns, uint64_t source, int depth) {
+    OSCParser::OSCBundle bundle;
+    if (depth >= kMaxBundleDepth || !OSCParser::parseBundle(data, length, bundle)) {
+        malformed_bundles_++;
+        return;
+    }
 
-        switch (msg.type) {
-            case AUDIO:
-                // Parse remaining tokens as float samples
-                while (iss >> token) {
-                    try {
-                        float sample = std::stof(token);
-                        msg.floatData.push_back(sample);
-                    } catch (const std::exception&) {
-                        continue;
-                    }
-                }
-                msg.valid = !msg.floatData.empty();
-                break;
+    // Immediate timetags (and scheduling disabled) take the fast path below
+    uint64_t deadline_ns = 0;
+    if (bundle_scheduling_ && bundle.timetag != OSCParser::kImmediateTimetag) {
+        deadline_ns = OSCParser::timetagToUnixNs(bundle.timetag) + getClockOffsetNs(source);
+        if (deadline_ns <= rx_timestamp::nowNs()) {
+            late_bundles_++;
+            deadline_ns = 0;
+        }
+    }
+
+    for (const auto& element : bundle.elements) {
+        // Scheduled elements keep their depth, so nesting limits hold across dispatch
+        if (deadline_ns != 0 &&
+            bundle_scheduler_.schedule(deadline_ns, element.first, element.second, arrival_ns, source, depth + 1)) {
+            continue;
+        }
+        if (OSCParser::isBundle(element.first, element.second)) {
+            handleBundle(element.first, element.second, arrival_ns, source, depth + 1);
+        } else {
+            parseOSCMessage(std::string(element.first, element.second), arrival_ns, source);
+        }
+    }
+}
+
+void OSCReceiver::printLatencyReport(std::ostream& out) const {
+    latency_histogram_.print(out, "Arrival-to-dispatch latency");
+    if (active_backend_ == ReceiveBackend::BUSY_POLL) {
+        out << "Busy-poll wakes: " << spin_wakes_ << " while spinning, "
+            << blocked_wakes_ << " after blocking" << std::endl;
+    }
+    if (bundle_scheduler_.getScheduledCount() > 0 || late_bundles_ > 0 || malformed_bundles_ > 0) {
+        bundle_scheduler_.getLatenessHistogram().print(out, "Bundle dispatch lateness (vs timetag)");
+        out << "Bundles: " << bundle_scheduler_.getScheduledCount() << " elements scheduled, "
+            << bundle_scheduler_.getPendingCount() << " pending, "
+            << late_bundles_ << " late on arrival, "
+            << bundle_scheduler_.getDroppedCount() << " dropped (queue full), "
+            << malformed_bundles_ << " malformed" << std::endl;
+    }
+    uint32_t channel_count = channels_.size();
+    if (channel_count > 0) {
+        out << "Channels:" << std::endl;
+        for (uint32_t id = 0; id <= channel_count; ++id) {
+            uint32_t channel = id < channel_count ? id : AddressTable::kOverflowId;
+            const AddressTable::ChannelStats& stats = channels_.stats(channel);
+            if (channel == AddressTable::kOverflowId && stats.messages == 0 && stats.invalid == 0) {
+                continue;
+            }
+            out << "  " << std::setw(4) << channel << "  " << channels_.getAddress(channel)
+                << ": " << stats.messages << " messages, " << stats.bytes << " bytes";
+            if (stats.invalid > 0) {
+                out << ", " << stats.invalid << " invalid";
+            }
+            out << std::endl;
+        }
+    }
+    if (features_decoded_ > 0 || features_skipped_ > 0) {
+        out << "Quantized features: " << features_decoded_ << " vectors decoded, "
+            << features_skipped_ << " skipped waiting for a keyframe" << std::endl;
+    }
+    std::lock_guard<std::mutex> lock(clock_mutex_);
+    for (const auto& entry : clock_offsets_) {
+        out << "Sender " << std::hex << std::setw(16) << std::setfill('0') << entry.first << std::dec
+            << std::setfill(' ') << " clock offset: " << std::fixed << std::setprecision(1)
+            << entry.second->getOffsetNs() / 1e3 << " us (" << entry.second->getSampleCount()
+            << " sync messages)" << std::endl;
+    }
+}
+
+int64_t OSCReceiver::getClockOffsetNs(uint64_t source) const {
+    std::lock_guard<std::mutex> lock(clock_mutex_);
+    auto it = clock_offsets_.find(source);
+    return it != clock_offsets_.end() ? it->second->getOffsetNs() : 0;
+}
+
+ClockOffsetEstimator* OSCReceiver::clockOffsetFor(uint64_t source) {
+    std::lock_guard<std::mutex> lock(clock_mutex_);
+    auto it = clock_offsets_.find(source);
+    if (it != clock_offsets_.end()) {
+        return it->second.get();
+    }
+    if (clock_offsets_.size() >= kMaxClockSources) {
+        return nullptr;
+    }
+    return clock_offsets_.emplace(source, std::make_unique<ClockOffsetEstimator>()).first->second.get();
+}
+
+void OSCReceiver::parseOSCMessage(const std::string& data, uint64_t arrival_ns, uint64_t source) {
+    MP_TRACE_SCOPE("OSCReceiver::parseOSCMessage");
+    // "/clock/sync <sender CLOCK_REALTIME ns>" feeds the bundle timetag offset
+    const size_t sync_length = sizeof(kClockSyncAddress) - 1;
+    if (data.size() > sync_length && (data[sync_length] == ' ' || data[sync_length] == '\0') &&
+        data.compare(0, sync_length, kClockSyncAddress) == 0) {
+        unsigned long long sender_ns = std::strtoull(data.c_str() + sync_length, nullptr, 10);
+        ClockOffsetEstimator* clock_offset = sender_ns > 0 ? clockOffsetFor(source) : nullptr;
+        if (clock_offset) {
+            clock_offset->addSample(sender_ns, arrival_ns);
+        }
+        return;
+    }
+
+    OSCParser::OSCMessage msg = OSCParser::parseMessage(data);
+    msg.arrival_ns = arrival_ns;
+
+    if (msg.address.empty()) {
+        return;
+    }
+
+    // Only messages that parse get an id of their own, so junk cannot fill the
+    // table; invalid ones are counted against a known address or the overflow id
+    if (!msg.valid) {
+        channels_.stats(channels_.find(msg.address)).invalid.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    uint32_t channel = channels_.intern(msg.address);
+    AddressTable::ChannelStats& stats = channels_.stats(channel);
+
+    // Addresses past the table share the overflow id, and interleaved deltas
+    // from several senders would decode to garbage against one shared state
+    if (msg.encodedOffset > 0 && channel == AddressTable::kOverflowId) {
+        msg.valid = false;
+    } else if (msg.encodedOffset > 0) {
+        FeatureChannel& feature = feature_channels_[channel];
+        std::lock_guard<std::mutex> lock(feature.mutex);
+        auto& decoder = feature.decoder;
+        uint64_t skipped = decoder.getSkippedCount();
+        msg.valid = decoder.decode(data.data() + msg.encodedOffset, data.size() - msg.encodedOffset, msg.floatData);
+        if (msg.valid) {
+            features_decoded_++;
+        } else if (decoder.getSkippedCount() != skipped) {
+            features_skipped_++;
+        }
+    }
 
-            case TEXT:
-                // Parse remaining text as single string
+    if (!msg.valid) {
+        stats.invalid.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Reduced verbosity - only show channel info
+    uint64_t count = stats.messages.fetch_add(1, std::memory_order_relaxed) + 1;
+    stats.bytes.fetch_add(data.size(), std::memory_order_relaxed);
+    stats.last_arrival_ns.store(arrival_ns, std::memory_order_relaxed);
+
+    if (count % 100 == 1) {  // Show every 100th message
+        std::string typeStr = (msg.type == OSCParser::AUDIO) ? "audio" :
+                            (msg.type == OSCParser::TEXT) ? "text" :
+                            (msg.type == OSCParser::ANALYSIS) ? "analysis" :
+                            (msg.type == OSCParser::CONTROL) ? "control" : "unknown";
+        std::cout << "[" << msg.address << "] " << typeStr << " (msg #" << count << ") ";
+    }
+
+    // Route to appropriate callback
+    switch (msg.type) {
+        case OSCParser::AUDIO:
+            if (!msg.floatData.empty()) {
                 {
-                    std::string restOfLine;
-                    std::getline(iss, restOfLine);
-                    if (!restOfLine.empty() && restOfLine[0] == ' ') {
-                        restOfLine = restOfLine.substr(1); // Remove leading space
-                    }
-                    msg.textData = restOfLine;
-                    msg.valid = !msg.textData.empty();
+                    LatestAudio& latest = latest_audio_[channel];
+                    std::lock_guard<std::mutex> lock(latest.mutex);
+                    latest.samples = msg.floatData;
                 }
-                break;
-
-            case ANALYSIS:
-                // Parse as float array (ML features)
-                while (iss >> token) {
-                    try {
-                        float value = std::stof(token);
-                        msg.floatData.push_back(value);
-                    } catch (const std::exception&) {
-                        continue;
+                if (audio_callback_) {
+                    MP_TRACE_SCOPE("audio_callback");
+                    audio_callback_(msg.floatData, msg.arrival_ns);
+                }
+                if (!audio_taps_.empty()) {
+                    auto shared = std::make_shared<const std::vector<float>>(std::move(msg.floatData));
+                    for (const auto& tap : audio_taps_) {
+                        tap(channel, msg.address, shared, msg.arrival_ns);
                     }
                 }
-                msg.valid = !msg.floatData.empty();
-                break;
-
-            default:
-                break;
-        }
+            }
+            break;
+        case OSCParser::TEXT:
+            if (text_callback_) {
+                MP_TRACE_SCOPE("text_callback");
+                text_callback_(msg.address, msg.textData, msg.arrival_ns);
+            }
+            break;
+        case OSCParser::ANALYSIS:
+            if (analysis_callback_) {
+                MP_TRACE_SCOPE("analysis_callback");
+                analysis_callback_(msg.address, msg.floatData, msg.arrival_ns);
+            }
+            break;
+        case OSCParser::CONTROL:
+            if (control_callback_) {
+                MP_TRACE_SCOPE("control_callback");
+                control_callback_(msg.address, msg.textData, msg.arrival_ns);
+            }
+            break;
+        default:
+            break;
     }
-
-    return msg;
-}
-
-OSCParser::MessageType OSCParser::getMessageType(const std::string& address) {
-    // TouchDesigner-style channel routing
-    if (address.find("/chan1/audio") == 0 ||
-        address.find("/audio/") == 0 ||
-        address.find("audio") != std::string::npos) {
-        return AUDIO;
-    } else if (address.find("/chan2/text") == 0 ||
-               address.find("/text/") == 0 ||
-               address.find("text") != std::string::npos) {
-        return TEXT;
-    } else if (address.find("/chan3/analysis") == 0 ||
-               address.find("/analysis/") == 0 ||
-               address.find("/features/") == 0 ||
-               address.find("analysis") != std::string::npos ||
-               address.find("features") != std::string::npos) {
-        return ANALYSIS;
-    }
-    return UNKNOWN;
-}
\ No newline at end of file
+}
@@ -6,7 +6,16 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
-#include <queue>
+#include <map>
+#include <memory>
+#include <sys/types.h>
+
+#include "address_table.h"
+#include "bundle_scheduler.h"
+#include "event_loop.h"
+#include "latency_histogram.h"
+#include "media_pipeline/feature_codec.h"
+#include "media_pipeline/thread_config.h"
 
 /**
  * Multi-channel OSC receiver for audio, text, and analysis data
@@ -14,9 +23,21 @@
  */
 class OSCReceiver {
 public:
-    using AudioCallback = std::function<void(const std::vector<float>&)>;
-    using TextCallback = std::function<void(const std::string&, const std::string&)>;  // (channel, message)
-    using AnalysisCallback = std::function<void(const std::string&, const std::vector<float>&)>;  // (channel, features)
+    // Every callback receives the kernel arrival time of its packet (CLOCK_REALTIME ns)
+    using AudioCallback = std::function<void(const std::vector<float>&, uint64_t)>;  // (samples, arrival_ns)
+    using TextCallback = std::function<void(const std::string&, const std::string&, uint64_t)>;  // (channel, message, arrival_ns)
+    using AnalysisCallback = std::function<void(const std::string&, const std::vector<float>&, uint64_t)>;  // (channel, features, arrival_ns)
+    using ControlCallback = std::function<void(const std::string&, const std::string&, uint64_t)>;  // (address, arguments, arrival_ns)
+    // Shares the parsed samples after the audio callback: (channel id, address, samples, arrival_ns)
+    using AudioTap = std::function<void(uint32_t, const std::string&,
+                                        const std::shared_ptr<const std::vector<float>>&, uint64_t)>;
+
+    enum class ReceiveBackend {
+        BLOCKING,   // recvfrom() loop
+        IO_URING,   // Multishot recvmsg with provided buffers (Linux), falls back to BLOCKING
+        EPOLL,      // Shared edge-triggered event loop over all listeners (Linux)
+        BUSY_POLL   // Spin on a non-blocking socket, backing off to poll() when idle
+    };
 
     OSCReceiver(int port = 8000);
     ~OSCReceiver();
@@ -36,6 +57,14 @@ public:
      */
     void setAudioCallback(AudioCallback callback);
 
+    /**
+     * Add a tap that receives every audio buffer with its stream (before start())
+     * The parsed buffer is moved into one read-only shared buffer for all
+     * taps, so none of them copies it; taps run on the receive thread that
+     * parsed it, after the audio callback, and should only queue it.
+     */
+    void addAudioTap(AudioTap tap);
+
     /**
      * Set callback for received text messages
      */
@@ -47,9 +76,87 @@ public:
     void setAnalysisCallback(AnalysisCallback callback);
 
     /**
-     * Get latest received audio data
+     * Set callback for received /control/ messages (e.g. source positions)
+     */
+    void setControlCallback(ControlCallback callback);
+
+    /**
+     * Select the socket receive backend (takes effect on next start())
+     */
+    void setReceiveBackend(ReceiveBackend backend) { backend_ = backend; }
+
+    /**
+     * Listen on an additional socket (UDP port, IPv6, multicast group or unix path)
+     * Any extra listener switches the receiver to the EPOLL backend; the
+     * constructor port is always served as udp:<port>.
+     */
+    void addListener(const ListenerConfig& config);
+
+    /**
+     * Set number of event loop threads used by the EPOLL backend
+     */
+    void setLoopThreads(int count) { loop_threads_ = count > 0 ? count : 1; }
+
+    /**
+     * Configure the BUSY_POLL backend
+     * @param cpu Core to pin the receive thread to (-1 leaves affinity alone)
+     * @param spin_us Idle time spent spinning before yielding, then blocking
+     */
+    void setBusyPoll(int cpu, int spin_us = 200) {
+        busy_poll_cpu_ = cpu;
+        busy_poll_spin_us_ = spin_us;
+    }
+
+    /**
+     * Set scheduling policy, affinity and FPU state for receive threads
+     * Applied at the top of the receive thread (or every event loop thread,
+     * where the CPU is offset by the thread index) and reported on stdout.
+     */
+    void setThreadConfig(const media_pipeline::ThreadConfig& config) { thread_config_ = config; }
+
+    /**
+     * Dispatch timetagged bundles at their timetag (default) or on arrival
+     * Timetags are converted to local time with the offset estimated from
+     * the same sender's /clock/sync messages (its CLOCK_REALTIME in ns);
+     * without those its clock is assumed to be synchronised already
+     * (NTP/PTP). Bundles with the immediate timetag are always dispatched on
+     * arrival.
+     */
+    void setBundleScheduling(bool enabled) { bundle_scheduling_ = enabled; }
+
+    /**
+     * Get the clock offset estimate used for one sender's bundle timetags
+     * @param source Sender id (EventLoop::sourceOf)
+     * @return Offset in ns, 0 until a /clock/sync arrived from that sender
+     */
+    int64_t getClockOffsetNs(uint64_t source) const;
+
+    /**
+     * Get arrival-to-dispatch latency histogram (all backends)
+     */
+    const LatencyHistogram& getLatencyHistogram() const { return latency_histogram_; }
+
+    /**
+     * Print latency histogram and busy-poll wake statistics
+     */
+    void printLatencyReport(std::ostream& out) const;
+
+    /**
+     * Get the backend the receive thread is actually using
+     */
+    ReceiveBackend getActiveBackend() const { return active_backend_; }
+
+    /**
+     * Get the latest audio buffer received on a channel
+     * @param channel Id from getChannels(); kOverflowId holds the latest
+     *        buffer from any address past the table
      */
-    std::vector<float> getLatestAudioData();
+    std::vector<float> getLatestAudioData(uint32_t channel);
+
+    /**
+     * Get the channel table (address per id and per-channel statistics)
+     */
+    const AddressTable& getChannels() const { return channels_; }
 
     /**
      * Check if receiver is running
@@ -62,48 +169,71 @@ public:
     uint64_t getMessageCount() const { return message_count_; }
 
 private:
+    bool startEventLoop();
     void receiveLoop();
-    void parseOSCMessage(const std::string& data);
+    void applyThreadConfig(const char* name, int cpu_offset);
+    void receiveLoopBlocking();
+    bool receiveLoopUring();
+    void receiveLoopBusyPoll();
+    ssize_t receivePacket(char* buffer, size_t size, int flags, uint64_t& arrival_ns, uint64_t& source);
+    void handlePacket(const char* data, size_t length, uint64_t arrival_ns, uint64_t source);
+    void handleBundle(const char* data, size_t length, uint64_t arrival_ns, uint64_t source, int depth);
+    void parseOSCMessage(const std::string& data, uint64_t arrival_ns, uint64_t source);
+    ClockOffsetEstimator* clockOffsetFor(uint64_t source);
 
     int port_;
     int socket_fd_;
     std::atomic<bool> running_;
     std::thread receive_thread_;
+    ReceiveBackend backend_;
+    std::atomic<ReceiveBackend> active_backend_;
+    std::vector<ListenerConfig> extra_listeners_;
+    int loop_threads_;
+    std::unique_ptr<EventLoop> event_loop_;
+    int busy_poll_cpu_;
+    int busy_poll_spin_us_;
+    media_pipeline::ThreadConfig thread_config_;
+
+    LatencyHistogram latency_histogram_;
+    std::atomic<uint64_t> spin_wakes_;     // Packets found while spinning
+    std::atomic<uint64_t> blocked_wakes_;  // Packets found after backing off to poll()
+
+    bool bundle_scheduling_;
+    BundleScheduler bundle_scheduler_;
+    std::atomic<uint64_t> late_bundles_;       // Timetag already passed on arrival
+    std::atomic<uint64_t> malformed_bundles_;
+
+    // Sender clocks differ, so each source gets its own estimate; capped so
+    // spoofed sources cannot grow the map without bound
+    static constexpr size_t kMaxClockSources = 64;
+    mutable std::mutex clock_mutex_;
+    std::map<uint64_t, std::unique_ptr<ClockOffsetEstimator>> clock_offsets_;  // By source
 
     AudioCallback audio_callback_;
+    std::vector<AudioTap> audio_taps_;
     TextCallback text_callback_;
     AnalysisCallback analysis_callback_;
-    std::mutex data_mutex_;
-    std::queue<std::vector<float>> audio_queue_;
-    std::vector<float> latest_audio_;
+    ControlCallback control_callback_;
 
-    std::atomic<uint64_t> message_count_;
-};
+    // Addresses interned as channel ids; everything per channel is indexed by
+    // id, and the event loop may parse on several threads at once
+    AddressTable channels_;
 
-/**
- * Multi-type OSC message parser for TouchDesigner-style channels
- */
-class OSCParser {
-public:
-    enum MessageType {
-        AUDIO,
-        TEXT,
-        ANALYSIS,
-        UNKNOWN
+    // Quantized analysis vectors: one delta reference per channel (none for the overflow id)
+    struct alignas(64) FeatureChannel {
+        std::mutex mutex;
+        media_pipeline::feature_codec::Decoder decoder;
     };
+    std::unique_ptr<FeatureChannel[]> feature_channels_;
 
-    struct OSCMessage {
-        std::string address;
-        MessageType type;
-        std::vector<float> floatData;
-        std::string textData;
-        bool valid;
+    // Latest audio buffer per channel, so streams parsed on different threads do not share a lock
+    struct alignas(64) LatestAudio {
+        std::mutex mutex;
+        std::vector<float> samples;
     };
+    std::unique_ptr<LatestAudio[]> latest_audio_;
+    std::atomic<uint64_t> features_decoded_;
+    std::atomic<uint64_t> features_skipped_;   // Delta frames without a reference (lost packets)
 
-    static OSCMessage parseMessage(const std::string& data);
-    static MessageType getMessageType(const std::string& address);
-
-private:
-    static bool parseFloatArray(const std::string& data, std::vector<float>& samples);
-    static bool parseTextMessage(const std::string& data, std::string& text);
-};
\ No newline at end of file
+    std::atomic<uint64_t> message_count_;
+};
@@ -0,0 +1,55 @@
+#include "rx_timestamp.h"
+
+namespace rx_timestamp {
+
+bool enable(int socket_fd) {
+    int on = 1;
+#ifdef SO_TIMESTAMPNS
+    if (setsockopt(socket_fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) == 0) {
+        return true;
+    }
+#endif
+#ifdef SO_TIMESTAMP
+    if (setsockopt(socket_fd, SOL_SOCKET, SO_TIMESTAMP, &on, sizeof(on)) == 0) {
+        return true;
+    }
+#endif
+    (void)socket_fd;
+    (void)on;
+    return false;
+}
+
+uint64_t extract(const struct msghdr* msg) {
+    if (!msg || !msg->msg_control || msg->msg_controllen == 0) {
+        return 0;
+    }
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(const_cast<struct msghdr*>(msg)); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(msg), cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+#ifdef SCM_TIMESTAMPNS
+        if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            const auto* ts = reinterpret_cast<const struct timespec*>(CMSG_DATA(cmsg));
+            return static_cast<uint64_t>(ts->tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts->tv_nsec);
+        }
+#endif
+#ifdef SCM_TIMESTAMP
+        if (cmsg->cmsg_type == SCM_TIMESTAMP) {
+            const auto* tv = reinterpret_cast<const struct timeval*>(CMSG_DATA(cmsg));
+            return static_cast<uint64_t>(tv->tv_sec) * 1000000000ULL + static_cast<uint64_t>(tv->tv_usec) * 1000ULL;
+        }
+#endif
+    }
+
+    return 0;
+}
+
+uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+} // namespace rx_timestamp
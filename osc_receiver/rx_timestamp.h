@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+
+/**
+ * Kernel receive timestamps
+ * SO_TIMESTAMPNS (Linux) or SO_TIMESTAMP (elsewhere) makes the kernel attach
+ * the packet arrival time to every datagram as a control message, so latency
+ * and jitter are measured from the wire rather than from when the receive
+ * thread got scheduled. All values are CLOCK_REALTIME nanoseconds.
+ */
+namespace rx_timestamp {
+
+/** Control buffer size needed by recvmsg() to receive the timestamp */
+constexpr size_t kControlSize = CMSG_SPACE(sizeof(struct timespec)) > CMSG_SPACE(sizeof(struct timeval))
+                                    ? CMSG_SPACE(sizeof(struct timespec))
+                                    : CMSG_SPACE(sizeof(struct timeval));
+
+/**
+ * Ask the kernel to timestamp incoming packets on this socket
+ * @return false if the platform has neither timestamp option
+ */
+bool enable(int socket_fd);
+
+/**
+ * Get the arrival time from a received message's control data
+ * @return 0 if no timestamp was attached
+ */
+uint64_t extract(const struct msghdr* msg);
+
+/**
+ * Current CLOCK_REALTIME in nanoseconds (fallback arrival time)
+ */
+uint64_t nowNs();
+
+} // namespace rx_timestamp
@@ -0,0 +1,57 @@
+#include "spectrum_service.h"
+#include "media_pipeline/osc_sender.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+SpectrumService::SpectrumService(int sample_rate, const media_pipeline::SpectrumAnalyzer::Config& config,
+                                 size_t queue_capacity)
+    : StreamWorker("spectrum", queue_capacity)
+    , sample_rate_(sample_rate)
+    , config_(config)
+    , osc_port_(0)
+    , osc_bits_(8)
+    , analyzers_(AddressTable::kMaxChannels)
+    , frames_(0)
+    , streams_(0) {
+    config_.bands = std::min(std::max<size_t>(config_.bands, 1), kMaxBands);
+}
+
+SpectrumService::~SpectrumService() {
+    stop();
+}
+
+void SpectrumService::setOscOutput(const std::string& host, int port, int bits) {
+    osc_host_ = host;
+    osc_port_ = port;
+    osc_bits_ = bits;
+}
+
+void SpectrumService::onStart() {
+    if (!osc_ && !osc_host_.empty() && osc_port_ > 0) {
+        osc_.reset(new media_pipeline::OSCSender(osc_host_, osc_port_));
+        // A keyframe a second bounds how long a client that joins or loses a packet waits
+        osc_->setFeatureEncoding(osc_bits_, std::max(1, static_cast<int>(std::lround(config_.frame_rate))));
+    }
+}
+
+void SpectrumService::analyze(uint32_t stream, const std::vector<float>& samples) {
+    auto& analyzer = analyzers_[stream];
+    if (!analyzer) {
+        analyzer.reset(new media_pipeline::SpectrumAnalyzer(sample_rate_, config_));
+        streams_.fetch_add(1, std::memory_order_relaxed);
+    }
+    const size_t frames = analyzer->process(samples.data(), samples.size(),
+        [&](const float* levels, const float* peaks, size_t bands) {
+            if (!osc_) {
+                return;
+            }
+            const std::string address = "/analysis/spectrum/" + std::to_string(stream);
+            message_.resize(bands * 2);
+            std::memcpy(message_.data(), levels, bands * sizeof(float));
+            std::memcpy(message_.data() + bands, peaks, bands * sizeof(float));
+            osc_->sendFeatures(address, message_.data(), message_.size());
+        });
+    frames_.fetch_add(frames, std::memory_order_relaxed);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "stream_worker.h"
+#include "media_pipeline/spectrum_analyzer.h"
+
+namespace media_pipeline {
+class OSCSender;
+}
+
+/**
+ * Log-frequency spectrum of every received audio stream, for visualization clients
+ *
+ * A StreamWorker running one SpectrumAnalyzer per stream address. Each
+ * frame (config.frame_rate per second of the stream's audio) is sent as
+ *   /analysis/spectrum/<stream> <levels...> <peaks...>
+ * (dB, bands values each; stream is the StreamWorker id of the stream
+ * address) in the compact quantized encoding of feature_codec.h: 8-bit
+ * deltas against a keyframe sent once a second, a few bytes per band.
+ */
+class SpectrumService : public StreamWorker {
+public:
+    static constexpr size_t kMaxBands = 128;  // Levels and peaks within one feature vector
+
+    /**
+     * @param config Analyzer settings for every stream; bands capped at kMaxBands
+     */
+    SpectrumService(int sample_rate, const media_pipeline::SpectrumAnalyzer::Config& config,
+                    size_t queue_capacity = 256);
+    ~SpectrumService() override;
+
+    /**
+     * Send frames over OSC (before start())
+     * @param bits 8 or 16 for quantized vectors, 0 for plain floats
+     */
+    void setOscOutput(const std::string& host, int port, int bits = 8);
+
+    const media_pipeline::SpectrumAnalyzer::Config& getConfig() const { return config_; }
+    uint64_t getFrameCount() const { return frames_.load(std::memory_order_relaxed); }
+    size_t getStreamCount() const { return streams_.load(std::memory_order_relaxed); }
+
+protected:
+    void onStart() override;
+    void analyze(uint32_t stream, const std::vector<float>& samples) override;
+
+private:
+    int sample_rate_;
+    media_pipeline::SpectrumAnalyzer::Config config_;
+    std::string osc_host_;
+    int osc_port_;
+    int osc_bits_;
+
+    // Worker thread only; by stream id, an analyzer created on the stream's first buffer
+    std::vector<std::unique_ptr<media_pipeline::SpectrumAnalyzer>> analyzers_;
+    std::unique_ptr<media_pipeline::OSCSender> osc_;
+    std::vector<float> message_;              // Levels then peaks
+
+    std::atomic<uint64_t> frames_;
+    std::atomic<size_t> streams_;
+};
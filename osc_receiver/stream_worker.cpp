@@ -0,0 +1,108 @@
+#include "stream_worker.h"
+#include "media_pipeline/osc_message.h"
+#include "media_pipeline/trace.h"
+
+#include <algorithm>
+
+StreamWorker::StreamWorker(const char* thread_name, size_t queue_capacity)
+    : thread_name_(thread_name)
+    , queue_capacity_(std::max<size_t>(queue_capacity, 1))
+    , channel_streams_(AddressTable::kMaxChannels, kNoStream)
+    , busy_(false)
+    , stop_(false)
+    , dropped_(0) {
+    queue_.reserve(queue_capacity_);
+    work_.reserve(queue_capacity_);
+}
+
+StreamWorker::~StreamWorker() {
+    stop();
+}
+
+bool StreamWorker::start() {
+    if (worker_.joinable()) {
+        return false;
+    }
+    stop_ = false;
+    worker_ = std::thread(&StreamWorker::workerLoop, this);
+    return true;
+}
+
+void StreamWorker::stop() {
+    if (!worker_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stop_ = true;
+    }
+    queue_wake_.notify_one();
+    worker_.join();
+}
+
+void StreamWorker::submit(uint32_t channel, const std::string& address, Samples samples) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        // Streams past the table would share one analyzer, so theirs are dropped
+        const uint32_t stream = streamOf(channel, address);
+        if (queue_.size() >= queue_capacity_ || stream == AddressTable::kOverflowId) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        queue_.push_back(Pending{stream, std::move(samples)});
+    }
+    queue_wake_.notify_one();
+}
+
+void StreamWorker::flush() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    queue_idle_.wait(lock, [this] { return (queue_.empty() && !busy_) || stop_; });
+}
+
+std::string StreamWorker::getAddress(uint32_t stream) const {
+    return stream < streams_.size() ? streams_.getAddress(stream) : std::string();
+}
+
+// Under queue_mutex_. The receiver's overflow id stands for many addresses,
+// so it is never cached.
+uint32_t StreamWorker::streamOf(uint32_t channel, const std::string& address) {
+    const bool cached = channel < AddressTable::kOverflowId;
+    if (cached && channel_streams_[channel] != kNoStream) {
+        return channel_streams_[channel];
+    }
+    const uint32_t stream = streams_.intern(media_pipeline::OSCParser::streamAddress(address));
+    if (cached) {
+        channel_streams_[channel] = stream;
+    }
+    return stream;
+}
+
+void StreamWorker::workerLoop() {
+    media_pipeline::applyThreadConfig(thread_config_, thread_name_);
+    onStart();
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while (true) {
+        queue_wake_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (stop_) {
+            break;
+        }
+        // Swapped, not copied: both vectors keep their capacity
+        work_.swap(queue_);
+        busy_ = true;
+        lock.unlock();
+
+        MP_TRACE_SCOPE("StreamWorker::analyze");
+        for (const Pending& pending : work_) {
+            analyze(pending.stream, *pending.samples);
+        }
+        work_.clear();  // Last reference to a buffer frees it here, off the receive threads
+
+        lock.lock();
+        busy_ = false;
+        if (queue_.empty()) {
+            queue_idle_.notify_all();
+        }
+    }
+    busy_ = false;
+    queue_idle_.notify_all();
+}
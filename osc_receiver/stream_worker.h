@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "address_table.h"
+#include "media_pipeline/thread_config.h"
+
+/**
+ * Worker thread that analyzes received audio streams off the receive path
+ *
+ * Receive threads submit the buffers OSCReceiver's audio taps share out
+ * (read-only, so any number of workers hold the same samples and nothing is
+ * copied) and return after one queue push; the worker hands each buffer to
+ * analyze() in arrival order. Past queue_capacity waiting buffers, new ones
+ * are dropped and counted rather than queued.
+ *
+ * Buffers are analyzed per stream, not per address: the chunks a sender
+ * splits a block into ("<address>_0", "<address>_1", ...) share one stream
+ * id, interned from OSCParser::streamAddress(). Stream ids are dense and
+ * below AddressTable::kMaxChannels, so subclasses keep per-stream state in
+ * arrays of that size. Subclasses stop() in their destructor, before their
+ * own members go.
+ */
+class StreamWorker {
+public:
+    using Samples = std::shared_ptr<const std::vector<float>>;
+
+    StreamWorker(const char* thread_name, size_t queue_capacity);
+    virtual ~StreamWorker();
+
+    StreamWorker(const StreamWorker&) = delete;
+    StreamWorker& operator=(const StreamWorker&) = delete;
+
+    /**
+     * Set scheduling for the worker (before start()); it should rank below the receive threads
+     */
+    void setThreadConfig(const media_pipeline::ThreadConfig& config) { thread_config_ = config; }
+
+    bool start();
+    void stop();
+
+    /**
+     * Queue one buffer of a stream (any thread)
+     * @param channel The receiver's id for address, which caches its stream
+     */
+    void submit(uint32_t channel, const std::string& address, Samples samples);
+
+    /**
+     * Block until every buffer submitted so far has been analyzed (while running)
+     */
+    void flush();
+
+    /**
+     * Get the address of a stream id (empty if unused)
+     */
+    std::string getAddress(uint32_t stream) const;
+
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+protected:
+    /**
+     * Called on the worker before the first buffer
+     */
+    virtual void onStart() {}
+
+    /**
+     * Analyze one buffer of a stream (worker thread)
+     */
+    virtual void analyze(uint32_t stream, const std::vector<float>& samples) = 0;
+
+private:
+    static constexpr uint32_t kNoStream = UINT32_MAX;
+
+    struct Pending {
+        uint32_t stream;
+        Samples samples;
+    };
+
+    uint32_t streamOf(uint32_t channel, const std::string& address);
+    void workerLoop();
+
+    const char* thread_name_;
+    size_t queue_capacity_;
+    media_pipeline::ThreadConfig thread_config_;
+
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_wake_;
+    std::condition_variable queue_idle_;
+    std::vector<Pending> queue_;
+    std::vector<uint32_t> channel_streams_;  // By receiver channel, under queue_mutex_
+    AddressTable streams_;                   // Stream addresses, interned under queue_mutex_
+    bool busy_;
+    bool stop_;
+    std::atomic<uint64_t> dropped_;
+
+    std::thread worker_;
+    std::vector<Pending> work_;  // Worker thread only
+};
@@ -0,0 +1,117 @@
+#include "test_framework.h"
+#include "address_table.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+TEST(address_table_intern) {
+    AddressTable table;
+    uint32_t audio = table.intern("/chan1/audio");
+    uint32_t text = table.intern("/chan2/text");
+    CHECK(audio != text);
+    CHECK_EQ(table.intern("/chan1/audio"), audio);
+    CHECK_EQ(table.intern(std::string("/chan1/audio/0")), 2u);  // Prefixes are distinct addresses
+    CHECK_EQ(table.size(), 3u);
+    CHECK_EQ(table.getAddress(text), std::string("/chan2/text"));
+
+    // Lookups never assign an id
+    CHECK_EQ(table.find("/chan2/text"), text);
+    CHECK_EQ(table.find("/chan3/analysis"), AddressTable::kOverflowId);
+    CHECK_EQ(table.size(), 3u);
+}
+
+TEST(address_table_overflow) {
+    AddressTable table;
+    for (uint32_t i = 0; i < AddressTable::kMaxChannels + 100; ++i) {
+        uint32_t id = table.intern("/spray/" + std::to_string(i));
+        CHECK_EQ(id, std::min(i, AddressTable::kOverflowId));
+    }
+    CHECK_EQ(table.size(), AddressTable::kOverflowId);
+    CHECK_EQ(table.getAddress(AddressTable::kOverflowId), std::string("(other)"));
+
+    // Addresses interned before the table filled keep their ids
+    CHECK_EQ(table.intern("/spray/17"), 17u);
+}
+
+TEST(address_table_full_misses) {
+    AddressTable table;
+    for (uint32_t i = 0; i < AddressTable::kOverflowId; ++i) {
+        table.intern("/known/" + std::to_string(i));
+    }
+    CHECK_EQ(table.size(), AddressTable::kOverflowId);
+
+    // Misses on a full table race known lookups without assigning anything
+    const int kThreads = 4;
+    const int kLookups = 20000;
+    std::vector<int> wrong(kThreads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kLookups; ++i) {
+                uint32_t known = static_cast<uint32_t>(i) % AddressTable::kOverflowId;
+                wrong[t] += table.intern("/junk/" + std::to_string(t) + "/" + std::to_string(i)) !=
+                            AddressTable::kOverflowId;
+                wrong[t] += table.intern("/known/" + std::to_string(known)) != known;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int count : wrong) {
+        CHECK_EQ(count, 0);
+    }
+    CHECK_EQ(table.size(), AddressTable::kOverflowId);
+    CHECK_EQ(table.find("/junk/0/0"), AddressTable::kOverflowId);
+}
+
+TEST(address_table_concurrent_intern) {
+    const int kThreads = 4;
+    const int kAddresses = 600;
+    const int kRounds = 20 * media_pipeline::test::stressScale();
+
+    std::vector<std::string> addresses;
+    for (int i = 0; i < kAddresses; ++i) {
+        addresses.push_back("/chan" + std::to_string(i % 7) + "/features/" + std::to_string(i));
+    }
+
+    // Every thread interns every address in its own order, racing on first sight
+    AddressTable table;
+    std::vector<std::vector<uint32_t>> ids(kThreads, std::vector<uint32_t>(kAddresses));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            std::vector<int> order(kAddresses);
+            for (int i = 0; i < kAddresses; ++i) {
+                order[i] = i;
+            }
+            for (int round = 0; round < kRounds; ++round) {
+                std::shuffle(order.begin(), order.end(), rng);
+                for (int i : order) {
+                    uint32_t id = table.intern(addresses[i]);
+                    table.stats(id).messages.fetch_add(1, std::memory_order_relaxed);
+                    ids[t][i] = id;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    CHECK_EQ(table.size(), static_cast<uint32_t>(kAddresses));
+    std::vector<bool> used(kAddresses, false);
+    for (int i = 0; i < kAddresses; ++i) {
+        uint32_t id = ids[0][i];
+        CHECK(id < static_cast<uint32_t>(kAddresses) && !used[id]);
+        used[id] = true;
+        for (int t = 1; t < kThreads; ++t) {
+            CHECK_EQ(ids[t][i], id);
+        }
+        CHECK_EQ(table.getAddress(id), addresses[i]);
+        CHECK_EQ(table.stats(id).messages.load(), static_cast<uint64_t>(kThreads) * kRounds);
+    }
+}
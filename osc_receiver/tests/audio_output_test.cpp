@@ -0,0 +1,344 @@
+#include "test_framework.h"
+#include "audio_output.h"
+#include "media_pipeline/wav_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <thread>
+
+// AudioOutput is driven through processAudio() as the PortAudio callback
+// would, so none of this needs an audio device
+
+namespace {
+
+// Plugin node compiled in: scales by its "scale" parameter, in place
+struct ScaleNode {
+    float scale = -1.0f;
+};
+
+const mp_plugin_param kScaleParams[] = {{"scale", -4.0f, 4.0f, -1.0f}};
+
+const mp_plugin_descriptor kScaleNode = {
+    MP_PLUGIN_ABI_VERSION, sizeof(mp_plugin_descriptor), "test.scale", "Scale", MP_PLUGIN_IN_PLACE, 0, 1, 1,
+    kScaleParams,
+    [](const mp_plugin_config*) { return reinterpret_cast<mp_plugin_instance*>(new ScaleNode()); },
+    [](mp_plugin_instance* instance) { delete reinterpret_cast<ScaleNode*>(instance); },
+    [](mp_plugin_instance* instance, const mp_plugin_block* block) {
+        const float scale = reinterpret_cast<ScaleNode*>(instance)->scale;
+        for (uint32_t i = 0; i < block->frames; ++i) {
+            block->outputs[0][i] = block->inputs[0][i] * scale;
+        }
+    },
+    [](mp_plugin_instance* instance, uint32_t, float value) { reinterpret_cast<ScaleNode*>(instance)->scale = value; },
+    nullptr,
+};
+
+} // namespace
+
+TEST(audio_output_fill_and_volume) {
+    AudioOutput output(48000, 256);
+    std::vector<float> block(256);
+
+    // Silence until something is queued
+    output.processAudio(block.data(), block.size());
+    for (float sample : block) {
+        CHECK_EQ(sample, 0.0f);
+    }
+
+    // Short buffer: default volume 0.5, then silence where the queue runs dry
+    output.addAudioData(std::vector<float>(100, 1.0f));
+    output.processAudio(block.data(), block.size());
+    for (size_t i = 0; i < block.size(); ++i) {
+        CHECK_EQ(block[i], i < 100 ? 0.5f : 0.0f);
+    }
+
+    // A volume change ramps across one block instead of stepping
+    output.setVolume(4.0f);
+    CHECK_EQ(output.getVolume(), 1.0f);
+    output.addAudioData(std::vector<float>(512, 1.0f));
+    output.processAudio(block.data(), block.size());
+    for (size_t i = 1; i < block.size(); ++i) {
+        CHECK(block[i] >= block[i - 1]);
+    }
+    CHECK(block[0] >= 0.5f && block[0] < 0.6f);
+    CHECK(block[255] > 0.99f);
+    output.processAudio(block.data(), block.size());
+    for (float sample : block) {
+        CHECK_EQ(sample, 1.0f);
+    }
+}
+
+TEST(audio_output_glitch_events) {
+    using media_pipeline::GlitchDetector;
+    const int sample_rate = 48000;
+    AudioOutput output(sample_rate, 256);
+    std::vector<float> block(256);
+
+    // Three packets of a continuous tone, then a fourth that skips ahead
+    auto tone = [&](size_t offset, size_t count) {
+        std::vector<float> samples(count);
+        for (size_t i = 0; i < count; ++i) {
+            samples[i] = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * 440.0 * (offset + i) / sample_rate));
+        }
+        return samples;
+    };
+    output.addAudioData(tone(0, 256));
+    output.addAudioData(tone(256, 256));
+    output.addAudioData(tone(512, 256));
+    output.addAudioData(tone(868, 256));
+    for (int b = 0; b < 4; ++b) {
+        output.processAudio(block.data(), block.size());
+    }
+
+    // Starve for two blocks, then resume
+    output.processAudio(block.data(), block.size());
+    output.processAudio(block.data(), block.size());
+    output.addAudioData(tone(1124, 256));
+    output.processAudio(block.data(), block.size());
+
+    GlitchDetector& detector = output.getGlitchDetector();
+    GlitchDetector::Event event;
+    CHECK(detector.popEvent(event));
+    CHECK(event.type == GlitchDetector::Type::DISCONTINUITY);
+    CHECK_EQ(event.position, 768u);
+    CHECK_EQ(event.first_packet, 4u);
+    CHECK(event.timestamp_ns > 0);
+
+    CHECK(detector.popEvent(event));
+    CHECK(event.type == GlitchDetector::Type::UNDERRUN);
+    CHECK_EQ(event.position, 1024u);
+    CHECK_EQ(event.length, 512u);
+    CHECK_EQ(event.first_packet, 4u);
+    CHECK_EQ(event.last_packet, 5u);
+    CHECK(!detector.popEvent(event));
+    CHECK_EQ(output.getOverflowCount(), 0u);
+}
+
+TEST(audio_output_impulse_response) {
+    // Direct sound and an echo 10000 samples later, past the head partitions
+    media_pipeline::WavData wav;
+    wav.sample_rate = 48000;
+    wav.channels = 1;
+    wav.samples.assign(10001, 0.0f);
+    wav.samples[0] = 1.0f;
+    wav.samples[10000] = 0.5f;
+    const std::string path = "/tmp/osc_receiver_ir_test.wav";
+    std::string error;
+    CHECK(media_pipeline::writeWavFile(path, wav, media_pipeline::WavData::Format::FLOAT32, error));
+
+    AudioOutput output(48000, 256);
+    CHECK(!output.loadImpulseResponse("/nonexistent.wav", media_pipeline::ThreadConfig(), error));
+    CHECK(output.loadImpulseResponse(path, media_pipeline::ThreadConfig(), error));
+    std::remove(path.c_str());
+    CHECK_EQ(output.getConvolver()->getLength(), 10001u);
+
+    std::vector<float> click(256, 0.0f);
+    click[3] = 1.0f;
+    output.addAudioData(click);
+
+    // The echo rings on after the queue runs dry
+    std::vector<float> played;
+    std::vector<float> block(256);
+    for (int b = 0; b < 48; ++b) {
+        output.processAudio(block.data(), block.size());
+        played.insert(played.end(), block.begin(), block.end());
+        const auto* convolver = output.getConvolver();
+        while (convolver->getStats().tail_blocks_completed < convolver->getStats().tail_blocks_submitted) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    for (size_t i = 0; i < played.size(); ++i) {
+        const float expected = i == 3 ? 0.5f : i == 10003 ? 0.25f : 0.0f;  // Default volume 0.5
+        CHECK_NEAR(played[i], expected, 1e-5);
+    }
+    CHECK_EQ(output.getConvolver()->getStats().tail_blocks_late, 0u);
+}
+
+TEST(audio_output_equalizer) {
+    EqualizerBand band;
+    CHECK(!EqualizerBand::parse("peaking:1000", band));
+    CHECK(!EqualizerBand::parse("wobble:1000:1", band));
+    CHECK(EqualizerBand::parse("notch:1000:4", band));
+    CHECK(band.type == media_pipeline::BiquadCoefficients::Type::NOTCH);
+    CHECK(EqualizerBand::parse("lowshelf:200:0.7:-3.5", band));
+    CHECK_EQ(band.gain_db, -3.5);
+
+    // A notch on the tone, which retuning moves away while it plays
+    AudioOutput output(48000, 256);
+    output.setVolume(1.0f);
+    CHECK(!output.setEqualizerBand(0, band));
+    EqualizerBand notch;
+    CHECK(EqualizerBand::parse("notch:1000:2", notch));
+    output.setEqualizer({notch});
+
+    std::vector<float> tone(256);
+    std::vector<float> block(256);
+    size_t position = 0;
+    auto play = [&](int blocks) {
+        double level = 0.0;
+        for (int b = 0; b < blocks; ++b) {
+            for (float& sample : tone) {
+                sample = static_cast<float>(std::sin(2.0 * M_PI * 1000.0 * position++ / 48000.0));
+            }
+            output.addAudioData(tone);
+            output.processAudio(block.data(), block.size());
+            for (float sample : block) {
+                level = std::max(level, static_cast<double>(std::fabs(sample)));
+            }
+        }
+        return level;
+    };
+    play(40);
+    CHECK(play(8) < 0.01);
+
+    notch.frequency = 4000.0;
+    CHECK(output.setEqualizerBand(0, notch, 20.0));
+    CHECK_EQ(output.getEqualizer()[0].frequency, 4000.0);
+    play(20);
+    CHECK(play(8) > 0.95);
+}
+
+TEST(audio_output_spatial_streams) {
+    using media_pipeline::SpatialRenderer;
+    media_pipeline::SpeakerLayout stereo;
+    CHECK(media_pipeline::SpeakerLayout::parse("stereo", stereo));
+    SpatialRenderer::Config config;
+    config.max_sources = 2;
+    std::string error;
+
+    AudioOutput output(48000, 256);
+    output.setVolume(1.0f);
+    CHECK(!output.setSpatialRenderer(SpatialRenderer::createPanner(48000, stereo, config, error), error));
+    config.block_size = 256;
+    CHECK(output.setSpatialRenderer(SpatialRenderer::createPanner(48000, stereo, config, error), error));
+    CHECK_EQ(output.getOutputChannels(), 2u);
+    CHECK(!output.loadImpulseResponse("/nonexistent.wav", media_pipeline::ThreadConfig(), error));
+
+    // One stream placed left and sent in chunks, one placed right after its
+    // first buffer; a third finds no free source. The last two share the
+    // address table's overflow id, which must not route one into the other
+    CHECK(output.setStreamPosition("/audio/left", 30.0f));
+    for (uint32_t chunk = 0; chunk < 4; ++chunk) {
+        output.addStreamAudio(10 + chunk, "/audio/left_" + std::to_string(chunk), std::vector<float>(128, 1.0f));
+    }
+    output.addStreamAudio(AddressTable::kOverflowId, "/audio/right", std::vector<float>(512, 0.5f));
+    CHECK(output.setStreamPosition("/audio/right", -30.0f));
+    output.addStreamAudio(AddressTable::kOverflowId, "/audio/extra", std::vector<float>(256, 1.0f));
+    CHECK_EQ(output.getUnplacedCount(), 1u);
+
+    // Gains fade in over the first block, then each stream is on its own speaker
+    std::vector<float> block(256 * 2);
+    output.processAudio(block.data(), 256);
+    output.processAudio(block.data(), 256);
+    for (size_t i = 0; i < 256; ++i) {
+        CHECK_NEAR(block[2 * i], 1.0, 1e-6);
+        CHECK_NEAR(block[2 * i + 1], 0.5, 1e-6);
+    }
+
+    const auto positions = output.getStreamPositions();
+    CHECK_EQ(positions.size(), 2u);
+    CHECK(positions[0].stream == "/audio/left");
+    CHECK_EQ(positions[1].azimuth_deg, -30.0f);
+    CHECK(!output.setStreamPosition("/audio/extra", 0.0f));
+
+    // Glitches are counted per stream, before the mix: the left stream sat at
+    // full scale, and only it resumes after both ran dry
+    output.processAudio(block.data(), 256);
+    output.addStreamAudio(10, "/audio/left_0", std::vector<float>(256, 0.5f));
+    output.processAudio(block.data(), 256);
+    using media_pipeline::GlitchDetector;
+    GlitchDetector::Event event;
+    CHECK(output.getStreamGlitchDetector(0)->popEvent(event));
+    CHECK(event.type == GlitchDetector::Type::CLIPPING);
+    CHECK(output.getStreamGlitchDetector(0)->popEvent(event));
+    CHECK(event.type == GlitchDetector::Type::UNDERRUN);
+    CHECK_EQ(event.position, 512u);
+    CHECK_EQ(event.length, 256u);
+    CHECK(!output.getStreamGlitchDetector(1)->popEvent(event));
+    CHECK(output.getStreamGlitchDetector(2) == nullptr);
+    CHECK_EQ(output.getGlitchCount(), 2u);
+    CHECK_EQ(output.getGlitchDetector().getTotalCount(), 0u);
+}
+
+TEST(audio_output_plugins) {
+    media_pipeline::PluginHost host;
+    std::string error;
+    CHECK(host.add(&kScaleNode, error));
+    AudioOutput output(48000, 256);
+    CHECK(!output.addPlugin(host.createNode("test.scale", 48000, 2, 256, error), error));
+    CHECK(output.addPlugin(host.createNode("test.scale", 48000, 1, 128, error), error));
+    CHECK(output.getPlugin("test.missing") == nullptr);
+
+    // After the queue and before the volume (0.5)
+    std::vector<float> block(256);
+    output.addAudioData(std::vector<float>(256, 1.0f));
+    output.processAudio(block.data(), block.size());
+    for (float sample : block) {
+        CHECK_EQ(sample, -0.5f);
+    }
+    CHECK(output.getPlugin("test.scale")->setParameter("scale", 2.0f));
+    output.addAudioData(std::vector<float>(256, 1.0f));
+    output.processAudio(block.data(), block.size());
+    for (float sample : block) {
+        CHECK_EQ(sample, 1.0f);
+    }
+}
+
+TEST(audio_output_concurrent_producer) {
+    const int kBuffers = 5000 * media_pipeline::test::stressScale();
+
+    // Samples carry a running counter from 1, so the output shows exactly what
+    // was played and in which order
+    AudioOutput output(48000, 256);
+    std::set<uint32_t> buffer_starts;
+    std::atomic<bool> producing{true};
+    std::thread producer([&] {
+        std::mt19937 rng(21);
+        uint32_t counter = 1;
+        std::vector<float> samples;
+        for (int b = 0; b < kBuffers; ++b) {
+            samples.resize(32 + rng() % 269);
+            buffer_starts.insert(counter);
+            for (float& sample : samples) {
+                sample = static_cast<float>(counter++);
+            }
+            output.addAudioData(samples);
+            if (b % 8 == 0) {
+                std::this_thread::yield();
+            }
+        }
+        producing = false;
+    });
+
+    std::vector<float> played;
+    std::vector<float> block(256);
+    int idle_blocks = 0;
+    while (producing || idle_blocks < 2) {
+        output.processAudio(block.data(), block.size());
+        bool idle = true;
+        for (float sample : block) {
+            if (sample != 0.0f) {
+                played.push_back(sample * 2.0f);  // Undo the default volume
+                idle = false;
+            }
+        }
+        idle_blocks = (idle && !producing) ? idle_blocks + 1 : 0;
+    }
+    producer.join();
+
+    // Strictly increasing; the queue drops whole buffers when it overflows, so
+    // any jump must land on the start of a buffer
+    CHECK(!played.empty());
+    CHECK(buffer_starts.count(static_cast<uint32_t>(played[0])));
+    for (size_t i = 1; i < played.size(); ++i) {
+        CHECK(played[i] > played[i - 1]);
+        if (played[i] != played[i - 1] + 1.0f) {
+            CHECK(buffer_starts.count(static_cast<uint32_t>(played[i])));
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#include "test_framework.h"
+#include "bundle_scheduler.h"
+#include "rx_timestamp.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <thread>
+
+namespace {
+
+struct Tagged {
+    uint64_t deadline_ns;
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+bool waitFor(const std::function<bool()>& done, int timeout_ms) {
+    auto limit = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > limit) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(bundle_scheduler_concurrent_schedule) {
+    const int kProducers = 4;
+    const uint32_t kPackets = 2000 * media_pipeline::test::stressScale();
+
+    // Short wheel (6.4 ms horizon) so most deadlines pass through the overflow list
+    BundleScheduler scheduler(100000, 64, 1 << 20);
+    std::vector<Tagged> dispatched;
+    std::vector<uint64_t> dispatch_times;
+    std::atomic<uint64_t> dispatch_count{0};
+    std::atomic<bool> mislabeled{false};
+    scheduler.start([&](const std::string& packet, uint64_t, uint64_t source, int depth) {
+        uint64_t now_ns = rx_timestamp::nowNs();
+        Tagged tagged;
+        std::memcpy(&tagged, packet.data(), sizeof(tagged));
+        if (source != tagged.producer || depth != static_cast<int>(tagged.sequence % 8)) {
+            mislabeled = true;
+        }
+        dispatched.push_back(tagged);
+        dispatch_times.push_back(now_ns);
+        dispatch_count.fetch_add(1, std::memory_order_release);
+    });
+
+    std::atomic<uint64_t> refused{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            std::mt19937 rng(p);
+            for (uint32_t s = 0; s < kPackets; ++s) {
+                // Mostly future deadlines up to 50 ms out, some already past
+                int64_t offset_us = static_cast<int64_t>(rng() % 50000) - 5000;
+                Tagged tagged{rx_timestamp::nowNs() + offset_us * 1000, static_cast<uint32_t>(p), s};
+                if (!scheduler.schedule(tagged.deadline_ns, reinterpret_cast<const char*>(&tagged),
+                                        sizeof(tagged), 0, static_cast<uint64_t>(p), static_cast<int>(s % 8))) {
+                    refused.fetch_add(1);
+                }
+                if (s % 32 == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    const uint64_t total = static_cast<uint64_t>(kProducers) * kPackets;
+    CHECK_EQ(refused.load(), 0u);
+    CHECK(waitFor([&] { return dispatch_count.load(std::memory_order_acquire) == total; }, 10000));
+    scheduler.stop();
+
+    CHECK_EQ(scheduler.getScheduledCount(), total);
+    CHECK_EQ(scheduler.getDroppedCount(), 0u);
+    CHECK_EQ(scheduler.getPendingCount(), 0u);
+    CHECK_EQ(scheduler.getLatenessHistogram().getCount(), total);
+    CHECK(!mislabeled);  // Source and depth travel with their packet
+
+    // Each packet exactly once, never ahead of its deadline
+    std::vector<std::vector<bool>> seen(kProducers, std::vector<bool>(kPackets, false));
+    for (size_t i = 0; i < dispatched.size(); ++i) {
+        const Tagged& tagged = dispatched[i];
+        CHECK(tagged.producer < kProducers && tagged.sequence < kPackets);
+        CHECK(!seen[tagged.producer][tagged.sequence]);
+        seen[tagged.producer][tagged.sequence] = true;
+        CHECK(dispatch_times[i] >= tagged.deadline_ns);
+    }
+}
+
+TEST(bundle_scheduler_full_and_stopped) {
+    BundleScheduler scheduler(1000000, 16, 4);
+    const char packet[] = "/chan1/audio 0.500 ";
+    CHECK(!scheduler.schedule(0, packet, sizeof(packet) - 1, 0));  // Not started
+
+    scheduler.start([](const std::string&, uint64_t, uint64_t, int) {});
+    uint64_t far_ns = rx_timestamp::nowNs() + 60ULL * 1000000000ULL;
+    for (int i = 0; i < 4; ++i) {
+        CHECK(scheduler.schedule(far_ns, packet, sizeof(packet) - 1, 0));
+    }
+    CHECK(!scheduler.schedule(far_ns, packet, sizeof(packet) - 1, 0));
+    CHECK_EQ(scheduler.getDroppedCount(), 1u);
+    CHECK_EQ(scheduler.getPendingCount(), 4u);
+
+    // Stopping discards what is still waiting
+    scheduler.stop();
+    CHECK_EQ(scheduler.getPendingCount(), 0u);
+    CHECK(!scheduler.schedule(far_ns, packet, sizeof(packet) - 1, 0));
+}
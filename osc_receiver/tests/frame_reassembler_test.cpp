@@ -0,0 +1,249 @@
+#include "test_framework.h"
+#include "frame_reassembler.h"
+#include "media_pipeline/stream_packetizer.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <thread>
+
+namespace stream_packet = media_pipeline::stream_packet;
+
+namespace {
+
+constexpr size_t kPayloadSize = 1000;
+
+uint8_t frameByte(uint64_t frame, size_t i) {
+    return static_cast<uint8_t>(frame * 13 + i * 7);
+}
+
+/**
+ * Packets for frames [first, first + count), frame f carrying f in its
+ * timestamp and sized so some frames are a single packet
+ * @param sequence Running packet sequence, advanced past the new packets
+ */
+std::vector<std::string> makePackets(uint64_t first, uint64_t count, uint64_t& sequence) {
+    std::vector<std::string> packets;
+    for (uint64_t f = first; f < first + count; ++f) {
+        size_t size = (f % 5 == 0) ? 300 : 1 + (f * 977) % (12 * kPayloadSize);
+        uint16_t total = static_cast<uint16_t>((size + kPayloadSize - 1) / kPayloadSize);
+        for (uint16_t index = 0; index < total; ++index) {
+            size_t offset = index * kPayloadSize;
+            size_t length = std::min(kPayloadSize, size - offset);
+            stream_packet::Header header{sequence++, index, total, static_cast<uint32_t>(length), f};
+            std::string packet(stream_packet::kHeaderSize + length, '\0');
+            stream_packet::write(header, reinterpret_cast<uint8_t*>(&packet[0]));
+            for (size_t i = 0; i < length; ++i) {
+                packet[stream_packet::kHeaderSize + i] = static_cast<char>(frameByte(f, offset + i));
+            }
+            packets.push_back(packet);
+        }
+    }
+    return packets;
+}
+
+bool frameIntact(const FrameReassembler::Frame& frame) {
+    for (size_t i = 0; i < frame.size; ++i) {
+        if (frame.data[i] != frameByte(frame.timestamp, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Shuffle within a sliding window: reordering as seen on a real path, not a full permutation
+void shuffleWindowed(std::vector<std::string>& packets, size_t window, std::mt19937& rng) {
+    for (size_t i = 0; i + 1 < packets.size(); ++i) {
+        size_t j = i + rng() % std::min(window, packets.size() - i);
+        std::swap(packets[i], packets[j]);
+    }
+}
+
+} // namespace
+
+TEST(frame_reassembler_out_of_order_with_duplicates) {
+    const uint64_t kFrames = 200;
+    uint64_t sequence = 1000;
+    std::vector<std::string> packets = makePackets(0, kFrames, sequence);
+    std::mt19937 rng(11);
+
+    uint64_t injected = 0;
+    std::vector<std::string> wire;
+    for (const std::string& packet : packets) {
+        wire.push_back(packet);
+        if (rng() % 10 == 0) {
+            wire.push_back(packet);
+            injected++;
+        }
+    }
+    shuffleWindowed(wire, 40, rng);
+
+    FrameReassembler reassembler;
+    std::map<uint64_t, size_t> delivered;
+    bool intact = true;
+    reassembler.setFrameCallback([&](const FrameReassembler::Frame& frame) {
+        intact = intact && frameIntact(frame);
+        delivered[frame.timestamp]++;
+    });
+    uint64_t now_ns = 1000000000;
+    for (const std::string& packet : wire) {
+        CHECK(reassembler.handlePacket(packet.data(), packet.size(), now_ns));
+        now_ns += 10000;
+    }
+
+    CHECK(intact);
+    CHECK_EQ(delivered.size(), kFrames);
+    for (const auto& entry : delivered) {
+        CHECK_EQ(entry.second, 1u);
+    }
+    CHECK_EQ(reassembler.getCompletedFrames(), kFrames);
+    CHECK_EQ(reassembler.getDuplicatePackets() + reassembler.getStalePackets(), injected);
+    CHECK_EQ(reassembler.getBufferedBytes(), 0u);
+    CHECK_EQ(reassembler.getTimedOutFrames() + reassembler.getEvictedFrames(), 0u);
+}
+
+TEST(frame_reassembler_timeout_and_invalid) {
+    uint64_t sequence = 0;
+    std::vector<std::string> packets = makePackets(3, 1, sequence);  // 2932 bytes: three fragments
+    CHECK(packets.size() > 2);
+
+    const uint64_t timeout_ns = 50000000;
+    FrameReassembler reassembler(4 * 1024 * 1024, 32 * 1024 * 1024, timeout_ns);
+    uint64_t now_ns = 1000000000;
+    for (size_t i = 0; i + 1 < packets.size(); ++i) {
+        reassembler.handlePacket(packets[i].data(), packets[i].size(), now_ns);
+    }
+    CHECK(reassembler.getBufferedBytes() > 0);
+
+    reassembler.expire(now_ns + timeout_ns + 1);
+    CHECK_EQ(reassembler.getTimedOutFrames(), 1u);
+    CHECK_EQ(reassembler.getBufferedBytes(), 0u);
+
+    // The straggler arrives for a frame already given up on
+    const std::string& last = packets.back();
+    CHECK(reassembler.handlePacket(last.data(), last.size(), now_ns + timeout_ns + 2));
+    CHECK_EQ(reassembler.getStalePackets(), 1u);
+    CHECK_EQ(reassembler.getCompletedFrames(), 0u);
+
+    // Short, and a header whose size disagrees with the datagram
+    CHECK(!reassembler.handlePacket(last.data(), 10, now_ns));
+    CHECK(!reassembler.handlePacket(last.data(), last.size() - 1, now_ns));
+    CHECK_EQ(reassembler.getInvalidPackets(), 2u);
+}
+
+TEST(frame_reassembler_memory_limit) {
+    uint64_t sequence = 0;
+    std::vector<std::string> packets = makePackets(1, 8, sequence);
+
+    // Hold back each frame's last fragment so nothing completes
+    FrameReassembler reassembler(4 * 1024 * 1024, 8 * kPayloadSize, 1000000000);
+    size_t held = 0;
+    for (size_t i = 0; i < packets.size(); ++i) {
+        stream_packet::Header header;
+        bool parsed = stream_packet::read(reinterpret_cast<const uint8_t*>(packets[i].data()), packets[i].size(),
+                                          header);
+        CHECK(parsed);
+        if (parsed && header.index + 1 < header.total) {
+            reassembler.handlePacket(packets[i].data(), packets[i].size(), 1000);
+            held += header.size;
+        }
+        CHECK(reassembler.getBufferedBytes() <= 8 * kPayloadSize);
+    }
+    CHECK(held > 8 * kPayloadSize);
+    CHECK(reassembler.getEvictedFrames() > 0);
+    CHECK_EQ(reassembler.getCompletedFrames(), 0u);
+
+    // A header claiming thousands of fragments is charged for what arrived, not what it claims
+    FrameReassembler fresh(4 * 1024 * 1024, 8 * kPayloadSize, 1000000000);
+    std::string packet(stream_packet::kHeaderSize + kPayloadSize, '\0');
+    stream_packet::Header header{1, 0, 4000, static_cast<uint32_t>(kPayloadSize), 0};
+    stream_packet::write(header, reinterpret_cast<uint8_t*>(&packet[0]));
+    CHECK(fresh.handlePacket(packet.data(), packet.size(), 1000));
+    CHECK_EQ(fresh.getBufferedBytes(), kPayloadSize);
+    CHECK_EQ(fresh.getEvictedFrames(), 0u);
+}
+
+TEST(frame_reassembler_overlapping_senders) {
+    const uint64_t kFrames = 100;
+
+    // Two senders both numbering from 1, as every StreamPacketizer does, interleaved on one socket
+    uint64_t sequence_a = 1;
+    uint64_t sequence_b = 1;
+    std::vector<std::string> from_a = makePackets(0, kFrames, sequence_a);
+    std::vector<std::string> from_b = makePackets(kFrames, kFrames, sequence_b);
+    std::vector<std::pair<uint64_t, std::string>> wire;
+    for (size_t i = 0; i < std::max(from_a.size(), from_b.size()); ++i) {
+        if (i < from_a.size()) wire.emplace_back(1, from_a[i]);
+        if (i < from_b.size()) wire.emplace_back(2, from_b[i]);
+    }
+    std::mt19937 rng(5);
+    for (size_t i = 0; i + 1 < wire.size(); ++i) {
+        std::swap(wire[i], wire[i + rng() % std::min<size_t>(30, wire.size() - i)]);
+    }
+
+    FrameReassembler reassembler;
+    std::vector<uint64_t> delivered(2 * kFrames, 0);
+    bool intact = true;
+    bool sources_match = true;
+    reassembler.setFrameCallback([&](const FrameReassembler::Frame& frame) {
+        intact = intact && frameIntact(frame);
+        sources_match = sources_match && frame.source == (frame.timestamp < kFrames ? 1u : 2u);
+        delivered[frame.timestamp]++;
+    });
+    uint64_t now_ns = 1000000000;
+    for (const auto& packet : wire) {
+        CHECK(reassembler.handlePacket(packet.second.data(), packet.second.size(), now_ns, packet.first));
+        now_ns += 10000;
+    }
+
+    CHECK(intact);
+    CHECK(sources_match);
+    for (uint64_t count : delivered) {
+        CHECK_EQ(count, 1u);
+    }
+    CHECK_EQ(reassembler.getStalePackets() + reassembler.getDuplicatePackets(), 0u);
+    CHECK_EQ(reassembler.getBufferedBytes(), 0u);
+}
+
+TEST(frame_reassembler_concurrent_senders) {
+    const int kThreads = 3;
+    const uint64_t kFrames = 300 * media_pipeline::test::stressScale();
+
+    // Each thread owns a disjoint range of frames and sequences, as from several receive threads
+    std::vector<std::vector<std::string>> wires(kThreads);
+    for (int t = 0; t < kThreads; ++t) {
+        uint64_t sequence = static_cast<uint64_t>(t) << 40;
+        wires[t] = makePackets(t * kFrames, kFrames, sequence);
+        std::mt19937 rng(t);
+        shuffleWindowed(wires[t], 30, rng);
+    }
+
+    FrameReassembler reassembler;
+    std::vector<uint64_t> delivered(kThreads * kFrames, 0);
+    bool intact = true;
+    reassembler.setFrameCallback([&](const FrameReassembler::Frame& frame) {
+        intact = intact && frameIntact(frame);  // Callbacks are serialized by the reassembler lock
+        delivered[frame.timestamp]++;
+    });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            uint64_t now_ns = 1000000000;
+            for (const std::string& packet : wires[t]) {
+                reassembler.handlePacket(packet.data(), packet.size(), now_ns);
+                now_ns += 1000;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(intact);
+    CHECK_EQ(reassembler.getCompletedFrames(), kThreads * kFrames);
+    for (uint64_t count : delivered) {
+        CHECK_EQ(count, 1u);
+    }
+    CHECK_EQ(reassembler.getBufferedBytes(), 0u);
+}
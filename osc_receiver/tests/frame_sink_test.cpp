@@ -0,0 +1,159 @@
+#include "test_framework.h"
+#include "frame_sink.h"
+
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace frame_sink_layout;
+
+namespace {
+
+// Frames repeat with this period so the writer only copies and laps a slow reader often
+constexpr uint64_t kPatterns = 64;
+
+uint8_t frameByte(uint64_t frame, size_t i) {
+    return static_cast<uint8_t>((frame % kPatterns) * 29 + i * 3);
+}
+
+size_t frameSize(uint64_t frame) {
+    return 64 + ((frame % kPatterns) * 389) % 4000;
+}
+
+struct Snapshot {
+    uint64_t timestamp_ns;
+    uint32_t size;
+    std::vector<uint8_t> data;
+};
+
+// A seqlock reader races with the writer by design and throws away what a
+// concurrent write tore, so the copy is kept out of ThreadSanitizer's view
+__attribute__((no_sanitize("thread"))) void copySlot(const Slot* slot, size_t capacity, Snapshot& out) {
+    const volatile Slot* view = slot;
+    out.timestamp_ns = view->timestamp_ns;
+    out.size = view->size;
+    const volatile uint8_t* data = reinterpret_cast<const volatile uint8_t*>(slot) + kSlotHeaderSize;
+    out.data.resize(out.size <= capacity ? out.size : 0);
+    for (size_t i = 0; i < out.data.size(); ++i) {
+        out.data[i] = data[i];
+    }
+}
+
+} // namespace
+
+TEST(frame_sink_reader_never_sees_torn_frames) {
+    const uint64_t kFrames = 200000 * media_pipeline::test::stressScale();
+    const std::string name = "/tmp/osc_receiver_frame_sink_test_" + std::to_string(getpid());
+
+    FrameFormat format;
+    CHECK(FrameFormat::parse("RGBA:32x32", format));
+    FrameSink sink(format);
+    std::string error;
+    CHECK(sink.openSharedMemory(name, 4096, error));
+
+    // Map the export as a consumer process would
+    int fd = open(name.c_str(), O_RDWR);
+    CHECK(fd >= 0);
+    struct stat info;
+    CHECK(fstat(fd, &info) == 0);
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    CHECK(mapping != MAP_FAILED);
+    auto* header = static_cast<Header*>(mapping);
+    CHECK_EQ(header->magic.load(std::memory_order_acquire), kMagic);
+    CHECK_EQ(header->version, kVersion);
+
+    std::atomic<bool> writer_done{false};
+    uint64_t accepted = 0;
+    uint64_t torn = 0;
+    uint64_t last_timestamp = 0;
+    bool in_order = true;
+    std::thread reader([&] {
+        Snapshot snapshot;
+        uint32_t seen_seq = 0;
+        while (!writer_done.load() || header->frame_seq.load() != seen_seq) {
+            const uint32_t frame_seq = header->frame_seq.load(std::memory_order_acquire);
+            if (frame_seq == seen_seq) {
+#ifdef __linux__
+                header->waiters.fetch_add(1, std::memory_order_seq_cst);
+                if (header->frame_seq.load(std::memory_order_seq_cst) == frame_seq) {
+                    struct timespec timeout = {0, 10000000};
+                    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header->frame_seq), FUTEX_WAIT, frame_seq,
+                            &timeout, nullptr, 0);
+                }
+                header->waiters.fetch_sub(1, std::memory_order_seq_cst);
+#endif
+                continue;
+            }
+            seen_seq = frame_seq;
+
+            const uint32_t latest = header->latest.load(std::memory_order_acquire);
+            if (latest == kNoFrame) {
+                continue;
+            }
+            auto* slot = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + header->slot_offset +
+                                                 latest * header->slot_stride);
+            const uint64_t before = slot->seq.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;  // Being rewritten: the next frame_seq bump brings a newer frame
+            }
+            copySlot(slot, header->slot_capacity, snapshot);
+            // A release fetch_add of 0 keeps the copy ahead of the reload, without a fence
+            if (slot->seq.fetch_add(0, std::memory_order_release) != before) {
+                continue;
+            }
+
+            // Accepted: it must be exactly the frame the writer stored
+            bool intact = snapshot.size == frameSize(snapshot.timestamp_ns) && snapshot.data.size() == snapshot.size;
+            for (size_t i = 0; intact && i < snapshot.data.size(); ++i) {
+                intact = snapshot.data[i] == frameByte(snapshot.timestamp_ns, i);
+            }
+            if (!intact) {
+                torn++;
+                continue;
+            }
+            in_order = in_order && snapshot.timestamp_ns >= last_timestamp;
+            last_timestamp = snapshot.timestamp_ns;
+            accepted++;
+        }
+    });
+
+    std::vector<std::vector<uint8_t>> frames(kPatterns);
+    for (uint64_t p = 0; p < kPatterns; ++p) {
+        frames[p].resize(frameSize(p));
+        for (size_t i = 0; i < frames[p].size(); ++i) {
+            frames[p][i] = frameByte(p, i);
+        }
+    }
+    for (uint64_t f = 1; f <= kFrames; ++f) {
+        const auto& frame = frames[f % kPatterns];
+        sink.write(frame.data(), frame.size(), f, f);
+        if (f % 256 == 0) {
+            std::this_thread::yield();  // Let the reader both sleep and be lapped
+        }
+    }
+    writer_done = true;
+    reader.join();
+
+    CHECK_EQ(torn, 0u);
+    CHECK(in_order);
+    CHECK(accepted > 0);
+    CHECK_EQ(last_timestamp, kFrames);  // The final frame is always readable
+    CHECK_EQ(sink.getFrameCount(), kFrames);
+    CHECK_EQ(header->waiters.load(), 0u);
+
+    munmap(mapping, size);
+    sink.close();
+}
@@ -0,0 +1,134 @@
+#include "test_framework.h"
+#include "loudness_monitor.h"
+#include "media_pipeline/osc_message.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <string>
+#include <thread>
+
+using media_pipeline::OSCParser;
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+
+StreamWorker::Samples toneBuffer(size_t start, size_t count, double dbfs) {
+    const double amplitude = std::pow(10.0, dbfs / 20.0);
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] = static_cast<float>(amplitude * std::sin(2.0 * M_PI * 997.0 * (start + i) / kSampleRate));
+    }
+    return std::make_shared<const std::vector<float>>(std::move(samples));
+}
+
+} // namespace
+
+// Two streams submitted from their own threads, as event loop threads would
+TEST(loudness_monitor_streams) {
+    int socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    CHECK(bind(socket_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    socklen_t length = sizeof(addr);
+    getsockname(socket_fd, reinterpret_cast<sockaddr*>(&addr), &length);
+
+    LoudnessMonitor monitor(kSampleRate, 4096);
+    monitor.setOscOutput("127.0.0.1", ntohs(addr.sin_port));
+    CHECK(monitor.start());
+
+    const size_t buffers = 300;  // 3 s of 10 ms buffers
+    std::thread loud([&] {
+        for (size_t b = 0; b < buffers; ++b) {
+            monitor.submit(3, "/audio/loud", toneBuffer(b * 441, 441, -23.0));
+        }
+    });
+    std::thread quiet([&] {
+        for (size_t b = 0; b < buffers; ++b) {
+            monitor.submit(5, "/audio/quiet", toneBuffer(b * 441, 441, -33.0));
+        }
+    });
+    loud.join();
+    quiet.join();
+    monitor.flush();
+
+    // A mono stream reads 3 dB below the same tone on a stereo pair. Stream
+    // ids follow first sight, which the two threads race for.
+    auto readings = monitor.getReadings();
+    CHECK_EQ(readings.size(), 2u);
+    CHECK_EQ(monitor.getDroppedCount(), 0u);
+    if (readings.size() == 2 && readings[0].address != "/audio/loud") {
+        std::swap(readings[0], readings[1]);
+    }
+    CHECK(readings[0].address == "/audio/loud" && readings[1].address == "/audio/quiet");
+    CHECK_NEAR(readings[0].reading.integrated_lufs, -26.0, 0.1);
+    CHECK_NEAR(readings[1].reading.momentary_lufs, -36.0, 0.1);
+    CHECK_NEAR(readings[0].reading.true_peak_dbtp, -23.0, 0.1);
+    CHECK_EQ(readings[0].reading.frames, buffers * 441);
+    CHECK_EQ(monitor.getOscMessageCount(), 2u * 30u);  // One per 100 ms step (4410 frames)
+
+    // Readings arrive as plain float analysis messages
+    pollfd pfd{socket_fd, POLLIN, 0};
+    CHECK(poll(&pfd, 1, 1000) == 1);
+    char packet[1500];
+    ssize_t received = recv(socket_fd, packet, sizeof(packet), 0);
+    CHECK(received > 0);
+    auto message = OSCParser::parseMessage(std::string(packet, received > 0 ? received : 0));
+    CHECK(message.type == OSCParser::ANALYSIS && message.address == "/analysis/loudness");
+    CHECK_EQ(message.floatData.size(), 5u);
+    if (message.floatData.size() == 5) {
+        CHECK(message.floatData[0] == 0.0f || message.floatData[0] == 1.0f);
+        CHECK(message.floatData[1] < 0.0f && message.floatData[1] >= LoudnessMonitor::kOscFloor);
+    }
+    monitor.stop();
+    close(socket_fd);
+}
+
+// Senders split each block into "<address>_0" ... "_3", each interned as a
+// channel of its own; one meter must still see the whole stream in order
+TEST(loudness_monitor_joins_chunked_streams) {
+    LoudnessMonitor monitor(kSampleRate, 4096);
+    CHECK(monitor.start());
+
+    const size_t kChunk = 128;
+    const size_t blocks = 600;  // 3.5 s of 512-frame blocks
+    for (size_t b = 0; b < blocks; ++b) {
+        for (uint32_t c = 0; c < 4; ++c) {
+            // The last chunk lands on the receiver's overflow id, which is never cached
+            const uint32_t channel = c == 3 ? AddressTable::kOverflowId : 10 + c;
+            monitor.submit(channel, "/audio/tone_" + std::to_string(c),
+                           toneBuffer((4 * b + c) * kChunk, kChunk, -23.0));
+        }
+    }
+    monitor.flush();
+
+    auto readings = monitor.getReadings();
+    CHECK_EQ(readings.size(), 1u);
+    if (readings.size() == 1) {
+        CHECK_EQ(readings[0].stream, 0u);
+        CHECK(readings[0].address == "/audio/tone");
+        // As of the last completed 100 ms step, within the final 4410 frames
+        const uint64_t total = blocks * 4 * kChunk;
+        CHECK(readings[0].reading.frames > total - 4410 && readings[0].reading.frames <= total);
+        CHECK_NEAR(readings[0].reading.integrated_lufs, -26.0, 0.1);
+        CHECK_NEAR(readings[0].reading.true_peak_dbtp, -23.0, 0.1);
+    }
+    CHECK_EQ(monitor.getDroppedCount(), 0u);
+    monitor.stop();
+}
+
+TEST(loudness_monitor_drops_when_behind) {
+    // Not started: nothing drains the queue
+    LoudnessMonitor monitor(kSampleRate, 2);
+    for (int i = 0; i < 5; ++i) {
+        monitor.submit(0, "/audio/a", toneBuffer(0, 441, -20.0));
+    }
+    CHECK_EQ(monitor.getDroppedCount(), 3u);
+    CHECK(monitor.getReadings().empty());
+}
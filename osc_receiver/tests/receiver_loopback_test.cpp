@@ -0,0 +1,382 @@
+#include "test_framework.h"
+#include "osc_receiver.h"
+#include "rx_timestamp.h"
+#include "uring_receiver.h"
+#include "media_pipeline/osc_message.h"
+#include "media_pipeline/osc_sender.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using media_pipeline::OSCSender;
+
+namespace {
+
+constexpr int kBlockSamples = 128;  // One chunk per block
+constexpr int kFeatureDims = 13;
+constexpr uint64_t kInFlight = 96;   // Messages sent but not yet received: well inside the default SO_RCVBUF
+
+// Samples 0-2 name the block (audio stays within [-1, 1]); the rest follow a pattern of it
+float sampleValue(int sender, int block, int i) {
+    if (i == 0) return sender / 10.0f;
+    if (i == 1) return block % 1000 / 1000.0f;
+    if (i == 2) return block / 1000 / 1000.0f;
+    return static_cast<float>((sender * 131 + block * 7 + i) % 2001 - 1000) / 1000.0f;
+}
+
+float featureValue(int block, int d) {
+    return std::sin(0.05f * block + d);
+}
+
+int freeUdpPort() {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t length = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length);
+    close(fd);
+    return ntohs(addr.sin_port);
+}
+
+struct Received {
+    std::mutex mutex;
+    std::set<std::pair<int, int>> audio_blocks;
+    std::set<std::string> texts;
+    std::map<std::string, int> feature_blocks;
+    size_t features = 0;
+    bool corrupt = false;
+};
+
+/**
+ * Send audio, text and quantized features from several threads at once and
+ * check every message arrives intact on the given backend
+ */
+void runLoopback(OSCReceiver::ReceiveBackend backend, int loop_threads, int senders) {
+    const int blocks = 300 * media_pipeline::test::stressScale();
+    const int port = freeUdpPort();
+
+    Received received;
+    OSCReceiver receiver(port);
+    receiver.setReceiveBackend(backend);
+    receiver.setLoopThreads(loop_threads);
+    receiver.setBusyPoll(-1, 100);
+    receiver.setAudioCallback([&](const std::vector<float>& samples, uint64_t) {
+        std::lock_guard<std::mutex> lock(received.mutex);
+        int sender = static_cast<int>(std::lround(samples[0] * 10.0f));
+        int block = static_cast<int>(std::lround(samples[1] * 1000.0f) + 1000 * std::lround(samples[2] * 1000.0f));
+        bool intact = samples.size() == kBlockSamples;
+        for (int i = 0; intact && i < kBlockSamples; ++i) {
+            intact = std::fabs(samples[i] - sampleValue(sender, block, i)) < 1e-6f;
+        }
+        received.corrupt |= !intact || !received.audio_blocks.insert({sender, block}).second;
+    });
+    receiver.setTextCallback([&](const std::string&, const std::string& text, uint64_t) {
+        std::lock_guard<std::mutex> lock(received.mutex);
+        received.corrupt |= !received.texts.insert(text).second;
+    });
+    receiver.setAnalysisCallback([&](const std::string& channel, const std::vector<float>& features, uint64_t) {
+        // One flow per sender stays in order, so vectors arrive in block order per channel
+        std::lock_guard<std::mutex> lock(received.mutex);
+        int block = received.feature_blocks[channel]++;
+        bool intact = features.size() == kFeatureDims;
+        for (int d = 0; intact && d < kFeatureDims; ++d) {
+            intact = std::fabs(features[d] - featureValue(block, d)) < 1e-3f;
+        }
+        received.corrupt |= !intact;
+        received.features++;
+    });
+    CHECK(receiver.start());
+
+    // Senders hold back while the receiver lags, so slow builds (TSan) see no
+    // socket overflow and every message can be accounted for
+    std::atomic<uint64_t> sent{0};
+    auto waitForReceiver = [&] {
+        auto limit = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (sent.load() > receiver.getMessageCount() + kInFlight && std::chrono::steady_clock::now() < limit) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int s = 0; s < senders; ++s) {
+        threads.emplace_back([&, s] {
+            OSCSender sender("127.0.0.1", port);
+            sender.setFeatureEncoding(16, 20);
+            const std::string feature_address = "/analysis/mfcc" + std::to_string(s);  // One delta reference per sender
+
+            int text_fd = socket(AF_INET, SOCK_DGRAM, 0);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(port));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+            std::vector<float> samples(kBlockSamples);
+            std::vector<float> features(kFeatureDims);
+            for (int block = 0; block < blocks; ++block) {
+                for (int i = 0; i < kBlockSamples; ++i) {
+                    samples[i] = sampleValue(s, block, i);
+                }
+                sender.sendAudio("/chan1/audio", samples.data(), kBlockSamples);
+
+                for (int d = 0; d < kFeatureDims; ++d) {
+                    features[d] = featureValue(block, d);
+                }
+                sender.sendFeatures(feature_address, features.data(), kFeatureDims);
+
+                std::string text = "/chan2/text sender " + std::to_string(s) + " line " + std::to_string(block);
+                sendto(text_fd, text.data(), text.size(), 0, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+
+                sent.fetch_add(3);
+                waitForReceiver();
+            }
+            close(text_fd);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Wait for the receiver to drain its socket
+    const size_t expected = static_cast<size_t>(senders) * blocks;
+    auto limit = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < limit) {
+        {
+            std::lock_guard<std::mutex> lock(received.mutex);
+            if (received.audio_blocks.size() == expected && received.texts.size() == expected &&
+                received.features == expected) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    // No silent fallback: everything arrived through the backend asked for
+    CHECK(receiver.getActiveBackend() == backend);
+    receiver.stop();
+
+    CHECK(!received.corrupt);
+    CHECK_EQ(received.audio_blocks.size(), expected);
+    CHECK_EQ(received.texts.size(), expected);
+    CHECK_EQ(received.features, expected);
+    CHECK_EQ(receiver.getMessageCount(), 3 * expected);
+}
+
+// Kernels without io_uring, or sandboxes that block it, skip the ring test
+bool uringAvailable() {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    bool available = false;
+    {
+        UringReceiver uring;
+        available = uring.initialize(fd);
+    }
+    close(fd);
+    return available;
+}
+
+// Sockets standing in for separate senders: each has its own loopback port
+int bindSender() {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    return fd;
+}
+
+uint64_t sourceOf(int fd) {
+    sockaddr_storage addr{};
+    socklen_t length = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length);
+    return EventLoop::sourceOf(addr, length);
+}
+
+void sendTo(int fd, int port, const std::string& packet) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sendto(fd, packet.data(), packet.size(), 0, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+}
+
+void appendBigEndian(std::string& out, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+std::string bundle(uint64_t timetag, const std::string& element) {
+    std::string packet("#bundle\0", 8);
+    appendBigEndian(packet, timetag, 8);
+    appendBigEndian(packet, element.size(), 4);
+    packet += element;
+    return packet;
+}
+
+uint64_t timetagAt(uint64_t unix_ns) {
+    constexpr uint64_t kNtpToUnixSeconds = 2208988800ULL;
+    uint64_t fraction = ((unix_ns % 1000000000ULL) << 32) / 1000000000ULL;
+    return (unix_ns / 1000000000ULL + kNtpToUnixSeconds) << 32 | fraction;
+}
+
+struct Dispatched {
+    std::mutex mutex;
+    std::map<std::string, uint64_t> texts;  // Text to local dispatch time
+
+    bool waitFor(const std::string& text, int timeout_ms) {
+        auto limit = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (std::chrono::steady_clock::now() < limit) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (texts.count(text)) {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+};
+
+void recordTexts(OSCReceiver& receiver, Dispatched& dispatched) {
+    receiver.setTextCallback([&dispatched](const std::string&, const std::string& text, uint64_t) {
+        std::lock_guard<std::mutex> lock(dispatched.mutex);
+        dispatched.texts.emplace(text, rx_timestamp::nowNs());
+    });
+}
+
+} // namespace
+
+TEST(receiver_loopback_blocking) {
+    runLoopback(OSCReceiver::ReceiveBackend::BLOCKING, 1, 1);
+}
+
+TEST(receiver_loopback_epoll_multiple_senders) {
+    runLoopback(OSCReceiver::ReceiveBackend::EPOLL, 2, 3);
+}
+
+TEST(receiver_loopback_busy_poll) {
+    runLoopback(OSCReceiver::ReceiveBackend::BUSY_POLL, 1, 2);
+}
+
+TEST(receiver_loopback_io_uring) {
+    if (!uringAvailable()) {
+        std::cout << "  io_uring unavailable, skipped" << std::endl;
+        return;
+    }
+    runLoopback(OSCReceiver::ReceiveBackend::IO_URING, 1, 2);
+}
+
+TEST(receiver_bundles_use_each_senders_clock) {
+    const int port = freeUdpPort();
+    Dispatched dispatched;
+    OSCReceiver receiver(port);
+    receiver.setReceiveBackend(OSCReceiver::ReceiveBackend::EPOLL);
+    recordTexts(receiver, dispatched);
+    CHECK(receiver.start());
+
+    // Sender b's clock runs 5 s ahead of ours, sender a's matches
+    const int64_t kSkewNs = 5000000000LL;
+    int a = bindSender();
+    int b = bindSender();
+    for (int i = 0; i < 8; ++i) {
+        sendTo(a, port, "/clock/sync " + std::to_string(rx_timestamp::nowNs()));
+        sendTo(b, port, "/clock/sync " + std::to_string(rx_timestamp::nowNs() + kSkewNs));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto limit = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (receiver.getClockOffsetNs(sourceOf(b)) > -kSkewNs / 2 && std::chrono::steady_clock::now() < limit) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(std::llabs(receiver.getClockOffsetNs(sourceOf(a))) < 50000000LL);
+    CHECK(std::llabs(receiver.getClockOffsetNs(sourceOf(b)) + kSkewNs) < 50000000LL);
+
+    // Both bundles are due 300 ms from now by their own sender's clock
+    const uint64_t kLeadNs = 300000000ULL;
+    uint64_t sent_ns = rx_timestamp::nowNs();
+    sendTo(a, port, bundle(timetagAt(sent_ns + kLeadNs), "/chan2/text from a"));
+    sendTo(b, port, bundle(timetagAt(sent_ns + kSkewNs + kLeadNs), "/chan2/text from b"));
+    CHECK(dispatched.waitFor("from a", 3000));
+    CHECK(dispatched.waitFor("from b", 3000));
+    receiver.stop();
+    close(a);
+    close(b);
+
+    for (const char* text : {"from a", "from b"}) {
+        uint64_t at_ns = dispatched.texts[text];
+        CHECK(at_ns >= sent_ns + kLeadNs - 50000000ULL);
+        CHECK(at_ns < sent_ns + kLeadNs + 500000000ULL);
+    }
+}
+
+TEST(receiver_scheduled_bundles_keep_nesting_limit) {
+    const int port = freeUdpPort();
+    Dispatched dispatched;
+    OSCReceiver receiver(port);
+    receiver.setReceiveBackend(OSCReceiver::ReceiveBackend::EPOLL);
+    recordTexts(receiver, dispatched);
+    CHECK(receiver.start());
+
+    // Seven immediate bundles inside a timetagged one stay within the limit, eight do not
+    auto nested = [](const std::string& message, int levels) {
+        std::string packet = message;
+        for (int i = 0; i < levels; ++i) {
+            packet = bundle(media_pipeline::OSCParser::kImmediateTimetag, packet);
+        }
+        return bundle(timetagAt(rx_timestamp::nowNs() + 50000000ULL), packet);
+    };
+    int fd = bindSender();
+    sendTo(fd, port, nested("/chan2/text too deep", 8));
+    sendTo(fd, port, nested("/chan2/text deep enough", 7));
+    CHECK(dispatched.waitFor("deep enough", 3000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    receiver.stop();
+    close(fd);
+
+    CHECK_EQ(dispatched.texts.count("too deep"), 0u);
+}
+
+TEST(receiver_invalid_messages_do_not_intern) {
+    const int port = freeUdpPort();
+    OSCReceiver receiver(port);
+    receiver.setReceiveBackend(OSCReceiver::ReceiveBackend::EPOLL);
+    CHECK(receiver.start());
+
+    // Junk on fresh addresses must not take ids from the streams that follow
+    const uint64_t kJunk = 2 * AddressTable::kMaxChannels;
+    int fd = bindSender();
+    for (uint64_t i = 0; i < kJunk; ++i) {
+        sendTo(fd, port, "/spray/" + std::to_string(i) + " 1 2 3");
+        if (i % 64 == 63) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    sendTo(fd, port, "/chan1/audio 0.25 -0.5");
+    auto limit = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (receiver.getMessageCount() < kJunk + 1 && std::chrono::steady_clock::now() < limit) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    receiver.stop();
+    close(fd);
+
+    const AddressTable& channels = receiver.getChannels();
+    CHECK_EQ(receiver.getMessageCount(), kJunk + 1);
+    CHECK_EQ(channels.size(), 1u);
+    CHECK_EQ(channels.stats(AddressTable::kOverflowId).invalid.load(), kJunk);
+    uint32_t audio = channels.find("/chan1/audio");
+    CHECK_EQ(audio, 0u);
+    std::vector<float> latest = receiver.getLatestAudioData(audio);
+    CHECK_EQ(latest.size(), 2u);
+    CHECK_NEAR(latest[1], -0.5f, 1e-6);
+}
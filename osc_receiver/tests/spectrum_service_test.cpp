@@ -0,0 +1,164 @@
+#include "test_framework.h"
+#include "loudness_monitor.h"
+#include "spectrum_service.h"
+#include "media_pipeline/feature_codec.h"
+#include "media_pipeline/osc_message.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <string>
+
+using media_pipeline::OSCParser;
+using media_pipeline::SpectrumAnalyzer;
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+
+int bindLoopback(int& port) {
+    int socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(socket_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t length = sizeof(addr);
+    getsockname(socket_fd, reinterpret_cast<sockaddr*>(&addr), &length);
+    port = ntohs(addr.sin_port);
+    return socket_fd;
+}
+
+} // namespace
+
+// One shared buffer per receive, analyzed by both services; the spectrum
+// reaches the client as quantized vectors
+TEST(spectrum_service_publishes_quantized_frames) {
+    int port = 0;
+    int socket_fd = bindLoopback(port);
+
+    SpectrumAnalyzer::Config config;
+    config.bands = 24;
+    SpectrumService spectrum(kSampleRate, config);
+    spectrum.setOscOutput("127.0.0.1", port);
+    LoudnessMonitor loudness(kSampleRate);
+    CHECK(spectrum.start());
+    CHECK(loudness.start());
+
+    // A tone at the center of band 15
+    const SpectrumAnalyzer bands(kSampleRate, config);
+    const size_t band = 15;
+    const double frequency = std::sqrt(static_cast<double>(bands.getBandEdge(band)) * bands.getBandEdge(band + 1));
+    const double amplitude = std::pow(10.0, -12.0 / 20.0);
+    for (size_t b = 0; b < 100; ++b) {  // 1 s of 10 ms buffers
+        std::vector<float> samples(441);
+        for (size_t i = 0; i < samples.size(); ++i) {
+            samples[i] = static_cast<float>(amplitude * std::sin(2.0 * M_PI * frequency * (b * 441 + i) / kSampleRate));
+        }
+        const StreamWorker::Samples shared = std::make_shared<const std::vector<float>>(std::move(samples));
+        spectrum.submit(7, "/audio/tone", shared);
+        loudness.submit(7, "/audio/tone", shared);
+    }
+    spectrum.flush();
+    loudness.flush();
+    CHECK_EQ(spectrum.getFrameCount(), 30u);
+    CHECK_EQ(spectrum.getStreamCount(), 1u);
+    CHECK_EQ(spectrum.getDroppedCount(), 0u);
+    CHECK_EQ(loudness.getReadings().size(), 1u);
+
+    media_pipeline::feature_codec::Decoder decoder;
+    std::vector<float> values;
+    size_t messages = 0;
+    size_t last_size = 0;
+    pollfd pfd{socket_fd, POLLIN, 0};
+    while (messages < 30 && poll(&pfd, 1, 1000) == 1) {
+        char packet[4096];
+        ssize_t received = recv(socket_fd, packet, sizeof(packet), 0);
+        CHECK(received > 0);
+        const std::string data(packet, received > 0 ? received : 0);
+        auto message = OSCParser::parseMessage(data);
+        CHECK(message.type == OSCParser::ANALYSIS && message.address == "/analysis/spectrum/0");
+        CHECK(message.encodedOffset > 0);
+        if (message.encodedOffset > 0) {
+            CHECK(decoder.decode(data.data() + message.encodedOffset, data.size() - message.encodedOffset, values));
+        }
+        last_size = data.size();
+        messages++;
+    }
+    CHECK_EQ(messages, 30u);
+    CHECK(last_size < 48 * 4);  // A delta frame: a byte or two per value, not four
+    CHECK_EQ(values.size(), 48u);
+    if (values.size() == 48) {
+        CHECK_NEAR(values[band], -12.0, 1.0);       // Level
+        CHECK_NEAR(values[24 + band], -12.0, 1.0);  // Peak
+        CHECK(values[band - 5] < -50.0f);
+    }
+    spectrum.stop();
+    loudness.stop();
+    close(socket_fd);
+}
+
+// The chunks of each block arrive on addresses of their own; the analyzer
+// windows the whole stream and publishes one series for it
+TEST(spectrum_service_joins_chunked_streams) {
+    int port = 0;
+    int socket_fd = bindLoopback(port);
+
+    SpectrumAnalyzer::Config config;
+    config.bands = 24;
+    SpectrumService spectrum(kSampleRate, config, 4096);
+    spectrum.setOscOutput("127.0.0.1", port);
+    CHECK(spectrum.start());
+
+    const SpectrumAnalyzer bands(kSampleRate, config);
+    const size_t band = 15;
+    const double frequency = std::sqrt(static_cast<double>(bands.getBandEdge(band)) * bands.getBandEdge(band + 1));
+    const double amplitude = std::pow(10.0, -12.0 / 20.0);
+    const size_t kChunk = 128;
+    size_t frame = 0;
+    for (size_t b = 0; b < 86; ++b) {  // 1 s of 512-frame blocks
+        for (uint32_t c = 0; c < 4; ++c) {
+            std::vector<float> samples(kChunk);
+            for (size_t i = 0; i < kChunk; ++i, ++frame) {
+                samples[i] = static_cast<float>(amplitude * std::sin(2.0 * M_PI * frequency * frame / kSampleRate));
+            }
+            spectrum.submit(20 + c, "/audio/tone_" + std::to_string(c),
+                            std::make_shared<const std::vector<float>>(std::move(samples)));
+        }
+    }
+    spectrum.flush();
+    CHECK_EQ(spectrum.getDroppedCount(), 0u);
+    CHECK_EQ(spectrum.getStreamCount(), 1u);
+    CHECK_EQ(spectrum.getAddress(0), std::string("/audio/tone"));
+    CHECK_EQ(spectrum.getFrameCount(), frame * 30 / kSampleRate);
+
+    media_pipeline::feature_codec::Decoder decoder;
+    std::vector<float> values;
+    size_t messages = 0;
+    pollfd pfd{socket_fd, POLLIN, 0};
+    while (messages < spectrum.getFrameCount() && poll(&pfd, 1, 1000) == 1) {
+        char packet[4096];
+        ssize_t received = recv(socket_fd, packet, sizeof(packet), 0);
+        CHECK(received > 0);
+        const std::string data(packet, received > 0 ? received : 0);
+        auto message = OSCParser::parseMessage(data);
+        CHECK(message.address == "/analysis/spectrum/0");
+        if (message.encodedOffset > 0) {
+            CHECK(decoder.decode(data.data() + message.encodedOffset, data.size() - message.encodedOffset, values));
+        }
+        messages++;
+    }
+    CHECK_EQ(messages, spectrum.getFrameCount());
+    CHECK_EQ(values.size(), 48u);
+    if (values.size() == 48) {
+        // A window spliced from every 4th chunk would smear the tone over the neighbours
+        CHECK_NEAR(values[band], -12.0, 1.0);
+        CHECK(values[band - 5] < -50.0f);
+        CHECK(values[band + 5] < -50.0f);
+    }
+    spectrum.stop();
+    close(socket_fd);
+}
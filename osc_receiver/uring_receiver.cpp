@@ -0,0 +1,403 @@
+#include "uring_receiver.h"
+#include "event_loop.h"
+#include "rx_timestamp.h"
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+
+#ifdef OSC_HAVE_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+unsigned roundUpPowerOfTwo(unsigned value) {
+    unsigned result = 1;
+    while (result < value && result < 32768) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+UringReceiver::UringReceiver(unsigned buffer_count, unsigned buffer_size)
+    : buffer_count_(roundUpPowerOfTwo(buffer_count))
+    , buffer_size_(buffer_size)
+    , packet_count_(0)
+    , batch_count_(0) {
+#ifdef OSC_HAVE_IO_URING
+    ring_fd_ = -1;
+    socket_fd_ = -1;
+    sq_ring_ptr_ = MAP_FAILED;
+    sq_ring_size_ = 0;
+    sq_tail_ = nullptr;
+    sq_mask_ = nullptr;
+    sq_array_ = nullptr;
+    sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    sqes_size_ = 0;
+    pending_submit_ = 0;
+    cq_ring_ptr_ = MAP_FAILED;
+    cq_ring_size_ = 0;
+    cq_head_ = nullptr;
+    cq_tail_ = nullptr;
+    cq_mask_ = nullptr;
+    cqes_ = nullptr;
+    buf_ring_ = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+    buf_ring_size_ = 0;
+    buf_ring_tail_ = 0;
+    std::memset(&msg_template_, 0, sizeof(msg_template_));
+    payload_offset_ = 0;
+#endif
+}
+
+UringReceiver::~UringReceiver() {
+    release();
+}
+
+#ifdef OSC_HAVE_IO_URING
+
+namespace {
+
+constexpr uint16_t kBufferGroup = 0;
+constexpr uint64_t kRecvUserData = 1;
+constexpr long kWaitTimeoutNs = 100 * 1000 * 1000;  // Re-check running flag every 100 ms
+constexpr int kMaxEmptyRearms = 8;  // ENOBUFS re-arms without a packet before giving up
+
+template <typename T>
+T loadAcquire(const T* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+template <typename T>
+void storeRelease(T* ptr, T value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+// Not &ring->bufs[index]: in C++ the uapi flex array sits behind an empty
+// struct, 8 bytes past where the kernel reads entry 0 (whose resv is the tail)
+io_uring_buf* ringEntry(io_uring_buf_ring* ring, unsigned index) {
+    return reinterpret_cast<io_uring_buf*>(ring) + index;
+}
+
+} // namespace
+
+bool UringReceiver::initialize(int socket_fd) {
+    release();
+    socket_fd_ = socket_fd;
+
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = buffer_count_ * 2;
+
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, 8, &params));
+    if (ring_fd_ < 0) {
+        std::cerr << "io_uring_setup failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (!(params.features & IORING_FEAT_EXT_ARG)) {
+        std::cerr << "io_uring: kernel lacks IORING_FEAT_EXT_ARG" << std::endl;
+        release();
+        return false;
+    }
+
+    // Map submission and completion rings
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        cq_ring_size_ = sq_ring_size_;
+    }
+
+    sq_ring_ptr_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ptr_ == MAP_FAILED) {
+        std::cerr << "io_uring: failed to map SQ ring" << std::endl;
+        release();
+        return false;
+    }
+
+    if (single_mmap) {
+        cq_ring_ptr_ = sq_ring_ptr_;
+    } else {
+        cq_ring_ptr_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ptr_ == MAP_FAILED) {
+            std::cerr << "io_uring: failed to map CQ ring" << std::endl;
+            release();
+            return false;
+        }
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+    if (sqes_ == MAP_FAILED) {
+        std::cerr << "io_uring: failed to map SQEs" << std::endl;
+        release();
+        return false;
+    }
+
+    char* sq = static_cast<char*>(sq_ring_ptr_);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+    char* cq = static_cast<char*>(cq_ring_ptr_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // Allocate and register the provided buffer ring
+    long page_size = sysconf(_SC_PAGESIZE);
+    buf_ring_size_ = buffer_count_ * sizeof(io_uring_buf);
+    buf_ring_size_ = (buf_ring_size_ + page_size - 1) / page_size * page_size;
+    buf_ring_ = static_cast<io_uring_buf_ring*>(mmap(nullptr, buf_ring_size_, PROT_READ | PROT_WRITE,
+                                                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (buf_ring_ == MAP_FAILED) {
+        std::cerr << "io_uring: failed to allocate buffer ring" << std::endl;
+        release();
+        return false;
+    }
+
+    io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+    reg.ring_entries = buffer_count_;
+    reg.bgid = kBufferGroup;
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        std::cerr << "io_uring: provided buffer rings unsupported: " << strerror(errno) << std::endl;
+        munmap(buf_ring_, buf_ring_size_);
+        buf_ring_ = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+        release();
+        return false;
+    }
+
+    buffer_slab_.assign(static_cast<size_t>(buffer_count_) * buffer_size_, 0);
+    buf_ring_tail_ = 0;
+    for (unsigned i = 0; i < buffer_count_; ++i) {
+        io_uring_buf* buf = ringEntry(buf_ring_, i);
+        buf->addr = reinterpret_cast<uint64_t>(buffer_slab_.data() + static_cast<size_t>(i) * buffer_size_);
+        buf->len = buffer_size_;
+        buf->bid = static_cast<uint16_t>(i);
+    }
+    buf_ring_tail_ = static_cast<uint16_t>(buffer_count_);
+    storeRelease(&buf_ring_->tail, buf_ring_tail_);
+
+    // Template for multishot recvmsg: room for the sender address and the RX timestamp
+    std::memset(&msg_template_, 0, sizeof(msg_template_));
+    msg_template_.msg_namelen = sizeof(struct sockaddr_storage);
+    msg_template_.msg_controllen = rx_timestamp::kControlSize;
+    payload_offset_ = sizeof(io_uring_recvmsg_out) + msg_template_.msg_namelen + msg_template_.msg_controllen;
+
+    if (payload_offset_ >= buffer_size_) {
+        std::cerr << "io_uring: buffer size too small" << std::endl;
+        release();
+        return false;
+    }
+
+    return true;
+}
+
+bool UringReceiver::armRecv() {
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & *sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = socket_fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(&msg_template_);
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = kRecvUserData;
+
+    sq_array_[index] = index;
+    storeRelease(sq_tail_, tail + 1);
+    pending_submit_++;
+    return true;
+}
+
+int UringReceiver::enter(unsigned to_submit, unsigned min_complete, unsigned flags, bool wait) {
+    if (!wait) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete,
+                                        flags, nullptr, 0));
+    }
+
+    struct __kernel_timespec ts;
+    ts.tv_sec = 0;
+    ts.tv_nsec = kWaitTimeoutNs;
+
+    io_uring_getevents_arg arg;
+    std::memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts = reinterpret_cast<uint64_t>(&ts);
+
+    return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete,
+                                    flags | IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                                    &arg, sizeof(arg)));
+}
+
+void UringReceiver::recycleBuffer(uint16_t buffer_id) {
+    unsigned mask = buffer_count_ - 1;
+    io_uring_buf* buf = ringEntry(buf_ring_, buf_ring_tail_ & mask);
+    buf->addr = reinterpret_cast<uint64_t>(buffer_slab_.data() + static_cast<size_t>(buffer_id) * buffer_size_);
+    buf->len = buffer_size_;
+    buf->bid = buffer_id;
+    buf_ring_tail_++;
+}
+
+bool UringReceiver::run(const std::atomic<bool>& running, const PacketHandler& handler) {
+    if (ring_fd_ < 0) {
+        return false;
+    }
+
+    armRecv();
+    int empty_rearms = 0;
+
+    while (running) {
+        int ret = enter(pending_submit_, 1, 0, true);
+        if (ret < 0) {
+            if (errno == EINTR || errno == ETIME || errno == EBUSY) {
+                continue;
+            }
+            std::cerr << "io_uring_enter failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        pending_submit_ = 0;
+
+        // Reap every completion that is ready in one pass
+        unsigned head = *cq_head_;
+        unsigned tail = loadAcquire(cq_tail_);
+        if (head == tail) {
+            continue;
+        }
+
+        bool rearm = false;
+        bool fatal = false;
+        unsigned mask = *cq_mask_;
+
+        for (; head != tail; ++head) {
+            const io_uring_cqe* cqe = &cqes_[head & mask];
+
+            if (!(cqe->flags & IORING_CQE_F_MORE)) {
+                rearm = true;
+            }
+
+            if (cqe->res < 0) {
+                // ENOBUFS just means the ring ran dry; re-arm once buffers are back.
+                // Every buffer is returned at the end of a batch, so repeated ENOBUFS
+                // without a packet in between means the kernel can't see the ring.
+                if (cqe->res == -ENOBUFS) {
+                    if (++empty_rearms > kMaxEmptyRearms) {
+                        std::cerr << "io_uring: provided buffer ring not usable" << std::endl;
+                        fatal = true;
+                    }
+                } else if (running) {
+                    std::cerr << "io_uring recvmsg failed: " << strerror(-cqe->res) << std::endl;
+                    fatal = true;
+                }
+                continue;
+            }
+
+            if (!(cqe->flags & IORING_CQE_F_BUFFER)) {
+                continue;
+            }
+
+            uint16_t buffer_id = static_cast<uint16_t>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+            const char* buffer = buffer_slab_.data() + static_cast<size_t>(buffer_id) * buffer_size_;
+            auto* out = reinterpret_cast<const io_uring_recvmsg_out*>(buffer);
+
+            if (static_cast<size_t>(cqe->res) >= payload_offset_ && !(out->flags & MSG_TRUNC)) {
+                // Control data sits between the address and the payload
+                struct msghdr control;
+                std::memset(&control, 0, sizeof(control));
+                control.msg_control = const_cast<char*>(buffer) + sizeof(io_uring_recvmsg_out) + msg_template_.msg_namelen;
+                control.msg_controllen = out->controllen;
+                uint64_t arrival_ns = rx_timestamp::extract(&control);
+
+                // The sender address sits right after the header
+                struct sockaddr_storage name{};
+                socklen_t name_length = std::min<socklen_t>(out->namelen, sizeof(name));
+                std::memcpy(&name, buffer + sizeof(io_uring_recvmsg_out), name_length);
+
+                handler(buffer + payload_offset_, out->payloadlen, arrival_ns ? arrival_ns : rx_timestamp::nowNs(),
+                        EventLoop::sourceOf(name, name_length));
+                packet_count_++;
+                empty_rearms = 0;
+            }
+
+            recycleBuffer(buffer_id);
+        }
+
+        // Hand the batch back to the kernel: one release store for the CQ, one for the buffers
+        storeRelease(cq_head_, head);
+        storeRelease(&buf_ring_->tail, buf_ring_tail_);
+        batch_count_++;
+
+        if (fatal) {
+            return false;
+        }
+        if (rearm && running) {
+            armRecv();
+        }
+    }
+
+    return true;
+}
+
+void UringReceiver::release() {
+    if (buf_ring_ != MAP_FAILED) {
+        if (ring_fd_ >= 0) {
+            io_uring_buf_reg reg;
+            std::memset(&reg, 0, sizeof(reg));
+            reg.bgid = kBufferGroup;
+            syscall(__NR_io_uring_register, ring_fd_, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+        }
+        munmap(buf_ring_, buf_ring_size_);
+        buf_ring_ = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+    }
+    if (sqes_ != MAP_FAILED) {
+        munmap(sqes_, sqes_size_);
+        sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    }
+    if (cq_ring_ptr_ != MAP_FAILED && cq_ring_ptr_ != sq_ring_ptr_) {
+        munmap(cq_ring_ptr_, cq_ring_size_);
+    }
+    cq_ring_ptr_ = MAP_FAILED;
+    if (sq_ring_ptr_ != MAP_FAILED) {
+        munmap(sq_ring_ptr_, sq_ring_size_);
+        sq_ring_ptr_ = MAP_FAILED;
+    }
+    if (ring_fd_ >= 0) {
+        close(ring_fd_);
+        ring_fd_ = -1;
+    }
+    pending_submit_ = 0;
+}
+
+#else  // !OSC_HAVE_IO_URING
+
+bool UringReceiver::initialize(int /*socket_fd*/) {
+    std::cerr << "io_uring is not available on this platform" << std::endl;
+    return false;
+}
+
+bool UringReceiver::run(const std::atomic<bool>& /*running*/, const PacketHandler& /*handler*/) {
+    return false;
+}
+
+void UringReceiver::release() {
+}
+
+#endif
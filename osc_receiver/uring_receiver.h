@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <sys/socket.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#ifdef IORING_RECV_MULTISHOT
+#define OSC_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+/**
+ * io_uring receive backend for UDP sockets (Linux 6.0+)
+ * Keeps a multishot recvmsg armed against a provided-buffer ring, so the
+ * kernel fills preregistered buffers without a syscall per packet.
+ * Completions are reaped in batches and buffers are returned to the ring
+ * once per batch. Each buffer also carries the kernel receive timestamp
+ * when it is enabled on the socket.
+ */
+class UringReceiver {
+public:
+    // source as EventLoop::sourceOf() computes it for the sender address
+    using PacketHandler = std::function<void(const char* data, size_t length, uint64_t arrival_ns, uint64_t source)>;
+
+    /**
+     * @param buffer_count Number of provided buffers (rounded up to a power of two)
+     * @param buffer_size Size of each buffer in bytes, including the recvmsg header
+     */
+    UringReceiver(unsigned buffer_count = 256, unsigned buffer_size = 4096);
+    ~UringReceiver();
+
+    UringReceiver(const UringReceiver&) = delete;
+    UringReceiver& operator=(const UringReceiver&) = delete;
+
+    /**
+     * Set up the ring and register buffers for the given socket
+     * @return false if io_uring or one of the required features is unavailable
+     */
+    bool initialize(int socket_fd);
+
+    /**
+     * Process completions until running becomes false
+     * @return false if the ring failed and the caller should fall back
+     */
+    bool run(const std::atomic<bool>& running, const PacketHandler& handler);
+
+    /**
+     * Get number of packets delivered through the ring
+     */
+    uint64_t getPacketCount() const { return packet_count_; }
+
+    /**
+     * Get number of completion batches reaped
+     */
+    uint64_t getBatchCount() const { return batch_count_; }
+
+private:
+    void release();
+
+#ifdef OSC_HAVE_IO_URING
+    bool armRecv();
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags, bool wait);
+    void recycleBuffer(uint16_t buffer_id);
+
+    int ring_fd_;
+    int socket_fd_;
+
+    // Submission queue
+    void* sq_ring_ptr_;
+    size_t sq_ring_size_;
+    unsigned* sq_tail_;
+    unsigned* sq_mask_;
+    unsigned* sq_array_;
+    io_uring_sqe* sqes_;
+    size_t sqes_size_;
+    unsigned pending_submit_;
+
+    // Completion queue
+    void* cq_ring_ptr_;
+    size_t cq_ring_size_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned* cq_mask_;
+    io_uring_cqe* cqes_;
+
+    // Provided buffer ring
+    io_uring_buf_ring* buf_ring_;
+    size_t buf_ring_size_;
+    uint16_t buf_ring_tail_;
+    std::vector<char> buffer_slab_;
+
+    struct msghdr msg_template_;
+    size_t payload_offset_;
+#endif
+
+    unsigned buffer_count_;
+    unsigned buffer_size_;
+    std::atomic<uint64_t> packet_count_;
+    std::atomic<uint64_t> batch_count_;
+};